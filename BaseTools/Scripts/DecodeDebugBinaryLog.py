@@ -0,0 +1,498 @@
+## @file
+# Decode the binary debug log produced by BaseDebugLibBinaryLog.
+#
+# The input is either a memory dump that contains the ring buffer described by
+# MdeModulePkg/Include/Guid/DebugBinaryLog.h, or a raw capture of the serial
+# port. Format strings are read from the .efi, .te or .debug files found under
+# the build output directories given on the command line.
+#
+# Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+
+'''
+DecodeDebugBinaryLog
+'''
+from __future__ import print_function
+
+import argparse
+import os
+import struct
+import sys
+import uuid
+
+#
+# Globals for help information
+#
+__prog__        = 'DecodeDebugBinaryLog'
+__copyright__   = 'Copyright (c) 2026, Intel Corporation. All rights reserved.'
+__description__ = 'Convert the records of the binary debug log back to text.\n'
+
+#
+# Definitions from MdeModulePkg/Include/Guid/DebugBinaryLog.h
+#
+DEBUG_BINARY_LOG_GUID             = uuid.UUID ('039260dd-1de8-418e-8238-7f70c5ad8029')
+DEBUG_BINARY_LOG_VERSION          = 1
+DEBUG_BINARY_LOG_RECORD_SIGNATURE = b'Db'
+DEBUG_BINARY_LOG_MAX_RECORD_SIZE  = 0x100
+
+DEBUG_BINARY_LOG_ARG_UINT32 = 0x01
+DEBUG_BINARY_LOG_ARG_UINT64 = 0x02
+DEBUG_BINARY_LOG_ARG_STRING = 0x03
+DEBUG_BINARY_LOG_ARG_GUID   = 0x04
+DEBUG_BINARY_LOG_ARG_TIME   = 0x05
+DEBUG_BINARY_LOG_ARG_STATUS = 0x06
+DEBUG_BINARY_LOG_ARG_NULL   = 0x07
+
+DEBUG_BINARY_LOG_RECORD_TRUNCATED     = 0x01
+DEBUG_BINARY_LOG_RECORD_ASSERT        = 0x02
+DEBUG_BINARY_LOG_RECORD_INLINE_FORMAT = 0x04
+
+BufferHeader = struct.Struct ('<16sIIQ')
+RecordHeader = struct.Struct ('<2sHI16siB3s')
+
+#
+# Status strings from MdePkg/Library/BasePrintLib/PrintLibInternal.c
+#
+WarningStrings = [
+    'Success', 'Warning Unknown Glyph', 'Warning Delete Failure', 'Warning Write Failure',
+    'Warning Buffer Too Small', 'Warning Stale Data', 'Warning File System', 'Warning Reset Required'
+    ]
+ErrorStrings = [
+    'Load Error', 'Invalid Parameter', 'Unsupported', 'Bad Buffer Size', 'Buffer Too Small',
+    'Not Ready', 'Device Error', 'Write Protected', 'Out of Resources', 'Volume Corrupt',
+    'Volume Full', 'No Media', 'Media changed', 'Not Found', 'Access Denied', 'No Response',
+    'No mapping', 'Time out', 'Not started', 'Already started', 'Aborted', 'ICMP Error',
+    'TFTP Error', 'Protocol Error', 'Incompatible Version', 'Security Violation', 'CRC Error',
+    'End of Media', 'Reserved (29)', 'Reserved (30)', 'End of File', 'Invalid Language',
+    'Compromised Data', 'IP Address Conflict', 'HTTP Error'
+    ]
+
+class ImageFile (object):
+    '''
+    A PE/COFF, TE or ELF image file, with the mapping from image addresses to
+    file offsets of its sections.
+    '''
+    def __init__ (self, Path):
+        self.Path     = Path
+        self.Sections = []
+        with open (Path, 'rb') as File:
+            self.Data = File.read ()
+        if self.Data[:4] == b'\x7fELF':
+            self.ParseElf ()
+        elif self.Data[:2] == b'VZ':
+            self.ParseTe ()
+        elif self.Data[:2] == b'MZ':
+            self.ParsePe (struct.unpack_from ('<I', self.Data, 0x3C)[0])
+        elif self.Data[:4] == b'PE\0\0':
+            self.ParsePe (0)
+
+    def AddSection (self, Address, FileOffset, Size):
+        if Size != 0 and FileOffset + Size <= len (self.Data):
+            self.Sections.append ((Address, FileOffset, Size))
+
+    def ParseCoffSections (self, Offset, Count, Adjust):
+        for Index in range (Count):
+            VirtualSize, VirtualAddress, RawSize, RawOffset = struct.unpack_from ('<IIII', self.Data, Offset + Index * 40 + 8)
+            self.AddSection (VirtualAddress, RawOffset + Adjust, min (RawSize, VirtualSize) if VirtualSize else RawSize)
+
+    def ParsePe (self, Offset):
+        if self.Data[Offset:Offset + 4] != b'PE\0\0':
+            return
+        Count, = struct.unpack_from ('<H', self.Data, Offset + 6)
+        OptionalSize, = struct.unpack_from ('<H', self.Data, Offset + 20)
+        self.ParseCoffSections (Offset + 24 + OptionalSize, Count, 0)
+
+    def ParseTe (self):
+        Count, = struct.unpack_from ('<B', self.Data, 4)
+        StrippedSize, = struct.unpack_from ('<H', self.Data, 6)
+        self.ParseCoffSections (40, Count, 40 - StrippedSize)
+
+    def ParseElf (self):
+        Is64   = self.Data[4] == 2
+        Endian = '<' if self.Data[5] == 1 else '>'
+        if Is64:
+            SectionOffset, = struct.unpack_from (Endian + 'Q', self.Data, 0x28)
+            EntrySize, Count = struct.unpack_from (Endian + 'HH', self.Data, 0x3A)
+            Layout = Endian + 'IIQQQQ'
+        else:
+            SectionOffset, = struct.unpack_from (Endian + 'I', self.Data, 0x20)
+            EntrySize, Count = struct.unpack_from (Endian + 'HH', self.Data, 0x2E)
+            Layout = Endian + 'IIIIII'
+        for Index in range (Count):
+            Name, Type, Flags, Address, Offset, Size = struct.unpack_from (Layout, self.Data, SectionOffset + Index * EntrySize)
+            #
+            # Only SHF_ALLOC sections that have file contents (not SHT_NOBITS).
+            #
+            if (Flags & 0x2) != 0 and Type != 8:
+                self.AddSection (Address, Offset, Size)
+
+    def FileOffsetToAddress (self, FileOffset):
+        for Address, Offset, Size in self.Sections:
+            if Offset <= FileOffset < Offset + Size:
+                return Address + FileOffset - Offset
+        return None
+
+    def AddressToFileOffset (self, Address):
+        for Base, Offset, Size in self.Sections:
+            if Base <= Address < Base + Size:
+                return Offset + Address - Base
+        return None
+
+    def FindGuid (self, Guid):
+        Addresses = []
+        Start     = self.Data.find (Guid)
+        while Start >= 0:
+            Address = self.FileOffsetToAddress (Start)
+            if Address is not None:
+                Addresses.append (Address)
+            Start = self.Data.find (Guid, Start + 1)
+        return Addresses
+
+    def ReadString (self, Address):
+        Offset = self.AddressToFileOffset (Address)
+        if Offset is None:
+            return None
+        End = self.Data.find (b'\0', Offset)
+        if End < 0:
+            return None
+        return self.Data[Offset:End]
+
+class ImageDatabase (object):
+    '''
+    Finds the format strings of the modules referenced by the log.
+    '''
+    def __init__ (self, Directories):
+        self.Files  = []
+        self.Images = {}
+        self.Cache  = {}
+        for Directory in Directories:
+            for Root, Dirs, Files in os.walk (Directory):
+                for Name in Files:
+                    if os.path.splitext (Name)[1].lower () in ('.efi', '.te', '.debug', '.dll'):
+                        self.Files.append (os.path.join (Root, Name))
+
+    def LoadImages (self, Guids):
+        Pending = set (Guids) - set (self.Images)
+        for Guid in Pending:
+            self.Images[Guid] = []
+        if not Pending:
+            return
+        for Path in self.Files:
+            try:
+                with open (Path, 'rb') as File:
+                    Data = File.read ()
+            except IOError:
+                continue
+            Found = [Guid for Guid in Pending if Data.find (Guid) >= 0]
+            if not Found:
+                continue
+            Image = ImageFile (Path)
+            for Guid in Found:
+                for Address in Image.FindGuid (Guid):
+                    self.Images[Guid].append ((Image, Address))
+
+    def GetFormat (self, Guid, Offset):
+        Key = (Guid, Offset)
+        if Key not in self.Cache:
+            Candidates = []
+            for Image, Address in self.Images.get (Guid, []):
+                String = Image.ReadString (Address + Offset)
+                if String is not None and len (String) > 0:
+                    Candidates.append (String)
+            #
+            # A format string is printable text. Prefer a candidate that looks
+            # like one when the GUID matched more than one place.
+            #
+            Candidates.sort (key = lambda String: not all (32 <= Byte < 127 or Byte in (9, 10, 13) for Byte in bytearray (String)))
+            self.Cache[Key] = Candidates[0].decode ('ascii', 'replace') if Candidates else None
+        return self.Cache[Key]
+
+def ParseArguments (Data):
+    '''
+    Return the list of (Tag, Value) arguments of a record, or None if Data is
+    not a well formed argument list.
+    '''
+    Arguments = []
+    Offset    = 0
+    while Offset < len (Data):
+        Tag     = bytearray (Data[Offset:Offset + 1])[0]
+        Offset += 1
+        if Tag == DEBUG_BINARY_LOG_ARG_UINT32:
+            if Offset + 4 > len (Data):
+                return None
+            Arguments.append ((Tag, struct.unpack_from ('<I', Data, Offset)[0]))
+            Offset += 4
+        elif Tag in (DEBUG_BINARY_LOG_ARG_UINT64, DEBUG_BINARY_LOG_ARG_STATUS):
+            if Offset + 8 > len (Data):
+                return None
+            Arguments.append ((Tag, struct.unpack_from ('<Q', Data, Offset)[0]))
+            Offset += 8
+        elif Tag == DEBUG_BINARY_LOG_ARG_STRING:
+            if Offset + 1 > len (Data):
+                return None
+            Length  = bytearray (Data[Offset:Offset + 1])[0]
+            Offset += 1
+            if Offset + Length > len (Data):
+                return None
+            Arguments.append ((Tag, Data[Offset:Offset + Length].decode ('latin-1')))
+            Offset += Length
+        elif Tag == DEBUG_BINARY_LOG_ARG_GUID:
+            if Offset + 16 > len (Data):
+                return None
+            Arguments.append ((Tag, str (uuid.UUID (bytes_le = bytes (Data[Offset:Offset + 16]))).upper ()))
+            Offset += 16
+        elif Tag == DEBUG_BINARY_LOG_ARG_TIME:
+            if Offset + 6 > len (Data):
+                return None
+            Arguments.append ((Tag, struct.unpack_from ('<HBBBB', Data, Offset)))
+            Offset += 6
+        elif Tag == DEBUG_BINARY_LOG_ARG_NULL:
+            Arguments.append ((Tag, None))
+        else:
+            return None
+    return Arguments
+
+def FormatStatus (Value):
+    if Value & (1 << 63):
+        Code = Value & ~(1 << 63)
+        if 0 < Code <= len (ErrorStrings):
+            return ErrorStrings[Code - 1]
+    elif Value < len (WarningStrings):
+        return WarningStrings[Value]
+    return '{0:08X}'.format (Value)
+
+def FormatMessage (Format, Arguments):
+    '''
+    Expand Format the way BasePrintLib does.
+    '''
+    Output   = []
+    Index    = 0
+    Consumed = iter (Arguments)
+
+    def Next (Default = 0):
+        try:
+            return next (Consumed)[1]
+        except StopIteration:
+            return Default
+
+    while Index < len (Format):
+        Character = Format[Index]
+        Index    += 1
+        if Character != '%':
+            Output.append (Character)
+            continue
+
+        Left = Sign = Blank = Comma = Zero = Long = HasPrecision = HasWidth = False
+        Width     = 0
+        Precision = 1
+        while Index < len (Format):
+            Character = Format[Index]
+            Index    += 1
+            if Character == '.':
+                HasPrecision = True
+            elif Character == '-':
+                Left = True
+            elif Character == '+':
+                Sign = True
+            elif Character == ' ':
+                Blank = True
+            elif Character == ',':
+                Comma = True
+            elif Character in 'lL':
+                Long = True
+            elif Character == '*':
+                if HasPrecision:
+                    Precision = Next ()
+                else:
+                    HasWidth = True
+                    Width    = Next ()
+            elif Character.isdigit ():
+                if Character == '0' and not HasPrecision:
+                    Zero = True
+                Count = 0
+                Index -= 1
+                while Index < len (Format) and Format[Index].isdigit ():
+                    Count  = Count * 10 + int (Format[Index])
+                    Index += 1
+                if HasPrecision:
+                    Precision = Count
+                else:
+                    HasWidth = True
+                    Width    = Count
+            else:
+                break
+        else:
+            break
+
+        Text    = None
+        Numeric = False
+        if Character in 'pXxud':
+            Hex = Character in 'pXx'
+            if Character in 'pX':
+                Zero = True
+            if Character == 'p':
+                Sign = Blank = False
+            Value = Next ()
+            if Character == 'd' and not Long and Value >= 0x80000000:
+                Value -= 1 << 32
+            elif Character == 'd' and Long and Value >= 1 << 63:
+                Value -= 1 << 64
+            Prefix = ''
+            if Blank:
+                Prefix = ' '
+            if Sign and Character != 'u':
+                Prefix = '+'
+            if Hex:
+                Digits = '{0:X}'.format (Value)
+            else:
+                if Comma:
+                    Zero      = False
+                    Precision = 1
+                if Value < 0:
+                    Prefix = '-'
+                    Value  = -Value
+                Digits = '{0:,}'.format (Value) if Comma else str (Value)
+            if Value == 0 and Precision == 0:
+                Digits = ''
+            if Zero and not Left and HasWidth and not HasPrecision:
+                Precision = Width - len (Prefix)
+            Text    = Prefix + Digits.rjust (Precision, '0')
+            Numeric = True
+        elif Character in 'sSa':
+            Value = Next (None)
+            Text  = '<null string>' if Value is None else Value
+            if HasPrecision:
+                Text = Text[:Precision]
+        elif Character == 'c':
+            Text = chr (Next () & 0xFF)
+        elif Character == 'g':
+            Value = Next (None)
+            Text  = '<null guid>' if Value is None else Value
+        elif Character == 't':
+            Value = Next (None)
+            if Value is None:
+                Text = '<null time>'
+            else:
+                Year, Month, Day, Hour, Minute = Value
+                Text = '{0:02d}/{1:02d}/{2:04d}  {3:02d}:{4:02d}'.format (Month, Day, Year, Hour, Minute)
+        elif Character == 'r':
+            Text = FormatStatus (Next ())
+        else:
+            Text = Character
+
+        if HasWidth and len (Text) < Width:
+            Text = Text.ljust (Width) if Left else Text.rjust (Width)
+        Output.append (Text)
+
+    return ''.join (Output)
+
+def DecodeRecord (Data, Offset, Images):
+    '''
+    Decode the record at Offset. Return (Text, Size), or None if there is no
+    valid record at Offset.
+    '''
+    if Data[Offset:Offset + 2] != DEBUG_BINARY_LOG_RECORD_SIGNATURE or Offset + RecordHeader.size > len (Data):
+        return None
+    Signature, Size, ErrorLevel, Guid, FormatOffset, Flags, Reserved = RecordHeader.unpack_from (Data, Offset)
+    if Size < RecordHeader.size or Size > DEBUG_BINARY_LOG_MAX_RECORD_SIZE or Offset + Size > len (Data):
+        return None
+    Arguments = ParseArguments (Data[Offset + RecordHeader.size:Offset + Size])
+    if Arguments is None:
+        return None
+
+    Module = str (uuid.UUID (bytes_le = bytes (Guid))).upper ()
+    if Flags & DEBUG_BINARY_LOG_RECORD_INLINE_FORMAT:
+        if not Arguments or Arguments[0][0] != DEBUG_BINARY_LOG_ARG_STRING:
+            return None
+        Format    = Arguments[0][1]
+        Arguments = Arguments[1:]
+    else:
+        Images.LoadImages ([bytes (Guid)])
+        Format = Images.GetFormat (bytes (Guid), FormatOffset)
+
+    if Format is None:
+        Text = '[{0} format {1:+#x} not found] {2}\n'.format (Module, FormatOffset, ' '.join (str (Value) for Tag, Value in Arguments))
+    else:
+        Text = FormatMessage (Format, Arguments)
+    if Flags & DEBUG_BINARY_LOG_RECORD_TRUNCATED:
+        Text = Text.rstrip ('\n') + ' <truncated>\n'
+    return Text, Size
+
+def ExtractRingBuffer (Data):
+    '''
+    Return the records of the ring buffer in Data in write order, or None if
+    Data does not contain an initialized ring buffer.
+    '''
+    Offset = Data.find (DEBUG_BINARY_LOG_GUID.bytes_le)
+    while Offset >= 0:
+        if Offset + BufferHeader.size <= len (Data):
+            Signature, Version, DataSize, WriteCount = BufferHeader.unpack_from (Data, Offset)
+            Start = Offset + BufferHeader.size
+            if Version == DEBUG_BINARY_LOG_VERSION and DataSize != 0 and Start + DataSize <= len (Data):
+                Ring = Data[Start:Start + DataSize]
+                if WriteCount <= DataSize:
+                    return Ring[:WriteCount]
+                Head = WriteCount % DataSize
+                return Ring[Head:] + Ring[:Head]
+        Offset = Data.find (DEBUG_BINARY_LOG_GUID.bytes_le, Offset + 1)
+    return None
+
+def Decode (Data, Images, Output, PassThrough):
+    '''
+    Decode every record of Data. Bytes that do not belong to a record are
+    copied to Output if PassThrough is True, which keeps text printed by other
+    DebugLib instances on a shared serial port.
+    '''
+    Offset = 0
+    while Offset < len (Data):
+        Result = DecodeRecord (Data, Offset, Images)
+        if Result is None:
+            Next = Data.find (DEBUG_BINARY_LOG_RECORD_SIGNATURE, Offset + 1)
+            if Next < 0:
+                Next = len (Data)
+            if PassThrough:
+                Output.write (Data[Offset:Next].decode ('latin-1').replace ('\r\n', '\n'))
+            Offset = Next
+            continue
+        Text, Size = Result
+        Output.write (Text)
+        Offset += Size
+
+if __name__ == '__main__':
+    #
+    # Create command line argument parser object
+    #
+    parser = argparse.ArgumentParser (prog = __prog__,
+                                      description = __description__ + __copyright__,
+                                      conflict_handler = 'resolve')
+    parser.add_argument ("-i", "--input", dest = 'InputFile', type = argparse.FileType ('rb'), required = True,
+                         help = "Memory dump that contains the ring buffer, or a capture of the serial port.")
+    parser.add_argument ("-b", "--build", dest = 'BuildDirectory', action = 'append', default = [],
+                         help = "Build output directory searched for .efi, .te and .debug files.  May be repeated.")
+    parser.add_argument ("-o", "--output", dest = 'OutputFile', type = argparse.FileType ('w'), default = sys.stdout,
+                         help = "Output filename for the decoded log.  Default is stdout.")
+    parser.add_argument ("-s", "--serial", dest = 'Serial', action = 'store_true',
+                         help = "Treat the input as a serial capture even if it contains a ring buffer.")
+    parser.add_argument ("-v", "--verbose", dest = 'Verbose', action = "store_true",
+                         help = "Increase output messages")
+
+    #
+    # Parse command line arguments
+    #
+    args = parser.parse_args ()
+
+    Data = args.InputFile.read ()
+    args.InputFile.close ()
+
+    Images = ImageDatabase (args.BuildDirectory)
+    if args.Verbose:
+        print ('{0} image files found'.format (len (Images.Files)), file = sys.stderr)
+
+    Ring = None if args.Serial else ExtractRingBuffer (Data)
+    if Ring is not None:
+        if args.Verbose:
+            print ('Ring buffer found, {0} bytes of records'.format (len (Ring)), file = sys.stderr)
+        Decode (Ring, Images, args.OutputFile, False)
+    else:
+        Decode (Data, Images, args.OutputFile, True)
@@ -279,6 +279,59 @@ FatFlushDataCacheRange (
   }
 }
 
+/**
+
+  Update the data read from disk directly with the dirty pages of the data cache
+  that overlap it.
+
+  @param  Volume                - FAT file system volume.
+  @param  Offset                - The starting byte offset of the data.
+  @param  BufferSize            - Size of Buffer.
+  @param  Buffer                - Buffer containing the data read from disk.
+
+**/
+STATIC
+VOID
+FatMergeDirtyDataCache (
+  IN     FAT_VOLUME  *Volume,
+  IN     UINT64      Offset,
+  IN     UINTN       BufferSize,
+  IN OUT UINT8       *Buffer
+  )
+{
+  DISK_CACHE  *DiskCache;
+  CACHE_TAG   *CacheTag;
+  UINTN       GroupNo;
+  UINT64      EntryPos;
+  UINT64      PagePos;
+  UINT64      Start;
+  UINT64      End;
+
+  DiskCache = &Volume->DiskCache[CacheData];
+  if (!DiskCache->Dirty) {
+    return;
+  }
+
+  EntryPos = Offset - DiskCache->BaseAddress;
+  for (GroupNo = 0; GroupNo <= DiskCache->GroupMask; GroupNo++) {
+    CacheTag = &DiskCache->CacheTag[GroupNo];
+    if ((CacheTag->RealSize == 0) || !CacheTag->Dirty) {
+      continue;
+    }
+
+    PagePos = LShiftU64 (CacheTag->PageNo, DiskCache->PageAlignment);
+    Start   = MAX (EntryPos, PagePos);
+    End     = MIN (EntryPos + BufferSize, PagePos + CacheTag->RealSize);
+    if (Start < End) {
+      CopyMem (
+        Buffer + (UINTN)(Start - EntryPos),
+        DiskCache->CacheBase + (GroupNo << DiskCache->PageAlignment) + (UINTN)(Start - PagePos),
+        (UINTN)(End - Start)
+        );
+    }
+  }
+}
+
 /**
 
   Exchange the cache page with the image on the disk
@@ -352,6 +405,90 @@ FatExchangeCachePage (
   return EFI_SUCCESS;
 }
 
+/**
+
+  Load a data cache page and the pages following it with one disk read.
+
+  The pages are loaded in the consecutive groups of the cache buffer, so the
+  read stops at the end of the cache buffer, at a page already in the cache,
+  and at the end of the volume.
+
+  @param  Volume                - FAT file system volume.
+  @param  PageNo                - The first page to load.
+  @param  PageCount             - The maximum number of pages to load.
+
+  @retval EFI_SUCCESS           - The pages are loaded.
+  @return Others                - An error occurred when accessing the disk.
+
+**/
+STATIC
+EFI_STATUS
+FatReadAheadCachePages (
+  IN FAT_VOLUME  *Volume,
+  IN UINTN       PageNo,
+  IN UINTN       PageCount
+  )
+{
+  EFI_STATUS  Status;
+  DISK_CACHE  *DiskCache;
+  CACHE_TAG   *CacheTag;
+  UINTN       GroupNo;
+  UINTN       Index;
+  UINTN       PageSize;
+  UINTN       ReadSize;
+  UINT64      EntryPos;
+  UINT8       PageAlignment;
+
+  DiskCache     = &Volume->DiskCache[CacheData];
+  PageAlignment = DiskCache->PageAlignment;
+  PageSize      = (UINTN)1 << PageAlignment;
+  GroupNo       = PageNo & DiskCache->GroupMask;
+  EntryPos      = DiskCache->BaseAddress + LShiftU64 (PageNo, PageAlignment);
+  PageCount     = MIN (PageCount, DiskCache->GroupMask + 1 - GroupNo);
+
+  for (Index = 1; Index < PageCount; Index++) {
+    CacheTag = &DiskCache->CacheTag[GroupNo + Index];
+    if ((EntryPos + LShiftU64 (Index, PageAlignment) >= DiskCache->LimitAddress) ||
+        ((CacheTag->RealSize > 0) && (CacheTag->PageNo == PageNo + Index)))
+    {
+      break;
+    }
+  }
+
+  PageCount = Index;
+
+  //
+  // Write the dirty pages to be replaced back to disk
+  //
+  for (Index = 0; Index < PageCount; Index++) {
+    CacheTag = &DiskCache->CacheTag[GroupNo + Index];
+    if ((CacheTag->RealSize > 0) && CacheTag->Dirty) {
+      Status = FatExchangeCachePage (Volume, CacheData, WriteDisk, CacheTag, NULL);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    }
+  }
+
+  ReadSize = PageCount << PageAlignment;
+  if (DiskCache->LimitAddress - EntryPos < ReadSize) {
+    ReadSize = (UINTN)(DiskCache->LimitAddress - EntryPos);
+  }
+
+  Status = FatDiskIo (Volume, ReadDisk, EntryPos, ReadSize, DiskCache->CacheBase + (GroupNo << PageAlignment), NULL);
+  for (Index = 0; Index < PageCount; Index++) {
+    CacheTag = &DiskCache->CacheTag[GroupNo + Index];
+    ClearCacheTagDirtyState (CacheTag);
+    CacheTag->PageNo   = PageNo + Index;
+    CacheTag->RealSize = 0;
+    if (!EFI_ERROR (Status)) {
+      CacheTag->RealSize = MIN (PageSize, ReadSize - (Index << PageAlignment));
+    }
+  }
+
+  return Status;
+}
+
 /**
 
   Get one cache page by specified PageNo.
@@ -376,6 +513,7 @@ FatGetCachePage (
 {
   EFI_STATUS  Status;
   UINTN       OldPageNo;
+  DISK_CACHE  *DiskCache;
 
   OldPageNo = CacheTag->PageNo;
   if ((CacheTag->RealSize > 0) && (OldPageNo == PageNo)) {
@@ -385,6 +523,16 @@ FatGetCachePage (
     return EFI_SUCCESS;
   }
 
+  //
+  // Read ahead of a sequential data access, doubling the number of pages
+  // read at every miss.
+  //
+  DiskCache = &Volume->DiskCache[CacheDataType];
+  if ((CacheDataType == CacheData) && DiskCache->Sequential && (DiskCache->MaxReadAheadPages > 1)) {
+    DiskCache->ReadAheadPages = MIN (MAX (DiskCache->ReadAheadPages * 2, 2), DiskCache->MaxReadAheadPages);
+    return FatReadAheadCachePages (Volume, PageNo, DiskCache->ReadAheadPages);
+  }
+
   //
   // Write dirty cache page back to disk
   //
@@ -475,6 +623,8 @@ FatAccessUnalignedCachePage (
      The access data will be divided into UnderRun data, Aligned data and OverRun data;
      The UnderRun data and OverRun data will be accessed by the Data cache,
      but the Aligned data will be accessed with disk directly.
+     A large block aligned read is accessed with disk directly as a whole, and
+     the misses of sequential accesses read the following pages ahead.
 
   @param  Volume                - FAT file system volume.
   @param  CacheDataType         - The type of cache: CACHE_DATA or CACHE_FAT.
@@ -523,6 +673,29 @@ FatAccessCache (
   PageNo        = (UINTN)RShiftU64 (EntryPos, PageAlignment);
   UnderRun      = ((UINTN)EntryPos) & (PageSize - 1);
 
+  if (CacheDataType == CacheData) {
+    DiskCache->Sequential = (BOOLEAN)(Offset == DiskCache->NextOffset);
+    DiskCache->NextOffset = Offset + BufferSize;
+    if (!DiskCache->Sequential) {
+      DiskCache->ReadAheadPages = 0;
+    }
+
+    //
+    // Read a large block aligned range with one disk access, without loading
+    // its unaligned head and tail pages in the cache.
+    //
+    if ((IoMode == ReadDisk) && (Task == NULL) && (BufferSize >= PageSize) &&
+        ((((UINTN)Offset | BufferSize) & (DiskCache->BlockSize - 1)) == 0))
+    {
+      Status = FatDiskIo (Volume, IoMode, Offset, BufferSize, Buffer, NULL);
+      if (!EFI_ERROR (Status)) {
+        FatMergeDirtyDataCache (Volume, Offset, BufferSize, Buffer);
+      }
+
+      return Status;
+    }
+  }
+
   if (UnderRun > 0) {
     Length = PageSize - UnderRun;
     if (Length > BufferSize) {
@@ -635,10 +808,75 @@ FatVolumeFlushCache (
   return Status;
 }
 
+/**
+
+  Return the size of the free memory.
+
+  @return The size in bytes of the conventional memory, or 0 if the memory
+          map cannot be retrieved.
+
+**/
+STATIC
+UINT64
+FatGetFreeMemorySize (
+  VOID
+  )
+{
+  EFI_STATUS             Status;
+  EFI_MEMORY_DESCRIPTOR  *MemoryMap;
+  EFI_MEMORY_DESCRIPTOR  *Entry;
+  UINTN                  MemoryMapSize;
+  UINTN                  MapKey;
+  UINTN                  DescriptorSize;
+  UINT32                 DescriptorVersion;
+  UINT64                 FreePages;
+
+  MemoryMap     = NULL;
+  MemoryMapSize = 0;
+  do {
+    Status = gBS->GetMemoryMap (&MemoryMapSize, MemoryMap, &MapKey, &DescriptorSize, &DescriptorVersion);
+    if (Status == EFI_BUFFER_TOO_SMALL) {
+      if (MemoryMap != NULL) {
+        FreePool (MemoryMap);
+      }
+
+      //
+      // Leave room for the descriptors added by the allocation itself.
+      //
+      MemoryMapSize += 4 * DescriptorSize;
+      MemoryMap      = AllocatePool (MemoryMapSize);
+      if (MemoryMap == NULL) {
+        return 0;
+      }
+    }
+  } while (Status == EFI_BUFFER_TOO_SMALL);
+
+  FreePages = 0;
+  if (!EFI_ERROR (Status)) {
+    for (Entry = MemoryMap;
+         (UINTN)Entry < (UINTN)MemoryMap + MemoryMapSize;
+         Entry = NEXT_MEMORY_DESCRIPTOR (Entry, DescriptorSize))
+    {
+      if (Entry->Type == EfiConventionalMemory) {
+        FreePages += Entry->NumberOfPages;
+      }
+    }
+  }
+
+  if (MemoryMap != NULL) {
+    FreePool (MemoryMap);
+  }
+
+  return LShiftU64 (FreePages, EFI_PAGE_SHIFT);
+}
+
 /**
 
   Initialize the disk cache according to Volume's FatType.
 
+  The number of Data cache pages scales with the free memory, from
+  FAT_DATACACHE_GROUP_MIN_COUNT to FAT_DATACACHE_GROUP_MAX_COUNT.
+
   @param  Volume                - FAT file system volume.
 
   @retval EFI_SUCCESS           - The disk cache is successfully initialized.
@@ -652,9 +890,11 @@ FatInitializeDiskCache (
 {
   DISK_CACHE  *DiskCache;
   UINTN       FatCacheGroupCount;
+  UINTN       DataCacheGroupCount;
   UINTN       DataCacheSize;
   UINTN       FatCacheSize;
   UINT8       *CacheBuffer;
+  UINT64      BudgetGroupCount;
 
   DiskCache = Volume->DiskCache;
   //
@@ -670,25 +910,48 @@ FatInitializeDiskCache (
     DiskCache[CacheData].PageAlignment = FAT_DATACACHE_PAGE_MAX_ALIGNMENT;
   }
 
-  DiskCache[CacheData].GroupMask    = FAT_DATACACHE_GROUP_COUNT - 1;
-  DiskCache[CacheData].BaseAddress  = Volume->RootPos;
-  DiskCache[CacheData].LimitAddress = Volume->VolumeSize;
-  DiskCache[CacheFat].GroupMask     = FatCacheGroupCount - 1;
-  DiskCache[CacheFat].BaseAddress   = Volume->FatPos;
-  DiskCache[CacheFat].LimitAddress  = Volume->FatPos + Volume->FatSize;
-  FatCacheSize                      = FatCacheGroupCount << DiskCache[CacheFat].PageAlignment;
-  DataCacheSize                     = FAT_DATACACHE_GROUP_COUNT << DiskCache[CacheData].PageAlignment;
+  BudgetGroupCount    = RShiftU64 (FatGetFreeMemorySize (), FAT_DATACACHE_MEMORY_SHIFT + DiskCache[CacheData].PageAlignment);
+  DataCacheGroupCount = (UINTN)MIN (BudgetGroupCount, FAT_DATACACHE_GROUP_MAX_COUNT);
+  DataCacheGroupCount = MAX (GetPowerOfTwo32 ((UINT32)DataCacheGroupCount), FAT_DATACACHE_GROUP_MIN_COUNT);
+
   //
-  // Allocate the Fat Cache buffer
+  // Allocate the Fat Cache buffer, followed by the cache tags. Fall back to
+  // the smallest Data cache when the memory is fragmented.
   //
-  CacheBuffer = AllocateZeroPool (FatCacheSize + DataCacheSize);
-  if (CacheBuffer == NULL) {
-    return EFI_OUT_OF_RESOURCES;
-  }
+  FatCacheSize = FatCacheGroupCount << DiskCache[CacheFat].PageAlignment;
+  do {
+    DataCacheSize = DataCacheGroupCount << DiskCache[CacheData].PageAlignment;
+    CacheBuffer   = AllocateZeroPool (
+                      FatCacheSize + DataCacheSize +
+                      (FatCacheGroupCount + DataCacheGroupCount) * sizeof (CACHE_TAG)
+                      );
+    if (CacheBuffer != NULL) {
+      break;
+    }
+
+    if (DataCacheGroupCount == FAT_DATACACHE_GROUP_MIN_COUNT) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    DataCacheGroupCount = FAT_DATACACHE_GROUP_MIN_COUNT;
+  } while (TRUE);
+
+  DiskCache[CacheData].GroupMask         = DataCacheGroupCount - 1;
+  DiskCache[CacheData].BaseAddress       = Volume->RootPos;
+  DiskCache[CacheData].LimitAddress      = Volume->VolumeSize;
+  DiskCache[CacheData].NextOffset        = MAX_UINT64;
+  DiskCache[CacheData].MaxReadAheadPages = MIN (FAT_DATACACHE_READ_AHEAD_MAX_PAGES, DataCacheGroupCount / 4);
+  DiskCache[CacheFat].GroupMask          = FatCacheGroupCount - 1;
+  DiskCache[CacheFat].BaseAddress        = Volume->FatPos;
+  DiskCache[CacheFat].LimitAddress       = Volume->FatPos + Volume->FatSize;
 
   Volume->CacheBuffer            = CacheBuffer;
   DiskCache[CacheFat].CacheBase  = CacheBuffer;
   DiskCache[CacheData].CacheBase = CacheBuffer + FatCacheSize;
+  DiskCache[CacheFat].CacheTag   = (CACHE_TAG *)(CacheBuffer + FatCacheSize + DataCacheSize);
+  DiskCache[CacheData].CacheTag  = DiskCache[CacheFat].CacheTag + FatCacheGroupCount;
+
+  DEBUG ((DEBUG_INFO, "FatInitializeDiskCache: %d Data cache pages of %d bytes\n", (UINT32)DataCacheGroupCount, 1 << DiskCache[CacheData].PageAlignment));
 
   DiskCache[CacheFat].BlockSize  = Volume->BlockIo->Media->BlockSize;
   DiskCache[CacheData].BlockSize = Volume->BlockIo->Media->BlockSize;
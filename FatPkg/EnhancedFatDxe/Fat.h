@@ -79,10 +79,30 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define FAT_FATCACHE_PAGE_MAX_ALIGNMENT   15
 #define FAT_DATACACHE_PAGE_MIN_ALIGNMENT  13
 #define FAT_DATACACHE_PAGE_MAX_ALIGNMENT  16
-#define FAT_DATACACHE_GROUP_COUNT         64
+#define FAT_DATACACHE_GROUP_MIN_COUNT     64
+#define FAT_DATACACHE_GROUP_MAX_COUNT     512
 #define FAT_FATCACHE_GROUP_MIN_COUNT      1
 #define FAT_FATCACHE_GROUP_MAX_COUNT      16
 
+//
+// The data cache of a volume uses 1/256 of the free memory, within the group
+// counts above. Sequential accesses read up to 16 data pages ahead in one request.
+//
+#define FAT_DATACACHE_MEMORY_SHIFT          8
+#define FAT_DATACACHE_READ_AHEAD_MAX_PAGES  16
+
+//
+// The extent cache of an open file starts with 16 extents and grows up to
+// 4096 extents. Positions beyond the cached extents walk the cluster chain.
+//
+#define FAT_EXTENT_MIN_COUNT  16
+#define FAT_EXTENT_MAX_COUNT  4096
+
+//
+// The FAT is read in 64KB chunks when the free cluster bitmap is built
+//
+#define FAT_FREE_BITMAP_SCAN_SIZE  SIZE_64KB
+
 // For cache block bits, use a UINT64
 typedef UINT64 DIRTY_BLOCKS;
 #define BITS_PER_BYTE         8
@@ -169,7 +189,14 @@ typedef struct {
   BOOLEAN      Dirty;
   UINT8        PageAlignment;
   UINTN        GroupMask;
-  CACHE_TAG    CacheTag[FAT_DATACACHE_GROUP_COUNT];
+  CACHE_TAG    *CacheTag;             // GroupMask + 1 tags
+  //
+  // Sequential access detection of the data cache
+  //
+  UINT64       NextOffset;            // Offset following the last access
+  BOOLEAN      Sequential;            // If the current access starts at NextOffset
+  UINTN        ReadAheadPages;        // Pages read by the next miss of a sequential access
+  UINTN        MaxReadAheadPages;
 } DISK_CACHE;
 
 //
@@ -182,6 +209,15 @@ typedef struct {
 // The directory entry for opened directory
 //
 
+//
+// A run of clusters that are consecutive both in the file and on the disk
+//
+typedef struct {
+  UINTN    FileCluster;                   // Index of the first cluster in the file
+  UINTN    DiskCluster;                   // Cluster number of the first cluster on the disk
+  UINTN    Length;                        // Number of clusters in the run
+} FAT_EXTENT;
+
 typedef struct _FAT_DIRENT FAT_DIRENT;
 typedef struct _FAT_ODIR   FAT_ODIR;
 typedef struct _FAT_OFILE  FAT_OFILE;
@@ -285,6 +321,16 @@ struct _FAT_OFILE {
   UINT64        PosDisk;        // on the disk
   UINTN         PosRem;         // remaining in this disk run
   //
+  // The extent cache of the cluster chain, built lazily by FatOFilePosition.
+  // The extents map the file clusters 0 to ExtentClusters - 1, ExtentComplete
+  // is set when the end of the cluster chain was reached.
+  //
+  FAT_EXTENT    *Extents;
+  UINTN         ExtentCount;
+  UINTN         ExtentMax;
+  UINTN         ExtentClusters;
+  BOOLEAN       ExtentComplete;
+  //
   // The opened parent, full path length and currently opened child files
   //
   FAT_OFILE     *Parent;
@@ -348,6 +394,7 @@ struct _FAT_VOLUME {
   FAT_INFO_SECTOR                    FatInfoSector;  // Free cluster info
   UINTN                              FreeInfoPos;    // Pos with the free cluster info
   BOOLEAN                            FreeInfoValid;  // If free cluster info is valid
+  UINT32                             *FreeBitmap;    // One bit per cluster, set if the cluster is free
   //
   // Unpacked Fat BPB info
   //
@@ -740,6 +787,8 @@ FatInitializeDiskCache (
      The access data will be divided into UnderRun data, Aligned data and OverRun data;
      The UnderRun data and OverRun data will be accessed by the Data cache,
      but the Aligned data will be accessed with disk directly.
+     A large block aligned read is accessed with disk directly as a whole, and
+     the misses of sequential accesses read the following pages ahead.
 
   @param  Volume                - FAT file system volume.
   @param  CacheDataType         - The type of cache: CACHE_DATA or CACHE_FAT.
@@ -974,6 +1023,31 @@ FatComputeFreeInfo (
   IN FAT_VOLUME  *Volume
   );
 
+/**
+
+  Build the free cluster bitmap of the volume from the FAT and update
+  the free cluster info of FatInfoSector of the volume.
+
+  @param  Volume                - FAT file system volume.
+
+**/
+VOID
+FatInitializeFreeBitmap (
+  IN FAT_VOLUME  *Volume
+  );
+
+/**
+
+  Free the extent cache of the open file.
+
+  @param  OFile                 - The open file.
+
+**/
+VOID
+FatFreeExtentCache (
+  IN FAT_OFILE  *OFile
+  );
+
 //
 // Init.c
 //
@@ -122,6 +122,69 @@ FatGetFatEntry (
   return Accum;
 }
 
+/**
+
+  Mark the cluster as free or allocated in the free cluster bitmap of the volume.
+
+  @param  Volume                - FAT file system volume.
+  @param  Index                 - The cluster number.
+  @param  Free                  - TRUE if the cluster becomes free.
+
+**/
+STATIC
+VOID
+FatUpdateFreeBitmap (
+  IN FAT_VOLUME  *Volume,
+  IN UINTN       Index,
+  IN BOOLEAN     Free
+  )
+{
+  if ((Volume->FreeBitmap == NULL) || (Index > (Volume->MaxCluster + 1))) {
+    return;
+  }
+
+  if (Free) {
+    Volume->FreeBitmap[Index / 32] |= (UINT32)1 << (Index % 32);
+  } else {
+    Volume->FreeBitmap[Index / 32] &= ~((UINT32)1 << (Index % 32));
+  }
+}
+
+/**
+
+  Find the first free cluster starting at the cluster number in the free
+  cluster bitmap of the volume.
+
+  @param  Volume                - FAT file system volume.
+  @param  Start                 - The cluster number to start the search at.
+
+  @return The number of the free cluster, or FAT_CLUSTER_LAST if there is no
+          free cluster at or after Start.
+
+**/
+STATIC
+UINTN
+FatFindFreeCluster (
+  IN FAT_VOLUME  *Volume,
+  IN UINTN       Start
+  )
+{
+  UINTN   Index;
+  UINT32  Word;
+
+  //
+  // The bits of the clusters after MaxCluster + 1 are never set
+  //
+  for (Index = Start; Index <= Volume->MaxCluster + 1; Index = (Index & ~(UINTN)31) + 32) {
+    Word = Volume->FreeBitmap[Index / 32] & (MAX_UINT32 << (Index % 32));
+    if (Word != 0) {
+      return (Index & ~(UINTN)31) + (UINTN)LowBitSet32 (Word);
+    }
+  }
+
+  return (UINTN)FAT_CLUSTER_LAST;
+}
+
 /**
 
   Set the FAT entry value of the volume, which is identified with the Index.
@@ -167,6 +230,8 @@ FatSetFatEntry (
     }
   }
 
+  FatUpdateFreeBitmap (Volume, Index, (BOOLEAN)(Value == FAT_CLUSTER_FREE));
+
   //
   // Make sure the entry is in memory
   //
@@ -283,6 +348,22 @@ FatAllocateCluster (
     return (UINTN)FAT_CLUSTER_LAST;
   }
 
+  //
+  // Search the free cluster bitmap from the hint, and wrap around once
+  //
+  if (Volume->FreeBitmap != NULL) {
+    Cluster = FatFindFreeCluster (Volume, Volume->FatInfoSector.FreeInfo.NextCluster);
+    if (FAT_END_OF_FAT_CHAIN (Cluster)) {
+      Cluster = FatFindFreeCluster (Volume, FAT_MIN_CLUSTER);
+      if (FAT_END_OF_FAT_CHAIN (Cluster)) {
+        return (UINTN)FAT_CLUSTER_LAST;
+      }
+    }
+
+    Volume->FatInfoSector.FreeInfo.NextCluster = (UINT32)(Cluster + 1);
+    return Cluster;
+  }
+
   for ( ; ;) {
     //
     // If the end of the list, return no available cluster
@@ -341,6 +422,197 @@ FatSizeToClusters (
   return Clusters;
 }
 
+/**
+
+  Free the extent cache of the open file.
+
+  @param  OFile                 - The open file.
+
+**/
+VOID
+FatFreeExtentCache (
+  IN FAT_OFILE  *OFile
+  )
+{
+  if (OFile->Extents != NULL) {
+    FreePool (OFile->Extents);
+  }
+
+  OFile->Extents        = NULL;
+  OFile->ExtentCount    = 0;
+  OFile->ExtentMax      = 0;
+  OFile->ExtentClusters = 0;
+  OFile->ExtentComplete = FALSE;
+}
+
+/**
+
+  Drop the extents of the file clusters from Clusters on, because the
+  cluster chain of the open file is changed after them.
+
+  @param  OFile                 - The open file.
+  @param  Clusters              - The number of file clusters that are unchanged.
+
+**/
+STATIC
+VOID
+FatTrimExtentCache (
+  IN FAT_OFILE  *OFile,
+  IN UINTN      Clusters
+  )
+{
+  FAT_EXTENT  *Extent;
+
+  while (OFile->ExtentCount > 0) {
+    Extent = &OFile->Extents[OFile->ExtentCount - 1];
+    if (Extent->FileCluster < Clusters) {
+      Extent->Length = MIN (Extent->Length, Clusters - Extent->FileCluster);
+      break;
+    }
+
+    OFile->ExtentCount--;
+  }
+
+  OFile->ExtentClusters = MIN (OFile->ExtentClusters, Clusters);
+  OFile->ExtentComplete = FALSE;
+}
+
+/**
+
+  Run the cluster chain of the open file until the extent cache maps the
+  file cluster Index, the end of the chain is reached or the extent cache
+  is full.
+
+  @param  OFile                 - The open file.
+  @param  Index                 - The index of the file cluster to map.
+
+  @retval EFI_SUCCESS           - The extent cache is extended.
+  @retval EFI_VOLUME_CORRUPTED  - Cluster chain corrupt.
+
+**/
+STATIC
+EFI_STATUS
+FatExtendExtentCache (
+  IN FAT_OFILE  *OFile,
+  IN UINTN      Index
+  )
+{
+  FAT_VOLUME  *Volume;
+  FAT_EXTENT  *Extent;
+  FAT_EXTENT  *Extents;
+  UINTN       Cluster;
+  UINTN       ExtentMax;
+
+  Volume = OFile->Volume;
+  Extent = NULL;
+  if (OFile->ExtentCount > 0) {
+    Extent = &OFile->Extents[OFile->ExtentCount - 1];
+  }
+
+  while (!OFile->ExtentComplete && (OFile->ExtentClusters <= Index)) {
+    if (Extent == NULL) {
+      Cluster = OFile->FileCluster;
+    } else {
+      Cluster = FatGetFatEntry (Volume, Extent->DiskCluster + Extent->Length - 1);
+    }
+
+    if ((Cluster == FAT_CLUSTER_FREE) && (Extent == NULL)) {
+      OFile->ExtentComplete = TRUE;
+      break;
+    }
+
+    if (FAT_END_OF_FAT_CHAIN (Cluster)) {
+      OFile->ExtentComplete = TRUE;
+      break;
+    }
+
+    if ((Cluster < FAT_MIN_CLUSTER) || (Cluster > Volume->MaxCluster + 1)) {
+      DEBUG ((DEBUG_INIT | DEBUG_ERROR, "FatExtendExtentCache: cluster chain corrupt\n"));
+      return EFI_VOLUME_CORRUPTED;
+    }
+
+    if ((Extent != NULL) && (Cluster == Extent->DiskCluster + Extent->Length)) {
+      Extent->Length++;
+    } else {
+      if (OFile->ExtentCount == OFile->ExtentMax) {
+        //
+        // Leave the rest of the chain to be walked if the cache cannot grow
+        //
+        if (OFile->ExtentMax >= FAT_EXTENT_MAX_COUNT) {
+          break;
+        }
+
+        ExtentMax = MAX (OFile->ExtentMax * 2, FAT_EXTENT_MIN_COUNT);
+        Extents   = ReallocatePool (
+                      OFile->ExtentMax * sizeof (FAT_EXTENT),
+                      ExtentMax * sizeof (FAT_EXTENT),
+                      OFile->Extents
+                      );
+        if (Extents == NULL) {
+          break;
+        }
+
+        OFile->Extents   = Extents;
+        OFile->ExtentMax = ExtentMax;
+      }
+
+      Extent              = &OFile->Extents[OFile->ExtentCount];
+      Extent->FileCluster = OFile->ExtentClusters;
+      Extent->DiskCluster = Cluster;
+      Extent->Length      = 1;
+      OFile->ExtentCount++;
+    }
+
+    OFile->ExtentClusters++;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Find the extent that maps the file cluster Index in the extent cache of
+  the open file.
+
+  @param  OFile                 - The open file.
+  @param  Index                 - The index of the file cluster.
+
+  @return The extent of the file cluster, or NULL if it is not cached.
+
+**/
+STATIC
+FAT_EXTENT *
+FatLookupExtent (
+  IN FAT_OFILE  *OFile,
+  IN UINTN      Index
+  )
+{
+  FAT_EXTENT  *Extent;
+  UINTN       Low;
+  UINTN       High;
+  UINTN       Middle;
+
+  if (Index >= OFile->ExtentClusters) {
+    return NULL;
+  }
+
+  Low  = 0;
+  High = OFile->ExtentCount;
+  while (Low < High) {
+    Middle = (Low + High) / 2;
+    Extent = &OFile->Extents[Middle];
+    if (Index < Extent->FileCluster) {
+      High = Middle;
+    } else if (Index >= Extent->FileCluster + Extent->Length) {
+      Low = Middle + 1;
+    } else {
+      return Extent;
+    }
+  }
+
+  return NULL;
+}
+
 /**
 
   Shrink the end of the open file base on the file size.
@@ -366,6 +638,7 @@ FatShrinkEof (
   ASSERT_VOLUME_LOCKED (Volume);
 
   NewSize = FatSizeToClusters (Volume, OFile->FileSize);
+  FatTrimExtentCache (OFile, NewSize);
 
   //
   // Find the address of the last cluster
@@ -456,6 +729,11 @@ FatGrowEof (
   NewSize = FatSizeToClusters (Volume, (UINTN)NewSizeInBytes);
 
   if (CurSize < NewSize) {
+    //
+    // The cluster chain gets longer than the cached extents may know
+    //
+    OFile->ExtentComplete = FALSE;
+
     //
     // If we haven't found the files last cluster do it now
     //
@@ -566,10 +844,14 @@ FatOFilePosition (
   )
 {
   FAT_VOLUME  *Volume;
+  FAT_EXTENT  *Extent;
+  EFI_STATUS  Status;
   UINTN       ClusterSize;
   UINTN       Cluster;
   UINTN       StartPos;
   UINTN       Run;
+  UINTN       Index;
+  UINTN       LastIndex;
 
   Volume      = OFile->Volume;
   ClusterSize = Volume->ClusterSize;
@@ -584,6 +866,41 @@ FatOFilePosition (
     OFile->PosDisk = Volume->RootPos + Position;
     Run            = OFile->FileSize - Position;
   } else {
+    //
+    // Map the clusters of the access with the extent cache, which is
+    // extended from the cluster chain as far as the access goes
+    //
+    Index     = Position >> Volume->ClusterAlignment;
+    LastIndex = Index;
+    if (PosLimit > 0) {
+      LastIndex = (UINTN)RShiftU64 ((UINT64)Position + PosLimit - 1, Volume->ClusterAlignment);
+    }
+
+    Status = FatExtendExtentCache (OFile, LastIndex);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Extent = FatLookupExtent (OFile, Index);
+    if (Extent != NULL) {
+      Cluster  = Extent->DiskCluster + Index - Extent->FileCluster;
+      StartPos = Index << Volume->ClusterAlignment;
+      Run      = MIN (Extent->FileCluster + Extent->Length, LastIndex + 1) - Index;
+
+      OFile->PosDisk = Volume->FirstClusterPos +
+                       LShiftU64 (Cluster - FAT_MIN_CLUSTER, Volume->ClusterAlignment) +
+                       Position - StartPos;
+      OFile->FileCurrentCluster = Cluster;
+      OFile->Position           = StartPos;
+      OFile->PosRem             = (Run << Volume->ClusterAlignment) - (Position - StartPos);
+      return EFI_SUCCESS;
+    }
+
+    if (OFile->ExtentComplete) {
+      DEBUG ((DEBUG_INIT | DEBUG_ERROR, "FatOFilePosition:" " cluster chain corrupt\n"));
+      return EFI_VOLUME_CORRUPTED;
+    }
+
     //
     // Run the file's cluster chain to find the current position
     // If possible, run from the current cluster rather than
@@ -603,6 +920,15 @@ FatOFilePosition (
       Cluster  = OFile->FileCluster;
     }
 
+    //
+    // The extent cache is full, start from its last cluster if that is closer
+    //
+    if ((OFile->ExtentCount > 0) && (((OFile->ExtentClusters - 1) << Volume->ClusterAlignment) > StartPos)) {
+      Extent   = &OFile->Extents[OFile->ExtentCount - 1];
+      Cluster  = Extent->DiskCluster + Extent->Length - 1;
+      StartPos = (OFile->ExtentClusters - 1) << Volume->ClusterAlignment;
+    }
+
     while (StartPos + ClusterSize <= Position) {
       StartPos += ClusterSize;
       if ((Cluster == FAT_CLUSTER_FREE) || (Cluster >= FAT_CLUSTER_SPECIAL)) {
@@ -745,3 +1071,109 @@ FatComputeFreeInfo (
     Volume->FatInfoSector.InfoEndSignature   = FAT_INFO_END_SIGNATURE;
   }
 }
+
+/**
+
+  Build the free cluster bitmap of the volume from the FAT and update
+  the free cluster info of FatInfoSector of the volume.
+
+  The free cluster count read from the FSInfo sector is only a hint, it is
+  replaced by the count of the bitmap. The next free cluster hint is kept as
+  the start of the search for a free cluster. If the bitmap cannot be built,
+  free clusters are searched in the FAT.
+
+  @param  Volume                - FAT file system volume.
+
+**/
+VOID
+FatInitializeFreeBitmap (
+  IN FAT_VOLUME  *Volume
+  )
+{
+  UINT32      *Bitmap;
+  VOID        *Buffer;
+  UINTN       EntrySize;
+  UINTN       Index;
+  UINTN       Count;
+  UINTN       Entry;
+  UINTN       Value;
+  UINTN       FreeCount;
+  EFI_STATUS  Status;
+
+  Bitmap = AllocateZeroPool (((Volume->MaxCluster + 2 + 31) / 32) * sizeof (UINT32));
+  if (Bitmap == NULL) {
+    DEBUG ((DEBUG_WARN, "FatInitializeFreeBitmap: no memory for %d clusters\n", (UINT32)Volume->MaxCluster));
+    return;
+  }
+
+  FreeCount = 0;
+  if (Volume->FatType == Fat12) {
+    //
+    // The FAT12 entries are not byte aligned, but there are only 4K of them
+    //
+    for (Index = FAT_MIN_CLUSTER; Index <= Volume->MaxCluster + 1; Index++) {
+      if (FatGetFatEntry (Volume, Index) == FAT_CLUSTER_FREE) {
+        Bitmap[Index / 32] |= (UINT32)1 << (Index % 32);
+        FreeCount++;
+      }
+    }
+  } else {
+    Buffer = AllocatePool (FAT_FREE_BITMAP_SCAN_SIZE);
+    if (Buffer == NULL) {
+      FreePool (Bitmap);
+      return;
+    }
+
+    EntrySize = (Volume->FatType == Fat16) ? sizeof (UINT16) : sizeof (UINT32);
+    for (Index = FAT_MIN_CLUSTER; Index <= Volume->MaxCluster + 1; Index += Count) {
+      Count  = MIN (FAT_FREE_BITMAP_SCAN_SIZE / EntrySize, Volume->MaxCluster + 2 - Index);
+      Status = FatDiskIo (
+                 Volume,
+                 ReadFat,
+                 Volume->FatPos + Index * EntrySize,
+                 Count * EntrySize,
+                 Buffer,
+                 NULL
+                 );
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+
+      for (Entry = 0; Entry < Count; Entry++) {
+        if (Volume->FatType == Fat16) {
+          Value = ((UINT16 *)Buffer)[Entry];
+        } else {
+          Value = ((UINT32 *)Buffer)[Entry] & FAT_CLUSTER_MASK_FAT32;
+        }
+
+        if (Value == FAT_CLUSTER_FREE) {
+          Bitmap[(Index + Entry) / 32] |= (UINT32)1 << ((Index + Entry) % 32);
+          FreeCount++;
+        }
+      }
+    }
+
+    FreePool (Buffer);
+  }
+
+  if (Volume->DiskError || (Index <= Volume->MaxCluster + 1)) {
+    FreePool (Bitmap);
+    return;
+  }
+
+  if (Volume->FreeInfoValid && (Volume->FatInfoSector.FreeInfo.ClusterCount != FreeCount)) {
+    DEBUG ((
+      DEBUG_INFO,
+      "FatInitializeFreeBitmap: FSInfo free cluster count %d is corrected to %d\n",
+      Volume->FatInfoSector.FreeInfo.ClusterCount,
+      (UINT32)FreeCount
+      ));
+  }
+
+  Volume->FreeBitmap                          = Bitmap;
+  Volume->FreeInfoValid                       = TRUE;
+  Volume->FatInfoSector.FreeInfo.ClusterCount = (UINT32)FreeCount;
+  Volume->FatInfoSector.Signature             = FAT_INFO_SIGNATURE;
+  Volume->FatInfoSector.InfoBeginSignature    = FAT_INFO_BEGIN_SIGNATURE;
+  Volume->FatInfoSector.InfoEndSignature      = FAT_INFO_END_SIGNATURE;
+}
@@ -103,6 +103,11 @@ FatAllocateVolume (
     goto Done;
   }
 
+  //
+  // Build the free cluster bitmap through the FAT cache
+  //
+  FatInitializeFreeBitmap (Volume);
+
   //
   // Install our protocol interfaces on the device's handle
   //
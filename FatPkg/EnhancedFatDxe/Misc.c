@@ -468,6 +468,13 @@ FatFreeVolume (
     FreePool (Volume->CacheBuffer);
   }
 
+  //
+  // Free the free cluster bitmap
+  //
+  if (Volume->FreeBitmap != NULL) {
+    FreePool (Volume->FreeBitmap);
+  }
+
   //
   // Free directory cache
   //
@@ -629,6 +629,10 @@ DumpSmiHandler (
         }
 
         Print (L"      </Caller>\n", SmiHandlerStruct->Handler);
+        if ((SmiStruct->Header.Revision >= 0x0002) && (HandlerCategory != SmmCoreSmiHandlerCategoryHardwareHandler)) {
+          Print (L"      <Profile InvocationCount=\"%ld\" TotalTimeNs=\"%ld\"/>\n", SmiHandlerStruct->InvocationCount, SmiHandlerStruct->TotalTimeNs);
+        }
+
         SmiHandlerStruct = (VOID *)((UINTN)SmiHandlerStruct + SmiHandlerStruct->Length);
         Print (L"    </SmiHandler>\n");
       }
@@ -0,0 +1,270 @@
+/** @file
+  Shell application to dump the SMI latency histograms.
+
+  The p50 and p99 values are the upper bound of the histogram bucket holding
+  the percentile, so they over-estimate the latency by less than a factor 2.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <PiDxe.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/DebugLib.h>
+#include <Library/PrintLib.h>
+#include <Library/UefiLib.h>
+#include <Protocol/SmmCommunication.h>
+#include <Guid/PiSmmCommunicationRegionTable.h>
+
+#include <Guid/SmiLatencyHistogram.h>
+
+CHAR16  *mSmiLatencyPhaseName[] = {
+  L"Rendezvous",
+  L"Dispatch",
+  L"ExitSync",
+  L"Total"
+};
+
+EFI_SMM_COMMUNICATION_PROTOCOL  *mSmmCommunication;
+UINT8                           *mCommBuffer;
+
+/**
+  Get the latency in nanoseconds below which the given percentage of the
+  samples of a histogram is.
+
+  @param  Histogram   The SMI latency histogram.
+  @param  Percentile  The percentage of the samples.
+
+  @return The upper bound of the bucket that holds the percentile.
+**/
+UINT64
+GetPercentileNs (
+  IN SMI_LATENCY_HISTOGRAM  *Histogram,
+  IN UINTN                  Percentile
+  )
+{
+  UINT64  Target;
+  UINT64  Sum;
+  UINTN   Index;
+
+  Target = DivU64x32 (MultU64x32 (Histogram->Count, (UINT32)Percentile) + 99, 100);
+  if (Target == 0) {
+    Target = 1;
+  }
+
+  Sum = 0;
+  for (Index = 0; Index < SMI_LATENCY_HISTOGRAM_BUCKET_COUNT - 1; Index++) {
+    Sum += Histogram->Bucket[Index];
+    if (Sum >= Target) {
+      return MIN (LShiftU64 (1, Index + 1) - 1, Histogram->MaxNs);
+    }
+  }
+
+  return Histogram->MaxNs;
+}
+
+/**
+  Print a latency in microseconds.
+
+  @param  Ns  The latency in nanoseconds.
+**/
+VOID
+PrintUs (
+  IN UINT64  Ns
+  )
+{
+  UINT32  Remainder;
+  UINT64  Us;
+
+  Us = DivU64x32Remainder (Ns, 1000, &Remainder);
+  Print (L" %8ld.%03d", Us, Remainder);
+}
+
+/**
+  Print one SMI latency histogram.
+
+  @param  Name       The name of the histogram.
+  @param  Histogram  The SMI latency histogram.
+**/
+VOID
+DumpHistogram (
+  IN CHAR16                 *Name,
+  IN SMI_LATENCY_HISTOGRAM  *Histogram
+  )
+{
+  Print (L"  %-36s %10ld", Name, Histogram->Count);
+  if (Histogram->Count == 0) {
+    Print (L"\n");
+    return;
+  }
+
+  PrintUs (DivU64x64Remainder (Histogram->TotalNs, Histogram->Count, NULL));
+  PrintUs (GetPercentileNs (Histogram, 50));
+  PrintUs (GetPercentileNs (Histogram, 99));
+  PrintUs (Histogram->MaxNs);
+  Print (L"\n");
+}
+
+/**
+  Send a command to the SMI latency histogram SMI handlers.
+
+  @param  Parameter  The parameter of the command in the communication buffer.
+  @param  Size       The size of the parameter.
+
+  @retval EFI_SUCCESS  The command was handled.
+  @retval Others       The command failed.
+**/
+EFI_STATUS
+SendCommand (
+  IN SMI_LATENCY_HISTOGRAM_PARAMETER_HEADER  *Parameter,
+  IN UINTN                                   Size
+  )
+{
+  EFI_STATUS                  Status;
+  EFI_SMM_COMMUNICATE_HEADER  *CommHeader;
+  UINTN                       CommSize;
+
+  CommHeader = (EFI_SMM_COMMUNICATE_HEADER *)mCommBuffer;
+  CopyGuid (&CommHeader->HeaderGuid, &gSmiLatencyHistogramGuid);
+  CommHeader->MessageLength = Size;
+
+  Parameter->DataLength   = (UINT32)Size;
+  Parameter->ReturnStatus = (UINT64)-1;
+
+  CommSize = OFFSET_OF (EFI_SMM_COMMUNICATE_HEADER, Data) + Size;
+  Status   = mSmmCommunication->Communicate (mSmmCommunication, mCommBuffer, &CommSize);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  return (EFI_STATUS)Parameter->ReturnStatus;
+}
+
+/**
+  Locate the SMM communication protocol and a communication buffer.
+
+  @retval EFI_SUCCESS  The communication buffer is ready.
+  @retval Others       The SMM communication is not available.
+**/
+EFI_STATUS
+InitializeCommunication (
+  VOID
+  )
+{
+  EFI_STATUS                               Status;
+  EDKII_PI_SMM_COMMUNICATION_REGION_TABLE  *PiSmmCommunicationRegionTable;
+  EFI_MEMORY_DESCRIPTOR                    *Entry;
+  UINT32                                   Index;
+
+  Status = gBS->LocateProtocol (&gEfiSmmCommunicationProtocolGuid, NULL, (VOID **)&mSmmCommunication);
+  if (EFI_ERROR (Status)) {
+    Print (L"SmiLatencyInfo: Locate SmmCommunication protocol - %r\n", Status);
+    return Status;
+  }
+
+  Status = EfiGetSystemConfigurationTable (
+             &gEdkiiPiSmmCommunicationRegionTableGuid,
+             (VOID **)&PiSmmCommunicationRegionTable
+             );
+  if (EFI_ERROR (Status)) {
+    Print (L"SmiLatencyInfo: Get PiSmmCommunicationRegionTable - %r\n", Status);
+    return Status;
+  }
+
+  Entry = (EFI_MEMORY_DESCRIPTOR *)(PiSmmCommunicationRegionTable + 1);
+  for (Index = 0; Index < PiSmmCommunicationRegionTable->NumberOfEntries; Index++) {
+    if ((Entry->Type == EfiConventionalMemory) &&
+        (EFI_PAGES_TO_SIZE ((UINTN)Entry->NumberOfPages) >= EFI_PAGE_SIZE))
+    {
+      mCommBuffer = (UINT8 *)(UINTN)Entry->PhysicalStart;
+      return EFI_SUCCESS;
+    }
+
+    Entry = (EFI_MEMORY_DESCRIPTOR *)((UINT8 *)Entry + PiSmmCommunicationRegionTable->DescriptorSize);
+  }
+
+  Print (L"SmiLatencyInfo: No SMM communication buffer\n");
+  return EFI_NOT_FOUND;
+}
+
+/**
+  The user Entry Point for Application. The user code starts with this function
+  as the real entry point for the image goes into a library that calls this function.
+
+  @param[in] ImageHandle    The firmware allocated handle for the EFI image.
+  @param[in] SystemTable    A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS       The entry point is executed successfully.
+  @retval other             Some error occurs when executing this entry point.
+
+**/
+EFI_STATUS
+EFIAPI
+SmiLatencyInfoEntrypoint (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS                                   Status;
+  SMI_LATENCY_HISTOGRAM_PARAMETER_GET_PHASES   *GetPhases;
+  SMI_LATENCY_HISTOGRAM_PARAMETER_GET_HANDLER  *GetHandler;
+  SMI_LATENCY_HISTOGRAM                        Histogram;
+  EFI_GUID                                     HandlerType;
+  CHAR16                                       Name[40];
+  UINT32                                       Index;
+
+  Status = InitializeCommunication ();
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Print (L"  %-36s %10s %12s %12s %12s %12s\n", L"SMI latency (us)", L"Count", L"Average", L"p50", L"p99", L"Max");
+
+  //
+  // Dump the SMI phases
+  //
+  GetPhases                 = (SMI_LATENCY_HISTOGRAM_PARAMETER_GET_PHASES *)&mCommBuffer[OFFSET_OF (EFI_SMM_COMMUNICATE_HEADER, Data)];
+  GetPhases->Header.Command = SMI_LATENCY_HISTOGRAM_COMMAND_GET_PHASES;
+  Status                    = SendCommand (&GetPhases->Header, sizeof (*GetPhases));
+  if (EFI_ERROR (Status)) {
+    Print (L"SmiLatencyInfo: GetPhases - %r\n", Status);
+  } else {
+    for (Index = 0; Index < SmiLatencyPhaseMax; Index++) {
+      CopyMem (&Histogram, &GetPhases->Phase[Index], sizeof (Histogram));
+      DumpHistogram (mSmiLatencyPhaseName[Index], &Histogram);
+    }
+  }
+
+  //
+  // Dump the SMI handlers until the SMM core returns EFI_NOT_FOUND
+  //
+  Print (L"\n");
+  GetHandler = (SMI_LATENCY_HISTOGRAM_PARAMETER_GET_HANDLER *)&mCommBuffer[OFFSET_OF (EFI_SMM_COMMUNICATE_HEADER, Data)];
+  for (Index = 0; ; Index++) {
+    GetHandler->Header.Command = SMI_LATENCY_HISTOGRAM_COMMAND_GET_HANDLER;
+    GetHandler->Index          = Index;
+    Status                     = SendCommand (&GetHandler->Header, sizeof (*GetHandler));
+    if (EFI_ERROR (Status)) {
+      if (Status != EFI_NOT_FOUND) {
+        Print (L"SmiLatencyInfo: GetHandler - %r\n", Status);
+      }
+
+      break;
+    }
+
+    CopyGuid (&HandlerType, &GetHandler->HandlerType);
+    CopyMem (&Histogram, &GetHandler->Histogram, sizeof (Histogram));
+    if (Index == 0) {
+      UnicodeSPrint (Name, sizeof (Name), L"RootSmi");
+    } else {
+      UnicodeSPrint (Name, sizeof (Name), L"%g", &HandlerType);
+    }
+
+    DumpHistogram (Name, &Histogram);
+  }
+
+  return EFI_SUCCESS;
+}
@@ -480,8 +480,9 @@ AhciBuildCommand (
   UINT32   PrdtIndex;
   UINTN    RemainedData;
   UINTN    MemAddr;
-  DATA_64  Data64;
-  UINT32   Offset;
+  DATA_64                Data64;
+  UINT32                 Offset;
+  EFI_AHCI_COMMAND_LIST  *CmdListEntry;
 
   //
   // Filling the PRDT
@@ -548,16 +549,13 @@ AhciBuildCommand (
     AhciRegisters->AhciCommandTable->PrdtTable[PrdtNumber - 1].AhciPrdtIoc = 1;
   }
 
-  CopyMem (
-    (VOID *)((UINTN)AhciRegisters->AhciCmdList + (UINTN)CommandSlotNumber * sizeof (EFI_AHCI_COMMAND_LIST)),
-    CommandList,
-    sizeof (EFI_AHCI_COMMAND_LIST)
-    );
+  CmdListEntry = &AhciRegisters->AhciCmdList[Port * EFI_AHCI_MAX_COMMAND_SLOTS + CommandSlotNumber];
+  CopyMem (CmdListEntry, CommandList, sizeof (EFI_AHCI_COMMAND_LIST));
 
-  Data64.Uint64                                              = (UINT64)(UINTN)AhciRegisters->AhciCommandTablePciAddr;
-  AhciRegisters->AhciCmdList[CommandSlotNumber].AhciCmdCtba  = Data64.Uint32.Lower32;
-  AhciRegisters->AhciCmdList[CommandSlotNumber].AhciCmdCtbau = Data64.Uint32.Upper32;
-  AhciRegisters->AhciCmdList[CommandSlotNumber].AhciCmdPmp   = PortMultiplier;
+  Data64.Uint64              = (UINT64)(UINTN)AhciRegisters->AhciCommandTablePciAddr;
+  CmdListEntry->AhciCmdCtba  = Data64.Uint32.Lower32;
+  CmdListEntry->AhciCmdCtbau = Data64.Uint32.Upper32;
+  CmdListEntry->AhciCmdPmp   = PortMultiplier;
 }
 
 /**
@@ -1072,7 +1070,7 @@ AhciPioTransfer (
     if (Read && (AtapiCommand == 0)) {
       Status = AhciWaitUntilFisReceived (PciIo, Port, Timeout, SataFisPioSetup);
       if (Status == EFI_SUCCESS) {
-        PrdCount = *(volatile UINT32 *)(&(AhciRegisters->AhciCmdList[0].AhciCmdPrdbc));
+        PrdCount = *(volatile UINT32 *)(&(AhciRegisters->AhciCmdList[Port * EFI_AHCI_MAX_COMMAND_SLOTS].AhciCmdPrdbc));
         if (PrdCount == DataCount) {
           Status = EFI_SUCCESS;
         } else {
@@ -1564,28 +1562,25 @@ AhciStopCommand (
 }
 
 /**
-  Start command for give slot on specific port.
+  Start the command list processing of specific port.
 
   @param  PciIo              The PCI IO protocol instance.
   @param  Port               The number of port.
-  @param  CommandSlot        The number of Command Slot.
   @param  Timeout            The timeout value of start, uses 100ns as a unit.
 
-  @retval EFI_DEVICE_ERROR   The command start unsuccessfully.
+  @retval EFI_DEVICE_ERROR   The port start unsuccessfully.
   @retval EFI_TIMEOUT        The operation is time out.
-  @retval EFI_SUCCESS        The command start successfully.
+  @retval EFI_SUCCESS        The port start successfully.
 
 **/
 EFI_STATUS
 EFIAPI
-AhciStartCommand (
+AhciStartPort (
   IN  EFI_PCI_IO_PROTOCOL  *PciIo,
   IN  UINT8                Port,
-  IN  UINT8                CommandSlot,
   IN  UINT64               Timeout
   )
 {
-  UINT32      CmdSlotBit;
   EFI_STATUS  Status;
   UINT32      PortStatus;
   UINT32      StartCmd;
@@ -1598,8 +1593,6 @@ AhciStartCommand (
   //
   Capability = AhciReadReg (PciIo, EFI_AHCI_CAPABILITY_OFFSET);
 
-  CmdSlotBit = (UINT32)(1 << CommandSlot);
-
   AhciClearPortStatus (
     PciIo,
     Port
@@ -1646,6 +1639,42 @@ AhciStartCommand (
   Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CMD;
   AhciOrReg (PciIo, Offset, EFI_AHCI_PORT_CMD_ST | StartCmd);
 
+  return EFI_SUCCESS;
+}
+
+/**
+  Start command for give slot on specific port.
+
+  @param  PciIo              The PCI IO protocol instance.
+  @param  Port               The number of port.
+  @param  CommandSlot        The number of Command Slot.
+  @param  Timeout            The timeout value of start, uses 100ns as a unit.
+
+  @retval EFI_DEVICE_ERROR   The command start unsuccessfully.
+  @retval EFI_TIMEOUT        The operation is time out.
+  @retval EFI_SUCCESS        The command start successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciStartCommand (
+  IN  EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN  UINT8                Port,
+  IN  UINT8                CommandSlot,
+  IN  UINT64               Timeout
+  )
+{
+  UINT32      CmdSlotBit;
+  EFI_STATUS  Status;
+  UINT32      Offset;
+
+  CmdSlotBit = (UINT32)(1 << CommandSlot);
+
+  Status = AhciStartPort (PciIo, Port, Timeout);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   //
   // Setting the command
   //
@@ -2222,7 +2251,6 @@ AhciCreateTransferDescriptor (
   UINT32                Capability;
   UINT32                PortImplementBitMap;
   UINT8                 MaxPortNumber;
-  UINT8                 MaxCommandSlotNumber;
   BOOLEAN               Support64Bit;
   UINT64                MaxReceiveFisSize;
   UINT64                MaxCommandListSize;
@@ -2235,12 +2263,8 @@ AhciCreateTransferDescriptor (
   //
   // Collect AHCI controller information
   //
-  Capability = AhciReadReg (PciIo, EFI_AHCI_CAPABILITY_OFFSET);
-  //
-  // Get the number of command slots per port supported by this HBA.
-  //
-  MaxCommandSlotNumber = (UINT8)(((Capability & 0x1F00) >> 8) + 1);
-  Support64Bit         = (BOOLEAN)(((Capability & BIT31) != 0) ? TRUE : FALSE);
+  Capability   = AhciReadReg (PciIo, EFI_AHCI_CAPABILITY_OFFSET);
+  Support64Bit = (BOOLEAN)(((Capability & BIT31) != 0) ? TRUE : FALSE);
 
   PortImplementBitMap = AhciReadReg (PciIo, EFI_AHCI_PI_OFFSET);
   //
@@ -2300,10 +2324,11 @@ AhciCreateTransferDescriptor (
 
   //
   // Allocate memory for command list
-  // Note that the implementation is a single task model which only use a command list for all ports.
+  // Every port owns a command list, so the queued commands of a port don't share
+  // the command slots with the commands of the other ports.
   //
   Buffer             = NULL;
-  MaxCommandListSize = MaxCommandSlotNumber * sizeof (EFI_AHCI_COMMAND_LIST);
+  MaxCommandListSize = MaxPortNumber * EFI_AHCI_MAX_COMMAND_SLOTS * sizeof (EFI_AHCI_COMMAND_LIST);
   Status             = PciIo->AllocateBuffer (
                                 PciIo,
                                 AllocateAnyPages,
@@ -2851,6 +2876,674 @@ AhciPuisEnable (
   return Status;
 }
 
+/**
+  Enable Native Command Queuing on the port if both the HBA and the device
+  support it. One command table is allocated for each command slot usable by
+  the queued commands.
+
+  @param  PciIo               The PCI IO protocol instance.
+  @param  AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param  Port                The number of port.
+  @param  IdentifyData        A pointer to data buffer which is used to contain IDENTIFY data.
+
+  @retval EFI_SUCCESS           Native Command Queuing is enabled on the port.
+  @retval EFI_UNSUPPORTED       The HBA or the device doesn't support Native Command Queuing.
+  @retval EFI_OUT_OF_RESOURCES  The command tables cannot be allocated.
+**/
+EFI_STATUS
+AhciNcqInitPort (
+  IN EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN EFI_AHCI_REGISTERS   *AhciRegisters,
+  IN UINT8                Port,
+  IN EFI_IDENTIFY_DATA    *IdentifyData
+  )
+{
+  EFI_STATUS            Status;
+  UINT32                Capability;
+  UINT32                SlotCount;
+  EFI_AHCI_NCQ_PORT     *NcqPort;
+  VOID                  *Buffer;
+  UINTN                 Bytes;
+  EFI_PHYSICAL_ADDRESS  PciAddr;
+
+  //
+  // Word 76 bit 8 of IDENTIFY data reports the support of Native Command Queuing
+  // and word 75 bits 4:0 report the maximum queue depth minus one.
+  //
+  Capability = AhciReadReg (PciIo, EFI_AHCI_CAPABILITY_OFFSET);
+  if (((Capability & EFI_AHCI_CAP_SNCQ) == 0) ||
+      (IdentifyData->AtaData.serial_ata_capabilities == 0xFFFF) ||
+      ((IdentifyData->AtaData.serial_ata_capabilities & BIT8) == 0))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  SlotCount = MIN (((Capability & 0x1F00) >> 8) + 1, (IdentifyData->AtaData.queue_depth & 0x1F) + 1);
+
+  NcqPort = AllocateZeroPool (sizeof (EFI_AHCI_NCQ_PORT));
+  if (NcqPort == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  NcqPort->CommandTablePages = EFI_SIZE_TO_PAGES (SlotCount * sizeof (EFI_AHCI_NCQ_COMMAND_TABLE));
+  Status                     = PciIo->AllocateBuffer (
+                                        PciIo,
+                                        AllocateAnyPages,
+                                        EfiBootServicesData,
+                                        NcqPort->CommandTablePages,
+                                        &Buffer,
+                                        0
+                                        );
+  if (EFI_ERROR (Status)) {
+    FreePool (NcqPort);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ZeroMem (Buffer, EFI_PAGES_TO_SIZE (NcqPort->CommandTablePages));
+
+  Bytes  = EFI_PAGES_TO_SIZE (NcqPort->CommandTablePages);
+  Status = PciIo->Map (
+                    PciIo,
+                    EfiPciIoOperationBusMasterCommonBuffer,
+                    Buffer,
+                    &Bytes,
+                    &PciAddr,
+                    &NcqPort->MapCommandTable
+                    );
+  if (!EFI_ERROR (Status) &&
+      ((Bytes != EFI_PAGES_TO_SIZE (NcqPort->CommandTablePages)) ||
+       (((Capability & EFI_AHCI_CAP_S64A) == 0) && (PciAddr + Bytes > 0x100000000ULL))))
+  {
+    //
+    // Unable to map the whole command tables into a contiguous region below 4G
+    // for an AHCI HBA that doesn't support 64bit addressing.
+    //
+    PciIo->Unmap (PciIo, NcqPort->MapCommandTable);
+    Status = EFI_OUT_OF_RESOURCES;
+  }
+
+  if (EFI_ERROR (Status)) {
+    PciIo->FreeBuffer (PciIo, NcqPort->CommandTablePages, Buffer);
+    FreePool (NcqPort);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  NcqPort->CommandTable        = Buffer;
+  NcqPort->CommandTablePciAddr = (EFI_AHCI_NCQ_COMMAND_TABLE *)(UINTN)PciAddr;
+  NcqPort->SlotMask            = (SlotCount == EFI_AHCI_MAX_COMMAND_SLOTS) ? MAX_UINT32 : (((UINT32)BIT0 << SlotCount) - 1);
+
+  AhciRegisters->NcqPort[Port] = NcqPort;
+
+  DEBUG ((DEBUG_INFO, "Port %d uses Native Command Queuing with %d command slots\n", Port, SlotCount));
+  return EFI_SUCCESS;
+}
+
+/**
+  Free the command tables of the ports using Native Command Queuing.
+
+  @param[in]  PciIo             The PCI IO protocol instance.
+  @param[in]  AhciRegisters     The pointer to the EFI_AHCI_REGISTERS.
+
+**/
+VOID
+AhciFreeNcqResources (
+  IN EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN EFI_AHCI_REGISTERS   *AhciRegisters
+  )
+{
+  UINT8              Port;
+  EFI_AHCI_NCQ_PORT  *NcqPort;
+
+  for (Port = 0; Port < EFI_AHCI_MAX_PORTS; Port++) {
+    NcqPort = AhciRegisters->NcqPort[Port];
+    if (NcqPort == NULL) {
+      continue;
+    }
+
+    PciIo->Unmap (PciIo, NcqPort->MapCommandTable);
+    PciIo->FreeBuffer (PciIo, NcqPort->CommandTablePages, NcqPort->CommandTable);
+    FreePool (NcqPort);
+    AhciRegisters->NcqPort[Port] = NULL;
+  }
+}
+
+/**
+  Check whether queued commands are in flight on specific port.
+
+  @param[in]  Instance          A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+  @param[in]  Port              The number of port.
+
+  @retval TRUE                  At least one queued command is in flight.
+  @retval FALSE                 No queued command is in flight.
+
+**/
+BOOLEAN
+AhciNcqPortBusy (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN UINT16                        Port
+  )
+{
+  EFI_AHCI_NCQ_PORT  *NcqPort;
+
+  if ((Instance->Mode != EfiAtaAhciMode) || (Port >= EFI_AHCI_MAX_PORTS)) {
+    return FALSE;
+  }
+
+  NcqPort = Instance->AhciRegisters.NcqPort[Port];
+  return (BOOLEAN)((NcqPort != NULL) && (NcqPort->ActiveSlots != 0));
+}
+
+/**
+  Release the command slot of a queued command and unmap its data buffer.
+
+  @param[in]  PciIo             The PCI IO protocol instance.
+  @param[in]  NcqPort           The Native Command Queuing state of the port.
+  @param[in]  Task              The task of the queued command.
+
+**/
+VOID
+AhciNcqReleaseSlot (
+  IN EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN EFI_AHCI_NCQ_PORT    *NcqPort,
+  IN ATA_NONBLOCK_TASK    *Task
+  )
+{
+  NcqPort->ActiveSlots      &= ~((UINT32)BIT0 << Task->Slot);
+  NcqPort->Tasks[Task->Slot] = NULL;
+  Task->IsStart              = FALSE;
+
+  if (Task->Map != NULL) {
+    PciIo->Unmap (PciIo, Task->Map);
+    Task->Map = NULL;
+  }
+}
+
+/**
+  Abort the queued commands in flight on all the ports.
+
+  The ports are stopped and the data buffers of the queued commands are
+  unmapped. The tasks themselves are left to the caller.
+
+  @param[in]  Instance          A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+
+**/
+VOID
+AhciNcqAbort (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance
+  )
+{
+  EFI_PCI_IO_PROTOCOL  *PciIo;
+  EFI_AHCI_NCQ_PORT    *NcqPort;
+  UINT8                Port;
+  UINT8                Slot;
+
+  if (Instance->Mode != EfiAtaAhciMode) {
+    return;
+  }
+
+  PciIo = Instance->PciIo;
+  for (Port = 0; Port < EFI_AHCI_MAX_PORTS; Port++) {
+    NcqPort = Instance->AhciRegisters.NcqPort[Port];
+    if ((NcqPort == NULL) || (NcqPort->ActiveSlots == 0)) {
+      continue;
+    }
+
+    AhciStopCommand (PciIo, Port, ATA_ATAPI_TIMEOUT);
+    AhciDisableFisReceive (PciIo, Port, ATA_ATAPI_TIMEOUT);
+
+    for (Slot = 0; Slot < EFI_AHCI_MAX_COMMAND_SLOTS; Slot++) {
+      if (NcqPort->Tasks[Slot] != NULL) {
+        AhciNcqReleaseSlot (PciIo, NcqPort, NcqPort->Tasks[Slot]);
+      }
+    }
+  }
+}
+
+/**
+  Recover the port from an error or a timeout of its queued commands. The
+  algorithm follows AHCI spec 1.3.1 section 6.2.2.3.
+
+  Stopping the port aborts all the queued commands in flight. The commands
+  reported by the NCQ Command Error log or timed out are marked as failed,
+  the other ones are issued again by the next call of AhciFpdmaTransfer().
+
+  @param[in]  PciIo             The PCI IO protocol instance.
+  @param[in]  AhciRegisters     The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]  Port              The number of port.
+  @param[in]  PortMultiplier    The port multiplier port number.
+  @param[in]  TimeoutSlots      The command slots whose commands timed out.
+
+**/
+VOID
+AhciNcqRecoverPort (
+  IN EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN EFI_AHCI_REGISTERS   *AhciRegisters,
+  IN UINT8                Port,
+  IN UINT8                PortMultiplier,
+  IN UINT32               TimeoutSlots
+  )
+{
+  EFI_STATUS         Status;
+  EFI_AHCI_NCQ_PORT  *NcqPort;
+  UINT32             Offset;
+  UINT32             PortInterrupt;
+  UINT32             PortTfd;
+  UINT32             FailedSlots;
+  BOOLEAN            DoRetry;
+  BOOLEAN            NeedReset;
+  UINT8              Slot;
+  UINT8              LogData[512];
+
+  NcqPort = AhciRegisters->NcqPort[Port];
+
+  Offset        = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_IS;
+  PortInterrupt = AhciReadReg (PciIo, Offset);
+  Offset        = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_TFD;
+  PortTfd       = AhciReadReg (PciIo, Offset);
+  DoRetry       = AhciShouldCmdBeRetried (PciIo, Port); // needs to be called before error recovery
+  FailedSlots   = TimeoutSlots;
+
+  DEBUG ((
+    DEBUG_ERROR,
+    "AHCI: Queued commands aborted on port %d, PxIS: %X PxTFD: %X PxSACT: %X\n",
+    Port,
+    PortInterrupt,
+    PortTfd,
+    AhciReadReg (PciIo, EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SACT)
+    ));
+
+  //
+  // Clearing PxCMD.ST aborts the commands in flight and clears PxSACT and PxCI.
+  //
+  Status = AhciStopCommand (PciIo, Port, ATA_ATAPI_TIMEOUT);
+  AhciClearPortStatus (PciIo, Port);
+
+  //
+  // If TFD.BSY or TFD.DRQ is still set, the device is hung and has to be reset.
+  // Otherwise, after an error, the device rejects the queued commands until the
+  // NCQ Command Error log is read. The log reports the tag of the failed command.
+  //
+  Offset    = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_TFD;
+  NeedReset = (BOOLEAN)(EFI_ERROR (Status) || ((AhciReadReg (PciIo, Offset) & (EFI_AHCI_PORT_TFD_BSY | EFI_AHCI_PORT_TFD_DRQ)) != 0));
+  if (!NeedReset && ((PortInterrupt & EFI_AHCI_PORT_IS_TFES) != 0)) {
+    Status = AhciReadLogExt (PciIo, AhciRegisters, Port, PortMultiplier, LogData, ATA_LOG_NCQ_COMMAND_ERROR, 0);
+    if (EFI_ERROR (Status)) {
+      NeedReset = TRUE;
+    } else if (!DoRetry && ((LogData[0] & BIT7) == 0)) {
+      FailedSlots |= ((UINT32)BIT0 << (LogData[0] & 0x1F)) & NcqPort->ActiveSlots;
+      PortTfd      = (UINT32)LogData[2] | ((UINT32)LogData[3] << 8);
+    }
+  }
+
+  if (NeedReset) {
+    Status = AhciResetPort (PciIo, Port);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "Failed to reset the port %d\n", Port));
+      FailedSlots = NcqPort->ActiveSlots;
+    }
+  }
+
+  //
+  // Fail all the commands in flight if the failed one is unknown.
+  //
+  if (!DoRetry && (FailedSlots == 0) && ((PortInterrupt & EFI_AHCI_PORT_IS_FATAL_ERROR_MASK) != 0)) {
+    FailedSlots = NcqPort->ActiveSlots;
+  }
+
+  for (Slot = 0; Slot < EFI_AHCI_MAX_COMMAND_SLOTS; Slot++) {
+    if (NcqPort->Tasks[Slot] == NULL) {
+      continue;
+    }
+
+    if ((FailedSlots & ((UINT32)BIT0 << Slot)) != 0) {
+      NcqPort->Tasks[Slot]->NcqFailed = TRUE;
+      NcqPort->Tasks[Slot]->NcqTfd    = PortTfd;
+    }
+
+    AhciNcqReleaseSlot (PciIo, NcqPort, NcqPort->Tasks[Slot]);
+  }
+
+  AhciStopCommand (PciIo, Port, ATA_ATAPI_TIMEOUT);
+  AhciDisableFisReceive (PciIo, Port, ATA_ATAPI_TIMEOUT);
+}
+
+/**
+  Issue a queued command in a free command slot of the port.
+
+  @param[in]  PciIo             The PCI IO protocol instance.
+  @param[in]  AhciRegisters     The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]  Port              The number of port.
+  @param[in]  PortMultiplier    The port multiplier port number.
+  @param[in]  Slot              The free command slot.
+  @param[in]  Read              The transfer direction.
+  @param[in]  AtaCommandBlock   The EFI_ATA_COMMAND_BLOCK data.
+  @param[in]  MemoryAddr        The pointer to the data buffer.
+  @param[in]  DataCount         The data count to be transferred.
+  @param[in]  Timeout           The timeout value of starting the port, uses 100ns as a unit.
+  @param[in]  Task              The task of the queued command.
+
+  @retval EFI_SUCCESS           The queued command is issued.
+  @retval EFI_BAD_BUFFER_SIZE   The data buffer cannot be described by the PRDT.
+  @retval Others                The port cannot be started.
+**/
+EFI_STATUS
+AhciNcqIssueCommand (
+  IN EFI_PCI_IO_PROTOCOL    *PciIo,
+  IN EFI_AHCI_REGISTERS     *AhciRegisters,
+  IN UINT8                  Port,
+  IN UINT8                  PortMultiplier,
+  IN UINT8                  Slot,
+  IN BOOLEAN                Read,
+  IN EFI_ATA_COMMAND_BLOCK  *AtaCommandBlock,
+  IN VOID                   *MemoryAddr,
+  IN UINT32                 DataCount,
+  IN UINT64                 Timeout,
+  IN ATA_NONBLOCK_TASK      *Task
+  )
+{
+  EFI_STATUS                     Status;
+  EFI_AHCI_NCQ_PORT              *NcqPort;
+  EFI_AHCI_NCQ_COMMAND_TABLE     *CommandTable;
+  EFI_AHCI_COMMAND_LIST          *CmdList;
+  EFI_PCI_IO_PROTOCOL_OPERATION  Flag;
+  EFI_PHYSICAL_ADDRESS           PhyAddr;
+  UINTN                          MapLength;
+  UINT32                         PrdtNumber;
+  UINT32                         PrdtIndex;
+  UINT32                         RemainedData;
+  DATA_64                        Data64;
+  UINT32                         SlotBit;
+
+  NcqPort    = AhciRegisters->NcqPort[Port];
+  PrdtNumber = (DataCount + EFI_AHCI_MAX_DATA_PER_PRDT - 1) / EFI_AHCI_MAX_DATA_PER_PRDT;
+  if ((DataCount == 0) || (PrdtNumber > EFI_AHCI_NCQ_MAX_PRDT)) {
+    return EFI_BAD_BUFFER_SIZE;
+  }
+
+  if (Read) {
+    Flag = EfiPciIoOperationBusMasterWrite;
+  } else {
+    Flag = EfiPciIoOperationBusMasterRead;
+  }
+
+  MapLength = DataCount;
+  Status    = PciIo->Map (
+                       PciIo,
+                       Flag,
+                       MemoryAddr,
+                       &MapLength,
+                       &PhyAddr,
+                       &Task->Map
+                       );
+  if (EFI_ERROR (Status) || (MapLength != DataCount)) {
+    if (!EFI_ERROR (Status)) {
+      PciIo->Unmap (PciIo, Task->Map);
+    }
+
+    Task->Map = NULL;
+    return EFI_BAD_BUFFER_SIZE;
+  }
+
+  //
+  // The port is stopped while no queued command is in flight.
+  //
+  if (NcqPort->ActiveSlots == 0) {
+    Status = AhciStartPort (PciIo, Port, Timeout);
+    if (EFI_ERROR (Status)) {
+      PciIo->Unmap (PciIo, Task->Map);
+      Task->Map = NULL;
+      return Status;
+    }
+  }
+
+  CommandTable = &NcqPort->CommandTable[Slot];
+  ZeroMem (CommandTable, sizeof (EFI_AHCI_NCQ_COMMAND_TABLE));
+
+  //
+  // The NCQ tag is the command slot, placed in bits 7:3 of the Count field.
+  // Bit 7 of the Device field is FUA, so only bit 6 is forced.
+  //
+  AhciBuildCommandFis (&CommandTable->CommandFis, AtaCommandBlock);
+  CommandTable->CommandFis.AhciCFisPmNum    = PortMultiplier;
+  CommandTable->CommandFis.AhciCFisSecCount = (UINT8)(Slot << 3);
+  CommandTable->CommandFis.AhciCFisDevHead  = (UINT8)(AtaCommandBlock->AtaDeviceHead | BIT6);
+
+  RemainedData = DataCount;
+  for (PrdtIndex = 0; PrdtIndex < PrdtNumber; PrdtIndex++) {
+    Data64.Uint64                                       = PhyAddr + (UINT64)PrdtIndex * EFI_AHCI_MAX_DATA_PER_PRDT;
+    CommandTable->PrdtTable[PrdtIndex].AhciPrdtDba      = Data64.Uint32.Lower32;
+    CommandTable->PrdtTable[PrdtIndex].AhciPrdtDbau     = Data64.Uint32.Upper32;
+    CommandTable->PrdtTable[PrdtIndex].AhciPrdtDbc      = MIN (RemainedData, EFI_AHCI_MAX_DATA_PER_PRDT) - 1;
+    RemainedData                                       -= MIN (RemainedData, EFI_AHCI_MAX_DATA_PER_PRDT);
+  }
+
+  CommandTable->PrdtTable[PrdtNumber - 1].AhciPrdtIoc = 1;
+
+  CmdList = &AhciRegisters->AhciCmdList[Port * EFI_AHCI_MAX_COMMAND_SLOTS + Slot];
+  ZeroMem (CmdList, sizeof (EFI_AHCI_COMMAND_LIST));
+  CmdList->AhciCmdCfl   = EFI_AHCI_FIS_REGISTER_H2D_LENGTH / 4;
+  CmdList->AhciCmdW     = Read ? 0 : 1;
+  CmdList->AhciCmdPmp   = PortMultiplier;
+  CmdList->AhciCmdPrdtl = PrdtNumber;
+  Data64.Uint64         = (UINT64)(UINTN)&NcqPort->CommandTablePciAddr[Slot];
+  CmdList->AhciCmdCtba  = Data64.Uint32.Lower32;
+  CmdList->AhciCmdCtbau = Data64.Uint32.Upper32;
+
+  //
+  // PxSACT must be set before PxCI. Both registers ignore the bits written
+  // as 0, so the commands in flight in the other slots are left alone.
+  //
+  SlotBit = (UINT32)BIT0 << Slot;
+  AhciWriteReg (PciIo, EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SACT, SlotBit);
+  AhciWriteReg (PciIo, EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CI, SlotBit);
+
+  NcqPort->ActiveSlots |= SlotBit;
+  NcqPort->Tasks[Slot]  = Task;
+  Task->Slot            = Slot;
+  Task->IsStart         = TRUE;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Start a queued DMA data transfer (READ/WRITE FPDMA QUEUED) on specific port.
+
+  Up to 32 queued commands are in flight on a port at the same time, each one
+  in its own command slot. The NCQ tag in the Count field of the command block
+  is assigned here from the command slot.
+
+  @param[in]       Instance            The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+  @param[in]       AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]       Port                The number of port.
+  @param[in]       PortMultiplier      The port multiplier port number.
+  @param[in]       Read                The transfer direction.
+  @param[in]       AtaCommandBlock     The EFI_ATA_COMMAND_BLOCK data.
+  @param[in, out]  AtaStatusBlock      The EFI_ATA_STATUS_BLOCK data.
+  @param[in, out]  MemoryAddr          The pointer to the data buffer.
+  @param[in]       DataCount           The data count to be transferred.
+  @param[in]       Timeout             The timeout value of the transfer, uses 100ns as a unit.
+  @param[in]       Task                Optional. Pointer to the ATA_NONBLOCK_TASK
+                                       used by non-blocking mode.
+
+  @retval EFI_NOT_READY       The queued command is waiting for a command slot
+                              or is not completed yet.
+  @retval EFI_UNSUPPORTED     Native Command Queuing is not enabled on the port.
+  @retval EFI_BAD_BUFFER_SIZE The data buffer cannot be described by the PRDT.
+  @retval EFI_DEVICE_ERROR    The queued command is aborted with error.
+  @retval EFI_TIMEOUT         The operation is time out.
+  @retval EFI_SUCCESS         The queued DMA data transfer executes successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciFpdmaTransfer (
+  IN     ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN     EFI_AHCI_REGISTERS            *AhciRegisters,
+  IN     UINT8                         Port,
+  IN     UINT8                         PortMultiplier,
+  IN     BOOLEAN                       Read,
+  IN     EFI_ATA_COMMAND_BLOCK         *AtaCommandBlock,
+  IN OUT EFI_ATA_STATUS_BLOCK          *AtaStatusBlock,
+  IN OUT VOID                          *MemoryAddr,
+  IN     UINT32                        DataCount,
+  IN     UINT64                        Timeout,
+  IN     ATA_NONBLOCK_TASK             *Task
+  )
+{
+  EFI_STATUS           Status;
+  EFI_PCI_IO_PROTOCOL  *PciIo;
+  EFI_AHCI_NCQ_PORT    *NcqPort;
+  ATA_NONBLOCK_TASK    BlockingTask;
+  EFI_TPL              OldTpl;
+  UINT32               FreeSlots;
+  UINT32               SlotBit;
+  UINT32               Offset;
+  UINT32               PortTfd;
+
+  PciIo   = Instance->PciIo;
+  NcqPort = AhciRegisters->NcqPort[Port];
+  if (NcqPort == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (Task == NULL) {
+    //
+    // Before starting the Blocking BlockIO operation, push to finish all non-blocking
+    // BlockIO tasks. Then run the command as a task of its own, checked every 100us.
+    //
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    while (!IsListEmpty (&Instance->NonBlockingTaskList)) {
+      AsyncNonBlockingTransferRoutine (NULL, Instance);
+      MicroSecondDelay (100);
+    }
+
+    gBS->RestoreTPL (OldTpl);
+
+    ZeroMem (&BlockingTask, sizeof (BlockingTask));
+    BlockingTask.RetryTimes   = DivU64x32 (Timeout, 1000) + 1;
+    BlockingTask.InfiniteWait = (BOOLEAN)(Timeout == 0);
+    do {
+      OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+      Status = AhciFpdmaTransfer (
+                 Instance,
+                 AhciRegisters,
+                 Port,
+                 PortMultiplier,
+                 Read,
+                 AtaCommandBlock,
+                 AtaStatusBlock,
+                 MemoryAddr,
+                 DataCount,
+                 Timeout,
+                 &BlockingTask
+                 );
+      gBS->RestoreTPL (OldTpl);
+      if (Status == EFI_NOT_READY) {
+        MicroSecondDelay (100);
+      }
+    } while (Status == EFI_NOT_READY);
+
+    return Status;
+  }
+
+  if (Task->NcqFailed) {
+    //
+    // The command was aborted by the error recovery of the port.
+    //
+    Status = EFI_DEVICE_ERROR;
+  } else if (!Task->IsStart) {
+    FreeSlots = NcqPort->SlotMask & ~NcqPort->ActiveSlots;
+    if (FreeSlots == 0) {
+      //
+      // All the command slots are in use, try again when a command completes.
+      //
+      return EFI_NOT_READY;
+    }
+
+    DEBUG ((DEBUG_VERBOSE, "Starting command for queued DMA transfer:\n"));
+    AhciPrintCommandBlock (AtaCommandBlock, DEBUG_VERBOSE);
+    Status = AhciNcqIssueCommand (
+               PciIo,
+               AhciRegisters,
+               Port,
+               PortMultiplier,
+               (UINT8)LowBitSet32 (FreeSlots),
+               Read,
+               AtaCommandBlock,
+               MemoryAddr,
+               DataCount,
+               Timeout,
+               Task
+               );
+    if (!EFI_ERROR (Status)) {
+      Status = EFI_NOT_READY;
+    }
+  } else {
+    SlotBit = (UINT32)BIT0 << Task->Slot;
+    Offset  = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_IS;
+    if ((AhciReadReg (PciIo, Offset) & EFI_AHCI_PORT_IS_FATAL_ERROR_MASK) != 0) {
+      AhciNcqRecoverPort (PciIo, AhciRegisters, Port, PortMultiplier, 0);
+      Status = Task->NcqFailed ? EFI_DEVICE_ERROR : EFI_NOT_READY;
+    } else if (((AhciReadReg (PciIo, EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_SACT) |
+                 AhciReadReg (PciIo, EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CI)) & SlotBit) == 0)
+    {
+      //
+      // The device cleared the bit of PxSACT by a Set Device Bits FIS.
+      //
+      AhciNcqReleaseSlot (PciIo, NcqPort, Task);
+      Status = EFI_SUCCESS;
+    } else {
+      Status = EFI_NOT_READY;
+    }
+  }
+
+  if (Status == EFI_NOT_READY) {
+    if (!Task->InfiniteWait && (Task->RetryTimes == 0)) {
+      if (Task->IsStart) {
+        AhciNcqRecoverPort (PciIo, AhciRegisters, Port, PortMultiplier, (UINT32)BIT0 << Task->Slot);
+      }
+
+      Status = EFI_TIMEOUT;
+    } else {
+      Task->RetryTimes--;
+    }
+  }
+
+  //
+  // Stop the port once the last queued command completes, as the commands
+  // that are not queued expect.
+  //
+  if (NcqPort->ActiveSlots == 0) {
+    AhciStopCommand (PciIo, Port, Timeout);
+    AhciDisableFisReceive (PciIo, Port, Timeout);
+  }
+
+  if (Status == EFI_NOT_READY) {
+    return Status;
+  }
+
+  ZeroMem (AtaStatusBlock, sizeof (EFI_ATA_STATUS_BLOCK));
+  if (Status == EFI_SUCCESS) {
+    AtaStatusBlock->AtaStatus = ATA_STSREG_DRDY;
+    AhciPrintStatusBlock (AtaStatusBlock, DEBUG_VERBOSE);
+  } else {
+    if (Task->NcqFailed) {
+      PortTfd = Task->NcqTfd;
+    } else {
+      PortTfd = AhciReadReg (PciIo, EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_TFD);
+    }
+
+    AtaStatusBlock->AtaStatus = (UINT8)(PortTfd | ATA_STSREG_ERR);
+    AtaStatusBlock->AtaError  = (UINT8)(PortTfd >> 8);
+
+    DEBUG ((DEBUG_ERROR, "Failed to execute command for queued DMA transfer: %r\n", Status));
+    AhciPrintCommandBlock (AtaCommandBlock, DEBUG_ERROR);
+    AhciPrintStatusBlock (AtaStatusBlock, DEBUG_ERROR);
+  }
+
+  return Status;
+}
+
 /**
   Initialize ATA host controller at AHCI mode.
 
@@ -2974,7 +3667,7 @@ AhciModeInitialization (
       Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_FBU;
       AhciWriteReg (PciIo, Offset, Data64.Uint32.Upper32);
 
-      Data64.Uint64 = (UINTN)(AhciRegisters->AhciCmdListPciAddr);
+      Data64.Uint64 = (UINTN)(AhciRegisters->AhciCmdListPciAddr + Port * EFI_AHCI_MAX_COMMAND_SLOTS);
       Offset        = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CLB;
       AhciWriteReg (PciIo, Offset, Data64.Uint32.Lower32);
       Offset = EFI_AHCI_PORT_START + Port * EFI_AHCI_PORT_REG_WIDTH + EFI_AHCI_PORT_CLBU;
@@ -3189,6 +3882,12 @@ AhciModeInitialization (
           0,
           &Buffer
           );
+        AhciNcqInitPort (
+          PciIo,
+          AhciRegisters,
+          Port,
+          &Buffer
+          );
       }
 
       //
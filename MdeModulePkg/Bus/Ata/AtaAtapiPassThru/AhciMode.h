@@ -13,6 +13,7 @@
 #define EFI_AHCI_CAPABILITY_OFFSET  0x0000
 #define   EFI_AHCI_CAP_SAM          BIT18
 #define   EFI_AHCI_CAP_SSS          BIT27
+#define   EFI_AHCI_CAP_SNCQ         BIT30
 #define   EFI_AHCI_CAP_S64A         BIT31
 #define EFI_AHCI_GHC_OFFSET         0x0004
 #define   EFI_AHCI_GHC_RESET        BIT0
@@ -23,6 +24,12 @@
 
 #define EFI_AHCI_MAX_PORTS  32
 
+//
+// Every port owns a command list of 32 slots, whatever the number of slots
+// supported by the HBA, so the command lists stay 1KB aligned.
+//
+#define EFI_AHCI_MAX_COMMAND_SLOTS  32
+
 #define AHCI_CAPABILITY2_OFFSET  0x0024
 #define   AHCI_CAP2_SDS          BIT3
 #define   AHCI_CAP2_SADM         BIT4
@@ -61,6 +68,12 @@ typedef union {
 //
 #define EFI_AHCI_MAX_DATA_PER_PRDT  0x400000
 
+//
+// The PRDT of a queued command covers the largest transfer of 0x10000 sectors
+// of 4K bytes.
+//
+#define EFI_AHCI_NCQ_MAX_PRDT  64
+
 #define EFI_AHCI_FIS_REGISTER_H2D           0x27         // Register FIS - Host to Device
 #define   EFI_AHCI_FIS_REGISTER_H2D_LENGTH  20
 #define EFI_AHCI_FIS_REGISTER_D2H           0x34         // Register FIS - Device to Host
@@ -285,6 +298,17 @@ typedef struct {
   EFI_AHCI_COMMAND_PRDT     PrdtTable[65535];     // The scatter/gather list for data transfer
 } EFI_AHCI_COMMAND_TABLE;
 
+//
+// Command table of a queued command. Each command slot used for Native Command
+// Queuing owns one, so its PRDT is kept small.
+//
+typedef struct {
+  EFI_AHCI_COMMAND_FIS      CommandFis;                        // A software constructed FIS.
+  EFI_AHCI_ATAPI_COMMAND    AtapiCmd;                          // Unused by queued commands.
+  UINT8                     Reserved[0x30];
+  EFI_AHCI_COMMAND_PRDT     PrdtTable[EFI_AHCI_NCQ_MAX_PRDT];  // The scatter/gather list for data transfer
+} EFI_AHCI_NCQ_COMMAND_TABLE;
+
 //
 // Received FIS structure
 //
@@ -311,6 +335,19 @@ typedef struct {
 
 #pragma pack()
 
+//
+// Native Command Queuing state of a port whose device supports it.
+//
+typedef struct {
+  EFI_AHCI_NCQ_COMMAND_TABLE    *CommandTable;           // One command table per command slot
+  EFI_AHCI_NCQ_COMMAND_TABLE    *CommandTablePciAddr;
+  VOID                          *MapCommandTable;
+  UINTN                         CommandTablePages;
+  UINT32                        SlotMask;                // Command slots usable by queued commands
+  UINT32                        ActiveSlots;             // Command slots set in PxSACT by this driver
+  struct _ATA_NONBLOCK_TASK     *Tasks[EFI_AHCI_MAX_COMMAND_SLOTS];
+} EFI_AHCI_NCQ_PORT;
+
 typedef struct {
   EFI_AHCI_RECEIVED_FIS     *AhciRFis;
   EFI_AHCI_COMMAND_LIST     *AhciCmdList;
@@ -324,6 +361,7 @@ typedef struct {
   VOID                      *MapRFis;
   VOID                      *MapCmdList;
   VOID                      *MapCommandTable;
+  EFI_AHCI_NCQ_PORT         *NcqPort[EFI_AHCI_MAX_PORTS];
 } EFI_AHCI_REGISTERS;
 
 /**
@@ -351,6 +389,26 @@ AhciPacketCommandExecute (
   IN  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet
   );
 
+/**
+  Start the command list processing of specific port.
+
+  @param  PciIo              The PCI IO protocol instance.
+  @param  Port               The number of port.
+  @param  Timeout            The timeout value of start, uses 100ns as a unit.
+
+  @retval EFI_DEVICE_ERROR   The port start unsuccessfully.
+  @retval EFI_TIMEOUT        The operation is time out.
+  @retval EFI_SUCCESS        The port start successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciStartPort (
+  IN  EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN  UINT8                Port,
+  IN  UINT64               Timeout
+  );
+
 /**
   Start command for give slot on specific port.
 
@@ -193,6 +193,7 @@ AtaPassThruPassThruExecute (
   EFI_ATA_PASS_THRU_CMD_PROTOCOL  Protocol;
   EFI_ATA_HC_WORK_MODE            Mode;
   EFI_STATUS                      Status;
+  EFI_TPL                         OldTpl;
 
   Protocol = Packet->Protocol;
 
@@ -286,6 +287,32 @@ AtaPassThruPassThruExecute (
         PortMultiplierPort = 0;
       }
 
+      if ((Task == NULL) &&
+          ((Protocol == EFI_ATA_PASS_THRU_PROTOCOL_ATA_NON_DATA) ||
+           (Protocol == EFI_ATA_PASS_THRU_PROTOCOL_PIO_DATA_IN) ||
+           (Protocol == EFI_ATA_PASS_THRU_PROTOCOL_PIO_DATA_OUT)))
+      {
+        //
+        // The blocking non-data and PIO commands do the same as the DMA ones:
+        // push to finish all non-blocking tasks first. The queued commands stay
+        // in the list until they are done, so the port has no queued command in
+        // flight that a non-queued command or its error recovery could abort.
+        // Delay 100us to simulate the blocking time out checking.
+        //
+        OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+        while (!IsListEmpty (&Instance->NonBlockingTaskList) ||
+               AhciNcqPortBusy (Instance, Port))
+        {
+          AsyncNonBlockingTransferRoutine (NULL, Instance);
+          //
+          // Stall for 100us.
+          //
+          MicroSecondDelay (100);
+        }
+
+        gBS->RestoreTPL (OldTpl);
+      }
+
       switch (Protocol) {
         case EFI_ATA_PASS_THRU_PROTOCOL_ATA_NON_DATA:
           Status = AhciNonDataTransfer (
@@ -369,6 +396,38 @@ AtaPassThruPassThruExecute (
                      Task
                      );
           break;
+        case EFI_ATA_PASS_THRU_PROTOCOL_FPDMA:
+          if (Packet->InTransferLength != 0) {
+            Status = AhciFpdmaTransfer (
+                       Instance,
+                       &Instance->AhciRegisters,
+                       (UINT8)Port,
+                       (UINT8)PortMultiplierPort,
+                       TRUE,
+                       Packet->Acb,
+                       Packet->Asb,
+                       Packet->InDataBuffer,
+                       Packet->InTransferLength,
+                       Packet->Timeout,
+                       Task
+                       );
+          } else {
+            Status = AhciFpdmaTransfer (
+                       Instance,
+                       &Instance->AhciRegisters,
+                       (UINT8)Port,
+                       (UINT8)PortMultiplierPort,
+                       FALSE,
+                       Packet->Acb,
+                       Packet->Asb,
+                       Packet->OutDataBuffer,
+                       Packet->OutTransferLength,
+                       Packet->Timeout,
+                       Task
+                       );
+          }
+
+          break;
         default:
           return EFI_UNSUPPORTED;
       }
@@ -399,22 +458,34 @@ AsyncNonBlockingTransferRoutine (
   )
 {
   LIST_ENTRY                    *Entry;
+  LIST_ENTRY                    *NextEntry;
   LIST_ENTRY                    *EntryHeader;
   ATA_NONBLOCK_TASK             *Task;
   EFI_STATUS                    Status;
   ATA_ATAPI_PASS_THRU_INSTANCE  *Instance;
+  BOOLEAN                       IsQueued;
 
   Instance    = (ATA_ATAPI_PASS_THRU_INSTANCE *)Context;
   EntryHeader = &Instance->NonBlockingTaskList;
   //
   // Get the Tasks from the Tasks List and execute it, until there is
   // no task in the list or the device is busy with task (EFI_NOT_READY).
+  // The queued (FPDMA) commands of AHCI mode run side by side, so the walk
+  // goes on past the ones not finished yet.
   //
-  while (TRUE) {
-    if (!IsListEmpty (EntryHeader)) {
-      Entry = GetFirstNode (EntryHeader);
-      Task  = ATA_NON_BLOCK_TASK_FROM_ENTRY (Entry);
-    } else {
+  Entry = GetFirstNode (EntryHeader);
+  while (!IsNull (EntryHeader, Entry)) {
+    Task     = ATA_NON_BLOCK_TASK_FROM_ENTRY (Entry);
+    IsQueued = (BOOLEAN)((Instance->Mode == EfiAtaAhciMode) &&
+                         (Task->Packet->Protocol == EFI_ATA_PASS_THRU_PROTOCOL_FPDMA));
+
+    //
+    // A command that is not queued waits for the tasks before it and for the
+    // queued commands of its port, and the tasks after it wait for it.
+    //
+    if (!IsQueued &&
+        ((Entry != GetFirstNode (EntryHeader)) || AhciNcqPortBusy (Instance, Task->Port)))
+    {
       return;
     }
 
@@ -427,25 +498,34 @@ AsyncNonBlockingTransferRoutine (
                );
 
     //
-    // If the data transfer meet a error, remove all tasks in the list since these tasks are
-    // associated with one task from Ata Bus and signal the event with error status.
+    // For Non blocking mode, the Status of EFI_NOT_READY means the operation
+    // is not finished yet.
     //
-    if ((Status != EFI_NOT_READY) && (Status != EFI_SUCCESS)) {
-      DestroyAsynTaskList (Instance, TRUE);
-      break;
+    if (Status == EFI_NOT_READY) {
+      if (!IsQueued) {
+        return;
+      }
+
+      Entry = GetNextNode (EntryHeader, Entry);
+      continue;
     }
 
     //
-    // For Non blocking mode, the Status of EFI_NOT_READY means the operation
-    // is not finished yet. Otherwise the operation is successful.
+    // If the data transfer meet a error, remove all tasks in the list since these tasks are
+    // associated with one task from Ata Bus and signal the event with error status.
+    // A queued command fails alone, as the error recovery of its port keeps the
+    // other queued commands going.
     //
-    if (Status == EFI_NOT_READY) {
-      break;
-    } else {
-      RemoveEntryList (&Task->Link);
-      gBS->SignalEvent (Task->Event);
-      FreePool (Task);
+    if ((Status != EFI_SUCCESS) && !IsQueued) {
+      DestroyAsynTaskList (Instance, TRUE);
+      return;
     }
+
+    NextEntry = GetNextNode (EntryHeader, Entry);
+    RemoveEntryList (&Task->Link);
+    gBS->SignalEvent (Task->Event);
+    FreePool (Task);
+    Entry = NextEntry;
   }
 }
 
@@ -952,6 +1032,7 @@ AtaAtapiPassThruStop (
   //
   if (Instance->Mode == EfiAtaAhciMode) {
     AhciRegisters = &Instance->AhciRegisters;
+    AhciFreeNcqResources (PciIo, AhciRegisters);
     PciIo->Unmap (
              PciIo,
              AhciRegisters->MapCommandTable
@@ -1154,6 +1235,11 @@ DestroyAsynTaskList (
 
   OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
   if (!IsListEmpty (&Instance->NonBlockingTaskList)) {
+    //
+    // Abort the queued commands in flight before their tasks are freed.
+    //
+    AhciNcqAbort (Instance);
+
     //
     // Free the Subtask list.
     //
@@ -1378,6 +1464,18 @@ AtaPassThruPassThru (
     return EFI_BAD_BUFFER_SIZE;
   }
 
+  //
+  // Queued commands are only supported in AHCI mode, on the ports whose device
+  // supports Native Command Queuing. Check it before the task is queued, so the
+  // caller can fall back to the commands that are not queued.
+  //
+  if ((Packet->Protocol == EFI_ATA_PASS_THRU_PROTOCOL_FPDMA) &&
+      ((Instance->Mode != EfiAtaAhciMode) || (Port >= EFI_AHCI_MAX_PORTS) ||
+       (Instance->AhciRegisters.NcqPort[Port] == NULL)))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
   //
   // For non-blocking mode, queue the Task into the list.
   //
@@ -138,6 +138,9 @@ struct _ATA_NONBLOCK_TASK {
   VOID                                *TableMap;       // Pointer to PRD table map.
   EFI_ATA_DMA_PRD                     *MapBaseAddress; //  Pointer to range Base address for Map.
   UINTN                               PageCount;       //  The page numbers used by PCIO freebuffer.
+  UINT8                               Slot;            // Command slot of a queued command.
+  BOOLEAN                             NcqFailed;       // The queued command is aborted with error.
+  UINT32                              NcqTfd;          // PxTFD of the port when the queued command failed.
 };
 
 //
@@ -1147,6 +1150,94 @@ AhciDmaTransfer (
   IN     ATA_NONBLOCK_TASK             *Task
   );
 
+/**
+  Start a queued DMA data transfer (READ/WRITE FPDMA QUEUED) on specific port.
+
+  Up to 32 queued commands are in flight on a port at the same time, each one
+  in its own command slot. The NCQ tag in the Count field of the command block
+  is assigned here from the command slot.
+
+  @param[in]       Instance            The ATA_ATAPI_PASS_THRU_INSTANCE protocol instance.
+  @param[in]       AhciRegisters       The pointer to the EFI_AHCI_REGISTERS.
+  @param[in]       Port                The number of port.
+  @param[in]       PortMultiplier      The port multiplier port number.
+  @param[in]       Read                The transfer direction.
+  @param[in]       AtaCommandBlock     The EFI_ATA_COMMAND_BLOCK data.
+  @param[in, out]  AtaStatusBlock      The EFI_ATA_STATUS_BLOCK data.
+  @param[in, out]  MemoryAddr          The pointer to the data buffer.
+  @param[in]       DataCount           The data count to be transferred.
+  @param[in]       Timeout             The timeout value of the transfer, uses 100ns as a unit.
+  @param[in]       Task                Optional. Pointer to the ATA_NONBLOCK_TASK
+                                       used by non-blocking mode.
+
+  @retval EFI_NOT_READY       The queued command is waiting for a command slot
+                              or is not completed yet.
+  @retval EFI_UNSUPPORTED     Native Command Queuing is not enabled on the port.
+  @retval EFI_BAD_BUFFER_SIZE The data buffer cannot be described by the PRDT.
+  @retval EFI_DEVICE_ERROR    The queued command is aborted with error.
+  @retval EFI_TIMEOUT         The operation is time out.
+  @retval EFI_SUCCESS         The queued DMA data transfer executes successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+AhciFpdmaTransfer (
+  IN     ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN     EFI_AHCI_REGISTERS            *AhciRegisters,
+  IN     UINT8                         Port,
+  IN     UINT8                         PortMultiplier,
+  IN     BOOLEAN                       Read,
+  IN     EFI_ATA_COMMAND_BLOCK         *AtaCommandBlock,
+  IN OUT EFI_ATA_STATUS_BLOCK          *AtaStatusBlock,
+  IN OUT VOID                          *MemoryAddr,
+  IN     UINT32                        DataCount,
+  IN     UINT64                        Timeout,
+  IN     ATA_NONBLOCK_TASK             *Task
+  );
+
+/**
+  Check whether queued commands are in flight on specific port.
+
+  @param[in]  Instance          A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+  @param[in]  Port              The number of port.
+
+  @retval TRUE                  At least one queued command is in flight.
+  @retval FALSE                 No queued command is in flight.
+
+**/
+BOOLEAN
+AhciNcqPortBusy (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance,
+  IN UINT16                        Port
+  );
+
+/**
+  Abort the queued commands in flight on all the ports.
+
+  The ports are stopped and the data buffers of the queued commands are
+  unmapped. The tasks themselves are left to the caller.
+
+  @param[in]  Instance          A pointer to the ATA_ATAPI_PASS_THRU_INSTANCE instance.
+
+**/
+VOID
+AhciNcqAbort (
+  IN ATA_ATAPI_PASS_THRU_INSTANCE  *Instance
+  );
+
+/**
+  Free the command tables of the ports using Native Command Queuing.
+
+  @param[in]  PciIo             The PCI IO protocol instance.
+  @param[in]  AhciRegisters     The pointer to the EFI_AHCI_REGISTERS.
+
+**/
+VOID
+AhciFreeNcqResources (
+  IN EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN EFI_AHCI_REGISTERS   *AhciRegisters
+  );
+
 /**
   Start a PIO data transfer on specific port.
 
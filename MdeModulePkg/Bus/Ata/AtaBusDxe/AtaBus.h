@@ -113,6 +113,11 @@ typedef struct {
 
   BOOLEAN                                  UdmaValid;
   BOOLEAN                                  Lba48Bit;
+  //
+  // The non-blocking requests use READ/WRITE FPDMA QUEUED, so several of them
+  // are in flight on the device at the same time.
+  //
+  BOOLEAN                                  NcqSupported;
 
   //
   // Cached data for ATA identify data
@@ -333,6 +333,17 @@ IdentifyAtaDevice (
     AtaDevice->Lba48Bit = FALSE;
   }
 
+  //
+  // Check whether the WORD 76 reports the support of Native Command Queuing.
+  // Whether the ATA pass through supports it is known from the first queued command.
+  //
+  if (AtaDevice->UdmaValid &&
+      (IdentifyData->serial_ata_capabilities != 0xFFFF) &&
+      ((IdentifyData->serial_ata_capabilities & BIT8) != 0))
+  {
+    AtaDevice->NcqSupported = TRUE;
+  }
+
   //
   // Block Media Information:
   //
@@ -432,6 +443,92 @@ DiscoverAtaDevice (
   return Status;
 }
 
+/**
+  Transfer data from ATA device with a queued command in non blocking mode.
+
+  This function performs one ATA pass through transaction of READ FPDMA QUEUED or
+  WRITE FPDMA QUEUED. The NCQ tag is assigned by the ATA pass through.
+
+  @param[in, out]  AtaDevice       The ATA child device involved for the operation.
+  @param[in, out]  TaskPacket      Pointer to a Pass Thru Command Packet.
+  @param[in, out]  Buffer          The pointer to the current transaction buffer.
+  @param[in]       StartLba        The starting logical block address to be accessed.
+  @param[in]       TransferLength  The block number or sector count of the transfer.
+  @param[in]       IsWrite         Indicates whether it is a write operation.
+  @param[in]       Event           The Event signaled when the request is completed.
+
+  @retval EFI_SUCCESS       The queued command is sent.
+  @retval EFI_UNSUPPORTED   The ATA pass through doesn't support queued commands
+                            on the device. The packet is released.
+  @return others            Some error occurs when transferring data.
+
+**/
+EFI_STATUS
+QueuedTransferAtaDevice (
+  IN OUT ATA_DEVICE                        *AtaDevice,
+  IN OUT EFI_ATA_PASS_THRU_COMMAND_PACKET  *TaskPacket,
+  IN OUT VOID                              *Buffer,
+  IN EFI_LBA                               StartLba,
+  IN UINT32                                TransferLength,
+  IN BOOLEAN                               IsWrite,
+  IN EFI_EVENT                             Event
+  )
+{
+  EFI_STATUS                        Status;
+  EFI_ATA_COMMAND_BLOCK             *Acb;
+  EFI_ATA_PASS_THRU_COMMAND_PACKET  *Packet;
+
+  //
+  // Prepare for ATA command block. The sector count is in the Features field,
+  // the Count field is left for the NCQ tag.
+  //
+  Acb                     = ZeroMem (&AtaDevice->Acb, sizeof (EFI_ATA_COMMAND_BLOCK));
+  Acb->AtaCommand         = IsWrite ? ATA_CMD_WRITE_FPDMA_QUEUED : ATA_CMD_READ_FPDMA_QUEUED;
+  Acb->AtaFeatures        = (UINT8)TransferLength;
+  Acb->AtaFeaturesExp     = (UINT8)(TransferLength >> 8);
+  Acb->AtaSectorNumber    = (UINT8)StartLba;
+  Acb->AtaCylinderLow     = (UINT8)RShiftU64 (StartLba, 8);
+  Acb->AtaCylinderHigh    = (UINT8)RShiftU64 (StartLba, 16);
+  Acb->AtaSectorNumberExp = (UINT8)RShiftU64 (StartLba, 24);
+  Acb->AtaCylinderLowExp  = (UINT8)RShiftU64 (StartLba, 32);
+  Acb->AtaCylinderHighExp = (UINT8)RShiftU64 (StartLba, 40);
+  Acb->AtaDeviceHead      = (UINT8)BIT6;
+
+  //
+  // Prepare for ATA pass through packet.
+  //
+  Packet = ZeroMem (TaskPacket, sizeof (EFI_ATA_PASS_THRU_COMMAND_PACKET));
+  if (IsWrite) {
+    Packet->OutDataBuffer     = Buffer;
+    Packet->OutTransferLength = TransferLength;
+  } else {
+    Packet->InDataBuffer     = Buffer;
+    Packet->InTransferLength = TransferLength;
+  }
+
+  Packet->Protocol = EFI_ATA_PASS_THRU_PROTOCOL_FPDMA;
+  Packet->Length   = EFI_ATA_PASS_THRU_LENGTH_SECTOR_COUNT;
+  //
+  // Use the maximum timeout value of DMA read/write operation, as TransferAtaDevice() does.
+  //
+  Packet->Timeout = EFI_TIMER_PERIOD_SECONDS (DivU64x32 (MultU64x32 (TransferLength, AtaDevice->BlockMedia.BlockSize), 2100000) + 31);
+
+  Status = AtaDevicePassThru (AtaDevice, TaskPacket, Event);
+  if (Status == EFI_UNSUPPORTED) {
+    if (Packet->Asb != NULL) {
+      FreeAlignedBuffer (Packet->Asb, sizeof (EFI_ATA_STATUS_BLOCK));
+      Packet->Asb = NULL;
+    }
+
+    if (Packet->Acb != NULL) {
+      FreePool (Packet->Acb);
+      Packet->Acb = NULL;
+    }
+  }
+
+  return Status;
+}
+
 /**
   Transfer data from ATA device.
 
@@ -469,9 +566,27 @@ TransferAtaDevice (
   IN EFI_EVENT                             Event OPTIONAL
   )
 {
+  EFI_STATUS                        Status;
   EFI_ATA_COMMAND_BLOCK             *Acb;
   EFI_ATA_PASS_THRU_COMMAND_PACKET  *Packet;
 
+  //
+  // Non-blocking requests use queued commands if the device supports them.
+  //
+  if ((TaskPacket != NULL) && AtaDevice->NcqSupported) {
+    Status = QueuedTransferAtaDevice (AtaDevice, TaskPacket, Buffer, StartLba, TransferLength, IsWrite, Event);
+    if (Status != EFI_UNSUPPORTED) {
+      return Status;
+    }
+
+    //
+    // The ATA pass through doesn't support queued commands on this device,
+    // so fall back to the commands that are not queued from now on.
+    //
+    DEBUG ((DEBUG_INFO, "AtaBus - Queued commands unsupported: Port %x PortMultiplierPort %x\n", AtaDevice->Port, AtaDevice->PortMultiplierPort));
+    AtaDevice->NcqSupported = FALSE;
+  }
+
   //
   // Ensure AtaDevice->UdmaValid, AtaDevice->Lba48Bit and IsWrite are valid boolean values
   //
@@ -806,7 +921,11 @@ AccessAtaDevice (
   if ((Token != NULL) && (Token->Event != NULL)) {
     OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
 
-    if (!IsListEmpty (&AtaDevice->AtaSubTaskList)) {
+    //
+    // Queued commands of several requests are in flight side by side. Otherwise
+    // the request waits until the subtasks of the previous one are done.
+    //
+    if (!AtaDevice->NcqSupported && !IsListEmpty (&AtaDevice->AtaSubTaskList)) {
       AtaTask = AllocateZeroPool (sizeof (ATA_BUS_ASYN_TASK));
       if (AtaTask == NULL) {
         gBS->RestoreTPL (OldTpl);
@@ -704,11 +704,11 @@ ProcessAsyncTaskList (
         }
 
         if (AsyncRequest->PrpListHost != NULL) {
-          PciIo->FreeBuffer (
-                   PciIo,
-                   AsyncRequest->PrpListNo,
-                   AsyncRequest->PrpListHost
-                   );
+          NvmeFreePrpList (
+            Private,
+            AsyncRequest->PrpListHost,
+            AsyncRequest->PrpListNo
+            );
         }
 
         RemoveEntryList (Link);
@@ -1036,14 +1036,15 @@ NvmExpressDriverBindingStart (
     // 4th 4kB boundary is the start of I/O completion queue #1.
     // 5th 4kB boundary is the start of I/O submission queue #2.
     // 6th 4kB boundary is the start of I/O completion queue #2.
+    // The remaining 4kB pages are the PRP list pool.
     //
-    // Allocate 6 pages of memory, then map it for bus master read and write.
+    // Allocate the pages, then map them for bus master read and write.
     //
     Status = PciIo->AllocateBuffer (
                       PciIo,
                       AllocateAnyPages,
                       EfiBootServicesData,
-                      6,
+                      NVME_CONTROLLER_BUFFER_PAGES,
                       (VOID **)&Private->Buffer,
                       0
                       );
@@ -1051,7 +1052,7 @@ NvmExpressDriverBindingStart (
       goto Exit;
     }
 
-    Bytes  = EFI_PAGES_TO_SIZE (6);
+    Bytes  = EFI_PAGES_TO_SIZE (NVME_CONTROLLER_BUFFER_PAGES);
     Status = PciIo->Map (
                       PciIo,
                       EfiPciIoOperationBusMasterCommonBuffer,
@@ -1061,11 +1062,14 @@ NvmExpressDriverBindingStart (
                       &Private->Mapping
                       );
 
-    if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (6))) {
+    if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (NVME_CONTROLLER_BUFFER_PAGES))) {
       goto Exit;
     }
 
-    Private->BufferPciAddr = (UINT8 *)(UINTN)MappedAddr;
+    Private->BufferPciAddr      = (UINT8 *)(UINTN)MappedAddr;
+    Private->PrpListPool        = Private->Buffer + EFI_PAGES_TO_SIZE (6);
+    Private->PrpListPoolPciAddr = Private->BufferPciAddr + EFI_PAGES_TO_SIZE (6);
+    Private->FreePrpLists       = (UINT32)(LShiftU64 (1, NVME_PRP_LIST_POOL_SIZE) - 1);
 
     Private->Signature                 = NVME_CONTROLLER_PRIVATE_DATA_SIGNATURE;
     Private->ControllerHandle          = Controller;
@@ -1171,7 +1175,7 @@ Exit:
   }
 
   if ((Private != NULL) && (Private->Buffer != NULL)) {
-    PciIo->FreeBuffer (PciIo, 6, Private->Buffer);
+    PciIo->FreeBuffer (PciIo, NVME_CONTROLLER_BUFFER_PAGES, Private->Buffer);
   }
 
   if ((Private != NULL) && (Private->ControllerData != NULL)) {
@@ -1293,7 +1297,7 @@ NvmExpressDriverBindingStop (
       }
 
       if (Private->Buffer != NULL) {
-        Private->PciIo->FreeBuffer (Private->PciIo, 6, Private->Buffer);
+        Private->PciIo->FreeBuffer (Private->PciIo, NVME_CONTROLLER_BUFFER_PAGES, Private->Buffer);
       }
 
       FreePool (Private->ControllerData);
@@ -79,6 +79,20 @@ extern EFI_DRIVER_SUPPORTED_EFI_VERSION_PROTOCOL  gNvmExpressDriverSupportedEfiV
 
 #define NVME_MAX_QUEUES  3                              // Number of queues supported by the driver
 
+//
+// Number of 4kB PRP lists kept mapped for reuse by the I/O commands. A PRP
+// list page covers a transfer of up to 2MB. Commands needing more than one
+// PRP list, or issued while all pooled PRP lists are in use, allocate their
+// PRP lists on demand.
+//
+#define NVME_PRP_LIST_POOL_SIZE  32
+
+//
+// Number of 4kB pages of the controller buffer: the admin and I/O queues,
+// followed by the PRP list pool.
+//
+#define NVME_CONTROLLER_BUFFER_PAGES  (6 + NVME_PRP_LIST_POOL_SIZE)
+
 //
 // FormatNVM Admin Command LBA Format (LBAF) Mask
 //
@@ -151,10 +165,18 @@ struct _NVME_CONTROLLER_PRIVATE_DATA {
   // 4th 4kB boundary is the start of I/O completion queue #1.
   // 5th 4kB boundary is the start of I/O submission queue #2.
   // 6th 4kB boundary is the start of I/O completion queue #2.
+  // The PRP list pool starts at the 7th 4kB boundary.
   //
   UINT8          *Buffer;
   UINT8          *BufferPciAddr;
 
+  //
+  // Pool of pre-mapped PRP lists, one bit per free PRP list.
+  //
+  UINT8          *PrpListPool;
+  UINT8          *PrpListPoolPciAddr;
+  UINT32         FreePrpLists;
+
   //
   // Pointers to 4kB aligned submission & completion queues.
   //
@@ -758,6 +780,79 @@ NvmeDumpStatus (
   IN NVME_CQ  *Cq
   );
 
+/**
+  Read or write some blocks with all the commands of the transfer in flight,
+  and wait for the transfer to complete.
+
+  @param  Device             The pointer to the NVME_DEVICE_PRIVATE_DATA data structure.
+  @param  Buffer             The buffer to transfer the data from or to.
+  @param  Lba                The start block number.
+  @param  Blocks             Total block number to be transferred.
+  @param  MaxTransferBlocks  The maximum block number of a command.
+  @param  IsWrite            TRUE to write the blocks, FALSE to read them.
+
+  @retval EFI_SUCCESS        The data are transferred.
+  @retval EFI_TIMEOUT        The transfer did not complete in time, and the
+                             controller has been reset.
+  @retval Others             Fail to transfer all the data.
+
+**/
+EFI_STATUS
+NvmeQueuedReadWrite (
+  IN     NVME_DEVICE_PRIVATE_DATA  *Device,
+  IN OUT VOID                      *Buffer,
+  IN     UINT64                    Lba,
+  IN     UINTN                     Blocks,
+  IN     UINT32                    MaxTransferBlocks,
+  IN     BOOLEAN                   IsWrite
+  );
+
+/**
+  Free the PRP lists created by NvmeCreatePrpList(). The PRP lists must have
+  been unmapped by the caller.
+
+  @param[in]     Private             The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in]     PrpListHost         The host base address of PRP lists.
+  @param[in]     PrpListNo           The number of PRP List.
+
+**/
+VOID
+NvmeFreePrpList (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN VOID                          *PrpListHost,
+  IN UINTN                         PrpListNo
+  );
+
+/**
+  Aborts the asynchronous PassThru requests.
+
+  @param[in] Private        The pointer to the NVME_CONTROLLER_PRIVATE_DATA
+                            data structure.
+
+  @retval EFI_SUCCESS       The asynchronous PassThru requests have been aborted.
+  @return EFI_DEVICE_ERROR  Fail to abort all the asynchronous PassThru requests.
+
+**/
+EFI_STATUS
+AbortAsyncPassThruTasks (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private
+  );
+
+/**
+  Call back function when the timer event is signaled.
+
+  @param[in]  Event     The Event this notify function registered to.
+  @param[in]  Context   Pointer to the context data registered to the
+                        Event.
+
+**/
+VOID
+EFIAPI
+ProcessAsyncTaskList (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  );
+
 /**
   Register the shutdown notification through the ResetNotification protocol.
 
@@ -195,21 +195,18 @@ NvmeRead (
     MaxTransferBlocks = 1024;
   }
 
-  while (Blocks > 0) {
-    if (Blocks > MaxTransferBlocks) {
-      Status = ReadSectors (Device, (UINT64)(UINTN)Buffer, Lba, MaxTransferBlocks);
-
-      Blocks -= MaxTransferBlocks;
-      Buffer  = (VOID *)(UINTN)((UINT64)(UINTN)Buffer + MaxTransferBlocks * BlockSize);
-      Lba    += MaxTransferBlocks;
-    } else {
-      Status = ReadSectors (Device, (UINT64)(UINTN)Buffer, Lba, (UINT32)Blocks);
-      Blocks = 0;
-    }
+  if (Blocks > MaxTransferBlocks) {
+    //
+    // Keep all the commands of a large transfer in flight on the
+    // asynchronous I/O queue, instead of issuing them one at a time.
+    //
+    Status = NvmeQueuedReadWrite (Device, Buffer, Lba, Blocks, MaxTransferBlocks, FALSE);
+  } else {
+    Status = ReadSectors (Device, (UINT64)(UINTN)Buffer, Lba, (UINT32)Blocks);
+  }
 
-    if (EFI_ERROR (Status)) {
-      break;
-    }
+  if (!EFI_ERROR (Status)) {
+    Blocks = 0;
   }
 
   DEBUG ((
@@ -281,21 +278,18 @@ NvmeWrite (
     MaxTransferBlocks = 1024;
   }
 
-  while (Blocks > 0) {
-    if (Blocks > MaxTransferBlocks) {
-      Status = WriteSectors (Device, (UINT64)(UINTN)Buffer, Lba, MaxTransferBlocks);
-
-      Blocks -= MaxTransferBlocks;
-      Buffer  = (VOID *)(UINTN)((UINT64)(UINTN)Buffer + MaxTransferBlocks * BlockSize);
-      Lba    += MaxTransferBlocks;
-    } else {
-      Status = WriteSectors (Device, (UINT64)(UINTN)Buffer, Lba, (UINT32)Blocks);
-      Blocks = 0;
-    }
+  if (Blocks > MaxTransferBlocks) {
+    //
+    // Keep all the commands of a large transfer in flight on the
+    // asynchronous I/O queue, instead of issuing them one at a time.
+    //
+    Status = NvmeQueuedReadWrite (Device, Buffer, Lba, Blocks, MaxTransferBlocks, TRUE);
+  } else {
+    Status = WriteSectors (Device, (UINT64)(UINTN)Buffer, Lba, (UINT32)Blocks);
+  }
 
-    if (EFI_ERROR (Status)) {
-      break;
-    }
+  if (!EFI_ERROR (Status)) {
+    Blocks = 0;
   }
 
   DEBUG ((
@@ -956,6 +950,137 @@ NvmeAsyncWrite (
   return Status;
 }
 
+/**
+  Read or write some blocks with all the commands of the transfer in flight,
+  and wait for the transfer to complete.
+
+  The transfer is split into commands of MaxTransferBlocks blocks by
+  NvmeAsyncRead() or NvmeAsyncWrite(), and queued to the asynchronous I/O
+  queue. The queue is processed here rather than by the periodic timer, so
+  the commands are submitted and completed without waiting for the timer.
+
+  @param  Device             The pointer to the NVME_DEVICE_PRIVATE_DATA data structure.
+  @param  Buffer             The buffer to transfer the data from or to.
+  @param  Lba                The start block number.
+  @param  Blocks             Total block number to be transferred.
+  @param  MaxTransferBlocks  The maximum block number of a command.
+  @param  IsWrite            TRUE to write the blocks, FALSE to read them.
+
+  @retval EFI_SUCCESS        The data are transferred.
+  @retval EFI_TIMEOUT        The transfer did not complete in time, and the
+                             controller has been reset.
+  @retval Others             Fail to transfer all the data.
+
+**/
+EFI_STATUS
+NvmeQueuedReadWrite (
+  IN     NVME_DEVICE_PRIVATE_DATA  *Device,
+  IN OUT VOID                      *Buffer,
+  IN     UINT64                    Lba,
+  IN     UINTN                     Blocks,
+  IN     UINT32                    MaxTransferBlocks,
+  IN     BOOLEAN                   IsWrite
+  )
+{
+  NVME_CONTROLLER_PRIVATE_DATA  *Private;
+  EFI_BLOCK_IO2_TOKEN           *Token;
+  EFI_EVENT                     TimerEvent;
+  UINT64                        Commands;
+  EFI_TPL                       OldTpl;
+  EFI_STATUS                    Status;
+
+  Private    = Device->Controller;
+  TimerEvent = NULL;
+
+  //
+  // The token is referenced by the subtasks until the request completes, so
+  // it is not allocated on the stack.
+  //
+  Token = AllocateZeroPool (sizeof (EFI_BLOCK_IO2_TOKEN));
+  if (Token == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = gBS->CreateEvent (0, 0, NULL, NULL, &Token->Event);
+  if (EFI_ERROR (Status)) {
+    FreePool (Token);
+    return Status;
+  }
+
+  //
+  // Allow every command the time of a blocking command.
+  //
+  Commands = DivU64x32 (Blocks + MaxTransferBlocks - 1, MaxTransferBlocks);
+  Status   = gBS->CreateEvent (EVT_TIMER, TPL_CALLBACK, NULL, NULL, &TimerEvent);
+  if (!EFI_ERROR (Status)) {
+    Status = gBS->SetTimer (TimerEvent, TimerRelative, MultU64x64 (NVME_GENERIC_TIMEOUT, Commands));
+  }
+
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  Token->TransactionStatus = EFI_SUCCESS;
+  if (IsWrite) {
+    Status = NvmeAsyncWrite (Device, Buffer, Lba, Blocks, Token);
+  } else {
+    Status = NvmeAsyncRead (Device, Buffer, Lba, Blocks, Token);
+  }
+
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  //
+  // Submit and complete the commands until the request completes.
+  //
+  Status = EFI_TIMEOUT;
+  while (EFI_ERROR (gBS->CheckEvent (TimerEvent))) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    ProcessAsyncTaskList (Private->TimerEvent, Private);
+    gBS->RestoreTPL (OldTpl);
+
+    if (!EFI_ERROR (gBS->CheckEvent (Token->Event))) {
+      Status = Token->TransactionStatus;
+      break;
+    }
+  }
+
+  if (Status == EFI_TIMEOUT) {
+    ReportStatusCode ((EFI_ERROR_MAJOR | EFI_ERROR_CODE), (EFI_IO_BUS_SCSI | EFI_IOB_EC_INTERFACE_ERROR));
+    DEBUG ((DEBUG_ERROR, "%a: Timeout occurs for an NVMe read/write request.\n", __func__));
+
+    //
+    // Reset the controller to abort the outstanding commands, as for a
+    // blocking PassThru command. Aborting the commands completes the request.
+    //
+    gBS->SetTimer (Private->TimerEvent, TimerCancel, 0);
+    if (!EFI_ERROR (NvmeControllerInit (Private)) &&
+        !EFI_ERROR (AbortAsyncPassThruTasks (Private)))
+    {
+      gBS->SetTimer (Private->TimerEvent, TimerPeriodic, NVME_HC_ASYNC_TIMER);
+    }
+
+    if (EFI_ERROR (gBS->CheckEvent (Token->Event))) {
+      //
+      // The request may still use the token, so it is not freed.
+      //
+      gBS->CloseEvent (TimerEvent);
+      return EFI_DEVICE_ERROR;
+    }
+  }
+
+Exit:
+  if (TimerEvent != NULL) {
+    gBS->CloseEvent (TimerEvent);
+  }
+
+  gBS->CloseEvent (Token->Event);
+  FreePool (Token);
+
+  return Status;
+}
+
 /**
   Reset the Block Device.
 
@@ -195,11 +195,48 @@ NvmeDumpStatus (
   }
 }
 
+/**
+  Free the PRP lists created by NvmeCreatePrpList(). The PRP lists must have
+  been unmapped by the caller.
+
+  @param[in]     Private             The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in]     PrpListHost         The host base address of PRP lists.
+  @param[in]     PrpListNo           The number of PRP List.
+
+**/
+VOID
+NvmeFreePrpList (
+  IN NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN VOID                          *PrpListHost,
+  IN UINTN                         PrpListNo
+  )
+{
+  UINTN    Index;
+  EFI_TPL  OldTpl;
+
+  if (((UINT8 *)PrpListHost >= Private->PrpListPool) &&
+      ((UINT8 *)PrpListHost < Private->PrpListPool + EFI_PAGES_TO_SIZE (NVME_PRP_LIST_POOL_SIZE)))
+  {
+    ASSERT (PrpListNo == 1);
+    Index  = ((UINT8 *)PrpListHost - Private->PrpListPool) / EFI_PAGE_SIZE;
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    ASSERT ((Private->FreePrpLists & (1U << Index)) == 0);
+    Private->FreePrpLists |= 1U << Index;
+    gBS->RestoreTPL (OldTpl);
+    return;
+  }
+
+  Private->PciIo->FreeBuffer (Private->PciIo, PrpListNo, PrpListHost);
+}
+
 /**
   Create PRP lists for data transfer which is larger than 2 memory pages.
   Note here we calcuate the number of required PRP lists and allocate them at one time.
 
-  @param[in]     PciIo               A pointer to the EFI_PCI_IO_PROTOCOL instance.
+  A single PRP list is taken from the pre-mapped PRP list pool of the
+  controller when possible; *Mapping is set to NULL in that case.
+
+  @param[in]     Private             The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
   @param[in]     PhysicalAddr        The physical base address of data buffer.
   @param[in]     Pages               The number of pages to be transfered.
   @param[out]    PrpListHost         The host base address of PRP lists.
@@ -211,14 +248,15 @@ NvmeDumpStatus (
 **/
 VOID *
 NvmeCreatePrpList (
-  IN     EFI_PCI_IO_PROTOCOL   *PciIo,
-  IN     EFI_PHYSICAL_ADDRESS  PhysicalAddr,
-  IN     UINTN                 Pages,
-  OUT VOID                     **PrpListHost,
-  IN OUT UINTN                 *PrpListNo,
-  OUT VOID                     **Mapping
+  IN     NVME_CONTROLLER_PRIVATE_DATA  *Private,
+  IN     EFI_PHYSICAL_ADDRESS          PhysicalAddr,
+  IN     UINTN                         Pages,
+  OUT VOID                             **PrpListHost,
+  IN OUT UINTN                         *PrpListNo,
+  OUT VOID                             **Mapping
   )
 {
+  EFI_PCI_IO_PROTOCOL   *PciIo;
   UINTN                 PrpEntryNo;
   UINT64                PrpListBase;
   UINTN                 PrpListIndex;
@@ -226,8 +264,13 @@ NvmeCreatePrpList (
   UINT64                Remainder;
   EFI_PHYSICAL_ADDRESS  PrpListPhyAddr;
   UINTN                 Bytes;
+  INTN                  PoolIndex;
+  EFI_TPL               OldTpl;
   EFI_STATUS            Status;
 
+  PciIo    = Private->PciIo;
+  *Mapping = NULL;
+
   //
   // The number of Prp Entry in a memory page.
   //
@@ -247,32 +290,51 @@ NvmeCreatePrpList (
     Remainder = PrpEntryNo - 1;
   }
 
-  Status = PciIo->AllocateBuffer (
-                    PciIo,
-                    AllocateAnyPages,
-                    EfiBootServicesData,
-                    *PrpListNo,
-                    PrpListHost,
-                    0
-                    );
+  //
+  // Take a single PRP list from the pool, which is mapped already.
+  //
+  PoolIndex = -1;
+  if (*PrpListNo == 1) {
+    OldTpl    = gBS->RaiseTPL (TPL_NOTIFY);
+    PoolIndex = LowBitSet32 (Private->FreePrpLists);
+    if (PoolIndex >= 0) {
+      Private->FreePrpLists &= ~(1U << PoolIndex);
+    }
 
-  if (EFI_ERROR (Status)) {
-    return NULL;
+    gBS->RestoreTPL (OldTpl);
   }
 
-  Bytes  = EFI_PAGES_TO_SIZE (*PrpListNo);
-  Status = PciIo->Map (
-                    PciIo,
-                    EfiPciIoOperationBusMasterCommonBuffer,
-                    *PrpListHost,
-                    &Bytes,
-                    &PrpListPhyAddr,
-                    Mapping
-                    );
-
-  if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (*PrpListNo))) {
-    DEBUG ((DEBUG_ERROR, "NvmeCreatePrpList: create PrpList failure!\n"));
-    goto EXIT;
+  Bytes = EFI_PAGES_TO_SIZE (*PrpListNo);
+  if (PoolIndex >= 0) {
+    *PrpListHost   = Private->PrpListPool + EFI_PAGES_TO_SIZE (PoolIndex);
+    PrpListPhyAddr = (EFI_PHYSICAL_ADDRESS)(UINTN)(Private->PrpListPoolPciAddr + EFI_PAGES_TO_SIZE (PoolIndex));
+  } else {
+    Status = PciIo->AllocateBuffer (
+                      PciIo,
+                      AllocateAnyPages,
+                      EfiBootServicesData,
+                      *PrpListNo,
+                      PrpListHost,
+                      0
+                      );
+
+    if (EFI_ERROR (Status)) {
+      return NULL;
+    }
+
+    Status = PciIo->Map (
+                      PciIo,
+                      EfiPciIoOperationBusMasterCommonBuffer,
+                      *PrpListHost,
+                      &Bytes,
+                      &PrpListPhyAddr,
+                      Mapping
+                      );
+
+    if (EFI_ERROR (Status) || (Bytes != EFI_PAGES_TO_SIZE (*PrpListNo))) {
+      DEBUG ((DEBUG_ERROR, "NvmeCreatePrpList: create PrpList failure!\n"));
+      goto EXIT;
+    }
   }
 
   //
@@ -311,9 +373,52 @@ NvmeCreatePrpList (
 
 EXIT:
   PciIo->FreeBuffer (PciIo, *PrpListNo, *PrpListHost);
+  *Mapping = NULL;
   return NULL;
 }
 
+/**
+  Check whether the data buffer of a command can be described by a single SGL
+  Data Block descriptor.
+
+  SGLs are only used for the I/O commands with a mapped data buffer, and only
+  when the controller reports SGL support in the Identify Controller data.
+
+  @param[in]     Private             The pointer to the NVME_CONTROLLER_PRIVATE_DATA data structure.
+  @param[in]     Packet              A pointer to the NVM Express Command Packet.
+  @param[in]     MapData             The mapping of the data buffer, or NULL.
+  @param[in]     DeviceAddress       The device address of the data buffer.
+
+  @retval TRUE   The data buffer can be described by an SGL.
+  @retval FALSE  PRPs must be used for the data buffer.
+
+**/
+BOOLEAN
+NvmeSglUsable (
+  IN NVME_CONTROLLER_PRIVATE_DATA              *Private,
+  IN EFI_NVM_EXPRESS_PASS_THRU_COMMAND_PACKET  *Packet,
+  IN VOID                                      *MapData,
+  IN UINT64                                    DeviceAddress
+  )
+{
+  UINT32  Sgls;
+
+  if ((Packet->QueueType != NVME_IO_QUEUE) || (MapData == NULL)) {
+    return FALSE;
+  }
+
+  Sgls = Private->ControllerData->Sgls & NVME_SGLS_SUPPORT_MASK;
+  if (Sgls == NVME_SGLS_SUPPORTED) {
+    return TRUE;
+  }
+
+  if (Sgls == NVME_SGLS_SUPPORTED_DWORD_ALIGNED) {
+    return (BOOLEAN)(((DeviceAddress & 0x3) == 0) && ((Packet->TransferLength & 0x3) == 0));
+  }
+
+  return FALSE;
+}
+
 /**
   Aborts the asynchronous PassThru requests.
 
@@ -389,11 +494,11 @@ AbortAsyncPassThruTasks (
     }
 
     if (AsyncRequest->PrpListHost != NULL) {
-      PciIo->FreeBuffer (
-               PciIo,
-               AsyncRequest->PrpListNo,
-               AsyncRequest->PrpListHost
-               );
+      NvmeFreePrpList (
+        Private,
+        AsyncRequest->PrpListHost,
+        AsyncRequest->PrpListNo
+        );
     }
 
     RemoveEntryList (Link);
@@ -455,32 +560,33 @@ NvmExpressPassThru (
   IN     EFI_EVENT                                 Event OPTIONAL
   )
 {
-  NVME_CONTROLLER_PRIVATE_DATA   *Private;
-  EFI_STATUS                     Status;
-  EFI_STATUS                     PreviousStatus;
-  EFI_PCI_IO_PROTOCOL            *PciIo;
-  NVME_SQ                        *Sq;
-  volatile NVME_CQ               *Cq;
-  UINT16                         QueueId;
-  UINT16                         QueueSize;
-  UINT32                         Bytes;
-  UINT16                         Offset;
-  EFI_EVENT                      TimerEvent;
-  EFI_PCI_IO_PROTOCOL_OPERATION  Flag;
-  EFI_PHYSICAL_ADDRESS           PhyAddr;
-  VOID                           *MapData;
-  VOID                           *MapMeta;
-  VOID                           *MapPrpList;
-  UINTN                          MapLength;
-  UINT64                         *Prp;
-  VOID                           *PrpListHost;
-  UINTN                          PrpListNo;
-  UINT32                         Attributes;
-  UINT32                         IoAlign;
-  UINT32                         MaxTransLen;
-  UINT32                         Data;
-  NVME_PASS_THRU_ASYNC_REQ       *AsyncRequest;
-  EFI_TPL                        OldTpl;
+  NVME_CONTROLLER_PRIVATE_DATA    *Private;
+  EFI_STATUS                      Status;
+  EFI_STATUS                      PreviousStatus;
+  EFI_PCI_IO_PROTOCOL             *PciIo;
+  NVME_SQ                         *Sq;
+  volatile NVME_CQ                *Cq;
+  UINT16                          QueueId;
+  UINT16                          QueueSize;
+  UINT32                          Bytes;
+  UINT16                          Offset;
+  EFI_EVENT                       TimerEvent;
+  EFI_PCI_IO_PROTOCOL_OPERATION   Flag;
+  EFI_PHYSICAL_ADDRESS            PhyAddr;
+  VOID                            *MapData;
+  VOID                            *MapMeta;
+  VOID                            *MapPrpList;
+  UINTN                           MapLength;
+  UINT64                          *Prp;
+  VOID                            *PrpListHost;
+  UINTN                           PrpListNo;
+  UINT32                          Attributes;
+  UINT32                          IoAlign;
+  UINT32                          MaxTransLen;
+  UINT32                          Data;
+  NVME_PASS_THRU_ASYNC_REQ        *AsyncRequest;
+  NVME_SGL_DATA_BLOCK_DESCRIPTOR  *Sgl;
+  EFI_TPL                         OldTpl;
 
   //
   // check the data fields in Packet parameter.
@@ -588,9 +694,10 @@ NvmExpressPassThru (
   Sq->Nsid = Packet->NvmeCmd->Nsid;
 
   //
-  // Currently we only support PRP for data transfer, SGL is NOT supported.
+  // The data pointer is built as PRP entries below. Only I/O transfers that
+  // would need a PRP list are switched to an SGL by the driver.
   //
-  ASSERT (Sq->Psdt == 0);
+  ASSERT (Sq->Psdt == NVME_PSDT_PRP);
   if (Sq->Psdt != 0) {
     DEBUG ((DEBUG_ERROR, "NvmExpressPassThru: doesn't support SGL mechanism\n"));
     return EFI_UNSUPPORTED;
@@ -675,12 +782,26 @@ NvmExpressPassThru (
   Offset = ((UINT16)Sq->Prp[0]) & (EFI_PAGE_SIZE - 1);
   Bytes  = Packet->TransferLength;
 
-  if ((Offset + Bytes) > (EFI_PAGE_SIZE * 2)) {
+  if (((Offset + Bytes) > (EFI_PAGE_SIZE * 2)) &&
+      NvmeSglUsable (Private, Packet, MapData, Sq->Prp[0]))
+  {
+    //
+    // The mapped data buffer is contiguous in the device address space, so a
+    // single SGL Data Block descriptor replaces the PRP list.
+    //
+    PhyAddr = Sq->Prp[0];
+    Sgl     = (NVME_SGL_DATA_BLOCK_DESCRIPTOR *)Sq->Prp;
+    ZeroMem (Sgl, sizeof (*Sgl));
+    Sgl->Address = PhyAddr;
+    Sgl->Length  = Bytes;
+    Sgl->Type    = NVME_SGL_DESCRIPTOR_TYPE_DATA_BLOCK;
+    Sq->Psdt     = NVME_PSDT_SGL_BUFFER;
+  } else if ((Offset + Bytes) > (EFI_PAGE_SIZE * 2)) {
     //
     // Create PrpList for remaining data buffer.
     //
     PhyAddr = (Sq->Prp[0] + EFI_PAGE_SIZE) & ~(EFI_PAGE_SIZE - 1);
-    Prp     = NvmeCreatePrpList (PciIo, PhyAddr, EFI_SIZE_TO_PAGES (Offset + Bytes) - 1, &PrpListHost, &PrpListNo, &MapPrpList);
+    Prp     = NvmeCreatePrpList (Private, PhyAddr, EFI_SIZE_TO_PAGES (Offset + Bytes) - 1, &PrpListHost, &PrpListNo, &MapPrpList);
     if (Prp == NULL) {
       Status = EFI_OUT_OF_RESOURCES;
       goto EXIT;
@@ -915,7 +1036,7 @@ EXIT:
   }
 
   if (Prp != NULL) {
-    PciIo->FreeBuffer (PciIo, PrpListNo, PrpListHost);
+    NvmeFreePrpList (Private, PrpListHost, PrpListNo);
   }
 
   if (TimerEvent != NULL) {
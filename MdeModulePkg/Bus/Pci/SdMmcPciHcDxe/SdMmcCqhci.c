@@ -0,0 +1,1033 @@
+/** @file
+  The command queue engine support of the SD/MMC host controller driver, as defined
+  by the eMMC 5.1 Command Queue Host Controller Interface (CQHCI).
+
+  The read and write tasks of an eMMC device in command queue mode are put in the
+  task descriptor list of the engine, each task linking to the ADMA2 descriptor
+  table of its TRB. The engine sends them to the device and transfers their data
+  without the driver, which only polls the task completion notifications.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "SdMmcPciHcDxe.h"
+
+/**
+  Read a register of the command queue engine of the slot.
+
+  @param[in]  Private       A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in]  Slot          The slot number of the eMMC device.
+  @param[in]  Offset        The offset of the register in the engine.
+  @param[out] Data          The value of the register.
+
+  @retval EFI_SUCCESS       The register is read.
+  @retval Others            The register can't be read.
+
+**/
+STATIC
+EFI_STATUS
+SdMmcCqeRead (
+  IN  SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN  UINT8                   Slot,
+  IN  UINT32                  Offset,
+  OUT UINT32                  *Data
+  )
+{
+  return SdMmcHcRwMmio (Private->PciIo, Slot, SD_MMC_CQHCI_BASE + Offset, TRUE, sizeof (UINT32), Data);
+}
+
+/**
+  Write a register of the command queue engine of the slot.
+
+  @param[in]  Private       A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in]  Slot          The slot number of the eMMC device.
+  @param[in]  Offset        The offset of the register in the engine.
+  @param[in]  Data          The value to write.
+
+  @retval EFI_SUCCESS       The register is written.
+  @retval Others            The register can't be written.
+
+**/
+STATIC
+EFI_STATUS
+SdMmcCqeWrite (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot,
+  IN UINT32                  Offset,
+  IN UINT32                  Data
+  )
+{
+  return SdMmcHcRwMmio (Private->PciIo, Slot, SD_MMC_CQHCI_BASE + Offset, FALSE, sizeof (UINT32), &Data);
+}
+
+/**
+  Wait for the bits of a register of the command queue engine of the slot.
+
+  @param[in]  Private       A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in]  Slot          The slot number of the eMMC device.
+  @param[in]  Offset        The offset of the register in the engine.
+  @param[in]  MaskValue     The mask of the bits.
+  @param[in]  TestValue     The expected value of the bits.
+
+  @retval EFI_SUCCESS       The bits have the expected value.
+  @retval EFI_TIMEOUT       The bits don't have the expected value in time.
+  @retval Others            The register can't be read.
+
+**/
+STATIC
+EFI_STATUS
+SdMmcCqeWaitSet (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot,
+  IN UINT32                  Offset,
+  IN UINT32                  MaskValue,
+  IN UINT32                  TestValue
+  )
+{
+  return SdMmcHcWaitMmioSet (
+           Private->PciIo,
+           Slot,
+           SD_MMC_CQHCI_BASE + Offset,
+           sizeof (UINT32),
+           MaskValue,
+           TestValue,
+           SD_MMC_HC_GENERIC_TIMEOUT
+           );
+}
+
+/**
+  Select the length of the ADMA2 descriptor lines of the slot.
+
+  The transfer descriptors of the engine have 16-bit lengths, so the 26-bit
+  length mode of V4.10 and later host controllers is turned off while the
+  engine runs, and turned on again for the TRBs sent while it is halted.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+  @param[in] Length26b      TRUE for the 26-bit length mode of the host controller.
+
+  @retval EFI_SUCCESS       The length mode is selected.
+  @retval Others            The host control 2 register can't be updated.
+
+**/
+STATIC
+EFI_STATUS
+SdMmcCqeSetAdmaLengthMode (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot,
+  IN BOOLEAN                 Length26b
+  )
+{
+  UINT16  HostCtrl2;
+
+  if (Private->ControllerVersion[Slot] < SD_MMC_HC_CTRL_VER_410) {
+    return EFI_SUCCESS;
+  }
+
+  if (Length26b) {
+    HostCtrl2 = SD_MMC_HC_26_DATA_LEN_ADMA_EN;
+    return SdMmcHcOrMmio (Private->PciIo, Slot, SD_MMC_HC_HOST_CTRL2, sizeof (HostCtrl2), &HostCtrl2);
+  }
+
+  HostCtrl2 = (UINT16) ~SD_MMC_HC_26_DATA_LEN_ADMA_EN;
+  return SdMmcHcAndMmio (Private->PciIo, Slot, SD_MMC_HC_HOST_CTRL2, sizeof (HostCtrl2), &HostCtrl2);
+}
+
+/**
+  Complete the tasks in the command queue engine with TaskStatus.
+
+  @param[in] Cqe            The command queue engine of the slot.
+  @param[in] TaskStatus     The result of the tasks.
+
+**/
+STATIC
+VOID
+SdMmcCqeCompleteTasks (
+  IN SD_MMC_HC_CQE  *Cqe,
+  IN EFI_STATUS     TaskStatus
+  )
+{
+  UINT8  Tag;
+
+  for (Tag = 0; Tag < SD_MMC_CQHCI_MAX_TASKS; Tag++) {
+    if (Cqe->Task[Tag] != NULL) {
+      Cqe->Task[Tag]->Packet->TransactionStatus = TaskStatus;
+      Cqe->Task[Tag]->CommandComplete           = TRUE;
+      Cqe->Task[Tag]                            = NULL;
+    }
+  }
+
+  Cqe->ActiveTags = 0;
+}
+
+/**
+  Discard the tasks in the command queue engine and disable it.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+
+**/
+STATIC
+VOID
+SdMmcCqeClearAll (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot
+  )
+{
+  SdMmcCqeHalt (Private, Slot);
+
+  SdMmcCqeWrite (Private, Slot, SD_MMC_CQHCI_CTL, SD_MMC_CQHCI_CTL_HALT | SD_MMC_CQHCI_CTL_CLEAR_ALL);
+  SdMmcCqeWaitSet (Private, Slot, SD_MMC_CQHCI_CTL, SD_MMC_CQHCI_CTL_CLEAR_ALL, 0);
+
+  SdMmcCqeWrite (Private, Slot, SD_MMC_CQHCI_CFG, 0);
+  SdMmcCqeSetAdmaLengthMode (Private, Slot, TRUE);
+  Private->Cqe[Slot].Halted = TRUE;
+}
+
+/**
+  Send a command without data to the eMMC device of the slot, while the command
+  queue engine is disabled.
+
+  It doesn't go through the pass thru protocol, which waits for the tasks of the
+  engine to complete.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+  @param[in] CommandIndex   The index of the command.
+  @param[in] Argument       The argument of the command.
+
+  @retval EFI_SUCCESS       The command is sent successfully.
+  @retval Others            The command fails.
+
+**/
+STATIC
+EFI_STATUS
+SdMmcCqeSendCommand (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot,
+  IN UINT16                  CommandIndex,
+  IN UINT32                  Argument
+  )
+{
+  EFI_SD_MMC_COMMAND_BLOCK             SdMmcCmdBlk;
+  EFI_SD_MMC_STATUS_BLOCK              SdMmcStatusBlk;
+  EFI_SD_MMC_PASS_THRU_COMMAND_PACKET  Packet;
+  SD_MMC_HC_TRB                        *Trb;
+  EFI_STATUS                           Status;
+
+  ZeroMem (&SdMmcCmdBlk, sizeof (SdMmcCmdBlk));
+  ZeroMem (&SdMmcStatusBlk, sizeof (SdMmcStatusBlk));
+  ZeroMem (&Packet, sizeof (Packet));
+
+  Packet.SdMmcCmdBlk    = &SdMmcCmdBlk;
+  Packet.SdMmcStatusBlk = &SdMmcStatusBlk;
+  Packet.Timeout        = SD_MMC_HC_GENERIC_TIMEOUT;
+
+  SdMmcCmdBlk.CommandIndex    = CommandIndex;
+  SdMmcCmdBlk.CommandType     = SdMmcCommandTypeAc;
+  SdMmcCmdBlk.ResponseType    = SdMmcResponseTypeR1b;
+  SdMmcCmdBlk.CommandArgument = Argument;
+
+  Trb = SdMmcCreateTrb (Private, Slot, &Packet, NULL, FALSE);
+  if (Trb == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = SdMmcWaitTrbEnv (Private, Trb);
+  if (!EFI_ERROR (Status)) {
+    Status = SdMmcExecTrb (Private, Trb);
+    if (!EFI_ERROR (Status)) {
+      Status = SdMmcWaitTrbResult (Private, Trb);
+    }
+  }
+
+  SdMmcFreeTrb (Trb);
+
+  return Status;
+}
+
+/**
+  Resume the command queue engine of the slot, enabling it first if it's disabled.
+
+  The registers of the host controller used by the engine for the data transfers
+  are set again, as the commands sent while the engine is halted change them.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+
+  @retval EFI_SUCCESS       The engine is running.
+  @retval Others            The engine can't be resumed.
+
+**/
+STATIC
+EFI_STATUS
+SdMmcCqeResume (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot
+  )
+{
+  EFI_STATUS     Status;
+  SD_MMC_HC_CQE  *Cqe;
+  UINT32         Config;
+  UINT32         Control;
+  UINT16         BlkSize;
+  UINT16         IntStatus;
+  UINT8          HostCtrl1;
+
+  Cqe = &Private->Cqe[Slot];
+
+  Status = SdMmcCqeRead (Private, Slot, SD_MMC_CQHCI_CFG, &Config);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if ((Config & SD_MMC_CQHCI_CFG_ENABLE) == 0) {
+    //
+    // 64-bit task descriptors and no direct command slot. The task completions
+    // are polled, so the interrupts are only reported in the status register.
+    //
+    Status = SdMmcCqeWrite (Private, Slot, SD_MMC_CQHCI_CFG, 0);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Status = SdMmcCqeWrite (Private, Slot, SD_MMC_CQHCI_TDLBA, (UINT32)Cqe->TdlPhy);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Status = SdMmcCqeWrite (Private, Slot, SD_MMC_CQHCI_TDLBAU, (UINT32)RShiftU64 (Cqe->TdlPhy, 32));
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Status = SdMmcCqeWrite (Private, Slot, SD_MMC_CQHCI_SSC2, Cqe->Rca);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Status = SdMmcCqeWrite (Private, Slot, SD_MMC_CQHCI_ISTE, SD_MMC_CQHCI_IS_MASK);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Status = SdMmcCqeWrite (Private, Slot, SD_MMC_CQHCI_ISGE, 0);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Status = SdMmcCqeWrite (Private, Slot, SD_MMC_CQHCI_CFG, SD_MMC_CQHCI_CFG_ENABLE);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  //
+  // Clear the interrupt status left by the commands sent while the engine is halted.
+  //
+  IntStatus = 0xFFFF;
+  Status    = SdMmcHcRwMmio (Private->PciIo, Slot, SD_MMC_HC_ERR_INT_STS, FALSE, sizeof (IntStatus), &IntStatus);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  IntStatus = 0xFF3F;
+  Status    = SdMmcHcRwMmio (Private->PciIo, Slot, SD_MMC_HC_NOR_INT_STS, FALSE, sizeof (IntStatus), &IntStatus);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  BlkSize = 0x200;
+  Status  = SdMmcHcRwMmio (Private->PciIo, Slot, SD_MMC_HC_BLK_SIZE, FALSE, sizeof (BlkSize), &BlkSize);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Set Host Control 1 register DMA Select field to ADMA2.
+  //
+  HostCtrl1 = (UINT8) ~(BIT3 | BIT4);
+  Status    = SdMmcHcAndMmio (Private->PciIo, Slot, SD_MMC_HC_HOST_CTRL1, sizeof (HostCtrl1), &HostCtrl1);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  HostCtrl1 = BIT4;
+  Status    = SdMmcHcOrMmio (Private->PciIo, Slot, SD_MMC_HC_HOST_CTRL1, sizeof (HostCtrl1), &HostCtrl1);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = SdMmcCqeSetAdmaLengthMode (Private, Slot, FALSE);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = SdMmcCqeRead (Private, Slot, SD_MMC_CQHCI_CTL, &Control);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if ((Control & SD_MMC_CQHCI_CTL_HALT) != 0) {
+    Status = SdMmcCqeWrite (Private, Slot, SD_MMC_CQHCI_CTL, 0);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Status = SdMmcCqeWaitSet (Private, Slot, SD_MMC_CQHCI_CTL, SD_MMC_CQHCI_CTL_HALT, 0);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  Cqe->Halted = FALSE;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Halt the command queue engine of the slot, so that the host controller can
+  send a command or a data transfer on its own.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+
+  @retval EFI_SUCCESS       The engine is halted, or isn't enabled.
+  @retval Others            The engine can't be halted.
+
+**/
+EFI_STATUS
+SdMmcCqeHalt (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot
+  )
+{
+  EFI_STATUS     Status;
+  SD_MMC_HC_CQE  *Cqe;
+
+  Cqe = &Private->Cqe[Slot];
+  if (!Cqe->Enabled || Cqe->Halted) {
+    return EFI_SUCCESS;
+  }
+
+  Status = SdMmcCqeWrite (Private, Slot, SD_MMC_CQHCI_CTL, SD_MMC_CQHCI_CTL_HALT);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = SdMmcCqeWaitSet (Private, Slot, SD_MMC_CQHCI_CTL, SD_MMC_CQHCI_CTL_HALT, SD_MMC_CQHCI_CTL_HALT);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "SdMmcCqeHalt: slot %d can't be halted with %r\n", Slot, Status));
+    return Status;
+  }
+
+  SdMmcCqeWrite (Private, Slot, SD_MMC_CQHCI_IS, SD_MMC_CQHCI_IS_HAC);
+  SdMmcCqeSetAdmaLengthMode (Private, Slot, TRUE);
+  Cqe->Halted = TRUE;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Start a task TRB in the command queue engine of its slot.
+
+  The task slot of the tag holds the task descriptor and a link descriptor to the
+  ADMA2 descriptor table built for the TRB.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Trb            The pointer to the SD_MMC_HC_TRB instance of the task.
+
+  @retval EFI_SUCCESS       The task is started.
+  @retval EFI_NOT_READY     All the tags are in use.
+  @retval EFI_NOT_STARTED   The engine isn't enabled.
+  @retval Others            The engine can't be resumed.
+
+**/
+EFI_STATUS
+SdMmcCqeStartTask (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN SD_MMC_HC_TRB           *Trb
+  )
+{
+  EFI_STATUS              Status;
+  SD_MMC_HC_CQE           *Cqe;
+  UINT32                  FreeTags;
+  UINT8                   Tag;
+  UINT8                   *TaskSlot;
+  SD_MMC_CQHCI_TASK_DESC  *TaskDesc;
+  SD_MMC_CQHCI_LINK_DESC  *LinkDesc;
+
+  Cqe = &Private->Cqe[Trb->Slot];
+  if (!Cqe->Enabled) {
+    return EFI_NOT_STARTED;
+  }
+
+  FreeTags = ~Cqe->ActiveTags & (UINT32)(LShiftU64 (1, Cqe->QueueDepth) - 1);
+  if (FreeTags == 0) {
+    return EFI_NOT_READY;
+  }
+
+  for (Tag = 0; (FreeTags & (BIT0 << Tag)) == 0; Tag++) {
+  }
+
+  if (Cqe->Halted) {
+    Status = SdMmcCqeResume (Private, Trb->Slot);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  TaskSlot = (UINT8 *)Cqe->Tdl + Tag * Cqe->SlotSize;
+  ZeroMem (TaskSlot, Cqe->SlotSize);
+
+  TaskDesc               = (SD_MMC_CQHCI_TASK_DESC *)TaskSlot;
+  TaskDesc->Valid        = 1;
+  TaskDesc->End          = 1;
+  TaskDesc->Int          = 1;
+  TaskDesc->Act          = SD_MMC_CQHCI_ACT_TASK;
+  TaskDesc->DataDir      = Trb->Read ? 1 : 0;
+  TaskDesc->BlockCount   = (UINT16)(Trb->DataLen / 0x200);
+  TaskDesc->BlockAddress = Trb->Packet->SdMmcCmdBlk->CommandArgument;
+
+  LinkDesc               = (SD_MMC_CQHCI_LINK_DESC *)(TaskSlot + sizeof (SD_MMC_CQHCI_TASK_DESC));
+  LinkDesc->Valid        = 1;
+  LinkDesc->Act          = SD_MMC_CQHCI_ACT_LINK;
+  LinkDesc->LowerAddress = (UINT32)Trb->AdmaDescPhy;
+  if (Cqe->Dma64) {
+    LinkDesc->UpperAddress = (UINT32)RShiftU64 (Trb->AdmaDescPhy, 32);
+  }
+
+  MemoryFence ();
+
+  Trb->Tag         = Tag;
+  Trb->Started     = TRUE;
+  Cqe->Task[Tag]   = Trb;
+  Cqe->ActiveTags |= BIT0 << Tag;
+
+  Status = SdMmcCqeWrite (Private, Trb->Slot, SD_MMC_CQHCI_TDBR, BIT0 << Tag);
+  if (EFI_ERROR (Status)) {
+    Trb->Started     = FALSE;
+    Cqe->Task[Tag]   = NULL;
+    Cqe->ActiveTags &= ~(BIT0 << Tag);
+    return Status;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Check the tasks in the command queue engine of the slot, and mark the completed
+  ones with their result.
+
+  The engine and the device are recovered when an error is reported, failing the
+  tasks in them.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+
+**/
+VOID
+SdMmcCqeCheckTasks (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot
+  )
+{
+  EFI_STATUS     Status;
+  EFI_TPL        OldTpl;
+  SD_MMC_HC_CQE  *Cqe;
+  UINT32         IntStatus;
+  UINT32         Completed;
+  UINT16         ErrIntStatus;
+  UINT16         NorIntStatus;
+  UINT8          Tag;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  Cqe = &Private->Cqe[Slot];
+  if (!Cqe->Enabled || (Cqe->ActiveTags == 0)) {
+    goto Exit;
+  }
+
+  Status = SdMmcCqeRead (Private, Slot, SD_MMC_CQHCI_IS, &IntStatus);
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  if (IntStatus != 0) {
+    SdMmcCqeWrite (Private, Slot, SD_MMC_CQHCI_IS, IntStatus);
+  }
+
+  Status = SdMmcCqeRead (Private, Slot, SD_MMC_CQHCI_TCN, &Completed);
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  if (Completed != 0) {
+    SdMmcCqeWrite (Private, Slot, SD_MMC_CQHCI_TCN, Completed);
+  }
+
+  Completed &= Cqe->ActiveTags;
+  for (Tag = 0; Tag < SD_MMC_CQHCI_MAX_TASKS; Tag++) {
+    if ((Completed & (BIT0 << Tag)) != 0) {
+      Cqe->Task[Tag]->Packet->TransactionStatus = EFI_SUCCESS;
+      Cqe->Task[Tag]->CommandComplete           = TRUE;
+      Cqe->Task[Tag]                            = NULL;
+      Cqe->ActiveTags                          &= ~(BIT0 << Tag);
+    }
+  }
+
+  Status = SdMmcHcRwMmio (Private->PciIo, Slot, SD_MMC_HC_ERR_INT_STS, TRUE, sizeof (ErrIntStatus), &ErrIntStatus);
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  if (((IntStatus & SD_MMC_CQHCI_IS_RED) != 0) ||
+      ((ErrIntStatus != 0) && (Cqe->ActiveTags != 0)))
+  {
+    DEBUG ((DEBUG_ERROR, "SdMmcCqeCheckTasks: slot %d error, IS %x, error interrupt status %x\n", Slot, IntStatus, ErrIntStatus));
+    SdMmcCqeRecover (Private, Slot, EFI_DEVICE_ERROR);
+  }
+
+  //
+  // Clear the command queuing event of the Normal Interrupt Status register.
+  //
+  NorIntStatus = BIT14;
+  SdMmcHcRwMmio (Private->PciIo, Slot, SD_MMC_HC_NOR_INT_STS, FALSE, sizeof (NorIntStatus), &NorIntStatus);
+
+Exit:
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Recover the command queue engine of the slot and the eMMC device from an error,
+  discarding the tasks in them.
+
+  The engine is left disabled, and enabled again when the next task is started.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+  @param[in] TaskStatus     The result of the discarded tasks.
+
+**/
+VOID
+SdMmcCqeRecover (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot,
+  IN EFI_STATUS              TaskStatus
+  )
+{
+  SD_MMC_HC_CQE  *Cqe;
+  UINT16         IntStatus;
+
+  Cqe = &Private->Cqe[Slot];
+  if (!Cqe->Enabled) {
+    return;
+  }
+
+  DEBUG ((DEBUG_ERROR, "SdMmcCqeRecover: slot %d tasks %08x discarded with %r\n", Slot, Cqe->ActiveTags, TaskStatus));
+
+  SdMmcCqeClearAll (Private, Slot);
+
+  //
+  // Reset the CMD and DAT lines of the host controller.
+  //
+  SdMmcSoftwareReset (Private->PciIo, Slot, 0xFF);
+
+  IntStatus = 0xFFFF;
+  SdMmcHcRwMmio (Private->PciIo, Slot, SD_MMC_HC_ERR_INT_STS, FALSE, sizeof (IntStatus), &IntStatus);
+  IntStatus = 0xFF3F;
+  SdMmcHcRwMmio (Private->PciIo, Slot, SD_MMC_HC_NOR_INT_STS, FALSE, sizeof (IntStatus), &IntStatus);
+  SdMmcCqeWrite (Private, Slot, SD_MMC_CQHCI_TCN, MAX_UINT32);
+  SdMmcCqeWrite (Private, Slot, SD_MMC_CQHCI_IS, SD_MMC_CQHCI_IS_MASK);
+
+  //
+  // Stop the data transfer in progress, then discard the queue of the device.
+  //
+  SdMmcCqeSendCommand (Private, Slot, EMMC_STOP_TRANSMISSION, 0);
+  SdMmcCqeSendCommand (Private, Slot, EMMC_CMDQ_TASK_MGMT, 1);
+
+  SdMmcCqeCompleteTasks (Cqe, TaskStatus);
+}
+
+/**
+  Disable the command queue engine of the slot and free its task descriptor list.
+  The tasks in the engine are completed with TaskStatus.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+  @param[in] TaskStatus     The result of the tasks in the engine.
+
+**/
+VOID
+SdMmcCqeStop (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot,
+  IN EFI_STATUS              TaskStatus
+  )
+{
+  SD_MMC_HC_CQE  *Cqe;
+
+  Cqe = &Private->Cqe[Slot];
+  if (!Cqe->Enabled) {
+    return;
+  }
+
+  if ((Cqe->ActiveTags != 0) && Private->Slot[Slot].MediaPresent) {
+    SdMmcCqeRecover (Private, Slot, TaskStatus);
+  } else {
+    SdMmcCqeClearAll (Private, Slot);
+    SdMmcCqeCompleteTasks (Cqe, TaskStatus);
+  }
+
+  Private->PciIo->Unmap (Private->PciIo, Cqe->TdlMap);
+  Private->PciIo->FreeBuffer (Private->PciIo, 1, Cqe->Tdl);
+
+  ZeroMem (Cqe, sizeof (SD_MMC_HC_CQE));
+}
+
+/**
+  Enable the command queue engine of a slot.
+
+  @param[in]      This          A pointer to the EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL instance.
+  @param[in]      Slot          The slot number of the eMMC device.
+  @param[in]      Rca           The relative device address of the eMMC device.
+  @param[in, out] QueueDepth    On input, the number of tasks the device can queue.
+                                On output, the number of tasks the host keeps queued
+                                in the device.
+
+  @retval EFI_SUCCESS           The command queue engine is enabled.
+  @retval EFI_INVALID_PARAMETER Slot or QueueDepth is invalid.
+  @retval EFI_UNSUPPORTED       The slot has no command queue engine.
+  @retval EFI_ALREADY_STARTED   The command queue engine is already enabled.
+  @retval EFI_OUT_OF_RESOURCES  The task descriptor list can't be allocated.
+  @retval EFI_DEVICE_ERROR      The command queue engine can't be enabled.
+
+**/
+EFI_STATUS
+EFIAPI
+SdMmcCommandQueueEnable (
+  IN     EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL  *This,
+  IN     UINT8                                Slot,
+  IN     UINT16                               Rca,
+  IN OUT UINT8                                *QueueDepth
+  )
+{
+  EFI_STATUS              Status;
+  SD_MMC_HC_PRIVATE_DATA  *Private;
+  SD_MMC_HC_CQE           *Cqe;
+  EFI_PCI_IO_PROTOCOL     *PciIo;
+  UINT32                  Version;
+  UINTN                   Bytes;
+
+  if ((This == NULL) || (QueueDepth == NULL) || (*QueueDepth == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Private = SD_MMC_HC_PRIVATE_FROM_COMMAND_QUEUE (This);
+
+  if ((Slot >= SD_MMC_HC_MAX_SLOT) || !Private->Slot[Slot].Enable) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // The tasks use the ADMA2 descriptor tables of their TRB, whose lines must have
+  // the layout of the transfer descriptors of the engine.
+  //
+  if ((SD_MMC_CQHCI_BASE == 0) ||
+      (Private->Slot[Slot].CardType != EmmcCardType) ||
+      (Private->Capability[Slot].Adma2 == 0) ||
+      ((Private->ControllerVersion[Slot] == SD_MMC_HC_CTRL_VER_300) &&
+       (Private->Capability[Slot].SysBus64V3 == 1)))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  Cqe = &Private->Cqe[Slot];
+  if (Cqe->Enabled) {
+    return EFI_ALREADY_STARTED;
+  }
+
+  Status = SdMmcCqeRead (Private, Slot, SD_MMC_CQHCI_VER, &Version);
+  if (EFI_ERROR (Status) || (Version == 0) || (Version == MAX_UINT32)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Cqe->Dma64 = (BOOLEAN)(((Private->ControllerVersion[Slot] == SD_MMC_HC_CTRL_VER_400) &&
+                          (Private->Capability[Slot].SysBus64V3 == 1)) ||
+                         ((Private->ControllerVersion[Slot] >= SD_MMC_HC_CTRL_VER_410) &&
+                          (Private->Capability[Slot].SysBus64V4 == 1)));
+
+  PciIo  = Private->PciIo;
+  Status = PciIo->AllocateBuffer (
+                    PciIo,
+                    AllocateAnyPages,
+                    EfiBootServicesData,
+                    1,
+                    &Cqe->Tdl,
+                    0
+                    );
+  if (EFI_ERROR (Status)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ZeroMem (Cqe->Tdl, EFI_PAGE_SIZE);
+  Bytes  = EFI_PAGE_SIZE;
+  Status = PciIo->Map (
+                    PciIo,
+                    EfiPciIoOperationBusMasterCommonBuffer,
+                    Cqe->Tdl,
+                    &Bytes,
+                    &Cqe->TdlPhy,
+                    &Cqe->TdlMap
+                    );
+  if (EFI_ERROR (Status) || (Bytes != EFI_PAGE_SIZE)) {
+    PciIo->FreeBuffer (PciIo, 1, Cqe->Tdl);
+    ZeroMem (Cqe, sizeof (SD_MMC_HC_CQE));
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  if (!Cqe->Dma64 && ((Cqe->TdlPhy + EFI_PAGE_SIZE) > 0x100000000ul)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Error;
+  }
+
+  Cqe->QueueDepth = MIN (*QueueDepth, SD_MMC_CQHCI_MAX_TASKS);
+  Cqe->SlotSize   = sizeof (SD_MMC_CQHCI_TASK_DESC) +
+                    (Cqe->Dma64 ? SD_MMC_CQHCI_LINK_DESC_64B : SD_MMC_CQHCI_LINK_DESC_32B);
+  Cqe->Rca    = Rca;
+  Cqe->Halted = TRUE;
+
+  //
+  // Drop the configuration the engine may have been left with.
+  //
+  Status = SdMmcCqeWrite (Private, Slot, SD_MMC_CQHCI_CFG, 0);
+  if (!EFI_ERROR (Status)) {
+    Status = SdMmcCqeResume (Private, Slot);
+  }
+
+  if (EFI_ERROR (Status)) {
+    Status = EFI_DEVICE_ERROR;
+    goto Error;
+  }
+
+  Cqe->Enabled = TRUE;
+  *QueueDepth  = Cqe->QueueDepth;
+
+  DEBUG ((DEBUG_INFO, "SdMmcCommandQueueEnable: slot %d version %x queue depth %d\n", Slot, Version, Cqe->QueueDepth));
+
+  return EFI_SUCCESS;
+
+Error:
+  SdMmcCqeSetAdmaLengthMode (Private, Slot, TRUE);
+  PciIo->Unmap (PciIo, Cqe->TdlMap);
+  PciIo->FreeBuffer (PciIo, 1, Cqe->Tdl);
+  ZeroMem (Cqe, sizeof (SD_MMC_HC_CQE));
+  return Status;
+}
+
+/**
+  Disable the command queue engine of a slot after the queued tasks are done.
+
+  @param[in]  This              A pointer to the EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL instance.
+  @param[in]  Slot              The slot number of the eMMC device.
+
+  @retval EFI_SUCCESS           The command queue engine is disabled.
+  @retval EFI_INVALID_PARAMETER Slot is invalid.
+  @retval EFI_NOT_STARTED       The command queue engine isn't enabled.
+  @retval EFI_DEVICE_ERROR      The command queue engine can't be halted.
+
+**/
+EFI_STATUS
+EFIAPI
+SdMmcCommandQueueDisable (
+  IN EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL  *This,
+  IN UINT8                                Slot
+  )
+{
+  EFI_STATUS              Status;
+  SD_MMC_HC_PRIVATE_DATA  *Private;
+  SD_MMC_HC_CQE           *Cqe;
+  EFI_TPL                 OldTpl;
+
+  if (This == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Private = SD_MMC_HC_PRIVATE_FROM_COMMAND_QUEUE (This);
+
+  if (Slot >= SD_MMC_HC_MAX_SLOT) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Cqe = &Private->Cqe[Slot];
+  if (!Cqe->Enabled) {
+    return EFI_NOT_STARTED;
+  }
+
+  //
+  // Wait async I/O list and the tasks in the engine are done.
+  //
+  Status = EFI_SUCCESS;
+  while (TRUE) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    if (IsListEmpty (&Private->Queue) && (Cqe->ActiveTags == 0)) {
+      Status = SdMmcCqeHalt (Private, Slot);
+      SdMmcCqeStop (Private, Slot, EFI_ABORTED);
+      gBS->RestoreTPL (OldTpl);
+      break;
+    }
+
+    gBS->RestoreTPL (OldTpl);
+  }
+
+  return EFI_ERROR (Status) ? EFI_DEVICE_ERROR : EFI_SUCCESS;
+}
+
+/**
+  Queue a read or write task in the eMMC device of a slot.
+
+  @param[in]      This          A pointer to the EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL instance.
+  @param[in]      Slot          The slot number of the eMMC device.
+  @param[in, out] Packet        A pointer to the command packet of the task.
+  @param[in]      Event         If Event is NULL, blocking I/O is performed. If Event is
+                                not NULL, then nonblocking I/O is performed, and Event
+                                will be signaled when the task completes.
+
+  @retval EFI_SUCCESS           The task is done if Event is NULL, or queued otherwise.
+  @retval EFI_INVALID_PARAMETER Slot or Packet is invalid.
+  @retval EFI_NOT_STARTED       The command queue engine isn't enabled.
+  @retval EFI_NO_MEDIA          The device isn't present in the slot.
+  @retval EFI_OUT_OF_RESOURCES  The task can't be queued due to lack of resources.
+  @retval EFI_DEVICE_ERROR      The task failed.
+  @retval EFI_TIMEOUT           The task didn't complete in the timeout of Packet.
+
+**/
+EFI_STATUS
+EFIAPI
+SdMmcCommandQueueQueueTask (
+  IN     EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL  *This,
+  IN     UINT8                                Slot,
+  IN OUT EFI_SD_MMC_PASS_THRU_COMMAND_PACKET  *Packet,
+  IN     EFI_EVENT                            Event    OPTIONAL
+  )
+{
+  EFI_STATUS              Status;
+  SD_MMC_HC_PRIVATE_DATA  *Private;
+  SD_MMC_HC_TRB           *Trb;
+  EFI_TPL                 OldTpl;
+  UINT32                  DataLen;
+  UINT64                  Timeout;
+  BOOLEAN                 InfiniteWait;
+
+  if ((This == NULL) || (Packet == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((Packet->SdMmcCmdBlk == NULL) || (Packet->SdMmcStatusBlk == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Private = SD_MMC_HC_PRIVATE_FROM_COMMAND_QUEUE (This);
+
+  if ((Slot >= SD_MMC_HC_MAX_SLOT) || !Private->Slot[Slot].Enable) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((Packet->SdMmcCmdBlk->CommandIndex == EMMC_READ_MULTIPLE_BLOCK) &&
+      (Packet->InDataBuffer != NULL) && (Packet->OutTransferLength == 0))
+  {
+    DataLen = Packet->InTransferLength;
+  } else if ((Packet->SdMmcCmdBlk->CommandIndex == EMMC_WRITE_MULTIPLE_BLOCK) &&
+             (Packet->OutDataBuffer != NULL) && (Packet->InTransferLength == 0))
+  {
+    DataLen = Packet->OutTransferLength;
+  } else {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((DataLen == 0) || ((DataLen % 0x200) != 0) || ((DataLen / 0x200) > MAX_UINT16)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (!Private->Slot[Slot].MediaPresent) {
+    return EFI_NO_MEDIA;
+  }
+
+  if (!Private->Cqe[Slot].Enabled) {
+    return EFI_NOT_STARTED;
+  }
+
+  Trb = SdMmcCreateTrb (Private, Slot, Packet, NULL, TRUE);
+  if (Trb == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ASSERT ((Trb->Mode == SdMmcAdma32bMode) || (Trb->Mode == SdMmcAdma64bV4Mode));
+  ASSERT (Trb->AdmaLengthMode == SdMmcAdmaLen16b);
+
+  //
+  // Queue async I/O, started by the timer in order with the other TRBs.
+  //
+  if (Event != NULL) {
+    Trb->Event = Event;
+    OldTpl     = gBS->RaiseTPL (TPL_NOTIFY);
+    InsertTailList (&Private->Queue, &Trb->TrbList);
+    gBS->RestoreTPL (OldTpl);
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Wait async I/O list is empty and a tag is free before starting the task.
+  //
+  Status = EFI_NOT_READY;
+  while (TRUE) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    if (IsListEmpty (&Private->Queue)) {
+      Status = SdMmcCqeStartTask (Private, Trb);
+      if (Status != EFI_NOT_READY) {
+        gBS->RestoreTPL (OldTpl);
+        break;
+      }
+    }
+
+    gBS->RestoreTPL (OldTpl);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Timeout = Packet->Timeout;
+    if (Timeout == 0) {
+      InfiniteWait = TRUE;
+    } else {
+      InfiniteWait = FALSE;
+    }
+
+    while (!Trb->CommandComplete && (InfiniteWait || (Timeout > 0))) {
+      SdMmcCqeCheckTasks (Private, Slot);
+      if (Trb->CommandComplete) {
+        break;
+      }
+
+      //
+      // Stall for 1 microsecond.
+      //
+      gBS->Stall (1);
+
+      Timeout--;
+    }
+
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    if (!Trb->CommandComplete) {
+      SdMmcCqeRecover (Private, Slot, EFI_TIMEOUT);
+    }
+
+    gBS->RestoreTPL (OldTpl);
+
+    Status = Packet->TransactionStatus;
+  }
+
+  SdMmcFreeTrb (Trb);
+
+  return Status;
+}
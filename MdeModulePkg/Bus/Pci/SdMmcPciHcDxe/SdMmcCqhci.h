@@ -0,0 +1,115 @@
+/** @file
+
+  Provides the definitions of the command queue engine of the SD/MMC host controller.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+  @par Specification Reference:
+    - Embedded Multi-Media Card (e.MMC) Electrical Standard 5.1, JESD84-B51, Appendix B
+**/
+
+#pragma once
+
+//
+// The offset of the command queue engine registers in the register space of a slot.
+//
+#define SD_MMC_CQHCI_BASE  (PcdGet32 (PcdSdMmcCqhciRegisterOffset))
+
+//
+// Command Queue Host Controller Interface Register Offset
+//
+#define SD_MMC_CQHCI_VER     0x00
+#define SD_MMC_CQHCI_CAP     0x04
+#define SD_MMC_CQHCI_CFG     0x08
+#define SD_MMC_CQHCI_CTL     0x0C
+#define SD_MMC_CQHCI_IS      0x10
+#define SD_MMC_CQHCI_ISTE    0x14
+#define SD_MMC_CQHCI_ISGE    0x18
+#define SD_MMC_CQHCI_IC      0x1C
+#define SD_MMC_CQHCI_TDLBA   0x20
+#define SD_MMC_CQHCI_TDLBAU  0x24
+#define SD_MMC_CQHCI_TDBR    0x28
+#define SD_MMC_CQHCI_TCN     0x2C
+#define SD_MMC_CQHCI_DQS     0x30
+#define SD_MMC_CQHCI_DPT     0x34
+#define SD_MMC_CQHCI_TCLR    0x38
+#define SD_MMC_CQHCI_SSC1    0x40
+#define SD_MMC_CQHCI_SSC2    0x44
+#define SD_MMC_CQHCI_CRDCT   0x48
+#define SD_MMC_CQHCI_RMEM    0x50
+#define SD_MMC_CQHCI_TERRI   0x54
+
+//
+// Bits of the Configuration register
+//
+#define SD_MMC_CQHCI_CFG_ENABLE     BIT0
+#define SD_MMC_CQHCI_CFG_TASK_128B  BIT8
+#define SD_MMC_CQHCI_CFG_DCMD       BIT12
+
+//
+// Bits of the Control register
+//
+#define SD_MMC_CQHCI_CTL_HALT       BIT0
+#define SD_MMC_CQHCI_CTL_CLEAR_ALL  BIT8
+
+//
+// Bits of the Interrupt Status register
+//
+#define SD_MMC_CQHCI_IS_HAC   BIT0
+#define SD_MMC_CQHCI_IS_TCC   BIT1
+#define SD_MMC_CQHCI_IS_RED   BIT2
+#define SD_MMC_CQHCI_IS_TCL   BIT3
+#define SD_MMC_CQHCI_IS_MASK  (SD_MMC_CQHCI_IS_HAC | SD_MMC_CQHCI_IS_TCC | SD_MMC_CQHCI_IS_RED | SD_MMC_CQHCI_IS_TCL)
+
+//
+// The engine has 32 task slots, selected by the tag of the task.
+//
+#define SD_MMC_CQHCI_MAX_TASKS  32
+
+//
+// The Act field of the descriptors. The transfer descriptors are the ADMA2
+// descriptor lines of the host controller, whose Act 2 is the transfer 4 here.
+//
+#define SD_MMC_CQHCI_ACT_TRAN  0x4
+#define SD_MMC_CQHCI_ACT_TASK  0x5
+#define SD_MMC_CQHCI_ACT_LINK  0x6
+
+//
+// Task descriptor of 64 bits, at the start of a task slot.
+//
+typedef struct {
+  UINT32    Valid         : 1;  // bit 0
+  UINT32    End           : 1;  // bit 1
+  UINT32    Int           : 1;  // bit 2
+  UINT32    Act           : 3;  // bit 3:5
+  UINT32    ForcedProg    : 1;  // bit 6
+  UINT32    ContextId     : 4;  // bit 7:10
+  UINT32    DataTag       : 1;  // bit 11
+  UINT32    DataDir       : 1;  // bit 12
+  UINT32    Priority      : 1;  // bit 13
+  UINT32    Qbr           : 1;  // bit 14
+  UINT32    ReliableWrite : 1;  // bit 15
+  UINT32    BlockCount    : 16; // bit 16:31
+  UINT32    BlockAddress;       // bit 32:63
+} SD_MMC_CQHCI_TASK_DESC;
+
+//
+// Link descriptor following the task descriptor in a task slot. It points to the
+// ADMA2 descriptor table of the task. UpperAddress only exists with 64-bit addressing,
+// and Reserved1 pads the descriptor to 128 bits then.
+//
+typedef struct {
+  UINT32    Valid        : 1;
+  UINT32    End          : 1;
+  UINT32    Int          : 1;
+  UINT32    Act          : 3;
+  UINT32    Reserved     : 10;
+  UINT32    Length       : 16;
+  UINT32    LowerAddress;
+  UINT32    UpperAddress;
+  UINT32    Reserved1;
+} SD_MMC_CQHCI_LINK_DESC;
+
+#define SD_MMC_CQHCI_LINK_DESC_32B  8
+#define SD_MMC_CQHCI_LINK_DESC_64B  16
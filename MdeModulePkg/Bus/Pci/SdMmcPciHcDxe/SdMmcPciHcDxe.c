@@ -48,6 +48,11 @@ SD_MMC_HC_PRIVATE_DATA  gSdMmcPciHcTemplate = {
     SdMmcPassThruGetSlotNumber,
     SdMmcPassThruResetDevice
   },
+  {                                 // CommandQueue
+    SdMmcCommandQueueEnable,
+    SdMmcCommandQueueDisable,
+    SdMmcCommandQueueQueueTask
+  },
   0,                                // PciAttributes
   0,                                // PreviousSlot
   NULL,                             // TimerEvent
@@ -156,74 +161,116 @@ ProcessAsyncTaskList (
 {
   SD_MMC_HC_PRIVATE_DATA               *Private;
   LIST_ENTRY                           *Link;
+  LIST_ENTRY                           *NextLink;
   SD_MMC_HC_TRB                        *Trb;
   EFI_STATUS                           Status;
   EFI_SD_MMC_PASS_THRU_COMMAND_PACKET  *Packet;
   BOOLEAN                              InfiniteWait;
   EFI_EVENT                            TrbEvent;
+  UINT8                                Slot;
 
   Private = (SD_MMC_HC_PRIVATE_DATA *)Context;
 
   //
-  // Check if the first entry in the async I/O queue is done or not.
+  // Collect the tasks completed by the command queue engines.
   //
-  Status = EFI_SUCCESS;
-  Trb    = NULL;
-  Link   = GetFirstNode (&Private->Queue);
-  if (!IsNull (&Private->Queue, Link)) {
-    Trb = SD_MMC_HC_TRB_FROM_THIS (Link);
+  for (Slot = 0; Slot < SD_MMC_HC_MAX_SLOT; Slot++) {
+    SdMmcCqeCheckTasks (Private, Slot);
+  }
+
+  //
+  // Check the entries in the async I/O queue in order. The tasks of the command
+  // queue engines are started as long as tags are free, while the other TRBs are
+  // executed one at a time, when the tasks queued before them are done.
+  //
+  for (Link = GetFirstNode (&Private->Queue);
+       !IsNull (&Private->Queue, Link);
+       Link = NextLink)
+  {
+    NextLink = GetNextNode (&Private->Queue, Link);
+    Trb      = SD_MMC_HC_TRB_FROM_THIS (Link);
     if (!Private->Slot[Trb->Slot].MediaPresent) {
       Status = EFI_NO_MEDIA;
-      goto Done;
-    }
+    } else if (Trb->IsTask) {
+      if (Trb->CommandComplete) {
+        Status = Trb->Packet->TransactionStatus;
+      } else if (!Trb->Started) {
+        Status = SdMmcCqeStartTask (Private, Trb);
+        if (!EFI_ERROR (Status)) {
+          Status = EFI_NOT_READY;
+        }
+      } else {
+        Status = EFI_NOT_READY;
+      }
+    } else {
+      if (Link != GetFirstNode (&Private->Queue)) {
+        break;
+      }
 
-    if (!Trb->Started) {
-      //
-      // Check whether the cmd/data line is ready for transfer.
-      //
-      Status = SdMmcCheckTrbEnv (Private, Trb);
-      if (!EFI_ERROR (Status)) {
-        Trb->Started = TRUE;
-        Status       = SdMmcExecTrb (Private, Trb);
-        if (EFI_ERROR (Status)) {
-          goto Done;
+      if (Private->Cqe[Trb->Slot].ActiveTags != 0) {
+        Status = EFI_NOT_READY;
+      } else if (!Trb->Started) {
+        //
+        // Check whether the cmd/data line is ready for transfer.
+        //
+        Status = SdMmcCheckTrbEnv (Private, Trb);
+        if (!EFI_ERROR (Status)) {
+          Status = SdMmcCqeHalt (Private, Trb->Slot);
+        }
+
+        if (!EFI_ERROR (Status)) {
+          Trb->Started = TRUE;
+          Status       = SdMmcExecTrb (Private, Trb);
+          if (!EFI_ERROR (Status)) {
+            Status = SdMmcCheckTrbResult (Private, Trb);
+          }
         }
       } else {
-        goto Done;
+        Status = SdMmcCheckTrbResult (Private, Trb);
       }
     }
 
-    Status = SdMmcCheckTrbResult (Private, Trb);
-  }
+    if (Status == EFI_NOT_READY) {
+      Packet = Trb->Packet;
+      if (Packet->Timeout == 0) {
+        InfiniteWait = TRUE;
+      } else {
+        InfiniteWait = FALSE;
+      }
 
-Done:
-  if ((Trb != NULL) && (Status == EFI_NOT_READY)) {
-    Packet = Trb->Packet;
-    if (Packet->Timeout == 0) {
-      InfiniteWait = TRUE;
-    } else {
-      InfiniteWait = FALSE;
-    }
+      if ((!InfiniteWait) && (Trb->Timeout-- == 0)) {
+        if (Trb->IsTask && Trb->Started) {
+          SdMmcCqeRecover (Private, Trb->Slot, EFI_TIMEOUT);
+        }
+
+        RemoveEntryList (Link);
+        Trb->Packet->TransactionStatus = EFI_TIMEOUT;
+        TrbEvent                       = Trb->Event;
+        SdMmcFreeTrb (Trb);
+        DEBUG ((DEBUG_VERBOSE, "ProcessAsyncTaskList(): Signal Event %p EFI_TIMEOUT\n", TrbEvent));
+        gBS->SignalEvent (TrbEvent);
+        //
+        // The recovery may complete the other tasks of the slot.
+        //
+        NextLink = GetFirstNode (&Private->Queue);
+        continue;
+      }
 
-    if ((!InfiniteWait) && (Trb->Timeout-- == 0)) {
+      if (!Trb->IsTask) {
+        break;
+      }
+    } else if ((Status == EFI_CRC_ERROR) && !Trb->IsTask && (Trb->Retries > 0)) {
+      Trb->Retries--;
+      Trb->Started = FALSE;
+      break;
+    } else {
       RemoveEntryList (Link);
-      Trb->Packet->TransactionStatus = EFI_TIMEOUT;
+      Trb->Packet->TransactionStatus = Status;
       TrbEvent                       = Trb->Event;
       SdMmcFreeTrb (Trb);
-      DEBUG ((DEBUG_VERBOSE, "ProcessAsyncTaskList(): Signal Event %p EFI_TIMEOUT\n", TrbEvent));
+      DEBUG ((DEBUG_VERBOSE, "ProcessAsyncTaskList(): Signal Event %p with %r\n", TrbEvent, Status));
       gBS->SignalEvent (TrbEvent);
-      return;
     }
-  } else if ((Trb != NULL) && (Status == EFI_CRC_ERROR) && (Trb->Retries > 0)) {
-    Trb->Retries--;
-    Trb->Started = FALSE;
-  } else if ((Trb != NULL)) {
-    RemoveEntryList (Link);
-    Trb->Packet->TransactionStatus = Status;
-    TrbEvent                       = Trb->Event;
-    SdMmcFreeTrb (Trb);
-    DEBUG ((DEBUG_VERBOSE, "ProcessAsyncTaskList(): Signal Event %p with %r\n", TrbEvent, Status));
-    gBS->SignalEvent (TrbEvent);
   }
 
   return;
@@ -269,6 +316,7 @@ SdMmcPciHcEnumerateDevice (
         // Signal all async task events at the slot with EFI_NO_MEDIA status.
         //
         OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+        SdMmcCqeStop (Private, Slot, EFI_NO_MEDIA);
         for (Link = GetFirstNode (&Private->Queue);
              !IsNull (&Private->Queue, Link);
              Link = NextLink)
@@ -838,6 +886,8 @@ SdMmcPciHcDriverBindingStart (
                   &Controller,
                   &gEfiSdMmcPassThruProtocolGuid,
                   &(Private->PassThru),
+                  &gEdkiiSdMmcCommandQueueProtocolGuid,
+                  &(Private->CommandQueue),
                   NULL
                   );
 
@@ -922,6 +972,7 @@ SdMmcPciHcDriverBindingStop (
   LIST_ENTRY                     *Link;
   LIST_ENTRY                     *NextLink;
   SD_MMC_HC_TRB                  *Trb;
+  UINT8                          Slot;
 
   DEBUG ((DEBUG_INFO, "SdMmcPciHcDriverBindingStop: Start\n"));
 
@@ -951,6 +1002,13 @@ SdMmcPciHcDriverBindingStop (
     Private->ConnectEvent = NULL;
   }
 
+  //
+  // Stop the command queue engines, failing the tasks in them.
+  //
+  for (Slot = 0; Slot < SD_MMC_HC_MAX_SLOT; Slot++) {
+    SdMmcCqeStop (Private, Slot, EFI_ABORTED);
+  }
+
   //
   // As the timer is closed, there is no needs to use TPL lock to
   // protect the critical region "queue".
@@ -970,10 +1028,13 @@ SdMmcPciHcDriverBindingStop (
   //
   // Uninstall Block I/O protocol from the device handle
   //
-  Status = gBS->UninstallProtocolInterface (
+  Status = gBS->UninstallMultipleProtocolInterfaces (
                   Controller,
                   &gEfiSdMmcPassThruProtocolGuid,
-                  &(Private->PassThru)
+                  &(Private->PassThru),
+                  &gEdkiiSdMmcCommandQueueProtocolGuid,
+                  &(Private->CommandQueue),
+                  NULL
                   );
 
   if (EFI_ERROR (Status)) {
@@ -1023,12 +1084,16 @@ SdMmcPassThruExecSyncTrb (
   EFI_STATUS  Status;
   EFI_TPL     OldTpl;
 
+  Status = EFI_SUCCESS;
+
   //
-  // Wait async I/O list is empty before execute sync I/O operation.
+  // Wait async I/O list is empty and the tasks of the command queue engine are
+  // done before execute sync I/O operation.
   //
   while (TRUE) {
     OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
-    if (IsListEmpty (&Private->Queue)) {
+    if (IsListEmpty (&Private->Queue) && (Private->Cqe[Trb->Slot].ActiveTags == 0)) {
+      Status = SdMmcCqeHalt (Private, Trb->Slot);
       gBS->RestoreTPL (OldTpl);
       break;
     }
@@ -1036,6 +1101,10 @@ SdMmcPassThruExecSyncTrb (
     gBS->RestoreTPL (OldTpl);
   }
 
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   while (Trb->Retries) {
     Status = SdMmcWaitTrbEnv (Private, Trb);
     if (EFI_ERROR (Status)) {
@@ -1138,7 +1207,7 @@ SdMmcPassThruPassThru (
     return EFI_DEVICE_ERROR;
   }
 
-  Trb = SdMmcCreateTrb (Private, Slot, Packet, Event);
+  Trb = SdMmcCreateTrb (Private, Slot, Packet, Event, FALSE);
   if (Trb == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
@@ -1418,6 +1487,7 @@ SdMmcPassThruResetDevice (
   LIST_ENTRY              *NextLink;
   SD_MMC_HC_TRB           *Trb;
   EFI_TPL                 OldTpl;
+  UINT8                   Index;
 
   if (This == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -1438,10 +1508,17 @@ SdMmcPassThruResetDevice (
   }
 
   //
-  // Free all async I/O requests in the queue
+  // Free all async I/O requests in the queue, discarding the tasks of the
+  // command queue engines first.
   //
   OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
 
+  for (Index = 0; Index < SD_MMC_HC_MAX_SLOT; Index++) {
+    if (Private->Cqe[Index].ActiveTags != 0) {
+      SdMmcCqeRecover (Private, Index, EFI_ABORTED);
+    }
+  }
+
   for (Link = GetFirstNode (&Private->Queue);
        !IsNull (&Private->Queue, Link);
        Link = NextLink)
@@ -32,8 +32,10 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/ComponentName2.h>
 #include <Protocol/SdMmcOverride.h>
 #include <Protocol/SdMmcPassThru.h>
+#include <Protocol/SdMmcCommandQueue.h>
 
 #include "SdMmcPciHci.h"
+#include "SdMmcCqhci.h"
 
 extern EFI_COMPONENT_NAME_PROTOCOL   gSdMmcPciHcComponentName;
 extern EFI_COMPONENT_NAME2_PROTOCOL  gSdMmcPciHcComponentName2;
@@ -46,6 +48,9 @@ extern EDKII_SD_MMC_OVERRIDE  *mOverride;
 #define SD_MMC_HC_PRIVATE_FROM_THIS(a) \
     CR(a, SD_MMC_HC_PRIVATE_DATA, PassThru, SD_MMC_HC_PRIVATE_SIGNATURE)
 
+#define SD_MMC_HC_PRIVATE_FROM_COMMAND_QUEUE(a) \
+    CR(a, SD_MMC_HC_PRIVATE_DATA, CommandQueue, SD_MMC_HC_PRIVATE_SIGNATURE)
+
 //
 // Generic time out value, 1 microsecond as unit.
 //
@@ -87,39 +92,70 @@ typedef struct {
   EDKII_SD_MMC_OPERATING_PARAMETERS    OperatingParameters;
 } SD_MMC_HC_SLOT;
 
+typedef struct _SD_MMC_HC_TRB SD_MMC_HC_TRB;
+
+//
+// The command queue engine of a slot.
+//
 typedef struct {
-  UINTN                            Signature;
+  BOOLEAN                 Enabled;
+  //
+  // The engine is halted or disabled, and must be resumed before it gets a task.
+  //
+  BOOLEAN                 Halted;
+  BOOLEAN                 Dma64;
+  UINT8                   QueueDepth;
+  UINT16                  Rca;
+  //
+  // The size of a task slot in the task descriptor list.
+  //
+  UINT32                  SlotSize;
+  VOID                    *Tdl;
+  EFI_PHYSICAL_ADDRESS    TdlPhy;
+  VOID                    *TdlMap;
+  //
+  // The tasks in the engine, indexed by tag.
+  //
+  UINT32                  ActiveTags;
+  SD_MMC_HC_TRB           *Task[SD_MMC_CQHCI_MAX_TASKS];
+} SD_MMC_HC_CQE;
 
-  EFI_HANDLE                       ControllerHandle;
-  EFI_PCI_IO_PROTOCOL              *PciIo;
+typedef struct {
+  UINTN                                  Signature;
+
+  EFI_HANDLE                             ControllerHandle;
+  EFI_PCI_IO_PROTOCOL                    *PciIo;
 
-  EFI_SD_MMC_PASS_THRU_PROTOCOL    PassThru;
+  EFI_SD_MMC_PASS_THRU_PROTOCOL          PassThru;
+  EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL    CommandQueue;
 
-  UINT64                           PciAttributes;
+  UINT64                                 PciAttributes;
   //
   // The field is used to record the previous slot in GetNextSlot().
   //
-  UINT8                            PreviousSlot;
+  UINT8                                  PreviousSlot;
   //
   // For Non-blocking operation.
   //
-  EFI_EVENT                        TimerEvent;
+  EFI_EVENT                              TimerEvent;
   //
   // For Sd removable device enumeration.
   //
-  EFI_EVENT                        ConnectEvent;
-  LIST_ENTRY                       Queue;
+  EFI_EVENT                              ConnectEvent;
+  LIST_ENTRY                             Queue;
 
-  SD_MMC_HC_SLOT                   Slot[SD_MMC_HC_MAX_SLOT];
-  SD_MMC_HC_SLOT_CAP               Capability[SD_MMC_HC_MAX_SLOT];
-  UINT64                           MaxCurrent[SD_MMC_HC_MAX_SLOT];
-  UINT16                           ControllerVersion[SD_MMC_HC_MAX_SLOT];
+  SD_MMC_HC_SLOT                         Slot[SD_MMC_HC_MAX_SLOT];
+  SD_MMC_HC_SLOT_CAP                     Capability[SD_MMC_HC_MAX_SLOT];
+  UINT64                                 MaxCurrent[SD_MMC_HC_MAX_SLOT];
+  UINT16                                 ControllerVersion[SD_MMC_HC_MAX_SLOT];
 
   //
   // Some controllers may require to override base clock frequency
   // value stored in Capabilities Register 1.
   //
-  UINT32                           BaseClkFreq[SD_MMC_HC_MAX_SLOT];
+  UINT32                                 BaseClkFreq[SD_MMC_HC_MAX_SLOT];
+
+  SD_MMC_HC_CQE                          Cqe[SD_MMC_HC_MAX_SLOT];
 } SD_MMC_HC_PRIVATE_DATA;
 
 typedef struct {
@@ -136,12 +172,17 @@ typedef struct {
 //
 // TRB (Transfer Request Block) contains information for the cmd request.
 //
-typedef struct {
+struct _SD_MMC_HC_TRB {
   UINT32                                 Signature;
   LIST_ENTRY                             TrbList;
 
   UINT8                                  Slot;
   UINT16                                 BlockSize;
+  //
+  // A task of the command queue engine, started with the tag.
+  //
+  BOOLEAN                                IsTask;
+  UINT8                                  Tag;
 
   EFI_SD_MMC_PASS_THRU_COMMAND_PACKET    *Packet;
   VOID                                   *Data;
@@ -169,7 +210,7 @@ typedef struct {
   UINT32                                 AdmaPages;
 
   SD_MMC_HC_PRIVATE_DATA                 *Private;
-} SD_MMC_HC_TRB;
+};
 
 #define SD_MMC_HC_TRB_FROM_THIS(a) \
     CR(a, SD_MMC_HC_TRB, TrbList, SD_MMC_HC_TRB_SIG)
@@ -665,6 +706,8 @@ SdMmcPciHcComponentNameGetControllerName (
   @param[in] Event          If Event is NULL, blocking I/O is performed. If Event is
                             not NULL, then nonblocking I/O is performed, and Event
                             will be signaled when the Packet completes.
+  @param[in] IsTask         TRUE if the TRB is a task of the command queue engine,
+                            whose ADMA2 descriptor lines have 16-bit lengths.
 
   @return Created Trb or NULL.
 
@@ -674,7 +717,8 @@ SdMmcCreateTrb (
   IN SD_MMC_HC_PRIVATE_DATA               *Private,
   IN UINT8                                Slot,
   IN EFI_SD_MMC_PASS_THRU_COMMAND_PACKET  *Packet,
-  IN EFI_EVENT                            Event
+  IN EFI_EVENT                            Event,
+  IN BOOLEAN                              IsTask
   );
 
 /**
@@ -863,3 +907,158 @@ SdMmcHcInitHost (
   IN SD_MMC_HC_PRIVATE_DATA  *Private,
   IN UINT8                   Slot
   );
+
+/**
+  Halt the command queue engine of the slot, so that the host controller can
+  send a command or a data transfer on its own.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+
+  @retval EFI_SUCCESS       The engine is halted, or isn't enabled.
+  @retval Others            The engine can't be halted.
+
+**/
+EFI_STATUS
+SdMmcCqeHalt (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot
+  );
+
+/**
+  Start a task TRB in the command queue engine of its slot.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Trb            The pointer to the SD_MMC_HC_TRB instance of the task.
+
+  @retval EFI_SUCCESS       The task is started.
+  @retval EFI_NOT_READY     All the tags are in use.
+  @retval EFI_NOT_STARTED   The engine isn't enabled.
+  @retval Others            The engine can't be resumed.
+
+**/
+EFI_STATUS
+SdMmcCqeStartTask (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN SD_MMC_HC_TRB           *Trb
+  );
+
+/**
+  Check the tasks in the command queue engine of the slot, and mark the completed
+  ones with their result.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+
+**/
+VOID
+SdMmcCqeCheckTasks (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot
+  );
+
+/**
+  Recover the command queue engine of the slot and the eMMC device from an error,
+  discarding the tasks in them.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+  @param[in] TaskStatus     The result of the discarded tasks.
+
+**/
+VOID
+SdMmcCqeRecover (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot,
+  IN EFI_STATUS              TaskStatus
+  );
+
+/**
+  Disable the command queue engine of the slot and free its task descriptor list.
+  The tasks in the engine are completed with TaskStatus.
+
+  @param[in] Private        A pointer to the SD_MMC_HC_PRIVATE_DATA instance.
+  @param[in] Slot           The slot number of the eMMC device.
+  @param[in] TaskStatus     The result of the tasks in the engine.
+
+**/
+VOID
+SdMmcCqeStop (
+  IN SD_MMC_HC_PRIVATE_DATA  *Private,
+  IN UINT8                   Slot,
+  IN EFI_STATUS              TaskStatus
+  );
+
+/**
+  Enable the command queue engine of a slot.
+
+  @param[in]      This          A pointer to the EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL instance.
+  @param[in]      Slot          The slot number of the eMMC device.
+  @param[in]      Rca           The relative device address of the eMMC device.
+  @param[in, out] QueueDepth    On input, the number of tasks the device can queue.
+                                On output, the number of tasks the host keeps queued
+                                in the device.
+
+  @retval EFI_SUCCESS           The command queue engine is enabled.
+  @retval EFI_INVALID_PARAMETER Slot or QueueDepth is invalid.
+  @retval EFI_UNSUPPORTED       The slot has no command queue engine.
+  @retval EFI_ALREADY_STARTED   The command queue engine is already enabled.
+  @retval EFI_OUT_OF_RESOURCES  The task descriptor list can't be allocated.
+  @retval EFI_DEVICE_ERROR      The command queue engine can't be enabled.
+
+**/
+EFI_STATUS
+EFIAPI
+SdMmcCommandQueueEnable (
+  IN     EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL  *This,
+  IN     UINT8                                Slot,
+  IN     UINT16                               Rca,
+  IN OUT UINT8                                *QueueDepth
+  );
+
+/**
+  Disable the command queue engine of a slot after the queued tasks are done.
+
+  @param[in]  This              A pointer to the EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL instance.
+  @param[in]  Slot              The slot number of the eMMC device.
+
+  @retval EFI_SUCCESS           The command queue engine is disabled.
+  @retval EFI_INVALID_PARAMETER Slot is invalid.
+  @retval EFI_NOT_STARTED       The command queue engine isn't enabled.
+  @retval EFI_DEVICE_ERROR      The command queue engine can't be halted.
+
+**/
+EFI_STATUS
+EFIAPI
+SdMmcCommandQueueDisable (
+  IN EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL  *This,
+  IN UINT8                                Slot
+  );
+
+/**
+  Queue a read or write task in the eMMC device of a slot.
+
+  @param[in]      This          A pointer to the EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL instance.
+  @param[in]      Slot          The slot number of the eMMC device.
+  @param[in, out] Packet        A pointer to the command packet of the task.
+  @param[in]      Event         If Event is NULL, blocking I/O is performed. If Event is
+                                not NULL, then nonblocking I/O is performed, and Event
+                                will be signaled when the task completes.
+
+  @retval EFI_SUCCESS           The task is done if Event is NULL, or queued otherwise.
+  @retval EFI_INVALID_PARAMETER Slot or Packet is invalid.
+  @retval EFI_NOT_STARTED       The command queue engine isn't enabled.
+  @retval EFI_NO_MEDIA          The device isn't present in the slot.
+  @retval EFI_OUT_OF_RESOURCES  The task can't be queued due to lack of resources.
+  @retval EFI_DEVICE_ERROR      The task failed.
+  @retval EFI_TIMEOUT           The task didn't complete in the timeout of Packet.
+
+**/
+EFI_STATUS
+EFIAPI
+SdMmcCommandQueueQueueTask (
+  IN     EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL  *This,
+  IN     UINT8                                Slot,
+  IN OUT EFI_SD_MMC_PASS_THRU_COMMAND_PACKET  *Packet,
+  IN     EFI_EVENT                            Event    OPTIONAL
+  );
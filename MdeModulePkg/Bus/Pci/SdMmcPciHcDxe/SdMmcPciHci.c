@@ -1844,6 +1844,8 @@ SdMmcSetupMemoryForDmaTransfer (
   @param[in] Event          If Event is NULL, blocking I/O is performed. If Event is
                             not NULL, then nonblocking I/O is performed, and Event
                             will be signaled when the Packet completes.
+  @param[in] IsTask         TRUE if the TRB is a task of the command queue engine,
+                            whose ADMA2 descriptor lines have 16-bit lengths.
 
   @return Created Trb or NULL.
 
@@ -1853,7 +1855,8 @@ SdMmcCreateTrb (
   IN SD_MMC_HC_PRIVATE_DATA               *Private,
   IN UINT8                                Slot,
   IN EFI_SD_MMC_PASS_THRU_COMMAND_PACKET  *Packet,
-  IN EFI_EVENT                            Event
+  IN EFI_EVENT                            Event,
+  IN BOOLEAN                              IsTask
   )
 {
   SD_MMC_HC_TRB  *Trb;
@@ -1877,6 +1880,7 @@ SdMmcCreateTrb (
   Trb->PioModeTransferCompleted = FALSE;
   Trb->PioBlockIndex            = 0;
   Trb->Private                  = Private;
+  Trb->IsTask                   = IsTask;
 
   if ((Packet->InTransferLength != 0) && (Packet->InDataBuffer != NULL)) {
     Trb->Data    = Packet->InDataBuffer;
@@ -1921,7 +1925,7 @@ SdMmcCreateTrb (
         Trb->Mode = SdMmcAdma64bV4Mode;
       }
 
-      if (Private->ControllerVersion[Slot] >= SD_MMC_HC_CTRL_VER_410) {
+      if ((Private->ControllerVersion[Slot] >= SD_MMC_HC_CTRL_VER_410) && !IsTask) {
         Trb->AdmaLengthMode = SdMmcAdmaLen26b;
       }
 
@@ -2342,7 +2346,7 @@ SdMmcExecTrb (
 /**
   Performs SW reset based on passed error status mask.
 
-  @param[in]  Private       Pointer to driver private data.
+  @param[in]  PciIo         The PCI IO protocol instance.
   @param[in]  Slot          Index of the slot to reset.
   @param[in]  ErrIntStatus  Error interrupt status mask.
 
@@ -2351,9 +2355,9 @@ SdMmcExecTrb (
 **/
 EFI_STATUS
 SdMmcSoftwareReset (
-  IN SD_MMC_HC_PRIVATE_DATA  *Private,
-  IN UINT8                   Slot,
-  IN UINT16                  ErrIntStatus
+  IN EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN UINT8                Slot,
+  IN UINT16               ErrIntStatus
   )
 {
   UINT8       SwReset;
@@ -2369,7 +2373,7 @@ SdMmcSoftwareReset (
   }
 
   Status = SdMmcHcRwMmio (
-             Private->PciIo,
+             PciIo,
              Slot,
              SD_MMC_HC_SW_RST,
              FALSE,
@@ -2381,7 +2385,7 @@ SdMmcSoftwareReset (
   }
 
   Status = SdMmcHcWaitMmioSet (
-             Private->PciIo,
+             PciIo,
              Slot,
              SD_MMC_HC_SW_RST,
              sizeof (SwReset),
@@ -2467,7 +2471,7 @@ SdMmcCheckAndRecoverErrors (
     ErrorStatus = EFI_DEVICE_ERROR;
   }
 
-  Status = SdMmcSoftwareReset (Private, Slot, ErrIntStatus);
+  Status = SdMmcSoftwareReset (Private->PciIo, Slot, ErrIntStatus);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -372,6 +372,23 @@ SdMmcHcWaitMmioSet (
   IN  UINT64               Timeout
   );
 
+/**
+  Performs SW reset based on passed error status mask.
+
+  @param[in]  PciIo         The PCI IO protocol instance.
+  @param[in]  Slot          Index of the slot to reset.
+  @param[in]  ErrIntStatus  Error interrupt status mask.
+
+  @retval EFI_SUCCESS  Software reset performed successfully.
+  @retval Other        Software reset failed.
+**/
+EFI_STATUS
+SdMmcSoftwareReset (
+  IN EFI_PCI_IO_PROTOCOL  *PciIo,
+  IN UINT8                Slot,
+  IN UINT16               ErrIntStatus
+  );
+
 /**
   Get the controller version information from the specified slot.
 
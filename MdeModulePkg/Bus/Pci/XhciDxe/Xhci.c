@@ -86,6 +86,17 @@ EFI_USB2_HC_PROTOCOL  gXhciUsb2HcTemplate = {
   0x0
 };
 
+//
+// Template for Xhci's USB2 Host Controller Streams Protocol Instance.
+//
+EDKII_USB2_HC_STREAMS_PROTOCOL  gXhciUsb2HcStreamsTemplate = {
+  XhcAllocateStreams,
+  XhcFreeStreams,
+  XhcAsyncStreamTransfer,
+  XhcCancelStreamTransfers,
+  XhcPollStreamTransfers
+};
+
 static UINT64   mXhciPerformanceCounterStartValue;
 static UINT64   mXhciPerformanceCounterEndValue;
 static UINT64   mXhciPerformanceCounterFrequency;
@@ -205,10 +216,11 @@ XhcReset (
       }
 
       //
-      // Clean up the asynchronous transfers, currently only
-      // interrupt supports asynchronous operation.
+      // Clean up the asynchronous transfers, the interrupt and
+      // the bulk stream ones.
       //
       XhciDelAllAsyncIntTransfers (Xhc);
+      XhciDelAllAsyncBulkTransfers (Xhc);
       XhcFreeSched (Xhc);
 
       XhcInitSched (Xhc);
@@ -794,7 +806,8 @@ XhcTransfer (
           Data,
           *DataLength,
           NULL,
-          NULL
+          NULL,
+          0
           );
 
   if (Urb == NULL) {
@@ -817,8 +830,18 @@ XhcTransfer (
       ASSERT (Urb->Result == EFI_USB_NOERROR);
       Status = EFI_SUCCESS;
       DEBUG ((DEBUG_ERROR, "XhcTransfer[Type=%d]: pending URB is finished, Length = %d.\n", Type, Urb->Completed));
-    } else if (EFI_ERROR (RecoveryStatus)) {
-      DEBUG ((DEBUG_ERROR, "XhcTransfer[Type=%d]: XhcDequeueTrbFromEndpoint failed!\n", Type));
+    } else {
+      if (EFI_ERROR (RecoveryStatus)) {
+        DEBUG ((DEBUG_ERROR, "XhcTransfer[Type=%d]: XhcDequeueTrbFromEndpoint failed!\n", Type));
+      }
+
+      //
+      // The dequeue pointer is moved past the asynchronous bulk transfers
+      // queued on the same ring, finish them so their callbacks are called.
+      //
+      if (Type == XHC_BULK_TRANSFER) {
+        XhcAbortAsyncBulkRing (Xhc, Urb->Ring, EFI_USB_ERR_NOTEXECUTE);
+      }
     }
   }
 
@@ -830,6 +853,10 @@ XhcTransfer (
   //
   if ((*TransferResult == EFI_USB_ERR_STALL) || (*TransferResult == EFI_USB_ERR_BABBLE) || (*TransferResult == EDKII_USB_ERR_TRANSACTION)) {
     ASSERT (Status == EFI_DEVICE_ERROR);
+    if (Type == XHC_BULK_TRANSFER) {
+      XhcAbortAsyncBulkRing (Xhc, Urb->Ring, EFI_USB_ERR_NOTEXECUTE);
+    }
+
     RecoveryStatus = XhcRecoverHaltedEndpoint (Xhc, Urb);
     if (EFI_ERROR (RecoveryStatus)) {
       DEBUG ((DEBUG_ERROR, "XhcTransfer[Type=%d]: XhcRecoverHaltedEndpoint failed!\n", Type));
@@ -1685,6 +1712,308 @@ XhcAsyncIsochronousTransfer (
   return EFI_UNSUPPORTED;
 }
 
+/**
+  Allocate the streams of a bulk endpoint of a SuperSpeed device.
+
+  @param  This              This EDKII_USB2_HC_STREAMS_PROTOCOL instance.
+  @param  DeviceAddress     The target device address.
+  @param  EndPointAddress   The address of the bulk endpoint, with bit 7 as the direction.
+  @param  NumberOfStreams   On input, the number of streams requested. On output,
+                            the number of streams allocated.
+
+  @retval EFI_SUCCESS           The streams are allocated.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_UNSUPPORTED       The host controller or the endpoint doesn't support streams.
+  @retval EFI_ALREADY_STARTED   The streams of the endpoint are already allocated.
+  @retval EFI_OUT_OF_RESOURCES  The streams can't be allocated due to lack of resources.
+  @retval EFI_DEVICE_ERROR      The endpoint can't be reconfigured.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcAllocateStreams (
+  IN     EDKII_USB2_HC_STREAMS_PROTOCOL  *This,
+  IN     UINT8                           DeviceAddress,
+  IN     UINT8                           EndPointAddress,
+  IN OUT UINT16                          *NumberOfStreams
+  )
+{
+  USB_XHCI_INSTANCE  *Xhc;
+  UINT8              SlotId;
+  EFI_STATUS         Status;
+  EFI_TPL            OldTpl;
+
+  if ((NumberOfStreams == NULL) || (*NumberOfStreams == 0) || ((EndPointAddress & 0x0F) == 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OldTpl = gBS->RaiseTPL (XHC_TPL);
+
+  Xhc    = XHC_FROM_STREAMS_THIS (This);
+  Status = EFI_DEVICE_ERROR;
+
+  if (XhcIsHalt (Xhc) || XhcIsSysError (Xhc)) {
+    DEBUG ((DEBUG_ERROR, "XhcAllocateStreams: HC is halted\n"));
+    goto ON_EXIT;
+  }
+
+  SlotId = XhcBusDevAddrToSlotId (Xhc, DeviceAddress);
+  if (SlotId == 0) {
+    Status = EFI_INVALID_PARAMETER;
+    goto ON_EXIT;
+  }
+
+  Status = XhcAllocateEndpointStreams (Xhc, SlotId, EndPointAddress, NumberOfStreams);
+
+ON_EXIT:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Free the streams of a bulk endpoint. The pending stream transfers of the endpoint
+  are removed without calling their callbacks.
+
+  @param  This              This EDKII_USB2_HC_STREAMS_PROTOCOL instance.
+  @param  DeviceAddress     The target device address.
+  @param  EndPointAddress   The address of the bulk endpoint, with bit 7 as the direction.
+
+  @retval EFI_SUCCESS           The streams are freed.
+  @retval EFI_NOT_FOUND         The endpoint has no streams.
+  @retval EFI_DEVICE_ERROR      The endpoint can't be reconfigured.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcFreeStreams (
+  IN EDKII_USB2_HC_STREAMS_PROTOCOL  *This,
+  IN UINT8                           DeviceAddress,
+  IN UINT8                           EndPointAddress
+  )
+{
+  USB_XHCI_INSTANCE  *Xhc;
+  EFI_STATUS         Status;
+  EFI_TPL            OldTpl;
+
+  OldTpl = gBS->RaiseTPL (XHC_TPL);
+
+  Xhc    = XHC_FROM_STREAMS_THIS (This);
+  Status = XhcReleaseEndpointStreams (Xhc, DeviceAddress, EndPointAddress);
+
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Submit a bulk transfer to a stream of an endpoint and return without waiting
+  for it. The transfers of different streams are in flight at the same time.
+  On an endpoint without streams, the transfers with StreamId 0 are queued on the
+  endpoint and executed in order.
+
+  @param  This                  This EDKII_USB2_HC_STREAMS_PROTOCOL instance.
+  @param  DeviceAddress         The target device address.
+  @param  EndPointAddress       The address of the bulk endpoint, with bit 7 as the direction.
+  @param  DeviceSpeed           The device speed. It must be EFI_USB_SPEED_SUPER for
+                                a stream transfer.
+  @param  MaximumPacketLength   The maximum packet size of the endpoint.
+  @param  StreamId              The stream of the transfer, 0 if the endpoint has no streams.
+  @param  Data                  The data buffer.
+  @param  DataLength            The size of the data buffer.
+  @param  CallBackFunction      The function called when the transfer is finished.
+  @param  Context               The context of CallBackFunction.
+
+  @retval EFI_SUCCESS           The transfer is submitted.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_ALREADY_STARTED   A transfer is already pending on the stream.
+  @retval EFI_NOT_READY         The endpoint can't queue more transfers until some finish.
+  @retval EFI_OUT_OF_RESOURCES  The transfer can't be submitted due to lack of resources.
+  @retval EFI_DEVICE_ERROR      The transfer can't be submitted due to host controller error.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcAsyncStreamTransfer (
+  IN EDKII_USB2_HC_STREAMS_PROTOCOL   *This,
+  IN UINT8                            DeviceAddress,
+  IN UINT8                            EndPointAddress,
+  IN UINT8                            DeviceSpeed,
+  IN UINTN                            MaximumPacketLength,
+  IN UINT16                           StreamId,
+  IN VOID                             *Data,
+  IN UINTN                            DataLength,
+  IN EFI_ASYNC_USB_TRANSFER_CALLBACK  CallBackFunction,
+  IN VOID                             *Context OPTIONAL
+  )
+{
+  USB_XHCI_INSTANCE     *Xhc;
+  XHC_ENDPOINT_STREAMS  *Streams;
+  TRANSFER_RING         *EPRing;
+  LIST_ENTRY            *Entry;
+  URB                   *Urb;
+  UINT8                 SlotId;
+  UINT8                 Dci;
+  UINTN                 TrbNum;
+  EFI_STATUS            Status;
+  EFI_TPL               OldTpl;
+
+  //
+  // Validate the parameters
+  //
+  if ((Data == NULL) || (DataLength == 0) || (CallBackFunction == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((StreamId != 0) && ((DeviceSpeed != EFI_USB_SPEED_SUPER) || (DataLength > XHC_STREAM_TRANSFER_MAX))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((DeviceSpeed == EFI_USB_SPEED_LOW) || (MaximumPacketLength > 1024)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  OldTpl = gBS->RaiseTPL (XHC_TPL);
+
+  Xhc    = XHC_FROM_STREAMS_THIS (This);
+  Status = EFI_DEVICE_ERROR;
+
+  if (XhcIsHalt (Xhc) || XhcIsSysError (Xhc)) {
+    DEBUG ((DEBUG_ERROR, "XhcAsyncStreamTransfer: HC is halted\n"));
+    goto ON_EXIT;
+  }
+
+  SlotId = XhcBusDevAddrToSlotId (Xhc, DeviceAddress);
+  if (SlotId == 0) {
+    goto ON_EXIT;
+  }
+
+  Dci     = XhcEndpointToDci ((UINT8)(EndPointAddress & 0x0F), (UINT8)(XHCI_IS_DATAIN (EndPointAddress) ? EfiUsbDataIn : EfiUsbDataOut));
+  Streams = (XHC_ENDPOINT_STREAMS *)Xhc->UsbDevContext[SlotId].EndpointStreams[Dci - 1];
+  if (StreamId != 0) {
+    if ((Streams == NULL) || (StreamId > Streams->StreamCount)) {
+      Status = EFI_INVALID_PARAMETER;
+      goto ON_EXIT;
+    }
+
+    //
+    // The ring of a stream holds the TRBs of one transfer at a time.
+    //
+    BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+      Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+      if ((Urb->Ep.BusAddr == DeviceAddress) &&
+          (Urb->Ep.EpAddr == (EndPointAddress & 0x0F)) &&
+          (Urb->Ep.Direction == (XHCI_IS_DATAIN (EndPointAddress) ? EfiUsbDataIn : EfiUsbDataOut)) &&
+          (Urb->StreamId == StreamId))
+      {
+        Status = EFI_ALREADY_STARTED;
+        goto ON_EXIT;
+      }
+    }
+  } else {
+    EPRing = (TRANSFER_RING *)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1];
+    if ((Streams != NULL) || (EPRing == NULL)) {
+      Status = EFI_INVALID_PARAMETER;
+      goto ON_EXIT;
+    }
+
+    //
+    // The transfer is queued behind the ones in flight on the ring of the endpoint.
+    // Its TRBs, of up to 64KB each, must not reach the TRBs not yet executed.
+    //
+    TrbNum = (DataLength + SIZE_64KB - 1) / SIZE_64KB;
+    if (TrbNum > EPRing->TrbNumber - 2) {
+      Status = EFI_INVALID_PARAMETER;
+      goto ON_EXIT;
+    }
+
+    if (XhcGetQueuedTrbNumber (Xhc, EPRing) + TrbNum > EPRing->TrbNumber - 2) {
+      Status = EFI_NOT_READY;
+      goto ON_EXIT;
+    }
+  }
+
+  Urb = XhciInsertAsyncBulkTransfer (
+          Xhc,
+          DeviceAddress,
+          EndPointAddress,
+          DeviceSpeed,
+          MaximumPacketLength,
+          StreamId,
+          Data,
+          DataLength,
+          CallBackFunction,
+          Context
+          );
+  if (Urb == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_EXIT;
+  }
+
+  //
+  // Ring the doorbell
+  //
+  Status = XhcRingStreamDoorBell (Xhc, SlotId, Dci, StreamId);
+
+ON_EXIT:
+  Xhc->PciIo->Flush (Xhc->PciIo);
+  gBS->RestoreTPL (OldTpl);
+
+  return Status;
+}
+
+/**
+  Remove the pending transfers of an endpoint without calling their callbacks.
+  The endpoint is ready for new transfers when it returns.
+
+  @param  This              This EDKII_USB2_HC_STREAMS_PROTOCOL instance.
+  @param  DeviceAddress     The target device address.
+  @param  EndPointAddress   The address of the bulk endpoint, with bit 7 as the direction.
+  @param  StreamId          The stream of the transfers, 0 for all the transfers of
+                            the endpoint.
+
+  @retval EFI_SUCCESS           The pending transfers are removed.
+  @retval EFI_NOT_FOUND         No transfer is pending.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcCancelStreamTransfers (
+  IN EDKII_USB2_HC_STREAMS_PROTOCOL  *This,
+  IN UINT8                           DeviceAddress,
+  IN UINT8                           EndPointAddress,
+  IN UINT16                          StreamId
+  )
+{
+  USB_XHCI_INSTANCE  *Xhc;
+  EFI_STATUS         Status;
+  EFI_TPL            OldTpl;
+
+  OldTpl = gBS->RaiseTPL (XHC_TPL);
+
+  Xhc    = XHC_FROM_STREAMS_THIS (This);
+  Status = XhciDelAsyncBulkTransfers (Xhc, DeviceAddress, EndPointAddress, StreamId, FALSE);
+
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Check the pending transfers and call the callbacks of the finished ones.
+
+  @param  This              This EDKII_USB2_HC_STREAMS_PROTOCOL instance.
+
+  @retval EFI_SUCCESS       The pending transfers are checked.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcPollStreamTransfers (
+  IN EDKII_USB2_HC_STREAMS_PROTOCOL  *This
+  )
+{
+  XhcMonitorAsyncBulkTransfers (XHC_FROM_STREAMS_THIS (This));
+  return EFI_SUCCESS;
+}
+
 /**
   Entry point for EFI drivers.
 
@@ -1825,6 +2154,7 @@ XhcCreateUsbHc (
   Xhc->DevicePath            = DevicePath;
   Xhc->OriginalPciAttributes = OriginalPciAttributes;
   CopyMem (&Xhc->Usb2Hc, &gXhciUsb2HcTemplate, sizeof (EFI_USB2_HC_PROTOCOL));
+  CopyMem (&Xhc->Usb2HcStreams, &gXhciUsb2HcStreamsTemplate, sizeof (EDKII_USB2_HC_STREAMS_PROTOCOL));
 
   Status = PciIo->Pci.Read (
                         PciIo,
@@ -1840,6 +2170,7 @@ XhcCreateUsbHc (
   }
 
   InitializeListHead (&Xhc->AsyncIntTransfers);
+  InitializeListHead (&Xhc->AsyncBulkTransfers);
 
   //
   // Be caution that the Offset passed to XhcReadCapReg() should be Dword align
@@ -2150,11 +2481,17 @@ XhcDriverBindingStart (
     FALSE
     );
 
-  Status = gBS->InstallProtocolInterface (
+  //
+  // The queued bulk transfers are always supported. The bulk streams need a
+  // Primary Stream Array, AllocateStreams() fails when MaxPSASize is 0.
+  //
+  Status = gBS->InstallMultipleProtocolInterfaces (
                   &Controller,
                   &gEfiUsb2HcProtocolGuid,
-                  EFI_NATIVE_INTERFACE,
-                  &Xhc->Usb2Hc
+                  &Xhc->Usb2Hc,
+                  &gEdkiiUsb2HcStreamsProtocolGuid,
+                  &Xhc->Usb2HcStreams,
+                  NULL
                   );
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "XhcDriverBindingStart: failed to install USB2_HC Protocol\n"));
@@ -2238,19 +2575,22 @@ XhcDriverBindingStop (
     return Status;
   }
 
-  Status = gBS->UninstallProtocolInterface (
+  Xhc   = XHC_FROM_THIS (Usb2Hc);
+  PciIo = Xhc->PciIo;
+
+  Status = gBS->UninstallMultipleProtocolInterfaces (
                   Controller,
                   &gEfiUsb2HcProtocolGuid,
-                  Usb2Hc
+                  Usb2Hc,
+                  &gEdkiiUsb2HcStreamsProtocolGuid,
+                  &Xhc->Usb2HcStreams,
+                  NULL
                   );
 
   if (EFI_ERROR (Status)) {
     return Status;
   }
 
-  Xhc   = XHC_FROM_THIS (Usb2Hc);
-  PciIo = Xhc->PciIo;
-
   //
   // Stop AsyncRequest Polling timer then stop the XHCI driver
   // and uninstall the XHCI protocl.
@@ -2286,6 +2626,7 @@ XhcDriverBindingStop (
   XhcHaltHC (Xhc, XHC_GENERIC_TIMEOUT);
   XhcClearBiosOwnership (Xhc);
   XhciDelAllAsyncIntTransfers (Xhc);
+  XhciDelAllAsyncBulkTransfers (Xhc);
   XhcFreeSched (Xhc);
 
   if (Xhc->ControllerNameTable) {
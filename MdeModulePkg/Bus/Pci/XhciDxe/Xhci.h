@@ -14,6 +14,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Uefi.h>
 
 #include <Protocol/Usb2HostController.h>
+#include <Protocol/Usb2HcStreams.h>
 #include <Protocol/PciIo.h>
 
 #include <Guid/EventGroup.h>
@@ -82,7 +83,22 @@ typedef struct _USB_DEV_CONTEXT    USB_DEV_CONTEXT;
 #define CMD_RING_TRB_NUMBER    0x100
 #define TR_RING_TRB_NUMBER     0x100
 #define ERST_NUMBER            0x01
-#define EVENT_RING_TRB_NUMBER  0x200
+#define EVENT_RING_TRB_NUMBER  0x400
+
+//
+// The ring of a bulk endpoint holds the TRBs of several queued transfers, every
+// TRB transfers up to 64KB. A transfer generates an event per TRB, the event ring
+// is sized to hold the events of the queued transfers between two checks.
+//
+#define TR_BULK_RING_TRB_NUMBER  0x400
+
+//
+// The streams of a bulk endpoint have a small transfer ring each, holding the
+// TRBs of one transfer of up to XHC_STREAM_TRANSFER_MAX bytes at a time.
+//
+#define XHC_STREAM_RING_TRB_NUMBER  0x40
+#define XHC_STREAM_NUMBER_MAX       0xFF
+#define XHC_STREAM_TRANSFER_MAX     ((XHC_STREAM_RING_TRB_NUMBER - 2) * SIZE_64KB)
 
 #define CMD_INTER        0
 #define CTRL_INTER       1
@@ -103,10 +119,13 @@ typedef struct _USB_DEV_CONTEXT    USB_DEV_CONTEXT;
 
 #define XHCI_INSTANCE_SIG  SIGNATURE_32 ('x', 'h', 'c', 'i')
 #define XHC_FROM_THIS(a)  CR(a, USB_XHCI_INSTANCE, Usb2Hc, XHCI_INSTANCE_SIG)
+#define XHC_FROM_STREAMS_THIS(a)  CR(a, USB_XHCI_INSTANCE, Usb2HcStreams, XHCI_INSTANCE_SIG)
 
 #define USB_DESC_TYPE_HUB              0x29
 #define USB_DESC_TYPE_HUB_SUPER_SPEED  0x2a
 
+#define USB_DESC_TYPE_SS_ENDPOINT_COMPANION  0x30
+
 //
 // The RequestType in EFI_USB_DEVICE_REQUEST is composed of
 // three fields: One bit direction, 2 bit type, and 5 bit
@@ -179,6 +198,10 @@ struct _USB_DEV_CONTEXT {
   //
   VOID                         *EndpointTransferRing[31];
   //
+  // The streams of every bulk endpoint, NULL if the endpoint has no streams.
+  //
+  VOID                         *EndpointStreams[31];
+  //
   // The device descriptor which is stored to support XHCI's Evaluate_Context cmd.
   //
   EFI_USB_DEVICE_DESCRIPTOR    DevDesc;
@@ -201,65 +224,67 @@ struct _USB_DEV_CONTEXT {
 };
 
 struct _USB_XHCI_INSTANCE {
-  UINT32                      Signature;
-  EFI_PCI_IO_PROTOCOL         *PciIo;
-  UINT64                      OriginalPciAttributes;
-  USBHC_MEM_POOL              *MemPool;
+  UINT32                            Signature;
+  EFI_PCI_IO_PROTOCOL               *PciIo;
+  UINT64                            OriginalPciAttributes;
+  USBHC_MEM_POOL                    *MemPool;
 
-  EFI_USB2_HC_PROTOCOL        Usb2Hc;
+  EFI_USB2_HC_PROTOCOL              Usb2Hc;
+  EDKII_USB2_HC_STREAMS_PROTOCOL    Usb2HcStreams;
 
-  EFI_DEVICE_PATH_PROTOCOL    *DevicePath;
+  EFI_DEVICE_PATH_PROTOCOL          *DevicePath;
 
   //
   // ExitBootServicesEvent is used to set OS semaphore and
   // stop the XHC DMA operation after exit boot service.
   //
-  EFI_EVENT                   ExitBootServiceEvent;
-  EFI_EVENT                   PollTimer;
-  LIST_ENTRY                  AsyncIntTransfers;
-
-  UINT8                       CapLength;  ///< Capability Register Length
-  XHC_HCSPARAMS1              HcSParams1; ///< Structural Parameters 1
-  XHC_HCSPARAMS2              HcSParams2; ///< Structural Parameters 2
-  XHC_HCCPARAMS               HcCParams;  ///< Capability Parameters
-  UINT32                      DBOff;      ///< Doorbell Offset
-  UINT32                      RTSOff;     ///< Runtime Register Space Offset
-  UINT16                      MaxInterrupt;
-  UINT32                      PageSize;
-  UINT64                      *ScratchBuf;
-  VOID                        *ScratchMap;
-  UINT32                      MaxScratchpadBufs;
-  UINT64                      *ScratchEntry;
-  UINTN                       *ScratchEntryMap;
-  UINT32                      ExtCapRegBase;
-  UINT32                      UsbLegSupOffset;
-  UINT32                      DebugCapSupOffset;
-  UINT32                      Usb2SupOffset;
-  UINT32                      Usb3SupOffset;
-  UINT64                      *DCBAA;
-  VOID                        *DCBAAMap;
-  UINT32                      MaxSlotsEn;
-  URB                         *PendingUrb;
+  EFI_EVENT                         ExitBootServiceEvent;
+  EFI_EVENT                         PollTimer;
+  LIST_ENTRY                        AsyncIntTransfers;
+  LIST_ENTRY                        AsyncBulkTransfers;
+
+  UINT8                             CapLength;  ///< Capability Register Length
+  XHC_HCSPARAMS1                    HcSParams1; ///< Structural Parameters 1
+  XHC_HCSPARAMS2                    HcSParams2; ///< Structural Parameters 2
+  XHC_HCCPARAMS                     HcCParams;  ///< Capability Parameters
+  UINT32                            DBOff;      ///< Doorbell Offset
+  UINT32                            RTSOff;     ///< Runtime Register Space Offset
+  UINT16                            MaxInterrupt;
+  UINT32                            PageSize;
+  UINT64                            *ScratchBuf;
+  VOID                              *ScratchMap;
+  UINT32                            MaxScratchpadBufs;
+  UINT64                            *ScratchEntry;
+  UINTN                             *ScratchEntryMap;
+  UINT32                            ExtCapRegBase;
+  UINT32                            UsbLegSupOffset;
+  UINT32                            DebugCapSupOffset;
+  UINT32                            Usb2SupOffset;
+  UINT32                            Usb3SupOffset;
+  UINT64                            *DCBAA;
+  VOID                              *DCBAAMap;
+  UINT32                            MaxSlotsEn;
+  URB                               *PendingUrb;
   //
   // Cmd Transfer Ring
   //
-  TRANSFER_RING               CmdRing;
+  TRANSFER_RING                     CmdRing;
   //
   // EventRing
   //
-  EVENT_RING                  EventRing;
+  EVENT_RING                        EventRing;
   //
   // Misc
   //
-  EFI_UNICODE_STRING_TABLE    *ControllerNameTable;
+  EFI_UNICODE_STRING_TABLE          *ControllerNameTable;
 
   //
   // Store device contexts managed by XHCI instance
   // The array supports up to 255 devices, entry 0 is reserved and should not be used.
   //
-  USB_DEV_CONTEXT             UsbDevContext[256];
+  USB_DEV_CONTEXT                   UsbDevContext[256];
 
-  BOOLEAN                     Support64BitDma; // Whether 64 bit DMA may be used with this device
+  BOOLEAN                           Support64BitDma; // Whether 64 bit DMA may be used with this device
 };
 
 extern EFI_DRIVER_BINDING_PROTOCOL   gXhciDriverBinding;
@@ -727,6 +752,131 @@ XhcAsyncIsochronousTransfer (
   IN     VOID                                *Context
   );
 
+/**
+  Allocate the streams of a bulk endpoint of a SuperSpeed device.
+
+  @param  This              This EDKII_USB2_HC_STREAMS_PROTOCOL instance.
+  @param  DeviceAddress     The target device address.
+  @param  EndPointAddress   The address of the bulk endpoint, with bit 7 as the direction.
+  @param  NumberOfStreams   On input, the number of streams requested. On output,
+                            the number of streams allocated.
+
+  @retval EFI_SUCCESS           The streams are allocated.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_UNSUPPORTED       The host controller or the endpoint doesn't support streams.
+  @retval EFI_ALREADY_STARTED   The streams of the endpoint are already allocated.
+  @retval EFI_OUT_OF_RESOURCES  The streams can't be allocated due to lack of resources.
+  @retval EFI_DEVICE_ERROR      The endpoint can't be reconfigured.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcAllocateStreams (
+  IN     EDKII_USB2_HC_STREAMS_PROTOCOL  *This,
+  IN     UINT8                           DeviceAddress,
+  IN     UINT8                           EndPointAddress,
+  IN OUT UINT16                          *NumberOfStreams
+  );
+
+/**
+  Free the streams of a bulk endpoint. The pending stream transfers of the endpoint
+  are removed without calling their callbacks.
+
+  @param  This              This EDKII_USB2_HC_STREAMS_PROTOCOL instance.
+  @param  DeviceAddress     The target device address.
+  @param  EndPointAddress   The address of the bulk endpoint, with bit 7 as the direction.
+
+  @retval EFI_SUCCESS           The streams are freed.
+  @retval EFI_NOT_FOUND         The endpoint has no streams.
+  @retval EFI_DEVICE_ERROR      The endpoint can't be reconfigured.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcFreeStreams (
+  IN EDKII_USB2_HC_STREAMS_PROTOCOL  *This,
+  IN UINT8                           DeviceAddress,
+  IN UINT8                           EndPointAddress
+  );
+
+/**
+  Submit a bulk transfer to a stream of an endpoint and return without waiting
+  for it. The transfers of different streams are in flight at the same time.
+  On an endpoint without streams, the transfers with StreamId 0 are queued on the
+  endpoint and executed in order.
+
+  @param  This                  This EDKII_USB2_HC_STREAMS_PROTOCOL instance.
+  @param  DeviceAddress         The target device address.
+  @param  EndPointAddress       The address of the bulk endpoint, with bit 7 as the direction.
+  @param  DeviceSpeed           The device speed. It must be EFI_USB_SPEED_SUPER for
+                                a stream transfer.
+  @param  MaximumPacketLength   The maximum packet size of the endpoint.
+  @param  StreamId              The stream of the transfer, 0 if the endpoint has no streams.
+  @param  Data                  The data buffer.
+  @param  DataLength            The size of the data buffer.
+  @param  CallBackFunction      The function called when the transfer is finished.
+  @param  Context               The context of CallBackFunction.
+
+  @retval EFI_SUCCESS           The transfer is submitted.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_ALREADY_STARTED   A transfer is already pending on the stream.
+  @retval EFI_NOT_READY         The endpoint can't queue more transfers until some finish.
+  @retval EFI_OUT_OF_RESOURCES  The transfer can't be submitted due to lack of resources.
+  @retval EFI_DEVICE_ERROR      The transfer can't be submitted due to host controller error.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcAsyncStreamTransfer (
+  IN EDKII_USB2_HC_STREAMS_PROTOCOL   *This,
+  IN UINT8                            DeviceAddress,
+  IN UINT8                            EndPointAddress,
+  IN UINT8                            DeviceSpeed,
+  IN UINTN                            MaximumPacketLength,
+  IN UINT16                           StreamId,
+  IN VOID                             *Data,
+  IN UINTN                            DataLength,
+  IN EFI_ASYNC_USB_TRANSFER_CALLBACK  CallBackFunction,
+  IN VOID                             *Context OPTIONAL
+  );
+
+/**
+  Remove the pending transfers of an endpoint without calling their callbacks.
+  The endpoint is ready for new transfers when it returns.
+
+  @param  This              This EDKII_USB2_HC_STREAMS_PROTOCOL instance.
+  @param  DeviceAddress     The target device address.
+  @param  EndPointAddress   The address of the bulk endpoint, with bit 7 as the direction.
+  @param  StreamId          The stream of the transfers, 0 for all the transfers of
+                            the endpoint.
+
+  @retval EFI_SUCCESS           The pending transfers are removed.
+  @retval EFI_NOT_FOUND         No transfer is pending.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcCancelStreamTransfers (
+  IN EDKII_USB2_HC_STREAMS_PROTOCOL  *This,
+  IN UINT8                           DeviceAddress,
+  IN UINT8                           EndPointAddress,
+  IN UINT16                          StreamId
+  );
+
+/**
+  Check the pending transfers and call the callbacks of the finished ones.
+
+  @param  This              This EDKII_USB2_HC_STREAMS_PROTOCOL instance.
+
+  @retval EFI_SUCCESS       The pending transfers are checked.
+
+**/
+EFI_STATUS
+EFIAPI
+XhcPollStreamTransfers (
+  IN EDKII_USB2_HC_STREAMS_PROTOCOL  *This
+  );
+
 /**
   Converts a time in nanoseconds to a performance counter tick count.
 
@@ -131,6 +131,7 @@ ON_EXIT:
   @param  DataLen   The length of data buffer
   @param  Callback  The function to call when data is transferred
   @param  Context   The context to the callback
+  @param  StreamId  The stream of a bulk transfer, 0 if the endpoint has no streams
 
   @return Created URB or NULL
 
@@ -147,7 +148,8 @@ XhcCreateUrb (
   IN VOID                             *Data,
   IN UINTN                            DataLen,
   IN EFI_ASYNC_USB_TRANSFER_CALLBACK  Callback,
-  IN VOID                             *Context
+  IN VOID                             *Context,
+  IN UINT16                           StreamId
   )
 {
   USB_ENDPOINT  *Ep;
@@ -175,6 +177,7 @@ XhcCreateUrb (
   Urb->DataLen  = DataLen;
   Urb->Callback = Callback;
   Urb->Context  = Context;
+  Urb->StreamId = StreamId;
 
   Status = XhcCreateTransferTrb (Xhc, Urb);
   if (EFI_ERROR (Status)) {
@@ -230,6 +233,7 @@ XhcCreateTransferTrb (
 {
   VOID                           *OutputContext;
   TRANSFER_RING                  *EPRing;
+  XHC_ENDPOINT_STREAMS           *Streams;
   UINT8                          EPType;
   UINT8                          SlotId;
   UINT8                          Dci;
@@ -255,7 +259,27 @@ XhcCreateTransferTrb (
 
   Dci = XhcEndpointToDci (Urb->Ep.EpAddr, (UINT8)(Urb->Ep.Direction));
   ASSERT (Dci < 32);
-  EPRing = (TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1];
+  Streams = (XHC_ENDPOINT_STREAMS *)Xhc->UsbDevContext[SlotId].EndpointStreams[Dci-1];
+  if (Urb->StreamId != 0) {
+    //
+    // The TRBs of a stream transfer are put on the transfer ring of the stream.
+    //
+    if ((Streams == NULL) || (Urb->StreamId > Streams->StreamCount)) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    EPRing = &Streams->Rings[Urb->StreamId];
+  } else {
+    //
+    // An endpoint with streams has no transfer ring for the transfers without a stream.
+    //
+    if (Streams != NULL) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    EPRing = (TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1];
+  }
+
   if (EPRing == NULL) {
     return EFI_OUT_OF_RESOURCES;
   }
@@ -707,7 +731,7 @@ XhcRecoverHaltedEndpoint (
   //
   // 3)Ring the doorbell to transit from stop to active
   //
-  XhcRingDoorBell (Xhc, SlotId, Dci);
+  XhcRingStreamDoorBell (Xhc, SlotId, Dci, Urb->StreamId);
 
 Done:
   return Status;
@@ -780,7 +804,7 @@ XhcDequeueTrbFromEndpoint (
   //
   // 3)Ring the doorbell to transit from stop to active
   //
-  XhcRingDoorBell (Xhc, SlotId, Dci);
+  XhcRingStreamDoorBell (Xhc, SlotId, Dci, Urb->StreamId);
 
 Done:
   return Status;
@@ -1040,6 +1064,17 @@ IsTransferRingTrb (
   UINTN                 Index;
   EFI_PHYSICAL_ADDRESS  PhyAddr;
 
+  //
+  // Skip the TRB walk when the TRB isn't on the ring of the URB. Many URBs are
+  // checked for every event when several transfers are in flight.
+  //
+  if ((Urb->Ring == NULL) ||
+      ((UINTN)Trb < (UINTN)Urb->Ring->RingSeg0) ||
+      ((UINTN)Trb >= (UINTN)Urb->Ring->RingSeg0 + Urb->Ring->TrbNumber * sizeof (TRB_TEMPLATE)))
+  {
+    return FALSE;
+  }
+
   CheckedTrb = Urb->TrbStart;
   for (Index = 0; Index < Urb->TrbNum; Index++) {
     if (Trb == CheckedTrb) {
@@ -1096,19 +1131,54 @@ IsAsyncIntTrb (
 }
 
 /**
-  Check the URB's execution result and update the URB's
-  result accordingly.
+  Check if the Trb is a transaction of the URBs in XHCI's asynchronous bulk transfer list.
 
-  @param  Xhc             The XHCI Instance.
-  @param  Urb             The URB to check result.
+  @param Xhc    The XHCI Instance.
+  @param Trb    The TRB to be checked.
+  @param Urb    The pointer to the matched Urb.
 
-  @return Whether the result of URB transfer is finialized.
+  @retval TRUE  The Trb is matched with a transaction of the URBs in the bulk list.
+  @retval FALSE The Trb is not matched with any URBs in the bulk list.
 
 **/
 BOOLEAN
-XhcCheckUrbResult (
+IsAsyncBulkTrb (
   IN  USB_XHCI_INSTANCE  *Xhc,
-  IN  URB                *Urb
+  IN  TRB_TEMPLATE       *Trb,
+  OUT URB                **Urb
+  )
+{
+  LIST_ENTRY  *Entry;
+  URB         *CheckedUrb;
+
+  BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+    CheckedUrb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    //
+    // The ring of a finished URB may be freed already.
+    //
+    if (!CheckedUrb->Finished && IsTransferRingTrb (Xhc, Trb, CheckedUrb)) {
+      *Urb = CheckedUrb;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Handle the new events of the event ring and update the result of the URBs they
+  belong to: the pending URB, the URB checked by the caller, and the URBs of the
+  asynchronous transfer lists. The periodic check handles the events once for all
+  the asynchronous URBs, rather than walking the event ring for each of them.
+
+  @param  Xhc             The XHCI Instance.
+  @param  Urb             The URB checked by the caller, NULL if none.
+
+**/
+VOID
+XhcProcessEventRing (
+  IN  USB_XHCI_INSTANCE  *Xhc,
+  IN  URB                *Urb OPTIONAL
   )
 {
   EVT_TRB_TRANSFER      *EvtTrb;
@@ -1123,19 +1193,17 @@ XhcCheckUrbResult (
   UINT32                Low;
   EFI_PHYSICAL_ADDRESS  PhyAddr;
 
-  ASSERT ((Xhc != NULL) && (Urb != NULL));
+  ASSERT (Xhc != NULL);
 
   Status   = EFI_SUCCESS;
   AsyncUrb = NULL;
-
-  if (Urb->Finished) {
-    goto EXIT;
-  }
-
-  EvtTrb = NULL;
+  EvtTrb   = NULL;
 
   if (XhcIsHalt (Xhc) || XhcIsSysError (Xhc)) {
-    Urb->Result |= EFI_USB_ERR_SYSTEM;
+    if (Urb != NULL) {
+      Urb->Result |= EFI_USB_ERR_SYSTEM;
+    }
+
     goto EXIT;
   }
 
@@ -1173,10 +1241,12 @@ XhcCheckUrbResult (
     //
     if ((Xhc->PendingUrb != NULL) && IsTransferRingTrb (Xhc, TRBPtr, Xhc->PendingUrb)) {
       CheckedUrb = Xhc->PendingUrb;
-    } else if (IsTransferRingTrb (Xhc, TRBPtr, Urb)) {
+    } else if ((Urb != NULL) && IsTransferRingTrb (Xhc, TRBPtr, Urb)) {
       CheckedUrb = Urb;
     } else if (IsAsyncIntTrb (Xhc, TRBPtr, &AsyncUrb)) {
       CheckedUrb = AsyncUrb;
+    } else if (IsAsyncBulkTrb (Xhc, TRBPtr, &AsyncUrb)) {
+      CheckedUrb = AsyncUrb;
     } else {
       continue;
     }
@@ -1185,20 +1255,20 @@ XhcCheckUrbResult (
       case TRB_COMPLETION_STALL_ERROR:
         CheckedUrb->Result  |= EFI_USB_ERR_STALL;
         CheckedUrb->Finished = TRUE;
-        DEBUG ((DEBUG_ERROR, "XhcCheckUrbResult: STALL_ERROR! Completecode = %x\n", EvtTrb->Completecode));
-        goto EXIT;
+        DEBUG ((DEBUG_ERROR, "XhcProcessEventRing: STALL_ERROR! Completecode = %x\n", EvtTrb->Completecode));
+        break;
 
       case TRB_COMPLETION_BABBLE_ERROR:
         CheckedUrb->Result  |= EFI_USB_ERR_BABBLE;
         CheckedUrb->Finished = TRUE;
-        DEBUG ((DEBUG_ERROR, "XhcCheckUrbResult: BABBLE_ERROR! Completecode = %x\n", EvtTrb->Completecode));
-        goto EXIT;
+        DEBUG ((DEBUG_ERROR, "XhcProcessEventRing: BABBLE_ERROR! Completecode = %x\n", EvtTrb->Completecode));
+        break;
 
       case TRB_COMPLETION_DATA_BUFFER_ERROR:
         CheckedUrb->Result  |= EFI_USB_ERR_BUFFER;
         CheckedUrb->Finished = TRUE;
-        DEBUG ((DEBUG_ERROR, "XhcCheckUrbResult: ERR_BUFFER! Completecode = %x\n", EvtTrb->Completecode));
-        goto EXIT;
+        DEBUG ((DEBUG_ERROR, "XhcProcessEventRing: ERR_BUFFER! Completecode = %x\n", EvtTrb->Completecode));
+        break;
 
       //
       // Based on XHCI spec 4.8.3, software should do the reset endpoint while USB Transaction occur.
@@ -1206,8 +1276,8 @@ XhcCheckUrbResult (
       case TRB_COMPLETION_USB_TRANSACTION_ERROR:
         CheckedUrb->Result  |= EDKII_USB_ERR_TRANSACTION;
         CheckedUrb->Finished = TRUE;
-        DEBUG ((DEBUG_ERROR, "XhcCheckUrbResult: TRANSACTION_ERROR! Completecode = %x\n", EvtTrb->Completecode));
-        goto EXIT;
+        DEBUG ((DEBUG_ERROR, "XhcProcessEventRing: TRANSACTION_ERROR! Completecode = %x\n", EvtTrb->Completecode));
+        break;
 
       case TRB_COMPLETION_STOPPED:
       case TRB_COMPLETION_STOPPED_LENGTH_INVALID:
@@ -1222,7 +1292,7 @@ XhcCheckUrbResult (
       case TRB_COMPLETION_SHORT_PACKET:
       case TRB_COMPLETION_SUCCESS:
         if (EvtTrb->Completecode == TRB_COMPLETION_SHORT_PACKET) {
-          DEBUG ((DEBUG_VERBOSE, "XhcCheckUrbResult: short packet happens!\n"));
+          DEBUG ((DEBUG_VERBOSE, "XhcProcessEventRing: short packet happens!\n"));
         }
 
         TRBType = (UINT8)(TRBPtr->Type);
@@ -1239,7 +1309,19 @@ XhcCheckUrbResult (
         DEBUG ((DEBUG_ERROR, "Transfer Default Error Occur! Completecode = 0x%x!\n", EvtTrb->Completecode));
         CheckedUrb->Result  |= EFI_USB_ERR_TIMEOUT;
         CheckedUrb->Finished = TRUE;
+        break;
+    }
+
+    if (CheckedUrb->Result != EFI_USB_NOERROR) {
+      //
+      // Return the error of the URB checked by the caller at once. The errors of
+      // the other URBs are recorded, and the next events are handled.
+      //
+      if (CheckedUrb == Urb) {
         goto EXIT;
+      }
+
+      continue;
     }
 
     //
@@ -1281,6 +1363,29 @@ EXIT:
     XhcWriteRuntimeReg (Xhc, XHC_ERDP_OFFSET, XHC_LOW_32BIT (PhyAddr) | BIT3);
     XhcWriteRuntimeReg (Xhc, XHC_ERDP_OFFSET + 4, XHC_HIGH_32BIT (PhyAddr));
   }
+}
+
+/**
+  Check the URB's execution result and update the URB's
+  result accordingly.
+
+  @param  Xhc             The XHCI Instance.
+  @param  Urb             The URB to check result.
+
+  @return Whether the result of URB transfer is finialized.
+
+**/
+BOOLEAN
+XhcCheckUrbResult (
+  IN  USB_XHCI_INSTANCE  *Xhc,
+  IN  URB                *Urb
+  )
+{
+  ASSERT ((Xhc != NULL) && (Urb != NULL));
+
+  if (!Urb->Finished) {
+    XhcProcessEventRing (Xhc, Urb);
+  }
 
   return Urb->Finished;
 }
@@ -1527,7 +1632,8 @@ XhciInsertAsyncIntTransfer (
           Data,
           DataLen,
           Callback,
-          Context
+          Context,
+          0
           );
   if (Urb == NULL) {
     DEBUG ((DEBUG_ERROR, "%a: failed to create URB\n", __func__));
@@ -1541,220 +1647,1015 @@ XhciInsertAsyncIntTransfer (
   //
   InsertHeadList (&Xhc->AsyncIntTransfers, &Urb->UrbList);
 
-  return Urb;
+  return Urb;
+}
+
+/**
+  Update the queue head for next round of asynchronous transfer
+
+  @param  Xhc     The XHCI Instance.
+  @param  Urb     The URB to update
+
+**/
+VOID
+XhcUpdateAsyncRequest (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN URB                *Urb
+  )
+{
+  EFI_STATUS  Status;
+
+  if (Urb->Result == EFI_USB_NOERROR) {
+    Status = XhcCreateTransferTrb (Xhc, Urb);
+    if (EFI_ERROR (Status)) {
+      return;
+    }
+
+    Status = RingIntTransferDoorBell (Xhc, Urb);
+    if (EFI_ERROR (Status)) {
+      return;
+    }
+  }
+}
+
+/**
+  Flush data from PCI controller specific address to mapped system
+  memory address.
+
+  @param  Xhc                The XHCI device.
+  @param  Urb                The URB to unmap.
+
+  @retval EFI_SUCCESS        Success to flush data to mapped system memory.
+  @retval EFI_DEVICE_ERROR   Fail to flush data to mapped system memory.
+
+**/
+EFI_STATUS
+XhcFlushAsyncIntMap (
+  IN  USB_XHCI_INSTANCE  *Xhc,
+  IN  URB                *Urb
+  )
+{
+  EFI_STATUS                     Status;
+  EFI_PHYSICAL_ADDRESS           PhyAddr;
+  EFI_PCI_IO_PROTOCOL_OPERATION  MapOp;
+  EFI_PCI_IO_PROTOCOL            *PciIo;
+  UINTN                          Len;
+  VOID                           *Map;
+
+  PciIo = Xhc->PciIo;
+  Len   = Urb->DataLen;
+
+  if (Urb->Ep.Direction == EfiUsbDataIn) {
+    MapOp = EfiPciIoOperationBusMasterWrite;
+  } else {
+    MapOp = EfiPciIoOperationBusMasterRead;
+  }
+
+  if (Urb->DataMap != NULL) {
+    Status = PciIo->Unmap (PciIo, Urb->DataMap);
+    if (EFI_ERROR (Status)) {
+      goto ON_ERROR;
+    }
+  }
+
+  Urb->DataMap = NULL;
+
+  Status = PciIo->Map (PciIo, MapOp, Urb->Data, &Len, &PhyAddr, &Map);
+  if (EFI_ERROR (Status) || (Len != Urb->DataLen)) {
+    goto ON_ERROR;
+  }
+
+  Urb->DataPhy = (VOID *)((UINTN)PhyAddr);
+  Urb->DataMap = Map;
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  return EFI_DEVICE_ERROR;
+}
+
+/**
+  Interrupt transfer periodic check handler.
+
+  @param  Event                 Interrupt event.
+  @param  Context               Pointer to USB_XHCI_INSTANCE.
+
+**/
+VOID
+EFIAPI
+XhcMonitorAsyncRequests (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  USB_XHCI_INSTANCE  *Xhc;
+  LIST_ENTRY         *Entry;
+  LIST_ENTRY         *Next;
+  UINT8              *ProcBuf;
+  URB                *Urb;
+  UINT8              SlotId;
+  EFI_STATUS         Status;
+  EFI_TPL            OldTpl;
+
+  OldTpl = gBS->RaiseTPL (XHC_TPL);
+
+  Xhc = (USB_XHCI_INSTANCE *)Context;
+
+  //
+  // Dispatch the new events to their URBs once, then complete the finished URBs.
+  //
+  XhcProcessEventRing (Xhc, NULL);
+
+  BASE_LIST_FOR_EACH_SAFE (Entry, Next, &Xhc->AsyncIntTransfers) {
+    //
+    // Save values passed into the callback.
+    // `XhcUpdateAsyncRequest` must be called before the callback
+    // since the callback may free the URB, leading to a fault.
+    // However, the callback depends on values of the URB *before*
+    // `XhcUpdateAsyncRequest` is called, so we must save a copy.
+    //
+    UINTN   cbCompleted;
+    UINT32  cbResult;
+    VOID    *cbContext;
+
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+
+    //
+    // Make sure that the device is available before every check.
+    //
+    SlotId = XhcBusDevAddrToSlotId (Xhc, Urb->Ep.BusAddr);
+    if (SlotId == 0) {
+      continue;
+    }
+
+    //
+    // If the URB is still active, check the next one.
+    //
+    if (!Urb->Finished) {
+      continue;
+    }
+
+    //
+    // Flush any PCI posted write transactions from a PCI host
+    // bridge to system memory.
+    //
+    Status = XhcFlushAsyncIntMap (Xhc, Urb);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "XhcMonitorAsyncRequests: Fail to Flush AsyncInt Mapped Memeory\n"));
+    }
+
+    //
+    // Allocate a buffer then copy the transferred data for user.
+    // If failed to allocate the buffer, update the URB for next
+    // round of transfer. Ignore the data of this round.
+    //
+    ProcBuf = NULL;
+    if (Urb->Result == EFI_USB_NOERROR) {
+      //
+      // Make sure the data received from HW is no more than expected.
+      //
+      if (Urb->Completed <= Urb->DataLen) {
+        ProcBuf = AllocateZeroPool (Urb->Completed);
+      }
+
+      if (ProcBuf == NULL) {
+        XhcUpdateAsyncRequest (Xhc, Urb);
+        continue;
+      }
+
+      CopyMem (ProcBuf, Urb->Data, Urb->Completed);
+    }
+
+    //
+    // Store values of URB before `XhcUpdateAsyncRequest`, since the callback depends on these values.
+    //
+    cbCompleted = Urb->Completed;
+    cbResult    = Urb->Result;
+    cbContext   = Urb->Context;
+
+    //
+    // The update call must occur before the callback since the callback
+    // may remove and free the URB, leading to a fault.
+    //
+    XhcUpdateAsyncRequest (Xhc, Urb);
+
+    //
+    // Leave error recovery to its related device driver. A
+    // common case of the error recovery is to re-submit the
+    // interrupt transfer which is linked to the head of the
+    // list. This function scans from head to tail. So the
+    // re-submitted interrupt transfer's callback function
+    // will not be called again in this round. Don't touch this
+    // URB after the callback, it may have been removed by the
+    // callback.
+    //
+    if (Urb->Callback != NULL) {
+      //
+      // Restore the previous TPL. The USB bus may connect a device in its callback,
+      // and some drivers require a lower TPL to run correctly.
+      //
+      gBS->RestoreTPL (OldTpl);
+      (Urb->Callback)(ProcBuf, cbCompleted, cbContext, cbResult);
+      OldTpl = gBS->RaiseTPL (XHC_TPL);
+    }
+
+    if (ProcBuf != NULL) {
+      gBS->FreePool (ProcBuf);
+    }
+  }
+  gBS->RestoreTPL (OldTpl);
+
+  XhcMonitorAsyncBulkTransfers (Xhc);
+}
+
+/**
+  Check the asynchronous bulk transfers and call the callbacks of the finished
+  ones. The callbacks are called at the TPL of the caller.
+
+  @param  Xhc                   The XHCI Instance.
+
+**/
+VOID
+XhcMonitorAsyncBulkTransfers (
+  IN USB_XHCI_INSTANCE  *Xhc
+  )
+{
+  LIST_ENTRY                       *Entry;
+  LIST_ENTRY                       *Next;
+  LIST_ENTRY                       *Link;
+  LIST_ENTRY                       FinishedUrbs;
+  URB                              *Urb;
+  URB                              *OtherUrb;
+  UINT8                            SlotId;
+  UINT8                            Dci;
+  VOID                             *Data;
+  UINTN                            Completed;
+  UINT32                           Result;
+  EFI_ASYNC_USB_TRANSFER_CALLBACK  Callback;
+  VOID                             *Context;
+  EFI_TPL                          OldTpl;
+
+  InitializeListHead (&FinishedUrbs);
+
+  OldTpl = gBS->RaiseTPL (XHC_TPL);
+
+  XhcProcessEventRing (Xhc, NULL);
+
+  BASE_LIST_FOR_EACH_SAFE (Entry, Next, &Xhc->AsyncBulkTransfers) {
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+
+    SlotId = XhcBusDevAddrToSlotId (Xhc, Urb->Ep.BusAddr);
+    if (SlotId == 0) {
+      //
+      // The device is detached, the transfer never completes.
+      //
+      Urb->Result  |= EFI_USB_ERR_SYSTEM;
+      Urb->Finished = TRUE;
+    }
+
+    if (!Urb->Finished) {
+      continue;
+    }
+
+    RemoveEntryList (&Urb->UrbList);
+    InsertTailList (&FinishedUrbs, &Urb->UrbList);
+
+    if ((SlotId != 0) &&
+        ((Urb->Result & (EFI_USB_ERR_STALL | EFI_USB_ERR_BABBLE | EDKII_USB_ERR_TRANSACTION)) != 0))
+    {
+      //
+      // The error halts the endpoint and so the transfers of all its streams.
+      // Recover the endpoint, then restart the streams still having a transfer.
+      // The recovery moves the dequeue pointer of the ring past the transfers
+      // queued behind the failed one, they are finished without being executed.
+      //
+      XhcRecoverHaltedEndpoint (Xhc, Urb);
+      if (Urb->StreamId == 0) {
+        XhcAbortAsyncBulkRing (Xhc, Urb->Ring, EFI_USB_ERR_NOTEXECUTE);
+      }
+
+      Dci = XhcEndpointToDci (Urb->Ep.EpAddr, (UINT8)(Urb->Ep.Direction));
+      BASE_LIST_FOR_EACH (Link, &Xhc->AsyncBulkTransfers) {
+        OtherUrb = EFI_LIST_CONTAINER (Link, URB, UrbList);
+        if (!OtherUrb->Finished &&
+            (OtherUrb->Ep.BusAddr == Urb->Ep.BusAddr) &&
+            (OtherUrb->Ep.EpAddr == Urb->Ep.EpAddr) &&
+            (OtherUrb->Ep.Direction == Urb->Ep.Direction))
+        {
+          XhcRingStreamDoorBell (Xhc, SlotId, Dci, OtherUrb->StreamId);
+        }
+      }
+    }
+  }
+
+  while (!IsListEmpty (&FinishedUrbs)) {
+    Urb = EFI_LIST_CONTAINER (GetFirstNode (&FinishedUrbs), URB, UrbList);
+    RemoveEntryList (&Urb->UrbList);
+
+    Data      = Urb->Data;
+    Completed = Urb->Completed;
+    Result    = Urb->Result;
+    Callback  = Urb->Callback;
+    Context   = Urb->Context;
+
+    //
+    // Unmapping the data buffer flushes the data written by the host controller
+    // to the system memory, before the callback reads it.
+    //
+    XhcFreeUrb (Xhc, Urb);
+
+    if (Callback != NULL) {
+      gBS->RestoreTPL (OldTpl);
+      Callback (Data, Completed, Context, Result);
+      OldTpl = gBS->RaiseTPL (XHC_TPL);
+    }
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Insert a single asynchronous bulk transfer on a stream of an endpoint, or on
+  the transfer ring of an endpoint without streams, behind its queued transfers.
+
+  @param Xhc            The XHCI Instance
+  @param BusAddr        The logical device address assigned by UsbBus driver
+  @param EpAddr         Endpoint addrress
+  @param DevSpeed       The device speed
+  @param MaxPacket      The max packet length of the endpoint
+  @param StreamId       The stream of the transfer, 0 if the endpoint has no streams
+  @param Data           The user data to transfer
+  @param DataLen        The length of data buffer
+  @param Callback       The function to call when data is transferred
+  @param Context        The context to the callback
+
+  @return Created URB or NULL
+
+**/
+URB *
+XhciInsertAsyncBulkTransfer (
+  IN USB_XHCI_INSTANCE                *Xhc,
+  IN UINT8                            BusAddr,
+  IN UINT8                            EpAddr,
+  IN UINT8                            DevSpeed,
+  IN UINTN                            MaxPacket,
+  IN UINT16                           StreamId,
+  IN VOID                             *Data,
+  IN UINTN                            DataLen,
+  IN EFI_ASYNC_USB_TRANSFER_CALLBACK  Callback,
+  IN VOID                             *Context
+  )
+{
+  URB  *Urb;
+
+  Urb = XhcCreateUrb (
+          Xhc,
+          BusAddr,
+          EpAddr,
+          DevSpeed,
+          MaxPacket,
+          XHC_ASYNC_BULK_TRANSFER,
+          NULL,
+          Data,
+          DataLen,
+          Callback,
+          Context,
+          StreamId
+          );
+  if (Urb == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a: failed to create URB\n", __func__));
+    return NULL;
+  }
+
+  InsertTailList (&Xhc->AsyncBulkTransfers, &Urb->UrbList);
+
+  return Urb;
+}
+
+/**
+  Delete the asynchronous bulk transfers of the device and endpoint, without
+  calling their callbacks.
+
+  @param  Xhc                   The XHCI Instance.
+  @param  BusAddr               The logical device address assigned by UsbBus driver.
+  @param  EpNum                 The endpoint of the target.
+  @param  StreamId              The stream of the transfers, 0 for all the transfers
+                                of the endpoint.
+  @param  EndpointStopped       TRUE if the caller stopped the endpoint already.
+
+  @retval EFI_SUCCESS           The asynchronous bulk transfers are removed.
+  @retval EFI_NOT_FOUND         No asynchronous bulk transfer is pending.
+
+**/
+EFI_STATUS
+XhciDelAsyncBulkTransfers (
+  IN  USB_XHCI_INSTANCE  *Xhc,
+  IN  UINT8              BusAddr,
+  IN  UINT8              EpNum,
+  IN  UINT16             StreamId,
+  IN  BOOLEAN            EndpointStopped
+  )
+{
+  LIST_ENTRY              *Entry;
+  LIST_ENTRY              *Next;
+  URB                     *Urb;
+  EFI_USB_DATA_DIRECTION  Direction;
+  EFI_STATUS              Status;
+  UINT8                   SlotId;
+  UINT8                   Dci;
+  BOOLEAN                 Found;
+  TRANSFER_RING           *SkippedRing;
+
+  Direction = ((EpNum & 0x80) != 0) ? EfiUsbDataIn : EfiUsbDataOut;
+  EpNum    &= 0x0F;
+
+  SlotId = XhcBusDevAddrToSlotId (Xhc, BusAddr);
+  Dci    = XhcEndpointToDci (EpNum, (UINT8)Direction);
+
+  Found = FALSE;
+  BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if ((Urb->Ep.BusAddr == BusAddr) &&
+        (Urb->Ep.EpAddr == EpNum) &&
+        (Urb->Ep.Direction == Direction) &&
+        ((StreamId == 0) || (Urb->StreamId == StreamId)))
+    {
+      Found = TRUE;
+      break;
+    }
+  }
+
+  if (!Found) {
+    return EFI_NOT_FOUND;
+  }
+
+  SkippedRing = NULL;
+
+  //
+  // Stop the endpoint once, it stops the transfers of all the streams. The rings
+  // are freed already when the device is disabled or the interface is changed,
+  // and their transfers are finished then.
+  //
+  if ((SlotId != 0) &&
+      (Xhc->UsbDevContext[SlotId].EndpointStreams[Dci - 1] == NULL) &&
+      (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1] == NULL))
+  {
+    SlotId = 0;
+  }
+
+  if ((SlotId != 0) && !EndpointStopped) {
+    Status = XhcStopEndpoint (Xhc, SlotId, Dci, NULL);
+    if (EFI_ERROR (Status)) {
+      //
+      // A halted endpoint can't be stopped, reset it to the stopped state.
+      //
+      XhcResetEndpoint (Xhc, SlotId, Dci);
+    }
+  }
+
+  BASE_LIST_FOR_EACH_SAFE (Entry, Next, &Xhc->AsyncBulkTransfers) {
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if ((Urb->Ep.BusAddr != BusAddr) ||
+        (Urb->Ep.EpAddr != EpNum) ||
+        (Urb->Ep.Direction != Direction) ||
+        ((StreamId != 0) && (Urb->StreamId != StreamId)))
+    {
+      continue;
+    }
+
+    //
+    // Skip the TRBs left on the ring of the stream, or on the ring of the endpoint
+    // without streams. The queued transfers of a ring are skipped at once.
+    //
+    if ((SlotId != 0) && !Urb->Finished && (Urb->Ring != SkippedRing)) {
+      Status = XhcSetTrDequeuePointer (Xhc, SlotId, Dci, Urb);
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "XhciDelAsyncBulkTransfers: XhcSetTrDequeuePointer failed\n"));
+      }
+
+      SkippedRing = Urb->Ring;
+    }
+
+    RemoveEntryList (&Urb->UrbList);
+    XhcFreeUrb (Xhc, Urb);
+  }
+
+  //
+  // Restart the other streams of the endpoint still having a transfer.
+  //
+  if ((SlotId != 0) && (StreamId != 0)) {
+    BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+      Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+      if (!Urb->Finished &&
+          (Urb->Ep.BusAddr == BusAddr) &&
+          (Urb->Ep.EpAddr == EpNum) &&
+          (Urb->Ep.Direction == Direction))
+      {
+        XhcRingStreamDoorBell (Xhc, SlotId, Dci, Urb->StreamId);
+      }
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Remove all the asynchronous bulk transfers, without calling their callbacks.
+
+  @param  Xhc    The XHCI Instance.
+
+**/
+VOID
+XhciDelAllAsyncBulkTransfers (
+  IN USB_XHCI_INSTANCE  *Xhc
+  )
+{
+  LIST_ENTRY  *Entry;
+  LIST_ENTRY  *Next;
+  URB         *Urb;
+
+  BASE_LIST_FOR_EACH_SAFE (Entry, Next, &Xhc->AsyncBulkTransfers) {
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    RemoveEntryList (&Urb->UrbList);
+    XhcFreeUrb (Xhc, Urb);
+  }
+}
+
+/**
+  Finish the asynchronous bulk transfers still queued on a transfer ring with an
+  error. Their callbacks are called by the next check of the asynchronous bulk
+  transfers. It is used before the ring is freed or skipped.
+
+  @param  Xhc           The XHCI Instance.
+  @param  Ring          The transfer ring.
+  @param  Result        The EFI_USB_ERR_* result of the transfers.
+
+**/
+VOID
+XhcAbortAsyncBulkRing (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN TRANSFER_RING      *Ring,
+  IN UINT32             Result
+  )
+{
+  LIST_ENTRY  *Entry;
+  URB         *Urb;
+
+  BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if (!Urb->Finished && (Urb->Ring == Ring)) {
+      Urb->Result  |= Result;
+      Urb->Finished = TRUE;
+    }
+  }
+}
+
+/**
+  Count the TRBs of the asynchronous bulk transfers still queued on a transfer
+  ring. The TRBs of a new transfer must not overwrite them.
+
+  @param  Xhc           The XHCI Instance.
+  @param  Ring          The transfer ring.
+
+  @return The number of TRBs in use on the ring.
+
+**/
+UINTN
+XhcGetQueuedTrbNumber (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN TRANSFER_RING      *Ring
+  )
+{
+  LIST_ENTRY  *Entry;
+  URB         *Urb;
+  UINTN       TrbNum;
+
+  TrbNum = 0;
+  BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if (!Urb->Finished && (Urb->Ring == Ring)) {
+      TrbNum += Urb->TrbNum;
+    }
+  }
+
+  return TrbNum;
+}
+
+/**
+  Find the SuperSpeed Endpoint Companion descriptor of an endpoint of the active
+  configuration and alternate setting, and return the number of streams it supports.
+
+  @param  Xhc           The XHCI Instance.
+  @param  SlotId        The slot id of the device.
+  @param  EpAddr        The endpoint address, with bit 7 as the direction.
+
+  @return The number of streams supported by the endpoint, 0 if it has no streams.
+
+**/
+UINT32
+XhcGetEndpointMaxStreams (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN UINT8              SlotId,
+  IN UINT8              EpAddr
+  )
+{
+  EFI_USB_CONFIG_DESCRIPTOR  *ConfigDesc;
+  USB_INTERFACE_DESCRIPTOR   *IfDesc;
+  UINT8                      *Desc;
+  UINT8                      *Next;
+  UINT8                      *End;
+  UINT8                      MaxStreams;
+  BOOLEAN                    IfActive;
+  UINTN                      Index;
+
+  if ((Xhc->UsbDevContext[SlotId].ConfDesc == NULL) ||
+      (Xhc->UsbDevContext[SlotId].ActiveAlternateSetting == NULL))
+  {
+    return 0;
+  }
+
+  ConfigDesc = NULL;
+  for (Index = 0; Index < Xhc->UsbDevContext[SlotId].DevDesc.NumConfigurations; Index++) {
+    if ((Xhc->UsbDevContext[SlotId].ConfDesc[Index] != NULL) &&
+        (Xhc->UsbDevContext[SlotId].ConfDesc[Index]->ConfigurationValue == Xhc->UsbDevContext[SlotId].ActiveConfiguration))
+    {
+      ConfigDesc = Xhc->UsbDevContext[SlotId].ConfDesc[Index];
+      break;
+    }
+  }
+
+  if (ConfigDesc == NULL) {
+    return 0;
+  }
+
+  IfActive = FALSE;
+  Desc     = (UINT8 *)ConfigDesc + ConfigDesc->Length;
+  End      = (UINT8 *)ConfigDesc + ConfigDesc->TotalLength;
+  while ((Desc + 2 <= End) && (Desc[0] >= 2) && (Desc + Desc[0] <= End)) {
+    if ((Desc[1] == USB_DESC_TYPE_INTERFACE) && (Desc[0] >= sizeof (USB_INTERFACE_DESCRIPTOR))) {
+      IfDesc   = (USB_INTERFACE_DESCRIPTOR *)Desc;
+      IfActive = (BOOLEAN)((IfDesc->InterfaceNumber < ConfigDesc->NumInterfaces) &&
+                           (IfDesc->AlternateSetting == Xhc->UsbDevContext[SlotId].ActiveAlternateSetting[IfDesc->InterfaceNumber]));
+    } else if (IfActive && (Desc[1] == USB_DESC_TYPE_ENDPOINT) && (Desc[0] >= sizeof (USB_ENDPOINT_DESCRIPTOR)) &&
+               (((USB_ENDPOINT_DESCRIPTOR *)Desc)->EndpointAddress == EpAddr))
+    {
+      //
+      // USB 3.2 9.6.7 The companion descriptor follows the endpoint descriptor.
+      // Bits 4:0 of its bmAttributes field are the MaxStreams of a bulk endpoint.
+      //
+      Next = Desc + Desc[0];
+      if ((Next + 4 > End) || (Next[0] < 6) || (Next[1] != USB_DESC_TYPE_SS_ENDPOINT_COMPANION)) {
+        return 0;
+      }
+
+      MaxStreams = Next[3] & 0x1F;
+      return (MaxStreams == 0) ? 0 : (1U << MaxStreams);
+    }
+
+    Desc += Desc[0];
+  }
+
+  return 0;
+}
+
+/**
+  Configure an endpoint through XHCI's Configure_Endpoint cmd, so that its transfers
+  are addressed to its streams or to its transfer ring.
+
+  @param  Xhc           The XHCI Instance.
+  @param  SlotId        The slot id of the device.
+  @param  Dci           The device context index of the endpoint.
+  @param  Streams       The streams of the endpoint, NULL to go back to its transfer ring.
+
+  @retval EFI_SUCCESS   The endpoint is configured.
+  @retval Others        Failed to configure the endpoint.
+
+**/
+EFI_STATUS
+XhcConfigEndpointStreams (
+  IN USB_XHCI_INSTANCE     *Xhc,
+  IN UINT8                 SlotId,
+  IN UINT8                 Dci,
+  IN XHC_ENDPOINT_STREAMS  *Streams OPTIONAL
+  )
+{
+  EFI_STATUS                  Status;
+  VOID                        *InputContext;
+  VOID                        *OutputContext;
+  UINTN                       InputContextSize;
+  INPUT_CONTRL_CONTEXT        *InputControlContext;
+  ENDPOINT_CONTEXT            *EpContext;
+  TRANSFER_RING               *EPRing;
+  EFI_PHYSICAL_ADDRESS        PhyAddr;
+  CMD_TRB_CONFIG_ENDPOINT     CmdTrbCfgEP;
+  EVT_TRB_COMMAND_COMPLETION  *EvtTrb;
+
+  InputContext  = Xhc->UsbDevContext[SlotId].InputContext;
+  OutputContext = Xhc->UsbDevContext[SlotId].OutputContext;
+
+  //
+  // The input endpoint context is the output one with the new dequeue pointer.
+  // The 64-byte contexts start with the fields of the 32-byte ones.
+  //
+  if (Xhc->HcCParams.Data.Csz == 0) {
+    InputContextSize = sizeof (INPUT_CONTEXT);
+    ZeroMem (InputContext, InputContextSize);
+    CopyMem (&((INPUT_CONTEXT *)InputContext)->Slot, &((DEVICE_CONTEXT *)OutputContext)->Slot, sizeof (SLOT_CONTEXT));
+    CopyMem (&((INPUT_CONTEXT *)InputContext)->EP[Dci - 1], &((DEVICE_CONTEXT *)OutputContext)->EP[Dci - 1], sizeof (ENDPOINT_CONTEXT));
+    InputControlContext = &((INPUT_CONTEXT *)InputContext)->InputControlContext;
+    EpContext           = &((INPUT_CONTEXT *)InputContext)->EP[Dci - 1];
+  } else {
+    InputContextSize = sizeof (INPUT_CONTEXT_64);
+    ZeroMem (InputContext, InputContextSize);
+    CopyMem (&((INPUT_CONTEXT_64 *)InputContext)->Slot, &((DEVICE_CONTEXT_64 *)OutputContext)->Slot, sizeof (SLOT_CONTEXT_64));
+    CopyMem (&((INPUT_CONTEXT_64 *)InputContext)->EP[Dci - 1], &((DEVICE_CONTEXT_64 *)OutputContext)->EP[Dci - 1], sizeof (ENDPOINT_CONTEXT_64));
+    InputControlContext = (INPUT_CONTRL_CONTEXT *)&((INPUT_CONTEXT_64 *)InputContext)->InputControlContext;
+    EpContext           = (ENDPOINT_CONTEXT *)&((INPUT_CONTEXT_64 *)InputContext)->EP[Dci - 1];
+  }
+
+  EpContext->EPState = 0;
+  if (Streams != NULL) {
+    //
+    // 6.2.3 A linear Primary Stream Array has 2^(MaxPStreams+1) entries.
+    //
+    PhyAddr                = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, Streams->StreamContextArray, Streams->ArraySize * sizeof (STREAM_CONTEXT), TRUE);
+    EpContext->MaxPStreams = (UINT32)HighBitSet32 (Streams->ArraySize) - 1;
+    EpContext->LSA         = 1;
+    EpContext->PtrLo       = XHC_LOW_32BIT (PhyAddr);
+    EpContext->PtrHi       = XHC_HIGH_32BIT (PhyAddr);
+  } else {
+    EPRing                 = (TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1];
+    PhyAddr                = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, EPRing->RingEnqueue, sizeof (TRB_TEMPLATE), TRUE);
+    EpContext->MaxPStreams = 0;
+    EpContext->LSA         = 0;
+    EpContext->PtrLo       = XHC_LOW_32BIT (PhyAddr) | EPRing->RingPCS;
+    EpContext->PtrHi       = XHC_HIGH_32BIT (PhyAddr);
+  }
+
+  //
+  // XHCI 4.6.6 The Drop Context and Add Context flags of a modified endpoint are set to '1'.
+  //
+  InputControlContext->Dword1 = BIT0 << Dci;
+  InputControlContext->Dword2 = BIT0 | (BIT0 << Dci);
+
+  ZeroMem (&CmdTrbCfgEP, sizeof (CmdTrbCfgEP));
+  PhyAddr              = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, InputContext, InputContextSize, TRUE);
+  CmdTrbCfgEP.PtrLo    = XHC_LOW_32BIT (PhyAddr);
+  CmdTrbCfgEP.PtrHi    = XHC_HIGH_32BIT (PhyAddr);
+  CmdTrbCfgEP.CycleBit = 1;
+  CmdTrbCfgEP.Type     = TRB_TYPE_CON_ENDPOINT;
+  CmdTrbCfgEP.SlotId   = Xhc->UsbDevContext[SlotId].SlotId;
+  EvtTrb               = NULL;
+  Status               = XhcCmdTransfer (
+                           Xhc,
+                           (TRB_TEMPLATE *)(UINTN)&CmdTrbCfgEP,
+                           XHC_GENERIC_TIMEOUT,
+                           (TRB_TEMPLATE **)(UINTN)&EvtTrb
+                           );
+  if (EFI_ERROR (Status) || (EvtTrb == NULL)) {
+    DEBUG ((DEBUG_ERROR, "XhcConfigEndpointStreams: Config Endpoint Failed, Status = %r\n", Status));
+    if (!EFI_ERROR (Status)) {
+      Status = EFI_DEVICE_ERROR;
+    }
+  }
+
+  return Status;
 }
 
 /**
-  Update the queue head for next round of asynchronous transfer
+  Free the memory of the streams of an endpoint. The pending transfers of the
+  streams are finished with an error, their callbacks are called by the next
+  check of the asynchronous bulk transfers.
 
-  @param  Xhc     The XHCI Instance.
-  @param  Urb     The URB to update
+  @param  Xhc           The XHCI Instance.
+  @param  SlotId        The slot id of the device.
+  @param  Dci           The device context index of the endpoint.
 
 **/
 VOID
-XhcUpdateAsyncRequest (
+XhcFreeEndpointStreams (
   IN USB_XHCI_INSTANCE  *Xhc,
-  IN URB                *Urb
+  IN UINT8              SlotId,
+  IN UINT8              Dci
   )
 {
-  EFI_STATUS  Status;
+  XHC_ENDPOINT_STREAMS  *Streams;
+  LIST_ENTRY            *Entry;
+  URB                   *Urb;
+  UINTN                 StreamId;
 
-  if (Urb->Result == EFI_USB_NOERROR) {
-    Status = XhcCreateTransferTrb (Xhc, Urb);
-    if (EFI_ERROR (Status)) {
-      return;
+  Streams = (XHC_ENDPOINT_STREAMS *)Xhc->UsbDevContext[SlotId].EndpointStreams[Dci - 1];
+  if (Streams == NULL) {
+    return;
+  }
+
+  BASE_LIST_FOR_EACH (Entry, &Xhc->AsyncBulkTransfers) {
+    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+    if ((Urb->Ring >= &Streams->Rings[1]) && (Urb->Ring <= &Streams->Rings[Streams->StreamCount])) {
+      Urb->Result  |= EFI_USB_ERR_SYSTEM;
+      Urb->Finished = TRUE;
     }
+  }
 
-    Status = RingIntTransferDoorBell (Xhc, Urb);
-    if (EFI_ERROR (Status)) {
-      return;
+  for (StreamId = 1; StreamId <= Streams->StreamCount; StreamId++) {
+    if (Streams->Rings[StreamId].RingSeg0 != NULL) {
+      UsbHcFreeMem (Xhc->MemPool, Streams->Rings[StreamId].RingSeg0, sizeof (TRB_TEMPLATE) * XHC_STREAM_RING_TRB_NUMBER);
     }
   }
+
+  UsbHcFreeMem (Xhc->MemPool, Streams->StreamContextArray, Streams->ArraySize * sizeof (STREAM_CONTEXT));
+  FreePool (Streams->Rings);
+  FreePool (Streams);
+  Xhc->UsbDevContext[SlotId].EndpointStreams[Dci - 1] = NULL;
 }
 
 /**
-  Flush data from PCI controller specific address to mapped system
-  memory address.
-
-  @param  Xhc                The XHCI device.
-  @param  Urb                The URB to unmap.
+  Allocate the streams of a bulk endpoint and configure the endpoint to use them.
 
-  @retval EFI_SUCCESS        Success to flush data to mapped system memory.
-  @retval EFI_DEVICE_ERROR   Fail to flush data to mapped system memory.
+  @param  Xhc                   The XHCI Instance.
+  @param  SlotId                The slot id of the device.
+  @param  EpAddr                The endpoint address, with bit 7 as the direction.
+  @param  NumberOfStreams       On input, the number of streams requested. On output,
+                                the number of streams allocated.
+
+  @retval EFI_SUCCESS           The streams are allocated.
+  @retval EFI_INVALID_PARAMETER The endpoint isn't a configured bulk endpoint.
+  @retval EFI_UNSUPPORTED       The host controller or the endpoint doesn't support streams.
+  @retval EFI_ALREADY_STARTED   The streams of the endpoint are already allocated.
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate the streams.
+  @retval EFI_DEVICE_ERROR      Failed to configure the endpoint.
 
 **/
 EFI_STATUS
-XhcFlushAsyncIntMap (
-  IN  USB_XHCI_INSTANCE  *Xhc,
-  IN  URB                *Urb
+XhcAllocateEndpointStreams (
+  IN     USB_XHCI_INSTANCE  *Xhc,
+  IN     UINT8              SlotId,
+  IN     UINT8              EpAddr,
+  IN OUT UINT16             *NumberOfStreams
   )
 {
-  EFI_STATUS                     Status;
-  EFI_PHYSICAL_ADDRESS           PhyAddr;
-  EFI_PCI_IO_PROTOCOL_OPERATION  MapOp;
-  EFI_PCI_IO_PROTOCOL            *PciIo;
-  UINTN                          Len;
-  VOID                           *Map;
+  EFI_STATUS            Status;
+  XHC_ENDPOINT_STREAMS  *Streams;
+  UINT8                 Dci;
+  UINT8                 EPType;
+  UINT32                StreamCount;
+  UINT32                ArraySize;
+  UINT32                StreamId;
+  EFI_PHYSICAL_ADDRESS  PhyAddr;
 
-  PciIo = Xhc->PciIo;
-  Len   = Urb->DataLen;
+  Dci = XhcEndpointToDci ((UINT8)(EpAddr & 0x0F), (UINT8)(((EpAddr & 0x80) != 0) ? EfiUsbDataIn : EfiUsbDataOut));
+  ASSERT (Dci < 32);
 
-  if (Urb->Ep.Direction == EfiUsbDataIn) {
-    MapOp = EfiPciIoOperationBusMasterWrite;
-  } else {
-    MapOp = EfiPciIoOperationBusMasterRead;
+  if (Xhc->UsbDevContext[SlotId].EndpointStreams[Dci - 1] != NULL) {
+    return EFI_ALREADY_STARTED;
   }
 
-  if (Urb->DataMap != NULL) {
-    Status = PciIo->Unmap (PciIo, Urb->DataMap);
-    if (EFI_ERROR (Status)) {
-      goto ON_ERROR;
-    }
+  if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1] == NULL) {
+    return EFI_INVALID_PARAMETER;
   }
 
-  Urb->DataMap = NULL;
+  if (Xhc->HcCParams.Data.Csz == 0) {
+    EPType = (UINT8)((DEVICE_CONTEXT *)Xhc->UsbDevContext[SlotId].OutputContext)->EP[Dci - 1].EPType;
+  } else {
+    EPType = (UINT8)((DEVICE_CONTEXT_64 *)Xhc->UsbDevContext[SlotId].OutputContext)->EP[Dci - 1].EPType;
+  }
 
-  Status = PciIo->Map (PciIo, MapOp, Urb->Data, &Len, &PhyAddr, &Map);
-  if (EFI_ERROR (Status) || (Len != Urb->DataLen)) {
-    goto ON_ERROR;
+  if ((EPType != ED_BULK_IN) && (EPType != ED_BULK_OUT)) {
+    return EFI_INVALID_PARAMETER;
   }
 
-  Urb->DataPhy = (VOID *)((UINTN)PhyAddr);
-  Urb->DataMap = Map;
-  return EFI_SUCCESS;
+  //
+  // The number of streams is bounded by the endpoint, by the driver and by the
+  // Primary Stream Array size supported by the host controller, 2^(MaxPSASize+1).
+  // Entry 0 of the array is reserved, and the smallest array has 4 entries.
+  //
+  StreamCount = XhcGetEndpointMaxStreams (Xhc, SlotId, EpAddr);
+  if ((Xhc->HcCParams.Data.MaxPsaSize == 0) || (StreamCount == 0)) {
+    return EFI_UNSUPPORTED;
+  }
 
-ON_ERROR:
-  return EFI_DEVICE_ERROR;
-}
+  StreamCount = MIN (StreamCount, *NumberOfStreams);
+  StreamCount = MIN (StreamCount, XHC_STREAM_NUMBER_MAX);
 
-/**
-  Interrupt transfer periodic check handler.
+  ArraySize = 4;
+  while (ArraySize < StreamCount + 1) {
+    ArraySize <<= 1;
+  }
 
-  @param  Event                 Interrupt event.
-  @param  Context               Pointer to USB_XHCI_INSTANCE.
+  if (ArraySize > (1U << (Xhc->HcCParams.Data.MaxPsaSize + 1))) {
+    ArraySize   = 1U << (Xhc->HcCParams.Data.MaxPsaSize + 1);
+    StreamCount = ArraySize - 1;
+  }
 
-**/
-VOID
-EFIAPI
-XhcMonitorAsyncRequests (
-  IN EFI_EVENT  Event,
-  IN VOID       *Context
-  )
-{
-  USB_XHCI_INSTANCE  *Xhc;
-  LIST_ENTRY         *Entry;
-  LIST_ENTRY         *Next;
-  UINT8              *ProcBuf;
-  URB                *Urb;
-  UINT8              SlotId;
-  EFI_STATUS         Status;
-  EFI_TPL            OldTpl;
+  Streams = AllocateZeroPool (sizeof (XHC_ENDPOINT_STREAMS));
+  if (Streams == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
 
-  OldTpl = gBS->RaiseTPL (XHC_TPL);
+  Streams->StreamCount        = (UINT16)StreamCount;
+  Streams->ArraySize          = (UINT16)ArraySize;
+  Streams->Rings              = AllocateZeroPool (ArraySize * sizeof (TRANSFER_RING));
+  Streams->StreamContextArray = UsbHcAllocateMem (Xhc->MemPool, ArraySize * sizeof (STREAM_CONTEXT), TRUE);
+  if ((Streams->Rings == NULL) || (Streams->StreamContextArray == NULL)) {
+    if (Streams->Rings != NULL) {
+      FreePool (Streams->Rings);
+    }
 
-  Xhc = (USB_XHCI_INSTANCE *)Context;
+    if (Streams->StreamContextArray != NULL) {
+      UsbHcFreeMem (Xhc->MemPool, Streams->StreamContextArray, ArraySize * sizeof (STREAM_CONTEXT));
+    }
 
-  BASE_LIST_FOR_EACH_SAFE (Entry, Next, &Xhc->AsyncIntTransfers) {
-    //
-    // Save values passed into the callback.
-    // `XhcUpdateAsyncRequest` must be called before the callback
-    // since the callback may free the URB, leading to a fault.
-    // However, the callback depends on values of the URB *before*
-    // `XhcUpdateAsyncRequest` is called, so we must save a copy.
-    //
-    UINTN   cbCompleted;
-    UINT32  cbResult;
-    VOID    *cbContext;
+    FreePool (Streams);
+    return EFI_OUT_OF_RESOURCES;
+  }
 
-    Urb = EFI_LIST_CONTAINER (Entry, URB, UrbList);
+  ZeroMem (Streams->StreamContextArray, ArraySize * sizeof (STREAM_CONTEXT));
+  for (StreamId = 1; StreamId <= StreamCount; StreamId++) {
+    CreateTransferRing (Xhc, XHC_STREAM_RING_TRB_NUMBER, &Streams->Rings[StreamId]);
+    PhyAddr = UsbHcGetPciAddrForHostAddr (
+                Xhc->MemPool,
+                Streams->Rings[StreamId].RingSeg0,
+                sizeof (TRB_TEMPLATE) * XHC_STREAM_RING_TRB_NUMBER,
+                TRUE
+                );
+    Streams->StreamContextArray[StreamId].PtrLo = XHC_LOW_32BIT (PhyAddr) | (SCT_PRIMARY_TR << 1) | Streams->Rings[StreamId].RingPCS;
+    Streams->StreamContextArray[StreamId].PtrHi = XHC_HIGH_32BIT (PhyAddr);
+  }
 
-    //
-    // Make sure that the device is available before every check.
-    //
-    SlotId = XhcBusDevAddrToSlotId (Xhc, Urb->Ep.BusAddr);
-    if (SlotId == 0) {
-      continue;
-    }
+  Xhc->UsbDevContext[SlotId].EndpointStreams[Dci - 1] = Streams;
 
-    //
-    // Check the result of URB execution. If it is still
-    // active, check the next one.
-    //
-    XhcCheckUrbResult (Xhc, Urb);
+  //
+  // The endpoint may be running, stop it before changing its dequeue pointer.
+  //
+  XhcStopEndpoint (Xhc, SlotId, Dci, NULL);
+  Status = XhcConfigEndpointStreams (Xhc, SlotId, Dci, Streams);
+  if (EFI_ERROR (Status)) {
+    XhcFreeEndpointStreams (Xhc, SlotId, Dci);
+    return EFI_DEVICE_ERROR;
+  }
 
-    if (!Urb->Finished) {
-      continue;
-    }
+  DEBUG ((DEBUG_INFO, "XhcAllocateEndpointStreams: Slot = 0x%x, Dci = 0x%x, %d streams\n", SlotId, Dci, StreamCount));
 
-    //
-    // Flush any PCI posted write transactions from a PCI host
-    // bridge to system memory.
-    //
-    Status = XhcFlushAsyncIntMap (Xhc, Urb);
-    if (EFI_ERROR (Status)) {
-      DEBUG ((DEBUG_ERROR, "XhcMonitorAsyncRequests: Fail to Flush AsyncInt Mapped Memeory\n"));
-    }
+  *NumberOfStreams = (UINT16)StreamCount;
+  return EFI_SUCCESS;
+}
 
-    //
-    // Allocate a buffer then copy the transferred data for user.
-    // If failed to allocate the buffer, update the URB for next
-    // round of transfer. Ignore the data of this round.
-    //
-    ProcBuf = NULL;
-    if (Urb->Result == EFI_USB_NOERROR) {
-      //
-      // Make sure the data received from HW is no more than expected.
-      //
-      if (Urb->Completed <= Urb->DataLen) {
-        ProcBuf = AllocateZeroPool (Urb->Completed);
-      }
+/**
+  Remove the pending transfers of the streams of a bulk endpoint, configure the
+  endpoint to use its transfer ring again and free the streams.
 
-      if (ProcBuf == NULL) {
-        XhcUpdateAsyncRequest (Xhc, Urb);
-        continue;
-      }
+  @param  Xhc                   The XHCI Instance.
+  @param  BusAddr               The logical device address assigned by UsbBus driver.
+  @param  EpAddr                The endpoint address, with bit 7 as the direction.
 
-      CopyMem (ProcBuf, Urb->Data, Urb->Completed);
-    }
+  @retval EFI_SUCCESS           The streams are freed.
+  @retval EFI_NOT_FOUND         The endpoint has no streams.
+  @retval EFI_DEVICE_ERROR      Failed to configure the endpoint.
 
-    //
-    // Store values of URB before `XhcUpdateAsyncRequest`, since the callback depends on these values.
-    //
-    cbCompleted = Urb->Completed;
-    cbResult    = Urb->Result;
-    cbContext   = Urb->Context;
+**/
+EFI_STATUS
+XhcReleaseEndpointStreams (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN UINT8              BusAddr,
+  IN UINT8              EpAddr
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       SlotId;
+  UINT8       Dci;
 
-    //
-    // The update call must occur before the callback since the callback
-    // may remove and free the URB, leading to a fault.
-    //
-    XhcUpdateAsyncRequest (Xhc, Urb);
+  SlotId = XhcBusDevAddrToSlotId (Xhc, BusAddr);
+  if (SlotId == 0) {
+    return EFI_NOT_FOUND;
+  }
+
+  Dci = XhcEndpointToDci ((UINT8)(EpAddr & 0x0F), (UINT8)(((EpAddr & 0x80) != 0) ? EfiUsbDataIn : EfiUsbDataOut));
+  ASSERT (Dci < 32);
+  if (Xhc->UsbDevContext[SlotId].EndpointStreams[Dci - 1] == NULL) {
+    return EFI_NOT_FOUND;
+  }
 
+  //
+  // The endpoint must be stopped before it is dropped, whether transfers are
+  // pending on its streams or not. The pending transfers are removed from the
+  // stopped endpoint.
+  //
+  Status = XhcStopEndpoint (Xhc, SlotId, Dci, NULL);
+  if (EFI_ERROR (Status)) {
     //
-    // Leave error recovery to its related device driver. A
-    // common case of the error recovery is to re-submit the
-    // interrupt transfer which is linked to the head of the
-    // list. This function scans from head to tail. So the
-    // re-submitted interrupt transfer's callback function
-    // will not be called again in this round. Don't touch this
-    // URB after the callback, it may have been removed by the
-    // callback.
+    // A halted endpoint can't be stopped, reset it to the stopped state.
     //
-    if (Urb->Callback != NULL) {
-      //
-      // Restore the previous TPL. The USB bus may connect a device in its callback,
-      // and some drivers require a lower TPL to run correctly.
-      //
-      gBS->RestoreTPL (OldTpl);
-      (Urb->Callback)(ProcBuf, cbCompleted, cbContext, cbResult);
-      OldTpl = gBS->RaiseTPL (XHC_TPL);
-    }
+    XhcResetEndpoint (Xhc, SlotId, Dci);
+  }
 
-    if (ProcBuf != NULL) {
-      gBS->FreePool (ProcBuf);
-    }
+  XhciDelAsyncBulkTransfers (Xhc, BusAddr, EpAddr, 0, TRUE);
+
+  Status = XhcConfigEndpointStreams (Xhc, SlotId, Dci, NULL);
+  if (EFI_ERROR (Status)) {
+    return EFI_DEVICE_ERROR;
   }
-  gBS->RestoreTPL (OldTpl);
+
+  XhcFreeEndpointStreams (Xhc, SlotId, Dci);
+  return EFI_SUCCESS;
 }
 
 /**
@@ -2133,6 +3034,34 @@ XhcRingDoorBell (
   return EFI_SUCCESS;
 }
 
+/**
+  Ring the door bell to notify XHCI there is a transaction to be executed on a
+  stream of an endpoint.
+
+  @param  Xhc           The XHCI Instance.
+  @param  SlotId        The slot id of the target device.
+  @param  Dci           The device context index of the target endpoint.
+  @param  StreamId      The stream of the endpoint, 0 if the endpoint has no streams.
+
+  @retval EFI_SUCCESS   Successfully ring the door bell.
+
+**/
+EFI_STATUS
+XhcRingStreamDoorBell (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN UINT8              SlotId,
+  IN UINT8              Dci,
+  IN UINT16             StreamId
+  )
+{
+  //
+  // 5.6 Doorbell Registers, the DB Stream ID field is in bits 31:16.
+  //
+  XhcWriteDoorBellReg (Xhc, SlotId * sizeof (UINT32), Dci | ((UINT32)StreamId << 16));
+
+  return EFI_SUCCESS;
+}
+
 /**
   Ring the door bell to notify XHCI there is a transaction to be executed through URB.
 
@@ -2702,10 +3631,16 @@ XhcDisableSlotCmd (
   // Free the slot related data structure
   //
   for (Index = 0; Index < 31; Index++) {
+    XhcFreeEndpointStreams (Xhc, SlotId, (UINT8)(Index + 1));
     if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index] != NULL) {
+      XhcAbortAsyncBulkRing (Xhc, Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index], EFI_USB_ERR_SYSTEM);
       RingSeg = ((TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index])->RingSeg0;
       if (RingSeg != NULL) {
-        UsbHcFreeMem (Xhc->MemPool, RingSeg, sizeof (TRB_TEMPLATE) * TR_RING_TRB_NUMBER);
+        UsbHcFreeMem (
+          Xhc->MemPool,
+          RingSeg,
+          sizeof (TRB_TEMPLATE) * ((TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index])->TrbNumber
+          );
       }
 
       FreePool (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index]);
@@ -2815,10 +3750,16 @@ XhcDisableSlotCmd64 (
   // Free the slot related data structure
   //
   for (Index = 0; Index < 31; Index++) {
+    XhcFreeEndpointStreams (Xhc, SlotId, (UINT8)(Index + 1));
     if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index] != NULL) {
+      XhcAbortAsyncBulkRing (Xhc, Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index], EFI_USB_ERR_SYSTEM);
       RingSeg = ((TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index])->RingSeg0;
       if (RingSeg != NULL) {
-        UsbHcFreeMem (Xhc->MemPool, RingSeg, sizeof (TRB_TEMPLATE) * TR_RING_TRB_NUMBER);
+        UsbHcFreeMem (
+          Xhc->MemPool,
+          RingSeg,
+          sizeof (TRB_TEMPLATE) * ((TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index])->TrbNumber
+          );
       }
 
       FreePool (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Index]);
@@ -2994,13 +3935,13 @@ XhcInitializeEndpointContext (
         if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1] == NULL) {
           EndpointTransferRing                                   = AllocateZeroPool (sizeof (TRANSFER_RING));
           Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1] = (VOID *)EndpointTransferRing;
-          CreateTransferRing (Xhc, TR_RING_TRB_NUMBER, (TRANSFER_RING *)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1]);
+          CreateTransferRing (Xhc, TR_BULK_RING_TRB_NUMBER, (TRANSFER_RING *)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1]);
           DEBUG ((
             DEBUG_INFO,
             "Endpoint[%x]: Created BULK ring [%p~%p)\n",
             EpDesc->EndpointAddress,
             EndpointTransferRing->RingSeg0,
-            (UINTN)EndpointTransferRing->RingSeg0 + TR_RING_TRB_NUMBER * sizeof (TRB_TEMPLATE)
+            (UINTN)EndpointTransferRing->RingSeg0 + TR_BULK_RING_TRB_NUMBER * sizeof (TRB_TEMPLATE)
             ));
         }
 
@@ -3071,7 +4012,7 @@ XhcInitializeEndpointContext (
     PhyAddr = UsbHcGetPciAddrForHostAddr (
                 Xhc->MemPool,
                 ((TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1])->RingSeg0,
-                sizeof (TRB_TEMPLATE) * TR_RING_TRB_NUMBER,
+                sizeof (TRB_TEMPLATE) * ((TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1])->TrbNumber,
                 TRUE
                 );
     PhyAddr                      &= ~((EFI_PHYSICAL_ADDRESS)0x0F);
@@ -3170,13 +4111,13 @@ XhcInitializeEndpointContext64 (
         if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1] == NULL) {
           EndpointTransferRing                                   = AllocateZeroPool (sizeof (TRANSFER_RING));
           Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1] = (VOID *)EndpointTransferRing;
-          CreateTransferRing (Xhc, TR_RING_TRB_NUMBER, (TRANSFER_RING *)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1]);
+          CreateTransferRing (Xhc, TR_BULK_RING_TRB_NUMBER, (TRANSFER_RING *)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1]);
           DEBUG ((
             DEBUG_INFO,
             "Endpoint64[%x]: Created BULK ring [%p~%p)\n",
             EpDesc->EndpointAddress,
             EndpointTransferRing->RingSeg0,
-            (UINTN)EndpointTransferRing->RingSeg0 + TR_RING_TRB_NUMBER * sizeof (TRB_TEMPLATE)
+            (UINTN)EndpointTransferRing->RingSeg0 + TR_BULK_RING_TRB_NUMBER * sizeof (TRB_TEMPLATE)
             ));
         }
 
@@ -3247,7 +4188,7 @@ XhcInitializeEndpointContext64 (
     PhyAddr = UsbHcGetPciAddrForHostAddr (
                 Xhc->MemPool,
                 ((TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1])->RingSeg0,
-                sizeof (TRB_TEMPLATE) * TR_RING_TRB_NUMBER,
+                sizeof (TRB_TEMPLATE) * ((TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci-1])->TrbNumber,
                 TRUE
                 );
     PhyAddr                      &= ~((EFI_PHYSICAL_ADDRESS)0x0F);
@@ -3608,6 +4549,14 @@ XhcSetTrDequeuePointer (
   PhyAddr              = UsbHcGetPciAddrForHostAddr (Xhc->MemPool, Urb->Ring->RingEnqueue, sizeof (CMD_SET_TR_DEQ_POINTER), FALSE);
   CmdSetTRDeq.PtrLo    = XHC_LOW_32BIT (PhyAddr) | Urb->Ring->RingPCS;
   CmdSetTRDeq.PtrHi    = XHC_HIGH_32BIT (PhyAddr);
+  if (Urb->StreamId != 0) {
+    //
+    // 6.4.3.9 The dequeue pointer is the one of the primary transfer ring of the stream.
+    //
+    CmdSetTRDeq.PtrLo   |= SCT_PRIMARY_TR << 1;
+    CmdSetTRDeq.StreamID = Urb->StreamId;
+  }
+
   CmdSetTRDeq.CycleBit = 1;
   CmdSetTRDeq.Type     = TRB_TYPE_SET_TR_DEQUE;
   CmdSetTRDeq.Endpoint = Dci;
@@ -3761,10 +4710,16 @@ XhcSetInterface (
       // XHCI 4.3.6 - Setting Alternate Interfaces
       // 2) Free Transfer Rings of all endpoints that will be affected by the Alternate Interface setting.
       //
+      XhcFreeEndpointStreams (Xhc, SlotId, Dci);
       if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1] != NULL) {
+        XhcAbortAsyncBulkRing (Xhc, Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1], EFI_USB_ERR_SYSTEM);
         RingSeg = ((TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1])->RingSeg0;
         if (RingSeg != NULL) {
-          UsbHcFreeMem (Xhc->MemPool, RingSeg, sizeof (TRB_TEMPLATE) * TR_RING_TRB_NUMBER);
+          UsbHcFreeMem (
+            Xhc->MemPool,
+            RingSeg,
+            sizeof (TRB_TEMPLATE) * ((TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1])->TrbNumber
+            );
         }
 
         FreePool (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1]);
@@ -3968,10 +4923,16 @@ XhcSetInterface64 (
       // XHCI 4.3.6 - Setting Alternate Interfaces
       // 2) Free Transfer Rings of all endpoints that will be affected by the Alternate Interface setting.
       //
+      XhcFreeEndpointStreams (Xhc, SlotId, Dci);
       if (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1] != NULL) {
+        XhcAbortAsyncBulkRing (Xhc, Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1], EFI_USB_ERR_SYSTEM);
         RingSeg = ((TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1])->RingSeg0;
         if (RingSeg != NULL) {
-          UsbHcFreeMem (Xhc->MemPool, RingSeg, sizeof (TRB_TEMPLATE) * TR_RING_TRB_NUMBER);
+          UsbHcFreeMem (
+            Xhc->MemPool,
+            RingSeg,
+            sizeof (TRB_TEMPLATE) * ((TRANSFER_RING *)(UINTN)Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1])->TrbNumber
+            );
         }
 
         FreePool (Xhc->UsbDevContext[SlotId].EndpointTransferRing[Dci - 1]);
@@ -20,6 +20,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define XHC_INT_TRANSFER_SYNC        0x04
 #define XHC_INT_TRANSFER_ASYNC       0x08
 #define XHC_INT_ONLY_TRANSFER_ASYNC  0x10
+#define XHC_ASYNC_BULK_TRANSFER      0x20
 
 //
 // 6.4.6 TRB Types
@@ -180,6 +181,10 @@ typedef struct _URB {
   EFI_ASYNC_USB_TRANSFER_CALLBACK    Callback;
   VOID                               *Context;
   //
+  // The stream of a bulk transfer, 0 if the endpoint has no streams.
+  //
+  UINT16                             StreamId;
+  //
   // Execute result
   //
   UINT32                             Result;
@@ -699,6 +704,46 @@ typedef struct _ENDPOINT_CONTEXT_64 {
   UINT32    RsvdZ15;
 } ENDPOINT_CONTEXT_64;
 
+//
+// 6.2.4.1 Stream Context
+// The PtrLo field holds the Dequeue Cycle State in bit 0 and the Stream Context
+// Type in bits 3:1.
+//
+typedef struct _STREAM_CONTEXT {
+  UINT32    PtrLo;
+
+  UINT32    PtrHi;
+
+  UINT32    StoppedEDTLA : 24;
+  UINT32    RsvdZ1       : 8;
+
+  UINT32    RsvdZ2;
+} STREAM_CONTEXT;
+
+//
+// Table 6-11 Stream Context Type (SCT), Primary Transfer Ring
+//
+#define SCT_PRIMARY_TR  1
+
+//
+// The streams of a bulk endpoint, addressed through a linear Primary Stream Array.
+//
+typedef struct _XHC_ENDPOINT_STREAMS {
+  //
+  // The Stream IDs in use are from 1 to StreamCount. Stream ID 0 is reserved.
+  //
+  UINT16            StreamCount;
+  //
+  // The number of entries of the Primary Stream Array, a power of 2.
+  //
+  UINT16            ArraySize;
+  STREAM_CONTEXT    *StreamContextArray;
+  //
+  // The transfer ring of every stream, indexed by the Stream ID.
+  //
+  TRANSFER_RING     *Rings;
+} XHC_ENDPOINT_STREAMS;
+
 //
 // 6.2.5.1 Input Control Context
 //
@@ -876,6 +921,180 @@ XhciInsertAsyncIntTransfer (
   IN VOID                             *Context
   );
 
+/**
+  Insert a single asynchronous bulk transfer on a stream of an endpoint, or on
+  the transfer ring of an endpoint without streams, behind its queued transfers.
+
+  @param Xhc            The XHCI Instance
+  @param BusAddr        The logical device address assigned by UsbBus driver
+  @param EpAddr         Endpoint addrress
+  @param DevSpeed       The device speed
+  @param MaxPacket      The max packet length of the endpoint
+  @param StreamId       The stream of the transfer, 0 if the endpoint has no streams
+  @param Data           The user data to transfer
+  @param DataLen        The length of data buffer
+  @param Callback       The function to call when data is transferred
+  @param Context        The context to the callback
+
+  @return Created URB or NULL
+
+**/
+URB *
+XhciInsertAsyncBulkTransfer (
+  IN USB_XHCI_INSTANCE                *Xhc,
+  IN UINT8                            BusAddr,
+  IN UINT8                            EpAddr,
+  IN UINT8                            DevSpeed,
+  IN UINTN                            MaxPacket,
+  IN UINT16                           StreamId,
+  IN VOID                             *Data,
+  IN UINTN                            DataLen,
+  IN EFI_ASYNC_USB_TRANSFER_CALLBACK  Callback,
+  IN VOID                             *Context
+  );
+
+/**
+  Delete the asynchronous bulk transfers of the device and endpoint, without
+  calling their callbacks.
+
+  @param  Xhc                   The XHCI Instance.
+  @param  BusAddr               The logical device address assigned by UsbBus driver.
+  @param  EpNum                 The endpoint of the target.
+  @param  StreamId              The stream of the transfers, 0 for all the transfers
+                                of the endpoint.
+  @param  EndpointStopped       TRUE if the caller stopped the endpoint already.
+
+  @retval EFI_SUCCESS           The asynchronous bulk transfers are removed.
+  @retval EFI_NOT_FOUND         No asynchronous bulk transfer is pending.
+
+**/
+EFI_STATUS
+XhciDelAsyncBulkTransfers (
+  IN  USB_XHCI_INSTANCE  *Xhc,
+  IN  UINT8              BusAddr,
+  IN  UINT8              EpNum,
+  IN  UINT16             StreamId,
+  IN  BOOLEAN            EndpointStopped
+  );
+
+/**
+  Remove all the asynchronous bulk transfers, without calling their callbacks.
+
+  @param  Xhc                   The XHCI Instance.
+
+**/
+VOID
+XhciDelAllAsyncBulkTransfers (
+  IN USB_XHCI_INSTANCE  *Xhc
+  );
+
+/**
+  Check the asynchronous bulk transfers and call the callbacks of the finished
+  ones. The callbacks are called at the TPL of the caller.
+
+  @param  Xhc                   The XHCI Instance.
+
+**/
+VOID
+XhcMonitorAsyncBulkTransfers (
+  IN USB_XHCI_INSTANCE  *Xhc
+  );
+
+/**
+  Finish the asynchronous bulk transfers still queued on a transfer ring with an
+  error. Their callbacks are called by the next check of the asynchronous bulk
+  transfers. It is used before the ring is freed or skipped.
+
+  @param  Xhc           The XHCI Instance.
+  @param  Ring          The transfer ring.
+  @param  Result        The EFI_USB_ERR_* result of the transfers.
+
+**/
+VOID
+XhcAbortAsyncBulkRing (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN TRANSFER_RING      *Ring,
+  IN UINT32             Result
+  );
+
+/**
+  Count the TRBs of the asynchronous bulk transfers still queued on a transfer
+  ring. The TRBs of a new transfer must not overwrite them.
+
+  @param  Xhc           The XHCI Instance.
+  @param  Ring          The transfer ring.
+
+  @return The number of TRBs in use on the ring.
+
+**/
+UINTN
+XhcGetQueuedTrbNumber (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN TRANSFER_RING      *Ring
+  );
+
+/**
+  Allocate the streams of a bulk endpoint and configure the endpoint to use them.
+
+  @param  Xhc                   The XHCI Instance.
+  @param  SlotId                The slot id of the device.
+  @param  EpAddr                The endpoint address, with bit 7 as the direction.
+  @param  NumberOfStreams       On input, the number of streams requested. On output,
+                                the number of streams allocated.
+
+  @retval EFI_SUCCESS           The streams are allocated.
+  @retval EFI_INVALID_PARAMETER The endpoint isn't a configured bulk endpoint.
+  @retval EFI_UNSUPPORTED       The host controller or the endpoint doesn't support streams.
+  @retval EFI_ALREADY_STARTED   The streams of the endpoint are already allocated.
+  @retval EFI_OUT_OF_RESOURCES  Failed to allocate the streams.
+  @retval EFI_DEVICE_ERROR      Failed to configure the endpoint.
+
+**/
+EFI_STATUS
+XhcAllocateEndpointStreams (
+  IN     USB_XHCI_INSTANCE  *Xhc,
+  IN     UINT8              SlotId,
+  IN     UINT8              EpAddr,
+  IN OUT UINT16             *NumberOfStreams
+  );
+
+/**
+  Remove the pending transfers of the streams of a bulk endpoint, configure the
+  endpoint to use its transfer ring again and free the streams.
+
+  @param  Xhc                   The XHCI Instance.
+  @param  BusAddr               The logical device address assigned by UsbBus driver.
+  @param  EpAddr                The endpoint address, with bit 7 as the direction.
+
+  @retval EFI_SUCCESS           The streams are freed.
+  @retval EFI_NOT_FOUND         The endpoint has no streams.
+  @retval EFI_DEVICE_ERROR      Failed to configure the endpoint.
+
+**/
+EFI_STATUS
+XhcReleaseEndpointStreams (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN UINT8              BusAddr,
+  IN UINT8              EpAddr
+  );
+
+/**
+  Free the memory of the streams of an endpoint. The pending transfers of the
+  streams are finished with an error, their callbacks are called by the next
+  check of the asynchronous bulk transfers.
+
+  @param  Xhc           The XHCI Instance.
+  @param  SlotId        The slot id of the device.
+  @param  Dci           The device context index of the endpoint.
+
+**/
+VOID
+XhcFreeEndpointStreams (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN UINT8              SlotId,
+  IN UINT8              Dci
+  );
+
 /**
   Set Bios Ownership
 
@@ -947,6 +1166,26 @@ XhcRingDoorBell (
   IN UINT8              Dci
   );
 
+/**
+  Ring the door bell to notify XHCI there is a transaction to be executed on a
+  stream of an endpoint.
+
+  @param  Xhc           The XHCI Instance.
+  @param  SlotId        The slot id of the target device.
+  @param  Dci           The device context index of the target endpoint.
+  @param  StreamId      The stream of the endpoint, 0 if the endpoint has no streams.
+
+  @retval EFI_SUCCESS   Successfully ring the door bell.
+
+**/
+EFI_STATUS
+XhcRingStreamDoorBell (
+  IN USB_XHCI_INSTANCE  *Xhc,
+  IN UINT8              SlotId,
+  IN UINT8              Dci,
+  IN UINT16             StreamId
+  );
+
 /**
   Interrupt transfer periodic check handler.
 
@@ -1432,6 +1671,7 @@ XhcSetTrDequeuePointer (
   @param  DataLen   The length of data buffer
   @param  Callback  The function to call when data is transferred
   @param  Context   The context to the callback
+  @param  StreamId  The stream of a bulk transfer, 0 if the endpoint has no streams
 
   @return Created URB or NULL
 
@@ -1448,7 +1688,8 @@ XhcCreateUrb (
   IN VOID                             *Data,
   IN UINTN                            DataLen,
   IN EFI_ASYNC_USB_TRANSFER_CALLBACK  Callback,
-  IN VOID                             *Context
+  IN VOID                             *Context,
+  IN UINT16                           StreamId
   );
 
 /**
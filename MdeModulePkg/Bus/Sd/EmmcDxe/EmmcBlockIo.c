@@ -404,6 +404,102 @@ Error:
   return Status;
 }
 
+/**
+  Enable the command queue of the device, if both the device and the host controller
+  support it.
+
+  The host controller keeps up to CMDQ_DEPTH read and write tasks queued in the
+  device, which executes them in the order it prefers.
+
+  @param[in]  Device            A pointer to the EMMC_DEVICE instance.
+
+  @retval EFI_SUCCESS           The command queue is enabled.
+  @retval EFI_UNSUPPORTED       The device or the host controller has no command queue.
+  @retval Others                The command queue can't be enabled.
+
+**/
+EFI_STATUS
+EmmcEnableCommandQueue (
+  IN EMMC_DEVICE  *Device
+  )
+{
+  EFI_STATUS                           Status;
+  EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL  *CommandQueue;
+  UINT8                                QueueDepth;
+
+  CommandQueue = Device->Private->CommandQueue;
+  if ((CommandQueue == NULL) || !Device->SectorAddressing ||
+      (Device->ExtCsd.ExtCsdRev < 8) || ((Device->ExtCsd.CmdqSupport & BIT0) == 0))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (Device->CmdqEnabled) {
+    return EFI_SUCCESS;
+  }
+
+  QueueDepth = (Device->ExtCsd.CmdqDepth & 0x1F) + 1;
+  Status     = CommandQueue->EnableQueue (CommandQueue, Device->Slot, Device->Slot + 1, &QueueDepth);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = EmmcSetExtCsd (&Device->Partition[0], OFFSET_OF (EMMC_EXT_CSD, CmdqModeEn), 1, NULL, FALSE);
+  if (EFI_ERROR (Status)) {
+    CommandQueue->DisableQueue (CommandQueue, Device->Slot);
+    return Status;
+  }
+
+  Device->ExtCsd.CmdqModeEn = 1;
+  Device->CmdqEnabled       = TRUE;
+
+  DEBUG ((DEBUG_INFO, "EmmcEnableCommandQueue: slot %d queue depth %d\n", Device->Slot, QueueDepth));
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Disable the command queue of the device after the queued requests are done.
+
+  The commands not allowed in command queue mode, like the protocol read and write
+  of the security protocol, are sent after it.
+
+  @param[in]  Device            A pointer to the EMMC_DEVICE instance.
+
+  @retval EFI_SUCCESS           The command queue is disabled, or isn't enabled.
+  @retval Others                The command queue can't be disabled.
+
+**/
+EFI_STATUS
+EmmcDisableCommandQueue (
+  IN EMMC_DEVICE  *Device
+  )
+{
+  EFI_STATUS                           Status;
+  EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL  *CommandQueue;
+
+  if (!Device->CmdqEnabled) {
+    return EFI_SUCCESS;
+  }
+
+  CommandQueue = Device->Private->CommandQueue;
+  Status       = CommandQueue->DisableQueue (CommandQueue, Device->Slot);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Device->CmdqEnabled = FALSE;
+
+  Status = EmmcSetExtCsd (&Device->Partition[0], OFFSET_OF (EMMC_EXT_CSD, CmdqModeEn), 0, NULL, FALSE);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Device->ExtCsd.CmdqModeEn = 0;
+
+  return EFI_SUCCESS;
+}
+
 /**
   Set the number of blocks for a block read/write cmd through sync or async I/O request.
 
@@ -743,7 +839,16 @@ EmmcRwMultiBlocks (
     RwMultiBlkReq->Event = NULL;
   }
 
-  Status = PassThru->PassThru (PassThru, Device->Slot, &RwMultiBlkReq->Packet, RwMultiBlkReq->Event);
+  if (Device->CmdqEnabled) {
+    Status = Device->Private->CommandQueue->QueueTask (
+                                             Device->Private->CommandQueue,
+                                             Device->Slot,
+                                             &RwMultiBlkReq->Packet,
+                                             RwMultiBlkReq->Event
+                                             );
+  } else {
+    Status = PassThru->PassThru (PassThru, Device->Slot, &RwMultiBlkReq->Packet, RwMultiBlkReq->Event);
+  }
 
 Error:
   if ((Token != NULL) && (Token->Event != NULL)) {
@@ -885,7 +990,8 @@ EmmcReadWrite (
   }
 
   //
-  // Start to execute data transfer. The max block number in single cmd is 65535 blocks.
+  // Start to execute data transfer. The max block number in single cmd is 65535 blocks,
+  // the limit of both the SET_BLOCK_COUNT cmd and the block count of a command queue task.
   //
   Remaining = BlockNum;
   MaxBlock  = 0xFFFF;
@@ -898,9 +1004,14 @@ EmmcReadWrite (
       BlockNum = MaxBlock;
     }
 
-    Status = EmmcSetBlkCount (Partition, (UINT16)BlockNum, Token, FALSE);
-    if (EFI_ERROR (Status)) {
-      return Status;
+    //
+    // A command queue task carries its block count.
+    //
+    if (!Device->CmdqEnabled) {
+      Status = EmmcSetBlkCount (Partition, (UINT16)BlockNum, Token, FALSE);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
     }
 
     BufferSize = BlockNum * BlockSize;
@@ -1368,6 +1479,15 @@ EmmcSecurityProtocolInOut (
   while (!IsListEmpty (&Partition->Queue)) {
   }
 
+  //
+  // The protocol read and write cmds aren't allowed in command queue mode, which
+  // stays disabled afterwards.
+  //
+  Status = EmmcDisableCommandQueue (Device);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
   //
   // Check if needs to switch partition access.
   //
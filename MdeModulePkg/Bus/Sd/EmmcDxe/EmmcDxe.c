@@ -632,6 +632,11 @@ DiscoverEmmcDevice (
       goto Error;
     }
 
+    //
+    // The device works without command queue if it can't be enabled.
+    //
+    EmmcEnableCommandQueue (Device);
+
     Status = gBS->InstallProtocolInterface (
                     &Device->Handle,
                     &gEfiDevicePathProtocolGuid,
@@ -901,6 +906,21 @@ EmmcDxeDriverBindingStart (
     Private->ParentDevicePath    = ParentDevicePath;
     Private->DriverBindingHandle = This->DriverBindingHandle;
 
+    //
+    // The host controller may queue the read and write requests in the devices.
+    //
+    Status = gBS->OpenProtocol (
+                    Controller,
+                    &gEdkiiSdMmcCommandQueueProtocolGuid,
+                    (VOID **)&Private->CommandQueue,
+                    This->DriverBindingHandle,
+                    Controller,
+                    EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                    );
+    if (EFI_ERROR (Status)) {
+      Private->CommandQueue = NULL;
+    }
+
     Status = gBS->InstallProtocolInterface (
                     &Controller,
                     &gEfiCallerIdGuid,
@@ -1037,6 +1057,8 @@ EmmcDxeDriverBindingStop (
 
     for (Index = 0; Index < EMMC_MAX_DEVICES; Index++) {
       Device = &Private->Device[Index];
+      EmmcDisableCommandQueue (Device);
+
       Status = gBS->OpenProtocol (
                       Device->Handle,
                       &gEfiDevicePathProtocolGuid,
@@ -15,6 +15,7 @@
 #include <IndustryStandard/Emmc.h>
 
 #include <Protocol/SdMmcPassThru.h>
+#include <Protocol/SdMmcCommandQueue.h>
 #include <Protocol/BlockIo.h>
 #include <Protocol/BlockIo2.h>
 #include <Protocol/StorageSecurityCommand.h>
@@ -138,18 +139,26 @@ struct _EMMC_DEVICE {
   //
   CHAR16                      ModelName[EMMC_MODEL_NAME_MAX_LEN];
   EMMC_DRIVER_PRIVATE_DATA    *Private;
+  //
+  // The read and write requests are queued in the device as command queue tasks.
+  //
+  BOOLEAN                     CmdqEnabled;
 };
 
 //
 // EMMC DXE driver private data structure
 //
 struct _EMMC_DRIVER_PRIVATE_DATA {
-  EFI_SD_MMC_PASS_THRU_PROTOCOL    *PassThru;
-  EFI_HANDLE                       Controller;
-  EFI_DEVICE_PATH_PROTOCOL         *ParentDevicePath;
-  EFI_HANDLE                       DriverBindingHandle;
+  EFI_SD_MMC_PASS_THRU_PROTOCOL          *PassThru;
+  //
+  // The command queue protocol of the host controller, NULL if it isn't installed.
+  //
+  EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL    *CommandQueue;
+  EFI_HANDLE                             Controller;
+  EFI_DEVICE_PATH_PROTOCOL               *ParentDevicePath;
+  EFI_HANDLE                             DriverBindingHandle;
 
-  EMMC_DEVICE                      Device[EMMC_MAX_DEVICES];
+  EMMC_DEVICE                            Device[EMMC_MAX_DEVICES];
 };
 
 /**
@@ -495,3 +504,33 @@ EmmcGetExtCsd (
   IN     EMMC_DEVICE  *Device,
   OUT EMMC_EXT_CSD    *ExtCsd
   );
+
+/**
+  Enable the command queue of the device, if both the device and the host controller
+  support it.
+
+  @param[in]  Device            A pointer to the EMMC_DEVICE instance.
+
+  @retval EFI_SUCCESS           The command queue is enabled.
+  @retval EFI_UNSUPPORTED       The device or the host controller has no command queue.
+  @retval Others                The command queue can't be enabled.
+
+**/
+EFI_STATUS
+EmmcEnableCommandQueue (
+  IN EMMC_DEVICE  *Device
+  );
+
+/**
+  Disable the command queue of the device after the queued requests are done.
+
+  @param[in]  Device            A pointer to the EMMC_DEVICE instance.
+
+  @retval EFI_SUCCESS           The command queue is disabled, or isn't enabled.
+  @retval Others                The command queue can't be disabled.
+
+**/
+EFI_STATUS
+EmmcDisableCommandQueue (
+  IN EMMC_DEVICE  *Device
+  );
@@ -67,7 +67,14 @@ UFS_PASS_THRU_PRIVATE_DATA  gUfsPassThruTemplate = {
   {                               // Queue
     NULL,
     NULL
-  }
+  },
+  {                               // WaitQueue
+    NULL,
+    NULL
+  },
+  NULL,                                                                                                                                   // DoorbellEvent
+  0,                                                                                                                                      // SlotsInUse
+  0                                                                                                                                       // PendingDoorbell
 };
 
 EFI_DRIVER_BINDING_PROTOCOL  gUfsPassThruDriverBinding = {
@@ -890,6 +897,7 @@ UfsPassThruDriverBindingStart (
   Private->UfsHcDriverInterface.UfsHcProtocol     = UfsHc;
   Private->UfsHcDriverInterface.UfsExecUicCommand = UfsHcDriverInterfaceExecUicCommand;
   InitializeListHead (&Private->Queue);
+  InitializeListHead (&Private->WaitQueue);
 
   //
   // This has to be done before initializing UfsHcInfo or calling the UfsControllerInit
@@ -1037,6 +1045,18 @@ UfsPassThruDriverBindingStart (
     goto Error;
   }
 
+  Status = gBS->CreateEvent (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  UfsRingPendingDoorbell,
+                  Private,
+                  &Private->DoorbellEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Ufs Create Doorbell Event Error, Status = %r\n", Status));
+    goto Error;
+  }
+
   Status = gBS->InstallMultipleProtocolInterfaces (
                   &Controller,
                   &gEfiExtScsiPassThruProtocolGuid,
@@ -1071,6 +1091,10 @@ Error:
       gBS->CloseEvent (Private->TimerEvent);
     }
 
+    if (Private->DoorbellEvent != NULL) {
+      gBS->CloseEvent (Private->DoorbellEvent);
+    }
+
     FreePool (Private);
   }
 
@@ -1165,6 +1189,17 @@ UfsPassThruDriverBindingStop (
     }
   }
 
+  if (!IsListEmpty (&Private->WaitQueue)) {
+    BASE_LIST_FOR_EACH_SAFE (Entry, NextEntry, &Private->WaitQueue) {
+      TransReq = UFS_PASS_THRU_TRANS_REQ_FROM_THIS (Entry);
+
+      TransReq->Packet->HostAdapterStatus =
+        EFI_EXT_SCSI_STATUS_HOST_ADAPTER_PHASE_ERROR;
+
+      SignalCallerEvent (Private, TransReq);
+    }
+  }
+
   Status = gBS->UninstallMultipleProtocolInterfaces (
                   Controller,
                   &gEfiExtScsiPassThruProtocolGuid,
@@ -1204,6 +1239,10 @@ UfsPassThruDriverBindingStop (
     gBS->CloseEvent (Private->TimerEvent);
   }
 
+  if (Private->DoorbellEvent != NULL) {
+    gBS->CloseEvent (Private->DoorbellEvent);
+  }
+
   FreePool (Private);
 
   //
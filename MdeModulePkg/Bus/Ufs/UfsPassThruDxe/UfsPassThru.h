@@ -75,6 +75,24 @@ typedef struct _UFS_PASS_THRU_PRIVATE_DATA {
   //
   EFI_EVENT                             TimerEvent;
   LIST_ENTRY                            Queue;
+  //
+  // The non-blocking requests waiting for a free slot of the transfer list.
+  //
+  LIST_ENTRY                            WaitQueue;
+  //
+  // Rings the doorbell of the slots filled since the last ring at once.
+  //
+  EFI_EVENT                             DoorbellEvent;
+  //
+  // The slots owned by a request, from the time they are filled until the
+  // request is completed. The doorbell register alone can't tell a free slot
+  // from a slot whose completion isn't processed yet.
+  //
+  UINT32                                SlotsInUse;
+  //
+  // The slots filled whose doorbell isn't rung yet.
+  //
+  UINT32                                PendingDoorbell;
 } UFS_PASS_THRU_PRIVATE_DATA;
 
 #define UFS_PASS_THRU_TRANS_REQ_SIG  SIGNATURE_32 ('U', 'F', 'S', 'T')
@@ -83,6 +101,7 @@ typedef struct {
   UINT32                                        Signature;
   LIST_ENTRY                                    TransferList;
 
+  UINT8                                         Lun;
   UINT8                                         Slot;
   UTP_TRD                                       *Trd;
   UINT32                                        CmdDescSize;
@@ -623,6 +642,9 @@ UfsPassThruGetNextTarget (
 /**
   Sends a UFS-supported SCSI Request Packet to a UFS device that is attached to the UFS host controller.
 
+  The nonblocking requests are kept in flight on all the slots of the transfer list. When no slot is
+  free, they wait in order for the completion of an earlier request.
+
   @param[in]      Private       The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
   @param[in]      Lun           The LUN of the UFS device to send the SCSI Request Packet.
   @param[in, out] Packet        A pointer to the SCSI Request Packet to send to a specified Lun of the
@@ -846,6 +868,25 @@ ProcessAsyncTaskList (
   IN VOID       *Context
   );
 
+/**
+  Ring the doorbell of the slots filled by the non-blocking requests since the
+  last ring, with a single write of the doorbell register.
+
+  The doorbell event is signaled by every non-blocking request. Its notify
+  function runs once the caller drops below TPL_CALLBACK, so that the requests
+  issued back to back by the caller are started together.
+
+  @param[in]  Event     The Event this notify function registered to.
+  @param[in]  Context   Pointer to the context data registered to the Event.
+
+**/
+VOID
+EFIAPI
+UfsRingPendingDoorbell (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  );
+
 /**
   Internal helper function which will signal the caller event and clean up
   resources.
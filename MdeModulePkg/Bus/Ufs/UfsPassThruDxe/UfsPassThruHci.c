@@ -708,7 +708,10 @@ UfsCreateNopCommandDesc (
 }
 
 /**
-  Find out available slot in transfer list of a UFS device.
+  Find out available slot in transfer list of a UFS device, and reserve it.
+
+  The slot stays reserved until it is released by UfsReleaseSlotInTrl(), so that
+  a slot whose request isn't completed yet is never given to another request.
 
   @param[in]  Private       The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
   @param[out] Slot          The available slot.
@@ -727,38 +730,69 @@ UfsFindAvailableSlotInTrl (
   UINT8       Index;
   UINT32      Data;
   EFI_STATUS  Status;
+  EFI_TPL     OldTpl;
 
   ASSERT ((Private != NULL) && (Slot != NULL));
 
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
   Status = UfsMmioRead32 (Private, UFS_HC_UTRLDBR_OFFSET, &Data);
   if (EFI_ERROR (Status)) {
+    gBS->RestoreTPL (OldTpl);
     return Status;
   }
 
-  Nutrs = (UINT8)((Private->UfsHcInfo.Capabilities & UFS_HC_CAP_NUTRS) + 1);
+  Data  |= Private->SlotsInUse;
+  Nutrs  = (UINT8)((Private->UfsHcInfo.Capabilities & UFS_HC_CAP_NUTRS) + 1);
+  Status = EFI_NOT_READY;
 
   for (Index = 0; Index < Nutrs; Index++) {
     if ((Data & (BIT0 << Index)) == 0) {
-      *Slot = Index;
-      return EFI_SUCCESS;
+      Private->SlotsInUse |= BIT0 << Index;
+      *Slot                = Index;
+      Status               = EFI_SUCCESS;
+      break;
     }
   }
 
-  return EFI_NOT_READY;
+  gBS->RestoreTPL (OldTpl);
+  return Status;
 }
 
 /**
-  Start specified slot in transfer list of a UFS device.
+  Release a slot reserved by UfsFindAvailableSlotInTrl().
 
   @param[in]  Private       The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
-  @param[in]  Slot          The slot to be started.
+  @param[in]  Slot          The slot to be released.
 
 **/
-EFI_STATUS
-UfsStartExecCmd (
+VOID
+UfsReleaseSlotInTrl (
   IN  UFS_PASS_THRU_PRIVATE_DATA  *Private,
   IN  UINT8                       Slot
   )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl                    = gBS->RaiseTPL (TPL_NOTIFY);
+  Private->SlotsInUse      &= ~(BIT0 << Slot);
+  Private->PendingDoorbell &= ~(BIT0 << Slot);
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Start specified slots in transfer list of a UFS device with a single write of
+  the doorbell register.
+
+  @param[in]  Private       The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
+  @param[in]  SlotsMap      The bit map of the slots to be started.
+
+**/
+EFI_STATUS
+UfsStartExecCmds (
+  IN  UFS_PASS_THRU_PRIVATE_DATA  *Private,
+  IN  UINT32                      SlotsMap
+  )
 {
   UINT32      Data;
   EFI_STATUS  Status;
@@ -775,7 +809,7 @@ UfsStartExecCmd (
     }
   }
 
-  Status = UfsMmioWrite32 (Private, UFS_HC_UTRLDBR_OFFSET, BIT0 << Slot);
+  Status = UfsMmioWrite32 (Private, UFS_HC_UTRLDBR_OFFSET, SlotsMap);
   if (EFI_ERROR (Status)) {
     return Status;
   }
@@ -783,6 +817,22 @@ UfsStartExecCmd (
   return EFI_SUCCESS;
 }
 
+/**
+  Start specified slot in transfer list of a UFS device.
+
+  @param[in]  Private       The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
+  @param[in]  Slot          The slot to be started.
+
+**/
+EFI_STATUS
+UfsStartExecCmd (
+  IN  UFS_PASS_THRU_PRIVATE_DATA  *Private,
+  IN  UINT8                       Slot
+  )
+{
+  return UfsStartExecCmds (Private, BIT0 << Slot);
+}
+
 /**
   Stop specified slot in transfer list of a UFS device.
 
@@ -927,6 +977,7 @@ UfsSendDmRequestRetry (
   Status = UfsCreateDMCommandDesc (Private, Packet, Trd, &CmdDescHost, &CmdDescMapping);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "Failed to create DM command descriptor\n"));
+    UfsReleaseSlotInTrl (Private, Slot);
     return Status;
   }
 
@@ -943,7 +994,7 @@ UfsSendDmRequestRetry (
   //
   // Wait for the completion of the transfer request.
   //
-  Status = UfsWaitMemSet (Private, UFS_HC_UTRLDBR_OFFSET, BIT0, 0, Packet->Timeout);
+  Status = UfsWaitMemSet (Private, UFS_HC_UTRLDBR_OFFSET, BIT0 << Slot, 0, Packet->Timeout);
   if (EFI_ERROR (Status)) {
     goto Exit;
   }
@@ -983,6 +1034,8 @@ Exit:
     UfsHc->FreeBuffer (UfsHc, EFI_SIZE_TO_PAGES (CmdDescSize), CmdDescHost);
   }
 
+  UfsReleaseSlotInTrl (Private, Slot);
+
   return Status;
 }
 
@@ -1278,6 +1331,7 @@ UfsExecNopCmds (
   Trd    = ((UTP_TRD *)Private->UtpTrlBase) + Slot;
   Status = UfsCreateNopCommandDesc (Private, Trd, &CmdDescHost, &CmdDescMapping);
   if (EFI_ERROR (Status)) {
+    UfsReleaseSlotInTrl (Private, Slot);
     return Status;
   }
 
@@ -1321,6 +1375,8 @@ Exit:
     UfsHc->FreeBuffer (UfsHc, EFI_SIZE_TO_PAGES (CmdDescSize), CmdDescHost);
   }
 
+  UfsReleaseSlotInTrl (Private, Slot);
+
   return Status;
 }
 
@@ -1467,9 +1523,84 @@ UfsPrepareDataTransferBuffer (
   return EFI_SUCCESS;
 }
 
+/**
+  Reserve a slot of the transfer list for a SCSI request, and fill its transfer
+  request descriptor, command descriptor and data buffer. The doorbell of the
+  slot isn't rung.
+
+  @param[in]      Private   Pointer to the UFS_PASS_THRU_PRIVATE_DATA
+  @param[in, out] TransReq  Pointer to the transfer request
+
+  @retval EFI_SUCCESS       The slot is ready to be started.
+  @retval EFI_NOT_READY     No slot is available at this moment.
+  @retval Others            The slot can't be filled.
+**/
+EFI_STATUS
+UfsFillScsiCmdSlot (
+  IN     UFS_PASS_THRU_PRIVATE_DATA  *Private,
+  IN OUT UFS_PASS_THRU_TRANS_REQ     *TransReq
+  )
+{
+  EFI_STATUS                          Status;
+  EDKII_UFS_HOST_CONTROLLER_PROTOCOL  *UfsHc;
+
+  UfsHc = Private->UfsHostController;
+  //
+  // Find out which slot of transfer request list is available.
+  //
+  Status = UfsFindAvailableSlotInTrl (Private, &TransReq->Slot);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  TransReq->Trd = ((UTP_TRD *)Private->UtpTrlBase) + TransReq->Slot;
+
+  //
+  // Fill transfer request descriptor to this slot.
+  //
+  Status = UfsCreateScsiCommandDesc (
+             Private,
+             TransReq->Lun,
+             TransReq->Packet,
+             TransReq->Trd,
+             &TransReq->CmdDescHost,
+             &TransReq->CmdDescMapping
+             );
+  if (EFI_ERROR (Status)) {
+    goto Error;
+  }
+
+  TransReq->CmdDescSize = TransReq->Trd->PrdtO * sizeof (UINT32) + TransReq->Trd->PrdtL * sizeof (UTP_TR_PRD);
+
+  Status = UfsPrepareDataTransferBuffer (Private, TransReq);
+  if (EFI_ERROR (Status)) {
+    goto Error;
+  }
+
+  return EFI_SUCCESS;
+
+Error:
+  if (TransReq->CmdDescMapping != NULL) {
+    UfsHc->Unmap (UfsHc, TransReq->CmdDescMapping);
+    TransReq->CmdDescMapping = NULL;
+  }
+
+  if (TransReq->CmdDescHost != NULL) {
+    UfsHc->FreeBuffer (UfsHc, EFI_SIZE_TO_PAGES (TransReq->CmdDescSize), TransReq->CmdDescHost);
+    TransReq->CmdDescHost = NULL;
+  }
+
+  UfsReleaseSlotInTrl (Private, TransReq->Slot);
+  TransReq->Trd = NULL;
+  return Status;
+}
+
 /**
   Sends a UFS-supported SCSI Request Packet to a UFS device that is attached to the UFS host controller.
 
+  The nonblocking requests are kept in flight on all the slots of the transfer list. When no slot is
+  free, they wait in order for the completion of an earlier request.
+
   @param[in]      Private       The pointer to the UFS_PASS_THRU_PRIVATE_DATA data structure.
   @param[in]      Lun           The LUN of the UFS device to send the SCSI Request Packet.
   @param[in, out] Packet        A pointer to the SCSI Request Packet to send to a specified Lun of the
@@ -1515,48 +1646,51 @@ UfsExecScsiCmds (
   TransReq->Signature     = UFS_PASS_THRU_TRANS_REQ_SIG;
   TransReq->TimeoutRemain = Packet->Timeout;
   TransReq->Packet        = Packet;
+  TransReq->Lun           = Lun;
 
   UfsHc = Private->UfsHostController;
-  //
-  // Find out which slot of transfer request list is available.
-  //
-  Status = UfsFindAvailableSlotInTrl (Private, &TransReq->Slot);
-  if (EFI_ERROR (Status)) {
-    return Status;
-  }
 
-  TransReq->Trd = ((UTP_TRD *)Private->UtpTrlBase) + TransReq->Slot;
+  if (Event != NULL) {
+    //
+    // Queue the async SCSI cmd. It takes a free slot of the transfer list, or
+    // waits in order for one to be freed by the completion of another cmd.
+    //
+    TransReq->CallerEvent = Event;
 
-  //
-  // Fill transfer request descriptor to this slot.
-  //
-  Status = UfsCreateScsiCommandDesc (
-             Private,
-             Lun,
-             Packet,
-             TransReq->Trd,
-             &TransReq->CmdDescHost,
-             &TransReq->CmdDescMapping
-             );
-  if (EFI_ERROR (Status)) {
-    return Status;
-  }
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    if (IsListEmpty (&Private->WaitQueue)) {
+      Status = UfsFillScsiCmdSlot (Private, TransReq);
+    } else {
+      Status = EFI_NOT_READY;
+    }
 
-  TransReq->CmdDescSize = TransReq->Trd->PrdtO * sizeof (UINT32) + TransReq->Trd->PrdtL * sizeof (UTP_TR_PRD);
+    if (Status == EFI_NOT_READY) {
+      InsertTailList (&Private->WaitQueue, &TransReq->TransferList);
+      Status = EFI_SUCCESS;
+    } else if (!EFI_ERROR (Status)) {
+      InsertTailList (&Private->Queue, &TransReq->TransferList);
+      Private->PendingDoorbell |= BIT0 << TransReq->Slot;
+    }
 
-  Status = UfsPrepareDataTransferBuffer (Private, TransReq);
-  if (EFI_ERROR (Status)) {
-    goto Exit1;
+    gBS->RestoreTPL (OldTpl);
+
+    if (EFI_ERROR (Status)) {
+      FreePool (TransReq);
+      return Status;
+    }
+
+    //
+    // The doorbell is rung once the caller drops below TPL_CALLBACK, together
+    // with the other cmds the caller issues until then.
+    //
+    gBS->SignalEvent (Private->DoorbellEvent);
+    return EFI_SUCCESS;
   }
 
-  //
-  // Insert the async SCSI cmd to the Async I/O list
-  //
-  if (Event != NULL) {
-    OldTpl                = gBS->RaiseTPL (TPL_NOTIFY);
-    TransReq->CallerEvent = Event;
-    InsertTailList (&Private->Queue, &TransReq->TransferList);
-    gBS->RestoreTPL (OldTpl);
+  Status = UfsFillScsiCmdSlot (Private, TransReq);
+  if (EFI_ERROR (Status)) {
+    FreePool (TransReq);
+    return Status;
   }
 
   //
@@ -1564,13 +1698,6 @@ UfsExecScsiCmds (
   //
   UfsStartExecCmd (Private, TransReq->Slot);
 
-  //
-  // Immediately return for async I/O.
-  //
-  if (Event != NULL) {
-    return EFI_SUCCESS;
-  }
-
   //
   // Wait for the completion of the transfer request.
   //
@@ -1634,7 +1761,6 @@ Exit:
 
   UfsReconcileDataTransferBuffer (Private, TransReq);
 
-Exit1:
   if (TransReq->CmdDescMapping != NULL) {
     UfsHc->Unmap (UfsHc, TransReq->CmdDescMapping);
   }
@@ -1643,9 +1769,9 @@ Exit1:
     UfsHc->FreeBuffer (UfsHc, EFI_SIZE_TO_PAGES (TransReq->CmdDescSize), TransReq->CmdDescHost);
   }
 
-  if (TransReq != NULL) {
-    FreePool (TransReq);
-  }
+  UfsReleaseSlotInTrl (Private, TransReq->Slot);
+
+  FreePool (TransReq);
 
   return Status;
 }
@@ -2254,22 +2380,29 @@ SignalCallerEvent (
 
   RemoveEntryList (&TransReq->TransferList);
 
-  UfsHc->Flush (UfsHc);
+  //
+  // A request still in the wait queue has no slot.
+  //
+  if (TransReq->Trd != NULL) {
+    UfsHc->Flush (UfsHc);
 
-  UfsStopExecCmd (Private, TransReq->Slot);
+    UfsStopExecCmd (Private, TransReq->Slot);
 
-  UfsReconcileDataTransferBuffer (Private, TransReq);
+    UfsReconcileDataTransferBuffer (Private, TransReq);
 
-  if (TransReq->CmdDescMapping != NULL) {
-    UfsHc->Unmap (UfsHc, TransReq->CmdDescMapping);
-  }
+    if (TransReq->CmdDescMapping != NULL) {
+      UfsHc->Unmap (UfsHc, TransReq->CmdDescMapping);
+    }
 
-  if (TransReq->CmdDescHost != NULL) {
-    UfsHc->FreeBuffer (
-             UfsHc,
-             EFI_SIZE_TO_PAGES (TransReq->CmdDescSize),
-             TransReq->CmdDescHost
-             );
+    if (TransReq->CmdDescHost != NULL) {
+      UfsHc->FreeBuffer (
+               UfsHc,
+               EFI_SIZE_TO_PAGES (TransReq->CmdDescSize),
+               TransReq->CmdDescHost
+               );
+    }
+
+    UfsReleaseSlotInTrl (Private, TransReq->Slot);
   }
 
   FreePool (TransReq);
@@ -2300,28 +2433,25 @@ ProcessAsyncTaskList (
   UTP_RESPONSE_UPIU                           *Response;
   UINT16                                      SenseDataLen;
   UINT32                                      ResTranCount;
-  UINT32                                      SlotsMap;
   UINT32                                      Value;
+  BOOLEAN                                     SlotsFull;
   EFI_STATUS                                  Status;
 
-  Private  = (UFS_PASS_THRU_PRIVATE_DATA *)Context;
-  SlotsMap = 0;
+  Private = (UFS_PASS_THRU_PRIVATE_DATA *)Context;
 
   //
-  // Check the entries in the async I/O queue are done or not.
+  // Check the entries in the async I/O queue are done or not. The doorbell
+  // register is read once for all of them. A slot whose doorbell isn't rung
+  // yet is still busy.
   //
   if (!IsListEmpty (&Private->Queue)) {
+    Status = UfsMmioRead32 (Private, UFS_HC_UTRLDBR_OFFSET, &Value);
+    Value |= Private->PendingDoorbell;
+
     BASE_LIST_FOR_EACH_SAFE (Entry, NextEntry, &Private->Queue) {
       TransReq = UFS_PASS_THRU_TRANS_REQ_FROM_THIS (Entry);
       Packet   = TransReq->Packet;
 
-      if ((SlotsMap & (BIT0 << TransReq->Slot)) != 0) {
-        return;
-      }
-
-      SlotsMap |= BIT0 << TransReq->Slot;
-
-      Status = UfsMmioRead32 (Private, UFS_HC_UTRLDBR_OFFSET, &Value);
       if (EFI_ERROR (Status)) {
         //
         // TODO: Should find/add a proper host adapter return status for this
@@ -2407,6 +2537,81 @@ ProcessAsyncTaskList (
       }
     }
   }
+
+  //
+  // Move the waiting entries to the slots freed above, in order.
+  //
+  if (!IsListEmpty (&Private->WaitQueue)) {
+    SlotsFull = FALSE;
+    BASE_LIST_FOR_EACH_SAFE (Entry, NextEntry, &Private->WaitQueue) {
+      TransReq = UFS_PASS_THRU_TRANS_REQ_FROM_THIS (Entry);
+      Packet   = TransReq->Packet;
+
+      Status = EFI_NOT_READY;
+      if (!SlotsFull) {
+        Status = UfsFillScsiCmdSlot (Private, TransReq);
+      }
+
+      if (Status == EFI_NOT_READY) {
+        SlotsFull = TRUE;
+        if (TransReq->TimeoutRemain > UFS_HC_ASYNC_TIMER) {
+          TransReq->TimeoutRemain -= UFS_HC_ASYNC_TIMER;
+        } else {
+          Packet->HostAdapterStatus = EFI_EXT_SCSI_STATUS_HOST_ADAPTER_TIMEOUT_COMMAND;
+          DEBUG ((DEBUG_VERBOSE, "ProcessAsyncTaskList(): Signal Event %p EFI_TIMEOUT.\n", TransReq->CallerEvent));
+          SignalCallerEvent (Private, TransReq);
+        }
+
+        continue;
+      }
+
+      if (EFI_ERROR (Status)) {
+        Packet->HostAdapterStatus = EFI_EXT_SCSI_STATUS_HOST_ADAPTER_PHASE_ERROR;
+        DEBUG ((DEBUG_VERBOSE, "ProcessAsyncTaskList(): Signal Event %p %r.\n", TransReq->CallerEvent, Status));
+        SignalCallerEvent (Private, TransReq);
+        continue;
+      }
+
+      RemoveEntryList (&TransReq->TransferList);
+      InsertTailList (&Private->Queue, &TransReq->TransferList);
+      Private->PendingDoorbell |= BIT0 << TransReq->Slot;
+    }
+  }
+
+  //
+  // Start the slots filled since the last doorbell, including those of a caller
+  // that waits for its cmds above TPL_CALLBACK.
+  //
+  UfsRingPendingDoorbell (NULL, Private);
+}
+
+/**
+  Ring the doorbell of the slots filled by the non-blocking requests since the
+  last ring, with a single write of the doorbell register.
+
+  @param[in]  Event     The Event this notify function registered to.
+  @param[in]  Context   Pointer to the context data registered to the Event.
+
+**/
+VOID
+EFIAPI
+UfsRingPendingDoorbell (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  UFS_PASS_THRU_PRIVATE_DATA  *Private;
+  EFI_TPL                     OldTpl;
+
+  Private = (UFS_PASS_THRU_PRIVATE_DATA *)Context;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  if (Private->PendingDoorbell != 0) {
+    UfsStartExecCmds (Private, Private->PendingDoorbell);
+    Private->PendingDoorbell = 0;
+  }
+
+  gBS->RestoreTPL (OldTpl);
 }
 
 /**
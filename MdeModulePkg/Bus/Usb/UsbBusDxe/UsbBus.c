@@ -26,6 +26,14 @@ EFI_USB_IO_PROTOCOL  mUsbIoProtocol = {
   UsbIoPortReset
 };
 
+EDKII_USB_STREAMS_PROTOCOL  mUsbStreamsProtocol = {
+  UsbStreamsAllocate,
+  UsbStreamsFree,
+  UsbStreamsAsyncTransfer,
+  UsbStreamsCancel,
+  UsbStreamsPoll
+};
+
 EFI_DRIVER_BINDING_PROTOCOL  mUsbBusDriverBinding = {
   UsbBusControllerDriverSupported,
   UsbBusControllerDriverStart,
@@ -924,6 +932,265 @@ ON_EXIT:
   return Status;
 }
 
+/**
+  Return the descriptor of a bulk endpoint of the interface.
+
+  @param  UsbIf                  The USB interface.
+  @param  Endpoint               The address of the endpoint.
+
+  @return The endpoint descriptor, or NULL if Endpoint isn't a bulk endpoint
+          of the interface.
+
+**/
+USB_ENDPOINT_DESC *
+UsbStreamsGetBulkEndpoint (
+  IN USB_INTERFACE  *UsbIf,
+  IN UINT8          Endpoint
+  )
+{
+  USB_ENDPOINT_DESC  *EpDesc;
+
+  if ((USB_ENDPOINT_ADDR (Endpoint) == 0) || (USB_ENDPOINT_ADDR (Endpoint) > 15)) {
+    return NULL;
+  }
+
+  EpDesc = UsbGetEndpointDesc (UsbIf, Endpoint);
+  if ((EpDesc == NULL) || (USB_ENDPOINT_TYPE (&EpDesc->Desc) != USB_ENDPOINT_BULK)) {
+    return NULL;
+  }
+
+  return EpDesc;
+}
+
+/**
+  USB_STREAMS function to allocate the streams of a bulk endpoint.
+
+  @param  This                   The USB_STREAMS instance.
+  @param  Endpoint               The address of the bulk endpoint.
+  @param  NumberOfStreams        On input, the number of streams requested. On
+                                 output, the number of streams allocated.
+
+  @retval EFI_SUCCESS            The streams are allocated.
+  @retval EFI_INVALID_PARAMETER  Endpoint isn't a bulk endpoint of the interface.
+  @retval Others                 Failed to allocate the streams.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbStreamsAllocate (
+  IN     EDKII_USB_STREAMS_PROTOCOL  *This,
+  IN     UINT8                       Endpoint,
+  IN OUT UINT16                      *NumberOfStreams
+  )
+{
+  USB_DEVICE     *Dev;
+  USB_INTERFACE  *UsbIf;
+  EFI_TPL        OldTpl;
+  EFI_STATUS     Status;
+
+  OldTpl = gBS->RaiseTPL (USB_BUS_TPL);
+
+  UsbIf = USB_INTERFACE_FROM_USBSTREAMS (This);
+  Dev   = UsbIf->Device;
+
+  if (UsbStreamsGetBulkEndpoint (UsbIf, Endpoint) == NULL) {
+    Status = EFI_INVALID_PARAMETER;
+    goto ON_EXIT;
+  }
+
+  Status = Dev->Bus->Usb2HcStreams->AllocateStreams (
+                                      Dev->Bus->Usb2HcStreams,
+                                      Dev->Address,
+                                      Endpoint,
+                                      NumberOfStreams
+                                      );
+
+ON_EXIT:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  USB_STREAMS function to free the streams of a bulk endpoint.
+
+  @param  This                   The USB_STREAMS instance.
+  @param  Endpoint               The address of the bulk endpoint.
+
+  @retval EFI_SUCCESS            The streams are freed.
+  @retval EFI_INVALID_PARAMETER  Endpoint isn't a bulk endpoint of the interface.
+  @retval Others                 Failed to free the streams.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbStreamsFree (
+  IN EDKII_USB_STREAMS_PROTOCOL  *This,
+  IN UINT8                       Endpoint
+  )
+{
+  USB_DEVICE     *Dev;
+  USB_INTERFACE  *UsbIf;
+  EFI_TPL        OldTpl;
+  EFI_STATUS     Status;
+
+  OldTpl = gBS->RaiseTPL (USB_BUS_TPL);
+
+  UsbIf = USB_INTERFACE_FROM_USBSTREAMS (This);
+  Dev   = UsbIf->Device;
+
+  if (UsbStreamsGetBulkEndpoint (UsbIf, Endpoint) == NULL) {
+    Status = EFI_INVALID_PARAMETER;
+    goto ON_EXIT;
+  }
+
+  Status = Dev->Bus->Usb2HcStreams->FreeStreams (
+                                      Dev->Bus->Usb2HcStreams,
+                                      Dev->Address,
+                                      Endpoint
+                                      );
+
+ON_EXIT:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  USB_STREAMS function to submit a bulk transfer to a stream of an endpoint, or
+  to queue it on an endpoint without streams.
+
+  @param  This                   The USB_STREAMS instance.
+  @param  Endpoint               The address of the bulk endpoint.
+  @param  StreamId               The stream of the transfer, 0 if the endpoint has no streams.
+  @param  Data                   The data buffer.
+  @param  DataLength             The size of the data buffer.
+  @param  Callback               The function called when the transfer is finished.
+  @param  Context                The context of Callback.
+
+  @retval EFI_SUCCESS            The transfer is submitted.
+  @retval EFI_INVALID_PARAMETER  Some parameters are invalid.
+  @retval Others                 Failed to submit the transfer.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbStreamsAsyncTransfer (
+  IN EDKII_USB_STREAMS_PROTOCOL       *This,
+  IN UINT8                            Endpoint,
+  IN UINT16                           StreamId,
+  IN VOID                             *Data,
+  IN UINTN                            DataLength,
+  IN EFI_ASYNC_USB_TRANSFER_CALLBACK  Callback,
+  IN VOID                             *Context OPTIONAL
+  )
+{
+  USB_DEVICE         *Dev;
+  USB_INTERFACE      *UsbIf;
+  USB_ENDPOINT_DESC  *EpDesc;
+  EFI_TPL            OldTpl;
+  EFI_STATUS         Status;
+
+  OldTpl = gBS->RaiseTPL (USB_BUS_TPL);
+
+  UsbIf  = USB_INTERFACE_FROM_USBSTREAMS (This);
+  Dev    = UsbIf->Device;
+  EpDesc = UsbStreamsGetBulkEndpoint (UsbIf, Endpoint);
+
+  if (EpDesc == NULL) {
+    Status = EFI_INVALID_PARAMETER;
+    goto ON_EXIT;
+  }
+
+  Status = Dev->Bus->Usb2HcStreams->AsyncStreamTransfer (
+                                      Dev->Bus->Usb2HcStreams,
+                                      Dev->Address,
+                                      Endpoint,
+                                      Dev->Speed,
+                                      EpDesc->Desc.MaxPacketSize,
+                                      StreamId,
+                                      Data,
+                                      DataLength,
+                                      Callback,
+                                      Context
+                                      );
+
+ON_EXIT:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  USB_STREAMS function to remove the pending transfers of an endpoint.
+
+  @param  This                   The USB_STREAMS instance.
+  @param  Endpoint               The address of the bulk endpoint.
+  @param  StreamId               The stream of the transfers, 0 for all the transfers
+                                 of the endpoint.
+
+  @retval EFI_SUCCESS            The pending transfers are removed.
+  @retval EFI_INVALID_PARAMETER  Endpoint isn't a bulk endpoint of the interface.
+  @retval EFI_NOT_FOUND          No transfer is pending.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbStreamsCancel (
+  IN EDKII_USB_STREAMS_PROTOCOL  *This,
+  IN UINT8                       Endpoint,
+  IN UINT16                      StreamId
+  )
+{
+  USB_DEVICE     *Dev;
+  USB_INTERFACE  *UsbIf;
+  EFI_TPL        OldTpl;
+  EFI_STATUS     Status;
+
+  OldTpl = gBS->RaiseTPL (USB_BUS_TPL);
+
+  UsbIf = USB_INTERFACE_FROM_USBSTREAMS (This);
+  Dev   = UsbIf->Device;
+
+  if (UsbStreamsGetBulkEndpoint (UsbIf, Endpoint) == NULL) {
+    Status = EFI_INVALID_PARAMETER;
+    goto ON_EXIT;
+  }
+
+  Status = Dev->Bus->Usb2HcStreams->CancelStreamTransfers (
+                                      Dev->Bus->Usb2HcStreams,
+                                      Dev->Address,
+                                      Endpoint,
+                                      StreamId
+                                      );
+
+ON_EXIT:
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  USB_STREAMS function to check the pending transfers. The callbacks
+  of the finished ones are called at the TPL of the caller, so the TPL isn't
+  raised here.
+
+  @param  This                   The USB_STREAMS instance.
+
+  @retval EFI_SUCCESS            The pending stream transfers are checked.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbStreamsPoll (
+  IN EDKII_USB_STREAMS_PROTOCOL  *This
+  )
+{
+  USB_INTERFACE  *UsbIf;
+  USB_BUS        *Bus;
+
+  UsbIf = USB_INTERFACE_FROM_USBSTREAMS (This);
+  Bus   = UsbIf->Device->Bus;
+
+  return Bus->Usb2HcStreams->Poll (Bus->Usb2HcStreams);
+}
+
 /**
   Install Usb Bus Protocol on host controller, and start the Usb bus.
 
@@ -1010,6 +1277,23 @@ UsbBusBuildProtocol (
     }
   }
 
+  //
+  // The queued bulk transfers and the bulk streams are optional. They are used
+  // by the device drivers keeping several bulk transfers in flight, such as the
+  // USB Attached SCSI driver.
+  //
+  Status = gBS->OpenProtocol (
+                  Controller,
+                  &gEdkiiUsb2HcStreamsProtocolGuid,
+                  (VOID **)&(UsbBus->Usb2HcStreams),
+                  This->DriverBindingHandle,
+                  Controller,
+                  EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                  );
+  if (EFI_ERROR (Status)) {
+    UsbBus->Usb2HcStreams = NULL;
+  }
+
   //
   // Install an EFI_USB_BUS_PROTOCOL to host controller to identify it.
   //
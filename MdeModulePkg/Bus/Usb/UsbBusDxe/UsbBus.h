@@ -13,6 +13,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include <Protocol/Usb2HostController.h>
 #include <Protocol/UsbIo.h>
+#include <Protocol/Usb2HcStreams.h>
+#include <Protocol/UsbStreams.h>
 #include <Protocol/DevicePath.h>
 
 #include <Library/BaseLib.h>
@@ -139,6 +141,9 @@ typedef struct _USB_HUB_API    USB_HUB_API;
 #define USB_INTERFACE_FROM_USBIO(a) \
           CR(a, USB_INTERFACE, UsbIo, USB_INTERFACE_SIGNATURE)
 
+#define USB_INTERFACE_FROM_USBSTREAMS(a) \
+          CR(a, USB_INTERFACE, UsbStreams, USB_INTERFACE_SIGNATURE)
+
 #define USB_BUS_FROM_THIS(a) \
           CR(a, USB_BUS, BusId, USB_BUS_SIGNATURE)
 
@@ -193,66 +198,76 @@ struct _USB_DEVICE {
 // Stands for different functions of USB device
 //
 struct _USB_INTERFACE {
-  UINTN                       Signature;
-  USB_DEVICE                  *Device;
-  USB_INTERFACE_DESC          *IfDesc;
-  USB_INTERFACE_SETTING       *IfSetting;
+  UINTN                         Signature;
+  USB_DEVICE                    *Device;
+  USB_INTERFACE_DESC            *IfDesc;
+  USB_INTERFACE_SETTING         *IfSetting;
 
   //
   // Handles and protocols
   //
-  EFI_HANDLE                  Handle;
-  EFI_USB_IO_PROTOCOL         UsbIo;
-  EFI_DEVICE_PATH_PROTOCOL    *DevicePath;
-  BOOLEAN                     IsManaged;
+  EFI_HANDLE                    Handle;
+  EFI_USB_IO_PROTOCOL           UsbIo;
+  EFI_DEVICE_PATH_PROTOCOL      *DevicePath;
+  BOOLEAN                       IsManaged;
+  //
+  // The bulk streams of a SuperSpeed interface, installed when the host
+  // controller supports them.
+  //
+  BOOLEAN                       HasStreams;
+  EDKII_USB_STREAMS_PROTOCOL    UsbStreams;
 
   //
   // Hub device special data
   //
-  BOOLEAN                     IsHub;
-  USB_HUB_API                 *HubApi;
-  UINT8                       NumOfPort;
-  EFI_EVENT                   HubNotify;
+  BOOLEAN                       IsHub;
+  USB_HUB_API                   *HubApi;
+  UINT8                         NumOfPort;
+  EFI_EVENT                     HubNotify;
 
   //
   // Data used only by normal hub devices
   //
-  USB_ENDPOINT_DESC           *HubEp;
-  UINT8                       *ChangeMap;
+  USB_ENDPOINT_DESC             *HubEp;
+  UINT8                         *ChangeMap;
 
   //
   // Data used only by root hub to hand over device to
   // companion UHCI driver if low/full speed devices are
   // connected to EHCI.
   //
-  UINT8                       MaxSpeed;
+  UINT8                         MaxSpeed;
 };
 
 //
 // Stands for the current USB Bus
 //
 struct _USB_BUS {
-  UINTN                       Signature;
-  EFI_USB_BUS_PROTOCOL        BusId;
+  UINTN                             Signature;
+  EFI_USB_BUS_PROTOCOL              BusId;
 
   //
   // Managed USB host controller
   //
-  EFI_HANDLE                  HostHandle;
-  EFI_DEVICE_PATH_PROTOCOL    *DevicePath;
-  EFI_USB2_HC_PROTOCOL        *Usb2Hc;
+  EFI_HANDLE                        HostHandle;
+  EFI_DEVICE_PATH_PROTOCOL          *DevicePath;
+  EFI_USB2_HC_PROTOCOL              *Usb2Hc;
+  //
+  // The bulk streams support of the host controller, NULL if not supported.
+  //
+  EDKII_USB2_HC_STREAMS_PROTOCOL    *Usb2HcStreams;
 
   //
   // Recorded the max supported usb devices.
   // XHCI can support up to 255 devices.
   // EHCI/UHCI/OHCI supports up to 127 devices.
   //
-  UINT32                      MaxDevices;
+  UINT32                            MaxDevices;
   //
   // An array of device that is on the bus. Devices[0] is
   // for root hub. Device with address i is at Devices[i].
   //
-  USB_DEVICE                  *Devices[256];
+  USB_DEVICE                        *Devices[256];
 
   //
   // USB Bus driver need to control the recursive connect policy of the bus, only those wanted
@@ -649,6 +664,111 @@ UsbIoPortReset (
   IN EFI_USB_IO_PROTOCOL  *This
   );
 
+/**
+  USB_STREAMS function to allocate the streams of a bulk endpoint.
+
+  @param  This                   The USB_STREAMS instance.
+  @param  Endpoint               The address of the bulk endpoint.
+  @param  NumberOfStreams        On input, the number of streams requested. On
+                                 output, the number of streams allocated.
+
+  @retval EFI_SUCCESS            The streams are allocated.
+  @retval EFI_INVALID_PARAMETER  Endpoint isn't a bulk endpoint of the interface.
+  @retval Others                 Failed to allocate the streams.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbStreamsAllocate (
+  IN     EDKII_USB_STREAMS_PROTOCOL  *This,
+  IN     UINT8                       Endpoint,
+  IN OUT UINT16                      *NumberOfStreams
+  );
+
+/**
+  USB_STREAMS function to free the streams of a bulk endpoint.
+
+  @param  This                   The USB_STREAMS instance.
+  @param  Endpoint               The address of the bulk endpoint.
+
+  @retval EFI_SUCCESS            The streams are freed.
+  @retval EFI_INVALID_PARAMETER  Endpoint isn't a bulk endpoint of the interface.
+  @retval Others                 Failed to free the streams.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbStreamsFree (
+  IN EDKII_USB_STREAMS_PROTOCOL  *This,
+  IN UINT8                       Endpoint
+  );
+
+/**
+  USB_STREAMS function to submit a bulk transfer to a stream of an endpoint, or
+  to queue it on an endpoint without streams.
+
+  @param  This                   The USB_STREAMS instance.
+  @param  Endpoint               The address of the bulk endpoint.
+  @param  StreamId               The stream of the transfer, 0 if the endpoint has no streams.
+  @param  Data                   The data buffer.
+  @param  DataLength             The size of the data buffer.
+  @param  Callback               The function called when the transfer is finished.
+  @param  Context                The context of Callback.
+
+  @retval EFI_SUCCESS            The transfer is submitted.
+  @retval EFI_INVALID_PARAMETER  Some parameters are invalid.
+  @retval Others                 Failed to submit the transfer.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbStreamsAsyncTransfer (
+  IN EDKII_USB_STREAMS_PROTOCOL       *This,
+  IN UINT8                            Endpoint,
+  IN UINT16                           StreamId,
+  IN VOID                             *Data,
+  IN UINTN                            DataLength,
+  IN EFI_ASYNC_USB_TRANSFER_CALLBACK  Callback,
+  IN VOID                             *Context OPTIONAL
+  );
+
+/**
+  USB_STREAMS function to remove the pending transfers of an endpoint.
+
+  @param  This                   The USB_STREAMS instance.
+  @param  Endpoint               The address of the bulk endpoint.
+  @param  StreamId               The stream of the transfers, 0 for all the transfers
+                                 of the endpoint.
+
+  @retval EFI_SUCCESS            The pending transfers are removed.
+  @retval EFI_INVALID_PARAMETER  Endpoint isn't a bulk endpoint of the interface.
+  @retval EFI_NOT_FOUND          No transfer is pending.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbStreamsCancel (
+  IN EDKII_USB_STREAMS_PROTOCOL  *This,
+  IN UINT8                       Endpoint,
+  IN UINT16                      StreamId
+  );
+
+/**
+  USB_STREAMS function to check the pending transfers. The callbacks
+  of the finished ones are called at the TPL of the caller, so the TPL isn't
+  raised here.
+
+  @param  This                   The USB_STREAMS instance.
+
+  @retval EFI_SUCCESS            The pending stream transfers are checked.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbStreamsPoll (
+  IN EDKII_USB_STREAMS_PROTOCOL  *This
+  );
+
 /**
   Install Usb Bus Protocol on host controller, and start the Usb bus.
 
@@ -749,6 +869,7 @@ UsbBusControllerDriverStop (
   );
 
 extern EFI_USB_IO_PROTOCOL           mUsbIoProtocol;
+extern EDKII_USB_STREAMS_PROTOCOL    mUsbStreamsProtocol;
 extern EFI_DRIVER_BINDING_PROTOCOL   mUsbBusDriverBinding;
 extern EFI_COMPONENT_NAME_PROTOCOL   mUsbBusComponentName;
 extern EFI_COMPONENT_NAME2_PROTOCOL  mUsbBusComponentName2;
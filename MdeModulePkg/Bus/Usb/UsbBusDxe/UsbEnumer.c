@@ -55,6 +55,22 @@ UsbFreeInterface (
   )
 {
   EFI_STATUS  Status;
+  EFI_STATUS  Status2;
+  BOOLEAN     HasStreams;
+
+  HasStreams = UsbIf->HasStreams;
+  if (HasStreams) {
+    Status = gBS->UninstallProtocolInterface (
+                    UsbIf->Handle,
+                    &gEdkiiUsbStreamsProtocolGuid,
+                    &UsbIf->UsbStreams
+                    );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    UsbIf->HasStreams = FALSE;
+  }
 
   UsbCloseHostProtoByChild (UsbIf->Device->Bus, UsbIf->Handle);
 
@@ -74,6 +90,16 @@ UsbFreeInterface (
     FreePool (UsbIf);
   } else {
     UsbOpenHostProtoByChild (UsbIf->Device->Bus, UsbIf->Handle);
+
+    if (HasStreams) {
+      Status2 = gBS->InstallProtocolInterface (
+                       &UsbIf->Handle,
+                       &gEdkiiUsbStreamsProtocolGuid,
+                       EFI_NATIVE_INTERFACE,
+                       &UsbIf->UsbStreams
+                       );
+      UsbIf->HasStreams = (BOOLEAN) !EFI_ERROR (Status2);
+    }
   }
 
   return Status;
@@ -173,6 +199,31 @@ UsbCreateInterface (
     goto ON_ERROR;
   }
 
+  //
+  // Let the drivers queue bulk transfers, and use the bulk streams of SuperSpeed
+  // devices, when the host controller supports them. The interface is still
+  // usable without.
+  //
+  if (Device->Bus->Usb2HcStreams != NULL) {
+    CopyMem (
+      &(UsbIf->UsbStreams),
+      &mUsbStreamsProtocol,
+      sizeof (EDKII_USB_STREAMS_PROTOCOL)
+      );
+
+    Status = gBS->InstallProtocolInterface (
+                    &UsbIf->Handle,
+                    &gEdkiiUsbStreamsProtocolGuid,
+                    EFI_NATIVE_INTERFACE,
+                    &UsbIf->UsbStreams
+                    );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_WARN, "UsbCreateInterface: failed to install UsbStreams - %r\n", Status));
+    } else {
+      UsbIf->HasStreams = TRUE;
+    }
+  }
+
   return UsbIf;
 
 ON_ERROR:
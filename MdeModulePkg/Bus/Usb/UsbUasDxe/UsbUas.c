@@ -0,0 +1,1230 @@
+/** @file
+  USB Attached SCSI driver. It selects the UAS alternate setting of a USB mass
+  storage interface and produces the Extended SCSI Pass Thru Protocol, so that
+  several commands are in flight on a SuperSpeed device.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "UsbUas.h"
+
+//
+// The version is above the one of the USB mass storage driver, so a device
+// supporting both protocols is driven through UAS. The USB mass storage driver
+// takes the device when this driver fails to start.
+//
+EFI_DRIVER_BINDING_PROTOCOL  gUsbUasDriverBinding = {
+  UsbUasDriverBindingSupported,
+  UsbUasDriverBindingStart,
+  UsbUasDriverBindingStop,
+  0x12,
+  NULL,
+  NULL
+};
+
+/**
+  Check whether all the bytes of the target are equal to a value.
+
+  @param  Target                The target, TARGET_MAX_BYTES bytes.
+  @param  Value                 The value.
+
+  @retval TRUE                  All the bytes are equal to Value.
+  @retval FALSE                 Some bytes are different from Value.
+
+**/
+BOOLEAN
+UsbUasIsTarget (
+  IN UINT8  *Target,
+  IN UINT8  Value
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < TARGET_MAX_BYTES; Index++) {
+    if (Target[Index] != Value) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Find a LUN in the LUNs reported by the device.
+
+  @param  UsbUas                The USB UAS device.
+  @param  Lun                   The LUN to find.
+
+  @return The index of the LUN, or UsbUas->LunCount if it isn't found.
+
+**/
+UINTN
+UsbUasFindLun (
+  IN USB_UAS_DEVICE  *UsbUas,
+  IN UINT64          Lun
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < UsbUas->LunCount; Index++) {
+    if (UsbUas->Luns[Index] == Lun) {
+      break;
+    }
+  }
+
+  return Index;
+}
+
+/**
+  Sends a SCSI Request Packet to a SCSI device that is attached to the SCSI channel.
+
+  @param  This                  A pointer to the EFI_EXT_SCSI_PASS_THRU_PROTOCOL instance.
+  @param  Target                The Target of the SCSI device.
+  @param  Lun                   The LUN of the SCSI device.
+  @param  Packet                A pointer to the SCSI Request Packet.
+  @param  Event                 If not NULL, the nonblocking I/O is performed and Event
+                                is signaled when the SCSI Request Packet completes.
+
+  @retval EFI_SUCCESS           The SCSI Request Packet was sent by the host.
+  @retval EFI_BAD_BUFFER_SIZE   The SCSI Request Packet was not executed. The number of
+                                bytes that could be transferred is returned.
+  @retval EFI_NOT_READY         Too many SCSI Request Packets are already in flight.
+  @retval EFI_DEVICE_ERROR      A device error occurred.
+  @retval EFI_INVALID_PARAMETER Target, Lun, or the contents of Packet are invalid.
+  @retval EFI_UNSUPPORTED       The command is not supported by the host adapter.
+  @retval EFI_TIMEOUT           A timeout occurred while waiting for the packet to execute.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasPassThru (
+  IN     EFI_EXT_SCSI_PASS_THRU_PROTOCOL             *This,
+  IN     UINT8                                       *Target,
+  IN     UINT64                                      Lun,
+  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
+  IN     EFI_EVENT                                   Event OPTIONAL
+  )
+{
+  USB_UAS_DEVICE   *UsbUas;
+  USB_UAS_REQUEST  *Request;
+  EFI_STATUS       Status;
+  EFI_EVENT        RequestEvent;
+
+  UsbUas = USB_UAS_DEVICE_FROM_PASS_THRU (This);
+
+  if ((Packet == NULL) || (Packet->Cdb == NULL) || (Target == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // The Command IU holds 16 bytes of CDB, the additional CDB bytes aren't supported.
+  //
+  if ((Packet->CdbLength == 0) || (Packet->CdbLength > USB_UAS_MAX_CDB_LENGTH)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((Packet->SenseDataLength != 0) && (Packet->SenseData == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (!UsbUasIsTarget (Target, 0) || (UsbUasFindLun (UsbUas, Lun) == UsbUas->LunCount)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((Packet->DataDirection == EFI_EXT_SCSI_DATA_DIRECTION_BIDIRECTIONAL) ||
+      ((Packet->InTransferLength != 0) && (Packet->OutTransferLength != 0)))
+  {
+    Packet->InTransferLength  = 0;
+    Packet->OutTransferLength = 0;
+    return EFI_UNSUPPORTED;
+  }
+
+  if (Packet->InTransferLength > USB_UAS_MAX_TRANSFER_LENGTH) {
+    Packet->InTransferLength = USB_UAS_MAX_TRANSFER_LENGTH;
+    return EFI_BAD_BUFFER_SIZE;
+  }
+
+  if (Packet->OutTransferLength > USB_UAS_MAX_TRANSFER_LENGTH) {
+    Packet->OutTransferLength = USB_UAS_MAX_TRANSFER_LENGTH;
+    return EFI_BAD_BUFFER_SIZE;
+  }
+
+  //
+  // Without streams the command is executed to the end in any case, and the
+  // event of a nonblocking request is signaled once it is complete.
+  //
+  RequestEvent = Event;
+  if (UsbUas->UsbStreams == NULL) {
+    RequestEvent = NULL;
+  }
+
+  Request = UsbUasAllocateRequest (UsbUas);
+  if (Request == NULL) {
+    return EFI_NOT_READY;
+  }
+
+  UsbUasBuildCommand (Request, (UINT16)Lun, Packet);
+  if (Packet->InTransferLength != 0) {
+    Request->DataEndpoint = UsbUas->DataInEndpoint;
+    Request->Data         = Packet->InDataBuffer;
+    Request->DataLength   = Packet->InTransferLength;
+  } else if (Packet->OutTransferLength != 0) {
+    Request->DataEndpoint = UsbUas->DataOutEndpoint;
+    Request->Data         = Packet->OutDataBuffer;
+    Request->DataLength   = Packet->OutTransferLength;
+  }
+
+  Request->Event = RequestEvent;
+
+  Status = UsbUasSubmitRequest (Request, Packet->Timeout);
+  if (EFI_ERROR (Status)) {
+    UsbUasReleaseRequest (Request);
+    Packet->HostAdapterStatus = EFI_EXT_SCSI_STATUS_HOST_ADAPTER_OTHER;
+    Packet->InTransferLength  = 0;
+    Packet->OutTransferLength = 0;
+    Packet->SenseDataLength   = 0;
+    return EFI_DEVICE_ERROR;
+  }
+
+  if (RequestEvent != NULL) {
+    return EFI_SUCCESS;
+  }
+
+  Status = UsbUasWaitRequest (Request, Packet->Timeout);
+  if (EFI_ERROR (Status)) {
+    Packet->HostAdapterStatus = EFI_EXT_SCSI_STATUS_HOST_ADAPTER_TIMEOUT_COMMAND;
+    Packet->InTransferLength  = 0;
+    Packet->OutTransferLength = 0;
+    Packet->SenseDataLength   = 0;
+  } else {
+    Status = Request->Status;
+  }
+
+  UsbUasReleaseRequest (Request);
+  if (Event != NULL) {
+    gBS->SignalEvent (Event);
+  }
+
+  return Status;
+}
+
+/**
+  Used to retrieve the list of legal Target IDs and LUNs for SCSI devices on a SCSI channel.
+
+  @param  This                  A pointer to the EFI_EXT_SCSI_PASS_THRU_PROTOCOL instance.
+  @param  Target                On input, the previous Target ID. On output, the next Target ID.
+  @param  Lun                   On input, the previous LUN. On output, the next LUN.
+
+  @retval EFI_SUCCESS           The Target ID and LUN of the next SCSI device are returned.
+  @retval EFI_NOT_FOUND         There are no more SCSI devices on this SCSI channel.
+  @retval EFI_INVALID_PARAMETER Target or Lun is not valid.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasGetNextTargetLun (
+  IN     EFI_EXT_SCSI_PASS_THRU_PROTOCOL  *This,
+  IN OUT UINT8                            **Target,
+  IN OUT UINT64                           *Lun
+  )
+{
+  USB_UAS_DEVICE  *UsbUas;
+  UINTN           Index;
+
+  UsbUas = USB_UAS_DEVICE_FROM_PASS_THRU (This);
+
+  if ((Target == NULL) || (*Target == NULL) || (Lun == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // If the target is all 0xFF's, return the first LUN.
+  //
+  if (UsbUasIsTarget (*Target, 0xFF)) {
+    SetMem (*Target, TARGET_MAX_BYTES, 0x00);
+    *Lun = UsbUas->Luns[0];
+    return EFI_SUCCESS;
+  }
+
+  if (!UsbUasIsTarget (*Target, 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Index = UsbUasFindLun (UsbUas, *Lun);
+  if (Index == UsbUas->LunCount) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Index + 1 == UsbUas->LunCount) {
+    return EFI_NOT_FOUND;
+  }
+
+  *Lun = UsbUas->Luns[Index + 1];
+  return EFI_SUCCESS;
+}
+
+/**
+  Used to allocate and build a device path node for a SCSI device on a SCSI channel.
+
+  @param  This                  A pointer to the EFI_EXT_SCSI_PASS_THRU_PROTOCOL instance.
+  @param  Target                The Target of the SCSI device.
+  @param  Lun                   The LUN of the SCSI device.
+  @param  DevicePath            The device path node built.
+
+  @retval EFI_SUCCESS           The device path node is built.
+  @retval EFI_NOT_FOUND         The SCSI device doesn't exist.
+  @retval EFI_INVALID_PARAMETER DevicePath is NULL.
+  @retval EFI_OUT_OF_RESOURCES  There are not enough resources to allocate DevicePath.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasBuildDevicePath (
+  IN     EFI_EXT_SCSI_PASS_THRU_PROTOCOL  *This,
+  IN     UINT8                            *Target,
+  IN     UINT64                           Lun,
+  IN OUT EFI_DEVICE_PATH_PROTOCOL         **DevicePath
+  )
+{
+  USB_UAS_DEVICE    *UsbUas;
+  SCSI_DEVICE_PATH  *ScsiNode;
+
+  UsbUas = USB_UAS_DEVICE_FROM_PASS_THRU (This);
+
+  if ((Target == NULL) || (DevicePath == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (!UsbUasIsTarget (Target, 0) || (UsbUasFindLun (UsbUas, Lun) == UsbUas->LunCount)) {
+    return EFI_NOT_FOUND;
+  }
+
+  ScsiNode = (SCSI_DEVICE_PATH *)CreateDeviceNode (
+                                   MESSAGING_DEVICE_PATH,
+                                   MSG_SCSI_DP,
+                                   sizeof (SCSI_DEVICE_PATH)
+                                   );
+  if (ScsiNode == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ScsiNode->Pun = 0;
+  ScsiNode->Lun = (UINT16)Lun;
+
+  *DevicePath = (EFI_DEVICE_PATH_PROTOCOL *)ScsiNode;
+  return EFI_SUCCESS;
+}
+
+/**
+  Used to translate a device path node to a Target ID and LUN.
+
+  @param  This                  A pointer to the EFI_EXT_SCSI_PASS_THRU_PROTOCOL instance.
+  @param  DevicePath            The device path node.
+  @param  Target                The Target ID of the SCSI device.
+  @param  Lun                   The LUN of the SCSI device.
+
+  @retval EFI_SUCCESS           DevicePath is translated.
+  @retval EFI_INVALID_PARAMETER DevicePath, Target or Lun is NULL.
+  @retval EFI_UNSUPPORTED       This driver doesn't support DevicePath.
+  @retval EFI_NOT_FOUND         The SCSI device doesn't exist.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasGetTargetLun (
+  IN  EFI_EXT_SCSI_PASS_THRU_PROTOCOL  *This,
+  IN  EFI_DEVICE_PATH_PROTOCOL         *DevicePath,
+  OUT UINT8                            **Target,
+  OUT UINT64                           *Lun
+  )
+{
+  USB_UAS_DEVICE    *UsbUas;
+  SCSI_DEVICE_PATH  *ScsiNode;
+
+  UsbUas = USB_UAS_DEVICE_FROM_PASS_THRU (This);
+
+  if ((DevicePath == NULL) || (Target == NULL) || (*Target == NULL) || (Lun == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((DevicePath->Type != MESSAGING_DEVICE_PATH) || (DevicePath->SubType != MSG_SCSI_DP) ||
+      (DevicePathNodeLength (DevicePath) != sizeof (SCSI_DEVICE_PATH)))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  ScsiNode = (SCSI_DEVICE_PATH *)DevicePath;
+  if ((ScsiNode->Pun != 0) || (UsbUasFindLun (UsbUas, ScsiNode->Lun) == UsbUas->LunCount)) {
+    return EFI_NOT_FOUND;
+  }
+
+  SetMem (*Target, TARGET_MAX_BYTES, 0x00);
+  *Lun = ScsiNode->Lun;
+  return EFI_SUCCESS;
+}
+
+/**
+  Resets a SCSI channel. The requests in flight are aborted and an I_T NEXUS
+  RESET is sent to the device.
+
+  @param  This                  A pointer to the EFI_EXT_SCSI_PASS_THRU_PROTOCOL instance.
+
+  @retval EFI_SUCCESS           The SCSI channel is reset.
+  @retval EFI_DEVICE_ERROR      A device error occurred while resetting the SCSI channel.
+  @retval EFI_TIMEOUT           A timeout occurred while resetting the SCSI channel.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasResetChannel (
+  IN EFI_EXT_SCSI_PASS_THRU_PROTOCOL  *This
+  )
+{
+  USB_UAS_DEVICE  *UsbUas;
+  EFI_STATUS      Status;
+
+  UsbUas = USB_UAS_DEVICE_FROM_PASS_THRU (This);
+
+  UsbUasAbortAllRequests (UsbUas);
+
+  Status = UsbUasTaskManagement (UsbUas, 0, USB_UAS_TMF_I_T_NEXUS_RESET);
+  if (Status == EFI_NOT_READY) {
+    Status = EFI_DEVICE_ERROR;
+  }
+
+  return Status;
+}
+
+/**
+  Resets a SCSI logical unit that is connected to a SCSI channel.
+
+  @param  This                  A pointer to the EFI_EXT_SCSI_PASS_THRU_PROTOCOL instance.
+  @param  Target                The Target of the SCSI device.
+  @param  Lun                   The LUN of the SCSI device.
+
+  @retval EFI_SUCCESS           The SCSI device is reset.
+  @retval EFI_INVALID_PARAMETER Target or Lun is not valid.
+  @retval EFI_DEVICE_ERROR      A device error occurred while resetting the SCSI device.
+  @retval EFI_TIMEOUT           A timeout occurred while resetting the SCSI device.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasResetTargetLun (
+  IN EFI_EXT_SCSI_PASS_THRU_PROTOCOL  *This,
+  IN UINT8                            *Target,
+  IN UINT64                           Lun
+  )
+{
+  USB_UAS_DEVICE  *UsbUas;
+  EFI_STATUS      Status;
+
+  UsbUas = USB_UAS_DEVICE_FROM_PASS_THRU (This);
+
+  if ((Target == NULL) || !UsbUasIsTarget (Target, 0) || (UsbUasFindLun (UsbUas, Lun) == UsbUas->LunCount)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = UsbUasTaskManagement (UsbUas, (UINT16)Lun, USB_UAS_TMF_LOGICAL_UNIT_RESET);
+  if (Status == EFI_NOT_READY) {
+    Status = EFI_DEVICE_ERROR;
+  }
+
+  return Status;
+}
+
+/**
+  Used to retrieve the list of legal Target IDs for SCSI devices on a SCSI channel.
+
+  @param  This                  A pointer to the EFI_EXT_SCSI_PASS_THRU_PROTOCOL instance.
+  @param  Target                On input, the previous Target ID. On output, the next Target ID.
+
+  @retval EFI_SUCCESS           The next Target ID is returned.
+  @retval EFI_NOT_FOUND         There are no more SCSI devices on this SCSI channel.
+  @retval EFI_INVALID_PARAMETER Target is not valid.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasGetNextTarget (
+  IN     EFI_EXT_SCSI_PASS_THRU_PROTOCOL  *This,
+  IN OUT UINT8                            **Target
+  )
+{
+  if ((Target == NULL) || (*Target == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (UsbUasIsTarget (*Target, 0xFF)) {
+    SetMem (*Target, TARGET_MAX_BYTES, 0x00);
+    return EFI_SUCCESS;
+  }
+
+  if (UsbUasIsTarget (*Target, 0)) {
+    return EFI_NOT_FOUND;
+  }
+
+  return EFI_INVALID_PARAMETER;
+}
+
+/**
+  Read the whole descriptor of the active configuration of the device.
+
+  @param  UsbIo                 The USB I/O Protocol instance.
+  @param  Buffer                The buffer of the descriptor, freed by the caller.
+  @param  Length                The length of the descriptor.
+
+  @retval EFI_SUCCESS           The descriptor is read.
+  @retval EFI_NOT_FOUND         The active configuration isn't found.
+  @retval Others                The descriptor can't be read.
+
+**/
+EFI_STATUS
+UsbUasGetConfigDescriptor (
+  IN  EFI_USB_IO_PROTOCOL  *UsbIo,
+  OUT UINT8                **Buffer,
+  OUT UINTN                *Length
+  )
+{
+  EFI_USB_DEVICE_DESCRIPTOR  DevDesc;
+  EFI_USB_CONFIG_DESCRIPTOR  ActiveConfig;
+  EFI_USB_CONFIG_DESCRIPTOR  Config;
+  UINT8                      Index;
+  UINT32                     Result;
+  EFI_STATUS                 Status;
+
+  Status = UsbIo->UsbGetDeviceDescriptor (UsbIo, &DevDesc);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = UsbIo->UsbGetConfigDescriptor (UsbIo, &ActiveConfig);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  for (Index = 0; Index < DevDesc.NumConfigurations; Index++) {
+    Status = UsbGetDescriptor (
+               UsbIo,
+               (UINT16)((USB_DESC_TYPE_CONFIG << 8) | Index),
+               0,
+               sizeof (EFI_USB_CONFIG_DESCRIPTOR),
+               &Config,
+               &Result
+               );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if (Config.ConfigurationValue != ActiveConfig.ConfigurationValue) {
+      continue;
+    }
+
+    if (Config.TotalLength < sizeof (EFI_USB_CONFIG_DESCRIPTOR)) {
+      return EFI_DEVICE_ERROR;
+    }
+
+    *Buffer = AllocateZeroPool (Config.TotalLength);
+    if (*Buffer == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    Status = UsbGetDescriptor (
+               UsbIo,
+               (UINT16)((USB_DESC_TYPE_CONFIG << 8) | Index),
+               0,
+               Config.TotalLength,
+               *Buffer,
+               &Result
+               );
+    if (EFI_ERROR (Status)) {
+      FreePool (*Buffer);
+      *Buffer = NULL;
+      return Status;
+    }
+
+    *Length = Config.TotalLength;
+    return EFI_SUCCESS;
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Find the UAS alternate setting of the interface and the pipes it uses.
+
+  @param  UsbUas                The USB UAS device. On output, its alternate setting
+                                and endpoints are filled.
+  @param  Buffer                The descriptor of the active configuration.
+  @param  Length                The length of the descriptor.
+  @param  MaxPacketSize         The maximum packet size of the data-in pipe.
+
+  @retval EFI_SUCCESS           The UAS alternate setting is found.
+  @retval EFI_UNSUPPORTED       The interface has no UAS alternate setting.
+
+**/
+EFI_STATUS
+UsbUasParseInterface (
+  IN OUT USB_UAS_DEVICE  *UsbUas,
+  IN     UINT8           *Buffer,
+  IN     UINTN           Length,
+  OUT    UINT16          *MaxPacketSize
+  )
+{
+  EFI_USB_INTERFACE_DESCRIPTOR  *IfDesc;
+  EFI_USB_ENDPOINT_DESCRIPTOR   *EpDesc;
+  UINTN                         Offset;
+  BOOLEAN                       InSetting;
+  UINT8                         Endpoint;
+  UINT16                        PacketSize;
+
+  InSetting  = FALSE;
+  Endpoint   = 0;
+  PacketSize = 0;
+  Offset     = 0;
+
+  UsbUas->CommandEndpoint = 0;
+  UsbUas->StatusEndpoint  = 0;
+  UsbUas->DataInEndpoint  = 0;
+  UsbUas->DataOutEndpoint = 0;
+
+  while ((Offset + 2 <= Length) && (Buffer[Offset] >= 2) && (Offset + Buffer[Offset] <= Length)) {
+    switch (Buffer[Offset + 1]) {
+      case USB_DESC_TYPE_INTERFACE:
+        if (InSetting) {
+          //
+          // The end of the UAS alternate setting
+          //
+          Offset = Length;
+          continue;
+        }
+
+        IfDesc = (EFI_USB_INTERFACE_DESCRIPTOR *)(Buffer + Offset);
+        if ((Buffer[Offset] >= sizeof (EFI_USB_INTERFACE_DESCRIPTOR)) &&
+            (IfDesc->InterfaceNumber == UsbUas->InterfaceNumber) &&
+            (IfDesc->InterfaceClass == USB_UAS_CLASS) &&
+            (IfDesc->InterfaceSubClass == USB_UAS_SUBCLASS) &&
+            (IfDesc->InterfaceProtocol == USB_UAS_PROTOCOL))
+        {
+          InSetting                = TRUE;
+          UsbUas->AlternateSetting = IfDesc->AlternateSetting;
+        }
+
+        break;
+
+      case USB_DESC_TYPE_ENDPOINT:
+        EpDesc   = (EFI_USB_ENDPOINT_DESCRIPTOR *)(Buffer + Offset);
+        Endpoint = 0;
+        if (InSetting && (Buffer[Offset] >= sizeof (EFI_USB_ENDPOINT_DESCRIPTOR)) &&
+            ((EpDesc->Attributes & (BIT0 | BIT1)) == USB_ENDPOINT_BULK))
+        {
+          Endpoint   = EpDesc->EndpointAddress;
+          PacketSize = ReadUnaligned16 (&EpDesc->MaxPacketSize);
+        }
+
+        break;
+
+      case USB_UAS_DESC_TYPE_PIPE_USAGE:
+        if (!InSetting || (Endpoint == 0) || (Buffer[Offset] < 3)) {
+          break;
+        }
+
+        switch (Buffer[Offset + 2]) {
+          case USB_UAS_PIPE_COMMAND:
+            UsbUas->CommandEndpoint = Endpoint;
+            break;
+          case USB_UAS_PIPE_STATUS:
+            UsbUas->StatusEndpoint = Endpoint;
+            break;
+          case USB_UAS_PIPE_DATA_IN:
+            UsbUas->DataInEndpoint = Endpoint;
+            *MaxPacketSize         = PacketSize;
+            break;
+          case USB_UAS_PIPE_DATA_OUT:
+            UsbUas->DataOutEndpoint = Endpoint;
+            break;
+          default:
+            break;
+        }
+
+        break;
+
+      default:
+        break;
+    }
+
+    Offset += Buffer[Offset];
+  }
+
+  if ((UsbUas->CommandEndpoint == 0) || (UsbUas->StatusEndpoint == 0) ||
+      (UsbUas->DataInEndpoint == 0) || (UsbUas->DataOutEndpoint == 0))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Find the UAS alternate setting of the interface of the USB I/O Protocol.
+
+  @param  UsbIo                 The USB I/O Protocol instance.
+  @param  UsbUas                The USB UAS device. On output, its interface,
+                                alternate setting and endpoints are filled.
+  @param  MaxPacketSize         The maximum packet size of the data-in pipe.
+
+  @retval EFI_SUCCESS           The UAS alternate setting is found.
+  @retval EFI_UNSUPPORTED       The interface has no UAS alternate setting.
+  @retval Others                The descriptors can't be read.
+
+**/
+EFI_STATUS
+UsbUasFindInterface (
+  IN     EFI_USB_IO_PROTOCOL  *UsbIo,
+  IN OUT USB_UAS_DEVICE       *UsbUas,
+  OUT    UINT16               *MaxPacketSize
+  )
+{
+  EFI_USB_INTERFACE_DESCRIPTOR  Interface;
+  UINT8                         *Buffer;
+  UINTN                         Length;
+  EFI_STATUS                    Status;
+
+  Status = UsbIo->UsbGetInterfaceDescriptor (UsbIo, &Interface);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // The alternate setting 0 of a UAS device is usually the Bulk-Only
+  // Transport, it has the mass storage class anyway.
+  //
+  if (Interface.InterfaceClass != USB_UAS_CLASS) {
+    return EFI_UNSUPPORTED;
+  }
+
+  UsbUas->InterfaceNumber = Interface.InterfaceNumber;
+
+  Status = UsbUasGetConfigDescriptor (UsbIo, &Buffer, &Length);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = UsbUasParseInterface (UsbUas, Buffer, Length, MaxPacketSize);
+  FreePool (Buffer);
+  return Status;
+}
+
+/**
+  Read the LUNs of the device with REPORT LUNS. The device has at least the
+  LUN 0.
+
+  @param  UsbUas                The USB UAS device.
+
+**/
+VOID
+UsbUasDiscoverLuns (
+  IN USB_UAS_DEVICE  *UsbUas
+  )
+{
+  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  Packet;
+  UINT8                                       Cdb[12];
+  UINT8                                       Target[TARGET_MAX_BYTES];
+  UINT8                                       SenseData[sizeof (EFI_SCSI_SENSE_DATA)];
+  UINT8                                       *Data;
+  UINT32                                      DataLength;
+  UINT32                                      ListLength;
+  UINT8                                       *Entry;
+  UINT16                                      Lun;
+  UINTN                                       Index;
+  UINTN                                       Retry;
+  EFI_STATUS                                  Status;
+
+  UsbUas->LunCount = 1;
+  UsbUas->Luns[0]  = 0;
+
+  DataLength = USB_UAS_REPORT_LUNS_HEADER_LEN + USB_UAS_MAX_LUNS * 8;
+  Data       = AllocateZeroPool (DataLength);
+  if (Data == NULL) {
+    return;
+  }
+
+  ZeroMem (Cdb, sizeof (Cdb));
+  Cdb[0] = USB_UAS_OP_REPORT_LUNS;
+  WriteUnaligned32 ((UINT32 *)&Cdb[6], SwapBytes32 (DataLength));
+
+  ZeroMem (Target, sizeof (Target));
+
+  //
+  // The first command after a reset may report a UNIT ATTENTION, retry it.
+  //
+  for (Retry = 0; Retry < 3; Retry++) {
+    ZeroMem (&Packet, sizeof (Packet));
+    Packet.Timeout          = EFI_TIMER_PERIOD_SECONDS (3);
+    Packet.Cdb              = Cdb;
+    Packet.CdbLength        = sizeof (Cdb);
+    Packet.InDataBuffer     = Data;
+    Packet.InTransferLength = DataLength;
+    Packet.SenseData        = SenseData;
+    Packet.SenseDataLength  = sizeof (SenseData);
+    Packet.DataDirection    = EFI_EXT_SCSI_DATA_DIRECTION_READ;
+
+    Status = UsbUasPassThru (&UsbUas->ExtScsiPassThru, Target, 0, &Packet, NULL);
+    if (!EFI_ERROR (Status) && (Packet.TargetStatus == EFI_EXT_SCSI_STATUS_TARGET_GOOD)) {
+      break;
+    }
+  }
+
+  if ((Retry == 3) || (Packet.InTransferLength < USB_UAS_REPORT_LUNS_HEADER_LEN)) {
+    DEBUG ((DEBUG_INFO, "UsbUasDiscoverLuns: REPORT LUNS failed, use LUN 0\n"));
+    FreePool (Data);
+    return;
+  }
+
+  ListLength = SwapBytes32 (ReadUnaligned32 ((UINT32 *)Data));
+  ListLength = MIN (ListLength, Packet.InTransferLength - USB_UAS_REPORT_LUNS_HEADER_LEN);
+
+  UsbUas->LunCount = 0;
+  for (Index = 0; Index + 8 <= ListLength; Index += 8) {
+    Entry = Data + USB_UAS_REPORT_LUNS_HEADER_LEN + Index;
+    if (Entry[0] == 0) {
+      //
+      // Peripheral device addressing method
+      //
+      Lun = Entry[1];
+    } else if ((Entry[0] & (BIT7 | BIT6)) == BIT6) {
+      //
+      // Flat space addressing method
+      //
+      Lun = (UINT16)(((Entry[0] & 0x3F) << 8) | Entry[1]);
+    } else {
+      continue;
+    }
+
+    if (UsbUas->LunCount < USB_UAS_MAX_LUNS) {
+      UsbUas->Luns[UsbUas->LunCount++] = Lun;
+    }
+  }
+
+  if (UsbUas->LunCount == 0) {
+    UsbUas->LunCount = 1;
+    UsbUas->Luns[0]  = 0;
+  }
+
+  DEBUG ((DEBUG_INFO, "UsbUasDiscoverLuns: %d LUNs\n", UsbUas->LunCount));
+  FreePool (Data);
+}
+
+/**
+  Check whether the controller is a USB interface with a UAS alternate setting.
+
+  @param  This                   The USB UAS driver binding protocol.
+  @param  Controller             The controller handle to check.
+  @param  RemainingDevicePath    The remaining device path.
+
+  @retval EFI_SUCCESS            The driver supports this controller.
+  @retval other                  This device isn't supported.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasDriverBindingSupported (
+  IN EFI_DRIVER_BINDING_PROTOCOL  *This,
+  IN EFI_HANDLE                   Controller,
+  IN EFI_DEVICE_PATH_PROTOCOL     *RemainingDevicePath
+  )
+{
+  EFI_USB_IO_PROTOCOL  *UsbIo;
+  USB_UAS_DEVICE       UsbUas;
+  UINT16               MaxPacketSize;
+  EFI_STATUS           Status;
+
+  Status = gBS->OpenProtocol (
+                  Controller,
+                  &gEfiUsbIoProtocolGuid,
+                  (VOID **)&UsbIo,
+                  This->DriverBindingHandle,
+                  Controller,
+                  EFI_OPEN_PROTOCOL_BY_DRIVER
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  ZeroMem (&UsbUas, sizeof (UsbUas));
+  Status = UsbUasFindInterface (UsbIo, &UsbUas, &MaxPacketSize);
+
+  gBS->CloseProtocol (
+         Controller,
+         &gEfiUsbIoProtocolGuid,
+         This->DriverBindingHandle,
+         Controller
+         );
+
+  return Status;
+}
+
+/**
+  Free the resources of the USB UAS device, restore the alternate setting of
+  the interface and close the protocols opened by Start().
+
+  @param  This                  The USB UAS driver binding protocol.
+  @param  UsbUas                The USB UAS device.
+  @param  OriginalSetting       The alternate setting before Start().
+
+**/
+VOID
+UsbUasCleanUp (
+  IN EFI_DRIVER_BINDING_PROTOCOL  *This,
+  IN USB_UAS_DEVICE               *UsbUas,
+  IN UINT8                        OriginalSetting
+  )
+{
+  EDKII_USB_STREAMS_PROTOCOL  *UsbStreams;
+  UINT32                      Result;
+
+  if (UsbUas->TimerEvent != NULL) {
+    gBS->CloseEvent (UsbUas->TimerEvent);
+  }
+
+  UsbStreams = UsbUas->UsbStreams;
+  if (UsbStreams != NULL) {
+    if (UsbUas->Requests != NULL) {
+      UsbUasAbortAllRequests (UsbUas);
+    }
+
+    UsbStreams->FreeStreams (UsbStreams, UsbUas->StatusEndpoint);
+    UsbStreams->FreeStreams (UsbStreams, UsbUas->DataInEndpoint);
+    UsbStreams->FreeStreams (UsbStreams, UsbUas->DataOutEndpoint);
+
+    gBS->CloseProtocol (
+           UsbUas->Controller,
+           &gEdkiiUsbStreamsProtocolGuid,
+           This->DriverBindingHandle,
+           UsbUas->Controller
+           );
+  }
+
+  //
+  // Let the USB mass storage driver drive the Bulk-Only Transport again.
+  //
+  if (UsbUas->AlternateSetting != OriginalSetting) {
+    UsbSetInterface (UsbUas->UsbIo, UsbUas->InterfaceNumber, OriginalSetting, &Result);
+  }
+
+  if (UsbUas->Requests != NULL) {
+    FreePool (UsbUas->Requests);
+  }
+
+  FreePool (UsbUas);
+}
+
+/**
+  Start the USB UAS device: select the UAS alternate setting, allocate the
+  streams of the pipes and install the Extended SCSI Pass Thru Protocol.
+
+  @param  This                  The USB UAS driver binding protocol.
+  @param  Controller            The USB UAS device to start on.
+  @param  RemainingDevicePath   The remaining device path.
+
+  @retval EFI_SUCCESS           This driver supports this device.
+  @retval EFI_UNSUPPORTED       This driver does not support this device.
+  @retval EFI_DEVICE_ERROR      This driver cannot be started due to device Error.
+  @retval EFI_OUT_OF_RESOURCES  Can't allocate memory resources.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasDriverBindingStart (
+  IN EFI_DRIVER_BINDING_PROTOCOL  *This,
+  IN EFI_HANDLE                   Controller,
+  IN EFI_DEVICE_PATH_PROTOCOL     *RemainingDevicePath
+  )
+{
+  EFI_USB_IO_PROTOCOL           *UsbIo;
+  EFI_USB_INTERFACE_DESCRIPTOR  Interface;
+  USB_UAS_DEVICE                *UsbUas;
+  EDKII_USB_STREAMS_PROTOCOL    *UsbStreams;
+  UINT16                        MaxPacketSize;
+  UINT16                        StreamCount;
+  UINT8                         OriginalSetting;
+  UINT8                         UasSetting;
+  UINT32                        Result;
+  EFI_STATUS                    Status;
+
+  Status = gBS->OpenProtocol (
+                  Controller,
+                  &gEfiUsbIoProtocolGuid,
+                  (VOID **)&UsbIo,
+                  This->DriverBindingHandle,
+                  Controller,
+                  EFI_OPEN_PROTOCOL_BY_DRIVER
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  UsbUas = AllocateZeroPool (sizeof (USB_UAS_DEVICE));
+  if (UsbUas == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_CLOSE;
+  }
+
+  UsbUas->Signature  = USB_UAS_SIGNATURE;
+  UsbUas->Controller = Controller;
+  UsbUas->UsbIo      = UsbIo;
+
+  Status = UsbIo->UsbGetInterfaceDescriptor (UsbIo, &Interface);
+  if (EFI_ERROR (Status)) {
+    FreePool (UsbUas);
+    goto ON_CLOSE;
+  }
+
+  OriginalSetting = Interface.AlternateSetting;
+
+  Status = UsbUasFindInterface (UsbIo, UsbUas, &MaxPacketSize);
+  if (EFI_ERROR (Status)) {
+    FreePool (UsbUas);
+    goto ON_CLOSE;
+  }
+
+  //
+  // AlternateSetting tracks the setting selected on the device, for the clean up.
+  //
+  UasSetting               = UsbUas->AlternateSetting;
+  UsbUas->AlternateSetting = OriginalSetting;
+
+  //
+  // A SuperSpeed device runs UAS over streams only. A high speed device has no
+  // streams and runs the commands one by one, even if the USB bus driver also
+  // produces the streams protocol for its queued bulk transfers.
+  //
+  UsbStreams = NULL;
+  if (MaxPacketSize > 512) {
+    Status = gBS->OpenProtocol (
+                    Controller,
+                    &gEdkiiUsbStreamsProtocolGuid,
+                    (VOID **)&UsbStreams,
+                    This->DriverBindingHandle,
+                    Controller,
+                    EFI_OPEN_PROTOCOL_BY_DRIVER
+                    );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_INFO, "UsbUasStart: no streams for SuperSpeed device, fall back to BOT\n"));
+      Status = EFI_UNSUPPORTED;
+      UsbUasCleanUp (This, UsbUas, OriginalSetting);
+      goto ON_CLOSE;
+    }
+
+    UsbUas->UsbStreams = UsbStreams;
+  }
+
+  //
+  // Select the UAS alternate setting. The USB bus driver configures its
+  // endpoints in the host controller.
+  //
+  if (UasSetting != OriginalSetting) {
+    Status = UsbSetInterface (UsbIo, UsbUas->InterfaceNumber, UasSetting, &Result);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "UsbUasStart: failed to select the UAS setting - %r\n", Status));
+      goto ON_ERROR;
+    }
+
+    UsbUas->AlternateSetting = UasSetting;
+  }
+
+  if (UsbStreams != NULL) {
+    UsbUas->TagCount = USB_UAS_MAX_TAGS;
+
+    StreamCount      = UsbUas->TagCount;
+    Status           = UsbStreams->AllocateStreams (UsbStreams, UsbUas->StatusEndpoint, &StreamCount);
+    UsbUas->TagCount = MIN (UsbUas->TagCount, StreamCount);
+
+    if (!EFI_ERROR (Status)) {
+      StreamCount      = UsbUas->TagCount;
+      Status           = UsbStreams->AllocateStreams (UsbStreams, UsbUas->DataInEndpoint, &StreamCount);
+      UsbUas->TagCount = MIN (UsbUas->TagCount, StreamCount);
+    }
+
+    if (!EFI_ERROR (Status)) {
+      StreamCount      = UsbUas->TagCount;
+      Status           = UsbStreams->AllocateStreams (UsbStreams, UsbUas->DataOutEndpoint, &StreamCount);
+      UsbUas->TagCount = MIN (UsbUas->TagCount, StreamCount);
+    }
+
+    if (EFI_ERROR (Status) || (UsbUas->TagCount == 0)) {
+      DEBUG ((DEBUG_ERROR, "UsbUasStart: failed to allocate the streams - %r\n", Status));
+      Status = EFI_DEVICE_ERROR;
+      goto ON_ERROR;
+    }
+  } else {
+    UsbUas->TagCount = 1;
+  }
+
+  UsbUas->Requests = AllocateZeroPool (UsbUas->TagCount * sizeof (USB_UAS_REQUEST));
+  if (UsbUas->Requests == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto ON_ERROR;
+  }
+
+  UsbUas->ExtScsiPassThruMode.AdapterId  = 0xFFFFFFFF;
+  UsbUas->ExtScsiPassThruMode.Attributes = EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_PHYSICAL |
+                                           EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_LOGICAL;
+  if (UsbStreams != NULL) {
+    UsbUas->ExtScsiPassThruMode.Attributes |= EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_NONBLOCKIO;
+  }
+
+  UsbUas->ExtScsiPassThruMode.IoAlign = 0;
+
+  UsbUas->ExtScsiPassThru.Mode             = &UsbUas->ExtScsiPassThruMode;
+  UsbUas->ExtScsiPassThru.PassThru         = UsbUasPassThru;
+  UsbUas->ExtScsiPassThru.GetNextTargetLun = UsbUasGetNextTargetLun;
+  UsbUas->ExtScsiPassThru.BuildDevicePath  = UsbUasBuildDevicePath;
+  UsbUas->ExtScsiPassThru.GetTargetLun     = UsbUasGetTargetLun;
+  UsbUas->ExtScsiPassThru.ResetChannel     = UsbUasResetChannel;
+  UsbUas->ExtScsiPassThru.ResetTargetLun   = UsbUasResetTargetLun;
+  UsbUas->ExtScsiPassThru.GetNextTarget    = UsbUasGetNextTarget;
+
+  if (UsbStreams != NULL) {
+    Status = gBS->CreateEvent (
+                    EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                    USB_UAS_TPL,
+                    UsbUasCheckTimeout,
+                    UsbUas,
+                    &UsbUas->TimerEvent
+                    );
+    if (EFI_ERROR (Status)) {
+      goto ON_ERROR;
+    }
+
+    Status = gBS->SetTimer (UsbUas->TimerEvent, TimerPeriodic, USB_UAS_TIMER_INTERVAL);
+    if (EFI_ERROR (Status)) {
+      goto ON_ERROR;
+    }
+  }
+
+  UsbUasDiscoverLuns (UsbUas);
+
+  Status = gBS->InstallProtocolInterface (
+                  &Controller,
+                  &gEfiExtScsiPassThruProtocolGuid,
+                  EFI_NATIVE_INTERFACE,
+                  &UsbUas->ExtScsiPassThru
+                  );
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "UsbUasStart: UAS setting %d, %d tags, %a\n",
+    UsbUas->AlternateSetting,
+    UsbUas->TagCount,
+    (UsbStreams != NULL) ? "streams" : "no streams"
+    ));
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  UsbUasCleanUp (This, UsbUas, OriginalSetting);
+
+ON_CLOSE:
+  gBS->CloseProtocol (
+         Controller,
+         &gEfiUsbIoProtocolGuid,
+         This->DriverBindingHandle,
+         Controller
+         );
+  return Status;
+}
+
+/**
+  Stop the USB UAS device and restore the alternate setting 0 of the interface.
+
+  @param  This                  The USB UAS driver binding protocol.
+  @param  Controller            The controller to release.
+  @param  NumberOfChildren      The number of handles in ChildHandleBuffer.
+  @param  ChildHandleBuffer     The array of child handle.
+
+  @retval EFI_SUCCESS           The controller is stopped.
+  @retval Others                Failed to stop the controller.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasDriverBindingStop (
+  IN  EFI_DRIVER_BINDING_PROTOCOL  *This,
+  IN  EFI_HANDLE                   Controller,
+  IN  UINTN                        NumberOfChildren,
+  IN  EFI_HANDLE                   *ChildHandleBuffer
+  )
+{
+  EFI_EXT_SCSI_PASS_THRU_PROTOCOL  *ExtScsiPassThru;
+  USB_UAS_DEVICE                   *UsbUas;
+  EFI_STATUS                       Status;
+
+  Status = gBS->OpenProtocol (
+                  Controller,
+                  &gEfiExtScsiPassThruProtocolGuid,
+                  (VOID **)&ExtScsiPassThru,
+                  This->DriverBindingHandle,
+                  Controller,
+                  EFI_OPEN_PROTOCOL_GET_PROTOCOL
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  UsbUas = USB_UAS_DEVICE_FROM_PASS_THRU (ExtScsiPassThru);
+
+  Status = gBS->UninstallProtocolInterface (
+                  Controller,
+                  &gEfiExtScsiPassThruProtocolGuid,
+                  &UsbUas->ExtScsiPassThru
+                  );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // The alternate setting 0 is the Bulk-Only Transport of the UAS devices.
+  //
+  UsbUasCleanUp (This, UsbUas, 0);
+
+  gBS->CloseProtocol (
+         Controller,
+         &gEfiUsbIoProtocolGuid,
+         This->DriverBindingHandle,
+         Controller
+         );
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Entrypoint of the USB UAS driver.
+
+  @param  ImageHandle           The firmware allocated handle for the UEFI image.
+  @param  SystemTable           A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS           The driver binding and component name protocols are installed.
+  @retval Others                Some error occurs when executing this entry point.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasEntryPoint (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  return EfiLibInstallDriverBindingComponentName2 (
+           ImageHandle,
+           SystemTable,
+           &gUsbUasDriverBinding,
+           ImageHandle,
+           &gUsbUasComponentName,
+           &gUsbUasComponentName2
+           );
+}
@@ -0,0 +1,678 @@
+/** @file
+  Definitions of the USB Attached SCSI driver, based on the "Universal Serial
+  Bus Mass Storage Class - USB Attached SCSI Protocol (UASP)" Revision 1.0 and
+  the T10 "USB Attached SCSI - 2 (UAS-2)".
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#pragma once
+
+#include <Uefi.h>
+#include <IndustryStandard/Scsi.h>
+#include <Protocol/UsbIo.h>
+#include <Protocol/UsbStreams.h>
+#include <Protocol/ScsiPassThruExt.h>
+#include <Protocol/DevicePath.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/UefiDriverEntryPoint.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+#include <Library/UefiUsbLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/DevicePathLib.h>
+
+#define USB_UAS_SIGNATURE  SIGNATURE_32 ('U', 's', 'b', 'U')
+
+#define USB_UAS_DEVICE_FROM_PASS_THRU(a) \
+        CR (a, USB_UAS_DEVICE, ExtScsiPassThru, USB_UAS_SIGNATURE)
+
+//
+// The interface of a UAS device. Its alternate setting 0 is usually the
+// Bulk-Only Transport of the same device.
+//
+#define USB_UAS_CLASS     0x08
+#define USB_UAS_SUBCLASS  0x06  ///< SCSI transparent command set
+#define USB_UAS_PROTOCOL  0x62
+
+//
+// The Pipe Usage descriptor follows each endpoint descriptor of the UAS
+// alternate setting and tells what the endpoint is used for.
+//
+#define USB_UAS_DESC_TYPE_PIPE_USAGE  0x24
+#define USB_UAS_PIPE_COMMAND          0x01
+#define USB_UAS_PIPE_STATUS           0x02
+#define USB_UAS_PIPE_DATA_IN          0x03
+#define USB_UAS_PIPE_DATA_OUT         0x04
+
+//
+// Information Unit IDs
+//
+#define USB_UAS_IU_COMMAND          0x01
+#define USB_UAS_IU_SENSE            0x03
+#define USB_UAS_IU_RESPONSE         0x04
+#define USB_UAS_IU_TASK_MANAGEMENT  0x05
+#define USB_UAS_IU_READ_READY       0x06
+#define USB_UAS_IU_WRITE_READY      0x07
+
+//
+// Task management functions and response codes
+//
+#define USB_UAS_TMF_LOGICAL_UNIT_RESET  0x08
+#define USB_UAS_TMF_I_T_NEXUS_RESET     0x10
+#define USB_UAS_RC_TMF_COMPLETE         0x00
+#define USB_UAS_RC_TMF_SUCCEEDED        0x08
+
+//
+// The tag of a command is the stream of its status and data when the
+// device is attached to a SuperSpeed port, so the number of commands in
+// flight is bounded by the number of streams allocated. A device on a
+// high speed port takes one command at a time.
+//
+#define USB_UAS_MAX_TAGS  16
+
+//
+// REPORT LUNS command, answered with a 8 bytes header and a 8 bytes entry per LUN
+//
+#define USB_UAS_OP_REPORT_LUNS          0xA0
+#define USB_UAS_REPORT_LUNS_HEADER_LEN  8
+
+#define USB_UAS_MAX_LUNS             32
+#define USB_UAS_MAX_CDB_LENGTH       16
+#define USB_UAS_MAX_SENSE_LENGTH     252
+#define USB_UAS_MAX_TRANSFER_LENGTH  SIZE_2MB
+
+#define USB_UAS_1_MILLISECOND  1000
+#define USB_UAS_1_SECOND       (1000 * USB_UAS_1_MILLISECOND)
+
+//
+// The timeout of the information units sent on the command pipe and of the
+// task management functions, set by experience.
+//
+#define USB_UAS_IU_TIMEOUT   (3 * USB_UAS_1_SECOND)
+#define USB_UAS_TMF_TIMEOUT  (10 * USB_UAS_1_SECOND)
+
+//
+// The interval of the timer checking the timeout of the nonblocking requests,
+// and the interval of the polling of the blocking requests, in 100ns units.
+//
+#define USB_UAS_TIMER_INTERVAL  EFI_TIMER_PERIOD_MILLISECONDS (10)
+#define USB_UAS_POLL_INTERVAL   EFI_TIMER_PERIOD_MICROSECONDS (10)
+
+#define USB_UAS_TPL  TPL_NOTIFY
+
+#pragma pack(1)
+///
+/// The header of all the information units. The tag is big endian.
+///
+typedef struct {
+  UINT8     IuId;
+  UINT8     Reserved;
+  UINT16    Tag;
+} USB_UAS_IU_HEADER;
+
+///
+/// The Command IU, sent on the command pipe.
+///
+typedef struct {
+  USB_UAS_IU_HEADER    Header;
+  UINT8                Attribute;       ///< Bits 0~2 task attribute, 0 ~ SIMPLE
+  UINT8                Reserved1;
+  UINT8                AddCdbLength;    ///< Bits 2~7, in dwords
+  UINT8                Reserved2;
+  UINT8                Lun[8];
+  UINT8                Cdb[USB_UAS_MAX_CDB_LENGTH];
+} USB_UAS_COMMAND_IU;
+
+///
+/// The Task Management IU, sent on the command pipe.
+///
+typedef struct {
+  USB_UAS_IU_HEADER    Header;
+  UINT8                Function;
+  UINT8                Reserved;
+  UINT16               TaskTag;
+  UINT8                Lun[8];
+} USB_UAS_TASK_MANAGEMENT_IU;
+
+///
+/// The Sense IU, received on the status pipe when a command is completed.
+/// The sense data length is big endian.
+///
+typedef struct {
+  USB_UAS_IU_HEADER    Header;
+  UINT16               StatusQualifier;
+  UINT8                Status;
+  UINT8                Reserved[7];
+  UINT16               SenseDataLength;
+  UINT8                SenseData[USB_UAS_MAX_SENSE_LENGTH];
+} USB_UAS_SENSE_IU;
+
+///
+/// The Response IU, received on the status pipe when a task management
+/// function is completed, or when a Command IU is rejected.
+///
+typedef struct {
+  USB_UAS_IU_HEADER    Header;
+  UINT8                AdditionalInfo[3];
+  UINT8                ResponseCode;
+} USB_UAS_RESPONSE_IU;
+
+typedef union {
+  USB_UAS_IU_HEADER             Header;
+  USB_UAS_COMMAND_IU            Command;
+  USB_UAS_TASK_MANAGEMENT_IU    TaskManagement;
+} USB_UAS_REQUEST_IU;
+
+typedef union {
+  USB_UAS_IU_HEADER      Header;
+  USB_UAS_SENSE_IU       Sense;
+  USB_UAS_RESPONSE_IU    Response;
+} USB_UAS_STATUS_IU;
+#pragma pack()
+
+typedef struct _USB_UAS_DEVICE USB_UAS_DEVICE;
+
+///
+/// A command or task management function in flight, identified by its tag.
+///
+typedef struct {
+  USB_UAS_DEVICE                                *Device;
+  UINT16                                        Tag;
+  BOOLEAN                                       InUse;
+  //
+  // The transfers of the status and data submitted to the streams and
+  // not yet called back. The request is completed once both are clear.
+  //
+  BOOLEAN                                       StatusPending;
+  BOOLEAN                                       DataPending;
+  BOOLEAN                                       Aborted;
+  BOOLEAN                                       Done;
+  //
+  // Released by its owner while a transfer is still to be called back.
+  //
+  BOOLEAN                                       Orphaned;
+
+  USB_UAS_REQUEST_IU                            Iu;
+  UINTN                                         IuLength;
+  USB_UAS_STATUS_IU                             StatusIu;
+  UINTN                                         StatusLength;
+  UINT32                                        StatusResult;
+
+  UINT8                                         DataEndpoint;
+  VOID                                          *Data;
+  UINT32                                        DataLength;
+  UINTN                                         Transferred;
+  UINT32                                        DataResult;
+
+  //
+  // The remaining time of a nonblocking request in 100ns units, 0 if the
+  // caller waits forever.
+  //
+  UINT64                                        TimeLeft;
+  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET    *Packet;
+  EFI_EVENT                                     Event;
+  EFI_STATUS                                    Status;
+} USB_UAS_REQUEST;
+
+struct _USB_UAS_DEVICE {
+  UINT32                             Signature;
+  EFI_HANDLE                         Controller;
+  EFI_USB_IO_PROTOCOL                *UsbIo;
+  EDKII_USB_STREAMS_PROTOCOL         *UsbStreams;    ///< NULL if the device runs without streams
+  EFI_EXT_SCSI_PASS_THRU_PROTOCOL    ExtScsiPassThru;
+  EFI_EXT_SCSI_PASS_THRU_MODE        ExtScsiPassThruMode;
+
+  UINT8                              InterfaceNumber;
+  UINT8                              AlternateSetting;
+  UINT8                              CommandEndpoint;
+  UINT8                              StatusEndpoint;
+  UINT8                              DataInEndpoint;
+  UINT8                              DataOutEndpoint;
+
+  UINT16                             TagCount;
+  USB_UAS_REQUEST                    *Requests;      ///< Requests[Tag - 1]
+  EFI_EVENT                          TimerEvent;
+
+  UINT16                             LunCount;
+  UINT16                             Luns[USB_UAS_MAX_LUNS];
+};
+
+extern EFI_DRIVER_BINDING_PROTOCOL  gUsbUasDriverBinding;
+extern EFI_COMPONENT_NAME_PROTOCOL   gUsbUasComponentName;
+extern EFI_COMPONENT_NAME2_PROTOCOL  gUsbUasComponentName2;
+
+//
+// Functions of the information unit transport
+//
+
+/**
+  Allocate a free tag of the device.
+
+  @param  UsbUas                The USB UAS device.
+
+  @return The request of the tag, or NULL if all the tags are in use.
+
+**/
+USB_UAS_REQUEST *
+UsbUasAllocateRequest (
+  IN USB_UAS_DEVICE  *UsbUas
+  );
+
+/**
+  Release the tag of a request. If a transfer of the request is still to be
+  called back, the tag is released by the callback.
+
+  @param  Request               The request to release.
+
+**/
+VOID
+UsbUasReleaseRequest (
+  IN USB_UAS_REQUEST  *Request
+  );
+
+/**
+  Build the Command IU of a SCSI request packet in the request.
+
+  @param  Request               The request holding the Command IU.
+  @param  Lun                   The LUN of the command.
+  @param  Packet                The SCSI request packet.
+
+**/
+VOID
+UsbUasBuildCommand (
+  IN USB_UAS_REQUEST                             *Request,
+  IN UINT16                                      Lun,
+  IN EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet
+  );
+
+/**
+  Build the Task Management IU in the request.
+
+  @param  Request               The request holding the Task Management IU.
+  @param  Lun                   The LUN of the function.
+  @param  Function              The task management function.
+
+**/
+VOID
+UsbUasBuildTaskManagement (
+  IN USB_UAS_REQUEST  *Request,
+  IN UINT16           Lun,
+  IN UINT8            Function
+  );
+
+/**
+  Submit the request to the device.
+
+  With streams, the status and data transfers are queued on the stream of the
+  tag before the IU is sent, and the request is completed by their callbacks.
+  Without streams, the request is executed to the end before returning.
+
+  @param  Request               The request to submit.
+  @param  Timeout               The timeout of the request in 100ns units, 0 to
+                                wait forever.
+
+  @retval EFI_SUCCESS           The request is submitted.
+  @retval EFI_DEVICE_ERROR      The request can't be sent to the device.
+  @retval Others                The transfers can't be queued.
+
+**/
+EFI_STATUS
+UsbUasSubmitRequest (
+  IN USB_UAS_REQUEST  *Request,
+  IN UINT64           Timeout
+  );
+
+/**
+  Wait for a submitted request to complete.
+
+  @param  Request               The request to wait for.
+  @param  Timeout               The timeout of the request in 100ns units, 0 to
+                                wait forever.
+
+  @retval EFI_SUCCESS           The request is completed, Request->Status is its result.
+  @retval EFI_TIMEOUT           The request is aborted after the timeout.
+
+**/
+EFI_STATUS
+UsbUasWaitRequest (
+  IN USB_UAS_REQUEST  *Request,
+  IN UINT64           Timeout
+  );
+
+/**
+  Abort the transfers of a request still in flight. The request is completed
+  once the transfers called back already are done.
+
+  @param  Request               The request to abort.
+
+**/
+VOID
+UsbUasAbortRequest (
+  IN USB_UAS_REQUEST  *Request
+  );
+
+/**
+  Abort all the requests in flight of the device.
+
+  @param  UsbUas                The USB UAS device.
+
+**/
+VOID
+UsbUasAbortAllRequests (
+  IN USB_UAS_DEVICE  *UsbUas
+  );
+
+/**
+  Timer callback to abort the nonblocking requests after their timeout.
+
+  @param  Event                 The timer event.
+  @param  Context               The USB UAS device.
+
+**/
+VOID
+EFIAPI
+UsbUasCheckTimeout (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  );
+
+/**
+  Send a task management function to the device and wait for its response.
+
+  @param  UsbUas                The USB UAS device.
+  @param  Lun                   The LUN of the function.
+  @param  Function              The task management function.
+
+  @retval EFI_SUCCESS           The function succeeded.
+  @retval EFI_NOT_READY         All the tags are in use.
+  @retval EFI_DEVICE_ERROR      The function failed.
+  @retval EFI_TIMEOUT           The device didn't respond.
+
+**/
+EFI_STATUS
+UsbUasTaskManagement (
+  IN USB_UAS_DEVICE  *UsbUas,
+  IN UINT16          Lun,
+  IN UINT8           Function
+  );
+
+//
+// Functions of the Extended SCSI Pass Thru Protocol
+//
+
+/**
+  Sends a SCSI Request Packet to a SCSI device that is attached to the SCSI channel.
+
+  @param  This                  A pointer to the EFI_EXT_SCSI_PASS_THRU_PROTOCOL instance.
+  @param  Target                The Target of the SCSI device.
+  @param  Lun                   The LUN of the SCSI device.
+  @param  Packet                A pointer to the SCSI Request Packet.
+  @param  Event                 If not NULL, the nonblocking I/O is performed and Event
+                                is signaled when the SCSI Request Packet completes.
+
+  @retval EFI_SUCCESS           The SCSI Request Packet was sent by the host.
+  @retval EFI_BAD_BUFFER_SIZE   The SCSI Request Packet was not executed. The number of
+                                bytes that could be transferred is returned.
+  @retval EFI_NOT_READY         Too many SCSI Request Packets are already in flight.
+  @retval EFI_DEVICE_ERROR      A device error occurred.
+  @retval EFI_INVALID_PARAMETER Target, Lun, or the contents of Packet are invalid.
+  @retval EFI_UNSUPPORTED       The command is not supported by the host adapter.
+  @retval EFI_TIMEOUT           A timeout occurred while waiting for the packet to execute.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasPassThru (
+  IN     EFI_EXT_SCSI_PASS_THRU_PROTOCOL             *This,
+  IN     UINT8                                       *Target,
+  IN     UINT64                                      Lun,
+  IN OUT EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet,
+  IN     EFI_EVENT                                   Event OPTIONAL
+  );
+
+/**
+  Used to retrieve the list of legal Target IDs and LUNs for SCSI devices on a SCSI channel.
+
+  @param  This                  A pointer to the EFI_EXT_SCSI_PASS_THRU_PROTOCOL instance.
+  @param  Target                On input, the previous Target ID. On output, the next Target ID.
+  @param  Lun                   On input, the previous LUN. On output, the next LUN.
+
+  @retval EFI_SUCCESS           The Target ID and LUN of the next SCSI device are returned.
+  @retval EFI_NOT_FOUND         There are no more SCSI devices on this SCSI channel.
+  @retval EFI_INVALID_PARAMETER Target or Lun is not valid.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasGetNextTargetLun (
+  IN     EFI_EXT_SCSI_PASS_THRU_PROTOCOL  *This,
+  IN OUT UINT8                            **Target,
+  IN OUT UINT64                           *Lun
+  );
+
+/**
+  Used to allocate and build a device path node for a SCSI device on a SCSI channel.
+
+  @param  This                  A pointer to the EFI_EXT_SCSI_PASS_THRU_PROTOCOL instance.
+  @param  Target                The Target of the SCSI device.
+  @param  Lun                   The LUN of the SCSI device.
+  @param  DevicePath            The device path node built.
+
+  @retval EFI_SUCCESS           The device path node is built.
+  @retval EFI_NOT_FOUND         The SCSI device doesn't exist.
+  @retval EFI_INVALID_PARAMETER DevicePath is NULL.
+  @retval EFI_OUT_OF_RESOURCES  There are not enough resources to allocate DevicePath.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasBuildDevicePath (
+  IN     EFI_EXT_SCSI_PASS_THRU_PROTOCOL  *This,
+  IN     UINT8                            *Target,
+  IN     UINT64                           Lun,
+  IN OUT EFI_DEVICE_PATH_PROTOCOL         **DevicePath
+  );
+
+/**
+  Used to translate a device path node to a Target ID and LUN.
+
+  @param  This                  A pointer to the EFI_EXT_SCSI_PASS_THRU_PROTOCOL instance.
+  @param  DevicePath            The device path node.
+  @param  Target                The Target ID of the SCSI device.
+  @param  Lun                   The LUN of the SCSI device.
+
+  @retval EFI_SUCCESS           DevicePath is translated.
+  @retval EFI_INVALID_PARAMETER DevicePath, Target or Lun is NULL.
+  @retval EFI_UNSUPPORTED       This driver doesn't support DevicePath.
+  @retval EFI_NOT_FOUND         The SCSI device doesn't exist.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasGetTargetLun (
+  IN  EFI_EXT_SCSI_PASS_THRU_PROTOCOL  *This,
+  IN  EFI_DEVICE_PATH_PROTOCOL         *DevicePath,
+  OUT UINT8                            **Target,
+  OUT UINT64                           *Lun
+  );
+
+/**
+  Resets a SCSI channel. The requests in flight are aborted and an I_T NEXUS
+  RESET is sent to the device.
+
+  @param  This                  A pointer to the EFI_EXT_SCSI_PASS_THRU_PROTOCOL instance.
+
+  @retval EFI_SUCCESS           The SCSI channel is reset.
+  @retval EFI_DEVICE_ERROR      A device error occurred while resetting the SCSI channel.
+  @retval EFI_TIMEOUT           A timeout occurred while resetting the SCSI channel.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasResetChannel (
+  IN EFI_EXT_SCSI_PASS_THRU_PROTOCOL  *This
+  );
+
+/**
+  Resets a SCSI logical unit that is connected to a SCSI channel.
+
+  @param  This                  A pointer to the EFI_EXT_SCSI_PASS_THRU_PROTOCOL instance.
+  @param  Target                The Target of the SCSI device.
+  @param  Lun                   The LUN of the SCSI device.
+
+  @retval EFI_SUCCESS           The SCSI device is reset.
+  @retval EFI_INVALID_PARAMETER Target or Lun is not valid.
+  @retval EFI_DEVICE_ERROR      A device error occurred while resetting the SCSI device.
+  @retval EFI_TIMEOUT           A timeout occurred while resetting the SCSI device.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasResetTargetLun (
+  IN EFI_EXT_SCSI_PASS_THRU_PROTOCOL  *This,
+  IN UINT8                            *Target,
+  IN UINT64                           Lun
+  );
+
+/**
+  Used to retrieve the list of legal Target IDs for SCSI devices on a SCSI channel.
+
+  @param  This                  A pointer to the EFI_EXT_SCSI_PASS_THRU_PROTOCOL instance.
+  @param  Target                On input, the previous Target ID. On output, the next Target ID.
+
+  @retval EFI_SUCCESS           The next Target ID is returned.
+  @retval EFI_NOT_FOUND         There are no more SCSI devices on this SCSI channel.
+  @retval EFI_INVALID_PARAMETER Target is not valid.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasGetNextTarget (
+  IN     EFI_EXT_SCSI_PASS_THRU_PROTOCOL  *This,
+  IN OUT UINT8                            **Target
+  );
+
+//
+// Functions for Driver Binding Protocol
+//
+
+/**
+  Check whether the controller is a USB interface with a UAS alternate setting.
+
+  @param  This                   The USB UAS driver binding protocol.
+  @param  Controller             The controller handle to check.
+  @param  RemainingDevicePath    The remaining device path.
+
+  @retval EFI_SUCCESS            The driver supports this controller.
+  @retval other                  This device isn't supported.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasDriverBindingSupported (
+  IN EFI_DRIVER_BINDING_PROTOCOL  *This,
+  IN EFI_HANDLE                   Controller,
+  IN EFI_DEVICE_PATH_PROTOCOL     *RemainingDevicePath
+  );
+
+/**
+  Start the USB UAS device: select the UAS alternate setting, allocate the
+  streams of the pipes and install the Extended SCSI Pass Thru Protocol.
+
+  @param  This                  The USB UAS driver binding protocol.
+  @param  Controller            The USB UAS device to start on.
+  @param  RemainingDevicePath   The remaining device path.
+
+  @retval EFI_SUCCESS           This driver supports this device.
+  @retval EFI_UNSUPPORTED       This driver does not support this device.
+  @retval EFI_DEVICE_ERROR      This driver cannot be started due to device Error.
+  @retval EFI_OUT_OF_RESOURCES  Can't allocate memory resources.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasDriverBindingStart (
+  IN EFI_DRIVER_BINDING_PROTOCOL  *This,
+  IN EFI_HANDLE                   Controller,
+  IN EFI_DEVICE_PATH_PROTOCOL     *RemainingDevicePath
+  );
+
+/**
+  Stop the USB UAS device and restore the alternate setting 0 of the interface.
+
+  @param  This                  The USB UAS driver binding protocol.
+  @param  Controller            The controller to release.
+  @param  NumberOfChildren      The number of handles in ChildHandleBuffer.
+  @param  ChildHandleBuffer     The array of child handle.
+
+  @retval EFI_SUCCESS           The controller is stopped.
+  @retval Others                Failed to stop the controller.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasDriverBindingStop (
+  IN  EFI_DRIVER_BINDING_PROTOCOL  *This,
+  IN  EFI_HANDLE                   Controller,
+  IN  UINTN                        NumberOfChildren,
+  IN  EFI_HANDLE                   *ChildHandleBuffer
+  );
+
+//
+// EFI Component Name Functions
+//
+
+/**
+  Retrieves a Unicode string that is the user readable name of the driver.
+
+  @param  This                  A pointer to the EFI_COMPONENT_NAME2_PROTOCOL or
+                                EFI_COMPONENT_NAME_PROTOCOL instance.
+  @param  Language              A pointer to a Null-terminated ASCII string
+                                array indicating the language.
+  @param  DriverName            A pointer to the Unicode string to return.
+
+  @retval EFI_SUCCESS           The Unicode string for the Driver is returned.
+  @retval EFI_INVALID_PARAMETER Language or DriverName is NULL.
+  @retval EFI_UNSUPPORTED       The driver does not support the language.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasGetDriverName (
+  IN  EFI_COMPONENT_NAME_PROTOCOL  *This,
+  IN  CHAR8                        *Language,
+  OUT CHAR16                       **DriverName
+  );
+
+/**
+  Retrieves a Unicode string that is the user readable name of the controller
+  that is being managed by a driver.
+
+  @param  This                  A pointer to the EFI_COMPONENT_NAME2_PROTOCOL or
+                                EFI_COMPONENT_NAME_PROTOCOL instance.
+  @param  ControllerHandle      The handle of a controller.
+  @param  ChildHandle           The handle of the child controller.
+  @param  Language              A pointer to a Null-terminated ASCII string
+                                array indicating the language.
+  @param  ControllerName        A pointer to the Unicode string to return.
+
+  @retval EFI_SUCCESS           The Unicode string for the controller is returned.
+  @retval EFI_INVALID_PARAMETER A parameter is invalid.
+  @retval EFI_UNSUPPORTED       The driver is not managing the controller, or
+                                does not support the language.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasGetControllerName (
+  IN  EFI_COMPONENT_NAME_PROTOCOL  *This,
+  IN  EFI_HANDLE                   ControllerHandle,
+  IN  EFI_HANDLE                   ChildHandle        OPTIONAL,
+  IN  CHAR8                        *Language,
+  OUT CHAR16                       **ControllerName
+  );
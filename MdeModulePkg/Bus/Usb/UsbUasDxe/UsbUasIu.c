@@ -0,0 +1,861 @@
+/** @file
+  Transport of the information units of the USB Attached SCSI protocol.
+
+  On a SuperSpeed port the tag of a command selects the stream of its data and
+  status, so the transfers of several commands are in flight at once and are
+  completed by the callbacks of the USB Streams Protocol. On a high speed port
+  the device is driven one command at a time, with the READ READY and WRITE
+  READY information units telling when the data phase starts.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "UsbUas.h"
+
+/**
+  Encode a LUN in the 8 bytes LUN field of an information unit, using the
+  peripheral device addressing method for LUNs below 256 and the flat space
+  addressing method for the others.
+
+  @param  Lun                   The LUN to encode.
+  @param  LunField              The LUN field of the information unit.
+
+**/
+VOID
+UsbUasEncodeLun (
+  IN  UINT16  Lun,
+  OUT UINT8   *LunField
+  )
+{
+  ZeroMem (LunField, 8);
+  if (Lun < 0x100) {
+    LunField[1] = (UINT8)Lun;
+  } else {
+    LunField[0] = (UINT8)(BIT6 | ((Lun >> 8) & 0x3F));
+    LunField[1] = (UINT8)Lun;
+  }
+}
+
+/**
+  Allocate a free tag of the device.
+
+  @param  UsbUas                The USB UAS device.
+
+  @return The request of the tag, or NULL if all the tags are in use.
+
+**/
+USB_UAS_REQUEST *
+UsbUasAllocateRequest (
+  IN USB_UAS_DEVICE  *UsbUas
+  )
+{
+  USB_UAS_REQUEST  *Request;
+  UINT16           Index;
+  EFI_TPL          OldTpl;
+
+  Request = NULL;
+  OldTpl  = gBS->RaiseTPL (USB_UAS_TPL);
+
+  for (Index = 0; Index < UsbUas->TagCount; Index++) {
+    if (!UsbUas->Requests[Index].InUse) {
+      Request = &UsbUas->Requests[Index];
+      ZeroMem (Request, sizeof (USB_UAS_REQUEST));
+      Request->Device = UsbUas;
+      Request->Tag    = (UINT16)(Index + 1);
+      Request->InUse  = TRUE;
+      break;
+    }
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  return Request;
+}
+
+/**
+  Remove the transfers of the request still queued on the streams. A transfer
+  that is finished but not yet called back can't be removed, its callback
+  follows.
+
+  The caller raises the TPL to USB_UAS_TPL.
+
+  @param  Request               The request.
+
+**/
+VOID
+UsbUasCancelTransfers (
+  IN USB_UAS_REQUEST  *Request
+  )
+{
+  USB_UAS_DEVICE              *UsbUas;
+  EDKII_USB_STREAMS_PROTOCOL  *UsbStreams;
+  EFI_STATUS                  Status;
+
+  UsbUas     = Request->Device;
+  UsbStreams = UsbUas->UsbStreams;
+  if (UsbStreams == NULL) {
+    return;
+  }
+
+  if (Request->StatusPending) {
+    Status = UsbStreams->CancelStreamTransfers (UsbStreams, UsbUas->StatusEndpoint, Request->Tag);
+    if (!EFI_ERROR (Status)) {
+      Request->StatusPending = FALSE;
+    }
+  }
+
+  if (Request->DataPending) {
+    Status = UsbStreams->CancelStreamTransfers (UsbStreams, Request->DataEndpoint, Request->Tag);
+    if (!EFI_ERROR (Status)) {
+      Request->DataPending = FALSE;
+    }
+  }
+}
+
+/**
+  Release the tag of a request. If a transfer of the request is still to be
+  called back, the tag is released by the callback.
+
+  @param  Request               The request to release.
+
+**/
+VOID
+UsbUasReleaseRequest (
+  IN USB_UAS_REQUEST  *Request
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl = gBS->RaiseTPL (USB_UAS_TPL);
+
+  UsbUasCancelTransfers (Request);
+  if (Request->StatusPending || Request->DataPending) {
+    Request->Packet   = NULL;
+    Request->Event    = NULL;
+    Request->Orphaned = TRUE;
+  } else {
+    Request->InUse = FALSE;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Build the Command IU of a SCSI request packet in the request.
+
+  @param  Request               The request holding the Command IU.
+  @param  Lun                   The LUN of the command.
+  @param  Packet                The SCSI request packet.
+
+**/
+VOID
+UsbUasBuildCommand (
+  IN USB_UAS_REQUEST                             *Request,
+  IN UINT16                                      Lun,
+  IN EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet
+  )
+{
+  USB_UAS_COMMAND_IU  *Command;
+
+  Command                  = &Request->Iu.Command;
+  Command->Header.IuId     = USB_UAS_IU_COMMAND;
+  Command->Header.Reserved = 0;
+  Command->Header.Tag      = SwapBytes16 (Request->Tag);
+  Command->Attribute       = 0;
+  Command->Reserved1       = 0;
+  Command->AddCdbLength    = 0;
+  Command->Reserved2       = 0;
+  UsbUasEncodeLun (Lun, Command->Lun);
+  ZeroMem (Command->Cdb, sizeof (Command->Cdb));
+  CopyMem (Command->Cdb, Packet->Cdb, Packet->CdbLength);
+
+  Request->IuLength = sizeof (USB_UAS_COMMAND_IU);
+  Request->Packet   = Packet;
+}
+
+/**
+  Build the Task Management IU in the request.
+
+  @param  Request               The request holding the Task Management IU.
+  @param  Lun                   The LUN of the function.
+  @param  Function              The task management function.
+
+**/
+VOID
+UsbUasBuildTaskManagement (
+  IN USB_UAS_REQUEST  *Request,
+  IN UINT16           Lun,
+  IN UINT8            Function
+  )
+{
+  USB_UAS_TASK_MANAGEMENT_IU  *TaskManagement;
+
+  TaskManagement                  = &Request->Iu.TaskManagement;
+  TaskManagement->Header.IuId     = USB_UAS_IU_TASK_MANAGEMENT;
+  TaskManagement->Header.Reserved = 0;
+  TaskManagement->Header.Tag      = SwapBytes16 (Request->Tag);
+  TaskManagement->Function        = Function;
+  TaskManagement->Reserved        = 0;
+  TaskManagement->TaskTag         = 0;
+  UsbUasEncodeLun (Lun, TaskManagement->Lun);
+
+  Request->IuLength = sizeof (USB_UAS_TASK_MANAGEMENT_IU);
+}
+
+/**
+  Fill the SCSI request packet with the result of the command.
+
+  @param  Request               The completed command.
+
+**/
+VOID
+UsbUasCompleteCommand (
+  IN USB_UAS_REQUEST  *Request
+  )
+{
+  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET  *Packet;
+  USB_UAS_SENSE_IU                            *Sense;
+  UINTN                                       SenseLength;
+
+  Packet = Request->Packet;
+  if (Packet == NULL) {
+    Request->Status = EFI_ABORTED;
+    return;
+  }
+
+  Packet->InTransferLength  = 0;
+  Packet->OutTransferLength = 0;
+  if (Request->DataEndpoint == Request->Device->DataInEndpoint) {
+    Packet->InTransferLength = (UINT32)Request->Transferred;
+  } else if (Request->DataEndpoint == Request->Device->DataOutEndpoint) {
+    Packet->OutTransferLength = (UINT32)Request->Transferred;
+  }
+
+  SenseLength               = Packet->SenseDataLength;
+  Packet->SenseDataLength   = 0;
+  Packet->HostAdapterStatus = EFI_EXT_SCSI_STATUS_HOST_ADAPTER_OK;
+  Packet->TargetStatus      = EFI_EXT_SCSI_STATUS_TARGET_GOOD;
+
+  if (Request->Aborted) {
+    Packet->HostAdapterStatus = EFI_EXT_SCSI_STATUS_HOST_ADAPTER_TIMEOUT_COMMAND;
+    Request->Status           = EFI_TIMEOUT;
+    return;
+  }
+
+  Sense = &Request->StatusIu.Sense;
+  if ((Request->StatusResult != EFI_USB_NOERROR) ||
+      (Request->StatusLength < OFFSET_OF (USB_UAS_SENSE_IU, SenseData)) ||
+      (Sense->Header.IuId != USB_UAS_IU_SENSE) ||
+      (SwapBytes16 (Sense->Header.Tag) != Request->Tag))
+  {
+    DEBUG ((
+      DEBUG_ERROR,
+      "UsbUasCompleteCommand: tag %d failed, result %x, IU %x\n",
+      Request->Tag,
+      Request->StatusResult,
+      Request->StatusIu.Header.IuId
+      ));
+    Packet->HostAdapterStatus = EFI_EXT_SCSI_STATUS_HOST_ADAPTER_OTHER;
+    Request->Status           = EFI_DEVICE_ERROR;
+    return;
+  }
+
+  Packet->TargetStatus = Sense->Status;
+
+  SenseLength = MIN (SenseLength, SwapBytes16 (Sense->SenseDataLength));
+  SenseLength = MIN (SenseLength, Request->StatusLength - OFFSET_OF (USB_UAS_SENSE_IU, SenseData));
+  if ((SenseLength != 0) && (Packet->SenseData != NULL)) {
+    CopyMem (Packet->SenseData, Sense->SenseData, SenseLength);
+    Packet->SenseDataLength = (UINT8)SenseLength;
+  }
+
+  if ((Request->DataResult != EFI_USB_NOERROR) && (Sense->Status == EFI_EXT_SCSI_STATUS_TARGET_GOOD)) {
+    Packet->HostAdapterStatus = EFI_EXT_SCSI_STATUS_HOST_ADAPTER_OTHER;
+    Request->Status           = EFI_DEVICE_ERROR;
+    return;
+  }
+
+  Request->Status = EFI_SUCCESS;
+}
+
+/**
+  Check the response of the task management function.
+
+  @param  Request               The completed task management function.
+
+**/
+VOID
+UsbUasCompleteTaskManagement (
+  IN USB_UAS_REQUEST  *Request
+  )
+{
+  USB_UAS_RESPONSE_IU  *Response;
+
+  if (Request->Aborted) {
+    Request->Status = EFI_TIMEOUT;
+    return;
+  }
+
+  Response = &Request->StatusIu.Response;
+  if ((Request->StatusResult != EFI_USB_NOERROR) ||
+      (Request->StatusLength < sizeof (USB_UAS_RESPONSE_IU)) ||
+      (Response->Header.IuId != USB_UAS_IU_RESPONSE) ||
+      (SwapBytes16 (Response->Header.Tag) != Request->Tag))
+  {
+    Request->Status = EFI_DEVICE_ERROR;
+    return;
+  }
+
+  if ((Response->ResponseCode != USB_UAS_RC_TMF_COMPLETE) &&
+      (Response->ResponseCode != USB_UAS_RC_TMF_SUCCEEDED))
+  {
+    DEBUG ((DEBUG_ERROR, "UsbUasCompleteTaskManagement: response code %x\n", Response->ResponseCode));
+    Request->Status = EFI_DEVICE_ERROR;
+    return;
+  }
+
+  Request->Status = EFI_SUCCESS;
+}
+
+/**
+  Complete the request once none of its transfers is pending. The event of a
+  nonblocking request is signaled, and its tag is released.
+
+  The caller raises the TPL to USB_UAS_TPL.
+
+  @param  Request               The request.
+
+**/
+VOID
+UsbUasTryComplete (
+  IN USB_UAS_REQUEST  *Request
+  )
+{
+  EFI_EVENT  Event;
+
+  if (Request->StatusPending || Request->DataPending) {
+    return;
+  }
+
+  if (!Request->Done) {
+    Request->Done = TRUE;
+    if (Request->Iu.Header.IuId == USB_UAS_IU_COMMAND) {
+      UsbUasCompleteCommand (Request);
+    } else {
+      UsbUasCompleteTaskManagement (Request);
+    }
+
+    if (Request->Event != NULL) {
+      Event          = Request->Event;
+      Request->InUse = FALSE;
+      gBS->SignalEvent (Event);
+      return;
+    }
+  }
+
+  if (Request->Orphaned) {
+    Request->InUse = FALSE;
+  }
+}
+
+/**
+  Callback of the status transfer of a request.
+
+  @param  Data                  The Sense IU or Response IU.
+  @param  DataLength            The length of the IU received.
+  @param  Context               The request.
+  @param  Result                The result of the transfer.
+
+  @retval EFI_SUCCESS           The status is recorded.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasStatusCallback (
+  IN VOID    *Data,
+  IN UINTN   DataLength,
+  IN VOID    *Context,
+  IN UINT32  Result
+  )
+{
+  USB_UAS_REQUEST             *Request;
+  EDKII_USB_STREAMS_PROTOCOL  *UsbStreams;
+  EFI_STATUS                  Status;
+  EFI_TPL                     OldTpl;
+
+  Request = (USB_UAS_REQUEST *)Context;
+  OldTpl  = gBS->RaiseTPL (USB_UAS_TPL);
+
+  if (Request->InUse && Request->StatusPending) {
+    Request->StatusPending = FALSE;
+    Request->StatusLength  = DataLength;
+    Request->StatusResult  = Result;
+
+    //
+    // The device sends the status after the data. A data transfer still
+    // queued when the status arrives is abandoned by the device, because the
+    // command is terminated early.
+    //
+    if (Request->DataPending) {
+      UsbStreams = Request->Device->UsbStreams;
+      Status     = UsbStreams->CancelStreamTransfers (UsbStreams, Request->DataEndpoint, Request->Tag);
+      if (!EFI_ERROR (Status)) {
+        Request->DataPending = FALSE;
+      }
+    }
+
+    UsbUasTryComplete (Request);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  return EFI_SUCCESS;
+}
+
+/**
+  Callback of the data transfer of a request.
+
+  @param  Data                  The data buffer.
+  @param  DataLength            The number of bytes transferred.
+  @param  Context               The request.
+  @param  Result                The result of the transfer.
+
+  @retval EFI_SUCCESS           The result is recorded.
+
+**/
+EFI_STATUS
+EFIAPI
+UsbUasDataCallback (
+  IN VOID    *Data,
+  IN UINTN   DataLength,
+  IN VOID    *Context,
+  IN UINT32  Result
+  )
+{
+  USB_UAS_REQUEST  *Request;
+  EFI_TPL          OldTpl;
+
+  Request = (USB_UAS_REQUEST *)Context;
+  OldTpl  = gBS->RaiseTPL (USB_UAS_TPL);
+
+  if (Request->InUse && Request->DataPending) {
+    Request->DataPending = FALSE;
+    Request->Transferred = DataLength;
+    Request->DataResult  = Result;
+    UsbUasTryComplete (Request);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  return EFI_SUCCESS;
+}
+
+/**
+  Send the IU of the request on the command pipe.
+
+  @param  Request               The request.
+
+  @retval EFI_SUCCESS           The IU is sent.
+  @retval EFI_DEVICE_ERROR      The IU can't be sent.
+
+**/
+EFI_STATUS
+UsbUasSendIu (
+  IN USB_UAS_REQUEST  *Request
+  )
+{
+  USB_UAS_DEVICE  *UsbUas;
+  UINTN           Length;
+  UINT32          Result;
+  EFI_STATUS      Status;
+
+  UsbUas = Request->Device;
+  Length = Request->IuLength;
+  Status = UsbUas->UsbIo->UsbBulkTransfer (
+                            UsbUas->UsbIo,
+                            UsbUas->CommandEndpoint,
+                            &Request->Iu,
+                            &Length,
+                            USB_UAS_IU_TIMEOUT / USB_UAS_1_MILLISECOND,
+                            &Result
+                            );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "UsbUasSendIu: tag %d failed - %r, result %x\n", Request->Tag, Status, Result));
+    if ((Result & EFI_USB_ERR_STALL) != 0) {
+      UsbClearEndpointHalt (UsbUas->UsbIo, UsbUas->CommandEndpoint, &Result);
+    }
+
+    return EFI_DEVICE_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Receive an IU of the request on the status pipe of a device without streams.
+
+  @param  Request               The request.
+  @param  Timeout               The timeout in milliseconds, 0 to wait forever.
+
+  @retval EFI_SUCCESS           An IU is received.
+  @retval Others                No IU is received.
+
+**/
+EFI_STATUS
+UsbUasReceiveStatus (
+  IN USB_UAS_REQUEST  *Request,
+  IN UINTN            Timeout
+  )
+{
+  USB_UAS_DEVICE  *UsbUas;
+  UINTN           Length;
+  UINT32          Result;
+  EFI_STATUS      Status;
+
+  UsbUas = Request->Device;
+  Length = sizeof (USB_UAS_STATUS_IU);
+  Status = UsbUas->UsbIo->UsbBulkTransfer (
+                            UsbUas->UsbIo,
+                            UsbUas->StatusEndpoint,
+                            &Request->StatusIu,
+                            &Length,
+                            Timeout,
+                            &Result
+                            );
+
+  Request->StatusLength = Length;
+  Request->StatusResult = Result;
+  if (Status == EFI_TIMEOUT) {
+    Request->Aborted = TRUE;
+  } else if ((Result & EFI_USB_ERR_STALL) != 0) {
+    UsbClearEndpointHalt (UsbUas->UsbIo, UsbUas->StatusEndpoint, &Result);
+  }
+
+  return Status;
+}
+
+/**
+  Execute the request on a device without streams, one phase after the other.
+
+  @param  Request               The request.
+  @param  Timeout               The timeout in 100ns units, 0 to wait forever.
+
+  @retval EFI_SUCCESS           The request is completed, Request->Status is its result.
+  @retval EFI_DEVICE_ERROR      The IU can't be sent.
+
+**/
+EFI_STATUS
+UsbUasExecRequest (
+  IN USB_UAS_REQUEST  *Request,
+  IN UINT64           Timeout
+  )
+{
+  USB_UAS_DEVICE  *UsbUas;
+  UINTN           TimeoutMs;
+  UINTN           Length;
+  UINT32          Result;
+  UINT8           IuId;
+  EFI_STATUS      Status;
+  EFI_TPL         OldTpl;
+
+  UsbUas    = Request->Device;
+  TimeoutMs = 0;
+  if (Timeout != 0) {
+    TimeoutMs = (UINTN)MAX (DivU64x32 (Timeout, 10000), 1);
+  }
+
+  Status = UsbUasSendIu (Request);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = UsbUasReceiveStatus (Request, TimeoutMs);
+  IuId   = Request->StatusIu.Header.IuId;
+
+  if (!EFI_ERROR (Status) && (Request->DataLength != 0) &&
+      (((IuId == USB_UAS_IU_READ_READY) && (Request->DataEndpoint == UsbUas->DataInEndpoint)) ||
+       ((IuId == USB_UAS_IU_WRITE_READY) && (Request->DataEndpoint == UsbUas->DataOutEndpoint))))
+  {
+    Length = Request->DataLength;
+    Status = UsbUas->UsbIo->UsbBulkTransfer (
+                              UsbUas->UsbIo,
+                              Request->DataEndpoint,
+                              Request->Data,
+                              &Length,
+                              TimeoutMs,
+                              &Result
+                              );
+
+    Request->Transferred = Length;
+    Request->DataResult  = Result;
+    if (Status == EFI_TIMEOUT) {
+      Request->Aborted = TRUE;
+    } else {
+      if ((Result & EFI_USB_ERR_STALL) != 0) {
+        UsbClearEndpointHalt (UsbUas->UsbIo, Request->DataEndpoint, &Result);
+      }
+
+      UsbUasReceiveStatus (Request, TimeoutMs);
+    }
+  }
+
+  OldTpl = gBS->RaiseTPL (USB_UAS_TPL);
+  UsbUasTryComplete (Request);
+  gBS->RestoreTPL (OldTpl);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Submit the request to the device.
+
+  With streams, the status and data transfers are queued on the stream of the
+  tag before the IU is sent, and the request is completed by their callbacks.
+  Without streams, the request is executed to the end before returning.
+
+  @param  Request               The request to submit.
+  @param  Timeout               The timeout of the request in 100ns units, 0 to
+                                wait forever.
+
+  @retval EFI_SUCCESS           The request is submitted.
+  @retval EFI_DEVICE_ERROR      The request can't be sent to the device.
+  @retval Others                The transfers can't be queued.
+
+**/
+EFI_STATUS
+UsbUasSubmitRequest (
+  IN USB_UAS_REQUEST  *Request,
+  IN UINT64           Timeout
+  )
+{
+  USB_UAS_DEVICE              *UsbUas;
+  EDKII_USB_STREAMS_PROTOCOL  *UsbStreams;
+  EFI_STATUS                  Status;
+  EFI_TPL                     OldTpl;
+
+  UsbUas            = Request->Device;
+  UsbStreams        = UsbUas->UsbStreams;
+  Request->TimeLeft = Timeout;
+
+  if (UsbStreams == NULL) {
+    return UsbUasExecRequest (Request, Timeout);
+  }
+
+  Request->StatusPending = TRUE;
+  Status                 = UsbStreams->AsyncStreamTransfer (
+                                         UsbStreams,
+                                         UsbUas->StatusEndpoint,
+                                         Request->Tag,
+                                         &Request->StatusIu,
+                                         sizeof (USB_UAS_STATUS_IU),
+                                         UsbUasStatusCallback,
+                                         Request
+                                         );
+  if (EFI_ERROR (Status)) {
+    Request->StatusPending = FALSE;
+    goto ON_ERROR;
+  }
+
+  if (Request->DataLength != 0) {
+    Request->DataPending = TRUE;
+    Status               = UsbStreams->AsyncStreamTransfer (
+                                         UsbStreams,
+                                         Request->DataEndpoint,
+                                         Request->Tag,
+                                         Request->Data,
+                                         Request->DataLength,
+                                         UsbUasDataCallback,
+                                         Request
+                                         );
+    if (EFI_ERROR (Status)) {
+      Request->DataPending = FALSE;
+      goto ON_ERROR;
+    }
+  }
+
+  Status = UsbUasSendIu (Request);
+  if (EFI_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  return EFI_SUCCESS;
+
+ON_ERROR:
+  //
+  // The caller releases the request. It isn't completed through its event.
+  //
+  OldTpl           = gBS->RaiseTPL (USB_UAS_TPL);
+  Request->Event   = NULL;
+  Request->Aborted = TRUE;
+  gBS->RestoreTPL (OldTpl);
+  return Status;
+}
+
+/**
+  Abort the transfers of a request still in flight. The request is completed
+  once the transfers called back already are done.
+
+  @param  Request               The request to abort.
+
+**/
+VOID
+UsbUasAbortRequest (
+  IN USB_UAS_REQUEST  *Request
+  )
+{
+  EFI_TPL  OldTpl;
+
+  OldTpl = gBS->RaiseTPL (USB_UAS_TPL);
+
+  if (Request->InUse && !Request->Done) {
+    Request->Aborted = TRUE;
+    UsbUasCancelTransfers (Request);
+    UsbUasTryComplete (Request);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Abort all the requests in flight of the device.
+
+  @param  UsbUas                The USB UAS device.
+
+**/
+VOID
+UsbUasAbortAllRequests (
+  IN USB_UAS_DEVICE  *UsbUas
+  )
+{
+  UINT16  Index;
+
+  for (Index = 0; Index < UsbUas->TagCount; Index++) {
+    UsbUasAbortRequest (&UsbUas->Requests[Index]);
+  }
+}
+
+/**
+  Wait for a submitted request to complete.
+
+  @param  Request               The request to wait for.
+  @param  Timeout               The timeout of the request in 100ns units, 0 to
+                                wait forever.
+
+  @retval EFI_SUCCESS           The request is completed, Request->Status is its result.
+  @retval EFI_TIMEOUT           The request is aborted after the timeout.
+
+**/
+EFI_STATUS
+UsbUasWaitRequest (
+  IN USB_UAS_REQUEST  *Request,
+  IN UINT64           Timeout
+  )
+{
+  EDKII_USB_STREAMS_PROTOCOL  *UsbStreams;
+
+  UsbStreams = Request->Device->UsbStreams;
+
+  while (!Request->Done) {
+    if (Timeout != 0) {
+      if (Timeout <= USB_UAS_POLL_INTERVAL) {
+        UsbUasAbortRequest (Request);
+        return Request->Done ? EFI_SUCCESS : EFI_TIMEOUT;
+      }
+
+      Timeout -= USB_UAS_POLL_INTERVAL;
+    }
+
+    //
+    // The caller may run at a TPL blocking the periodic check of the host
+    // controller driver, so check the stream transfers here.
+    //
+    if (UsbStreams != NULL) {
+      UsbStreams->Poll (UsbStreams);
+    }
+
+    gBS->Stall ((UINTN)DivU64x32 (USB_UAS_POLL_INTERVAL, 10));
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Timer callback to abort the nonblocking requests after their timeout.
+
+  @param  Event                 The timer event.
+  @param  Context               The USB UAS device.
+
+**/
+VOID
+EFIAPI
+UsbUasCheckTimeout (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  USB_UAS_DEVICE   *UsbUas;
+  USB_UAS_REQUEST  *Request;
+  UINT16           Index;
+
+  UsbUas = (USB_UAS_DEVICE *)Context;
+
+  for (Index = 0; Index < UsbUas->TagCount; Index++) {
+    Request = &UsbUas->Requests[Index];
+    if (!Request->InUse || Request->Done || (Request->Event == NULL) || (Request->TimeLeft == 0)) {
+      continue;
+    }
+
+    if (Request->TimeLeft > USB_UAS_TIMER_INTERVAL) {
+      Request->TimeLeft -= USB_UAS_TIMER_INTERVAL;
+    } else {
+      DEBUG ((DEBUG_ERROR, "UsbUasCheckTimeout: tag %d timed out\n", Request->Tag));
+      Request->TimeLeft = 0;
+      UsbUasAbortRequest (Request);
+    }
+  }
+}
+
+/**
+  Send a task management function to the device and wait for its response.
+
+  @param  UsbUas                The USB UAS device.
+  @param  Lun                   The LUN of the function.
+  @param  Function              The task management function.
+
+  @retval EFI_SUCCESS           The function succeeded.
+  @retval EFI_NOT_READY         All the tags are in use.
+  @retval EFI_DEVICE_ERROR      The function failed.
+  @retval EFI_TIMEOUT           The device didn't respond.
+
+**/
+EFI_STATUS
+UsbUasTaskManagement (
+  IN USB_UAS_DEVICE  *UsbUas,
+  IN UINT16          Lun,
+  IN UINT8           Function
+  )
+{
+  USB_UAS_REQUEST  *Request;
+  UINT64           Timeout;
+  EFI_STATUS       Status;
+
+  Request = UsbUasAllocateRequest (UsbUas);
+  if (Request == NULL) {
+    return EFI_NOT_READY;
+  }
+
+  UsbUasBuildTaskManagement (Request, Lun, Function);
+
+  Timeout = MultU64x32 (USB_UAS_TMF_TIMEOUT, 10);
+  Status  = UsbUasSubmitRequest (Request, Timeout);
+  if (!EFI_ERROR (Status)) {
+    Status = UsbUasWaitRequest (Request, Timeout);
+    if (!EFI_ERROR (Status)) {
+      Status = Request->Status;
+    }
+  }
+
+  UsbUasReleaseRequest (Request);
+
+  DEBUG ((DEBUG_INFO, "UsbUasTaskManagement: function %x LUN %d - %r\n", Function, Lun, Status));
+  return Status;
+}
@@ -0,0 +1,265 @@
+/** @file
+  Index of the installed device path protocol interfaces.
+
+  Every device path protocol interface is linked into a bucket selected by the
+  hash of its device path, so that LocateDevicePath() and the duplicate device
+  path check of InstallMultipleProtocolInterfaces() look at the few interfaces
+  whose device path hashes the same instead of every handle in the system.
+
+  The hash and size are captured when the interface is installed. A device
+  path interface must therefore not be modified in place once it is installed;
+  ReinstallProtocolInterface() must be used to publish a new device path.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DxeMain.h"
+#include "Handle.h"
+
+#define DEVICE_PATH_INDEX_BUCKET_COUNT  256
+
+LIST_ENTRY  mDevicePathIndex[DEVICE_PATH_INDEX_BUCKET_COUNT];
+
+/**
+  Returns the index bucket of a device path hash.
+
+  @param  Hash                   The device path hash
+
+  @return The list head of the bucket
+
+**/
+STATIC
+LIST_ENTRY *
+CoreGetDevicePathIndexBucket (
+  IN UINT32  Hash
+  )
+{
+  return &mDevicePathIndex[Hash & (DEVICE_PATH_INDEX_BUCKET_COUNT - 1)];
+}
+
+/**
+  Initializes the index of installed device path protocol interfaces.
+
+**/
+VOID
+CoreInitializeDevicePathIndex (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < DEVICE_PATH_INDEX_BUCKET_COUNT; Index++) {
+    InitializeListHead (&mDevicePathIndex[Index]);
+  }
+}
+
+/**
+  Adds a protocol interface to the device path index if it is a device path
+  protocol interface.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Prot                   The protocol interface that was installed
+
+**/
+VOID
+CoreInsertDevicePathIndex (
+  IN PROTOCOL_INTERFACE  *Prot
+  )
+{
+  UINTN  Size;
+
+  ASSERT_LOCKED (&gProtocolDatabaseLock);
+
+  if ((Prot->Interface == NULL) ||
+      !CompareGuid (&Prot->Protocol->ProtocolID, &gEfiDevicePathProtocolGuid))
+  {
+    return;
+  }
+
+  //
+  // A protocol interface is indexed once, from install or reinstall.
+  //
+  ASSERT (Prot->ByDevicePath.ForwardLink == NULL);
+
+  Size = GetDevicePathSize (Prot->Interface);
+  ASSERT (Size >= END_DEVICE_PATH_LENGTH);
+  if (Size == 0) {
+    //
+    // Not a valid device path, it can never match.
+    //
+    return;
+  }
+
+  Prot->DevicePathSize = Size;
+  Prot->DevicePathHash = GetDevicePathHash (Prot->Interface);
+  InsertTailList (CoreGetDevicePathIndexBucket (Prot->DevicePathHash), &Prot->ByDevicePath);
+}
+
+/**
+  Removes a protocol interface from the device path index, if it was indexed.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Prot                   The protocol interface that is being removed
+
+**/
+VOID
+CoreRemoveDevicePathIndex (
+  IN PROTOCOL_INTERFACE  *Prot
+  )
+{
+  ASSERT_LOCKED (&gProtocolDatabaseLock);
+
+  if (Prot->ByDevicePath.ForwardLink != NULL) {
+    RemoveEntryList (&Prot->ByDevicePath);
+    Prot->ByDevicePath.ForwardLink = NULL;
+    Prot->ByDevicePath.BackLink    = NULL;
+  }
+}
+
+/**
+  Finds the installed device path protocol interface that is identical to
+  DevicePath.
+  The gProtocolDatabaseLock must be owned
+
+  @param  DevicePath             The device path to search for
+
+  @return The protocol interface (NULL: Not found)
+
+**/
+PROTOCOL_INTERFACE *
+CoreFindDevicePathIndex (
+  IN EFI_DEVICE_PATH_PROTOCOL  *DevicePath
+  )
+{
+  UINT32              Hash;
+  UINTN               Size;
+  LIST_ENTRY          *Bucket;
+  LIST_ENTRY          *Link;
+  PROTOCOL_INTERFACE  *Prot;
+
+  ASSERT_LOCKED (&gProtocolDatabaseLock);
+
+  Size = GetDevicePathSize (DevicePath);
+  ASSERT (Size >= END_DEVICE_PATH_LENGTH);
+  Hash   = GetDevicePathHash (DevicePath);
+  Bucket = CoreGetDevicePathIndexBucket (Hash);
+
+  for (Link = Bucket->ForwardLink; Link != Bucket; Link = Link->ForwardLink) {
+    Prot = CR (Link, PROTOCOL_INTERFACE, ByDevicePath, PROTOCOL_INTERFACE_SIGNATURE);
+    if ((Prot->DevicePathHash == Hash) &&
+        (Prot->DevicePathSize == Size) &&
+        (CompareMem (DevicePath, Prot->Interface, Size - END_DEVICE_PATH_LENGTH) == 0))
+    {
+      return Prot;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Checks whether a handle has an interface of a protocol installed.
+
+  @param  Handle                 The handle to check
+  @param  ProtEntry              The protocol entry of the protocol
+
+  @retval TRUE                   The handle supports the protocol
+  @retval FALSE                  The handle does not support the protocol
+
+**/
+STATIC
+BOOLEAN
+CoreHandleSupportsProtocolEntry (
+  IN IHANDLE         *Handle,
+  IN PROTOCOL_ENTRY  *ProtEntry
+  )
+{
+  LIST_ENTRY          *Link;
+  PROTOCOL_INTERFACE  *Prot;
+
+  for (Link = Handle->Protocols.ForwardLink; Link != &Handle->Protocols; Link = Link->ForwardLink) {
+    Prot = CR (Link, PROTOCOL_INTERFACE, Link, PROTOCOL_INTERFACE_SIGNATURE);
+    if (Prot->Protocol == ProtEntry) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Finds the handle whose device path is the longest prefix of the first
+  instance of DevicePath and that supports Protocol.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Protocol               The protocol the handle must support
+  @param  DevicePath             The device path to match
+  @param  MatchSize              Returns the size of the matched prefix, in bytes
+
+  @return The handle (NULL: Not found)
+
+**/
+EFI_HANDLE
+CoreLocateDevicePathIndex (
+  IN  EFI_GUID                  *Protocol,
+  IN  EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  OUT UINTN                     *MatchSize
+  )
+{
+  PROTOCOL_ENTRY            *ProtEntry;
+  EFI_DEVICE_PATH_PROTOCOL  *Node;
+  EFI_HANDLE                BestDevice;
+  UINT32                    Hash;
+  UINTN                     Size;
+  LIST_ENTRY                *Bucket;
+  LIST_ENTRY                *Link;
+  PROTOCOL_INTERFACE        *Prot;
+
+  ASSERT_LOCKED (&gProtocolDatabaseLock);
+
+  ProtEntry = CoreFindProtocolEntry (Protocol, FALSE);
+  if (ProtEntry == NULL) {
+    return NULL;
+  }
+
+  //
+  // Walk the first instance of DevicePath once. Before each node, the nodes
+  // walked so far form a prefix whose hash is known, so only the bucket of
+  // that hash has to be searched. Later matches are longer and win.
+  //
+  BestDevice = NULL;
+  Hash       = DEVICE_PATH_HASH_SEED;
+  Node       = DevicePath;
+  while (TRUE) {
+    Size   = (UINTN)Node - (UINTN)DevicePath;
+    Bucket = CoreGetDevicePathIndexBucket (Hash);
+    for (Link = Bucket->ForwardLink; Link != Bucket; Link = Link->ForwardLink) {
+      Prot = CR (Link, PROTOCOL_INTERFACE, ByDevicePath, PROTOCOL_INTERFACE_SIGNATURE);
+      if ((Prot->DevicePathHash == Hash) &&
+          (Prot->DevicePathSize - END_DEVICE_PATH_LENGTH == Size) &&
+          (CompareMem (DevicePath, Prot->Interface, Size) == 0) &&
+          CoreHandleSupportsProtocolEntry (Prot->Handle, ProtEntry))
+      {
+        BestDevice = Prot->Handle;
+        *MatchSize = Size;
+        break;
+      }
+    }
+
+    if (IsDevicePathEndType (Node) ||
+        (DevicePathNodeLength (Node) < sizeof (EFI_DEVICE_PATH_PROTOCOL)))
+    {
+      //
+      // End of the device path or of its first instance.
+      //
+      break;
+    }
+
+    Hash = HashDevicePathNode (Hash, Node);
+    Node = NextDevicePathNode (Node);
+  }
+
+  return BestDevice;
+}
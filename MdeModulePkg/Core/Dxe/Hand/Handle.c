@@ -96,6 +96,8 @@ CoreInitializeHandleServices (
     return EFI_OUT_OF_RESOURCES;
   }
 
+  CoreInitializeDevicePathIndex ();
+
   return EFI_SUCCESS;
 }
 
@@ -263,48 +265,14 @@ IsDevicePathInstalled (
   IN EFI_DEVICE_PATH_PROTOCOL  *DevicePath
   )
 {
-  UINTN               SourceSize;
-  UINTN               Size;
-  BOOLEAN             Found;
-  LIST_ENTRY          *Link;
-  PROTOCOL_ENTRY      *ProtEntry;
-  PROTOCOL_INTERFACE  *Prot;
+  BOOLEAN  Found;
 
   if (DevicePath == NULL) {
     return FALSE;
   }
 
-  Found      = FALSE;
-  SourceSize = GetDevicePathSize (DevicePath);
-  ASSERT (SourceSize >= END_DEVICE_PATH_LENGTH);
-
   CoreAcquireProtocolLock ();
-  //
-  // Look up the protocol entry
-  //
-  ProtEntry = CoreFindProtocolEntry (&gEfiDevicePathProtocolGuid, FALSE);
-  if (ProtEntry == NULL) {
-    goto Done;
-  }
-
-  for (Link = ProtEntry->Protocols.ForwardLink; Link != &ProtEntry->Protocols; Link = Link->ForwardLink) {
-    //
-    // Loop on the DevicePathProtocol interfaces
-    //
-    Prot = CR (Link, PROTOCOL_INTERFACE, ByProtocol, PROTOCOL_INTERFACE_SIGNATURE);
-
-    //
-    // Check if DevicePath is same as this interface
-    //
-    Size = GetDevicePathSize (Prot->Interface);
-    ASSERT (Size >= END_DEVICE_PATH_LENGTH);
-    if ((Size == SourceSize) && (CompareMem (DevicePath, Prot->Interface, Size - END_DEVICE_PATH_LENGTH) == 0)) {
-      Found = TRUE;
-      break;
-    }
-  }
-
-Done:
+  Found = (BOOLEAN)(CoreFindDevicePathIndex (DevicePath) != NULL);
   CoreReleaseProtocolLock ();
   return Found;
 }
@@ -569,6 +537,7 @@ CoreInstallProtocolInterfaceNotify (
   // protocol entry
   //
   InsertTailList (&ProtEntry->Protocols, &Prot->ByProtocol);
+  CoreInsertDevicePathIndex (Prot);
 
   //
   // Notify the notification list for this protocol
@@ -66,6 +66,11 @@ typedef struct {
   /// OPEN_PROTOCOL_DATA list
   LIST_ENTRY        OpenList;
   UINTN             OpenListCount;
+  /// Link on a device path index bucket, device path interfaces only
+  LIST_ENTRY        ByDevicePath;
+  /// Hash and size of the device path interface when it was indexed
+  UINT32            DevicePathHash;
+  UINTN             DevicePathSize;
 } PROTOCOL_INTERFACE;
 
 #define OPEN_PROTOCOL_DATA_SIGNATURE  SIGNATURE_32('p','o','d','l')
@@ -160,6 +165,74 @@ CoreRemoveInterfaceFromProtocol (
   IN VOID      *Interface
   );
 
+/**
+  Initializes the index of installed device path protocol interfaces.
+
+**/
+VOID
+CoreInitializeDevicePathIndex (
+  VOID
+  );
+
+/**
+  Adds a protocol interface to the device path index if it is a device path
+  protocol interface.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Prot                   The protocol interface that was installed
+
+**/
+VOID
+CoreInsertDevicePathIndex (
+  IN PROTOCOL_INTERFACE  *Prot
+  );
+
+/**
+  Removes a protocol interface from the device path index, if it was indexed.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Prot                   The protocol interface that is being removed
+
+**/
+VOID
+CoreRemoveDevicePathIndex (
+  IN PROTOCOL_INTERFACE  *Prot
+  );
+
+/**
+  Finds the installed device path protocol interface that is identical to
+  DevicePath.
+  The gProtocolDatabaseLock must be owned
+
+  @param  DevicePath             The device path to search for
+
+  @return The protocol interface (NULL: Not found)
+
+**/
+PROTOCOL_INTERFACE *
+CoreFindDevicePathIndex (
+  IN EFI_DEVICE_PATH_PROTOCOL  *DevicePath
+  );
+
+/**
+  Finds the handle whose device path is the longest prefix of the first
+  instance of DevicePath and that supports Protocol.
+  The gProtocolDatabaseLock must be owned
+
+  @param  Protocol               The protocol the handle must support
+  @param  DevicePath             The device path to match
+  @param  MatchSize              Returns the size of the matched prefix, in bytes
+
+  @return The handle (NULL: Not found)
+
+**/
+EFI_HANDLE
+CoreLocateDevicePathIndex (
+  IN  EFI_GUID                  *Protocol,
+  IN  EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  OUT UINTN                     *MatchSize
+  );
+
 /**
   Connects a controller to a driver.
 
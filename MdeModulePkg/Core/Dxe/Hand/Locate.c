@@ -451,17 +451,8 @@ CoreLocateDevicePath (
   OUT EFI_HANDLE                   *Device
   )
 {
-  INTN                      SourceSize;
-  INTN                      Size;
-  INTN                      BestMatch;
-  UINTN                     HandleCount;
-  UINTN                     Index;
-  EFI_STATUS                Status;
-  EFI_HANDLE                *Handles;
-  EFI_HANDLE                Handle;
-  EFI_HANDLE                BestDevice;
-  EFI_DEVICE_PATH_PROTOCOL  *SourcePath;
-  EFI_DEVICE_PATH_PROTOCOL  *TmpDevicePath;
+  UINTN       BestMatch;
+  EFI_HANDLE  BestDevice;
 
   if (Protocol == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -471,73 +462,20 @@ CoreLocateDevicePath (
     return EFI_INVALID_PARAMETER;
   }
 
-  Handles       = NULL;
-  BestDevice    = NULL;
-  SourcePath    = *DevicePath;
-  TmpDevicePath = SourcePath;
-  while (!IsDevicePathEnd (TmpDevicePath)) {
-    if (IsDevicePathEndInstance (TmpDevicePath)) {
-      //
-      // If DevicePath is a multi-instance device path,
-      // the function will operate on the first instance
-      //
-      break;
-    }
-
-    TmpDevicePath = NextDevicePathNode (TmpDevicePath);
-  }
-
-  SourceSize = (UINTN)TmpDevicePath - (UINTN)SourcePath;
-
   //
-  // Get a list of all handles that support the requested protocol
+  // Look up the longest prefix of the first instance of DevicePath that is
+  // installed on a handle supporting the requested protocol
   //
-  Status = CoreLocateHandleBuffer (ByProtocol, Protocol, NULL, &HandleCount, &Handles);
-  if (EFI_ERROR (Status) || (HandleCount == 0)) {
-    return EFI_NOT_FOUND;
-  }
-
-  BestMatch = -1;
-  for (Index = 0; Index < HandleCount; Index += 1) {
-    Handle = Handles[Index];
-    Status = CoreHandleProtocol (Handle, &gEfiDevicePathProtocolGuid, (VOID **)&TmpDevicePath);
-    if (EFI_ERROR (Status)) {
-      //
-      // If this handle doesn't support device path, then skip it
-      //
-      continue;
-    }
-
-    //
-    // Check if DevicePath is first part of SourcePath
-    //
-    Size = GetDevicePathSize (TmpDevicePath) - sizeof (EFI_DEVICE_PATH_PROTOCOL);
-    ASSERT (Size >= 0);
-    if ((Size <= SourceSize) && (CompareMem (SourcePath, TmpDevicePath, (UINTN)Size) == 0)) {
-      //
-      // If the size is equal to the best match, then we
-      // have a duplicate device path for 2 different device
-      // handles
-      //
-      ASSERT (Size != BestMatch);
-
-      //
-      // We've got a match, see if it's the best match so far
-      //
-      if (Size > BestMatch) {
-        BestMatch  = Size;
-        BestDevice = Handle;
-      }
-    }
-  }
-
-  CoreFreePool (Handles);
+  BestMatch = 0;
+  CoreAcquireProtocolLock ();
+  BestDevice = CoreLocateDevicePathIndex (Protocol, *DevicePath, &BestMatch);
+  CoreReleaseProtocolLock ();
 
   //
   // If there wasn't any match, then no parts of the device path was found.
   // Which is strange since there is likely a "root level" device path in the system.
   //
-  if (BestMatch == -1) {
+  if (BestDevice == NULL) {
     return EFI_NOT_FOUND;
   }
 
@@ -550,7 +488,7 @@ CoreLocateDevicePath (
   //
   // Return the remaining part of the device path
   //
-  *DevicePath = (EFI_DEVICE_PATH_PROTOCOL *)(((UINT8 *)SourcePath) + BestMatch);
+  *DevicePath = (EFI_DEVICE_PATH_PROTOCOL *)(((UINT8 *)*DevicePath) + BestMatch);
   return EFI_SUCCESS;
 }
 
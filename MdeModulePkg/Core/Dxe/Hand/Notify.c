@@ -76,6 +76,7 @@ CoreRemoveInterfaceFromProtocol (
     // Remove the protocol interface entry
     //
     RemoveEntryList (&Prot->ByProtocol);
+    CoreRemoveDevicePathIndex (Prot);
   }
 
   return Prot;
@@ -242,6 +243,7 @@ CoreReinstallProtocolInterface (
   // protocol entry
   //
   InsertTailList (&ProtEntry->Protocols, &Prot->ByProtocol);
+  CoreInsertDevicePathIndex (Prot);
 
   //
   // Update the Key to show that the handle has been created/modified
@@ -87,6 +87,8 @@ SMM_CORE_SMI_HANDLERS  mSmmCoreSmiHandlers[] = {
   { SmmExitBootServicesHandler, &gEfiEventExitBootServicesGuid,     NULL, FALSE },
   { SmmReadyToBootHandler,      &gEfiEventReadyToBootGuid,          NULL, FALSE },
   { SmmEndOfDxeHandler,         &gEfiEndOfDxeEventGroupGuid,        NULL, TRUE  },
+  { SmiLatencyHistogramHandler, &gSmiLatencyHistogramGuid,          NULL, FALSE },
+  { SmiTraceHandler,            &gSmiTraceGuid,                     NULL, FALSE },
   { NULL,                       NULL,                               NULL, FALSE }
 };
 
@@ -692,6 +694,11 @@ SmmEntryPoint (
   gSmmCoreSmst.CpuSaveStateSize      = SmmEntryContext->CpuSaveStateSize;
   gSmmCoreSmst.CpuSaveState          = SmmEntryContext->CpuSaveState;
 
+  //
+  // Allocate the SMI trace ring buffers once the number of CPUs is known
+  //
+  SmiTraceInitialize ();
+
   //
   // Call platform hook before Smm Dispatch
   //
@@ -770,13 +777,15 @@ SmmEntryPoint (
           CommHeaderSize          = OFFSET_OF (EFI_SMM_COMMUNICATE_HEADER, Data);
         }
 
-        BufferSize -= CommHeaderSize;
-        Status      = SmiManage (
-                        CommGuid,
-                        NULL,
-                        CommData,
-                        &BufferSize
-                        );
+        BufferSize         -= CommHeaderSize;
+        mSmiTraceCommBuffer = CommData;
+        Status              = SmiManage (
+                                CommGuid,
+                                NULL,
+                                CommData,
+                                &BufferSize
+                                );
+        mSmiTraceCommBuffer = NULL;
         //
         // Update CommunicationBuffer, BufferSize and ReturnStatus
         // Communicate service finished, reset the pointer to CommBuffer to NULL
@@ -34,6 +34,8 @@
 #include <Guid/MemoryProfile.h>
 #include <Guid/LoadModuleAtFixedAddress.h>
 #include <Guid/SmiHandlerProfile.h>
+#include <Guid/SmiLatencyHistogram.h>
+#include <Guid/SmiTrace.h>
 #include <Guid/EndOfS3Resume.h>
 #include <Guid/S3SmmInitDone.h>
 
@@ -54,6 +56,7 @@
 #include <Library/HobLib.h>
 #include <Library/SmmMemLib.h>
 #include <Library/SafeIntLib.h>
+#include <Library/TimerLib.h>
 
 #include "PiSmmCorePrivateData.h"
 #include "HeapGuard.h"
@@ -74,13 +77,17 @@ typedef struct {
 
 #define SMI_ENTRY_SIGNATURE  SIGNATURE_32('s','m','i','e')
 
-typedef struct {
+typedef struct _SMI_ENTRY SMI_ENTRY;
+
+struct _SMI_ENTRY {
   UINTN         Signature;
   LIST_ENTRY    AllEntries; // All entries
 
-  EFI_GUID      HandlerType; // Type of interrupt
-  LIST_ENTRY    SmiHandlers; // All handlers
-} SMI_ENTRY;
+  EFI_GUID                 HandlerType; // Type of interrupt
+  LIST_ENTRY               SmiHandlers; // All handlers
+  SMI_LATENCY_HISTOGRAM    Latency;     // Time spent in the handlers
+  SMI_ENTRY                *HashNext;   // Next entry in the same hash bucket
+};
 
 #define SMI_HANDLER_SIGNATURE  SIGNATURE_32('s','m','i','h')
 
@@ -93,6 +100,8 @@ typedef struct {
   VOID                            *Context;    // for profile
   UINTN                           ContextSize; // for profile
   BOOLEAN                         ToRemove;    // To remove this SMI_HANDLER later
+  UINT64                          InvocationCount; // for profile
+  UINT64                          TotalTicks;      // for profile
 } SMI_HANDLER;
 
 //
@@ -616,6 +625,22 @@ SmmLocateHandleBuffer (
   OUT    EFI_HANDLE              **Buffer
   );
 
+/**
+  Finds the SMI entry for the requested handler type.
+
+  @param  HandlerType            The type of the interrupt
+  @param  Create                 Create a new entry if not found
+
+  @return SMI entry
+
+**/
+SMI_ENTRY  *
+EFIAPI
+SmmCoreFindSmiEntry (
+  IN EFI_GUID  *HandlerType,
+  IN BOOLEAN   Create
+  );
+
 /**
   Manage SMI of a particular type.
 
@@ -851,6 +876,110 @@ SmmEndOfS3ResumeHandler (
   IN OUT UINTN       *CommBufferSize  OPTIONAL
   );
 
+/**
+  SMI handler that returns the SMI latency histogram of the SMI handlers.
+
+  @param  DispatchHandle  The unique handle assigned to this handler by SmiHandlerRegister().
+  @param  Context         Points to an optional handler context which was specified when the handler was registered.
+  @param  CommBuffer      A pointer to a collection of data in memory that will
+                          be conveyed from a non-SMM environment into an SMM environment.
+  @param  CommBufferSize  The size of the CommBuffer.
+
+  @return Status Code
+
+**/
+EFI_STATUS
+EFIAPI
+SmiLatencyHistogramHandler (
+  IN     EFI_HANDLE  DispatchHandle,
+  IN     CONST VOID  *Context         OPTIONAL,
+  IN OUT VOID        *CommBuffer      OPTIONAL,
+  IN OUT UINTN       *CommBufferSize  OPTIONAL
+  );
+
+/**
+  Return the number of performance counter ticks between two counter values.
+
+  @param  StartCounter   The performance counter value at the start.
+  @param  EndCounter     The performance counter value at the end.
+
+  @return The number of ticks from StartCounter to EndCounter.
+
+**/
+UINT64
+SmiLatencyGetElapsedTicks (
+  IN UINT64  StartCounter,
+  IN UINT64  EndCounter
+  );
+
+/**
+  Add the time elapsed since a performance counter value to an SMI latency histogram.
+
+  @param  Histogram      The SMI latency histogram.
+  @param  StartCounter   The performance counter value at the start of the sample.
+
+**/
+VOID
+SmiLatencyHistogramAdd (
+  IN OUT SMI_LATENCY_HISTOGRAM  *Histogram,
+  IN     UINT64                 StartCounter
+  );
+
+/**
+  Allocate the SMI trace ring buffers of all CPUs if the SMI trace is enabled.
+
+  It does nothing when the ring buffers are already allocated.
+
+**/
+VOID
+SmiTraceInitialize (
+  VOID
+  );
+
+/**
+  Add the record of an SMI handler call to the SMI trace ring buffer of the current CPU.
+
+  @param  HandlerType     The GUID of the SMI handler, or NULL for a root SMI handler.
+  @param  SmiHandler      The SMI handler.
+  @param  StartCounter    The performance counter value when the handler was called.
+  @param  Ticks           The number of performance counter ticks spent in the handler.
+  @param  CommBuffer      The communication buffer passed to the handler.
+  @param  CommBufferSize  The size of the communication buffer passed to the handler.
+  @param  Status          The status returned by the handler.
+
+**/
+VOID
+SmiTraceRecord (
+  IN CONST EFI_GUID  *HandlerType OPTIONAL,
+  IN SMI_HANDLER     *SmiHandler,
+  IN UINT64          StartCounter,
+  IN UINT64          Ticks,
+  IN VOID            *CommBuffer OPTIONAL,
+  IN UINTN           CommBufferSize,
+  IN EFI_STATUS      Status
+  );
+
+/**
+  SMI handler that returns the SMI trace records.
+
+  @param  DispatchHandle  The unique handle assigned to this handler by SmiHandlerRegister().
+  @param  Context         Points to an optional handler context which was specified when the handler was registered.
+  @param  CommBuffer      A pointer to a collection of data in memory that will
+                          be conveyed from a non-SMM environment into an SMM environment.
+  @param  CommBufferSize  The size of the CommBuffer.
+
+  @return Status Code
+
+**/
+EFI_STATUS
+EFIAPI
+SmiTraceHandler (
+  IN     EFI_HANDLE  DispatchHandle,
+  IN     CONST VOID  *Context         OPTIONAL,
+  IN OUT VOID        *CommBuffer      OPTIONAL,
+  IN OUT UINTN       *CommBufferSize  OPTIONAL
+  );
+
 /**
   Place holder function until all the SMM System Table Service are available.
 
@@ -1214,6 +1343,10 @@ extern EFI_SMM_DRIVER_ENTRY  *mSmmCoreDriverEntry;
 
 extern EFI_LOADED_IMAGE_PROTOCOL  *mSmmCoreLoadedImage;
 
+extern VOID  *mSmiTraceCommBuffer;
+
+extern LIST_ENTRY  mDiscoveredList;
+
 //
 // Page management
 //
@@ -13,8 +13,23 @@
 //
 UINTN  mSmiManageCallingDepth = 0;
 
+//
+// mSmiHandlerToRemoveCount counts the SMI handlers unregistered by SMI handlers,
+// so SmiManage only looks for the handlers to remove when there are any.
+//
+UINTN  mSmiHandlerToRemoveCount = 0;
+
 LIST_ENTRY  mSmiEntryList = INITIALIZE_LIST_HEAD_VARIABLE (mSmiEntryList);
 
+//
+// The SMI entries are also chained in a hash table indexed by their GUID, so
+// SmiManage finds the entry of an SMI without walking mSmiEntryList.
+// The number of buckets must be a power of 2.
+//
+#define SMI_ENTRY_HASH_BUCKET_COUNT  64
+
+SMI_ENTRY  *mSmiEntryHashTable[SMI_ENTRY_HASH_BUCKET_COUNT];
+
 SMI_ENTRY  mRootSmiEntry = {
   SMI_ENTRY_SIGNATURE,
   INITIALIZE_LIST_HEAD_VARIABLE (mRootSmiEntry.AllEntries),
@@ -22,6 +37,31 @@ SMI_ENTRY  mRootSmiEntry = {
   INITIALIZE_LIST_HEAD_VARIABLE (mRootSmiEntry.SmiHandlers),
 };
 
+/**
+  Returns the hash table bucket of an SMI handler type.
+
+  @param  HandlerType            The type of the interrupt
+
+  @return The index of the bucket in mSmiEntryHashTable.
+
+**/
+UINTN
+SmiEntryHash (
+  IN CONST EFI_GUID  *HandlerType
+  )
+{
+  UINT32  Hash;
+
+  Hash  = ReadUnaligned32 ((CONST UINT32 *)HandlerType) ^
+          ReadUnaligned32 ((CONST UINT32 *)HandlerType + 1) ^
+          ReadUnaligned32 ((CONST UINT32 *)HandlerType + 2) ^
+          ReadUnaligned32 ((CONST UINT32 *)HandlerType + 3);
+  Hash ^= Hash >> 16;
+  Hash ^= Hash >> 8;
+
+  return Hash & (SMI_ENTRY_HASH_BUCKET_COUNT - 1);
+}
+
 /**
   Finds the SMI entry for the requested handler type.
 
@@ -38,19 +78,17 @@ SmmCoreFindSmiEntry (
   IN BOOLEAN   Create
   )
 {
-  LIST_ENTRY  *Link;
-  SMI_ENTRY   *Item;
-  SMI_ENTRY   *SmiEntry;
+  SMI_ENTRY  *Item;
+  SMI_ENTRY  *SmiEntry;
+  UINTN      Bucket;
 
   //
-  // Search the SMI entry list for the matching GUID
+  // Search the hash bucket of the GUID for the matching GUID
   //
   SmiEntry = NULL;
-  for (Link = mSmiEntryList.ForwardLink;
-       Link != &mSmiEntryList;
-       Link = Link->ForwardLink)
-  {
-    Item = CR (Link, SMI_ENTRY, AllEntries, SMI_ENTRY_SIGNATURE);
+  Bucket   = SmiEntryHash (HandlerType);
+  for (Item = mSmiEntryHashTable[Bucket]; Item != NULL; Item = Item->HashNext) {
+    ASSERT (Item->Signature == SMI_ENTRY_SIGNATURE);
     if (CompareGuid (&Item->HandlerType, HandlerType)) {
       //
       // This is the SMI entry
@@ -73,11 +111,14 @@ SmmCoreFindSmiEntry (
       SmiEntry->Signature = SMI_ENTRY_SIGNATURE;
       CopyGuid ((VOID *)&SmiEntry->HandlerType, HandlerType);
       InitializeListHead (&SmiEntry->SmiHandlers);
+      ZeroMem (&SmiEntry->Latency, sizeof (SmiEntry->Latency));
 
       //
-      // Add it to SMI entry list
+      // Add it to SMI entry list and hash table
       //
       InsertTailList (&mSmiEntryList, &SmiEntry->AllEntries);
+      SmiEntry->HashNext         = mSmiEntryHashTable[Bucket];
+      mSmiEntryHashTable[Bucket] = SmiEntry;
     }
   }
 
@@ -100,6 +141,8 @@ RemoveSmiHandler (
   IN SMI_ENTRY    *SmiEntry
   )
 {
+  SMI_ENTRY  **Link;
+
   ASSERT (SmiHandler->ToRemove);
   RemoveEntryList (&SmiHandler->Link);
   FreePool (SmiHandler);
@@ -110,6 +153,13 @@ RemoveSmiHandler (
   if (SmiEntry != NULL) {
     if (IsListEmpty (&SmiEntry->SmiHandlers)) {
       RemoveEntryList (&SmiEntry->AllEntries);
+      for (Link = &mSmiEntryHashTable[SmiEntryHash (&SmiEntry->HandlerType)]; *Link != NULL; Link = &(*Link)->HashNext) {
+        if (*Link == SmiEntry) {
+          *Link = SmiEntry->HashNext;
+          break;
+        }
+      }
+
       FreePool (SmiEntry);
       return TRUE;
     }
@@ -149,6 +199,10 @@ SmiManage (
   EFI_STATUS   ReturnStatus;
   BOOLEAN      WillReturn;
   EFI_STATUS   Status;
+  UINT64       StartCounter;
+  UINT64       HandlerStartCounter;
+  UINT64       HandlerTicks;
+  UINTN        HandlerCommBufferSize;
 
   PERF_FUNCTION_BEGIN ();
   WillReturn   = FALSE;
@@ -175,10 +229,14 @@ SmiManage (
 
   Head = &SmiEntry->SmiHandlers;
   mSmiManageCallingDepth++;
+  StartCounter = GetPerformanceCounter ();
 
   for (Link = Head->ForwardLink; Link != Head; Link = Link->ForwardLink) {
     SmiHandler = CR (Link, SMI_HANDLER, Link, SMI_HANDLER_SIGNATURE);
 
+    HandlerCommBufferSize = (CommBufferSize != NULL) ? *CommBufferSize : 0;
+    HandlerStartCounter   = GetPerformanceCounter ();
+
     Status = SmiHandler->Handler (
                            (EFI_HANDLE)SmiHandler,
                            Context,
@@ -186,6 +244,11 @@ SmiManage (
                            CommBufferSize
                            );
 
+    HandlerTicks = SmiLatencyGetElapsedTicks (HandlerStartCounter, GetPerformanceCounter ());
+    SmiHandler->InvocationCount++;
+    SmiHandler->TotalTicks += HandlerTicks;
+    SmiTraceRecord (HandlerType, SmiHandler, HandlerStartCounter, HandlerTicks, CommBuffer, HandlerCommBufferSize, Status);
+
     switch (Status) {
       case EFI_INTERRUPT_PENDING:
         //
@@ -254,6 +317,11 @@ SmiManage (
     }
   }
 
+  //
+  // Record the latency before SmiEntry may be freed below.
+  //
+  SmiLatencyHistogramAdd (&SmiEntry->Latency, StartCounter);
+
   ASSERT (mSmiManageCallingDepth > 0);
   mSmiManageCallingDepth--;
 
@@ -263,7 +331,9 @@ SmiManage (
   // marked as ToRemove.
   // Note that SmiManage can be called recursively.
   //
-  if (mSmiManageCallingDepth == 0) {
+  if ((mSmiManageCallingDepth == 0) && (mSmiHandlerToRemoveCount != 0)) {
+    mSmiHandlerToRemoveCount = 0;
+
     //
     // Go through all SmiHandler in root SMI handlers
     //
@@ -447,6 +517,7 @@ SmiHandlerUnRegister (
     // Do not delete or remove SmiHandler or SmiEntry now.
     // SmiManage will handle it later
     //
+    mSmiHandlerToRemoveCount++;
     return EFI_SUCCESS;
   }
 
@@ -750,6 +750,8 @@ GetSmmSmiHandlerDataOnSmiEntry (
     SmiHandlerStruct->Handler           = (UINTN)SmiHandler->Handler;
     SmiHandlerStruct->ImageRef          = AddressToImageRef ((UINTN)SmiHandler->Handler);
     SmiHandlerStruct->ContextBufferSize = (UINT32)SmiHandler->ContextSize;
+    SmiHandlerStruct->InvocationCount   = SmiHandler->InvocationCount;
+    SmiHandlerStruct->TotalTimeNs       = GetTimeInNanoSecond (SmiHandler->TotalTicks);
     if (SmiHandler->ContextSize != 0) {
       SmiHandlerStruct->ContextBufferOffset = sizeof (SMM_CORE_SMI_HANDLER_STRUCTURE);
       CopyMem ((UINT8 *)SmiHandlerStruct + SmiHandlerStruct->ContextBufferOffset, SmiHandler->Context, SmiHandler->ContextSize);
@@ -929,6 +931,64 @@ SmiHandlerProfileCopyData (
   *DataOffset = *DataOffset + *DataSize;
 }
 
+/**
+  Update the invocation count and time of the SMI handlers in the SMI handler
+  profile database with the current values.
+
+  The database is built when SMM is locked. The root and GUID SMI handlers are
+  dispatched by SmiManage(), which counts the calls of every handler. The
+  hardware SMI handlers are dispatched by the SmmChildDispatcher, so they have
+  no counters.
+**/
+VOID
+UpdateSmiHandlerProfileCounters (
+  VOID
+  )
+{
+  SMM_CORE_SMI_DATABASE_STRUCTURE  *SmiStruct;
+  SMM_CORE_SMI_HANDLER_STRUCTURE   *SmiHandlerStruct;
+  SMI_ENTRY                        *SmiEntry;
+  SMI_HANDLER                      *SmiHandler;
+  LIST_ENTRY                       *ListEntry;
+  UINTN                            Offset;
+  UINT32                           Index;
+
+  Offset = mSmmImageDatabaseSize;
+  while (Offset < mSmmImageDatabaseSize + mSmmRootSmiDatabaseSize + mSmmSmiDatabaseSize) {
+    SmiStruct = (SMM_CORE_SMI_DATABASE_STRUCTURE *)((UINT8 *)mSmiHandlerProfileDatabase + Offset);
+    Offset   += SmiStruct->Header.Length;
+
+    if (SmiStruct->HandlerCategory == SmmCoreSmiHandlerCategoryRootHandler) {
+      SmiEntry = &mRootSmiEntry;
+    } else {
+      SmiEntry = SmmCoreFindSmiEntry (&SmiStruct->HandlerType, FALSE);
+      if (SmiEntry == NULL) {
+        continue;
+      }
+    }
+
+    SmiHandlerStruct = (SMM_CORE_SMI_HANDLER_STRUCTURE *)(SmiStruct + 1);
+    for (Index = 0; Index < SmiStruct->HandlerCount; Index++) {
+      ListEntry = &SmiEntry->SmiHandlers;
+      for (ListEntry = ListEntry->ForwardLink;
+           ListEntry != &SmiEntry->SmiHandlers;
+           ListEntry = ListEntry->ForwardLink)
+      {
+        SmiHandler = CR (ListEntry, SMI_HANDLER, Link, SMI_HANDLER_SIGNATURE);
+        if ((SmiHandlerStruct->Handler == (UINTN)SmiHandler->Handler) &&
+            (SmiHandlerStruct->CallerAddr == (UINTN)SmiHandler->CallerAddr))
+        {
+          SmiHandlerStruct->InvocationCount = SmiHandler->InvocationCount;
+          SmiHandlerStruct->TotalTimeNs     = GetTimeInNanoSecond (SmiHandler->TotalTicks);
+          break;
+        }
+      }
+
+      SmiHandlerStruct = (SMM_CORE_SMI_HANDLER_STRUCTURE *)((UINTN)SmiHandlerStruct + SmiHandlerStruct->Length);
+    }
+  }
+}
+
 /**
   SMI handler profile handler to get info.
 
@@ -945,6 +1005,8 @@ SmiHandlerProfileHandlerGetInfo (
   SmiHandlerProfileRecordingStatus  = mSmiHandlerProfileRecordingStatus;
   mSmiHandlerProfileRecordingStatus = FALSE;
 
+  UpdateSmiHandlerProfileCounters ();
+
   SmiHandlerProfileParameterGetInfo->DataSize            = mSmiHandlerProfileDatabaseSize;
   SmiHandlerProfileParameterGetInfo->Header.ReturnStatus = 0;
 
@@ -1130,7 +1192,7 @@ SmmCoreFindHardwareSmiEntry (
   // allocate a new entry
   //
   if ((SmiEntry == NULL) && Create) {
-    SmiEntry = AllocatePool (sizeof (SMI_ENTRY));
+    SmiEntry = AllocateZeroPool (sizeof (SMI_ENTRY));
     if (SmiEntry != NULL) {
       //
       // Initialize new SMI entry structure
@@ -0,0 +1,194 @@
+/** @file
+  SMI latency histogram of the SMI handlers.
+
+  SmiManage() adds the time spent in the handlers of an SMI entry to the
+  histogram of that entry. The histograms are returned to the non-SMM
+  environment by the gSmiLatencyHistogramGuid SMI handler.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "PiSmmCore.h"
+
+extern LIST_ENTRY  mSmiEntryList;
+extern SMI_ENTRY   mRootSmiEntry;
+
+UINT64  mSmiLatencyCounterStart = 0;
+UINT64  mSmiLatencyCounterEnd   = 0;
+
+/**
+  Return the number of performance counter ticks between two counter values.
+
+  @param  StartCounter   The performance counter value at the start.
+  @param  EndCounter     The performance counter value at the end.
+
+  @return The number of ticks from StartCounter to EndCounter.
+
+**/
+UINT64
+SmiLatencyGetElapsedTicks (
+  IN UINT64  StartCounter,
+  IN UINT64  EndCounter
+  )
+{
+  if (mSmiLatencyCounterStart == mSmiLatencyCounterEnd) {
+    GetPerformanceCounterProperties (&mSmiLatencyCounterStart, &mSmiLatencyCounterEnd);
+  }
+
+  //
+  // Take the counter wrap around into account.
+  //
+  if (mSmiLatencyCounterStart < mSmiLatencyCounterEnd) {
+    if (EndCounter >= StartCounter) {
+      return EndCounter - StartCounter;
+    }
+
+    return (mSmiLatencyCounterEnd - StartCounter) + (EndCounter - mSmiLatencyCounterStart);
+  }
+
+  if (StartCounter >= EndCounter) {
+    return StartCounter - EndCounter;
+  }
+
+  return (StartCounter - mSmiLatencyCounterEnd) + (mSmiLatencyCounterStart - EndCounter);
+}
+
+/**
+  Add the time elapsed since a performance counter value to an SMI latency histogram.
+
+  @param  Histogram      The SMI latency histogram.
+  @param  StartCounter   The performance counter value at the start of the sample.
+
+**/
+VOID
+SmiLatencyHistogramAdd (
+  IN OUT SMI_LATENCY_HISTOGRAM  *Histogram,
+  IN     UINT64                 StartCounter
+  )
+{
+  UINT64  Ns;
+  INTN    Bucket;
+
+  Ns     = GetTimeInNanoSecond (SmiLatencyGetElapsedTicks (StartCounter, GetPerformanceCounter ()));
+  Bucket = HighBitSet64 (Ns);
+  if (Bucket < 0) {
+    Bucket = 0;
+  } else if (Bucket >= SMI_LATENCY_HISTOGRAM_BUCKET_COUNT) {
+    Bucket = SMI_LATENCY_HISTOGRAM_BUCKET_COUNT - 1;
+  }
+
+  Histogram->Count++;
+  Histogram->TotalNs += Ns;
+  Histogram->Bucket[Bucket]++;
+  if (Ns > Histogram->MaxNs) {
+    Histogram->MaxNs = Ns;
+  }
+}
+
+/**
+  Return the SMI latency histogram of one SMI entry.
+
+  @param  Parameter   The parameter of the get handler command in SMRAM.
+
+**/
+VOID
+SmiLatencyHistogramGetHandler (
+  IN OUT SMI_LATENCY_HISTOGRAM_PARAMETER_GET_HANDLER  *Parameter
+  )
+{
+  LIST_ENTRY  *Link;
+  SMI_ENTRY   *SmiEntry;
+  UINT32      Index;
+
+  if (Parameter->Index == 0) {
+    SmiEntry = &mRootSmiEntry;
+  } else {
+    SmiEntry = NULL;
+    Index    = 1;
+    for (Link = GetFirstNode (&mSmiEntryList); !IsNull (&mSmiEntryList, Link); Link = GetNextNode (&mSmiEntryList, Link)) {
+      if (Index == Parameter->Index) {
+        SmiEntry = CR (Link, SMI_ENTRY, AllEntries, SMI_ENTRY_SIGNATURE);
+        break;
+      }
+
+      Index++;
+    }
+
+    if (SmiEntry == NULL) {
+      Parameter->Header.ReturnStatus = (UINT64)(INT64)(INTN)EFI_NOT_FOUND;
+      return;
+    }
+  }
+
+  CopyGuid (&Parameter->HandlerType, &SmiEntry->HandlerType);
+  CopyMem (&Parameter->Histogram, &SmiEntry->Latency, sizeof (Parameter->Histogram));
+  Parameter->Header.ReturnStatus = 0;
+}
+
+/**
+  SMI handler that returns the SMI latency histogram of the SMI handlers.
+
+  The SMM CPU driver registers a handler for the same GUID to return the
+  histograms of the SMI phases, so other commands are left to that handler.
+
+  @param  DispatchHandle  The unique handle assigned to this handler by SmiHandlerRegister().
+  @param  Context         Points to an optional handler context which was specified when the handler was registered.
+  @param  CommBuffer      A pointer to a collection of data in memory that will
+                          be conveyed from a non-SMM environment into an SMM environment.
+  @param  CommBufferSize  The size of the CommBuffer.
+
+  @return Status Code
+
+**/
+EFI_STATUS
+EFIAPI
+SmiLatencyHistogramHandler (
+  IN     EFI_HANDLE  DispatchHandle,
+  IN     CONST VOID  *Context         OPTIONAL,
+  IN OUT VOID        *CommBuffer      OPTIONAL,
+  IN OUT UINTN       *CommBufferSize  OPTIONAL
+  )
+{
+  SMI_LATENCY_HISTOGRAM_PARAMETER_GET_HANDLER  GetHandler;
+  UINTN                                        TempCommBufferSize;
+
+  //
+  // If input is invalid, stop processing this SMI
+  //
+  if ((CommBuffer == NULL) || (CommBufferSize == NULL)) {
+    return EFI_SUCCESS;
+  }
+
+  TempCommBufferSize = *CommBufferSize;
+
+  if (TempCommBufferSize < sizeof (SMI_LATENCY_HISTOGRAM_PARAMETER_HEADER)) {
+    DEBUG ((DEBUG_ERROR, "SmiLatencyHistogramHandler: SMM communication buffer size invalid!\n"));
+    return EFI_SUCCESS;
+  }
+
+  if (!SmmIsBufferOutsideSmmValid ((UINTN)CommBuffer, TempCommBufferSize)) {
+    DEBUG ((DEBUG_ERROR, "SmiLatencyHistogramHandler: SMM communication buffer in SMRAM or overflow!\n"));
+    return EFI_SUCCESS;
+  }
+
+  if (((SMI_LATENCY_HISTOGRAM_PARAMETER_HEADER *)CommBuffer)->Command != SMI_LATENCY_HISTOGRAM_COMMAND_GET_HANDLER) {
+    return EFI_WARN_INTERRUPT_SOURCE_PENDING;
+  }
+
+  if (TempCommBufferSize != sizeof (SMI_LATENCY_HISTOGRAM_PARAMETER_GET_HANDLER)) {
+    DEBUG ((DEBUG_ERROR, "SmiLatencyHistogramHandler: SMM communication buffer size invalid!\n"));
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Work on a copy in SMRAM so the non-SMM environment cannot change the
+  // parameter while it is used.
+  //
+  CopyMem (&GetHandler, CommBuffer, sizeof (GetHandler));
+  SmiLatencyHistogramGetHandler (&GetHandler);
+  CopyMem (CommBuffer, &GetHandler, sizeof (GetHandler));
+
+  return EFI_SUCCESS;
+}
@@ -0,0 +1,346 @@
+/** @file
+  SMI trace of the SMI handlers.
+
+  SmiManage() adds a record of every root and GUIDed SMI handler call to a
+  ring buffer of the CPU that runs it. Adding a record only stores the values
+  already known by SmiManage(), so the trace can be left enabled in production
+  builds. The records are returned to the non-SMM environment by the
+  gSmiTraceGuid SMI handler.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "PiSmmCore.h"
+
+typedef struct {
+  UINT64              TotalCount;
+  UINT32              Next;
+  SMI_TRACE_RECORD    *Records;
+} SMI_TRACE_RING;
+
+BOOLEAN         mSmiTraceInitialized  = FALSE;
+UINT32          mSmiTraceRecordCount  = 0;
+UINTN           mSmiTraceNumberOfCpus = 0;
+SMI_TRACE_RING  *mSmiTraceRings       = NULL;
+
+//
+// The communicate buffer validated by SmmEntryPoint(), while the handlers of
+// the communicate GUID are dispatched.
+//
+VOID  *mSmiTraceCommBuffer = NULL;
+
+/**
+  Allocate the SMI trace ring buffers of all CPUs if the SMI trace is enabled.
+
+  It does nothing when the ring buffers are already allocated.
+
+**/
+VOID
+SmiTraceInitialize (
+  VOID
+  )
+{
+  UINTN             RecordsSize;
+  SMI_TRACE_RECORD  *Records;
+  UINTN             Index;
+
+  if (mSmiTraceInitialized) {
+    return;
+  }
+
+  mSmiTraceInitialized = TRUE;
+  if ((PcdGet32 (PcdSmiTraceRecordCount) == 0) || (gSmmCoreSmst.NumberOfCpus == 0)) {
+    return;
+  }
+
+  if (EFI_ERROR (SafeUintnMult (sizeof (SMI_TRACE_RECORD) * PcdGet32 (PcdSmiTraceRecordCount), gSmmCoreSmst.NumberOfCpus, &RecordsSize))) {
+    return;
+  }
+
+  mSmiTraceRings = AllocateZeroPool (sizeof (SMI_TRACE_RING) * gSmmCoreSmst.NumberOfCpus);
+  Records        = AllocatePool (RecordsSize);
+  if ((mSmiTraceRings == NULL) || (Records == NULL)) {
+    DEBUG ((DEBUG_ERROR, "SmiTraceInitialize: Out of resources for %Lu SMI trace records!\n", (UINT64)(RecordsSize / sizeof (SMI_TRACE_RECORD))));
+    if (mSmiTraceRings != NULL) {
+      FreePool (mSmiTraceRings);
+      mSmiTraceRings = NULL;
+    }
+
+    if (Records != NULL) {
+      FreePool (Records);
+    }
+
+    return;
+  }
+
+  mSmiTraceRecordCount  = PcdGet32 (PcdSmiTraceRecordCount);
+  mSmiTraceNumberOfCpus = gSmmCoreSmst.NumberOfCpus;
+  for (Index = 0; Index < mSmiTraceNumberOfCpus; Index++) {
+    mSmiTraceRings[Index].Records = Records + Index * mSmiTraceRecordCount;
+  }
+}
+
+/**
+  Add the record of an SMI handler call to the SMI trace ring buffer of the current CPU.
+
+  @param  HandlerType     The GUID of the SMI handler, or NULL for a root SMI handler.
+  @param  SmiHandler      The SMI handler.
+  @param  StartCounter    The performance counter value when the handler was called.
+  @param  Ticks           The number of performance counter ticks spent in the handler.
+  @param  CommBuffer      The communication buffer passed to the handler.
+  @param  CommBufferSize  The size of the communication buffer passed to the handler.
+  @param  Status          The status returned by the handler.
+
+**/
+VOID
+SmiTraceRecord (
+  IN CONST EFI_GUID  *HandlerType OPTIONAL,
+  IN SMI_HANDLER     *SmiHandler,
+  IN UINT64          StartCounter,
+  IN UINT64          Ticks,
+  IN VOID            *CommBuffer OPTIONAL,
+  IN UINTN           CommBufferSize,
+  IN EFI_STATUS      Status
+  )
+{
+  SMI_TRACE_RING    *Ring;
+  SMI_TRACE_RECORD  *Record;
+
+  if ((mSmiTraceRings == NULL) || (gSmmCoreSmst.CurrentlyExecutingCpu >= mSmiTraceNumberOfCpus)) {
+    return;
+  }
+
+  Ring   = &mSmiTraceRings[gSmmCoreSmst.CurrentlyExecutingCpu];
+  Record = &Ring->Records[Ring->Next];
+  if (HandlerType != NULL) {
+    CopyGuid (&Record->HandlerType, HandlerType);
+  } else {
+    ZeroMem (&Record->HandlerType, sizeof (Record->HandlerType));
+  }
+
+  //
+  // Keep the handler address and the ticks here. They are converted to the
+  // image GUID, the offset and nanoseconds when the record is read.
+  //
+  Record->HandlerOffset = (UINTN)SmiHandler->Handler;
+  Record->StartCounter  = StartCounter;
+  Record->DurationNs    = Ticks;
+  Record->Status        = (UINT64)(INT64)(INTN)Status;
+
+  //
+  // Only the communicate buffer validated by SmmEntryPoint() is recorded.
+  //
+  if ((CommBuffer != NULL) && (CommBuffer == mSmiTraceCommBuffer)) {
+    Record->CommBuffer     = (UINTN)CommBuffer;
+    Record->CommBufferSize = CommBufferSize;
+  } else {
+    Record->CommBuffer     = 0;
+    Record->CommBufferSize = 0;
+  }
+
+  Ring->TotalCount++;
+  Ring->Next++;
+  if (Ring->Next == mSmiTraceRecordCount) {
+    Ring->Next = 0;
+  }
+}
+
+/**
+  Translate the address of an SMI handler to the SMM image containing it.
+
+  Only the file GUID of the image and the offset in it are returned to the
+  non-SMM environment, as the SMI handler profile does, so no SMRAM address
+  is exposed.
+
+  @param  Address    The address of the SMI handler.
+  @param  ImageGuid  Return the file GUID of the image, or zero if the image is unknown.
+  @param  Offset     Return the offset of the handler in the image, or zero if the image is unknown.
+
+**/
+VOID
+SmiTraceGetHandlerImage (
+  IN  UINT64    Address,
+  OUT EFI_GUID  *ImageGuid,
+  OUT UINT64    *Offset
+  )
+{
+  LIST_ENTRY            *Link;
+  EFI_SMM_DRIVER_ENTRY  *DriverEntry;
+
+  if ((Address >= gSmmCorePrivate->PiSmmCoreImageBase) &&
+      (Address < gSmmCorePrivate->PiSmmCoreImageBase + gSmmCorePrivate->PiSmmCoreImageSize))
+  {
+    CopyGuid (ImageGuid, &gEfiCallerIdGuid);
+    *Offset = Address - gSmmCorePrivate->PiSmmCoreImageBase;
+    return;
+  }
+
+  for (Link = mDiscoveredList.ForwardLink; Link != &mDiscoveredList; Link = Link->ForwardLink) {
+    DriverEntry = CR (Link, EFI_SMM_DRIVER_ENTRY, Link, EFI_SMM_DRIVER_ENTRY_SIGNATURE);
+    if ((DriverEntry->ImageBuffer != 0) &&
+        (Address >= DriverEntry->ImageBuffer) &&
+        (Address < DriverEntry->ImageBuffer + EFI_PAGES_TO_SIZE (DriverEntry->NumberOfPage)))
+    {
+      CopyGuid (ImageGuid, &DriverEntry->FileName);
+      *Offset = Address - DriverEntry->ImageBuffer;
+      return;
+    }
+  }
+
+  ZeroMem (ImageGuid, sizeof (EFI_GUID));
+  *Offset = 0;
+}
+
+/**
+  Return the SMI trace records of one CPU.
+
+  @param  Parameter       The parameter of the get records command in SMRAM.
+  @param  Records         The buffer for the records following the parameter
+                          in the communicate buffer.
+  @param  MaxRecordCount  The number of records that fit in Records.
+
+**/
+VOID
+SmiTraceGetRecords (
+  IN OUT SMI_TRACE_PARAMETER_GET_RECORDS  *Parameter,
+  OUT    SMI_TRACE_RECORD                 *Records,
+  IN     UINTN                            MaxRecordCount
+  )
+{
+  SMI_TRACE_RING    *Ring;
+  SMI_TRACE_RECORD  Record;
+  UINT64            Available;
+  UINT32            Oldest;
+  UINTN             Count;
+  UINTN             Index;
+
+  if (mSmiTraceRings == NULL) {
+    Parameter->Header.ReturnStatus = (UINT64)(INT64)(INTN)EFI_UNSUPPORTED;
+    return;
+  }
+
+  if (Parameter->CpuIndex >= mSmiTraceNumberOfCpus) {
+    Parameter->Header.ReturnStatus = (UINT64)(INT64)(INTN)EFI_INVALID_PARAMETER;
+    return;
+  }
+
+  Ring = &mSmiTraceRings[Parameter->CpuIndex];
+  if (Ring->TotalCount > mSmiTraceRecordCount) {
+    Available = mSmiTraceRecordCount;
+    Oldest    = Ring->Next;
+  } else {
+    Available = Ring->TotalCount;
+    Oldest    = 0;
+  }
+
+  Count = MIN (Parameter->RecordCount, MaxRecordCount);
+  if (Parameter->Index >= Available) {
+    Count = 0;
+  } else if (Count > Available - Parameter->Index) {
+    Count = (UINTN)(Available - Parameter->Index);
+  }
+
+  for (Index = 0; Index < Count; Index++) {
+    CopyMem (
+      &Record,
+      &Ring->Records[ModU64x32 (Oldest + Parameter->Index + Index, mSmiTraceRecordCount)],
+      sizeof (Record)
+      );
+    SmiTraceGetHandlerImage (Record.HandlerOffset, &Record.ImageGuid, &Record.HandlerOffset);
+    Record.DurationNs = GetTimeInNanoSecond (Record.DurationNs);
+    CopyMem (&Records[Index], &Record, sizeof (Record));
+  }
+
+  Parameter->RecordCount         = (UINT32)Count;
+  Parameter->TotalCount          = Ring->TotalCount;
+  Parameter->Header.ReturnStatus = 0;
+}
+
+/**
+  SMI handler that returns the SMI trace records.
+
+  @param  DispatchHandle  The unique handle assigned to this handler by SmiHandlerRegister().
+  @param  Context         Points to an optional handler context which was specified when the handler was registered.
+  @param  CommBuffer      A pointer to a collection of data in memory that will
+                          be conveyed from a non-SMM environment into an SMM environment.
+  @param  CommBufferSize  The size of the CommBuffer.
+
+  @return Status Code
+
+**/
+EFI_STATUS
+EFIAPI
+SmiTraceHandler (
+  IN     EFI_HANDLE  DispatchHandle,
+  IN     CONST VOID  *Context         OPTIONAL,
+  IN OUT VOID        *CommBuffer      OPTIONAL,
+  IN OUT UINTN       *CommBufferSize  OPTIONAL
+  )
+{
+  SMI_TRACE_PARAMETER_HEADER       *Header;
+  SMI_TRACE_PARAMETER_GET_INFO     *GetInfo;
+  SMI_TRACE_PARAMETER_GET_RECORDS  GetRecords;
+  UINTN                            TempCommBufferSize;
+
+  //
+  // If input is invalid, stop processing this SMI
+  //
+  if ((CommBuffer == NULL) || (CommBufferSize == NULL)) {
+    return EFI_SUCCESS;
+  }
+
+  TempCommBufferSize = *CommBufferSize;
+
+  if (TempCommBufferSize < sizeof (SMI_TRACE_PARAMETER_HEADER)) {
+    DEBUG ((DEBUG_ERROR, "SmiTraceHandler: SMM communication buffer size invalid!\n"));
+    return EFI_SUCCESS;
+  }
+
+  if (!SmmIsBufferOutsideSmmValid ((UINTN)CommBuffer, TempCommBufferSize)) {
+    DEBUG ((DEBUG_ERROR, "SmiTraceHandler: SMM communication buffer in SMRAM or overflow!\n"));
+    return EFI_SUCCESS;
+  }
+
+  Header               = (SMI_TRACE_PARAMETER_HEADER *)CommBuffer;
+  Header->ReturnStatus = (UINT64)(INT64)(INTN)EFI_INVALID_PARAMETER;
+
+  switch (Header->Command) {
+    case SMI_TRACE_COMMAND_GET_INFO:
+      if (TempCommBufferSize != sizeof (SMI_TRACE_PARAMETER_GET_INFO)) {
+        DEBUG ((DEBUG_ERROR, "SmiTraceHandler: SMM communication buffer size invalid!\n"));
+        break;
+      }
+
+      GetInfo                      = (SMI_TRACE_PARAMETER_GET_INFO *)CommBuffer;
+      GetInfo->NumberOfCpus        = (UINT32)mSmiTraceNumberOfCpus;
+      GetInfo->RecordCount         = mSmiTraceRecordCount;
+      GetInfo->Header.ReturnStatus = 0;
+      break;
+
+    case SMI_TRACE_COMMAND_GET_RECORDS:
+      if (TempCommBufferSize < sizeof (SMI_TRACE_PARAMETER_GET_RECORDS)) {
+        DEBUG ((DEBUG_ERROR, "SmiTraceHandler: SMM communication buffer size invalid!\n"));
+        break;
+      }
+
+      //
+      // Work on a copy in SMRAM so the non-SMM environment cannot change the
+      // parameter while it is used.
+      //
+      CopyMem (&GetRecords, CommBuffer, sizeof (GetRecords));
+      SmiTraceGetRecords (
+        &GetRecords,
+        (SMI_TRACE_RECORD *)((SMI_TRACE_PARAMETER_GET_RECORDS *)CommBuffer + 1),
+        (TempCommBufferSize - sizeof (SMI_TRACE_PARAMETER_GET_RECORDS)) / sizeof (SMI_TRACE_RECORD)
+        );
+      CopyMem (CommBuffer, &GetRecords, sizeof (GetRecords));
+      break;
+
+    default:
+      break;
+  }
+
+  return EFI_SUCCESS;
+}
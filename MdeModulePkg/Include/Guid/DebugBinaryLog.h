@@ -0,0 +1,123 @@
+/** @file
+  Record format of the binary (deferred formatting) debug log.
+
+  A DebugLib instance producing this log does not format DEBUG() messages on
+  the target. Each message becomes one DEBUG_BINARY_LOG_RECORD that holds the
+  module GUID, the location of the format string relative to the module's
+  gEfiCallerIdGuid, and the raw arguments consumed by the format string. A
+  host tool finds the module image by its GUID, reads the format string out of
+  the image and formats the message.
+
+  Records are written to an optional memory ring buffer that starts with a
+  DEBUG_BINARY_LOG_BUFFER_HEADER, and optionally streamed to the serial port.
+
+  <pre>
+  Memory ring buffer:
+  +---------------+-----------------------------------------------------+
+  | Buffer Header | Data: records, wrapping around at DataSize          |
+  +---------------+-----------------------------------------------------+
+                                  ^
+                                  +---- WriteCount modulo DataSize
+
+  Record:
+  +---------------+-------+---------+-------+---------+-----+
+  | Record Header | Tag 1 | Value 1 | Tag 2 | Value 2 | ... |
+  +---------------+-------+---------+-------+---------+-----+
+  </pre>
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef DEBUG_BINARY_LOG_H_
+#define DEBUG_BINARY_LOG_H_
+
+///
+/// Signature of the memory ring buffer header.
+///
+#define EDKII_DEBUG_BINARY_LOG_GUID \
+  { \
+    0x039260dd, 0x1de8, 0x418e, { 0x82, 0x38, 0x7f, 0x70, 0xc5, 0xad, 0x80, 0x29 } \
+  }
+
+#define DEBUG_BINARY_LOG_VERSION  1
+
+#define DEBUG_BINARY_LOG_RECORD_SIGNATURE  SIGNATURE_16 ('D', 'b')
+
+///
+/// Maximum size of one record, including its header.
+///
+#define DEBUG_BINARY_LOG_MAX_RECORD_SIZE  0x100
+
+///
+/// Argument tags. Every argument is a one byte tag followed by its value.
+///
+#define DEBUG_BINARY_LOG_ARG_UINT32  0x01    ///< UINT32 value.
+#define DEBUG_BINARY_LOG_ARG_UINT64  0x02    ///< UINT64 value.
+#define DEBUG_BINARY_LOG_ARG_STRING  0x03    ///< UINT8 length, then that many ASCII characters.
+#define DEBUG_BINARY_LOG_ARG_GUID    0x04    ///< GUID value.
+#define DEBUG_BINARY_LOG_ARG_TIME    0x05    ///< UINT16 Year, then UINT8 Month, Day, Hour and Minute.
+#define DEBUG_BINARY_LOG_ARG_STATUS  0x06    ///< RETURN_STATUS widened to 64 bits, error bit in bit 63.
+#define DEBUG_BINARY_LOG_ARG_NULL    0x07    ///< NULL string, GUID or TIME pointer, no value.
+
+///
+/// Set in DEBUG_BINARY_LOG_RECORD.Flags when arguments were dropped because
+/// the record reached DEBUG_BINARY_LOG_MAX_RECORD_SIZE.
+///
+#define DEBUG_BINARY_LOG_RECORD_TRUNCATED  BIT0
+
+///
+/// Set in DEBUG_BINARY_LOG_RECORD.Flags when the record was produced by
+/// DebugAssert().
+///
+#define DEBUG_BINARY_LOG_RECORD_ASSERT  BIT1
+
+///
+/// Set in DEBUG_BINARY_LOG_RECORD.Flags when the format string does not live
+/// in the image of the emitting module. The format string is then stored as
+/// the first DEBUG_BINARY_LOG_ARG_STRING argument and FormatOffset is 0.
+///
+#define DEBUG_BINARY_LOG_RECORD_INLINE_FORMAT  BIT2
+
+#pragma pack(1)
+
+typedef struct {
+  ///
+  /// EDKII_DEBUG_BINARY_LOG_GUID once the buffer is initialized.
+  ///
+  GUID      Signature;
+  UINT32    Version;
+  ///
+  /// Size of the data area that follows this header, in bytes.
+  ///
+  UINT32    DataSize;
+  ///
+  /// Number of bytes ever written. The next record starts at WriteCount
+  /// modulo DataSize; the oldest complete records may have been overwritten.
+  ///
+  UINT64    WriteCount;
+} DEBUG_BINARY_LOG_BUFFER_HEADER;
+
+typedef struct {
+  UINT16    Signature;
+  ///
+  /// Size of the record, including this header and the arguments.
+  ///
+  UINT16    Size;
+  UINT32    ErrorLevel;
+  GUID      ModuleGuid;
+  ///
+  /// Address of the format string minus the address of gEfiCallerIdGuid in
+  /// the module that emitted the record.
+  ///
+  INT32     FormatOffset;
+  UINT8     Flags;
+  UINT8     Reserved[3];
+} DEBUG_BINARY_LOG_RECORD;
+
+#pragma pack()
+
+extern GUID  gEdkiiDebugBinaryLogGuid;
+
+#endif
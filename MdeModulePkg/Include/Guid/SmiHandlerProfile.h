@@ -41,7 +41,7 @@ typedef struct {
 } SMM_CORE_IMAGE_DATABASE_STRUCTURE;
 
 #define SMM_CORE_SMI_DATABASE_SIGNATURE  SIGNATURE_32 ('S','C','S','D')
-#define SMM_CORE_SMI_DATABASE_REVISION   0x0001
+#define SMM_CORE_SMI_DATABASE_REVISION   0x0002
 
 typedef enum {
   SmmCoreSmiHandlerCategoryRootHandler,
@@ -84,6 +84,13 @@ typedef struct {
   UINT16              ContextBufferOffset;
   UINT8               Reserved[2];
   UINT32              ContextBufferSize;
+  //
+  // Added in SMM_CORE_SMI_DATABASE_REVISION 0x0002.
+  // The number of calls of the handler and the total time spent in it.
+  // They are zero for the SmmCoreSmiHandlerCategoryHardwareHandler.
+  //
+  UINT64              InvocationCount;
+  UINT64              TotalTimeNs;
   // UINT8                 ContextBuffer[];
 } SMM_CORE_SMI_HANDLER_STRUCTURE;
 
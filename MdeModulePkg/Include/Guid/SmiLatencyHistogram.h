@@ -0,0 +1,80 @@
+/** @file
+  Header file for SMI latency histogram definition.
+
+  The SMM CPU driver keeps a histogram of the SMI residency for every phase of
+  the SMI, and the SMM core keeps one for every GUID of the SMI handlers it
+  dispatches. The histograms are always recorded in SMRAM and can be read
+  through the SMM communicate protocol with gSmiLatencyHistogramGuid.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#pragma once
+
+#define SMI_LATENCY_HISTOGRAM_GUID \
+  { \
+    0x9de1269f, 0x74c7, 0x45d7, { 0x9f, 0x99, 0x21, 0x32, 0x71, 0x18, 0x93, 0x88 } \
+  }
+
+#define SMI_LATENCY_HISTOGRAM_BUCKET_COUNT  40
+
+///
+/// Bucket N counts the samples from 2^N to 2^(N+1) - 1 nanoseconds. Bucket 0
+/// also counts the samples below 1 nanosecond, and the last bucket counts all
+/// samples that are too long for the other buckets.
+///
+typedef struct {
+  UINT64    Count;
+  UINT64    TotalNs;
+  UINT64    MaxNs;
+  UINT64    Bucket[SMI_LATENCY_HISTOGRAM_BUCKET_COUNT];
+} SMI_LATENCY_HISTOGRAM;
+
+///
+/// The phases of an SMI measured by the BSP of the SMI.
+///
+typedef enum {
+  SmiLatencyPhaseRendezvous,  ///< From SMI entry to the SMM core dispatch.
+  SmiLatencyPhaseDispatch,    ///< The SMM core dispatch of the SMI handlers.
+  SmiLatencyPhaseExitSync,    ///< From the SMM core dispatch to the exit of all CPUs.
+  SmiLatencyPhaseTotal,       ///< From SMI entry to the exit of all CPUs.
+  SmiLatencyPhaseMax
+} SMI_LATENCY_PHASE;
+
+//
+// SMI latency histogram commands
+//
+#define SMI_LATENCY_HISTOGRAM_COMMAND_GET_PHASES   0x1
+#define SMI_LATENCY_HISTOGRAM_COMMAND_GET_HANDLER  0x2
+
+typedef struct {
+  UINT32    Command;
+  UINT32    DataLength;
+  UINT64    ReturnStatus;
+} SMI_LATENCY_HISTOGRAM_PARAMETER_HEADER;
+
+///
+/// Handled by the SMM CPU driver.
+///
+typedef struct {
+  SMI_LATENCY_HISTOGRAM_PARAMETER_HEADER    Header;
+  SMI_LATENCY_HISTOGRAM                     Phase[SmiLatencyPhaseMax];
+} SMI_LATENCY_HISTOGRAM_PARAMETER_GET_PHASES;
+
+///
+/// Handled by the SMM core. Index 0 returns the histogram of the root SMI
+/// handlers, with a zero HandlerType. The following indexes return the
+/// histograms of the GUIDed SMI handlers. EFI_NOT_FOUND is returned in
+/// ReturnStatus when Index is beyond the last one.
+///
+typedef struct {
+  SMI_LATENCY_HISTOGRAM_PARAMETER_HEADER    Header;
+  UINT32                                    Index;
+  UINT32                                    Reserved;
+  EFI_GUID                                  HandlerType;
+  SMI_LATENCY_HISTOGRAM                     Histogram;
+} SMI_LATENCY_HISTOGRAM_PARAMETER_GET_HANDLER;
+
+extern EFI_GUID  gSmiLatencyHistogramGuid;
@@ -0,0 +1,79 @@
+/** @file
+  Header file for SMI trace definition.
+
+  When PcdSmiTraceRecordCount is not zero, the SMM core records every call of a
+  root or GUIDed SMI handler in a ring buffer of the CPU that dispatched it.
+  The ring buffers are in SMRAM and can be read at runtime through the SMM
+  communicate protocol with gSmiTraceGuid.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#pragma once
+
+#define SMI_TRACE_GUID \
+  { \
+    0x060f17b5, 0x2ea4, 0x48ea, { 0xab, 0x9b, 0xe2, 0x22, 0x57, 0x25, 0x39, 0xd6 } \
+  }
+
+///
+/// One call of an SMI handler. HandlerType is zero for the root SMI handlers.
+/// The handler is identified by the file GUID of the SMM image containing it
+/// and its offset in that image, and both are zero when the image is unknown.
+/// CommBuffer and CommBufferSize describe the communicate buffer validated by
+/// the SMM core when the handler was called for an SMM communicate request,
+/// and they are zero for other calls.
+///
+typedef struct {
+  EFI_GUID    HandlerType;
+  EFI_GUID    ImageGuid;
+  UINT64      HandlerOffset;
+  UINT64      StartCounter;     ///< Performance counter value when the handler was called.
+  UINT64      DurationNs;
+  UINT64      CommBuffer;
+  UINT64      CommBufferSize;
+  UINT64      Status;           ///< EFI_STATUS returned by the handler.
+} SMI_TRACE_RECORD;
+
+//
+// SMI trace commands
+//
+#define SMI_TRACE_COMMAND_GET_INFO     0x1
+#define SMI_TRACE_COMMAND_GET_RECORDS  0x2
+
+typedef struct {
+  UINT32    Command;
+  UINT32    DataLength;
+  UINT64    ReturnStatus;
+} SMI_TRACE_PARAMETER_HEADER;
+
+///
+/// RecordCount is the number of records in the ring buffer of each CPU. Both
+/// fields are zero when the SMI trace is disabled.
+///
+typedef struct {
+  SMI_TRACE_PARAMETER_HEADER    Header;
+  UINT32                        NumberOfCpus;
+  UINT32                        RecordCount;
+} SMI_TRACE_PARAMETER_GET_INFO;
+
+///
+/// Returns up to RecordCount records of the ring buffer of CpuIndex, starting
+/// from the record Index, where record 0 is the oldest one in the ring buffer.
+/// The records follow this structure in the communicate buffer. On return,
+/// RecordCount is the number of the returned records, and TotalCount is the
+/// number of the records ever added to the ring buffer of CpuIndex. Records
+/// were overwritten when TotalCount is bigger than the ring buffer size.
+///
+typedef struct {
+  SMI_TRACE_PARAMETER_HEADER    Header;
+  UINT32                        CpuIndex;
+  UINT32                        RecordCount;
+  UINT64                        Index;
+  UINT64                        TotalCount;
+  // SMI_TRACE_RECORD           Records[RecordCount];
+} SMI_TRACE_PARAMETER_GET_RECORDS;
+
+extern EFI_GUID  gSmiTraceGuid;
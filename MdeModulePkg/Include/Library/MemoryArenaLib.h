@@ -0,0 +1,271 @@
+/** @file
+  Memory arena (bump allocator) library.
+
+  A memory arena hands out small buffers by advancing an offset inside
+  page-granular chunks. Buffers are never freed individually; instead the
+  caller rolls the arena back to a previously taken mark or releases every
+  chunk at once. This suits parsers and converters that make a large number
+  of short-lived allocations whose lifetime ends with a single operation.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef MEMORY_ARENA_LIB_H_
+#define MEMORY_ARENA_LIB_H_
+
+#define MEMORY_ARENA_SIGNATURE  SIGNATURE_32 ('M', 'A', 'R', 'N')
+
+///
+/// Default number of pages requested for each arena chunk.
+///
+#define MEMORY_ARENA_DEFAULT_CHUNK_PAGES  16
+
+///
+/// Every buffer returned by the arena is aligned on this boundary.
+///
+#define MEMORY_ARENA_ALIGNMENT  sizeof (UINT64)
+
+///
+/// Arena state. The caller owns the storage of this structure, which
+/// typically lives in a module global or in the context structure whose
+/// lifetime matches the allocations.
+///
+typedef struct {
+  UINT32        Signature;
+  LIST_ENTRY    ChunkList;          ///< Chunks in allocation order; the last one is active.
+  UINTN         ChunkPages;         ///< Minimum size, in pages, of a new chunk.
+  UINT64        AllocationCount;    ///< Number of buffers handed out.
+  UINT64        ChunkAllocationCount; ///< Number of page allocations made for chunks.
+  UINTN         BytesInUse;         ///< Bytes currently handed out, including padding.
+  UINTN         PeakBytesInUse;     ///< High water mark of BytesInUse.
+} MEMORY_ARENA;
+
+///
+/// Opaque position inside an arena, as returned by MemoryArenaGetMark().
+///
+typedef struct {
+  VOID     *Chunk;
+  UINTN    Used;
+  UINTN    BytesInUse;
+} MEMORY_ARENA_MARK;
+
+///
+/// Usage counters of an arena.
+///
+typedef struct {
+  UINT64    AllocationCount;
+  UINT64    ChunkAllocationCount;
+  UINTN     ChunkCount;
+  UINTN     BytesInUse;
+  UINTN     PeakBytesInUse;
+} MEMORY_ARENA_STATISTICS;
+
+/**
+  Initialize an empty memory arena.
+
+  No memory is allocated until the first call to MemoryArenaAllocate().
+
+  If Arena is NULL, then ASSERT().
+
+  @param[out] Arena        The arena to initialize.
+  @param[in]  ChunkPages   Minimum number of 4 KB pages per chunk. If 0,
+                           MEMORY_ARENA_DEFAULT_CHUNK_PAGES is used.
+
+**/
+VOID
+EFIAPI
+MemoryArenaInitialize (
+  OUT MEMORY_ARENA  *Arena,
+  IN  UINTN         ChunkPages
+  );
+
+/**
+  Allocate a buffer from a memory arena.
+
+  The buffer is aligned on MEMORY_ARENA_ALIGNMENT and stays valid until the
+  arena is reset past it or freed. Requests larger than a chunk get a chunk
+  of their own.
+
+  If Arena is NULL or not initialized, then ASSERT().
+
+  @param[in, out] Arena          The arena to allocate from.
+  @param[in]      AllocationSize The number of bytes to allocate.
+
+  @return A pointer to the allocated buffer, or NULL if AllocationSize is 0
+          or there are not enough resources.
+
+**/
+VOID *
+EFIAPI
+MemoryArenaAllocate (
+  IN OUT MEMORY_ARENA  *Arena,
+  IN     UINTN         AllocationSize
+  );
+
+/**
+  Allocate a zero-filled buffer from a memory arena.
+
+  @param[in, out] Arena          The arena to allocate from.
+  @param[in]      AllocationSize The number of bytes to allocate.
+
+  @return A pointer to the allocated buffer, or NULL if AllocationSize is 0
+          or there are not enough resources.
+
+**/
+VOID *
+EFIAPI
+MemoryArenaAllocateZero (
+  IN OUT MEMORY_ARENA  *Arena,
+  IN     UINTN         AllocationSize
+  );
+
+/**
+  Copy a buffer into a memory arena.
+
+  If AllocationSize is not 0 and Buffer is NULL, then ASSERT().
+
+  @param[in, out] Arena          The arena to allocate from.
+  @param[in]      AllocationSize The number of bytes to allocate and copy.
+  @param[in]      Buffer         The buffer to copy.
+
+  @return A pointer to the new copy, or NULL if AllocationSize is 0 or there
+          are not enough resources.
+
+**/
+VOID *
+EFIAPI
+MemoryArenaAllocateCopy (
+  IN OUT MEMORY_ARENA  *Arena,
+  IN     UINTN         AllocationSize,
+  IN     CONST VOID    *Buffer
+  );
+
+/**
+  Record the current position of a memory arena.
+
+  @param[in]  Arena   The arena.
+  @param[out] Mark    Receives the current position.
+
+**/
+VOID
+EFIAPI
+MemoryArenaGetMark (
+  IN  MEMORY_ARENA       *Arena,
+  OUT MEMORY_ARENA_MARK  *Mark
+  );
+
+/**
+  Roll a memory arena back to a mark.
+
+  Every buffer allocated after the mark was taken becomes invalid, and the
+  chunks that were added after the mark are returned to the system.
+
+  If Mark was not taken from Arena, or the arena was already rolled back past
+  it, then ASSERT().
+
+  @param[in, out] Arena   The arena.
+  @param[in]      Mark    A position returned by MemoryArenaGetMark().
+
+**/
+VOID
+EFIAPI
+MemoryArenaResetToMark (
+  IN OUT MEMORY_ARENA             *Arena,
+  IN     CONST MEMORY_ARENA_MARK  *Mark
+  );
+
+/**
+  Invalidate every buffer of a memory arena but keep its first chunk for
+  reuse.
+
+  @param[in, out] Arena   The arena.
+
+**/
+VOID
+EFIAPI
+MemoryArenaReset (
+  IN OUT MEMORY_ARENA  *Arena
+  );
+
+/**
+  Return every chunk of a memory arena to the system.
+
+  The arena stays initialized and may be used again.
+
+  @param[in, out] Arena   The arena.
+
+**/
+VOID
+EFIAPI
+MemoryArenaFree (
+  IN OUT MEMORY_ARENA  *Arena
+  );
+
+/**
+  Check whether a buffer was allocated from a memory arena.
+
+  @param[in] Arena    The arena.
+  @param[in] Buffer   The buffer to check.
+
+  @retval TRUE    Buffer lies inside one of the arena chunks.
+  @retval FALSE   Buffer does not belong to the arena.
+
+**/
+BOOLEAN
+EFIAPI
+MemoryArenaContains (
+  IN CONST MEMORY_ARENA  *Arena,
+  IN CONST VOID          *Buffer
+  );
+
+/**
+  Retrieve the usage counters of a memory arena.
+
+  @param[in]  Arena        The arena.
+  @param[out] Statistics   Receives the counters.
+
+**/
+VOID
+EFIAPI
+MemoryArenaGetStatistics (
+  IN  CONST MEMORY_ARENA       *Arena,
+  OUT MEMORY_ARENA_STATISTICS  *Statistics
+  );
+
+/**
+  Select the memory arena that serves the pool requests of the calling module.
+
+  The UefiMemoryAllocationLibArena instance of MemoryAllocationLib serves small
+  boot services data pool requests from the selected arena, and FreePool() of
+  its buffers does nothing. Other MemoryAllocationLib instances ignore the
+  selection. Buffers that are handed to other agents must be allocated while
+  no arena is selected, and the buffers of the arena must not be freed with
+  FreePool() once another arena, or none, is selected.
+
+  @param[in] Arena   The arena, or NULL to send the pool requests to the
+                     system again.
+
+  @return The previously selected arena, or NULL if there was none.
+
+**/
+MEMORY_ARENA *
+EFIAPI
+MemoryArenaSetPoolArena (
+  IN MEMORY_ARENA  *Arena  OPTIONAL
+  );
+
+/**
+  Return the memory arena that serves the pool requests of the calling module.
+
+  @return The arena selected with MemoryArenaSetPoolArena(), or NULL.
+
+**/
+MEMORY_ARENA *
+EFIAPI
+MemoryArenaGetPoolArena (
+  VOID
+  );
+
+#endif
@@ -0,0 +1,100 @@
+/** @file
+  Disk I/O Cache protocol is produced by DiskIoDxe on the controller handle of
+  every physical media whose Disk I/O accesses are cached. It reports the hit
+  and miss counters of the cache and allows a consumer that accessed the media
+  through the Block I/O protocol directly to drop the cached data.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#pragma once
+
+#define EDKII_DISK_IO_CACHE_PROTOCOL_GUID \
+  { \
+    0x8dd26ce6, 0xca1f, 0x4717, { 0xbe, 0x9f, 0x42, 0x1c, 0xa7, 0xb7, 0x59, 0x11 } \
+  }
+
+typedef struct _EDKII_DISK_IO_CACHE_PROTOCOL EDKII_DISK_IO_CACHE_PROTOCOL;
+
+#define EDKII_DISK_IO_CACHE_PROTOCOL_REVISION  0x00010000
+
+typedef struct {
+  ///
+  /// The size in bytes of a cache line. It is a multiple of the block size.
+  ///
+  UINT32    LineSize;
+  ///
+  /// The number of cache lines allowed by the memory budget of the media.
+  ///
+  UINT32    LineCount;
+  ///
+  /// The number of cache lines holding valid data.
+  ///
+  UINT32    ValidLineCount;
+  UINT32    Reserved;
+  ///
+  /// The number of cache line lookups that found the data in the cache.
+  ///
+  UINT64    Hits;
+  ///
+  /// The number of cache line lookups that read the data from the media.
+  ///
+  UINT64    Misses;
+  ///
+  /// The number of cache lines read from the media ahead of a sequential access.
+  ///
+  UINT64    ReadAheadLines;
+  ///
+  /// The number of valid cache lines replaced by other data.
+  ///
+  UINT64    Evictions;
+  ///
+  /// The number of times the whole cache was dropped, because the media was
+  /// changed or on request of a consumer.
+  ///
+  UINT64    Invalidations;
+} EDKII_DISK_IO_CACHE_STATISTICS;
+
+/**
+  Return the counters of the Disk I/O cache.
+
+  @param[in]  This        Pointer to the EDKII_DISK_IO_CACHE_PROTOCOL instance.
+  @param[out] Statistics  Pointer to the buffer receiving the counters.
+
+  @retval EFI_SUCCESS            The counters are returned.
+  @retval EFI_INVALID_PARAMETER  Statistics is NULL.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_DISK_IO_CACHE_GET_STATISTICS)(
+  IN  EDKII_DISK_IO_CACHE_PROTOCOL    *This,
+  OUT EDKII_DISK_IO_CACHE_STATISTICS  *Statistics
+  );
+
+/**
+  Drop all the data held by the Disk I/O cache.
+
+  The cache is write-through, so no data is lost. A consumer calls it after
+  writing the media through the Block I/O protocol directly.
+
+  @param[in]  This        Pointer to the EDKII_DISK_IO_CACHE_PROTOCOL instance.
+
+  @retval EFI_SUCCESS     The cache is empty.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_DISK_IO_CACHE_INVALIDATE)(
+  IN EDKII_DISK_IO_CACHE_PROTOCOL  *This
+  );
+
+struct _EDKII_DISK_IO_CACHE_PROTOCOL {
+  UINT64                                Revision;
+  EDKII_DISK_IO_CACHE_GET_STATISTICS    GetStatistics;
+  EDKII_DISK_IO_CACHE_INVALIDATE        Invalidate;
+};
+
+extern EFI_GUID  gEdkiiDiskIoCacheProtocolGuid;
@@ -0,0 +1,122 @@
+/** @file
+  SD/MMC Command Queue protocol is produced by the SD/MMC host controller drivers
+  whose slots have a command queue engine, as defined by the eMMC 5.1 host
+  controller interface (CQHCI). It is installed on the handle of the
+  EFI_SD_MMC_PASS_THRU_PROTOCOL. The eMMC driver uses it to keep several read and
+  write tasks queued in an eMMC device in command queue mode.
+
+  The commands sent through EFI_SD_MMC_PASS_THRU_PROTOCOL to a slot with the
+  command queue enabled are executed in order with the queued tasks: a command
+  waits for the tasks queued before it, and the tasks queued after it wait for
+  the command.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#pragma once
+
+#include <Protocol/SdMmcPassThru.h>
+
+#define EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL_GUID \
+  { \
+    0xbe8e8fdd, 0x4553, 0x4c48, { 0xbc, 0x7a, 0xb9, 0x05, 0xf2, 0x19, 0x19, 0x2e } \
+  }
+
+typedef struct _EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL;
+
+/**
+  Enable the command queue engine of a slot.
+
+  The eMMC device of the slot must be selected. The caller sets the CMDQ_MODE_EN
+  field of the EXT_CSD register of the device when it returns EFI_SUCCESS, before
+  it queues the first task.
+
+  @param[in]      This          A pointer to the EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL instance.
+  @param[in]      Slot          The slot number of the eMMC device.
+  @param[in]      Rca           The relative device address of the eMMC device.
+  @param[in, out] QueueDepth    On input, the number of tasks the device can queue.
+                                On output, the number of tasks the host keeps queued
+                                in the device.
+
+  @retval EFI_SUCCESS           The command queue engine is enabled.
+  @retval EFI_INVALID_PARAMETER Slot or QueueDepth is invalid.
+  @retval EFI_UNSUPPORTED       The slot has no command queue engine.
+  @retval EFI_ALREADY_STARTED   The command queue engine is already enabled.
+  @retval EFI_OUT_OF_RESOURCES  The task descriptor list can't be allocated.
+  @retval EFI_DEVICE_ERROR      The command queue engine can't be enabled.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_SD_MMC_COMMAND_QUEUE_ENABLE)(
+  IN     EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL  *This,
+  IN     UINT8                                Slot,
+  IN     UINT16                               Rca,
+  IN OUT UINT8                                *QueueDepth
+  );
+
+/**
+  Disable the command queue engine of a slot after the queued tasks are done.
+
+  The caller clears the CMDQ_MODE_EN field of the device afterwards, before it sends
+  the commands not allowed in command queue mode.
+
+  @param[in]  This              A pointer to the EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL instance.
+  @param[in]  Slot              The slot number of the eMMC device.
+
+  @retval EFI_SUCCESS           The command queue engine is disabled.
+  @retval EFI_INVALID_PARAMETER Slot is invalid.
+  @retval EFI_NOT_STARTED       The command queue engine isn't enabled.
+  @retval EFI_DEVICE_ERROR      The command queue engine can't be halted.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_SD_MMC_COMMAND_QUEUE_DISABLE)(
+  IN EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL  *This,
+  IN UINT8                                Slot
+  );
+
+/**
+  Queue a read or write task in the eMMC device of a slot.
+
+  Packet describes the task as the EMMC_READ_MULTIPLE_BLOCK or EMMC_WRITE_MULTIPLE_BLOCK
+  command the device would get without command queue: the command argument is the
+  address of the first block, and the data buffer holds up to 65535 blocks of 512
+  bytes. No EMMC_SET_BLOCK_COUNT command is sent before it.
+
+  @param[in]      This          A pointer to the EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL instance.
+  @param[in]      Slot          The slot number of the eMMC device.
+  @param[in, out] Packet        A pointer to the command packet of the task.
+  @param[in]      Event         If Event is NULL, blocking I/O is performed. If Event is
+                                not NULL, then nonblocking I/O is performed, and Event
+                                will be signaled when the task completes, with the
+                                result in the TransactionStatus of Packet.
+
+  @retval EFI_SUCCESS           The task is done if Event is NULL, or queued otherwise.
+  @retval EFI_INVALID_PARAMETER Slot or Packet is invalid.
+  @retval EFI_NOT_STARTED       The command queue engine isn't enabled.
+  @retval EFI_NO_MEDIA          The device isn't present in the slot.
+  @retval EFI_OUT_OF_RESOURCES  The task can't be queued due to lack of resources.
+  @retval EFI_DEVICE_ERROR      The task failed.
+  @retval EFI_TIMEOUT           The task didn't complete in the timeout of Packet.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_SD_MMC_COMMAND_QUEUE_QUEUE_TASK)(
+  IN     EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL  *This,
+  IN     UINT8                                Slot,
+  IN OUT EFI_SD_MMC_PASS_THRU_COMMAND_PACKET  *Packet,
+  IN     EFI_EVENT                            Event    OPTIONAL
+  );
+
+struct _EDKII_SD_MMC_COMMAND_QUEUE_PROTOCOL {
+  EDKII_SD_MMC_COMMAND_QUEUE_ENABLE        EnableQueue;
+  EDKII_SD_MMC_COMMAND_QUEUE_DISABLE       DisableQueue;
+  EDKII_SD_MMC_COMMAND_QUEUE_QUEUE_TASK    QueueTask;
+};
+
+extern EFI_GUID  gEdkiiSdMmcCommandQueueProtocolGuid;
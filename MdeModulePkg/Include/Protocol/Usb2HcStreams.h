@@ -0,0 +1,169 @@
+/** @file
+  USB2 Host Controller Streams protocol is produced by the USB host controller
+  drivers that support the bulk streams of SuperSpeed endpoints, and queue several
+  asynchronous bulk transfers on the other bulk endpoints. It is installed on the
+  handle of the EFI_USB2_HC_PROTOCOL. The USB bus driver uses it to produce
+  EDKII_USB_STREAMS_PROTOCOL on the interfaces of the devices.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#pragma once
+
+#include <Protocol/Usb2HostController.h>
+
+#define EDKII_USB2_HC_STREAMS_PROTOCOL_GUID \
+  { \
+    0x1586bf22, 0xf149, 0x4831, { 0x82, 0x44, 0xb2, 0xb5, 0xfd, 0xb9, 0x33, 0xb5 } \
+  }
+
+typedef struct _EDKII_USB2_HC_STREAMS_PROTOCOL EDKII_USB2_HC_STREAMS_PROTOCOL;
+
+/**
+  Allocate the streams of a bulk endpoint of a SuperSpeed device.
+
+  The endpoint is reconfigured so that the transfers are addressed to a stream.
+  The number of streams is bounded by the host controller and by the MaxStreams
+  field of the SuperSpeed Endpoint Companion descriptor of the endpoint.
+
+  @param  This              This EDKII_USB2_HC_STREAMS_PROTOCOL instance.
+  @param  DeviceAddress     The target device address.
+  @param  EndPointAddress   The address of the bulk endpoint, with bit 7 as the direction.
+  @param  NumberOfStreams   On input, the number of streams requested. On output,
+                            the number of streams allocated. The stream IDs are
+                            from 1 to NumberOfStreams.
+
+  @retval EFI_SUCCESS           The streams are allocated.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_UNSUPPORTED       The host controller or the endpoint doesn't support streams.
+  @retval EFI_ALREADY_STARTED   The streams of the endpoint are already allocated.
+  @retval EFI_OUT_OF_RESOURCES  The streams can't be allocated due to lack of resources.
+  @retval EFI_DEVICE_ERROR      The endpoint can't be reconfigured.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB2_HC_STREAMS_ALLOCATE)(
+  IN     EDKII_USB2_HC_STREAMS_PROTOCOL  *This,
+  IN     UINT8                           DeviceAddress,
+  IN     UINT8                           EndPointAddress,
+  IN OUT UINT16                          *NumberOfStreams
+  );
+
+/**
+  Free the streams of a bulk endpoint. The pending stream transfers of the endpoint
+  are removed without calling their callbacks.
+
+  @param  This              This EDKII_USB2_HC_STREAMS_PROTOCOL instance.
+  @param  DeviceAddress     The target device address.
+  @param  EndPointAddress   The address of the bulk endpoint, with bit 7 as the direction.
+
+  @retval EFI_SUCCESS           The streams are freed.
+  @retval EFI_NOT_FOUND         The endpoint has no streams.
+  @retval EFI_DEVICE_ERROR      The endpoint can't be reconfigured.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB2_HC_STREAMS_FREE)(
+  IN EDKII_USB2_HC_STREAMS_PROTOCOL  *This,
+  IN UINT8                           DeviceAddress,
+  IN UINT8                           EndPointAddress
+  );
+
+/**
+  Submit a bulk transfer to a stream of an endpoint and return without waiting
+  for it. The transfers of different streams are in flight at the same time.
+  On an endpoint without streams, the transfers with StreamId 0 are queued on the
+  endpoint and executed in order.
+
+  The data buffer is owned by the caller until the callback is called. The callback
+  is called once with the data buffer, the number of bytes transferred and the
+  EFI_USB_ERR_* result of the transfer.
+
+  @param  This                  This EDKII_USB2_HC_STREAMS_PROTOCOL instance.
+  @param  DeviceAddress         The target device address.
+  @param  EndPointAddress       The address of the bulk endpoint, with bit 7 as the direction.
+  @param  DeviceSpeed           The device speed. It must be EFI_USB_SPEED_SUPER for
+                                a stream transfer.
+  @param  MaximumPacketLength   The maximum packet size of the endpoint.
+  @param  StreamId              The stream of the transfer, 0 if the endpoint has no streams.
+  @param  Data                  The data buffer.
+  @param  DataLength            The size of the data buffer.
+  @param  CallBackFunction      The function called when the transfer is finished.
+  @param  Context               The context of CallBackFunction.
+
+  @retval EFI_SUCCESS           The transfer is submitted.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_ALREADY_STARTED   A transfer is already pending on the stream.
+  @retval EFI_NOT_READY         The endpoint can't queue more transfers until some finish.
+  @retval EFI_OUT_OF_RESOURCES  The transfer can't be submitted due to lack of resources.
+  @retval EFI_DEVICE_ERROR      The transfer can't be submitted due to host controller error.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB2_HC_STREAMS_ASYNC_TRANSFER)(
+  IN EDKII_USB2_HC_STREAMS_PROTOCOL   *This,
+  IN UINT8                            DeviceAddress,
+  IN UINT8                            EndPointAddress,
+  IN UINT8                            DeviceSpeed,
+  IN UINTN                            MaximumPacketLength,
+  IN UINT16                           StreamId,
+  IN VOID                             *Data,
+  IN UINTN                            DataLength,
+  IN EFI_ASYNC_USB_TRANSFER_CALLBACK  CallBackFunction,
+  IN VOID                             *Context OPTIONAL
+  );
+
+/**
+  Remove the pending transfers of an endpoint without calling their callbacks.
+  The endpoint is ready for new transfers when it returns.
+
+  @param  This              This EDKII_USB2_HC_STREAMS_PROTOCOL instance.
+  @param  DeviceAddress     The target device address.
+  @param  EndPointAddress   The address of the bulk endpoint, with bit 7 as the direction.
+  @param  StreamId          The stream of the transfers, 0 for all the transfers of
+                            the endpoint.
+
+  @retval EFI_SUCCESS           The pending transfers are removed.
+  @retval EFI_NOT_FOUND         No transfer is pending.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB2_HC_STREAMS_CANCEL)(
+  IN EDKII_USB2_HC_STREAMS_PROTOCOL  *This,
+  IN UINT8                           DeviceAddress,
+  IN UINT8                           EndPointAddress,
+  IN UINT16                          StreamId
+  );
+
+/**
+  Check the pending transfers and call the callbacks of the finished ones.
+
+  The host controller driver checks them periodically. A caller waiting for a
+  transfer at a TPL that blocks the periodic check calls it instead.
+
+  @param  This              This EDKII_USB2_HC_STREAMS_PROTOCOL instance.
+
+  @retval EFI_SUCCESS       The pending transfers are checked.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB2_HC_STREAMS_POLL)(
+  IN EDKII_USB2_HC_STREAMS_PROTOCOL  *This
+  );
+
+struct _EDKII_USB2_HC_STREAMS_PROTOCOL {
+  EDKII_USB2_HC_STREAMS_ALLOCATE          AllocateStreams;
+  EDKII_USB2_HC_STREAMS_FREE              FreeStreams;
+  EDKII_USB2_HC_STREAMS_ASYNC_TRANSFER    AsyncStreamTransfer;
+  EDKII_USB2_HC_STREAMS_CANCEL            CancelStreamTransfers;
+  EDKII_USB2_HC_STREAMS_POLL              Poll;
+};
+
+extern EFI_GUID  gEdkiiUsb2HcStreamsProtocolGuid;
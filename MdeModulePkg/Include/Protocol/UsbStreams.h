@@ -0,0 +1,149 @@
+/** @file
+  USB Streams protocol is produced by the USB bus driver on the USB interfaces,
+  when the host controller supports the bulk streams. It lets a device driver keep
+  several bulk transfers in flight on the streams of an endpoint of a SuperSpeed
+  device, as required by the USB Attached SCSI protocol, or queue several bulk
+  transfers on an endpoint without streams, like the mass storage and network
+  drivers do to keep the device busy.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#pragma once
+
+#include <Protocol/UsbIo.h>
+
+#define EDKII_USB_STREAMS_PROTOCOL_GUID \
+  { \
+    0x15e5bb8f, 0x992c, 0x4145, { 0xbf, 0x28, 0xe9, 0x99, 0xef, 0x8b, 0x2b, 0x15 } \
+  }
+
+typedef struct _EDKII_USB_STREAMS_PROTOCOL EDKII_USB_STREAMS_PROTOCOL;
+
+/**
+  Allocate the streams of a bulk endpoint of the interface.
+
+  @param  This              This EDKII_USB_STREAMS_PROTOCOL instance.
+  @param  Endpoint          The address of the bulk endpoint, with bit 7 as the direction.
+  @param  NumberOfStreams   On input, the number of streams requested. On output,
+                            the number of streams allocated. The stream IDs are
+                            from 1 to NumberOfStreams.
+
+  @retval EFI_SUCCESS           The streams are allocated.
+  @retval EFI_INVALID_PARAMETER Endpoint isn't a bulk endpoint of the interface.
+  @retval EFI_UNSUPPORTED       The host controller or the endpoint doesn't support streams.
+  @retval Others                The streams can't be allocated.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB_STREAMS_ALLOCATE)(
+  IN     EDKII_USB_STREAMS_PROTOCOL  *This,
+  IN     UINT8                       Endpoint,
+  IN OUT UINT16                      *NumberOfStreams
+  );
+
+/**
+  Free the streams of a bulk endpoint of the interface. The pending stream transfers
+  of the endpoint are removed without calling their callbacks.
+
+  @param  This              This EDKII_USB_STREAMS_PROTOCOL instance.
+  @param  Endpoint          The address of the bulk endpoint, with bit 7 as the direction.
+
+  @retval EFI_SUCCESS           The streams are freed.
+  @retval EFI_INVALID_PARAMETER Endpoint isn't a bulk endpoint of the interface.
+  @retval Others                The streams can't be freed.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB_STREAMS_FREE)(
+  IN EDKII_USB_STREAMS_PROTOCOL  *This,
+  IN UINT8                       Endpoint
+  );
+
+/**
+  Submit a bulk transfer to a stream of an endpoint and return without waiting
+  for it. On an endpoint without streams, the transfers with StreamId 0 are queued
+  on the endpoint and executed in order.
+
+  The data buffer is owned by the caller until the callback is called. The callback
+  is called once with the data buffer, the number of bytes transferred and the
+  EFI_USB_ERR_* result of the transfer.
+
+  @param  This              This EDKII_USB_STREAMS_PROTOCOL instance.
+  @param  Endpoint          The address of the bulk endpoint, with bit 7 as the direction.
+  @param  StreamId          The stream of the transfer, 0 if the endpoint has no streams.
+  @param  Data              The data buffer.
+  @param  DataLength        The size of the data buffer.
+  @param  Callback          The function called when the transfer is finished.
+  @param  Context           The context of Callback.
+
+  @retval EFI_SUCCESS           The transfer is submitted.
+  @retval EFI_INVALID_PARAMETER Some parameters are invalid.
+  @retval EFI_ALREADY_STARTED   A transfer is already pending on the stream.
+  @retval EFI_NOT_READY         The endpoint can't queue more transfers until some finish.
+  @retval Others                The transfer can't be submitted.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB_STREAMS_ASYNC_TRANSFER)(
+  IN EDKII_USB_STREAMS_PROTOCOL       *This,
+  IN UINT8                            Endpoint,
+  IN UINT16                           StreamId,
+  IN VOID                             *Data,
+  IN UINTN                            DataLength,
+  IN EFI_ASYNC_USB_TRANSFER_CALLBACK  Callback,
+  IN VOID                             *Context OPTIONAL
+  );
+
+/**
+  Remove the pending transfers of an endpoint without calling their callbacks.
+
+  @param  This              This EDKII_USB_STREAMS_PROTOCOL instance.
+  @param  Endpoint          The address of the bulk endpoint, with bit 7 as the direction.
+  @param  StreamId          The stream of the transfers, 0 for all the transfers of
+                            the endpoint.
+
+  @retval EFI_SUCCESS           The pending transfers are removed.
+  @retval EFI_INVALID_PARAMETER Endpoint isn't a bulk endpoint of the interface.
+  @retval EFI_NOT_FOUND         No transfer is pending.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB_STREAMS_CANCEL)(
+  IN EDKII_USB_STREAMS_PROTOCOL  *This,
+  IN UINT8                       Endpoint,
+  IN UINT16                      StreamId
+  );
+
+/**
+  Check the pending transfers and call the callbacks of the finished ones.
+
+  A caller waiting for a transfer at a TPL that blocks the periodic check of the
+  host controller driver calls it.
+
+  @param  This              This EDKII_USB_STREAMS_PROTOCOL instance.
+
+  @retval EFI_SUCCESS       The pending transfers are checked.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_USB_STREAMS_POLL)(
+  IN EDKII_USB_STREAMS_PROTOCOL  *This
+  );
+
+struct _EDKII_USB_STREAMS_PROTOCOL {
+  EDKII_USB_STREAMS_ALLOCATE          AllocateStreams;
+  EDKII_USB_STREAMS_FREE              FreeStreams;
+  EDKII_USB_STREAMS_ASYNC_TRANSFER    AsyncStreamTransfer;
+  EDKII_USB_STREAMS_CANCEL            CancelStreamTransfers;
+  EDKII_USB_STREAMS_POLL              Poll;
+};
+
+extern EFI_GUID  gEdkiiUsbStreamsProtocolGuid;
@@ -0,0 +1,797 @@
+/** @file
+  Debug library instance that records DEBUG() messages as binary records.
+
+  The format string is not expanded on the target. Each message is stored as
+  the module GUID, the offset of the format string from gEfiCallerIdGuid and
+  the raw arguments the format string consumes. Records go to a memory ring
+  buffer at PcdDebugBinaryLogBufferBase and, if PcdDebugBinaryLogSerialEnable
+  is TRUE, to the serial port. BaseTools/Scripts/DecodeDebugBinaryLog.py
+  turns the records back into text using the build output.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Base.h>
+#include <Guid/DebugBinaryLog.h>
+#include <Library/DebugLib.h>
+#include <Library/BaseLib.h>
+#include <Library/PrintLib.h>
+#include <Library/PcdLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/SerialPortLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Library/DebugPrintErrorLevelLib.h>
+
+//
+// Define the maximum assert message length that this library supports
+//
+#define MAX_DEBUG_MESSAGE_LENGTH  0x100
+
+//
+// Longest string argument a record can hold
+//
+#define MAX_STRING_ARGUMENT_LENGTH  MAX_UINT8
+
+//
+// Leading Year, Month, Day, Hour and Minute fields of the TIME structure %t
+// takes, which are the only ones the formatter prints
+//
+#define TIME_ARGUMENT_SIZE  6
+
+//
+// VA_LIST can not initialize to NULL for all compiler, so we use this to
+// indicate a null VA_LIST
+//
+VA_LIST  mVaListNull;
+
+//
+// Record under construction. Records are built on the stack so that the
+// library works from XIP code and needs no global state.
+//
+typedef struct {
+  UINT8    *Buffer;
+  UINTN    Size;
+  UINT8    Flags;
+} BINARY_LOG_RECORD_BUILDER;
+
+/**
+  The constructor function initialize the Serial Port Library
+
+  @retval EFI_SUCCESS   The constructor always returns RETURN_SUCCESS.
+
+**/
+RETURN_STATUS
+EFIAPI
+BaseDebugLibBinaryLogConstructor (
+  VOID
+  )
+{
+  return SerialPortInitialize ();
+}
+
+/**
+  Append one tagged argument to a record.
+
+  @param  Builder    The record under construction.
+  @param  Tag        One of the DEBUG_BINARY_LOG_ARG_* values.
+  @param  Value      The value to copy after the tag. May be NULL if ValueSize is 0.
+  @param  ValueSize  The number of bytes of Value.
+
+  @retval TRUE   The argument was appended.
+  @retval FALSE  The record is full and the argument was dropped.
+
+**/
+STATIC
+BOOLEAN
+BinaryLogAppendArgument (
+  IN OUT BINARY_LOG_RECORD_BUILDER  *Builder,
+  IN     UINT8                      Tag,
+  IN     CONST VOID                 *Value,
+  IN     UINTN                      ValueSize
+  )
+{
+  if (Builder->Size + sizeof (Tag) + ValueSize > DEBUG_BINARY_LOG_MAX_RECORD_SIZE) {
+    Builder->Flags |= DEBUG_BINARY_LOG_RECORD_TRUNCATED;
+    return FALSE;
+  }
+
+  Builder->Buffer[Builder->Size] = Tag;
+  CopyMem (&Builder->Buffer[Builder->Size + sizeof (Tag)], Value, ValueSize);
+  Builder->Size += sizeof (Tag) + ValueSize;
+  return TRUE;
+}
+
+/**
+  Append one string argument to a record.
+
+  Unicode strings are stored as ASCII, keeping the low byte of each character
+  as AsciiSPrint() does.
+
+  @param  Builder    The record under construction.
+  @param  String     The ASCII or Unicode string. May be NULL.
+  @param  Unicode    TRUE if String is a Unicode string.
+  @param  MaxLength  The maximum number of characters to read from String,
+                     or 0 to read up to the Null-terminator.
+
+  @retval TRUE   The argument was appended.
+  @retval FALSE  The record is full and the argument was dropped.
+
+**/
+STATIC
+BOOLEAN
+BinaryLogAppendString (
+  IN OUT BINARY_LOG_RECORD_BUILDER  *Builder,
+  IN     CONST VOID                 *String,
+  IN     BOOLEAN                    Unicode,
+  IN     UINTN                      MaxLength
+  )
+{
+  UINTN   Room;
+  UINTN   Length;
+  UINT16  Character;
+  UINT8   *Target;
+
+  if (String == NULL) {
+    return BinaryLogAppendArgument (Builder, DEBUG_BINARY_LOG_ARG_NULL, NULL, 0);
+  }
+
+  //
+  // Tag and length byte, plus at least one character.
+  //
+  if (Builder->Size + 3 > DEBUG_BINARY_LOG_MAX_RECORD_SIZE) {
+    Builder->Flags |= DEBUG_BINARY_LOG_RECORD_TRUNCATED;
+    return FALSE;
+  }
+
+  Room = MIN (DEBUG_BINARY_LOG_MAX_RECORD_SIZE - Builder->Size - 2, MAX_STRING_ARGUMENT_LENGTH);
+  if ((MaxLength == 0) || (MaxLength > Room)) {
+    MaxLength = Room;
+  }
+
+  Target = &Builder->Buffer[Builder->Size + 2];
+  for (Length = 0; Length < MaxLength; Length++) {
+    if (Unicode) {
+      Character = ReadUnaligned16 (&((CONST UINT16 *)String)[Length]);
+    } else {
+      Character = ((CONST UINT8 *)String)[Length];
+    }
+
+    if (Character == 0) {
+      break;
+    }
+
+    Target[Length] = (UINT8)Character;
+  }
+
+  if ((Length == Room) && (Length == MaxLength)) {
+    Builder->Flags |= DEBUG_BINARY_LOG_RECORD_TRUNCATED;
+  }
+
+  Builder->Buffer[Builder->Size]     = DEBUG_BINARY_LOG_ARG_STRING;
+  Builder->Buffer[Builder->Size + 1] = (UINT8)Length;
+  Builder->Size                     += 2 + Length;
+  return TRUE;
+}
+
+/**
+  Append the arguments consumed by a format string to a record.
+
+  The format string is walked with the same rules BasePrintLib uses, so that
+  every argument is fetched with the type the formatter would fetch it with.
+  Pointer arguments are dereferenced now, because their targets may be gone
+  by the time the record is decoded.
+
+  @param  Builder         The record under construction.
+  @param  Format          Null-terminated ASCII format string.
+  @param  VaListMarker    VA_LIST marker for the variable argument list.
+  @param  BaseListMarker  BASE_LIST marker for the variable argument list.
+
+**/
+STATIC
+VOID
+BinaryLogAppendArguments (
+  IN OUT BINARY_LOG_RECORD_BUILDER  *Builder,
+  IN     CONST CHAR8                *Format,
+  IN     VA_LIST                    VaListMarker,
+  IN     BASE_LIST                  BaseListMarker
+  )
+{
+  BOOLEAN        Done;
+  BOOLEAN        LongType;
+  BOOLEAN        HasPrecision;
+  UINTN          Precision;
+  UINT32         Value32;
+  UINT64         Value64;
+  VOID           *Pointer;
+  RETURN_STATUS  Status;
+  BOOLEAN        Appended;
+
+  for ( ; *Format != '\0'; Format++) {
+    if (*Format != '%') {
+      continue;
+    }
+
+    LongType     = FALSE;
+    HasPrecision = FALSE;
+    Precision    = 1;
+    for (Done = FALSE; !Done; ) {
+      Format++;
+      switch (*Format) {
+        case '.':
+          HasPrecision = TRUE;
+          break;
+        case 'L':
+        case 'l':
+          LongType = TRUE;
+          break;
+        case '*':
+          if (BaseListMarker == NULL) {
+            Value64 = VA_ARG (VaListMarker, UINTN);
+          } else {
+            Value64 = BASE_ARG (BaseListMarker, UINTN);
+          }
+
+          if (HasPrecision) {
+            Precision = (UINTN)Value64;
+          }
+
+          if (!BinaryLogAppendArgument (Builder, DEBUG_BINARY_LOG_ARG_UINT64, &Value64, sizeof (Value64))) {
+            return;
+          }
+
+          break;
+        case '-':
+        case '+':
+        case ' ':
+        case ',':
+          break;
+        default:
+          if ((*Format >= '0') && (*Format <= '9')) {
+            if (HasPrecision) {
+              for (Precision = 0; (*Format >= '0') && (*Format <= '9'); Format++) {
+                Precision = Precision * 10 + (*Format - '0');
+              }
+
+              Format--;
+            }
+
+            break;
+          }
+
+          Done = TRUE;
+          break;
+      }
+    }
+
+    switch (*Format) {
+      case 'p':
+        if (BaseListMarker == NULL) {
+          Value64 = (UINTN)VA_ARG (VaListMarker, VOID *);
+        } else {
+          Value64 = (UINTN)BASE_ARG (BaseListMarker, VOID *);
+        }
+
+        Appended = BinaryLogAppendArgument (Builder, DEBUG_BINARY_LOG_ARG_UINT64, &Value64, sizeof (Value64));
+        break;
+
+      case 'X':
+      case 'x':
+      case 'u':
+      case 'd':
+        if (LongType) {
+          if (BaseListMarker == NULL) {
+            Value64 = VA_ARG (VaListMarker, INT64);
+          } else {
+            Value64 = BASE_ARG (BaseListMarker, INT64);
+          }
+
+          Appended = BinaryLogAppendArgument (Builder, DEBUG_BINARY_LOG_ARG_UINT64, &Value64, sizeof (Value64));
+        } else {
+          if (BaseListMarker == NULL) {
+            Value32 = (UINT32)VA_ARG (VaListMarker, int);
+          } else {
+            Value32 = (UINT32)BASE_ARG (BaseListMarker, int);
+          }
+
+          Appended = BinaryLogAppendArgument (Builder, DEBUG_BINARY_LOG_ARG_UINT32, &Value32, sizeof (Value32));
+        }
+
+        break;
+
+      case 's':
+      case 'S':
+      case 'a':
+        if (BaseListMarker == NULL) {
+          Pointer = VA_ARG (VaListMarker, VOID *);
+        } else {
+          Pointer = BASE_ARG (BaseListMarker, VOID *);
+        }
+
+        Appended = BinaryLogAppendString (Builder, Pointer, (BOOLEAN)(*Format != 'a'), HasPrecision ? Precision : 0);
+        break;
+
+      case 'c':
+        if (BaseListMarker == NULL) {
+          Value32 = (UINT32)(VA_ARG (VaListMarker, UINTN) & 0xffff);
+        } else {
+          Value32 = (UINT32)(BASE_ARG (BaseListMarker, UINTN) & 0xffff);
+        }
+
+        Appended = BinaryLogAppendArgument (Builder, DEBUG_BINARY_LOG_ARG_UINT32, &Value32, sizeof (Value32));
+        break;
+
+      case 'g':
+      case 't':
+        if (BaseListMarker == NULL) {
+          Pointer = VA_ARG (VaListMarker, VOID *);
+        } else {
+          Pointer = BASE_ARG (BaseListMarker, VOID *);
+        }
+
+        if (Pointer == NULL) {
+          Appended = BinaryLogAppendArgument (Builder, DEBUG_BINARY_LOG_ARG_NULL, NULL, 0);
+        } else if (*Format == 'g') {
+          Appended = BinaryLogAppendArgument (Builder, DEBUG_BINARY_LOG_ARG_GUID, Pointer, sizeof (GUID));
+        } else {
+          Appended = BinaryLogAppendArgument (Builder, DEBUG_BINARY_LOG_ARG_TIME, Pointer, TIME_ARGUMENT_SIZE);
+        }
+
+        break;
+
+      case 'r':
+        if (BaseListMarker == NULL) {
+          Status = VA_ARG (VaListMarker, RETURN_STATUS);
+        } else {
+          Status = BASE_ARG (BaseListMarker, RETURN_STATUS);
+        }
+
+        //
+        // Store the status in its 64-bit encoding so that the decoder does not
+        // need to know the width of UINTN on the target.
+        //
+        Value64 = (UINT64)(Status & ~MAX_BIT);
+        if (RETURN_ERROR (Status)) {
+          Value64 |= BIT63;
+        }
+
+        Appended = BinaryLogAppendArgument (Builder, DEBUG_BINARY_LOG_ARG_STATUS, &Value64, sizeof (Value64));
+        break;
+
+      case '\0':
+        //
+        // Format string terminates unexpectedly.
+        //
+        return;
+
+      default:
+        //
+        // '%%' and unknown types consume no argument.
+        //
+        Appended = TRUE;
+        break;
+    }
+
+    if (!Appended) {
+      return;
+    }
+  }
+}
+
+/**
+  Send a finished record to the serial port and the memory ring buffer.
+
+  @param  Record  The record.
+  @param  Size    The size of the record in bytes.
+
+**/
+STATIC
+VOID
+BinaryLogWriteRecord (
+  IN CONST UINT8  *Record,
+  IN UINTN        Size
+  )
+{
+  DEBUG_BINARY_LOG_BUFFER_HEADER  *Header;
+  UINT8                           *Data;
+  UINT32                          DataSize;
+  UINT64                          WriteCount;
+  UINT32                          Offset;
+  UINTN                           Head;
+
+  if (FeaturePcdGet (PcdDebugBinaryLogSerialEnable)) {
+    SerialPortWrite ((UINT8 *)Record, Size);
+  }
+
+  Header = (DEBUG_BINARY_LOG_BUFFER_HEADER *)(UINTN)PcdGet64 (PcdDebugBinaryLogBufferBase);
+  if ((Header == NULL) ||
+      (PcdGet32 (PcdDebugBinaryLogBufferSize) < sizeof (*Header) + DEBUG_BINARY_LOG_MAX_RECORD_SIZE))
+  {
+    return;
+  }
+
+  DataSize = PcdGet32 (PcdDebugBinaryLogBufferSize) - sizeof (*Header);
+  Data     = (UINT8 *)(Header + 1);
+
+  //
+  // The first record initializes the buffer. This happens on the boot
+  // processor long before any other processor can log, so it is not
+  // serialized.
+  //
+  if (!CompareGuid (&Header->Signature, &gEdkiiDebugBinaryLogGuid) ||
+      (Header->Version != DEBUG_BINARY_LOG_VERSION) ||
+      (Header->DataSize != DataSize))
+  {
+    Header->Version    = DEBUG_BINARY_LOG_VERSION;
+    Header->DataSize   = DataSize;
+    Header->WriteCount = 0;
+    CopyGuid (&Header->Signature, &gEdkiiDebugBinaryLogGuid);
+  }
+
+  //
+  // Reserve room for the record. Concurrent writers get disjoint ranges.
+  //
+  do {
+    WriteCount = Header->WriteCount;
+  } while (InterlockedCompareExchange64 (&Header->WriteCount, WriteCount, WriteCount + Size) != WriteCount);
+
+  Offset = (UINT32)ModU64x32 (WriteCount, DataSize);
+  Head   = MIN (Size, DataSize - Offset);
+  CopyMem (Data + Offset, Record, Head);
+  CopyMem (Data, Record + Head, Size - Head);
+}
+
+/**
+  Build and emit one record.
+
+  @param  ErrorLevel      The error level of the message.
+  @param  RecordFlags     DEBUG_BINARY_LOG_RECORD_* flags to set in the record.
+  @param  Format          Format string for the message.
+  @param  VaListMarker    VA_LIST marker for the variable argument list.
+  @param  BaseListMarker  BASE_LIST marker for the variable argument list.
+
+**/
+STATIC
+VOID
+BinaryLogRecord (
+  IN  UINTN        ErrorLevel,
+  IN  UINT8        RecordFlags,
+  IN  CONST CHAR8  *Format,
+  IN  VA_LIST      VaListMarker,
+  IN  BASE_LIST    BaseListMarker
+  )
+{
+  UINT64                     Buffer[DEBUG_BINARY_LOG_MAX_RECORD_SIZE / sizeof (UINT64)];
+  DEBUG_BINARY_LOG_RECORD    *Record;
+  BINARY_LOG_RECORD_BUILDER  Builder;
+
+  Record = (DEBUG_BINARY_LOG_RECORD *)Buffer;
+  ZeroMem (Record, sizeof (*Record));
+  Record->Signature  = DEBUG_BINARY_LOG_RECORD_SIGNATURE;
+  Record->ErrorLevel = (UINT32)ErrorLevel;
+  CopyGuid (&Record->ModuleGuid, &gEfiCallerIdGuid);
+
+  Builder.Buffer = (UINT8 *)Buffer;
+  Builder.Size   = sizeof (*Record);
+  Builder.Flags  = RecordFlags;
+
+  if ((RecordFlags & DEBUG_BINARY_LOG_RECORD_INLINE_FORMAT) != 0) {
+    BinaryLogAppendString (&Builder, Format, FALSE, 0);
+  } else {
+    //
+    // The distance between two objects of the same image does not change when
+    // the image is relocated, so the decoder can find Format in the image file.
+    //
+    Record->FormatOffset = (INT32)((INTN)Format - (INTN)&gEfiCallerIdGuid);
+  }
+
+  BinaryLogAppendArguments (&Builder, Format, VaListMarker, BaseListMarker);
+
+  Record->Size  = (UINT16)Builder.Size;
+  Record->Flags = Builder.Flags;
+  BinaryLogWriteRecord ((UINT8 *)Buffer, Builder.Size);
+}
+
+/**
+  Build and emit one record from a variable argument list.
+
+  @param  ErrorLevel   The error level of the message.
+  @param  RecordFlags  DEBUG_BINARY_LOG_RECORD_* flags to set in the record.
+  @param  Format       Format string for the message.
+  @param  ...          Variable argument list whose contents are accessed
+                       based on the format string specified by Format.
+
+**/
+STATIC
+VOID
+EFIAPI
+BinaryLogPrint (
+  IN  UINTN        ErrorLevel,
+  IN  UINT8        RecordFlags,
+  IN  CONST CHAR8  *Format,
+  ...
+  )
+{
+  VA_LIST  Marker;
+
+  VA_START (Marker, Format);
+  BinaryLogRecord (ErrorLevel, RecordFlags, Format, Marker, NULL);
+  VA_END (Marker);
+}
+
+/**
+  Prints a debug message to the debug output device if the specified error level is enabled.
+
+  If any bit in ErrorLevel is also set in DebugPrintErrorLevelLib function
+  GetDebugPrintErrorLevel (), then print the message specified by Format and the
+  associated variable argument list to the debug output device.
+
+  If Format is NULL, then ASSERT().
+
+  @param  ErrorLevel  The error level of the debug message.
+  @param  Format      Format string for the debug message to print.
+  @param  ...         Variable argument list whose contents are accessed
+                      based on the format string specified by Format.
+
+**/
+VOID
+EFIAPI
+DebugPrint (
+  IN  UINTN        ErrorLevel,
+  IN  CONST CHAR8  *Format,
+  ...
+  )
+{
+  VA_LIST  Marker;
+
+  VA_START (Marker, Format);
+  DebugVPrint (ErrorLevel, Format, Marker);
+  VA_END (Marker);
+}
+
+/**
+  Prints a debug message to the debug output device if the specified
+  error level is enabled.
+
+  If any bit in ErrorLevel is also set in DebugPrintErrorLevelLib function
+  GetDebugPrintErrorLevel (), then print the message specified by Format and
+  the associated variable argument list to the debug output device.
+
+  If Format is NULL, then ASSERT().
+
+  @param  ErrorLevel    The error level of the debug message.
+  @param  Format        Format string for the debug message to print.
+  @param  VaListMarker  VA_LIST marker for the variable argument list.
+
+**/
+VOID
+EFIAPI
+DebugVPrint (
+  IN  UINTN        ErrorLevel,
+  IN  CONST CHAR8  *Format,
+  IN  VA_LIST      VaListMarker
+  )
+{
+  ASSERT (Format != NULL);
+
+  if ((ErrorLevel & GetDebugPrintErrorLevel ()) == 0) {
+    return;
+  }
+
+  BinaryLogRecord (ErrorLevel, 0, Format, VaListMarker, NULL);
+}
+
+/**
+  Prints a debug message to the debug output device if the specified
+  error level is enabled.
+  This function use BASE_LIST which would provide a more compatible
+  service than VA_LIST.
+
+  If any bit in ErrorLevel is also set in DebugPrintErrorLevelLib function
+  GetDebugPrintErrorLevel (), then print the message specified by Format and
+  the associated variable argument list to the debug output device.
+
+  BASE_LIST messages are usually forwarded from another module, such as a
+  status code handler, so the format string is stored in the record.
+
+  If Format is NULL, then ASSERT().
+
+  @param  ErrorLevel      The error level of the debug message.
+  @param  Format          Format string for the debug message to print.
+  @param  BaseListMarker  BASE_LIST marker for the variable argument list.
+
+**/
+VOID
+EFIAPI
+DebugBPrint (
+  IN  UINTN        ErrorLevel,
+  IN  CONST CHAR8  *Format,
+  IN  BASE_LIST    BaseListMarker
+  )
+{
+  ASSERT (Format != NULL);
+
+  if ((ErrorLevel & GetDebugPrintErrorLevel ()) == 0) {
+    return;
+  }
+
+  BinaryLogRecord (ErrorLevel, DEBUG_BINARY_LOG_RECORD_INLINE_FORMAT, Format, mVaListNull, BaseListMarker);
+}
+
+/**
+  Records an assert message containing a filename, line number, and description.
+  This may be followed by a breakpoint or a dead loop.
+
+  Record a message of the form "ASSERT <FileName>(<LineNumber>): <Description>\n".
+  Unless PcdDebugBinaryLogSerialEnable is TRUE, the message is also printed as
+  text to the serial port, so that a hang on an assert is never silent.
+  If DEBUG_PROPERTY_ASSERT_BREAKPOINT_ENABLED bit of PcdDebugPropertyMask is set
+  then CpuBreakpoint() is called. Otherwise, if
+  DEBUG_PROPERTY_ASSERT_DEADLOOP_ENABLED bit of PcdDebugPropertyMask is set then
+  CpuDeadLoop() is called.  If neither of these bits are set, then this function
+  returns immediately after the message is recorded.
+
+  If FileName is NULL, then a <FileName> string of "(NULL) Filename" is printed.
+  If Description is NULL, then a <Description> string of "(NULL) Description" is printed.
+
+  @param  FileName     The pointer to the name of the source file that generated the assert condition.
+  @param  LineNumber   The line number in the source file that generated the assert condition
+  @param  Description  The pointer to the description of the assert condition.
+
+**/
+VOID
+EFIAPI
+DebugAssert (
+  IN CONST CHAR8  *FileName,
+  IN UINTN        LineNumber,
+  IN CONST CHAR8  *Description
+  )
+{
+  CHAR8  Buffer[MAX_DEBUG_MESSAGE_LENGTH];
+
+  BinaryLogPrint (
+    DEBUG_ERROR,
+    DEBUG_BINARY_LOG_RECORD_ASSERT,
+    "ASSERT [%a] %a(%d): %a\n",
+    gEfiCallerBaseName,
+    FileName,
+    LineNumber,
+    Description
+    );
+
+  if (!FeaturePcdGet (PcdDebugBinaryLogSerialEnable)) {
+    AsciiSPrint (Buffer, sizeof (Buffer), "ASSERT [%a] %a(%d): %a\n", gEfiCallerBaseName, FileName, LineNumber, Description);
+    SerialPortWrite ((UINT8 *)Buffer, AsciiStrLen (Buffer));
+  }
+
+  //
+  // Generate a Breakpoint, DeadLoop, or NOP based on PCD settings
+  //
+  if ((PcdGet8 (PcdDebugPropertyMask) & DEBUG_PROPERTY_ASSERT_BREAKPOINT_ENABLED) != 0) {
+    CpuBreakpoint ();
+  } else if ((PcdGet8 (PcdDebugPropertyMask) & DEBUG_PROPERTY_ASSERT_DEADLOOP_ENABLED) != 0) {
+    CpuDeadLoop ();
+  }
+}
+
+/**
+  Fills a target buffer with PcdDebugClearMemoryValue, and returns the target buffer.
+
+  This function fills Length bytes of Buffer with the value specified by
+  PcdDebugClearMemoryValue, and returns Buffer.
+
+  If Buffer is NULL, then ASSERT().
+  If Length is greater than (MAX_ADDRESS - Buffer + 1), then ASSERT().
+
+  @param   Buffer  The pointer to the target buffer to be filled with PcdDebugClearMemoryValue.
+  @param   Length  The number of bytes in Buffer to fill with zeros PcdDebugClearMemoryValue.
+
+  @return  Buffer  The pointer to the target buffer filled with PcdDebugClearMemoryValue.
+
+**/
+VOID *
+EFIAPI
+DebugClearMemory (
+  OUT VOID  *Buffer,
+  IN UINTN  Length
+  )
+{
+  ASSERT (Buffer != NULL);
+
+  return SetMem (Buffer, Length, PcdGet8 (PcdDebugClearMemoryValue));
+}
+
+/**
+  Returns TRUE if ASSERT() macros are enabled.
+
+  This function returns TRUE if the DEBUG_PROPERTY_DEBUG_ASSERT_ENABLED bit of
+  PcdDebugPropertyMask is set.  Otherwise FALSE is returned.
+
+  @retval  TRUE    The DEBUG_PROPERTY_DEBUG_ASSERT_ENABLED bit of PcdDebugPropertyMask is set.
+  @retval  FALSE   The DEBUG_PROPERTY_DEBUG_ASSERT_ENABLED bit of PcdDebugPropertyMask is clear.
+
+**/
+BOOLEAN
+EFIAPI
+DebugAssertEnabled (
+  VOID
+  )
+{
+  return (BOOLEAN)((PcdGet8 (PcdDebugPropertyMask) & DEBUG_PROPERTY_DEBUG_ASSERT_ENABLED) != 0);
+}
+
+/**
+  Returns TRUE if DEBUG() macros are enabled.
+
+  This function returns TRUE if the DEBUG_PROPERTY_DEBUG_PRINT_ENABLED bit of
+  PcdDebugPropertyMask is set.  Otherwise FALSE is returned.
+
+  @retval  TRUE    The DEBUG_PROPERTY_DEBUG_PRINT_ENABLED bit of PcdDebugPropertyMask is set.
+  @retval  FALSE   The DEBUG_PROPERTY_DEBUG_PRINT_ENABLED bit of PcdDebugPropertyMask is clear.
+
+**/
+BOOLEAN
+EFIAPI
+DebugPrintEnabled (
+  VOID
+  )
+{
+  return (BOOLEAN)((PcdGet8 (PcdDebugPropertyMask) & DEBUG_PROPERTY_DEBUG_PRINT_ENABLED) != 0);
+}
+
+/**
+  Returns TRUE if DEBUG_CODE() macros are enabled.
+
+  This function returns TRUE if the DEBUG_PROPERTY_DEBUG_CODE_ENABLED bit of
+  PcdDebugPropertyMask is set.  Otherwise FALSE is returned.
+
+  @retval  TRUE    The DEBUG_PROPERTY_DEBUG_CODE_ENABLED bit of PcdDebugPropertyMask is set.
+  @retval  FALSE   The DEBUG_PROPERTY_DEBUG_CODE_ENABLED bit of PcdDebugPropertyMask is clear.
+
+**/
+BOOLEAN
+EFIAPI
+DebugCodeEnabled (
+  VOID
+  )
+{
+  return (BOOLEAN)((PcdGet8 (PcdDebugPropertyMask) & DEBUG_PROPERTY_DEBUG_CODE_ENABLED) != 0);
+}
+
+/**
+  Returns TRUE if DEBUG_CLEAR_MEMORY() macro is enabled.
+
+  This function returns TRUE if the DEBUG_PROPERTY_CLEAR_MEMORY_ENABLED bit of
+  PcdDebugPropertyMask is set.  Otherwise FALSE is returned.
+
+  @retval  TRUE    The DEBUG_PROPERTY_CLEAR_MEMORY_ENABLED bit of PcdDebugPropertyMask is set.
+  @retval  FALSE   The DEBUG_PROPERTY_CLEAR_MEMORY_ENABLED bit of PcdDebugPropertyMask is clear.
+
+**/
+BOOLEAN
+EFIAPI
+DebugClearMemoryEnabled (
+  VOID
+  )
+{
+  return (BOOLEAN)((PcdGet8 (PcdDebugPropertyMask) & DEBUG_PROPERTY_CLEAR_MEMORY_ENABLED) != 0);
+}
+
+/**
+  Returns TRUE if any one of the bit is set both in ErrorLevel and PcdFixedDebugPrintErrorLevel.
+
+  This function compares the bit mask of ErrorLevel and PcdFixedDebugPrintErrorLevel.
+
+  @retval  TRUE    Current ErrorLevel is supported.
+  @retval  FALSE   Current ErrorLevel is not supported.
+
+**/
+BOOLEAN
+EFIAPI
+DebugPrintLevelEnabled (
+  IN  CONST UINTN  ErrorLevel
+  )
+{
+  return (BOOLEAN)((ErrorLevel & PcdGet32 (PcdFixedDebugPrintErrorLevel)) != 0);
+}
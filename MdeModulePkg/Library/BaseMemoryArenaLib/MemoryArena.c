@@ -0,0 +1,456 @@
+/** @file
+  Memory arena (bump allocator) implementation.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "MemoryArenaInternal.h"
+
+//
+// The arena serving the pool requests of the module, see MemoryArenaSetPoolArena().
+//
+MEMORY_ARENA  *mMemoryArenaPoolArena = NULL;
+
+/**
+  Return the last, active chunk of an arena.
+
+  @param[in] Arena   The arena.
+
+  @return The active chunk, or NULL if the arena owns no chunk.
+
+**/
+STATIC
+MEMORY_ARENA_CHUNK *
+GetActiveChunk (
+  IN CONST MEMORY_ARENA  *Arena
+  )
+{
+  if (IsListEmpty (&Arena->ChunkList)) {
+    return NULL;
+  }
+
+  return MEMORY_ARENA_CHUNK_FROM_LINK (GetPreviousNode (&Arena->ChunkList, &Arena->ChunkList));
+}
+
+/**
+  Unlink and free one chunk.
+
+  @param[in, out] Arena   The arena.
+  @param[in]      Chunk   The chunk to release.
+
+**/
+STATIC
+VOID
+ReleaseChunk (
+  IN OUT MEMORY_ARENA        *Arena,
+  IN     MEMORY_ARENA_CHUNK  *Chunk
+  )
+{
+  RemoveEntryList (&Chunk->Link);
+  Chunk->Signature = 0;
+  InternalMemoryArenaFreePages (Chunk, Chunk->Pages);
+}
+
+/**
+  Initialize an empty memory arena.
+
+  No memory is allocated until the first call to MemoryArenaAllocate().
+
+  If Arena is NULL, then ASSERT().
+
+  @param[out] Arena        The arena to initialize.
+  @param[in]  ChunkPages   Minimum number of 4 KB pages per chunk. If 0,
+                           MEMORY_ARENA_DEFAULT_CHUNK_PAGES is used.
+
+**/
+VOID
+EFIAPI
+MemoryArenaInitialize (
+  OUT MEMORY_ARENA  *Arena,
+  IN  UINTN         ChunkPages
+  )
+{
+  ASSERT (Arena != NULL);
+
+  ZeroMem (Arena, sizeof (*Arena));
+  Arena->Signature  = MEMORY_ARENA_SIGNATURE;
+  Arena->ChunkPages = (ChunkPages == 0) ? MEMORY_ARENA_DEFAULT_CHUNK_PAGES : ChunkPages;
+  InitializeListHead (&Arena->ChunkList);
+}
+
+/**
+  Allocate a buffer from a memory arena.
+
+  The buffer is aligned on MEMORY_ARENA_ALIGNMENT and stays valid until the
+  arena is reset past it or freed. Requests larger than a chunk get a chunk
+  of their own.
+
+  If Arena is NULL or not initialized, then ASSERT().
+
+  @param[in, out] Arena          The arena to allocate from.
+  @param[in]      AllocationSize The number of bytes to allocate.
+
+  @return A pointer to the allocated buffer, or NULL if AllocationSize is 0
+          or there are not enough resources.
+
+**/
+VOID *
+EFIAPI
+MemoryArenaAllocate (
+  IN OUT MEMORY_ARENA  *Arena,
+  IN     UINTN         AllocationSize
+  )
+{
+  MEMORY_ARENA_CHUNK  *Chunk;
+  UINTN               Size;
+  UINTN               Pages;
+  VOID                *Buffer;
+
+  ASSERT (Arena != NULL);
+  ASSERT (Arena->Signature == MEMORY_ARENA_SIGNATURE);
+
+  if ((AllocationSize == 0) ||
+      (AllocationSize > MAX_UINTN - MEMORY_ARENA_CHUNK_HEADER_SIZE - EFI_PAGE_SIZE))
+  {
+    return NULL;
+  }
+
+  Size  = ALIGN_VALUE (AllocationSize, MEMORY_ARENA_ALIGNMENT);
+  Chunk = GetActiveChunk (Arena);
+  if ((Chunk == NULL) || (EFI_PAGES_TO_SIZE (Chunk->Pages) - Chunk->Used < Size)) {
+    //
+    // The active chunk is exhausted. Start a new one that is large enough for
+    // this request. The remainder of the previous chunk is not revisited, so
+    // that marks stay a simple (chunk, offset) pair.
+    //
+    Pages = EFI_SIZE_TO_PAGES (MEMORY_ARENA_CHUNK_HEADER_SIZE + Size);
+    Pages = MAX (Pages, Arena->ChunkPages);
+    Chunk = InternalMemoryArenaAllocatePages (Pages);
+    if (Chunk == NULL) {
+      return NULL;
+    }
+
+    Chunk->Signature = MEMORY_ARENA_CHUNK_SIGNATURE;
+    Chunk->Pages     = Pages;
+    Chunk->Used      = MEMORY_ARENA_CHUNK_HEADER_SIZE;
+    InsertTailList (&Arena->ChunkList, &Chunk->Link);
+    Arena->ChunkAllocationCount++;
+  }
+
+  Buffer       = (UINT8 *)Chunk + Chunk->Used;
+  Chunk->Used += Size;
+
+  Arena->AllocationCount++;
+  Arena->BytesInUse += Size;
+  if (Arena->BytesInUse > Arena->PeakBytesInUse) {
+    Arena->PeakBytesInUse = Arena->BytesInUse;
+  }
+
+  return Buffer;
+}
+
+/**
+  Allocate a zero-filled buffer from a memory arena.
+
+  @param[in, out] Arena          The arena to allocate from.
+  @param[in]      AllocationSize The number of bytes to allocate.
+
+  @return A pointer to the allocated buffer, or NULL if AllocationSize is 0
+          or there are not enough resources.
+
+**/
+VOID *
+EFIAPI
+MemoryArenaAllocateZero (
+  IN OUT MEMORY_ARENA  *Arena,
+  IN     UINTN         AllocationSize
+  )
+{
+  VOID  *Buffer;
+
+  Buffer = MemoryArenaAllocate (Arena, AllocationSize);
+  if (Buffer != NULL) {
+    ZeroMem (Buffer, AllocationSize);
+  }
+
+  return Buffer;
+}
+
+/**
+  Copy a buffer into a memory arena.
+
+  If AllocationSize is not 0 and Buffer is NULL, then ASSERT().
+
+  @param[in, out] Arena          The arena to allocate from.
+  @param[in]      AllocationSize The number of bytes to allocate and copy.
+  @param[in]      Buffer         The buffer to copy.
+
+  @return A pointer to the new copy, or NULL if AllocationSize is 0 or there
+          are not enough resources.
+
+**/
+VOID *
+EFIAPI
+MemoryArenaAllocateCopy (
+  IN OUT MEMORY_ARENA  *Arena,
+  IN     UINTN         AllocationSize,
+  IN     CONST VOID    *Buffer
+  )
+{
+  VOID  *Memory;
+
+  ASSERT (Buffer != NULL || AllocationSize == 0);
+
+  Memory = MemoryArenaAllocate (Arena, AllocationSize);
+  if (Memory != NULL) {
+    CopyMem (Memory, Buffer, AllocationSize);
+  }
+
+  return Memory;
+}
+
+/**
+  Record the current position of a memory arena.
+
+  @param[in]  Arena   The arena.
+  @param[out] Mark    Receives the current position.
+
+**/
+VOID
+EFIAPI
+MemoryArenaGetMark (
+  IN  MEMORY_ARENA       *Arena,
+  OUT MEMORY_ARENA_MARK  *Mark
+  )
+{
+  MEMORY_ARENA_CHUNK  *Chunk;
+
+  ASSERT (Arena != NULL);
+  ASSERT (Arena->Signature == MEMORY_ARENA_SIGNATURE);
+  ASSERT (Mark != NULL);
+
+  Chunk            = GetActiveChunk (Arena);
+  Mark->Chunk      = Chunk;
+  Mark->Used       = (Chunk == NULL) ? 0 : Chunk->Used;
+  Mark->BytesInUse = Arena->BytesInUse;
+}
+
+/**
+  Roll a memory arena back to a mark.
+
+  Every buffer allocated after the mark was taken becomes invalid, and the
+  chunks that were added after the mark are returned to the system.
+
+  If Mark was not taken from Arena, or the arena was already rolled back past
+  it, then ASSERT().
+
+  @param[in, out] Arena   The arena.
+  @param[in]      Mark    A position returned by MemoryArenaGetMark().
+
+**/
+VOID
+EFIAPI
+MemoryArenaResetToMark (
+  IN OUT MEMORY_ARENA             *Arena,
+  IN     CONST MEMORY_ARENA_MARK  *Mark
+  )
+{
+  MEMORY_ARENA_CHUNK  *Chunk;
+
+  ASSERT (Arena != NULL);
+  ASSERT (Arena->Signature == MEMORY_ARENA_SIGNATURE);
+  ASSERT (Mark != NULL);
+
+  for (Chunk = GetActiveChunk (Arena);
+       Chunk != NULL && Chunk != Mark->Chunk;
+       Chunk = GetActiveChunk (Arena))
+  {
+    ReleaseChunk (Arena, Chunk);
+  }
+
+  //
+  // Running out of chunks means the mark does not belong to this arena, or
+  // the arena was rolled back to an earlier position already.
+  //
+  ASSERT (Chunk == Mark->Chunk);
+  if (Chunk != NULL) {
+    ASSERT (Mark->Used <= Chunk->Used);
+    Chunk->Used = Mark->Used;
+  }
+
+  Arena->BytesInUse = Mark->BytesInUse;
+}
+
+/**
+  Invalidate every buffer of a memory arena but keep its first chunk for
+  reuse.
+
+  @param[in, out] Arena   The arena.
+
+**/
+VOID
+EFIAPI
+MemoryArenaReset (
+  IN OUT MEMORY_ARENA  *Arena
+  )
+{
+  MEMORY_ARENA_CHUNK  *First;
+  MEMORY_ARENA_CHUNK  *Chunk;
+
+  ASSERT (Arena != NULL);
+  ASSERT (Arena->Signature == MEMORY_ARENA_SIGNATURE);
+
+  if (IsListEmpty (&Arena->ChunkList)) {
+    return;
+  }
+
+  First = MEMORY_ARENA_CHUNK_FROM_LINK (GetFirstNode (&Arena->ChunkList));
+  for (Chunk = GetActiveChunk (Arena); Chunk != First; Chunk = GetActiveChunk (Arena)) {
+    ReleaseChunk (Arena, Chunk);
+  }
+
+  First->Used       = MEMORY_ARENA_CHUNK_HEADER_SIZE;
+  Arena->BytesInUse = 0;
+}
+
+/**
+  Return every chunk of a memory arena to the system.
+
+  The arena stays initialized and may be used again.
+
+  @param[in, out] Arena   The arena.
+
+**/
+VOID
+EFIAPI
+MemoryArenaFree (
+  IN OUT MEMORY_ARENA  *Arena
+  )
+{
+  MEMORY_ARENA_CHUNK  *Chunk;
+
+  ASSERT (Arena != NULL);
+  ASSERT (Arena->Signature == MEMORY_ARENA_SIGNATURE);
+
+  for (Chunk = GetActiveChunk (Arena); Chunk != NULL; Chunk = GetActiveChunk (Arena)) {
+    ReleaseChunk (Arena, Chunk);
+  }
+
+  Arena->BytesInUse = 0;
+}
+
+/**
+  Check whether a buffer was allocated from a memory arena.
+
+  @param[in] Arena    The arena.
+  @param[in] Buffer   The buffer to check.
+
+  @retval TRUE    Buffer lies inside one of the arena chunks.
+  @retval FALSE   Buffer does not belong to the arena.
+
+**/
+BOOLEAN
+EFIAPI
+MemoryArenaContains (
+  IN CONST MEMORY_ARENA  *Arena,
+  IN CONST VOID          *Buffer
+  )
+{
+  LIST_ENTRY          *Link;
+  MEMORY_ARENA_CHUNK  *Chunk;
+  UINTN               Offset;
+
+  ASSERT (Arena != NULL);
+  ASSERT (Arena->Signature == MEMORY_ARENA_SIGNATURE);
+
+  for (Link = GetFirstNode (&Arena->ChunkList);
+       !IsNull (&Arena->ChunkList, Link);
+       Link = GetNextNode (&Arena->ChunkList, Link))
+  {
+    Chunk = MEMORY_ARENA_CHUNK_FROM_LINK (Link);
+    if ((UINTN)Buffer < (UINTN)Chunk) {
+      continue;
+    }
+
+    Offset = (UINTN)Buffer - (UINTN)Chunk;
+    if ((Offset >= MEMORY_ARENA_CHUNK_HEADER_SIZE) && (Offset < Chunk->Used)) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Retrieve the usage counters of a memory arena.
+
+  @param[in]  Arena        The arena.
+  @param[out] Statistics   Receives the counters.
+
+**/
+VOID
+EFIAPI
+MemoryArenaGetStatistics (
+  IN  CONST MEMORY_ARENA       *Arena,
+  OUT MEMORY_ARENA_STATISTICS  *Statistics
+  )
+{
+  LIST_ENTRY  *Link;
+
+  ASSERT (Arena != NULL);
+  ASSERT (Arena->Signature == MEMORY_ARENA_SIGNATURE);
+  ASSERT (Statistics != NULL);
+
+  Statistics->AllocationCount      = Arena->AllocationCount;
+  Statistics->ChunkAllocationCount = Arena->ChunkAllocationCount;
+  Statistics->BytesInUse           = Arena->BytesInUse;
+  Statistics->PeakBytesInUse       = Arena->PeakBytesInUse;
+  Statistics->ChunkCount           = 0;
+  for (Link = GetFirstNode (&Arena->ChunkList);
+       !IsNull (&Arena->ChunkList, Link);
+       Link = GetNextNode (&Arena->ChunkList, Link))
+  {
+    Statistics->ChunkCount++;
+  }
+}
+
+/**
+  Select the memory arena that serves the pool requests of the calling module.
+
+  @param[in] Arena   The arena, or NULL to send the pool requests to the
+                     system again.
+
+  @return The previously selected arena, or NULL if there was none.
+
+**/
+MEMORY_ARENA *
+EFIAPI
+MemoryArenaSetPoolArena (
+  IN MEMORY_ARENA  *Arena  OPTIONAL
+  )
+{
+  MEMORY_ARENA  *Previous;
+
+  ASSERT ((Arena == NULL) || (Arena->Signature == MEMORY_ARENA_SIGNATURE));
+
+  Previous              = mMemoryArenaPoolArena;
+  mMemoryArenaPoolArena = Arena;
+  return Previous;
+}
+
+/**
+  Return the memory arena that serves the pool requests of the calling module.
+
+  @return The arena selected with MemoryArenaSetPoolArena(), or NULL.
+
+**/
+MEMORY_ARENA *
+EFIAPI
+MemoryArenaGetPoolArena (
+  VOID
+  )
+{
+  return mMemoryArenaPoolArena;
+}
@@ -0,0 +1,64 @@
+/** @file
+  Internal definitions of the memory arena library.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef MEMORY_ARENA_INTERNAL_H_
+#define MEMORY_ARENA_INTERNAL_H_
+
+#include <Base.h>
+#include <Uefi/UefiBaseType.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryArenaLib.h>
+
+#define MEMORY_ARENA_CHUNK_SIGNATURE  SIGNATURE_32 ('M', 'A', 'C', 'K')
+
+///
+/// Header placed at the start of every arena chunk.
+///
+typedef struct {
+  UINT32        Signature;
+  LIST_ENTRY    Link;
+  UINTN         Pages;
+  UINTN         Used;       ///< Offset of the first free byte from the chunk start.
+} MEMORY_ARENA_CHUNK;
+
+#define MEMORY_ARENA_CHUNK_FROM_LINK(a) \
+  CR (a, MEMORY_ARENA_CHUNK, Link, MEMORY_ARENA_CHUNK_SIGNATURE)
+
+#define MEMORY_ARENA_CHUNK_HEADER_SIZE \
+  ALIGN_VALUE (sizeof (MEMORY_ARENA_CHUNK), MEMORY_ARENA_ALIGNMENT)
+
+/**
+  Allocate the pages backing one arena chunk.
+
+  @param[in] Pages   The number of 4 KB pages to allocate.
+
+  @return The base of the pages, or NULL if there are not enough resources.
+
+**/
+VOID *
+InternalMemoryArenaAllocatePages (
+  IN UINTN  Pages
+  );
+
+/**
+  Free the pages backing one arena chunk.
+
+  @param[in] Buffer  The base returned by InternalMemoryArenaAllocatePages().
+  @param[in] Pages   The number of 4 KB pages to free.
+
+**/
+VOID
+InternalMemoryArenaFreePages (
+  IN VOID   *Buffer,
+  IN UINTN  Pages
+  );
+
+#endif
@@ -0,0 +1,44 @@
+/** @file
+  Chunk page provider of the memory arena library based on
+  MemoryAllocationLib.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/MemoryAllocationLib.h>
+
+#include "MemoryArenaInternal.h"
+
+/**
+  Allocate the pages backing one arena chunk.
+
+  @param[in] Pages   The number of 4 KB pages to allocate.
+
+  @return The base of the pages, or NULL if there are not enough resources.
+
+**/
+VOID *
+InternalMemoryArenaAllocatePages (
+  IN UINTN  Pages
+  )
+{
+  return AllocatePages (Pages);
+}
+
+/**
+  Free the pages backing one arena chunk.
+
+  @param[in] Buffer  The base returned by InternalMemoryArenaAllocatePages().
+  @param[in] Pages   The number of 4 KB pages to free.
+
+**/
+VOID
+InternalMemoryArenaFreePages (
+  IN VOID   *Buffer,
+  IN UINTN  Pages
+  )
+{
+  FreePages (Buffer, Pages);
+}
@@ -0,0 +1,321 @@
+/** @file
+  Unit tests of the MemoryArenaLib allocation, mark/reset and free logic.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/MemoryArenaLib.h>
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME     "Memory Arena Lib Unit Test"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+//
+// Number of small allocations that the tests push through one arena.
+//
+#define SMALL_ALLOCATION_COUNT  4096
+
+/**
+  Release the arena used by a test case.
+
+  @param[in]  Context  The MEMORY_ARENA of the test case.
+
+**/
+VOID
+EFIAPI
+TestCleanup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MemoryArenaFree ((MEMORY_ARENA *)Context);
+}
+
+/**
+  Many small allocations are aligned, distinct, and served by far fewer
+  chunk allocations.
+
+  @param[in]  Context  The MEMORY_ARENA of the test case.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SmallAllocations (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MEMORY_ARENA             *Arena;
+  MEMORY_ARENA_STATISTICS  Statistics;
+  UINT8                    *Previous;
+  UINT8                    *Buffer;
+  UINTN                    Index;
+
+  Arena = (MEMORY_ARENA *)Context;
+  MemoryArenaInitialize (Arena, 1);
+
+  UT_ASSERT_TRUE (MemoryArenaAllocate (Arena, 0) == NULL);
+
+  Previous = NULL;
+  for (Index = 0; Index < SMALL_ALLOCATION_COUNT; Index++) {
+    Buffer = MemoryArenaAllocateZero (Arena, (Index % 37) + 1);
+    UT_ASSERT_NOT_NULL (Buffer);
+    UT_ASSERT_EQUAL ((UINTN)Buffer & (MEMORY_ARENA_ALIGNMENT - 1), 0);
+    UT_ASSERT_NOT_EQUAL ((UINTN)Buffer, (UINTN)Previous);
+    UT_ASSERT_TRUE (MemoryArenaContains (Arena, Buffer));
+    UT_ASSERT_EQUAL (Buffer[(Index % 37)], 0);
+    SetMem (Buffer, (Index % 37) + 1, 0xA5);
+    Previous = Buffer;
+  }
+
+  MemoryArenaGetStatistics (Arena, &Statistics);
+  UT_ASSERT_EQUAL (Statistics.AllocationCount, SMALL_ALLOCATION_COUNT);
+  UT_ASSERT_TRUE (Statistics.ChunkAllocationCount * 16 < Statistics.AllocationCount);
+  UT_ASSERT_EQUAL (Statistics.ChunkCount, Statistics.ChunkAllocationCount);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Requests larger than a chunk get a dedicated chunk.
+
+  @param[in]  Context  The MEMORY_ARENA of the test case.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+LargeAllocation (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MEMORY_ARENA  *Arena;
+  UINT8         *Buffer;
+  UINT8         Source[SIZE_4KB];
+
+  Arena = (MEMORY_ARENA *)Context;
+  MemoryArenaInitialize (Arena, 1);
+
+  SetMem (Source, sizeof (Source), 0x5A);
+  Buffer = MemoryArenaAllocateCopy (Arena, sizeof (Source), Source);
+  UT_ASSERT_NOT_NULL (Buffer);
+  UT_ASSERT_MEM_EQUAL (Buffer, Source, sizeof (Source));
+
+  Buffer = MemoryArenaAllocate (Arena, SIZE_64KB);
+  UT_ASSERT_NOT_NULL (Buffer);
+  UT_ASSERT_TRUE (MemoryArenaContains (Arena, Buffer + SIZE_64KB - 1));
+  UT_ASSERT_FALSE (MemoryArenaContains (Arena, Source));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Rolling back to a mark releases later chunks and reuses the memory.
+
+  @param[in]  Context  The MEMORY_ARENA of the test case.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+MarkAndReset (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MEMORY_ARENA             *Arena;
+  MEMORY_ARENA_MARK        Mark;
+  MEMORY_ARENA_STATISTICS  Before;
+  MEMORY_ARENA_STATISTICS  After;
+  VOID                     *First;
+  VOID                     *AfterMark;
+  VOID                     *Again;
+  UINTN                    Index;
+
+  Arena = (MEMORY_ARENA *)Context;
+  MemoryArenaInitialize (Arena, 1);
+
+  First = MemoryArenaAllocate (Arena, 24);
+  UT_ASSERT_NOT_NULL (First);
+
+  MemoryArenaGetMark (Arena, &Mark);
+  MemoryArenaGetStatistics (Arena, &Before);
+  AfterMark = MemoryArenaAllocate (Arena, 100);
+  UT_ASSERT_NOT_NULL (AfterMark);
+  for (Index = 0; Index < SMALL_ALLOCATION_COUNT; Index++) {
+    UT_ASSERT_NOT_NULL (MemoryArenaAllocate (Arena, 64));
+  }
+
+  MemoryArenaResetToMark (Arena, &Mark);
+  MemoryArenaGetStatistics (Arena, &After);
+  UT_ASSERT_EQUAL (After.ChunkCount, Before.ChunkCount);
+  UT_ASSERT_EQUAL (After.BytesInUse, Before.BytesInUse);
+  UT_ASSERT_TRUE (MemoryArenaContains (Arena, First));
+  UT_ASSERT_FALSE (MemoryArenaContains (Arena, AfterMark));
+
+  Again = MemoryArenaAllocate (Arena, 100);
+  UT_ASSERT_EQUAL ((UINTN)Again, (UINTN)AfterMark);
+
+  //
+  // A mark taken on an empty arena rolls everything back.
+  //
+  MemoryArenaFree (Arena);
+  MemoryArenaGetMark (Arena, &Mark);
+  UT_ASSERT_NOT_NULL (MemoryArenaAllocate (Arena, 8));
+  MemoryArenaResetToMark (Arena, &Mark);
+  MemoryArenaGetStatistics (Arena, &After);
+  UT_ASSERT_EQUAL (After.ChunkCount, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Reset keeps the first chunk, Free releases all of them.
+
+  @param[in]  Context  The MEMORY_ARENA of the test case.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ResetAndFree (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MEMORY_ARENA             *Arena;
+  MEMORY_ARENA_STATISTICS  Statistics;
+  VOID                     *First;
+  UINTN                    Index;
+
+  Arena = (MEMORY_ARENA *)Context;
+  MemoryArenaInitialize (Arena, 1);
+
+  First = MemoryArenaAllocate (Arena, 16);
+  for (Index = 0; Index < SMALL_ALLOCATION_COUNT; Index++) {
+    UT_ASSERT_NOT_NULL (MemoryArenaAllocate (Arena, 32));
+  }
+
+  MemoryArenaReset (Arena);
+  MemoryArenaGetStatistics (Arena, &Statistics);
+  UT_ASSERT_EQUAL (Statistics.ChunkCount, 1);
+  UT_ASSERT_EQUAL (Statistics.BytesInUse, 0);
+  UT_ASSERT_TRUE (Statistics.PeakBytesInUse >= SMALL_ALLOCATION_COUNT * 32);
+  UT_ASSERT_EQUAL ((UINTN)MemoryArenaAllocate (Arena, 16), (UINTN)First);
+
+  MemoryArenaFree (Arena);
+  MemoryArenaGetStatistics (Arena, &Statistics);
+  UT_ASSERT_EQUAL (Statistics.ChunkCount, 0);
+  UT_ASSERT_FALSE (MemoryArenaContains (Arena, First));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  MemoryArenaLib and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      MemoryArenaTests;
+  STATIC MEMORY_ARENA         Arena;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Framework = NULL;
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (&MemoryArenaTests, Framework, "Memory Arena Tests", "MemoryArenaLib", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the Memory Arena Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-----------Description--------------Name----------Function--------Pre---Post-------------------Context-----------
+  //
+  AddTestCase (MemoryArenaTests, "Small allocations share chunks", "SmallAllocations", SmallAllocations, NULL, TestCleanup, &Arena);
+  AddTestCase (MemoryArenaTests, "Large allocations get their own chunk", "LargeAllocation", LargeAllocation, NULL, TestCleanup, &Arena);
+  AddTestCase (MemoryArenaTests, "Reset to a mark releases later allocations", "MarkAndReset", MarkAndReset, NULL, TestCleanup, &Arena);
+  AddTestCase (MemoryArenaTests, "Reset keeps one chunk and free releases all", "ResetAndFree", ResetAndFree, NULL, TestCleanup, &Arena);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define MemoryArenaLibUnitTestMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+MemoryArenaLibUnitTestMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
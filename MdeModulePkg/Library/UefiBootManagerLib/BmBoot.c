@@ -129,7 +129,7 @@ BmFindBootOptionInVariable (
       ASSERT (OptionToFind->OptionNumber == BootOption.OptionNumber);
       if ((OptionToFind->Attributes == BootOption.Attributes) &&
           (StrCmp (OptionToFind->Description, BootOption.Description) == 0) &&
-          (CompareMem (OptionToFind->FilePath, BootOption.FilePath, GetDevicePathSize (OptionToFind->FilePath)) == 0) &&
+          CompareDevicePath (OptionToFind->FilePath, BootOption.FilePath) &&
           (OptionToFind->OptionalDataSize == BootOption.OptionalDataSize) &&
           (CompareMem (OptionToFind->OptionalData, BootOption.OptionalData, OptionToFind->OptionalDataSize) == 0)
           )
@@ -644,7 +644,7 @@ BmExpandUsbDevicePath (
     if (GetNext) {
       break;
     } else {
-      GetNext = (BOOLEAN)(CompareMem (NextFullPath, FullPath, GetDevicePathSize (NextFullPath)) == 0);
+      GetNext = CompareDevicePath (NextFullPath, FullPath);
       FreePool (NextFullPath);
       NextFullPath = NULL;
     }
@@ -712,7 +712,7 @@ BmExpandFileDevicePath (
         if (GetNext) {
           break;
         } else {
-          GetNext = (BOOLEAN)(CompareMem (NextFullPath, FullPath, GetDevicePathSize (NextFullPath)) == 0);
+          GetNext = CompareDevicePath (NextFullPath, FullPath);
           FreePool (NextFullPath);
           NextFullPath = NULL;
         }
@@ -775,7 +775,7 @@ BmExpandUriDevicePath (
     if (GetNext) {
       break;
     } else {
-      GetNext = (BOOLEAN)(CompareMem (NextFullPath, FullPath, GetDevicePathSize (NextFullPath)) == 0);
+      GetNext = CompareDevicePath (NextFullPath, FullPath);
       //
       // Free the resource occupied by the RAM disk.
       //
@@ -1169,7 +1169,7 @@ BmExpandMediaDevicePath (
       if (GetNext) {
         break;
       } else {
-        GetNext = (BOOLEAN)(CompareMem (NextFullPath, FullPath, GetDevicePathSize (NextFullPath)) == 0);
+        GetNext = CompareDevicePath (NextFullPath, FullPath);
         FreePool (NextFullPath);
         NextFullPath = NULL;
       }
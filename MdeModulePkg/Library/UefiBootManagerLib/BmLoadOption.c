@@ -559,7 +559,7 @@ EfiBootManagerFindLoadOption (
     if ((Key->OptionType == Array[Index].OptionType) &&
         (Key->Attributes == Array[Index].Attributes) &&
         (StrCmp (Key->Description, Array[Index].Description) == 0) &&
-        (CompareMem (Key->FilePath, Array[Index].FilePath, GetDevicePathSize (Key->FilePath)) == 0) &&
+        CompareDevicePath (Key->FilePath, Array[Index].FilePath) &&
         (Key->OptionalDataSize == Array[Index].OptionalDataSize) &&
         (CompareMem (Key->OptionalData, Array[Index].OptionalData, Key->OptionalDataSize) == 0))
     {
@@ -186,6 +186,8 @@ DiskIoDriverBindingStart (
     goto ErrorExit;
   }
 
+  Instance->Cache = DiskIoCacheCreate (Instance->BlockIo);
+
   //
   // Install protocol interfaces for the Disk IO device.
   //
@@ -207,8 +209,29 @@ DiskIoDriverBindingStart (
                     );
   }
 
+  if (!EFI_ERROR (Status) && (Instance->Cache != NULL)) {
+    //
+    // The media is still accessible without the cache.
+    //
+    Status = gBS->InstallProtocolInterface (
+                    &ControllerHandle,
+                    &gEdkiiDiskIoCacheProtocolGuid,
+                    EFI_NATIVE_INTERFACE,
+                    &Instance->Cache->Protocol
+                    );
+    if (EFI_ERROR (Status)) {
+      DiskIoCacheDestroy (Instance->Cache);
+      Instance->Cache = NULL;
+      Status          = EFI_SUCCESS;
+    }
+  }
+
 ErrorExit:
   if (EFI_ERROR (Status)) {
+    if ((Instance != NULL) && (Instance->Cache != NULL)) {
+      DiskIoCacheDestroy (Instance->Cache);
+    }
+
     if ((Instance != NULL) && (Instance->SharedWorkingBuffer != NULL)) {
       FreeAlignedPages (
         Instance->SharedWorkingBuffer,
@@ -325,6 +348,18 @@ DiskIoDriverBindingStop (
       EfiReleaseLock (&Instance->TaskQueueLock);
     } while (!AllTaskDone);
 
+    if (Instance->Cache != NULL) {
+      Status = gBS->UninstallProtocolInterface (
+                      ControllerHandle,
+                      &gEdkiiDiskIoCacheProtocolGuid,
+                      &Instance->Cache->Protocol
+                      );
+      ASSERT_EFI_ERROR (Status);
+      if (!EFI_ERROR (Status)) {
+        DiskIoCacheDestroy (Instance->Cache);
+      }
+    }
+
     FreeAlignedPages (
       Instance->SharedWorkingBuffer,
       EFI_SIZE_TO_PAGES (PcdGet32 (PcdDiskIoDataBufferBlockNum) * Instance->BlockIo->Media->BlockSize)
@@ -866,6 +901,16 @@ DiskIo2ReadWriteDisk (
     while (!DiskIo2RemoveCompletedTask (Instance)) {
     }
 
+    //
+    // Serve the small reads from the cache of the media. No write of this
+    // instance is in flight at this point.
+    //
+    if (!Write && (Instance->Cache != NULL) &&
+        DiskIoCacheRead (Instance->Cache, MediaId, Offset, BufferSize, Buffer, &Status))
+    {
+      return Status;
+    }
+
     SubtasksPtr = &Subtasks;
   } else {
     DiskIo2RemoveCompletedTask (Instance);
@@ -1016,6 +1061,14 @@ DiskIo2ReadWriteDisk (
   gBS->RestoreTPL (SubtaskLockTpl);
   gBS->RestoreTPL (SubtaskPerformTpl);
 
+  if (Write && (Instance->Cache != NULL)) {
+    //
+    // Keep the cache write-through. The cached lines of a failed or non-blocking
+    // write are dropped, the next blocking read waits for the write to complete.
+    //
+    DiskIoCacheWrite (Instance->Cache, Offset, BufferSize, (Blocking && !EFI_ERROR (Status)) ? Buffer : NULL);
+  }
+
   return Status;
 }
 
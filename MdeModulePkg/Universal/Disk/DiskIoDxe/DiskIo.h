@@ -15,6 +15,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/ComponentName.h>
 #include <Protocol/DriverBinding.h>
 #include <Protocol/DiskIo.h>
+#include <Protocol/DiskIoCache.h>
 #include <Library/DebugLib.h>
 #include <Library/UefiDriverEntryPoint.h>
 #include <Library/UefiLib.h>
@@ -23,6 +24,51 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 
+//
+// The preferred size of a cache line, and the maximum number of cache lines
+// read from the media by one BlockIo request of the cache.
+//
+#define DISK_IO_CACHE_LINE_SIZE      SIZE_4KB
+#define DISK_IO_CACHE_MAX_RUN_LINES  16
+
+#define DISK_IO_CACHE_LINE_SIGNATURE  SIGNATURE_32 ('d', 'i', 'c', 'l')
+typedef struct {
+  UINT32        Signature;
+  LIST_ENTRY    LruLink;                /// < link in the LRU list, the most recently used line first
+  LIST_ENTRY    HashLink;               /// < link in the hash bucket of a valid line
+  BOOLEAN       Valid;
+  UINT64        Index;                  /// < line number, the LBA of the line divided by LineBlocks
+  UINT8         *Data;
+} DISK_IO_CACHE_LINE;
+
+#define DISK_IO_CACHE_SIGNATURE  SIGNATURE_32 ('d', 's', 'k', 'C')
+typedef struct {
+  UINT32                            Signature;
+  EDKII_DISK_IO_CACHE_PROTOCOL      Protocol;
+  EDKII_DISK_IO_CACHE_STATISTICS    Statistics;
+  EFI_BLOCK_IO_PROTOCOL             *BlockIo;
+
+  UINT32                            MediaId;          /// < media of the cached data
+  UINT32                            BlockSize;
+  UINT32                            LineBlocks;
+  UINT32                            LineSize;
+  UINT32                            MaxRunLines;
+
+  //
+  // Sequential read detection
+  //
+  UINT64                            NextOffset;       /// < offset following the last read
+  UINT32                            ReadAheadLines;   /// < current read ahead window
+
+  DISK_IO_CACHE_LINE                *Lines;
+  UINT8                             *LineData;
+  UINT8                             *RunBuffer;       /// < aligned buffer for MaxRunLines lines
+  LIST_ENTRY                        *HashBuckets;
+  UINTN                             HashMask;
+  LIST_ENTRY                        LruList;
+} DISK_IO_CACHE;
+#define DISK_IO_CACHE_FROM_PROTOCOL(a)  CR (a, DISK_IO_CACHE, Protocol, DISK_IO_CACHE_SIGNATURE)
+
 #define DISK_IO_PRIVATE_DATA_SIGNATURE  SIGNATURE_32 ('d', 's', 'k', 'I')
 typedef struct {
   UINT32                    Signature;
@@ -36,6 +82,8 @@ typedef struct {
 
   EFI_LOCK                  TaskQueueLock;
   LIST_ENTRY                TaskQueue;
+
+  DISK_IO_CACHE             *Cache;         /// < NULL when the accesses are not cached
 } DISK_IO_PRIVATE_DATA;
 #define DISK_IO_PRIVATE_DATA_FROM_DISK_IO(a)   CR (a, DISK_IO_PRIVATE_DATA, DiskIo,  DISK_IO_PRIVATE_DATA_SIGNATURE)
 #define DISK_IO_PRIVATE_DATA_FROM_DISK_IO2(a)  CR (a, DISK_IO_PRIVATE_DATA, DiskIo2, DISK_IO_PRIVATE_DATA_SIGNATURE)
@@ -334,6 +382,82 @@ DiskIo2FlushDiskEx (
   IN OUT EFI_DISK_IO2_TOKEN  *Token
   );
 
+//
+// Disk I/O cache
+//
+
+/**
+  Create the cache of the media of a Disk I/O instance.
+
+  The media of a logical partition is not cached, because the partition
+  driver accesses it through the Disk I/O protocol of the parent media.
+
+  @param  BlockIo       The Block I/O protocol of the media.
+
+  @return The cache, or NULL when the media is not cached.
+
+**/
+DISK_IO_CACHE *
+DiskIoCacheCreate (
+  IN EFI_BLOCK_IO_PROTOCOL  *BlockIo
+  );
+
+/**
+  Free the cache of the media of a Disk I/O instance.
+
+  @param  Cache         The cache.
+
+**/
+VOID
+DiskIoCacheDestroy (
+  IN DISK_IO_CACHE  *Cache
+  );
+
+/**
+  Read the bytes of a blocking Disk I/O request through the cache.
+
+  @param  Cache         The cache.
+  @param  MediaId       ID of the medium to be read.
+  @param  Offset        The starting byte offset to read from.
+  @param  BufferSize    The number of bytes to read.
+  @param  Buffer        The buffer receiving the data.
+  @param  Status        The status of the request handled by the cache.
+
+  @retval TRUE          The request was handled by the cache, and Status is returned.
+  @retval FALSE         The request is not cacheable and must be sent to the media.
+
+**/
+BOOLEAN
+DiskIoCacheRead (
+  IN  DISK_IO_CACHE  *Cache,
+  IN  UINT32         MediaId,
+  IN  UINT64         Offset,
+  IN  UINTN          BufferSize,
+  OUT UINT8          *Buffer,
+  OUT EFI_STATUS     *Status
+  );
+
+/**
+  Update the cache after a write request was sent to the media.
+
+  The cache is write-through: the cached lines of the written bytes are
+  updated with the data of a successful blocking write, and dropped otherwise.
+
+  @param  Cache         The cache.
+  @param  Offset        The starting byte offset of the write request.
+  @param  BufferSize    The number of bytes of the write request.
+  @param  Buffer        The data written to the media, or NULL to drop the
+                        cached lines of the written bytes.
+
+**/
+VOID
+DiskIoCacheWrite (
+  IN DISK_IO_CACHE  *Cache,
+  IN UINT64         Offset,
+  IN UINTN          BufferSize,
+  IN UINT8          *Buffer OPTIONAL
+  );
+
 //
 // EFI Component Name Functions
 //
@@ -0,0 +1,632 @@
+/** @file
+  Block cache of the Disk I/O driver.
+
+  The blocks of a physical media are kept in cache lines of a few blocks,
+  replaced in LRU order within the memory budget PcdDiskIoCacheSize. Small
+  blocking reads are served from the cache, the missing lines are read from
+  the media in one request, extended by a read ahead window when the reads are
+  sequential. The cache is write-through and drops its content whenever the
+  MediaId of the media changes, so it never holds data that is not on the
+  current media.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DiskIo.h"
+
+/**
+  Find the valid cache line of a line number.
+
+  @param  Cache         The cache.
+  @param  Index         The line number.
+
+  @return The cache line, or NULL when the line is not cached.
+
+**/
+DISK_IO_CACHE_LINE *
+DiskIoCacheLookup (
+  IN DISK_IO_CACHE  *Cache,
+  IN UINT64         Index
+  )
+{
+  LIST_ENTRY          *Bucket;
+  LIST_ENTRY          *Link;
+  DISK_IO_CACHE_LINE  *Line;
+
+  Bucket = &Cache->HashBuckets[(UINTN)Index & Cache->HashMask];
+  for (Link = GetFirstNode (Bucket); !IsNull (Bucket, Link); Link = GetNextNode (Bucket, Link)) {
+    Line = CR (Link, DISK_IO_CACHE_LINE, HashLink, DISK_IO_CACHE_LINE_SIGNATURE);
+    if (Line->Index == Index) {
+      return Line;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Drop the data of a cache line, and make it the first line to be reused.
+
+  @param  Cache         The cache.
+  @param  Line          The valid cache line.
+
+**/
+VOID
+DiskIoCacheDropLine (
+  IN DISK_IO_CACHE       *Cache,
+  IN DISK_IO_CACHE_LINE  *Line
+  )
+{
+  ASSERT (Line->Valid);
+  RemoveEntryList (&Line->HashLink);
+  RemoveEntryList (&Line->LruLink);
+  InsertTailList (&Cache->LruList, &Line->LruLink);
+  Line->Valid = FALSE;
+  Cache->Statistics.ValidLineCount--;
+}
+
+/**
+  Drop all the cached data.
+
+  @param  Cache         The cache.
+
+**/
+VOID
+DiskIoCacheDropAll (
+  IN DISK_IO_CACHE  *Cache
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Cache->Statistics.LineCount; Index++) {
+    if (Cache->Lines[Index].Valid) {
+      DiskIoCacheDropLine (Cache, &Cache->Lines[Index]);
+    }
+  }
+
+  Cache->ReadAheadLines = 0;
+  Cache->Statistics.Invalidations++;
+}
+
+/**
+  Drop the cached data when the media is not the media of the cached data.
+
+  @param  Cache         The cache.
+
+  @retval TRUE          The media can be cached.
+  @retval FALSE         There is no media, or its block size is not the one of the cache.
+
+**/
+BOOLEAN
+DiskIoCacheCheckMedia (
+  IN DISK_IO_CACHE  *Cache
+  )
+{
+  EFI_BLOCK_IO_MEDIA  *Media;
+
+  Media = Cache->BlockIo->Media;
+  if (Media->MediaId != Cache->MediaId) {
+    if (Cache->Statistics.ValidLineCount != 0) {
+      DEBUG ((DEBUG_INFO, "DiskIoCache: MediaId %x -> %x, drop the cache\n", Cache->MediaId, Media->MediaId));
+      DiskIoCacheDropAll (Cache);
+    }
+
+    Cache->MediaId = Media->MediaId;
+  }
+
+  return (BOOLEAN)(Media->MediaPresent && (Media->BlockSize == Cache->BlockSize));
+}
+
+/**
+  Store the data of a line read from the media in the least recently used cache line.
+
+  @param  Cache         The cache.
+  @param  Index         The line number.
+  @param  Data          The data of the line.
+
+**/
+VOID
+DiskIoCacheInsert (
+  IN DISK_IO_CACHE  *Cache,
+  IN UINT64         Index,
+  IN UINT8          *Data
+  )
+{
+  DISK_IO_CACHE_LINE  *Line;
+
+  ASSERT (DiskIoCacheLookup (Cache, Index) == NULL);
+
+  Line = CR (GetPreviousNode (&Cache->LruList, &Cache->LruList), DISK_IO_CACHE_LINE, LruLink, DISK_IO_CACHE_LINE_SIGNATURE);
+  if (Line->Valid) {
+    DiskIoCacheDropLine (Cache, Line);
+    Cache->Statistics.Evictions++;
+  }
+
+  CopyMem (Line->Data, Data, Cache->LineSize);
+  Line->Index = Index;
+  Line->Valid = TRUE;
+  InsertTailList (&Cache->HashBuckets[(UINTN)Index & Cache->HashMask], &Line->HashLink);
+  RemoveEntryList (&Line->LruLink);
+  InsertHeadList (&Cache->LruList, &Line->LruLink);
+  Cache->Statistics.ValidLineCount++;
+}
+
+/**
+  Copy the bytes of a request that are in a line.
+
+  @param  Cache         The cache.
+  @param  Index         The line number.
+  @param  Data          The data of the line.
+  @param  Offset        The starting byte offset of the request.
+  @param  BufferSize    The number of bytes of the request.
+  @param  Buffer        The buffer of the request.
+  @param  ToLine        TRUE to copy the request data to the line, FALSE to
+                        copy the line data to the request buffer.
+
+**/
+VOID
+DiskIoCacheCopyLine (
+  IN DISK_IO_CACHE  *Cache,
+  IN UINT64         Index,
+  IN UINT8          *Data,
+  IN UINT64         Offset,
+  IN UINTN          BufferSize,
+  IN UINT8          *Buffer,
+  IN BOOLEAN        ToLine
+  )
+{
+  UINT64  LineStart;
+  UINT64  Start;
+  UINT64  End;
+
+  LineStart = MultU64x32 (Index, Cache->LineSize);
+  Start     = MAX (Offset, LineStart);
+  End       = MIN (Offset + BufferSize, LineStart + Cache->LineSize);
+  ASSERT (Start < End);
+
+  if (ToLine) {
+    CopyMem (Data + (UINTN)(Start - LineStart), Buffer + (UINTN)(Start - Offset), (UINTN)(End - Start));
+  } else {
+    CopyMem (Buffer + (UINTN)(Start - Offset), Data + (UINTN)(Start - LineStart), (UINTN)(End - Start));
+  }
+}
+
+/**
+  Read the lines that are not cached from the media.
+
+  The missing lines starting at First up to the last line of the request are
+  read in one BlockIo request. When the run reaches the last line of the
+  request, it is extended by the read ahead window of sequential reads.
+
+  @param  Cache         The cache.
+  @param  MediaId       ID of the medium to be read.
+  @param  First         The first missing line.
+  @param  Last          The last line of the request.
+  @param  Offset        The starting byte offset of the request.
+  @param  BufferSize    The number of bytes of the request.
+  @param  Buffer        The buffer of the request.
+  @param  RunLines      Return the number of lines of the request that were read.
+
+  @return The status of the BlockIo request.
+
+**/
+EFI_STATUS
+DiskIoCacheReadRun (
+  IN  DISK_IO_CACHE  *Cache,
+  IN  UINT32         MediaId,
+  IN  UINT64         First,
+  IN  UINT64         Last,
+  IN  UINT64         Offset,
+  IN  UINTN          BufferSize,
+  OUT UINT8          *Buffer,
+  OUT UINT32         *RunLines
+  )
+{
+  EFI_STATUS             Status;
+  EFI_BLOCK_IO_PROTOCOL  *BlockIo;
+  UINT64                 Lba;
+  UINT64                 Blocks;
+  UINT32                 Lines;
+  UINT32                 ReadAhead;
+  UINT32                 Index;
+
+  BlockIo = Cache->BlockIo;
+
+  Lines = 1;
+  while ((First + Lines <= Last) && (Lines < Cache->MaxRunLines) && (DiskIoCacheLookup (Cache, First + Lines) == NULL)) {
+    Lines++;
+  }
+
+  ReadAhead = 0;
+  if (First + Lines > Last) {
+    while ((ReadAhead < Cache->ReadAheadLines) && (Lines + ReadAhead < Cache->MaxRunLines) &&
+           (DiskIoCacheLookup (Cache, First + Lines + ReadAhead) == NULL))
+    {
+      ReadAhead++;
+    }
+  }
+
+  //
+  // The request is within the media, only the read ahead lines may go past its end.
+  //
+  Lba    = MultU64x32 (First, Cache->LineBlocks);
+  Blocks = MIN (MultU64x32 (Lines + ReadAhead, Cache->LineBlocks), BlockIo->Media->LastBlock + 1 - Lba);
+  Status = BlockIo->ReadBlocks (BlockIo, MediaId, Lba, (UINTN)Blocks * Cache->BlockSize, Cache->RunBuffer);
+  if (EFI_ERROR (Status) && (ReadAhead != 0)) {
+    //
+    // Do not fail the request for a block it does not read.
+    //
+    ReadAhead = 0;
+    Blocks    = MIN (MultU64x32 (Lines, Cache->LineBlocks), BlockIo->Media->LastBlock + 1 - Lba);
+    Status    = BlockIo->ReadBlocks (BlockIo, MediaId, Lba, (UINTN)Blocks * Cache->BlockSize, Cache->RunBuffer);
+  }
+
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Cache->Statistics.Misses += Lines;
+  for (Index = 0; Index < Lines + ReadAhead; Index++) {
+    if (First + Index <= Last) {
+      DiskIoCacheCopyLine (Cache, First + Index, Cache->RunBuffer + Index * Cache->LineSize, Offset, BufferSize, Buffer, FALSE);
+    }
+
+    //
+    // A partial line at the end of the media is not cached, neither is the
+    // data read while the BlockIo driver detected a new media.
+    //
+    if ((MultU64x32 (Index + 1, Cache->LineBlocks) <= Blocks) && (BlockIo->Media->MediaId == Cache->MediaId)) {
+      DiskIoCacheInsert (Cache, First + Index, Cache->RunBuffer + Index * Cache->LineSize);
+      if (Index >= Lines) {
+        Cache->Statistics.ReadAheadLines++;
+      }
+    }
+  }
+
+  *RunLines = Lines;
+  return EFI_SUCCESS;
+}
+
+/**
+  Read the bytes of a blocking Disk I/O request through the cache.
+
+  @param  Cache         The cache.
+  @param  MediaId       ID of the medium to be read.
+  @param  Offset        The starting byte offset to read from.
+  @param  BufferSize    The number of bytes to read.
+  @param  Buffer        The buffer receiving the data.
+  @param  Status        The status of the request handled by the cache.
+
+  @retval TRUE          The request was handled by the cache, and Status is returned.
+  @retval FALSE         The request is not cacheable and must be sent to the media.
+
+**/
+BOOLEAN
+DiskIoCacheRead (
+  IN  DISK_IO_CACHE  *Cache,
+  IN  UINT32         MediaId,
+  IN  UINT64         Offset,
+  IN  UINTN          BufferSize,
+  OUT UINT8          *Buffer,
+  OUT EFI_STATUS     *Status
+  )
+{
+  EFI_TPL             OldTpl;
+  EFI_BLOCK_IO_MEDIA  *Media;
+  BOOLEAN             Sequential;
+  UINT64              First;
+  UINT64              Last;
+  UINT64              Index;
+  DISK_IO_CACHE_LINE  *Line;
+  UINT32              RunLines;
+
+  Media  = Cache->BlockIo->Media;
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  Sequential        = (BOOLEAN)(Offset == Cache->NextOffset);
+  Cache->NextOffset = Offset + BufferSize;
+  if (!Sequential) {
+    Cache->ReadAheadLines = 0;
+  }
+
+  //
+  // Let the media report the errors of a request that is not cacheable.
+  // Large requests are not cached so they do not flush the small metadata reads.
+  // A small cache still takes the requests of one line.
+  //
+  if (!DiskIoCacheCheckMedia (Cache) || (MediaId != Media->MediaId) ||
+      (BufferSize == 0) || (BufferSize > MAX (1, Cache->MaxRunLines / 2) * Cache->LineSize) ||
+      (Offset + BufferSize < Offset) ||
+      (DivU64x32 (Offset + BufferSize - 1, Cache->BlockSize) > Media->LastBlock))
+  {
+    gBS->RestoreTPL (OldTpl);
+    return FALSE;
+  }
+
+  First   = DivU64x32 (Offset, Cache->LineSize);
+  Last    = DivU64x32 (Offset + BufferSize - 1, Cache->LineSize);
+  *Status = EFI_SUCCESS;
+  for (Index = First; Index <= Last; Index += RunLines) {
+    Line = DiskIoCacheLookup (Cache, Index);
+    if (Line != NULL) {
+      DiskIoCacheCopyLine (Cache, Index, Line->Data, Offset, BufferSize, Buffer, FALSE);
+      RemoveEntryList (&Line->LruLink);
+      InsertHeadList (&Cache->LruList, &Line->LruLink);
+      Cache->Statistics.Hits++;
+      RunLines = 1;
+      continue;
+    }
+
+    *Status = DiskIoCacheReadRun (Cache, MediaId, Index, Last, Offset, BufferSize, Buffer, &RunLines);
+    if (EFI_ERROR (*Status)) {
+      Cache->ReadAheadLines = 0;
+      break;
+    }
+
+    //
+    // Grow the read ahead window while the sequential reads miss the cache.
+    //
+    if (Sequential) {
+      Cache->ReadAheadLines = MAX (1, MIN (Cache->ReadAheadLines * 2, Cache->MaxRunLines));
+    }
+  }
+
+  gBS->RestoreTPL (OldTpl);
+  return TRUE;
+}
+
+/**
+  Update the cache after a write request was sent to the media.
+
+  The cache is write-through: the cached lines of the written bytes are
+  updated with the data of a successful blocking write, and dropped otherwise.
+
+  @param  Cache         The cache.
+  @param  Offset        The starting byte offset of the write request.
+  @param  BufferSize    The number of bytes of the write request.
+  @param  Buffer        The data written to the media, or NULL to drop the
+                        cached lines of the written bytes.
+
+**/
+VOID
+DiskIoCacheWrite (
+  IN DISK_IO_CACHE  *Cache,
+  IN UINT64         Offset,
+  IN UINTN          BufferSize,
+  IN UINT8          *Buffer OPTIONAL
+  )
+{
+  EFI_TPL             OldTpl;
+  UINT64              First;
+  UINT64              Last;
+  UINT64              Index;
+  UINTN               LineIndex;
+  DISK_IO_CACHE_LINE  *Line;
+
+  if ((BufferSize == 0) || (Offset + BufferSize < Offset)) {
+    return;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  DiskIoCacheCheckMedia (Cache);
+  First = DivU64x32 (Offset, Cache->LineSize);
+  Last  = DivU64x32 (Offset + BufferSize - 1, Cache->LineSize);
+  if (Last - First < Cache->Statistics.LineCount) {
+    for (Index = First; Index <= Last; Index++) {
+      Line = DiskIoCacheLookup (Cache, Index);
+      if (Line == NULL) {
+        continue;
+      }
+
+      if (Buffer != NULL) {
+        DiskIoCacheCopyLine (Cache, Index, Line->Data, Offset, BufferSize, Buffer, TRUE);
+      } else {
+        DiskIoCacheDropLine (Cache, Line);
+      }
+    }
+  } else {
+    //
+    // Walk the cache lines instead of the line numbers of a large write.
+    //
+    for (LineIndex = 0; LineIndex < Cache->Statistics.LineCount; LineIndex++) {
+      Line = &Cache->Lines[LineIndex];
+      if (!Line->Valid || (Line->Index < First) || (Line->Index > Last)) {
+        continue;
+      }
+
+      if (Buffer != NULL) {
+        DiskIoCacheCopyLine (Cache, Line->Index, Line->Data, Offset, BufferSize, Buffer, TRUE);
+      } else {
+        DiskIoCacheDropLine (Cache, Line);
+      }
+    }
+  }
+
+  gBS->RestoreTPL (OldTpl);
+}
+
+/**
+  Return the counters of the Disk I/O cache.
+
+  @param[in]  This        Pointer to the EDKII_DISK_IO_CACHE_PROTOCOL instance.
+  @param[out] Statistics  Pointer to the buffer receiving the counters.
+
+  @retval EFI_SUCCESS            The counters are returned.
+  @retval EFI_INVALID_PARAMETER  Statistics is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+DiskIoCacheGetStatistics (
+  IN  EDKII_DISK_IO_CACHE_PROTOCOL    *This,
+  OUT EDKII_DISK_IO_CACHE_STATISTICS  *Statistics
+  )
+{
+  DISK_IO_CACHE  *Cache;
+  EFI_TPL        OldTpl;
+
+  if (Statistics == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Cache  = DISK_IO_CACHE_FROM_PROTOCOL (This);
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  CopyMem (Statistics, &Cache->Statistics, sizeof (*Statistics));
+  gBS->RestoreTPL (OldTpl);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Drop all the data held by the Disk I/O cache.
+
+  @param[in]  This        Pointer to the EDKII_DISK_IO_CACHE_PROTOCOL instance.
+
+  @retval EFI_SUCCESS     The cache is empty.
+
+**/
+EFI_STATUS
+EFIAPI
+DiskIoCacheInvalidate (
+  IN EDKII_DISK_IO_CACHE_PROTOCOL  *This
+  )
+{
+  DISK_IO_CACHE  *Cache;
+  EFI_TPL        OldTpl;
+
+  Cache  = DISK_IO_CACHE_FROM_PROTOCOL (This);
+  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  DiskIoCacheDropAll (Cache);
+  gBS->RestoreTPL (OldTpl);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Create the cache of the media of a Disk I/O instance.
+
+  The media of a logical partition is not cached, because the partition
+  driver accesses it through the Disk I/O protocol of the parent media.
+
+  @param  BlockIo       The Block I/O protocol of the media.
+
+  @return The cache, or NULL when the media is not cached.
+
+**/
+DISK_IO_CACHE *
+DiskIoCacheCreate (
+  IN EFI_BLOCK_IO_PROTOCOL  *BlockIo
+  )
+{
+  DISK_IO_CACHE  *Cache;
+  UINT32         BlockSize;
+  UINT32         LineBlocks;
+  UINT32         LineCount;
+  UINTN          BucketCount;
+  UINTN          Index;
+
+  BlockSize = BlockIo->Media->BlockSize;
+  if ((PcdGet32 (PcdDiskIoCacheSize) == 0) || BlockIo->Media->LogicalPartition || (BlockSize == 0)) {
+    return NULL;
+  }
+
+  LineBlocks = MAX (1, DISK_IO_CACHE_LINE_SIZE / BlockSize);
+  LineCount  = PcdGet32 (PcdDiskIoCacheSize) / (LineBlocks * BlockSize);
+  if (LineCount < 4) {
+    DEBUG ((DEBUG_WARN, "DiskIoCache: %d bytes are too small to cache the blocks of %d bytes\n", PcdGet32 (PcdDiskIoCacheSize), BlockSize));
+    return NULL;
+  }
+
+  Cache = AllocateZeroPool (sizeof (DISK_IO_CACHE));
+  if (Cache == NULL) {
+    return NULL;
+  }
+
+  Cache->Signature              = DISK_IO_CACHE_SIGNATURE;
+  Cache->Protocol.Revision      = EDKII_DISK_IO_CACHE_PROTOCOL_REVISION;
+  Cache->Protocol.GetStatistics = DiskIoCacheGetStatistics;
+  Cache->Protocol.Invalidate    = DiskIoCacheInvalidate;
+  Cache->BlockIo                = BlockIo;
+  Cache->MediaId                = BlockIo->Media->MediaId;
+  Cache->BlockSize              = BlockSize;
+  Cache->LineBlocks             = LineBlocks;
+  Cache->LineSize               = LineBlocks * BlockSize;
+  Cache->MaxRunLines            = MIN (DISK_IO_CACHE_MAX_RUN_LINES, LineCount / 4);
+  Cache->NextOffset             = MAX_UINT64;
+  Cache->Statistics.LineSize    = Cache->LineSize;
+  Cache->Statistics.LineCount   = LineCount;
+  InitializeListHead (&Cache->LruList);
+
+  //
+  // Use a power of 2 buckets, at least one per line.
+  //
+  BucketCount     = GetPowerOfTwo32 (LineCount);
+  BucketCount     = (BucketCount == LineCount) ? BucketCount : BucketCount * 2;
+  Cache->HashMask = BucketCount - 1;
+
+  Cache->Lines       = AllocateZeroPool (LineCount * sizeof (DISK_IO_CACHE_LINE));
+  Cache->HashBuckets = AllocatePool (BucketCount * sizeof (LIST_ENTRY));
+  Cache->LineData    = AllocatePages (EFI_SIZE_TO_PAGES ((UINTN)LineCount * Cache->LineSize));
+  Cache->RunBuffer   = AllocateAlignedPages (
+                         EFI_SIZE_TO_PAGES (Cache->MaxRunLines * Cache->LineSize),
+                         BlockIo->Media->IoAlign
+                         );
+  if ((Cache->Lines == NULL) || (Cache->HashBuckets == NULL) || (Cache->LineData == NULL) || (Cache->RunBuffer == NULL)) {
+    DEBUG ((DEBUG_WARN, "DiskIoCache: Out of resources for %d cache lines\n", LineCount));
+    DiskIoCacheDestroy (Cache);
+    return NULL;
+  }
+
+  for (Index = 0; Index < BucketCount; Index++) {
+    InitializeListHead (&Cache->HashBuckets[Index]);
+  }
+
+  for (Index = 0; Index < LineCount; Index++) {
+    Cache->Lines[Index].Signature = DISK_IO_CACHE_LINE_SIGNATURE;
+    Cache->Lines[Index].Data      = Cache->LineData + Index * Cache->LineSize;
+    InsertTailList (&Cache->LruList, &Cache->Lines[Index].LruLink);
+  }
+
+  return Cache;
+}
+
+/**
+  Free the cache of the media of a Disk I/O instance.
+
+  @param  Cache         The cache.
+
+**/
+VOID
+DiskIoCacheDestroy (
+  IN DISK_IO_CACHE  *Cache
+  )
+{
+  DEBUG ((
+    DEBUG_INFO,
+    "DiskIoCache: %ld hits, %ld misses, %ld read ahead lines\n",
+    Cache->Statistics.Hits,
+    Cache->Statistics.Misses,
+    Cache->Statistics.ReadAheadLines
+    ));
+
+  if (Cache->RunBuffer != NULL) {
+    FreeAlignedPages (Cache->RunBuffer, EFI_SIZE_TO_PAGES (Cache->MaxRunLines * Cache->LineSize));
+  }
+
+  if (Cache->LineData != NULL) {
+    FreePages (Cache->LineData, EFI_SIZE_TO_PAGES ((UINTN)Cache->Statistics.LineCount * Cache->LineSize));
+  }
+
+  if (Cache->HashBuckets != NULL) {
+    FreePool (Cache->HashBuckets);
+  }
+
+  if (Cache->Lines != NULL) {
+    FreePool (Cache->Lines);
+  }
+
+  FreePool (Cache);
+}
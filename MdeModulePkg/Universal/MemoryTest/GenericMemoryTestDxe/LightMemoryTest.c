@@ -361,6 +361,53 @@ WriteMemory (
   return EFI_SUCCESS;
 }
 
+/**
+  Report the uncorrectable memory error found at an address.
+
+  @param[in] Address  The address of the memory test pattern that mis-compared.
+
+  @retval EFI_DEVICE_ERROR      The memory error is reported.
+  @retval EFI_OUT_OF_RESOURCES  Could not allocate the extended error data.
+
+**/
+EFI_STATUS
+ReportMemoryError (
+  IN  EFI_PHYSICAL_ADDRESS  Address
+  )
+{
+  EFI_MEMORY_EXTENDED_ERROR_DATA  *ExtendedErrorData;
+
+  //
+  // Report uncorrectable errors
+  //
+  ExtendedErrorData = AllocateZeroPool (sizeof (EFI_MEMORY_EXTENDED_ERROR_DATA));
+  if (ExtendedErrorData == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ExtendedErrorData->DataHeader.HeaderSize = (UINT16)sizeof (EFI_STATUS_CODE_DATA);
+  ExtendedErrorData->DataHeader.Size       = (UINT16)(sizeof (EFI_MEMORY_EXTENDED_ERROR_DATA) - sizeof (EFI_STATUS_CODE_DATA));
+  ExtendedErrorData->Granularity           = EFI_MEMORY_ERROR_DEVICE;
+  ExtendedErrorData->Operation             = EFI_MEMORY_OPERATION_READ;
+  ExtendedErrorData->Syndrome              = 0x0;
+  ExtendedErrorData->Address               = Address;
+  ExtendedErrorData->Resolution            = 0x40;
+
+  REPORT_STATUS_CODE_EX (
+    EFI_ERROR_CODE,
+    EFI_COMPUTING_UNIT_MEMORY | EFI_CU_MEMORY_EC_UNCORRECTABLE,
+    0,
+    &gEfiGenericMemTestProtocolGuid,
+    NULL,
+    (UINT8 *)ExtendedErrorData + sizeof (EFI_STATUS_CODE_DATA),
+    ExtendedErrorData->DataHeader.Size
+    );
+
+  FreePool (ExtendedErrorData);
+
+  return EFI_DEVICE_ERROR;
+}
+
 /**
   Verify the range of physical memory which covered by memory test pattern.
 
@@ -382,12 +429,10 @@ VerifyMemory (
   IN  UINT64                       Size
   )
 {
-  EFI_PHYSICAL_ADDRESS            Address;
-  INTN                            ErrorFound;
-  EFI_MEMORY_EXTENDED_ERROR_DATA  *ExtendedErrorData;
+  EFI_PHYSICAL_ADDRESS  Address;
+  INTN                  ErrorFound;
 
-  Address           = Start;
-  ExtendedErrorData = NULL;
+  Address = Start;
 
   //
   // Add 4G memory address check for IA32 platform
@@ -409,33 +454,7 @@ VerifyMemory (
                    Private->MonoTestSize
                    );
     if (ErrorFound != 0) {
-      //
-      // Report uncorrectable errors
-      //
-      ExtendedErrorData = AllocateZeroPool (sizeof (EFI_MEMORY_EXTENDED_ERROR_DATA));
-      if (ExtendedErrorData == NULL) {
-        return EFI_OUT_OF_RESOURCES;
-      }
-
-      ExtendedErrorData->DataHeader.HeaderSize = (UINT16)sizeof (EFI_STATUS_CODE_DATA);
-      ExtendedErrorData->DataHeader.Size       = (UINT16)(sizeof (EFI_MEMORY_EXTENDED_ERROR_DATA) - sizeof (EFI_STATUS_CODE_DATA));
-      ExtendedErrorData->Granularity           = EFI_MEMORY_ERROR_DEVICE;
-      ExtendedErrorData->Operation             = EFI_MEMORY_OPERATION_READ;
-      ExtendedErrorData->Syndrome              = 0x0;
-      ExtendedErrorData->Address               = Address;
-      ExtendedErrorData->Resolution            = 0x40;
-
-      REPORT_STATUS_CODE_EX (
-        EFI_ERROR_CODE,
-        EFI_COMPUTING_UNIT_MEMORY | EFI_CU_MEMORY_EC_UNCORRECTABLE,
-        0,
-        &gEfiGenericMemTestProtocolGuid,
-        NULL,
-        (UINT8 *)ExtendedErrorData + sizeof (EFI_STATUS_CODE_DATA),
-        ExtendedErrorData->DataHeader.Size
-        );
-
-      return EFI_DEVICE_ERROR;
+      return ReportMemoryError (Address);
     }
 
     Address += Private->CoverageSpan;
@@ -540,6 +559,14 @@ InitializeMemoryTest (
   mCurrentRange       = NONTESTED_MEMORY_RANGE_FROM_LINK (mCurrentLink);
   mCurrentAddress     = mCurrentRange->StartAddress;
 
+  //
+  // The non-tested memory ranges are split across the APs by the first
+  // PerformMemoryTest() call, once the platform memory test driver has set
+  // the test parameters and the memory map is final.
+  //
+  FreeParallelMemoryTest (Private);
+  Private->ParallelTestPending = TRUE;
+
   return EFI_SUCCESS;
 }
 
@@ -578,6 +605,18 @@ GenPerformMemoryTest (
   RangeData     = NULL;
   BlockBoundary = 0;
 
+  //
+  // Split the non-tested memory ranges across the APs if possible
+  //
+  if (Private->ParallelTestPending) {
+    Private->ParallelTestPending = FALSE;
+    ParallelMemoryTestInitialize (Private);
+  }
+
+  if (Private->WorkerCount != 0) {
+    return ParallelPerformMemoryTest (Private, TestedMemorySize, TotalMemorySize, ErrorOut, TestAbort);
+  }
+
   //
   // In extensive mode the boundary of "mCurrentRange->Length" may will lost
   // some range that is not Private->BdsBlockSize size boundary, so need
@@ -697,6 +736,8 @@ GenMemoryTestFinished (
     ASSERT_EFI_ERROR (Status);
   }
 
+  ParallelMemoryTestFinished (Private);
+
   //
   // Add the non tested memory range to system memory map through GCD service
   //
@@ -868,7 +909,15 @@ GENERIC_MEMORY_TEST_PRIVATE  mGenericMemoryTestPrivate = {
   {
     NULL,
     NULL
-  }
+  },
+  FALSE,
+  FALSE,
+  NULL,
+  0,
+  0,
+  NULL,
+  0,
+  NULL
 };
 
 /**
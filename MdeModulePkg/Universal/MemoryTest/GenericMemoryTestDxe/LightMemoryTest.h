@@ -12,6 +12,7 @@
 #include <Guid/StatusCodeDataTypeId.h>
 #include <Protocol/GenericMemoryTest.h>
 #include <Protocol/Cpu.h>
+#include <Protocol/MpService.h>
 
 #include <Library/DebugLib.h>
 #include <Library/UefiDriverEntryPoint.h>
@@ -20,8 +21,12 @@
 #include <Library/ReportStatusCodeLib.h>
 #include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
+#include <Library/CacheMaintenanceLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+#include <Library/TimerLib.h>
+#include <Library/PcdLib.h>
 
 //
 // Some global define
@@ -66,6 +71,35 @@ typedef struct {
   EFI_NONTESTED_MEMORY_RANGE_SIGNATURE \
   )
 
+//
+// This structure records the part of a nontested memory range that belongs to
+// one proximity domain, and the next address to be handed to a worker.
+//
+#define MEMORY_TEST_UNKNOWN_DOMAIN  MAX_UINT32
+
+typedef struct {
+  EFI_PHYSICAL_ADDRESS    StartAddress;
+  UINT64                  Length;
+  EFI_PHYSICAL_ADDRESS    NextAddress;
+  UINT32                  ProximityDomain;
+} MEMORY_TEST_SEGMENT;
+
+//
+// This structure records the block tested by one AP in the current
+// PerformMemoryTest() call and the throughput of the AP.
+//
+typedef struct {
+  BOOLEAN                 Enabled;
+  UINT32                  ProximityDomain;
+  EFI_PHYSICAL_ADDRESS    StartAddress;
+  UINT64                  Length;
+  BOOLEAN                 CacheDirty;
+  BOOLEAN                 ErrorFound;
+  EFI_PHYSICAL_ADDRESS    ErrorAddress;
+  UINT64                  TestedSize;
+  UINT64                  Ticks;
+} MEMORY_TEST_WORKER;
+
 //
 // This is the memory test driver's structure definition
 //
@@ -107,6 +141,18 @@ typedef struct {
   // memory range list
   //
   LIST_ENTRY                          NonTestedMemRanList;
+
+  //
+  // parallel memory test, the workers are indexed by processor number
+  //
+  BOOLEAN                             ParallelTestPending;
+  BOOLEAN                             LastBatch;
+  EFI_MP_SERVICES_PROTOCOL            *MpServices;
+  UINTN                               NumberOfProcessors;
+  UINTN                               WorkerCount;
+  MEMORY_TEST_WORKER                  *Workers;
+  UINTN                               SegmentCount;
+  MEMORY_TEST_SEGMENT                 *Segments;
 } GENERIC_MEMORY_TEST_PRIVATE;
 
 #define GENERIC_MEMORY_TEST_PRIVATE_FROM_THIS(a) \
@@ -117,6 +163,9 @@ typedef struct {
   EFI_GENERIC_MEMORY_TEST_PRIVATE_SIGNATURE \
   )
 
+extern UINT64  mTestedSystemMemory;
+extern UINT64  mNonTestedSystemMemory;
+
 //
 // Function Prototypes
 //
@@ -231,6 +280,83 @@ VerifyMemory (
   IN  UINT64                       Size
   );
 
+/**
+  Report the uncorrectable memory error found at an address.
+
+  @param[in] Address  The address of the memory test pattern that mis-compared.
+
+  @retval EFI_DEVICE_ERROR      The memory error is reported.
+  @retval EFI_OUT_OF_RESOURCES  Could not allocate the extended error data.
+
+**/
+EFI_STATUS
+ReportMemoryError (
+  IN  EFI_PHYSICAL_ADDRESS  Address
+  );
+
+/**
+  Free the parallel memory test data.
+
+  @param[in] Private  Point to generic memory test driver's private data.
+
+**/
+VOID
+FreeParallelMemoryTest (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private
+  );
+
+/**
+  Prepare the parallel memory test of the non-tested memory ranges.
+
+  The parallel memory test is used when PcdGenericMemoryTestParallelEnable is
+  TRUE and the MP services protocol reports at least one enabled AP.
+
+  @param[in] Private  Point to generic memory test driver's private data.
+
+  @retval EFI_SUCCESS          The parallel memory test is ready.
+  @retval EFI_UNSUPPORTED      The memory test is performed by the BSP only.
+  @retval EFI_OUT_OF_RESOURCES Could not allocate the worker data.
+
+**/
+EFI_STATUS
+ParallelMemoryTestInitialize (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private
+  );
+
+/**
+  Test one block of memory on every AP.
+
+  @param[in]  Private           Point to generic memory test driver's private data.
+  @param[out] TestedMemorySize  Return the tested extended memory size.
+  @param[out] TotalMemorySize   Return the whole system physical memory size.
+  @param[out] ErrorOut          TRUE if the memory error occurred.
+  @param[in]  TestAbort         Indicates that the user pressed "ESC" to skip the memory test.
+
+  @retval EFI_SUCCESS         The blocks of memory passed the test.
+  @retval EFI_NOT_FOUND       All memory blocks have already been tested.
+  @retval EFI_DEVICE_ERROR    Memory device error occurred, and no agent can handle it.
+
+**/
+EFI_STATUS
+ParallelPerformMemoryTest (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private,
+  OUT UINT64                       *TestedMemorySize,
+  OUT UINT64                       *TotalMemorySize,
+  OUT BOOLEAN                      *ErrorOut,
+  IN  BOOLEAN                      TestAbort
+  );
+
+/**
+  Report the throughput of every AP and free the parallel memory test data.
+
+  @param[in] Private  Point to generic memory test driver's private data.
+
+**/
+VOID
+ParallelMemoryTestFinished (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private
+  );
+
 /**
   Test a range of the memory directly .
 
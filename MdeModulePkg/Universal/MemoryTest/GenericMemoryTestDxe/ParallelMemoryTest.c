@@ -0,0 +1,768 @@
+/** @file
+  Parallel memory test of the non-tested memory ranges.
+
+  The non-tested memory ranges are split into segments along the memory
+  affinity structures of the ACPI SRAT. Every PerformMemoryTest() call hands
+  one block of BdsBlockSize bytes to every enabled AP, preferring a block in
+  the proximity domain of the AP, and the APs write and verify their blocks
+  at the same time through the MP services protocol.
+
+  The pattern is written with SetMem64(), which uses non-temporal stores in
+  the BaseMemoryLibSse2 and BaseMemoryLibMmx instances, and is verified by
+  one sequential pass of 64-bit compares.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "LightMemoryTest.h"
+
+#include <IndustryStandard/Acpi.h>
+
+UINT64  mMemoryTestCounterStart = 0;
+UINT64  mMemoryTestCounterEnd   = 0;
+
+/**
+  Return the number of performance counter ticks between two counter values.
+
+  @param  StartCounter   The performance counter value at the start.
+  @param  EndCounter     The performance counter value at the end.
+
+  @return The number of ticks from StartCounter to EndCounter.
+
+**/
+UINT64
+MemoryTestGetElapsedTicks (
+  IN UINT64  StartCounter,
+  IN UINT64  EndCounter
+  )
+{
+  //
+  // Take the counter wrap around into account.
+  //
+  if (mMemoryTestCounterStart < mMemoryTestCounterEnd) {
+    if (EndCounter >= StartCounter) {
+      return EndCounter - StartCounter;
+    }
+
+    return (mMemoryTestCounterEnd - StartCounter) + (EndCounter - mMemoryTestCounterStart);
+  }
+
+  if (StartCounter >= EndCounter) {
+    return StartCounter - EndCounter;
+  }
+
+  return (StartCounter - mMemoryTestCounterEnd) + (mMemoryTestCounterStart - EndCounter);
+}
+
+/**
+  Return the next structure of the SRAT.
+
+  @param[in] Srat       The SRAT.
+  @param[in] Structure  The current structure, or NULL to return the first one.
+
+  @return The next structure, or NULL if there is no more valid structure.
+
+**/
+UINT8 *
+GetNextSratStructure (
+  IN EFI_ACPI_4_0_SYSTEM_RESOURCE_AFFINITY_TABLE_HEADER  *Srat,
+  IN UINT8                                               *Structure OPTIONAL
+  )
+{
+  UINT8  *End;
+
+  End = (UINT8 *)Srat + Srat->Header.Length;
+  if (Structure == NULL) {
+    Structure = (UINT8 *)(Srat + 1);
+  } else {
+    Structure += Structure[1];
+  }
+
+  //
+  // Byte 0 of every structure is the type and byte 1 is the length.
+  //
+  if ((Structure + 2 > End) || (Structure[1] < 2) || (Structure + Structure[1] > End)) {
+    return NULL;
+  }
+
+  return Structure;
+}
+
+/**
+  Return the proximity domain of a processor.
+
+  @param[in] Srat         The SRAT, or NULL if the platform does not provide one.
+  @param[in] ProcessorId  The APIC ID of the processor.
+
+  @return The proximity domain, or MEMORY_TEST_UNKNOWN_DOMAIN if it is not
+          described by the SRAT.
+
+**/
+UINT32
+GetProcessorProximityDomain (
+  IN EFI_ACPI_4_0_SYSTEM_RESOURCE_AFFINITY_TABLE_HEADER  *Srat OPTIONAL,
+  IN UINT64                                              ProcessorId
+  )
+{
+  UINT8                                                       *Structure;
+  EFI_ACPI_4_0_PROCESSOR_LOCAL_APIC_SAPIC_AFFINITY_STRUCTURE  *ApicAffinity;
+  EFI_ACPI_4_0_PROCESSOR_LOCAL_X2APIC_AFFINITY_STRUCTURE      *X2ApicAffinity;
+
+  if (Srat == NULL) {
+    return MEMORY_TEST_UNKNOWN_DOMAIN;
+  }
+
+  for (Structure = GetNextSratStructure (Srat, NULL); Structure != NULL; Structure = GetNextSratStructure (Srat, Structure)) {
+    if ((Structure[0] == EFI_ACPI_4_0_PROCESSOR_LOCAL_APIC_SAPIC_AFFINITY) &&
+        (Structure[1] >= sizeof (EFI_ACPI_4_0_PROCESSOR_LOCAL_APIC_SAPIC_AFFINITY_STRUCTURE)))
+    {
+      ApicAffinity = (EFI_ACPI_4_0_PROCESSOR_LOCAL_APIC_SAPIC_AFFINITY_STRUCTURE *)Structure;
+      if (((ApicAffinity->Flags & EFI_ACPI_4_0_PROCESSOR_LOCAL_APIC_SAPIC_ENABLED) != 0) &&
+          (ApicAffinity->ApicId == ProcessorId))
+      {
+        return ApicAffinity->ProximityDomain7To0 |
+               (ApicAffinity->ProximityDomain31To8[0] << 8) |
+               (ApicAffinity->ProximityDomain31To8[1] << 16) |
+               ((UINT32)ApicAffinity->ProximityDomain31To8[2] << 24);
+      }
+    } else if ((Structure[0] == EFI_ACPI_4_0_PROCESSOR_LOCAL_X2APIC_AFFINITY) &&
+               (Structure[1] >= sizeof (EFI_ACPI_4_0_PROCESSOR_LOCAL_X2APIC_AFFINITY_STRUCTURE)))
+    {
+      X2ApicAffinity = (EFI_ACPI_4_0_PROCESSOR_LOCAL_X2APIC_AFFINITY_STRUCTURE *)Structure;
+      if (((X2ApicAffinity->Flags & EFI_ACPI_4_0_PROCESSOR_LOCAL_APIC_SAPIC_ENABLED) != 0) &&
+          (X2ApicAffinity->X2ApicId == ProcessorId))
+      {
+        return X2ApicAffinity->ProximityDomain;
+      }
+    }
+  }
+
+  return MEMORY_TEST_UNKNOWN_DOMAIN;
+}
+
+/**
+  Return the proximity domain of a memory address.
+
+  @param[in]      Srat     The SRAT, or NULL if the platform does not provide one.
+  @param[in]      Address  The memory address.
+  @param[in, out] Limit    On input, the end of the memory range that contains Address.
+                           On output, the end of the memory in the same proximity domain.
+
+  @return The proximity domain, or MEMORY_TEST_UNKNOWN_DOMAIN if it is not
+          described by the SRAT.
+
+**/
+UINT32
+GetMemoryProximityDomain (
+  IN     EFI_ACPI_4_0_SYSTEM_RESOURCE_AFFINITY_TABLE_HEADER  *Srat OPTIONAL,
+  IN     EFI_PHYSICAL_ADDRESS                                Address,
+  IN OUT EFI_PHYSICAL_ADDRESS                                *Limit
+  )
+{
+  UINT8                                   *Structure;
+  EFI_ACPI_4_0_MEMORY_AFFINITY_STRUCTURE  *MemoryAffinity;
+  EFI_PHYSICAL_ADDRESS                    Base;
+  EFI_PHYSICAL_ADDRESS                    End;
+  UINT32                                  Domain;
+
+  Domain = MEMORY_TEST_UNKNOWN_DOMAIN;
+  if (Srat == NULL) {
+    return Domain;
+  }
+
+  for (Structure = GetNextSratStructure (Srat, NULL); Structure != NULL; Structure = GetNextSratStructure (Srat, Structure)) {
+    if ((Structure[0] != EFI_ACPI_4_0_MEMORY_AFFINITY) ||
+        (Structure[1] < sizeof (EFI_ACPI_4_0_MEMORY_AFFINITY_STRUCTURE)))
+    {
+      continue;
+    }
+
+    MemoryAffinity = (EFI_ACPI_4_0_MEMORY_AFFINITY_STRUCTURE *)Structure;
+    if ((MemoryAffinity->Flags & EFI_ACPI_4_0_MEMORY_ENABLED) == 0) {
+      continue;
+    }
+
+    Base = LShiftU64 (MemoryAffinity->AddressBaseHigh, 32) | MemoryAffinity->AddressBaseLow;
+    End  = Base + (LShiftU64 (MemoryAffinity->LengthHigh, 32) | MemoryAffinity->LengthLow);
+    if ((Address >= Base) && (Address < End)) {
+      Domain = MemoryAffinity->ProximityDomain;
+      *Limit = MIN (*Limit, End);
+    } else if ((Base > Address) && (Base < *Limit)) {
+      //
+      // Stop at the start of the memory of another proximity domain.
+      //
+      *Limit = Base;
+    }
+  }
+
+  return Domain;
+}
+
+/**
+  Free the parallel memory test data.
+
+  @param[in] Private  Point to generic memory test driver's private data.
+
+**/
+VOID
+FreeParallelMemoryTest (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private
+  )
+{
+  if (Private->Workers != NULL) {
+    FreePool (Private->Workers);
+  }
+
+  if (Private->Segments != NULL) {
+    FreePool (Private->Segments);
+  }
+
+  Private->NumberOfProcessors = 0;
+  Private->WorkerCount        = 0;
+  Private->Workers            = NULL;
+  Private->SegmentCount       = 0;
+  Private->Segments           = NULL;
+}
+
+/**
+  Prepare the parallel memory test of the non-tested memory ranges.
+
+  The parallel memory test is used when PcdGenericMemoryTestParallelEnable is
+  TRUE and the MP services protocol reports at least one enabled AP.
+
+  @param[in] Private  Point to generic memory test driver's private data.
+
+  @retval EFI_SUCCESS          The parallel memory test is ready.
+  @retval EFI_UNSUPPORTED      The memory test is performed by the BSP only.
+  @retval EFI_OUT_OF_RESOURCES Could not allocate the worker data.
+
+**/
+EFI_STATUS
+ParallelMemoryTestInitialize (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private
+  )
+{
+  EFI_STATUS                                          Status;
+  EFI_MP_SERVICES_PROTOCOL                            *MpServices;
+  UINTN                                               NumberOfProcessors;
+  UINTN                                               NumberOfEnabledProcessors;
+  EFI_PROCESSOR_INFORMATION                           ProcessorInfo;
+  EFI_ACPI_4_0_SYSTEM_RESOURCE_AFFINITY_TABLE_HEADER  *Srat;
+  LIST_ENTRY                                          *Link;
+  NONTESTED_MEMORY_RANGE                              *Range;
+  UINTN                                               MaxSegmentCount;
+  MEMORY_TEST_SEGMENT                                 *Segment;
+  EFI_PHYSICAL_ADDRESS                                Address;
+  EFI_PHYSICAL_ADDRESS                                Limit;
+  UINT32                                              Domain;
+  UINTN                                               Index;
+
+  FreeParallelMemoryTest (Private);
+
+  if (!FeaturePcdGet (PcdGenericMemoryTestParallelEnable)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // The APs write the pattern 64 bits at a time.
+  //
+  if ((Private->MonoTestSize == 0) || ((Private->MonoTestSize % sizeof (UINT64)) != 0) ||
+      ((Private->CoverageSpan % sizeof (UINT64)) != 0) || (Private->CoverageSpan < Private->MonoTestSize))
+  {
+    return EFI_UNSUPPORTED;
+  }
+
+  for (Index = 1; Index < Private->MonoTestSize / sizeof (UINT64); Index++) {
+    if (ReadUnaligned64 ((UINT64 *)Private->MonoPattern + Index) != ReadUnaligned64 (Private->MonoPattern)) {
+      return EFI_UNSUPPORTED;
+    }
+  }
+
+  Status = gBS->LocateProtocol (&gEfiMpServiceProtocolGuid, NULL, (VOID **)&MpServices);
+  if (EFI_ERROR (Status)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = MpServices->GetNumberOfProcessors (MpServices, &NumberOfProcessors, &NumberOfEnabledProcessors);
+  if (EFI_ERROR (Status) || (NumberOfEnabledProcessors < 2)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Srat = (VOID *)EfiLocateFirstAcpiTable (EFI_ACPI_4_0_SYSTEM_RESOURCE_AFFINITY_TABLE_SIGNATURE);
+  if ((Srat != NULL) && (Srat->Header.Length < sizeof (EFI_ACPI_4_0_SYSTEM_RESOURCE_AFFINITY_TABLE_HEADER))) {
+    Srat = NULL;
+  }
+
+  Private->Workers = AllocateZeroPool (NumberOfProcessors * sizeof (MEMORY_TEST_WORKER));
+  if (Private->Workers == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Private->MpServices         = MpServices;
+  Private->NumberOfProcessors = NumberOfProcessors;
+  for (Index = 0; Index < NumberOfProcessors; Index++) {
+    Status = MpServices->GetProcessorInfo (MpServices, Index, &ProcessorInfo);
+    if (EFI_ERROR (Status) ||
+        ((ProcessorInfo.StatusFlag & PROCESSOR_ENABLED_BIT) == 0) ||
+        ((ProcessorInfo.StatusFlag & PROCESSOR_AS_BSP_BIT) != 0))
+    {
+      continue;
+    }
+
+    Private->Workers[Index].Enabled         = TRUE;
+    Private->Workers[Index].ProximityDomain = GetProcessorProximityDomain (Srat, ProcessorInfo.ProcessorId);
+    Private->WorkerCount++;
+  }
+
+  if (Private->WorkerCount == 0) {
+    FreeParallelMemoryTest (Private);
+    return EFI_UNSUPPORTED;
+  }
+
+  //
+  // Every memory affinity structure may split a non-tested memory range into
+  // two more segments.
+  //
+  MaxSegmentCount = 0;
+  for (Link = GetFirstNode (&Private->NonTestedMemRanList); !IsNull (&Private->NonTestedMemRanList, Link); Link = GetNextNode (&Private->NonTestedMemRanList, Link)) {
+    MaxSegmentCount++;
+  }
+
+  if (Srat != NULL) {
+    MaxSegmentCount *= 2 * (Srat->Header.Length / sizeof (EFI_ACPI_4_0_MEMORY_AFFINITY_STRUCTURE)) + 1;
+  }
+
+  Private->Segments = AllocateZeroPool (MaxSegmentCount * sizeof (MEMORY_TEST_SEGMENT));
+  if (Private->Segments == NULL) {
+    FreeParallelMemoryTest (Private);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Link = GetFirstNode (&Private->NonTestedMemRanList); !IsNull (&Private->NonTestedMemRanList, Link); Link = GetNextNode (&Private->NonTestedMemRanList, Link)) {
+    Range   = NONTESTED_MEMORY_RANGE_FROM_LINK (Link);
+    Address = Range->StartAddress;
+    while (Address < Range->StartAddress + Range->Length) {
+      ASSERT (Private->SegmentCount < MaxSegmentCount);
+      Limit   = Range->StartAddress + Range->Length;
+      Domain  = GetMemoryProximityDomain (Srat, Address, &Limit);
+      Segment = &Private->Segments[Private->SegmentCount++];
+
+      Segment->StartAddress    = Address;
+      Segment->Length          = Limit - Address;
+      Segment->NextAddress     = Address;
+      Segment->ProximityDomain = Domain;
+      Address                  = Limit;
+    }
+  }
+
+  GetPerformanceCounterProperties (&mMemoryTestCounterStart, &mMemoryTestCounterEnd);
+
+  DEBUG ((
+    DEBUG_INFO,
+    "GenericMemoryTest: %d APs test %d memory segments in parallel, SRAT %a\n",
+    Private->WorkerCount,
+    Private->SegmentCount,
+    (Srat != NULL) ? "found" : "not found"
+    ));
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Take the next block to be tested, from the proximity domain of an AP if possible.
+
+  @param[in]  Private       Point to generic memory test driver's private data.
+  @param[in]  Domain        The proximity domain of the AP.
+  @param[out] StartAddress  The start address of the block.
+  @param[out] Length        The length of the block.
+
+  @retval TRUE   A block is returned.
+  @retval FALSE  All memory blocks have already been taken.
+
+**/
+BOOLEAN
+TakeMemoryTestBlock (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private,
+  IN  UINT32                       Domain,
+  OUT EFI_PHYSICAL_ADDRESS         *StartAddress,
+  OUT UINT64                       *Length
+  )
+{
+  UINTN                Pass;
+  UINTN                Index;
+  MEMORY_TEST_SEGMENT  *Segment;
+  UINT64               Remaining;
+
+  //
+  // The first pass only takes the memory local to the AP, the second pass
+  // takes the memory left by the other proximity domains.
+  //
+  for (Pass = 0; Pass < 2; Pass++) {
+    for (Index = 0; Index < Private->SegmentCount; Index++) {
+      Segment = &Private->Segments[Index];
+      if ((Pass == 0) && (Segment->ProximityDomain != Domain)) {
+        continue;
+      }
+
+      Remaining = Segment->StartAddress + Segment->Length - Segment->NextAddress;
+      if (Remaining != 0) {
+        *StartAddress         = Segment->NextAddress;
+        *Length               = MIN (Remaining, Private->BdsBlockSize);
+        Segment->NextAddress += *Length;
+        return TRUE;
+      }
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Write the memory test pattern into the block of a worker.
+
+  @param[in]      Private  Point to generic memory test driver's private data.
+  @param[in, out] Worker   The worker.
+
+**/
+VOID
+WriteMemoryTestBlock (
+  IN     GENERIC_MEMORY_TEST_PRIVATE  *Private,
+  IN OUT MEMORY_TEST_WORKER           *Worker
+  )
+{
+  UINT64                StartCounter;
+  UINT64                Pattern;
+  EFI_PHYSICAL_ADDRESS  Address;
+  EFI_PHYSICAL_ADDRESS  End;
+
+  StartCounter = GetPerformanceCounter ();
+  Pattern      = ReadUnaligned64 (Private->MonoPattern);
+  End          = Worker->StartAddress + Worker->Length;
+
+  if (Private->CoverageSpan == Private->MonoTestSize) {
+    SetMem64 ((VOID *)(UINTN)Worker->StartAddress, (UINTN)Worker->Length, Pattern);
+  } else {
+    for (Address = Worker->StartAddress; Address + Private->MonoTestSize <= End; Address += Private->CoverageSpan) {
+      SetMem64 ((VOID *)(UINTN)Address, Private->MonoTestSize, Pattern);
+    }
+  }
+
+  Worker->Ticks     += MemoryTestGetElapsedTicks (StartCounter, GetPerformanceCounter ());
+  Worker->CacheDirty = TRUE;
+}
+
+/**
+  Verify the memory test pattern in the block of a worker.
+
+  @param[in]      Private  Point to generic memory test driver's private data.
+  @param[in, out] Worker   The worker.
+
+**/
+VOID
+VerifyMemoryTestBlock (
+  IN     GENERIC_MEMORY_TEST_PRIVATE  *Private,
+  IN OUT MEMORY_TEST_WORKER           *Worker
+  )
+{
+  UINT64                StartCounter;
+  UINT64                Pattern;
+  EFI_PHYSICAL_ADDRESS  Address;
+  EFI_PHYSICAL_ADDRESS  End;
+  UINT64                *Data;
+  UINTN                 Index;
+
+  StartCounter = GetPerformanceCounter ();
+  Pattern      = ReadUnaligned64 (Private->MonoPattern);
+  End          = Worker->StartAddress + Worker->Length;
+
+  for (Address = Worker->StartAddress; Address + Private->MonoTestSize <= End; Address += Private->CoverageSpan) {
+    Data = (UINT64 *)(UINTN)Address;
+    for (Index = 0; Index < Private->MonoTestSize / sizeof (UINT64); Index++) {
+      if (Data[Index] != Pattern) {
+        Worker->ErrorFound   = TRUE;
+        Worker->ErrorAddress = Address;
+        break;
+      }
+    }
+
+    if (Worker->ErrorFound) {
+      break;
+    }
+  }
+
+  Worker->Ticks      += MemoryTestGetElapsedTicks (StartCounter, GetPerformanceCounter ());
+  Worker->TestedSize += Worker->Length;
+}
+
+/**
+  Return the worker of the calling AP.
+
+  @param[in] Private  Point to generic memory test driver's private data.
+
+  @return The worker, or NULL if the AP is not a worker.
+
+**/
+MEMORY_TEST_WORKER *
+GetMemoryTestWorker (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       ProcessorNumber;
+
+  Status = Private->MpServices->WhoAmI (Private->MpServices, &ProcessorNumber);
+  if (EFI_ERROR (Status) || (ProcessorNumber >= Private->NumberOfProcessors) ||
+      !Private->Workers[ProcessorNumber].Enabled)
+  {
+    return NULL;
+  }
+
+  return &Private->Workers[ProcessorNumber];
+}
+
+/**
+  AP procedure that writes the memory test pattern into the block of the AP.
+
+  After the last block of the memory test, the AP writes back and invalidates
+  its own data cache once, so no pattern is left in the cache of the AP.
+
+  @param[in] Buffer  Point to generic memory test driver's private data.
+
+**/
+VOID
+EFIAPI
+WriteMemoryTestProcedure (
+  IN VOID  *Buffer
+  )
+{
+  GENERIC_MEMORY_TEST_PRIVATE  *Private;
+  MEMORY_TEST_WORKER           *Worker;
+
+  Private = Buffer;
+  Worker  = GetMemoryTestWorker (Private);
+  if (Worker == NULL) {
+    return;
+  }
+
+  if (Worker->Length != 0) {
+    WriteMemoryTestBlock (Private, Worker);
+  }
+
+  if (Private->LastBatch && Worker->CacheDirty) {
+    WriteBackInvalidateDataCache ();
+    Worker->CacheDirty = FALSE;
+  }
+}
+
+/**
+  AP procedure that verifies the memory test pattern in the block of the AP.
+
+  @param[in] Buffer  Point to generic memory test driver's private data.
+
+**/
+VOID
+EFIAPI
+VerifyMemoryTestProcedure (
+  IN VOID  *Buffer
+  )
+{
+  MEMORY_TEST_WORKER  *Worker;
+
+  Worker = GetMemoryTestWorker (Buffer);
+  if ((Worker != NULL) && (Worker->Length != 0)) {
+    VerifyMemoryTestBlock (Buffer, Worker);
+  }
+}
+
+/**
+  Test one block of memory on every AP.
+
+  @param[in]  Private           Point to generic memory test driver's private data.
+  @param[out] TestedMemorySize  Return the tested extended memory size.
+  @param[out] TotalMemorySize   Return the whole system physical memory size.
+  @param[out] ErrorOut          TRUE if the memory error occurred.
+  @param[in]  TestAbort         Indicates that the user pressed "ESC" to skip the memory test.
+
+  @retval EFI_SUCCESS         The blocks of memory passed the test.
+  @retval EFI_NOT_FOUND       All memory blocks have already been tested.
+  @retval EFI_DEVICE_ERROR    Memory device error occurred, and no agent can handle it.
+
+**/
+EFI_STATUS
+ParallelPerformMemoryTest (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private,
+  OUT UINT64                       *TestedMemorySize,
+  OUT UINT64                       *TotalMemorySize,
+  OUT BOOLEAN                      *ErrorOut,
+  IN  BOOLEAN                      TestAbort
+  )
+{
+  EFI_STATUS                      Status;
+  EFI_MEMORY_RANGE_EXTENDED_DATA  RangeData;
+  MEMORY_TEST_WORKER              *Worker;
+  UINT64                          BatchSize;
+  BOOLEAN                         BlockTaken;
+  UINTN                           Index;
+
+  *ErrorOut  = FALSE;
+  BatchSize  = 0;
+  BlockTaken = FALSE;
+
+  for (Index = 0; Index < Private->NumberOfProcessors; Index++) {
+    Worker             = &Private->Workers[Index];
+    Worker->Length     = 0;
+    Worker->ErrorFound = FALSE;
+    if (Worker->Enabled &&
+        TakeMemoryTestBlock (Private, Worker->ProximityDomain, &Worker->StartAddress, &Worker->Length))
+    {
+      BlockTaken = TRUE;
+
+      //
+      // Add 4G memory address check for IA32 platform
+      // NOTE: Without page table, there is no way to use memory above 4G.
+      // The block is skipped and not counted as tested.
+      //
+      if (Worker->StartAddress + Worker->Length > MAX_ADDRESS) {
+        Worker->Length = 0;
+      }
+
+      BatchSize += Worker->Length;
+    }
+  }
+
+  //
+  // The data caches are written back once, with the last blocks.
+  //
+  Private->LastBatch = TRUE;
+  for (Index = 0; Index < Private->SegmentCount; Index++) {
+    if (Private->Segments[Index].NextAddress < Private->Segments[Index].StartAddress + Private->Segments[Index].Length) {
+      Private->LastBatch = FALSE;
+      break;
+    }
+  }
+
+  *TotalMemorySize = Private->BaseMemorySize + mNonTestedSystemMemory;
+  if (!BlockTaken) {
+    //
+    // Here means all the memory test have finished
+    //
+    *TestedMemorySize = mTestedSystemMemory;
+    return EFI_NOT_FOUND;
+  }
+
+  //
+  // If TestAbort is true, means user cancel the memory test
+  //
+  if (!TestAbort && (Private->CoverLevel != IGNORE)) {
+    for (Index = 0; Index < Private->NumberOfProcessors; Index++) {
+      Worker = &Private->Workers[Index];
+      if (Worker->Length == 0) {
+        continue;
+      }
+
+      //
+      // Report status code of every memory block
+      //
+      ZeroMem (&RangeData, sizeof (RangeData));
+      RangeData.DataHeader.HeaderSize = (UINT16)sizeof (EFI_STATUS_CODE_DATA);
+      RangeData.DataHeader.Size       = (UINT16)(sizeof (EFI_MEMORY_RANGE_EXTENDED_DATA) - sizeof (EFI_STATUS_CODE_DATA));
+      RangeData.Start                 = Worker->StartAddress;
+      RangeData.Length                = Worker->Length;
+
+      REPORT_STATUS_CODE_EX (
+        EFI_PROGRESS_CODE,
+        EFI_COMPUTING_UNIT_MEMORY | EFI_CU_MEMORY_PC_TEST,
+        0,
+        &gEfiGenericMemTestProtocolGuid,
+        NULL,
+        (UINT8 *)&RangeData + sizeof (EFI_STATUS_CODE_DATA),
+        RangeData.DataHeader.Size
+        );
+    }
+
+    //
+    // If the MP services are busy, the BSP tests the blocks of the APs.
+    //
+    Status = Private->MpServices->StartupAllAPs (Private->MpServices, WriteMemoryTestProcedure, FALSE, NULL, 0, Private, NULL);
+    if (EFI_ERROR (Status)) {
+      for (Index = 0; Index < Private->NumberOfProcessors; Index++) {
+        Worker = &Private->Workers[Index];
+        if (Worker->Length != 0) {
+          WriteMemoryTestBlock (Private, Worker);
+        }
+      }
+
+      if (Private->LastBatch) {
+        WriteBackInvalidateDataCache ();
+      }
+    }
+
+    Status = Private->MpServices->StartupAllAPs (Private->MpServices, VerifyMemoryTestProcedure, FALSE, NULL, 0, Private, NULL);
+    for (Index = 0; Index < Private->NumberOfProcessors; Index++) {
+      Worker = &Private->Workers[Index];
+      if (Worker->Length == 0) {
+        continue;
+      }
+
+      if (EFI_ERROR (Status)) {
+        VerifyMemoryTestBlock (Private, Worker);
+      }
+
+      if (Worker->ErrorFound) {
+        //
+        // If perform here, means there is mis-compare error, and no agent can
+        // handle it, so we return to BDS EFI_DEVICE_ERROR.
+        //
+        ReportMemoryError (Worker->ErrorAddress);
+        *ErrorOut = TRUE;
+        return EFI_DEVICE_ERROR;
+      }
+    }
+  }
+
+  mTestedSystemMemory += BatchSize;
+  *TestedMemorySize    = mTestedSystemMemory;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Report the throughput of every AP and free the parallel memory test data.
+
+  @param[in] Private  Point to generic memory test driver's private data.
+
+**/
+VOID
+ParallelMemoryTestFinished (
+  IN  GENERIC_MEMORY_TEST_PRIVATE  *Private
+  )
+{
+  UINTN               Index;
+  MEMORY_TEST_WORKER  *Worker;
+  UINT64              Ns;
+
+  for (Index = 0; Index < Private->NumberOfProcessors; Index++) {
+    Worker = &Private->Workers[Index];
+    if (Worker->TestedSize == 0) {
+      continue;
+    }
+
+    //
+    // Bytes per microsecond is the throughput in MB/s.
+    //
+    Ns = GetTimeInNanoSecond (Worker->Ticks);
+    DEBUG ((
+      DEBUG_INFO,
+      "GenericMemoryTest: CPU %d domain 0x%x tested 0x%lx bytes in %ld us, %ld MB/s\n",
+      Index,
+      Worker->ProximityDomain,
+      Worker->TestedSize,
+      DivU64x32 (Ns, 1000),
+      (Ns == 0) ? 0 : DivU64x64Remainder (MultU64x32 (Worker->TestedSize, 1000), Ns, NULL)
+      ));
+  }
+
+  FreeParallelMemoryTest (Private);
+}
@@ -234,7 +234,10 @@ ErrorExit:
 /**
   Allocate a FORM_EXPRESSION node.
 
-  @param  Form                   The Form associated with this Expression
+  Expression nodes live as long as the FormSet, so they are carved out of the
+  FormSet expression arena instead of being allocated from pool one by one.
+
+  @param  FormSet                The FormSet associated with this Expression
   @param  OpCode                 The binary opcode data.
 
   @return Pointer to a FORM_EXPRESSION data structure.
@@ -242,13 +245,13 @@ ErrorExit:
 **/
 FORM_EXPRESSION *
 CreateExpression (
-  IN OUT FORM_BROWSER_FORM  *Form,
-  IN     UINT8              *OpCode
+  IN OUT FORM_BROWSER_FORMSET  *FormSet,
+  IN     UINT8                 *OpCode
   )
 {
   FORM_EXPRESSION  *Expression;
 
-  Expression = AllocateZeroPool (sizeof (FORM_EXPRESSION));
+  Expression = MemoryArenaAllocateZero (&FormSet->ExpressionArena, sizeof (FORM_EXPRESSION));
   if (Expression == NULL) {
     ASSERT (Expression != NULL);
     return NULL;
@@ -826,9 +829,9 @@ DestroyExpression (
   }
 
   //
-  // Free this Expression
+  // The Expression itself belongs to the FormSet expression arena and is
+  // released together with the FormSet.
   //
-  FreePool (Expression);
 }
 
 /**
@@ -1030,11 +1033,12 @@ DestroyFormSet (
   IN OUT FORM_BROWSER_FORMSET  *FormSet
   )
 {
-  LIST_ENTRY            *Link;
-  FORMSET_STORAGE       *Storage;
-  FORMSET_DEFAULTSTORE  *DefaultStore;
-  FORM_EXPRESSION       *Expression;
-  FORM_BROWSER_FORM     *Form;
+  LIST_ENTRY               *Link;
+  FORMSET_STORAGE          *Storage;
+  FORMSET_DEFAULTSTORE     *DefaultStore;
+  FORM_EXPRESSION          *Expression;
+  FORM_BROWSER_FORM        *Form;
+  MEMORY_ARENA_STATISTICS  ArenaStatistics;
 
   if (FormSet->IfrBinaryData == NULL) {
     //
@@ -1107,6 +1111,19 @@ DestroyFormSet (
     FreePool (FormSet->ExpressionBuffer);
   }
 
+  if (FormSet->ExpressionArena.Signature == MEMORY_ARENA_SIGNATURE) {
+    MemoryArenaGetStatistics (&FormSet->ExpressionArena, &ArenaStatistics);
+    DEBUG ((
+      DEBUG_VERBOSE,
+      "%a: %lu expressions from %lu page allocations\n",
+      __func__,
+      ArenaStatistics.AllocationCount,
+      ArenaStatistics.ChunkAllocationCount
+    ));
+
+    MemoryArenaFree (&FormSet->ExpressionArena);
+  }
+
   FreePool (FormSet);
 }
 
@@ -1290,6 +1307,7 @@ ParseOpCodes (
   BOOLEAN                  HaveInserted;
   UINT16                   TotalBits;
   BOOLEAN                  QuestionReferBitField;
+  MEMORY_ARENA_MARK        DisableIfMark;
 
   SuppressForQuestion    = FALSE;
   SuppressForOption      = FALSE;
@@ -1318,6 +1336,8 @@ ParseOpCodes (
   //
   CountOpCodes (FormSet, &NumberOfStatement, &NumberOfExpression);
 
+  MemoryArenaInitialize (&FormSet->ExpressionArena, EXPRESSION_ARENA_CHUNK_PAGES);
+
   mStatementIndex          = 0;
   mUsedQuestionId          = 1;
   FormSet->StatementBuffer = AllocateZeroPool (NumberOfStatement * sizeof (FORM_BROWSER_STATEMENT));
@@ -1639,7 +1659,7 @@ ParseOpCodes (
       // Create sub expression nested in MAP opcode
       //
       if ((CurrentExpression == NULL) && (MapScopeDepth > 0)) {
-        CurrentExpression = CreateExpression (CurrentForm, OpCodeData);
+        CurrentExpression = CreateExpression (FormSet, OpCodeData);
         if (CurrentExpression == NULL) {
           ASSERT (CurrentExpression != NULL);
           return EFI_OUT_OF_RESOURCES;
@@ -2512,7 +2532,7 @@ ParseOpCodes (
         //
         // Create an Expression node
         //
-        CurrentExpression = CreateExpression (CurrentForm, OpCodeData);
+        CurrentExpression = CreateExpression (FormSet, OpCodeData);
         if (CurrentExpression == NULL) {
           return EFI_OUT_OF_RESOURCES;
         }
@@ -2545,7 +2565,7 @@ ParseOpCodes (
         //
         // Create an Expression node
         //
-        CurrentExpression = CreateExpression (CurrentForm, OpCodeData);
+        CurrentExpression = CreateExpression (FormSet, OpCodeData);
         if (CurrentExpression == NULL) {
           return EFI_OUT_OF_RESOURCES;
         }
@@ -2571,7 +2591,7 @@ ParseOpCodes (
         //
         // Question and Option will appear in scope of this OpCode
         //
-        CurrentExpression = CreateExpression (CurrentForm, OpCodeData);
+        CurrentExpression = CreateExpression (FormSet, OpCodeData);
         if (CurrentExpression == NULL) {
           return EFI_OUT_OF_RESOURCES;
         }
@@ -2606,7 +2626,7 @@ ParseOpCodes (
         //
         // Questions will appear in scope of this OpCode
         //
-        CurrentExpression = CreateExpression (CurrentForm, OpCodeData);
+        CurrentExpression = CreateExpression (FormSet, OpCodeData);
         if (CurrentExpression == NULL) {
           return EFI_OUT_OF_RESOURCES;
         }
@@ -2633,7 +2653,15 @@ ParseOpCodes (
         // The DisableIf expression should only rely on constant, so it could be
         // evaluated at initialization and it will not be queued
         //
-        CurrentExpression = AllocateZeroPool (sizeof (FORM_EXPRESSION));
+        if (CurrentForm == NULL) {
+          //
+          // The FormSet level DisableIf expression is released right after it
+          // is evaluated, so remember where the arena stood.
+          //
+          MemoryArenaGetMark (&FormSet->ExpressionArena, &DisableIfMark);
+        }
+
+        CurrentExpression = MemoryArenaAllocateZero (&FormSet->ExpressionArena, sizeof (FORM_EXPRESSION));
         if (CurrentExpression == NULL) {
           ASSERT (CurrentExpression != NULL);
           return EFI_OUT_OF_RESOURCES;
@@ -2667,7 +2695,7 @@ ParseOpCodes (
       // Expression
       //
       case EFI_IFR_VALUE_OP:
-        CurrentExpression = CreateExpression (CurrentForm, OpCodeData);
+        CurrentExpression = CreateExpression (FormSet, OpCodeData);
         if (CurrentExpression == NULL) {
           return EFI_OUT_OF_RESOURCES;
         }
@@ -2710,7 +2738,7 @@ ParseOpCodes (
         break;
 
       case EFI_IFR_RULE_OP:
-        CurrentExpression = CreateExpression (CurrentForm, OpCodeData);
+        CurrentExpression = CreateExpression (FormSet, OpCodeData);
         if (CurrentExpression == NULL) {
           return EFI_OUT_OF_RESOURCES;
         }
@@ -2733,7 +2761,7 @@ ParseOpCodes (
         break;
 
       case EFI_IFR_READ_OP:
-        CurrentExpression = CreateExpression (CurrentForm, OpCodeData);
+        CurrentExpression = CreateExpression (FormSet, OpCodeData);
         if (CurrentExpression == NULL) {
           return EFI_OUT_OF_RESOURCES;
         }
@@ -2764,7 +2792,7 @@ ParseOpCodes (
         break;
 
       case EFI_IFR_WRITE_OP:
-        CurrentExpression = CreateExpression (CurrentForm, OpCodeData);
+        CurrentExpression = CreateExpression (FormSet, OpCodeData);
         if (CurrentExpression == NULL) {
           return EFI_OUT_OF_RESOURCES;
         }
@@ -3062,6 +3090,7 @@ ParseOpCodes (
                 // DisableIf Expression is only used once and not queued, free it
                 //
                 DestroyExpression (CurrentExpression);
+                MemoryArenaResetToMark (&FormSet->ExpressionArena, &DisableIfMark);
               }
 
               //
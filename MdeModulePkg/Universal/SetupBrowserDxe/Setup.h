@@ -39,6 +39,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/BaseLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/MemoryArenaLib.h>
 #include <Library/HiiLib.h>
 #include <Library/PcdLib.h>
 #include <Library/DevicePathLib.h>
@@ -68,6 +69,11 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 #define EXPRESSION_STACK_SIZE_INCREMENT  0x100
 
+//
+// Number of pages per chunk of the FormSet expression arena
+//
+#define EXPRESSION_ARENA_CHUNK_PAGES  4
+
 #define EFI_IFR_SPECIFICATION_VERSION  (UINT16) (((EFI_SYSTEM_TABLE_REVISION >> 16) << 8) | (((EFI_SYSTEM_TABLE_REVISION & 0xFFFF) / 10) << 4) | ((EFI_SYSTEM_TABLE_REVISION & 0xFFFF) % 10))
 
 #define SETUP_DRIVER_SIGNATURE  SIGNATURE_32 ('F', 'B', 'D', 'V')
@@ -464,6 +470,7 @@ typedef struct {
   LIST_ENTRY                        DefaultStoreListHead;    // DefaultStore list (FORMSET_DEFAULTSTORE)
   LIST_ENTRY                        FormListHead;            // Form list (FORM_BROWSER_FORM)
   LIST_ENTRY                        ExpressionListHead;      // List of Expressions (FORM_EXPRESSION)
+  MEMORY_ARENA                      ExpressionArena;         // Backing store of all FORM_EXPRESSION nodes
 } FORM_BROWSER_FORMSET;
 #define FORM_BROWSER_FORMSET_FROM_LINK(a)  CR (a, FORM_BROWSER_FORMSET, Link, FORM_BROWSER_FORMSET_SIGNATURE)
 
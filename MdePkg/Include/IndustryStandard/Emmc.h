@@ -1,7 +1,7 @@
 /** @file
   Header file for eMMC support.
 
-  This header file contains some definitions defined in EMMC4.5/EMMC5.0 spec.
+  This header file contains some definitions defined in EMMC4.5/EMMC5.0/EMMC5.1 spec.
 
   Copyright (c) 2015, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
@@ -48,6 +48,11 @@
 #define  EMMC_FAST_IO               39
 #define  EMMC_GO_IRQ_STATE          40
 #define  EMMC_LOCK_UNLOCK           42
+#define  EMMC_QUEUED_TASK_PARAMS    44
+#define  EMMC_QUEUED_TASK_ADDRESS   45
+#define  EMMC_EXECUTE_READ_TASK     46
+#define  EMMC_EXECUTE_WRITE_TASK    47
+#define  EMMC_CMDQ_TASK_MGMT        48
 #define  EMMC_SET_TIME              49
 #define  EMMC_PROTOCOL_RD           53
 #define  EMMC_PROTOCOL_WR           54
@@ -128,7 +133,8 @@ typedef struct {
   //
   // Modes Segment
   //
-  UINT8    Reserved[16];                          // Reserved [15:0]
+  UINT8    Reserved[15];                          // Reserved [14:0]
+  UINT8    CmdqModeEn;                            // Command queue mode enable R/W/E_P [15]
   UINT8    SecureRemovalType;                     // Secure Removal Type R/W & R [16]
   UINT8    ProductStateAwarenessEnablement;       // Product state awareness enablement R/W/E & R [17]
   UINT8    MaxPreLoadingDataSize[4];              // Max pre loading data size R [21:18]
@@ -265,7 +271,10 @@ typedef struct {
   UINT8    DeviceLifeTimeEstTypB;                 // Device life time estimation type B [269]
   UINT8    VendorProprietaryHealthReport[32];     // Vendor proprietary health report [301:270]
   UINT8    NumOfFwSectorsProgrammed[4];           // Number of FW sectors correctly programmed [305:302]
-  UINT8    Reserved21[181];                       // Reserved [486:306]
+  UINT8    Reserved21;                            // Reserved [306]
+  UINT8    CmdqDepth;                             // Command queue depth [307]
+  UINT8    CmdqSupport;                           // Command queue support [308]
+  UINT8    Reserved22[178];                       // Reserved [486:309]
   UINT8    FfuArg[4];                             // FFU Argument [490:487]
   UINT8    OperationCodeTimeout;                  // Operation codes timeout [491]
   UINT8    FfuFeatures;                           // FFU features [492]
@@ -282,7 +291,7 @@ typedef struct {
   UINT8    HpiFeatures;                           // HPI features [503]
   UINT8    SupportedCmdSet;                       // Supported Command Sets [504]
   UINT8    ExtSecurityErr;                        // Extended Security Commands Error [505]
-  UINT8    Reserved22[6];                         // Reserved [511:506]
+  UINT8    Reserved23[6];                         // Reserved [511:506]
 } EMMC_EXT_CSD;
 
 #pragma pack()
@@ -882,8 +882,8 @@ typedef struct {
   //
   UINT8           Opc;       // Opcode
   UINT8           Fuse  : 2; // Fused Operation
-  UINT8           Rsvd1 : 5;
-  UINT8           Psdt  : 1; // PRP or SGL for Data Transfer
+  UINT8           Rsvd1 : 4;
+  UINT8           Psdt  : 2; // PRP or SGL for Data Transfer
   UINT16          Cid;       // Command Identifier
 
   //
@@ -909,6 +909,34 @@ typedef struct {
   NVME_PAYLOAD    Payload;
 } NVME_SQ;
 
+//
+// PRP or SGL for Data Transfer (PSDT) field values
+//
+#define NVME_PSDT_PRP         0x0 // PRPs are used for the data transfer
+#define NVME_PSDT_SGL_BUFFER  0x1 // SGLs are used, MPTR is the address of a contiguous buffer
+
+//
+// SGL Data Block descriptor, placed in the Data Pointer (Prp[0] and Prp[1])
+// of a submission queue entry when SGLs are used for the data transfer.
+//
+typedef struct {
+  UINT64    Address;
+  UINT32    Length;
+  UINT8     Rsvd[3];
+  UINT8     SubType : 4;  // SGL Descriptor Sub Type
+  UINT8     Type    : 4;  // SGL Descriptor Type
+} NVME_SGL_DATA_BLOCK_DESCRIPTOR;
+
+#define NVME_SGL_DESCRIPTOR_TYPE_DATA_BLOCK  0x0
+
+//
+// SGL Support (SGLS) field of the Identify Controller data, bits 1:0
+//
+#define NVME_SGLS_SUPPORT_MASK             (BIT0 | BIT1)
+#define NVME_SGLS_NOT_SUPPORTED            0x0
+#define NVME_SGLS_SUPPORTED                0x1
+#define NVME_SGLS_SUPPORTED_DWORD_ALIGNED  0x2
+
 //
 // Completion Queue
 //
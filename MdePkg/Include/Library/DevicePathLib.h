@@ -432,6 +432,74 @@ IsDevicePathMultiInstance (
   IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath
   );
 
+///
+/// Hash of a device path that has no node other than the end node. It is also
+/// the initial Hash value to pass to HashDevicePathNode().
+///
+#define DEVICE_PATH_HASH_SEED  0x811C9DC5
+
+/**
+  Folds one device path node into a device path hash.
+
+  The hash is 32-bit FNV-1a over the bytes of the node, including its header.
+  Starting from DEVICE_PATH_HASH_SEED and folding the nodes of a device path
+  one after the other gives the same value as GetDevicePathHash(), so the
+  hash of every prefix of a device path can be computed in a single walk.
+
+  If Node is NULL, then ASSERT().
+
+  @param  Hash                       The hash of the nodes that precede Node.
+  @param  Node                       A pointer to a device path node data structure.
+
+  @return The hash of the nodes that precede Node, followed by Node.
+
+**/
+UINT32
+EFIAPI
+HashDevicePathNode (
+  IN UINT32      Hash,
+  IN CONST VOID  *Node
+  );
+
+/**
+  Returns the hash of a device path.
+
+  Every node before the end-of-device-path node is hashed, including the
+  end-of-instance nodes of a multi-instance device path. Two device paths that
+  CompareDevicePath() reports as equal have the same hash.
+
+  @param  DevicePath                 A pointer to a device path data structure.
+
+  @return The hash of DevicePath, or DEVICE_PATH_HASH_SEED if DevicePath is NULL.
+
+**/
+UINT32
+EFIAPI
+GetDevicePathHash (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath
+  );
+
+/**
+  Determines if two device paths are identical.
+
+  The device paths are compared node by node, so that the comparison stops at
+  the first node that differs without computing the size of either path.
+
+  @param  DevicePath1                A pointer to a device path data structure.
+  @param  DevicePath2                A pointer to a device path data structure.
+
+  @retval TRUE                       Every node of DevicePath1 matches the node of
+                                     DevicePath2 at the same position, or both are NULL.
+  @retval FALSE                      The device paths differ, or only one of them is NULL.
+
+**/
+BOOLEAN
+EFIAPI
+CompareDevicePath (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath1,
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath2
+  );
+
 /**
   Retrieves the device path protocol from a handle.
 
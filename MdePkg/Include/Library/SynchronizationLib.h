@@ -13,6 +13,46 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 ///
 typedef volatile UINTN SPIN_LOCK;
 
+///
+/// Definitions for TICKET_SPIN_LOCK.
+///
+/// A ticket lock grants the lock in arrival order, so no processor can be
+/// starved under contention.
+///
+typedef struct {
+  volatile UINT32    NextTicket;
+  volatile UINT32    NowServing;
+} TICKET_SPIN_LOCK;
+
+///
+/// Definitions for MCS_SPIN_LOCK.
+///
+/// An MCS lock queues the waiters, and every waiter spins on a flag in its
+/// own MCS_SPIN_LOCK_NODE. Only one cache line moves between processors when
+/// the lock is handed over, however many processors are waiting. The node
+/// must stay valid from acquire to release, typically on the caller stack.
+///
+typedef struct _MCS_SPIN_LOCK_NODE MCS_SPIN_LOCK_NODE;
+
+struct _MCS_SPIN_LOCK_NODE {
+  MCS_SPIN_LOCK_NODE *volatile    Next;
+  volatile UINT32                 Locked;
+};
+
+typedef struct {
+  MCS_SPIN_LOCK_NODE *volatile    Tail;
+} MCS_SPIN_LOCK;
+
+///
+/// Definitions for RW_SPIN_LOCK.
+///
+/// Any number of readers or a single writer may hold the lock. A waiting
+/// writer keeps new readers out, so writers are not starved.
+///
+typedef struct {
+  volatile UINT32    State;
+} RW_SPIN_LOCK;
+
 /**
   Retrieves the architecture-specific spin lock alignment requirements for
   optimal spin lock performance.
@@ -270,3 +310,276 @@ InterlockedCompareExchangePointer (
   IN      VOID                                 *CompareValue,
   IN      VOID                                 *ExchangeValue
   );
+
+/**
+  Initializes a ticket spin lock to the released state and returns the lock.
+
+  If TicketLock is NULL, then ASSERT().
+
+  @param  TicketLock  A pointer to the ticket spin lock to initialize.
+
+  @return TicketLock in the released state.
+
+**/
+TICKET_SPIN_LOCK *
+EFIAPI
+InitializeTicketSpinLock (
+  OUT TICKET_SPIN_LOCK  *TicketLock
+  );
+
+/**
+  Waits, in first-come first-served order, until a ticket spin lock is
+  granted to the caller.
+
+  If TicketLock is NULL, then ASSERT().
+  If PcdSpinLockTimeout is not zero, and TicketLock can not be acquired in
+  PcdSpinLockTimeout microseconds, then ASSERT().
+
+  @param  TicketLock  A pointer to the ticket spin lock to acquire.
+
+  @return TicketLock in the acquired state.
+
+**/
+TICKET_SPIN_LOCK *
+EFIAPI
+AcquireTicketSpinLock (
+  IN OUT TICKET_SPIN_LOCK  *TicketLock
+  );
+
+/**
+  Attempts to acquire a ticket spin lock without waiting.
+
+  The lock is acquired only if it is released and no other processor is
+  waiting for it.
+
+  If TicketLock is NULL, then ASSERT().
+
+  @param  TicketLock  A pointer to the ticket spin lock to acquire.
+
+  @retval TRUE   TicketLock was acquired.
+  @retval FALSE  TicketLock could not be acquired.
+
+**/
+BOOLEAN
+EFIAPI
+AcquireTicketSpinLockOrFail (
+  IN OUT TICKET_SPIN_LOCK  *TicketLock
+  );
+
+/**
+  Releases a ticket spin lock and hands it to the next waiter, if any.
+
+  If TicketLock is NULL, then ASSERT().
+  If TicketLock is not in the acquired state, then ASSERT().
+
+  @param  TicketLock  A pointer to the ticket spin lock to release.
+
+  @return TicketLock.
+
+**/
+TICKET_SPIN_LOCK *
+EFIAPI
+ReleaseTicketSpinLock (
+  IN OUT TICKET_SPIN_LOCK  *TicketLock
+  );
+
+/**
+  Initializes an MCS queue spin lock to the released state and returns the
+  lock.
+
+  If McsLock is NULL, then ASSERT().
+
+  @param  McsLock  A pointer to the MCS spin lock to initialize.
+
+  @return McsLock in the released state.
+
+**/
+MCS_SPIN_LOCK *
+EFIAPI
+InitializeMcsSpinLock (
+  OUT MCS_SPIN_LOCK  *McsLock
+  );
+
+/**
+  Queues the caller on an MCS spin lock and waits until the lock is handed
+  to it.
+
+  If McsLock or Node is NULL, then ASSERT().
+  If PcdSpinLockTimeout is not zero, and McsLock can not be acquired in
+  PcdSpinLockTimeout microseconds, then ASSERT().
+
+  @param  McsLock  A pointer to the MCS spin lock to acquire.
+  @param  Node     Caller-owned queue node. It must stay valid, and must not
+                   be used for another lock, until ReleaseMcsSpinLock().
+
+  @return McsLock in the acquired state.
+
+**/
+MCS_SPIN_LOCK *
+EFIAPI
+AcquireMcsSpinLock (
+  IN OUT MCS_SPIN_LOCK       *McsLock,
+  IN OUT MCS_SPIN_LOCK_NODE  *Node
+  );
+
+/**
+  Attempts to acquire an MCS spin lock without waiting.
+
+  If McsLock or Node is NULL, then ASSERT().
+
+  @param  McsLock  A pointer to the MCS spin lock to acquire.
+  @param  Node     Caller-owned queue node, used for ReleaseMcsSpinLock()
+                   if the lock is acquired.
+
+  @retval TRUE   McsLock was acquired.
+  @retval FALSE  McsLock could not be acquired.
+
+**/
+BOOLEAN
+EFIAPI
+AcquireMcsSpinLockOrFail (
+  IN OUT MCS_SPIN_LOCK       *McsLock,
+  IN OUT MCS_SPIN_LOCK_NODE  *Node
+  );
+
+/**
+  Releases an MCS spin lock and hands it to the next queued waiter, if any.
+
+  If McsLock or Node is NULL, then ASSERT().
+
+  @param  McsLock  A pointer to the MCS spin lock to release.
+  @param  Node     The queue node passed to the call that acquired McsLock.
+
+  @return McsLock.
+
+**/
+MCS_SPIN_LOCK *
+EFIAPI
+ReleaseMcsSpinLock (
+  IN OUT MCS_SPIN_LOCK       *McsLock,
+  IN OUT MCS_SPIN_LOCK_NODE  *Node
+  );
+
+/**
+  Initializes a reader-writer spin lock to the released state and returns
+  the lock.
+
+  If RwLock is NULL, then ASSERT().
+
+  @param  RwLock  A pointer to the reader-writer spin lock to initialize.
+
+  @return RwLock in the released state.
+
+**/
+RW_SPIN_LOCK *
+EFIAPI
+InitializeRwSpinLock (
+  OUT RW_SPIN_LOCK  *RwLock
+  );
+
+/**
+  Waits until a reader-writer spin lock can be acquired for shared access.
+
+  If RwLock is NULL, then ASSERT().
+  If PcdSpinLockTimeout is not zero, and RwLock can not be acquired in
+  PcdSpinLockTimeout microseconds, then ASSERT().
+
+  @param  RwLock  A pointer to the reader-writer spin lock to acquire.
+
+  @return RwLock acquired for shared access.
+
+**/
+RW_SPIN_LOCK *
+EFIAPI
+AcquireRwSpinLockShared (
+  IN OUT RW_SPIN_LOCK  *RwLock
+  );
+
+/**
+  Attempts to acquire a reader-writer spin lock for shared access without
+  waiting.
+
+  If RwLock is NULL, then ASSERT().
+
+  @param  RwLock  A pointer to the reader-writer spin lock to acquire.
+
+  @retval TRUE   RwLock was acquired for shared access.
+  @retval FALSE  A writer holds or waits for RwLock.
+
+**/
+BOOLEAN
+EFIAPI
+AcquireRwSpinLockSharedOrFail (
+  IN OUT RW_SPIN_LOCK  *RwLock
+  );
+
+/**
+  Releases shared access to a reader-writer spin lock.
+
+  If RwLock is NULL, then ASSERT().
+  If RwLock is not held for shared access, then ASSERT().
+
+  @param  RwLock  A pointer to the reader-writer spin lock to release.
+
+  @return RwLock.
+
+**/
+RW_SPIN_LOCK *
+EFIAPI
+ReleaseRwSpinLockShared (
+  IN OUT RW_SPIN_LOCK  *RwLock
+  );
+
+/**
+  Waits until a reader-writer spin lock can be acquired for exclusive
+  access.
+
+  If RwLock is NULL, then ASSERT().
+  If PcdSpinLockTimeout is not zero, and RwLock can not be acquired in
+  PcdSpinLockTimeout microseconds, then ASSERT().
+
+  @param  RwLock  A pointer to the reader-writer spin lock to acquire.
+
+  @return RwLock acquired for exclusive access.
+
+**/
+RW_SPIN_LOCK *
+EFIAPI
+AcquireRwSpinLockExclusive (
+  IN OUT RW_SPIN_LOCK  *RwLock
+  );
+
+/**
+  Attempts to acquire a reader-writer spin lock for exclusive access
+  without waiting.
+
+  If RwLock is NULL, then ASSERT().
+
+  @param  RwLock  A pointer to the reader-writer spin lock to acquire.
+
+  @retval TRUE   RwLock was acquired for exclusive access.
+  @retval FALSE  RwLock is held by a reader or a writer.
+
+**/
+BOOLEAN
+EFIAPI
+AcquireRwSpinLockExclusiveOrFail (
+  IN OUT RW_SPIN_LOCK  *RwLock
+  );
+
+/**
+  Releases exclusive access to a reader-writer spin lock.
+
+  If RwLock is NULL, then ASSERT().
+  If RwLock is not held for exclusive access, then ASSERT().
+
+  @param  RwLock  A pointer to the reader-writer spin lock to release.
+
+  @return RwLock.
+
+**/
+RW_SPIN_LOCK *
+EFIAPI
+ReleaseRwSpinLockExclusive (
+  IN OUT RW_SPIN_LOCK  *RwLock
+  );
@@ -297,6 +297,63 @@ InternalMathDivRemS64x64 (
   OUT     INT64  *Remainder  OPTIONAL
   );
 
+//
+// Checksum functions
+//
+
+/**
+  Returns the sum of all elements in a buffer of 8-bit values, dropping the
+  carry bits.
+
+  @param  Buffer      The pointer to the buffer to carry out the sum operation.
+  @param  Length      The size, in bytes, of Buffer.
+
+  @return The sum of Buffer with carry bits dropped during additions.
+
+**/
+UINT8
+EFIAPI
+InternalCalculateSum8 (
+  IN      CONST UINT8  *Buffer,
+  IN      UINTN        Length
+  );
+
+/**
+  Returns the sum of all elements in a buffer of 16-bit values, dropping the
+  carry bits.
+
+  @param  Buffer      The pointer to the buffer to carry out the sum operation.
+                      Aligned on a 16-bit boundary.
+  @param  Count       The number of 16-bit values in Buffer.
+
+  @return The sum of Buffer with carry bits dropped during additions.
+
+**/
+UINT16
+EFIAPI
+InternalCalculateSum16 (
+  IN      CONST UINT16  *Buffer,
+  IN      UINTN         Count
+  );
+
+/**
+  Returns the sum of all elements in a buffer of 32-bit values, dropping the
+  carry bits.
+
+  @param  Buffer      The pointer to the buffer to carry out the sum operation.
+                      Aligned on a 32-bit boundary.
+  @param  Count       The number of 32-bit values in Buffer.
+
+  @return The sum of Buffer with carry bits dropped during additions.
+
+**/
+UINT32
+EFIAPI
+InternalCalculateSum32 (
+  IN      CONST UINT32  *Buffer,
+  IN      UINTN         Count
+  );
+
 /**
   Transfers control to a function starting with a new stack.
 
@@ -35,17 +35,10 @@ CalculateSum8 (
   IN      UINTN        Length
   )
 {
-  UINT8  Sum;
-  UINTN  Count;
-
   ASSERT (Buffer != NULL);
   ASSERT (Length <= (MAX_ADDRESS - ((UINTN)Buffer) + 1));
 
-  for (Sum = 0, Count = 0; Count < Length; Count++) {
-    Sum = (UINT8)(Sum + *(Buffer + Count));
-  }
-
-  return Sum;
+  return InternalCalculateSum8 (Buffer, Length);
 }
 
 /**
@@ -109,21 +102,12 @@ CalculateSum16 (
   IN      UINTN         Length
   )
 {
-  UINT16  Sum;
-  UINTN   Count;
-  UINTN   Total;
-
   ASSERT (Buffer != NULL);
   ASSERT (((UINTN)Buffer & 0x1) == 0);
   ASSERT ((Length & 0x1) == 0);
   ASSERT (Length <= (MAX_ADDRESS - ((UINTN)Buffer) + 1));
 
-  Total = Length / sizeof (*Buffer);
-  for (Sum = 0, Count = 0; Count < Total; Count++) {
-    Sum = (UINT16)(Sum + *(Buffer + Count));
-  }
-
-  return Sum;
+  return InternalCalculateSum16 (Buffer, Length / sizeof (*Buffer));
 }
 
 /**
@@ -189,21 +173,12 @@ CalculateSum32 (
   IN      UINTN         Length
   )
 {
-  UINT32  Sum;
-  UINTN   Count;
-  UINTN   Total;
-
   ASSERT (Buffer != NULL);
   ASSERT (((UINTN)Buffer & 0x3) == 0);
   ASSERT ((Length & 0x3) == 0);
   ASSERT (Length <= (MAX_ADDRESS - ((UINTN)Buffer) + 1));
 
-  Total = Length / sizeof (*Buffer);
-  for (Sum = 0, Count = 0; Count < Total; Count++) {
-    Sum = Sum + *(Buffer + Count);
-  }
-
-  return Sum;
+  return InternalCalculateSum32 (Buffer, Length / sizeof (*Buffer));
 }
 
 /**
@@ -0,0 +1,99 @@
+/** @file
+  Architecture independent sum of buffer elements used by the checksum
+  functions.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "BaseLibInternals.h"
+
+//
+// The sums are accumulated in a UINTN and the carry bits are dropped once at
+// the end, which gives the same result as dropping them after every addition
+// and lets the compiler keep the loops free of truncations.
+//
+
+/**
+  Returns the sum of all elements in a buffer of 8-bit values, dropping the
+  carry bits.
+
+  @param  Buffer      The pointer to the buffer to carry out the sum operation.
+  @param  Length      The size, in bytes, of Buffer.
+
+  @return The sum of Buffer with carry bits dropped during additions.
+
+**/
+UINT8
+EFIAPI
+InternalCalculateSum8 (
+  IN      CONST UINT8  *Buffer,
+  IN      UINTN        Length
+  )
+{
+  UINTN  Sum;
+  UINTN  Index;
+
+  for (Sum = 0, Index = 0; Index < Length; Index++) {
+    Sum += Buffer[Index];
+  }
+
+  return (UINT8)Sum;
+}
+
+/**
+  Returns the sum of all elements in a buffer of 16-bit values, dropping the
+  carry bits.
+
+  @param  Buffer      The pointer to the buffer to carry out the sum operation.
+                      Aligned on a 16-bit boundary.
+  @param  Count       The number of 16-bit values in Buffer.
+
+  @return The sum of Buffer with carry bits dropped during additions.
+
+**/
+UINT16
+EFIAPI
+InternalCalculateSum16 (
+  IN      CONST UINT16  *Buffer,
+  IN      UINTN         Count
+  )
+{
+  UINTN  Sum;
+  UINTN  Index;
+
+  for (Sum = 0, Index = 0; Index < Count; Index++) {
+    Sum += Buffer[Index];
+  }
+
+  return (UINT16)Sum;
+}
+
+/**
+  Returns the sum of all elements in a buffer of 32-bit values, dropping the
+  carry bits.
+
+  @param  Buffer      The pointer to the buffer to carry out the sum operation.
+                      Aligned on a 32-bit boundary.
+  @param  Count       The number of 32-bit values in Buffer.
+
+  @return The sum of Buffer with carry bits dropped during additions.
+
+**/
+UINT32
+EFIAPI
+InternalCalculateSum32 (
+  IN      CONST UINT32  *Buffer,
+  IN      UINTN         Count
+  )
+{
+  UINTN  Sum;
+  UINTN  Index;
+
+  for (Sum = 0, Index = 0; Index < Count; Index++) {
+    Sum += Buffer[Index];
+  }
+
+  return (UINT32)Sum;
+}
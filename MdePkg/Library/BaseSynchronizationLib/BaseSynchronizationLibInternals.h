@@ -136,3 +136,38 @@ UINTN
 InternalGetSpinLockProperties (
   VOID
   );
+
+///
+/// State used to enforce PcdSpinLockTimeout while waiting for a lock.
+///
+typedef struct {
+  UINT64    Current;
+  UINT64    Total;
+  UINT64    Timeout;
+  UINT64    Start;
+  UINT64    End;
+  INT64     Cycle;
+} SPIN_LOCK_WAIT_CONTEXT;
+
+/**
+  Prepares waiting for a lock.
+
+  @param  WaitContext  The wait context to initialize.
+
+**/
+VOID
+InternalSpinLockWaitStart (
+  OUT SPIN_LOCK_WAIT_CONTEXT  *WaitContext
+  );
+
+/**
+  Pauses once while waiting for a lock, and ASSERT()s if the time spent
+  waiting exceeds PcdSpinLockTimeout.
+
+  @param  WaitContext  The wait context prepared by InternalSpinLockWaitStart().
+
+**/
+VOID
+InternalSpinLockWait (
+  IN OUT SPIN_LOCK_WAIT_CONTEXT  *WaitContext
+  );
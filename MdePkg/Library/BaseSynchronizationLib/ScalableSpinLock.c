@@ -0,0 +1,587 @@
+/** @file
+  Ticket, MCS queue and reader-writer spin locks.
+
+  The locks are built on the architecture specific interlocked primitives of
+  this library, so they are available on every architecture that provides
+  them.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "BaseSynchronizationLibInternals.h"
+
+#define RW_SPIN_LOCK_WRITER          BIT31
+#define RW_SPIN_LOCK_WRITER_WAITING  BIT30
+#define RW_SPIN_LOCK_READER_MASK     (BIT30 - 1)
+
+/**
+  Prepares waiting for a lock.
+
+  @param  WaitContext  The wait context to initialize.
+
+**/
+VOID
+InternalSpinLockWaitStart (
+  OUT SPIN_LOCK_WAIT_CONTEXT  *WaitContext
+  )
+{
+  WaitContext->Total   = 0;
+  WaitContext->Timeout = 0;
+  if (PcdGet32 (PcdSpinLockTimeout) == 0) {
+    return;
+  }
+
+  WaitContext->Current = GetPerformanceCounter ();
+  WaitContext->Start   = 0;
+  WaitContext->End     = 0;
+
+  //
+  // Compute the number of performance counter ticks required to reach the
+  // timeout, and the length of one counter cycle to handle wrap-around.
+  //
+  WaitContext->Timeout = DivU64x32 (
+                           MultU64x32 (
+                             GetPerformanceCounterProperties (&WaitContext->Start, &WaitContext->End),
+                             PcdGet32 (PcdSpinLockTimeout)
+                             ),
+                           1000000
+                           );
+  WaitContext->Cycle = WaitContext->End - WaitContext->Start;
+  if (WaitContext->Cycle < 0) {
+    WaitContext->Cycle = -WaitContext->Cycle;
+  }
+
+  WaitContext->Cycle++;
+}
+
+/**
+  Pauses once while waiting for a lock, and ASSERT()s if the time spent
+  waiting exceeds PcdSpinLockTimeout.
+
+  @param  WaitContext  The wait context prepared by InternalSpinLockWaitStart().
+
+**/
+VOID
+InternalSpinLockWait (
+  IN OUT SPIN_LOCK_WAIT_CONTEXT  *WaitContext
+  )
+{
+  UINT64  Previous;
+  INT64   Delta;
+
+  CpuPause ();
+  if (WaitContext->Timeout == 0) {
+    return;
+  }
+
+  Previous             = WaitContext->Current;
+  WaitContext->Current = GetPerformanceCounter ();
+  Delta                = (INT64)(WaitContext->Current - Previous);
+  if (WaitContext->Start > WaitContext->End) {
+    Delta = -Delta;
+  }
+
+  if (Delta < 0) {
+    Delta += WaitContext->Cycle;
+  }
+
+  WaitContext->Total += Delta;
+  ASSERT (WaitContext->Total < WaitContext->Timeout);
+}
+
+/**
+  Initializes a ticket spin lock to the released state and returns the lock.
+
+  If TicketLock is NULL, then ASSERT().
+
+  @param  TicketLock  A pointer to the ticket spin lock to initialize.
+
+  @return TicketLock in the released state.
+
+**/
+TICKET_SPIN_LOCK *
+EFIAPI
+InitializeTicketSpinLock (
+  OUT TICKET_SPIN_LOCK  *TicketLock
+  )
+{
+  ASSERT (TicketLock != NULL);
+
+  TicketLock->NextTicket = 0;
+  TicketLock->NowServing = 0;
+  MemoryFence ();
+  return TicketLock;
+}
+
+/**
+  Waits, in first-come first-served order, until a ticket spin lock is
+  granted to the caller.
+
+  If TicketLock is NULL, then ASSERT().
+  If PcdSpinLockTimeout is not zero, and TicketLock can not be acquired in
+  PcdSpinLockTimeout microseconds, then ASSERT().
+
+  @param  TicketLock  A pointer to the ticket spin lock to acquire.
+
+  @return TicketLock in the acquired state.
+
+**/
+TICKET_SPIN_LOCK *
+EFIAPI
+AcquireTicketSpinLock (
+  IN OUT TICKET_SPIN_LOCK  *TicketLock
+  )
+{
+  UINT32                  Ticket;
+  SPIN_LOCK_WAIT_CONTEXT  WaitContext;
+
+  ASSERT (TicketLock != NULL);
+
+  //
+  // InterlockedIncrement() returns the incremented value, so the ticket
+  // drawn by this caller is one less.
+  //
+  Ticket = InterlockedIncrement (&TicketLock->NextTicket) - 1;
+  if (TicketLock->NowServing != Ticket) {
+    InternalSpinLockWaitStart (&WaitContext);
+    while (TicketLock->NowServing != Ticket) {
+      InternalSpinLockWait (&WaitContext);
+    }
+  }
+
+  MemoryFence ();
+  return TicketLock;
+}
+
+/**
+  Attempts to acquire a ticket spin lock without waiting.
+
+  The lock is acquired only if it is released and no other processor is
+  waiting for it.
+
+  If TicketLock is NULL, then ASSERT().
+
+  @param  TicketLock  A pointer to the ticket spin lock to acquire.
+
+  @retval TRUE   TicketLock was acquired.
+  @retval FALSE  TicketLock could not be acquired.
+
+**/
+BOOLEAN
+EFIAPI
+AcquireTicketSpinLockOrFail (
+  IN OUT TICKET_SPIN_LOCK  *TicketLock
+  )
+{
+  UINT32  Serving;
+
+  ASSERT (TicketLock != NULL);
+
+  Serving = TicketLock->NowServing;
+  return (BOOLEAN)(InterlockedCompareExchange32 (&TicketLock->NextTicket, Serving, Serving + 1) == Serving);
+}
+
+/**
+  Releases a ticket spin lock and hands it to the next waiter, if any.
+
+  If TicketLock is NULL, then ASSERT().
+  If TicketLock is not in the acquired state, then ASSERT().
+
+  @param  TicketLock  A pointer to the ticket spin lock to release.
+
+  @return TicketLock.
+
+**/
+TICKET_SPIN_LOCK *
+EFIAPI
+ReleaseTicketSpinLock (
+  IN OUT TICKET_SPIN_LOCK  *TicketLock
+  )
+{
+  ASSERT (TicketLock != NULL);
+  ASSERT (TicketLock->NextTicket != TicketLock->NowServing);
+
+  //
+  // Only the owner writes NowServing, so a plain store after the fence is
+  // enough to publish the critical section and pass the lock on.
+  //
+  MemoryFence ();
+  TicketLock->NowServing = TicketLock->NowServing + 1;
+  MemoryFence ();
+  return TicketLock;
+}
+
+/**
+  Initializes an MCS queue spin lock to the released state and returns the
+  lock.
+
+  If McsLock is NULL, then ASSERT().
+
+  @param  McsLock  A pointer to the MCS spin lock to initialize.
+
+  @return McsLock in the released state.
+
+**/
+MCS_SPIN_LOCK *
+EFIAPI
+InitializeMcsSpinLock (
+  OUT MCS_SPIN_LOCK  *McsLock
+  )
+{
+  ASSERT (McsLock != NULL);
+
+  McsLock->Tail = NULL;
+  MemoryFence ();
+  return McsLock;
+}
+
+/**
+  Queues the caller on an MCS spin lock and waits until the lock is handed
+  to it.
+
+  If McsLock or Node is NULL, then ASSERT().
+  If PcdSpinLockTimeout is not zero, and McsLock can not be acquired in
+  PcdSpinLockTimeout microseconds, then ASSERT().
+
+  @param  McsLock  A pointer to the MCS spin lock to acquire.
+  @param  Node     Caller-owned queue node. It must stay valid, and must not
+                   be used for another lock, until ReleaseMcsSpinLock().
+
+  @return McsLock in the acquired state.
+
+**/
+MCS_SPIN_LOCK *
+EFIAPI
+AcquireMcsSpinLock (
+  IN OUT MCS_SPIN_LOCK       *McsLock,
+  IN OUT MCS_SPIN_LOCK_NODE  *Node
+  )
+{
+  MCS_SPIN_LOCK_NODE      *Predecessor;
+  SPIN_LOCK_WAIT_CONTEXT  WaitContext;
+
+  ASSERT (McsLock != NULL);
+  ASSERT (Node != NULL);
+
+  Node->Next   = NULL;
+  Node->Locked = 1;
+  MemoryFence ();
+
+  //
+  // Atomically append Node to the queue.
+  //
+  do {
+    Predecessor = McsLock->Tail;
+  } while (InterlockedCompareExchangePointer ((VOID **)&McsLock->Tail, Predecessor, Node) != Predecessor);
+
+  if (Predecessor != NULL) {
+    //
+    // Link behind the predecessor and spin on the local flag only.
+    //
+    Predecessor->Next = Node;
+    InternalSpinLockWaitStart (&WaitContext);
+    while (Node->Locked != 0) {
+      InternalSpinLockWait (&WaitContext);
+    }
+  }
+
+  MemoryFence ();
+  return McsLock;
+}
+
+/**
+  Attempts to acquire an MCS spin lock without waiting.
+
+  If McsLock or Node is NULL, then ASSERT().
+
+  @param  McsLock  A pointer to the MCS spin lock to acquire.
+  @param  Node     Caller-owned queue node, used for ReleaseMcsSpinLock()
+                   if the lock is acquired.
+
+  @retval TRUE   McsLock was acquired.
+  @retval FALSE  McsLock could not be acquired.
+
+**/
+BOOLEAN
+EFIAPI
+AcquireMcsSpinLockOrFail (
+  IN OUT MCS_SPIN_LOCK       *McsLock,
+  IN OUT MCS_SPIN_LOCK_NODE  *Node
+  )
+{
+  ASSERT (McsLock != NULL);
+  ASSERT (Node != NULL);
+
+  Node->Next   = NULL;
+  Node->Locked = 0;
+  MemoryFence ();
+
+  return (BOOLEAN)(InterlockedCompareExchangePointer ((VOID **)&McsLock->Tail, NULL, Node) == NULL);
+}
+
+/**
+  Releases an MCS spin lock and hands it to the next queued waiter, if any.
+
+  If McsLock or Node is NULL, then ASSERT().
+
+  @param  McsLock  A pointer to the MCS spin lock to release.
+  @param  Node     The queue node passed to the call that acquired McsLock.
+
+  @return McsLock.
+
+**/
+MCS_SPIN_LOCK *
+EFIAPI
+ReleaseMcsSpinLock (
+  IN OUT MCS_SPIN_LOCK       *McsLock,
+  IN OUT MCS_SPIN_LOCK_NODE  *Node
+  )
+{
+  SPIN_LOCK_WAIT_CONTEXT  WaitContext;
+
+  ASSERT (McsLock != NULL);
+  ASSERT (Node != NULL);
+  ASSERT (McsLock->Tail != NULL);
+
+  MemoryFence ();
+  if (Node->Next == NULL) {
+    //
+    // No known successor. If Node is still the tail the queue becomes empty.
+    //
+    if (InterlockedCompareExchangePointer ((VOID **)&McsLock->Tail, Node, NULL) == Node) {
+      return McsLock;
+    }
+
+    //
+    // A successor swapped itself in but has not linked behind Node yet.
+    //
+    InternalSpinLockWaitStart (&WaitContext);
+    while (Node->Next == NULL) {
+      InternalSpinLockWait (&WaitContext);
+    }
+  }
+
+  Node->Next->Locked = 0;
+  MemoryFence ();
+  return McsLock;
+}
+
+/**
+  Initializes a reader-writer spin lock to the released state and returns
+  the lock.
+
+  If RwLock is NULL, then ASSERT().
+
+  @param  RwLock  A pointer to the reader-writer spin lock to initialize.
+
+  @return RwLock in the released state.
+
+**/
+RW_SPIN_LOCK *
+EFIAPI
+InitializeRwSpinLock (
+  OUT RW_SPIN_LOCK  *RwLock
+  )
+{
+  ASSERT (RwLock != NULL);
+
+  RwLock->State = 0;
+  MemoryFence ();
+  return RwLock;
+}
+
+/**
+  Attempts to acquire a reader-writer spin lock for shared access without
+  waiting.
+
+  If RwLock is NULL, then ASSERT().
+
+  @param  RwLock  A pointer to the reader-writer spin lock to acquire.
+
+  @retval TRUE   RwLock was acquired for shared access.
+  @retval FALSE  A writer holds or waits for RwLock.
+
+**/
+BOOLEAN
+EFIAPI
+AcquireRwSpinLockSharedOrFail (
+  IN OUT RW_SPIN_LOCK  *RwLock
+  )
+{
+  UINT32  State;
+
+  ASSERT (RwLock != NULL);
+
+  State = RwLock->State;
+  if ((State & (RW_SPIN_LOCK_WRITER | RW_SPIN_LOCK_WRITER_WAITING)) != 0) {
+    return FALSE;
+  }
+
+  ASSERT ((State & RW_SPIN_LOCK_READER_MASK) != RW_SPIN_LOCK_READER_MASK);
+  return (BOOLEAN)(InterlockedCompareExchange32 (&RwLock->State, State, State + 1) == State);
+}
+
+/**
+  Waits until a reader-writer spin lock can be acquired for shared access.
+
+  If RwLock is NULL, then ASSERT().
+  If PcdSpinLockTimeout is not zero, and RwLock can not be acquired in
+  PcdSpinLockTimeout microseconds, then ASSERT().
+
+  @param  RwLock  A pointer to the reader-writer spin lock to acquire.
+
+  @return RwLock acquired for shared access.
+
+**/
+RW_SPIN_LOCK *
+EFIAPI
+AcquireRwSpinLockShared (
+  IN OUT RW_SPIN_LOCK  *RwLock
+  )
+{
+  SPIN_LOCK_WAIT_CONTEXT  WaitContext;
+
+  if (!AcquireRwSpinLockSharedOrFail (RwLock)) {
+    InternalSpinLockWaitStart (&WaitContext);
+    do {
+      InternalSpinLockWait (&WaitContext);
+    } while (!AcquireRwSpinLockSharedOrFail (RwLock));
+  }
+
+  return RwLock;
+}
+
+/**
+  Releases shared access to a reader-writer spin lock.
+
+  If RwLock is NULL, then ASSERT().
+  If RwLock is not held for shared access, then ASSERT().
+
+  @param  RwLock  A pointer to the reader-writer spin lock to release.
+
+  @return RwLock.
+
+**/
+RW_SPIN_LOCK *
+EFIAPI
+ReleaseRwSpinLockShared (
+  IN OUT RW_SPIN_LOCK  *RwLock
+  )
+{
+  ASSERT (RwLock != NULL);
+  ASSERT ((RwLock->State & RW_SPIN_LOCK_READER_MASK) != 0);
+  ASSERT ((RwLock->State & RW_SPIN_LOCK_WRITER) == 0);
+
+  InterlockedDecrement (&RwLock->State);
+  return RwLock;
+}
+
+/**
+  Attempts to acquire a reader-writer spin lock for exclusive access
+  without waiting.
+
+  If RwLock is NULL, then ASSERT().
+
+  @param  RwLock  A pointer to the reader-writer spin lock to acquire.
+
+  @retval TRUE   RwLock was acquired for exclusive access.
+  @retval FALSE  RwLock is held by a reader or a writer.
+
+**/
+BOOLEAN
+EFIAPI
+AcquireRwSpinLockExclusiveOrFail (
+  IN OUT RW_SPIN_LOCK  *RwLock
+  )
+{
+  UINT32  State;
+
+  ASSERT (RwLock != NULL);
+
+  //
+  // The writer-waiting flag may be set by this or another writer; taking
+  // the lock clears it, and writers still waiting set it again.
+  //
+  State = RwLock->State;
+  if ((State & ~RW_SPIN_LOCK_WRITER_WAITING) != 0) {
+    return FALSE;
+  }
+
+  return (BOOLEAN)(InterlockedCompareExchange32 (&RwLock->State, State, RW_SPIN_LOCK_WRITER) == State);
+}
+
+/**
+  Waits until a reader-writer spin lock can be acquired for exclusive
+  access.
+
+  If RwLock is NULL, then ASSERT().
+  If PcdSpinLockTimeout is not zero, and RwLock can not be acquired in
+  PcdSpinLockTimeout microseconds, then ASSERT().
+
+  @param  RwLock  A pointer to the reader-writer spin lock to acquire.
+
+  @return RwLock acquired for exclusive access.
+
+**/
+RW_SPIN_LOCK *
+EFIAPI
+AcquireRwSpinLockExclusive (
+  IN OUT RW_SPIN_LOCK  *RwLock
+  )
+{
+  UINT32                  State;
+  SPIN_LOCK_WAIT_CONTEXT  WaitContext;
+
+  if (AcquireRwSpinLockExclusiveOrFail (RwLock)) {
+    return RwLock;
+  }
+
+  InternalSpinLockWaitStart (&WaitContext);
+  do {
+    //
+    // Announce the waiting writer so that no new reader enters.
+    //
+    State = RwLock->State;
+    if ((State & RW_SPIN_LOCK_WRITER_WAITING) == 0) {
+      InterlockedCompareExchange32 (&RwLock->State, State, State | RW_SPIN_LOCK_WRITER_WAITING);
+    }
+
+    InternalSpinLockWait (&WaitContext);
+  } while (!AcquireRwSpinLockExclusiveOrFail (RwLock));
+
+  return RwLock;
+}
+
+/**
+  Releases exclusive access to a reader-writer spin lock.
+
+  If RwLock is NULL, then ASSERT().
+  If RwLock is not held for exclusive access, then ASSERT().
+
+  @param  RwLock  A pointer to the reader-writer spin lock to release.
+
+  @return RwLock.
+
+**/
+RW_SPIN_LOCK *
+EFIAPI
+ReleaseRwSpinLockExclusive (
+  IN OUT RW_SPIN_LOCK  *RwLock
+  )
+{
+  UINT32  State;
+
+  ASSERT (RwLock != NULL);
+  ASSERT ((RwLock->State & RW_SPIN_LOCK_WRITER) != 0);
+
+  //
+  // Waiting writers may set the writer-waiting flag concurrently, keep it.
+  //
+  do {
+    State = RwLock->State;
+  } while (InterlockedCompareExchange32 (&RwLock->State, State, State & ~RW_SPIN_LOCK_WRITER) != State);
+
+  return RwLock;
+}
@@ -28,24 +28,21 @@ GLOBAL_REMOVE_IF_UNREFERENCED CONST EFI_DEVICE_PATH_PROTOCOL  mUefiDevicePathLib
 };
 
 /**
-  Determine whether a given device path is valid.
+  Validate a device path and return its size.
+
+  The device path is validated and measured in the same walk, so that callers
+  that need both do not walk the device path twice.
 
   @param  DevicePath  A pointer to a device path data structure.
-  @param  MaxSize     The maximum size of the device path data structure.
+  @param  MaxSize     The maximum size of the device path data structure, or 0
+                      for no limit.
 
-  @retval TRUE        DevicePath is valid.
-  @retval FALSE       DevicePath is NULL.
-  @retval FALSE       Maxsize is less than sizeof(EFI_DEVICE_PATH_PROTOCOL).
-  @retval FALSE       The length of any node node in the DevicePath is less
-                      than sizeof (EFI_DEVICE_PATH_PROTOCOL).
-  @retval FALSE       If MaxSize is not zero, the size of the DevicePath
-                      exceeds MaxSize.
-  @retval FALSE       If PcdMaximumDevicePathNodeCount is not zero, the node
-                      count of the DevicePath exceeds PcdMaximumDevicePathNodeCount.
+  @retval 0           DevicePath is invalid. See IsDevicePathValid() for the
+                      conditions checked.
+  @retval Others      The size of DevicePath in bytes, including the end node.
 **/
-BOOLEAN
-EFIAPI
-IsDevicePathValid (
+UINTN
+UefiDevicePathLibGetValidDevicePathSize (
   IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
   IN       UINTN                     MaxSize
   )
@@ -58,7 +55,7 @@ IsDevicePathValid (
   // Validate the input whether exists and its size big enough to touch the first node
   //
   if ((DevicePath == NULL) || ((MaxSize > 0) && (MaxSize < END_DEVICE_PATH_LENGTH))) {
-    return FALSE;
+    return 0;
   }
 
   if (MaxSize == 0) {
@@ -68,11 +65,11 @@ IsDevicePathValid (
   for (Count = 0, Size = 0; !IsDevicePathEnd (DevicePath); DevicePath = NextDevicePathNode (DevicePath)) {
     NodeLength = DevicePathNodeLength (DevicePath);
     if (NodeLength < sizeof (EFI_DEVICE_PATH_PROTOCOL)) {
-      return FALSE;
+      return 0;
     }
 
     if (NodeLength > MAX_UINTN - Size) {
-      return FALSE;
+      return 0;
     }
 
     Size += NodeLength;
@@ -81,13 +78,13 @@ IsDevicePathValid (
     // Validate next node before touch it.
     //
     if (Size > MaxSize - END_DEVICE_PATH_LENGTH ) {
-      return FALSE;
+      return 0;
     }
 
     if (PcdGet32 (PcdMaximumDevicePathNodeCount) > 0) {
       Count++;
       if (Count >= PcdGet32 (PcdMaximumDevicePathNodeCount)) {
-        return FALSE;
+        return 0;
       }
     }
 
@@ -98,14 +95,44 @@ IsDevicePathValid (
         (DevicePathSubType (DevicePath) == MEDIA_FILEPATH_DP) &&
         (*(CHAR16 *)((UINT8 *)DevicePath + NodeLength - 2) != 0))
     {
-      return FALSE;
+      return 0;
     }
   }
 
   //
-  // Only return TRUE when the End Device Path node is valid.
+  // Only return the size when the End Device Path node is valid.
   //
-  return (BOOLEAN)(DevicePathNodeLength (DevicePath) == END_DEVICE_PATH_LENGTH);
+  if (DevicePathNodeLength (DevicePath) != END_DEVICE_PATH_LENGTH) {
+    return 0;
+  }
+
+  return Size + END_DEVICE_PATH_LENGTH;
+}
+
+/**
+  Determine whether a given device path is valid.
+
+  @param  DevicePath  A pointer to a device path data structure.
+  @param  MaxSize     The maximum size of the device path data structure.
+
+  @retval TRUE        DevicePath is valid.
+  @retval FALSE       DevicePath is NULL.
+  @retval FALSE       Maxsize is less than sizeof(EFI_DEVICE_PATH_PROTOCOL).
+  @retval FALSE       The length of any node node in the DevicePath is less
+                      than sizeof (EFI_DEVICE_PATH_PROTOCOL).
+  @retval FALSE       If MaxSize is not zero, the size of the DevicePath
+                      exceeds MaxSize.
+  @retval FALSE       If PcdMaximumDevicePathNodeCount is not zero, the node
+                      count of the DevicePath exceeds PcdMaximumDevicePathNodeCount.
+**/
+BOOLEAN
+EFIAPI
+IsDevicePathValid (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  IN       UINTN                     MaxSize
+  )
+{
+  return (BOOLEAN)(UefiDevicePathLibGetValidDevicePathSize (DevicePath, MaxSize) != 0);
 }
 
 /**
@@ -360,28 +387,7 @@ UefiDevicePathLibGetDevicePathSize (
   IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath
   )
 {
-  CONST EFI_DEVICE_PATH_PROTOCOL  *Start;
-
-  if (DevicePath == NULL) {
-    return 0;
-  }
-
-  if (!IsDevicePathValid (DevicePath, 0)) {
-    return 0;
-  }
-
-  //
-  // Search for the end of the device path structure
-  //
-  Start = DevicePath;
-  while (!IsDevicePathEnd (DevicePath)) {
-    DevicePath = NextDevicePathNode (DevicePath);
-  }
-
-  //
-  // Compute the size and add back in the size of the end device path structure
-  //
-  return ((UINTN)DevicePath - (UINTN)Start) + DevicePathNodeLength (DevicePath);
+  return UefiDevicePathLibGetValidDevicePathSize (DevicePath, 0);
 }
 
 /**
@@ -471,7 +477,9 @@ UefiDevicePathLibAppendDevicePath (
     return DuplicateDevicePath (FirstDevicePath);
   }
 
-  if (!IsDevicePathValid (FirstDevicePath, 0) || !IsDevicePathValid (SecondDevicePath, 0)) {
+  Size1 = UefiDevicePathLibGetValidDevicePathSize (FirstDevicePath, 0);
+  Size2 = UefiDevicePathLibGetValidDevicePathSize (SecondDevicePath, 0);
+  if ((Size1 == 0) || (Size2 == 0)) {
     return NULL;
   }
 
@@ -479,9 +487,7 @@ UefiDevicePathLibAppendDevicePath (
   // Allocate space for the combined device path. It only has one end node of
   // length EFI_DEVICE_PATH_PROTOCOL.
   //
-  Size1 = GetDevicePathSize (FirstDevicePath);
-  Size2 = GetDevicePathSize (SecondDevicePath);
-  Size  = Size1 + Size2 - END_DEVICE_PATH_LENGTH;
+  Size = Size1 + Size2 - END_DEVICE_PATH_LENGTH;
 
   NewDevicePath = AllocatePool (Size);
 
@@ -611,21 +617,20 @@ UefiDevicePathLibAppendDevicePathInstance (
     return NULL;
   }
 
-  if (!IsDevicePathValid (DevicePath, 0) || !IsDevicePathValid (DevicePathInstance, 0)) {
+  SrcSize      = UefiDevicePathLibGetValidDevicePathSize (DevicePath, 0);
+  InstanceSize = UefiDevicePathLibGetValidDevicePathSize (DevicePathInstance, 0);
+  if ((SrcSize == 0) || (InstanceSize == 0)) {
     return NULL;
   }
 
-  SrcSize      = GetDevicePathSize (DevicePath);
-  InstanceSize = GetDevicePathSize (DevicePathInstance);
-
   NewDevicePath = AllocatePool (SrcSize + InstanceSize);
   if (NewDevicePath != NULL) {
-    TempDevicePath = CopyMem (NewDevicePath, DevicePath, SrcSize);
-
-    while (!IsDevicePathEnd (TempDevicePath)) {
-      TempDevicePath = NextDevicePathNode (TempDevicePath);
-    }
+    CopyMem (NewDevicePath, DevicePath, SrcSize);
 
+    //
+    // The end node of a valid device path is its last END_DEVICE_PATH_LENGTH bytes.
+    //
+    TempDevicePath          = (EFI_DEVICE_PATH_PROTOCOL *)((UINT8 *)NewDevicePath + SrcSize - END_DEVICE_PATH_LENGTH);
     TempDevicePath->SubType = END_INSTANCE_DEVICE_PATH_SUBTYPE;
     TempDevicePath          = NextDevicePathNode (TempDevicePath);
     CopyMem (TempDevicePath, DevicePathInstance, InstanceSize);
@@ -0,0 +1,137 @@
+/** @file
+  Device path hashing and comparison. These services only walk the nodes of a
+  device path, so they are shared by every instance of the Device Path Library.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+
+#include <Library/DevicePathLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+
+/**
+  Folds one device path node into a device path hash.
+
+  The hash is 32-bit FNV-1a over the bytes of the node, including its header.
+  Starting from DEVICE_PATH_HASH_SEED and folding the nodes of a device path
+  one after the other gives the same value as GetDevicePathHash(), so the
+  hash of every prefix of a device path can be computed in a single walk.
+
+  If Node is NULL, then ASSERT().
+
+  @param  Hash                       The hash of the nodes that precede Node.
+  @param  Node                       A pointer to a device path node data structure.
+
+  @return The hash of the nodes that precede Node, followed by Node.
+
+**/
+UINT32
+EFIAPI
+HashDevicePathNode (
+  IN UINT32      Hash,
+  IN CONST VOID  *Node
+  )
+{
+  CONST UINT8  *Byte;
+  UINTN        Length;
+
+  ASSERT (Node != NULL);
+
+  Byte = Node;
+  for (Length = DevicePathNodeLength (Node); Length > 0; Length--) {
+    Hash = (Hash ^ *Byte++) * 0x01000193;
+  }
+
+  return Hash;
+}
+
+/**
+  Returns the hash of a device path.
+
+  Every node before the end-of-device-path node is hashed, including the
+  end-of-instance nodes of a multi-instance device path. Two device paths that
+  CompareDevicePath() reports as equal have the same hash.
+
+  @param  DevicePath                 A pointer to a device path data structure.
+
+  @return The hash of DevicePath, or DEVICE_PATH_HASH_SEED if DevicePath is NULL.
+
+**/
+UINT32
+EFIAPI
+GetDevicePathHash (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath
+  )
+{
+  UINT32  Hash;
+
+  Hash = DEVICE_PATH_HASH_SEED;
+  if (DevicePath == NULL) {
+    return Hash;
+  }
+
+  while (!IsDevicePathEnd (DevicePath)) {
+    //
+    // Stop on a malformed node rather than loop forever.
+    //
+    if (DevicePathNodeLength (DevicePath) < sizeof (EFI_DEVICE_PATH_PROTOCOL)) {
+      break;
+    }
+
+    Hash       = HashDevicePathNode (Hash, DevicePath);
+    DevicePath = NextDevicePathNode (DevicePath);
+  }
+
+  return Hash;
+}
+
+/**
+  Determines if two device paths are identical.
+
+  The device paths are compared node by node, so that the comparison stops at
+  the first node that differs without computing the size of either path.
+
+  @param  DevicePath1                A pointer to a device path data structure.
+  @param  DevicePath2                A pointer to a device path data structure.
+
+  @retval TRUE                       Every node of DevicePath1 matches the node of
+                                     DevicePath2 at the same position, or both are NULL.
+  @retval FALSE                      The device paths differ, or only one of them is NULL.
+
+**/
+BOOLEAN
+EFIAPI
+CompareDevicePath (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath1,
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath2
+  )
+{
+  UINTN  NodeLength;
+
+  if ((DevicePath1 == NULL) || (DevicePath2 == NULL)) {
+    return (BOOLEAN)(DevicePath1 == DevicePath2);
+  }
+
+  while (DevicePath1 != DevicePath2) {
+    NodeLength = DevicePathNodeLength (DevicePath1);
+    if ((NodeLength < sizeof (EFI_DEVICE_PATH_PROTOCOL)) ||
+        (NodeLength != DevicePathNodeLength (DevicePath2)) ||
+        (CompareMem (DevicePath1, DevicePath2, NodeLength) != 0))
+    {
+      return FALSE;
+    }
+
+    if (IsDevicePathEnd (DevicePath1)) {
+      return TRUE;
+    }
+
+    DevicePath1 = NextDevicePathNode (DevicePath1);
+    DevicePath2 = NextDevicePathNode (DevicePath2);
+  }
+
+  return TRUE;
+}
@@ -164,6 +164,26 @@ UefiDevicePathLibGetDevicePathSize (
   IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath
   );
 
+/**
+  Validate a device path and return its size.
+
+  The device path is validated and measured in the same walk, so that callers
+  that need both do not walk the device path twice.
+
+  @param  DevicePath  A pointer to a device path data structure.
+  @param  MaxSize     The maximum size of the device path data structure, or 0
+                      for no limit.
+
+  @retval 0           DevicePath is invalid. See IsDevicePathValid() for the
+                      conditions checked.
+  @retval Others      The size of DevicePath in bytes, including the end node.
+**/
+UINTN
+UefiDevicePathLibGetValidDevicePathSize (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath,
+  IN       UINTN                     MaxSize
+  );
+
 /**
   Creates a new copy of an existing device path.
 
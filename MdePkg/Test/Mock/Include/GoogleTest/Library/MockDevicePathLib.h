@@ -133,6 +133,26 @@ struct MockDevicePathLib {
     (IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath)
     );
 
+  MOCK_FUNCTION_DECLARATION (
+    UINT32,
+    HashDevicePathNode,
+    (IN UINT32      Hash,
+     IN CONST VOID  *Node)
+    );
+
+  MOCK_FUNCTION_DECLARATION (
+    UINT32,
+    GetDevicePathHash,
+    (IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath)
+    );
+
+  MOCK_FUNCTION_DECLARATION (
+    BOOLEAN,
+    CompareDevicePath,
+    (IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath1,
+     IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath2)
+    );
+
   MOCK_FUNCTION_DECLARATION (
     EFI_DEVICE_PATH_PROTOCOL *,
     DevicePathFromHandle,
@@ -27,6 +27,9 @@ MOCK_FUNCTION_DEFINITION (MockDevicePathLib, AppendDevicePathInstance, 2, EFIAPI
 MOCK_FUNCTION_DEFINITION (MockDevicePathLib, GetNextDevicePathInstance, 2, EFIAPI);
 MOCK_FUNCTION_DEFINITION (MockDevicePathLib, CreateDeviceNode, 3, EFIAPI);
 MOCK_FUNCTION_DEFINITION (MockDevicePathLib, IsDevicePathMultiInstance, 1, EFIAPI);
+MOCK_FUNCTION_DEFINITION (MockDevicePathLib, HashDevicePathNode, 2, EFIAPI);
+MOCK_FUNCTION_DEFINITION (MockDevicePathLib, GetDevicePathHash, 1, EFIAPI);
+MOCK_FUNCTION_DEFINITION (MockDevicePathLib, CompareDevicePath, 2, EFIAPI);
 MOCK_FUNCTION_DEFINITION (MockDevicePathLib, DevicePathFromHandle, 1, EFIAPI);
 MOCK_FUNCTION_DEFINITION (MockDevicePathLib, FileDevicePath, 2, EFIAPI);
 MOCK_FUNCTION_DEFINITION (MockDevicePathLib, ConvertDevicePathToText, 3, EFIAPI);
@@ -0,0 +1,460 @@
+/** @file
+  Correctness check and throughput benchmark of CalculateSum8/16/32(),
+  CalculateCheckSum8() and IsZeroBuffer().
+
+  Every function is first compared with a straightforward element by element
+  loop for all buffer alignments and for lengths around the block sizes used
+  by the vectorized implementations. The throughput of the library function
+  and of the reference loop is then reported for buffers from 4 KB to 16 MB.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <time.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME     "Checksum and IsZeroBuffer Benchmark"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define MIN_BENCHMARK_SIZE  SIZE_4KB
+#define MAX_BENCHMARK_SIZE  SIZE_16MB
+
+//
+// Each size is processed until at least this many bytes went through the
+// function, so that small buffers are timed over enough calls.
+//
+#define BYTES_PER_MEASUREMENT  SIZE_64MB
+
+//
+// Lengths up to this value are checked exhaustively against the reference.
+//
+#define MAX_CHECKED_LENGTH  300
+
+typedef enum {
+  BenchmarkSum8,
+  BenchmarkSum16,
+  BenchmarkSum32,
+  BenchmarkIsZeroBuffer,
+  BenchmarkMax
+} BENCHMARK_FUNCTION;
+
+STATIC CONST CHAR8  *mFunctionName[BenchmarkMax] = {
+  "CalculateSum8",
+  "CalculateSum16",
+  "CalculateSum32",
+  "IsZeroBuffer"
+};
+
+//
+// Defeats dead code elimination of the benchmark loops.
+//
+volatile UINTN  mSink;
+
+/**
+  Return a time stamp in nanoseconds.
+
+  timespec_get() is used as it is available with every host toolchain.
+
+  @return The time stamp.
+
+**/
+STATIC
+UINT64
+GetTimeInNanoSecond (
+  VOID
+  )
+{
+  struct timespec  Now;
+
+  timespec_get (&Now, TIME_UTC);
+  return (UINT64)Now.tv_sec * 1000000000ULL + (UINT64)Now.tv_nsec;
+}
+
+/**
+  Sum of a buffer of 8-bit values, one element at a time.
+
+  @param  Buffer  The buffer.
+  @param  Length  The size of Buffer in bytes.
+
+  @return The sum with carry bits dropped.
+
+**/
+STATIC
+UINT8
+ReferenceSum8 (
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  )
+{
+  UINT8  Sum;
+  UINTN  Index;
+
+  for (Sum = 0, Index = 0; Index < Length; Index++) {
+    Sum = (UINT8)(Sum + Buffer[Index]);
+  }
+
+  return Sum;
+}
+
+/**
+  Sum of a buffer of 16-bit values, one element at a time.
+
+  @param  Buffer  The buffer.
+  @param  Length  The size of Buffer in bytes.
+
+  @return The sum with carry bits dropped.
+
+**/
+STATIC
+UINT16
+ReferenceSum16 (
+  IN CONST UINT16  *Buffer,
+  IN UINTN         Length
+  )
+{
+  UINT16  Sum;
+  UINTN   Index;
+
+  for (Sum = 0, Index = 0; Index < Length / sizeof (UINT16); Index++) {
+    Sum = (UINT16)(Sum + Buffer[Index]);
+  }
+
+  return Sum;
+}
+
+/**
+  Sum of a buffer of 32-bit values, one element at a time.
+
+  @param  Buffer  The buffer.
+  @param  Length  The size of Buffer in bytes.
+
+  @return The sum with carry bits dropped.
+
+**/
+STATIC
+UINT32
+ReferenceSum32 (
+  IN CONST UINT32  *Buffer,
+  IN UINTN         Length
+  )
+{
+  UINT32  Sum;
+  UINTN   Index;
+
+  for (Sum = 0, Index = 0; Index < Length / sizeof (UINT32); Index++) {
+    Sum = Sum + Buffer[Index];
+  }
+
+  return Sum;
+}
+
+/**
+  Check a buffer for zeros, one byte at a time.
+
+  @param  Buffer  The buffer.
+  @param  Length  The size of Buffer in bytes.
+
+  @retval TRUE   Every byte of Buffer is zero.
+  @retval FALSE  Buffer has a non-zero byte.
+
+**/
+STATIC
+BOOLEAN
+ReferenceIsZeroBuffer (
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Length; Index++) {
+    if (Buffer[Index] != 0) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Run one function over a buffer.
+
+  @param  Function   The function to run.
+  @param  Reference  TRUE to run the reference loop instead of the library.
+  @param  Buffer     The buffer.
+  @param  Length     The size of Buffer in bytes.
+
+  @return The result of the function, widened to UINTN.
+
+**/
+STATIC
+UINTN
+RunFunction (
+  IN BENCHMARK_FUNCTION  Function,
+  IN BOOLEAN             Reference,
+  IN CONST UINT8         *Buffer,
+  IN UINTN               Length
+  )
+{
+  switch (Function) {
+    case BenchmarkSum8:
+      return Reference ? ReferenceSum8 (Buffer, Length) : CalculateSum8 (Buffer, Length);
+    case BenchmarkSum16:
+      return Reference ? ReferenceSum16 ((CONST UINT16 *)Buffer, Length) : CalculateSum16 ((CONST UINT16 *)Buffer, Length);
+    case BenchmarkSum32:
+      return Reference ? ReferenceSum32 ((CONST UINT32 *)Buffer, Length) : CalculateSum32 ((CONST UINT32 *)Buffer, Length);
+    case BenchmarkIsZeroBuffer:
+      return Reference ? ReferenceIsZeroBuffer (Buffer, Length) : IsZeroBuffer (Buffer, Length);
+    default:
+      return 0;
+  }
+}
+
+/**
+  Check CalculateSum8/16/32() and CalculateCheckSum8() against the reference
+  loops for every alignment the functions accept and all short lengths.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SumMatchesReference (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8  *Buffer;
+  UINTN  Offset;
+  UINTN  Length;
+  UINTN  Index;
+
+  Buffer = AllocatePool (64 + MAX_CHECKED_LENGTH);
+  UT_ASSERT_NOT_NULL (Buffer);
+  for (Index = 0; Index < 64 + MAX_CHECKED_LENGTH; Index++) {
+    Buffer[Index] = (UINT8)(Index * 167 + 13);
+  }
+
+  for (Offset = 0; Offset < 64; Offset++) {
+    for (Length = 0; Length <= MAX_CHECKED_LENGTH; Length++) {
+      UT_ASSERT_EQUAL (CalculateSum8 (Buffer + Offset, Length), ReferenceSum8 (Buffer + Offset, Length));
+      UT_ASSERT_EQUAL (CalculateCheckSum8 (Buffer + Offset, Length), (UINT8)(0x100 - ReferenceSum8 (Buffer + Offset, Length)));
+      if (((Offset & 0x1) == 0) && ((Length & 0x1) == 0)) {
+        UT_ASSERT_EQUAL (
+          CalculateSum16 ((UINT16 *)(Buffer + Offset), Length),
+          ReferenceSum16 ((UINT16 *)(Buffer + Offset), Length)
+          );
+      }
+
+      if (((Offset & 0x3) == 0) && ((Length & 0x3) == 0)) {
+        UT_ASSERT_EQUAL (
+          CalculateSum32 ((UINT32 *)(Buffer + Offset), Length),
+          ReferenceSum32 ((UINT32 *)(Buffer + Offset), Length)
+          );
+      }
+    }
+  }
+
+  FreePool (Buffer);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check IsZeroBuffer() for every alignment, all short lengths and a non-zero
+  byte at every position, including just past the end of the buffer.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IsZeroBufferMatchesReference (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8  *Buffer;
+  UINTN  Offset;
+  UINTN  Length;
+  UINTN  Position;
+
+  Buffer = AllocateZeroPool (64 + MAX_CHECKED_LENGTH + 1);
+  UT_ASSERT_NOT_NULL (Buffer);
+
+  for (Offset = 0; Offset < 64; Offset++) {
+    for (Length = 1; Length <= MAX_CHECKED_LENGTH; Length++) {
+      UT_ASSERT_TRUE (IsZeroBuffer (Buffer + Offset, Length));
+      for (Position = 0; Position < Length; Position++) {
+        Buffer[Offset + Position] = 0x80;
+        UT_ASSERT_FALSE (IsZeroBuffer (Buffer + Offset, Length));
+        Buffer[Offset + Position] = 0;
+      }
+
+      Buffer[Offset + Length] = 1;
+      UT_ASSERT_TRUE (IsZeroBuffer (Buffer + Offset, Length));
+      Buffer[Offset + Length] = 0;
+    }
+  }
+
+  FreePool (Buffer);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Report the throughput of one function and of its reference loop for
+  buffers from MIN_BENCHMARK_SIZE to MAX_BENCHMARK_SIZE.
+
+  @param[in]  Context  The BENCHMARK_FUNCTION to run, cast to a pointer.
+
+  @retval  UNIT_TEST_PASSED             The library and the reference agreed.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+Throughput (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  BENCHMARK_FUNCTION  Function;
+  UINT8               *Buffer;
+  UINTN               Size;
+  UINTN               Index;
+  UINTN               Calls;
+  UINTN               Pass;
+  UINT64              Start;
+  UINT64              Elapsed[2];
+
+  Function = (BENCHMARK_FUNCTION)(UINTN)Context;
+
+  //
+  // Page aligned, as tables and flash regions usually are. IsZeroBuffer()
+  // is measured on an all-zero buffer, which is the case that reads it all.
+  //
+  Buffer = AllocatePages (EFI_SIZE_TO_PAGES (MAX_BENCHMARK_SIZE));
+  UT_ASSERT_NOT_NULL (Buffer);
+  for (Index = 0; Index < MAX_BENCHMARK_SIZE; Index++) {
+    Buffer[Index] = (Function == BenchmarkIsZeroBuffer) ? 0 : (UINT8)(Index * 167 + 13);
+  }
+
+  for (Size = MIN_BENCHMARK_SIZE; Size <= MAX_BENCHMARK_SIZE; Size *= 4) {
+    UT_ASSERT_EQUAL (RunFunction (Function, FALSE, Buffer, Size), RunFunction (Function, TRUE, Buffer, Size));
+
+    Calls = BYTES_PER_MEASUREMENT / Size;
+    for (Pass = 0; Pass < 2; Pass++) {
+      Start = GetTimeInNanoSecond ();
+      for (Index = 0; Index < Calls; Index++) {
+        mSink += RunFunction (Function, (BOOLEAN)(Pass == 1), Buffer, Size);
+      }
+
+      Elapsed[Pass] = MAX (GetTimeInNanoSecond () - Start, 1);
+    }
+
+    DEBUG ((
+      DEBUG_INFO,
+      "%a: %8d KB, %6d MB/s, reference loop %6d MB/s\n",
+      mFunctionName[Function],
+      (INT32)(Size / SIZE_1KB),
+      (INT32)DivU64x64Remainder (MultU64x32 (BYTES_PER_MEASUREMENT, 1000), Elapsed[0], NULL),
+      (INT32)DivU64x64Remainder (MultU64x32 (BYTES_PER_MEASUREMENT, 1000), Elapsed[1], NULL)
+      ));
+  }
+
+  FreePages (Buffer, EFI_SIZE_TO_PAGES (MAX_BENCHMARK_SIZE));
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the checksum
+  and IsZeroBuffer() functions and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      ChecksumTests;
+  BENCHMARK_FUNCTION          Function;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Framework = NULL;
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&ChecksumTests, Framework, "Checksum Tests", "BaseLib.Checksum", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the Checksum Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (ChecksumTests, "Sums match the reference loops", "SumMatchesReference", SumMatchesReference, NULL, NULL, NULL);
+  AddTestCase (ChecksumTests, "IsZeroBuffer matches the reference loop", "IsZeroBufferMatchesReference", IsZeroBufferMatchesReference, NULL, NULL, NULL);
+  for (Function = 0; Function < BenchmarkMax; Function++) {
+    AddTestCase (ChecksumTests, "Throughput", (CHAR8 *)mFunctionName[Function], Throughput, NULL, NULL, (UNIT_TEST_CONTEXT)(UINTN)Function);
+  }
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define ChecksumBenchmarkMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+ChecksumBenchmarkMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
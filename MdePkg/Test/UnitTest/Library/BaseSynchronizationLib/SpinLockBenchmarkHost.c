@@ -0,0 +1,378 @@
+/** @file
+  Multi-threaded correctness and contention benchmark of the spin locks in
+  BaseSynchronizationLib.
+
+  Every lock flavor protects a counter that is not updated atomically. All
+  threads hammer the same lock, and the final counter value proves mutual
+  exclusion. The time per acquire/release pair is reported for each flavor
+  and thread count.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME     "BaseSynchronizationLib Spin Lock Benchmark"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+#define MAX_BENCHMARK_THREADS  64
+#define ITERATIONS_PER_THREAD  100000
+
+//
+// Readers in the reader-writer benchmark take the lock this many times for
+// each exclusive acquisition.
+//
+#define READS_PER_WRITE  8
+
+typedef enum {
+  LockFlavorTestAndSet,
+  LockFlavorTicket,
+  LockFlavorMcs,
+  LockFlavorReaderWriter,
+  LockFlavorMax
+} LOCK_FLAVOR;
+
+typedef struct {
+  LOCK_FLAVOR         Flavor;
+  UINTN               ThreadCount;
+  SPIN_LOCK           SpinLock;
+  TICKET_SPIN_LOCK    TicketLock;
+  MCS_SPIN_LOCK       McsLock;
+  RW_SPIN_LOCK        RwLock;
+  volatile UINT32     StartGate;
+  volatile UINT64     Counter;
+  volatile UINT64     ReadSum;
+} LOCK_BENCHMARK_CONTEXT;
+
+STATIC CONST CHAR8  *mFlavorName[LockFlavorMax] = {
+  "test-and-set",
+  "ticket",
+  "mcs",
+  "reader-writer"
+};
+
+/**
+  Return a monotonic time stamp in nanoseconds.
+
+  @return The time stamp.
+
+**/
+STATIC
+UINT64
+GetTimeInNanoSecond (
+  VOID
+  )
+{
+  struct timespec  Now;
+
+  clock_gettime (CLOCK_MONOTONIC, &Now);
+  return (UINT64)Now.tv_sec * 1000000000ULL + (UINT64)Now.tv_nsec;
+}
+
+/**
+  Non-atomic read-modify-write of the shared counter. Lost updates show up
+  as a wrong final value if the lock does not provide mutual exclusion.
+
+  @param  Context  The benchmark context.
+
+**/
+STATIC
+VOID
+CriticalSection (
+  IN LOCK_BENCHMARK_CONTEXT  *Context
+  )
+{
+  UINT64  Value;
+
+  Value            = Context->Counter;
+  Context->Counter = Value + 1;
+}
+
+/**
+  Body of one benchmark thread.
+
+  @param  Argument  The LOCK_BENCHMARK_CONTEXT shared by all threads.
+
+  @return NULL.
+
+**/
+STATIC
+VOID *
+BenchmarkThread (
+  IN VOID  *Argument
+  )
+{
+  LOCK_BENCHMARK_CONTEXT  *Context;
+  MCS_SPIN_LOCK_NODE      Node;
+  UINTN                   Index;
+  UINTN                   Read;
+
+  Context = (LOCK_BENCHMARK_CONTEXT *)Argument;
+
+  //
+  // Start all threads together so that they contend from the first iteration.
+  //
+  InterlockedIncrement (&Context->StartGate);
+  while (Context->StartGate < Context->ThreadCount) {
+    CpuPause ();
+  }
+
+  for (Index = 0; Index < ITERATIONS_PER_THREAD; Index++) {
+    switch (Context->Flavor) {
+      case LockFlavorTestAndSet:
+        AcquireSpinLock (&Context->SpinLock);
+        CriticalSection (Context);
+        ReleaseSpinLock (&Context->SpinLock);
+        break;
+
+      case LockFlavorTicket:
+        AcquireTicketSpinLock (&Context->TicketLock);
+        CriticalSection (Context);
+        ReleaseTicketSpinLock (&Context->TicketLock);
+        break;
+
+      case LockFlavorMcs:
+        AcquireMcsSpinLock (&Context->McsLock, &Node);
+        CriticalSection (Context);
+        ReleaseMcsSpinLock (&Context->McsLock, &Node);
+        break;
+
+      case LockFlavorReaderWriter:
+        for (Read = 0; Read < READS_PER_WRITE; Read++) {
+          AcquireRwSpinLockShared (&Context->RwLock);
+          Context->ReadSum += 0;
+          ReleaseRwSpinLockShared (&Context->RwLock);
+        }
+
+        AcquireRwSpinLockExclusive (&Context->RwLock);
+        CriticalSection (Context);
+        ReleaseRwSpinLockExclusive (&Context->RwLock);
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Run one lock flavor with 1, 2, 4, ... threads up to the number of online
+  processors, check the counter and report the cost of a lock round trip.
+
+  @param[in]  Context  The LOCK_FLAVOR to run, cast to a pointer.
+
+  @retval  UNIT_TEST_PASSED             All runs preserved mutual exclusion.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+LockContention (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC LOCK_BENCHMARK_CONTEXT  Benchmark;
+  pthread_t                      Threads[MAX_BENCHMARK_THREADS];
+  UINTN                          MaxThreads;
+  UINTN                          ThreadCount;
+  UINTN                          NextThreadCount;
+  UINTN                          Index;
+  UINT64                         Start;
+  UINT64                         Elapsed;
+  long                           Online;
+
+  //
+  // Spinning waiters only make progress with a processor each, so never run
+  // more threads than there are online processors.
+  //
+  Online     = sysconf (_SC_NPROCESSORS_ONLN);
+  MaxThreads = (Online < 1) ? 1 : MIN ((UINTN)Online, MAX_BENCHMARK_THREADS);
+
+  for (ThreadCount = 1; ThreadCount <= MaxThreads; ThreadCount = NextThreadCount) {
+    ZeroMem ((VOID *)&Benchmark, sizeof (Benchmark));
+    Benchmark.Flavor      = (LOCK_FLAVOR)(UINTN)Context;
+    Benchmark.ThreadCount = ThreadCount;
+    InitializeSpinLock (&Benchmark.SpinLock);
+    InitializeTicketSpinLock (&Benchmark.TicketLock);
+    InitializeMcsSpinLock (&Benchmark.McsLock);
+    InitializeRwSpinLock (&Benchmark.RwLock);
+
+    Start = GetTimeInNanoSecond ();
+    for (Index = 0; Index < ThreadCount; Index++) {
+      UT_ASSERT_EQUAL (pthread_create (&Threads[Index], NULL, BenchmarkThread, &Benchmark), 0);
+    }
+
+    for (Index = 0; Index < ThreadCount; Index++) {
+      pthread_join (Threads[Index], NULL);
+    }
+
+    Elapsed = GetTimeInNanoSecond () - Start;
+
+    UT_ASSERT_EQUAL (Benchmark.Counter, (UINT64)ThreadCount * ITERATIONS_PER_THREAD);
+    DEBUG ((
+      DEBUG_INFO,
+      "%a: %d threads, %d ns per lock round trip\n",
+      mFlavorName[Benchmark.Flavor],
+      (INT32)ThreadCount,
+      (INT32)DivU64x64Remainder (Elapsed, Benchmark.Counter, NULL)
+      ));
+
+    //
+    // Always finish with a run on every online processor.
+    //
+    NextThreadCount = ThreadCount * 2;
+    if ((ThreadCount < MaxThreads) && (NextThreadCount > MaxThreads)) {
+      NextThreadCount = MaxThreads;
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check the non-blocking acquire paths of every lock flavor.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TryAcquire (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TICKET_SPIN_LOCK    TicketLock;
+  MCS_SPIN_LOCK       McsLock;
+  MCS_SPIN_LOCK_NODE  Node;
+  MCS_SPIN_LOCK_NODE  OtherNode;
+  RW_SPIN_LOCK        RwLock;
+
+  InitializeTicketSpinLock (&TicketLock);
+  UT_ASSERT_TRUE (AcquireTicketSpinLockOrFail (&TicketLock));
+  UT_ASSERT_FALSE (AcquireTicketSpinLockOrFail (&TicketLock));
+  ReleaseTicketSpinLock (&TicketLock);
+  AcquireTicketSpinLock (&TicketLock);
+  ReleaseTicketSpinLock (&TicketLock);
+  UT_ASSERT_TRUE (AcquireTicketSpinLockOrFail (&TicketLock));
+  ReleaseTicketSpinLock (&TicketLock);
+
+  InitializeMcsSpinLock (&McsLock);
+  UT_ASSERT_TRUE (AcquireMcsSpinLockOrFail (&McsLock, &Node));
+  UT_ASSERT_FALSE (AcquireMcsSpinLockOrFail (&McsLock, &OtherNode));
+  ReleaseMcsSpinLock (&McsLock, &Node);
+  UT_ASSERT_TRUE (McsLock.Tail == NULL);
+  AcquireMcsSpinLock (&McsLock, &OtherNode);
+  ReleaseMcsSpinLock (&McsLock, &OtherNode);
+  UT_ASSERT_TRUE (McsLock.Tail == NULL);
+
+  InitializeRwSpinLock (&RwLock);
+  UT_ASSERT_TRUE (AcquireRwSpinLockSharedOrFail (&RwLock));
+  UT_ASSERT_TRUE (AcquireRwSpinLockSharedOrFail (&RwLock));
+  UT_ASSERT_FALSE (AcquireRwSpinLockExclusiveOrFail (&RwLock));
+  ReleaseRwSpinLockShared (&RwLock);
+  ReleaseRwSpinLockShared (&RwLock);
+  UT_ASSERT_TRUE (AcquireRwSpinLockExclusiveOrFail (&RwLock));
+  UT_ASSERT_FALSE (AcquireRwSpinLockSharedOrFail (&RwLock));
+  UT_ASSERT_FALSE (AcquireRwSpinLockExclusiveOrFail (&RwLock));
+  ReleaseRwSpinLockExclusive (&RwLock);
+  UT_ASSERT_EQUAL (RwLock.State, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the spin
+  locks and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      SpinLockTests;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Framework = NULL;
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&SpinLockTests, Framework, "Spin Lock Tests", "SynchronizationLib.SpinLock", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the Spin Lock Tests\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  AddTestCase (SpinLockTests, "Non-blocking acquire", "TryAcquire", TryAcquire, NULL, NULL, NULL);
+  AddTestCase (SpinLockTests, "Test-and-set lock contention", "TestAndSet", LockContention, NULL, NULL, (UNIT_TEST_CONTEXT)(UINTN)LockFlavorTestAndSet);
+  AddTestCase (SpinLockTests, "Ticket lock contention", "Ticket", LockContention, NULL, NULL, (UNIT_TEST_CONTEXT)(UINTN)LockFlavorTicket);
+  AddTestCase (SpinLockTests, "MCS lock contention", "Mcs", LockContention, NULL, NULL, (UNIT_TEST_CONTEXT)(UINTN)LockFlavorMcs);
+  AddTestCase (SpinLockTests, "Reader-writer lock contention", "ReaderWriter", LockContention, NULL, NULL, (UNIT_TEST_CONTEXT)(UINTN)LockFlavorReaderWriter);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+///
+/// Avoid ECC error for function name that starts with lower case letter
+///
+#define SpinLockBenchmarkMain  main
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+
+  @param[in] Argc  Number of arguments
+  @param[in] Argv  Array of pointers to arguments
+
+  @retval 0      Success
+  @retval other  Error
+**/
+INT32
+SpinLockBenchmarkMain (
+  IN INT32  Argc,
+  IN CHAR8  *Argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
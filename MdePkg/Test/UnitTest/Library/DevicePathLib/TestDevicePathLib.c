@@ -356,6 +356,73 @@ TestGetDevicePathSize (
   return UNIT_TEST_PASSED;
 }
 
+UNIT_TEST_STATUS
+EFIAPI
+TestGetDevicePathHash (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32                     Hash;
+  EFI_DEVICE_PATH_PROTOCOL   *Node;
+  EFI_DEVICE_PATH_PROTOCOL   *Duplicate;
+  SIMPLE_TEST_SUITE_CONTEXT  *TestContext;
+
+  TestContext = (SIMPLE_TEST_SUITE_CONTEXT *)Context;
+
+  //
+  // Folding the nodes one by one gives the hash of the whole path
+  //
+  Hash = DEVICE_PATH_HASH_SEED;
+  for (Node = (EFI_DEVICE_PATH_PROTOCOL *)TestContext->ComplexDevicePath; !IsDevicePathEnd (Node); Node = NextDevicePathNode (Node)) {
+    Hash = HashDevicePathNode (Hash, Node);
+  }
+
+  UT_ASSERT_EQUAL (Hash, GetDevicePathHash ((EFI_DEVICE_PATH_PROTOCOL *)TestContext->ComplexDevicePath));
+
+  //
+  // Equal paths hash equal, different paths (very likely) do not
+  //
+  Duplicate = DuplicateDevicePath ((EFI_DEVICE_PATH_PROTOCOL *)TestContext->ComplexDevicePath);
+  UT_ASSERT_EQUAL (GetDevicePathHash (Duplicate), Hash);
+  UT_ASSERT_NOT_EQUAL (GetDevicePathHash ((EFI_DEVICE_PATH_PROTOCOL *)TestContext->SimpleDevicePath), Hash);
+  FreePool (Duplicate);
+
+  UT_ASSERT_EQUAL (GetDevicePathHash (NULL), DEVICE_PATH_HASH_SEED);
+
+  return UNIT_TEST_PASSED;
+}
+
+UNIT_TEST_STATUS
+EFIAPI
+TestCompareDevicePath (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_DEVICE_PATH_PROTOCOL   *Duplicate;
+  EFI_DEVICE_PATH_PROTOCOL   *Appended;
+  SIMPLE_TEST_SUITE_CONTEXT  *TestContext;
+
+  TestContext = (SIMPLE_TEST_SUITE_CONTEXT *)Context;
+
+  Duplicate = DuplicateDevicePath ((EFI_DEVICE_PATH_PROTOCOL *)TestContext->ComplexDevicePath);
+  UT_ASSERT_TRUE (CompareDevicePath (Duplicate, (EFI_DEVICE_PATH_PROTOCOL *)TestContext->ComplexDevicePath));
+  UT_ASSERT_FALSE (CompareDevicePath (Duplicate, (EFI_DEVICE_PATH_PROTOCOL *)TestContext->SimpleDevicePath));
+
+  //
+  // A path does not match a longer path that starts with it
+  //
+  Appended = AppendDevicePath (Duplicate, (EFI_DEVICE_PATH_PROTOCOL *)TestContext->SimpleDevicePath);
+  UT_ASSERT_FALSE (CompareDevicePath (Duplicate, Appended));
+  UT_ASSERT_FALSE (CompareDevicePath (Appended, Duplicate));
+  FreePool (Appended);
+  FreePool (Duplicate);
+
+  UT_ASSERT_TRUE (CompareDevicePath (NULL, NULL));
+  UT_ASSERT_FALSE (CompareDevicePath (NULL, (EFI_DEVICE_PATH_PROTOCOL *)TestContext->SimpleDevicePath));
+
+  return UNIT_TEST_PASSED;
+}
+
 UNIT_TEST_STATUS
 EFIAPI
 TestDuplicateDevicePath (
@@ -587,6 +654,8 @@ UefiTestMain (
   AddTestCase (DevicePathSimpleTestSuite, "Test IsDevicePathEnd", "TestIsDevicePathEnd", TestIsDevicePathEnd, NULL, NULL, &SimpleTestContext);
   AddTestCase (DevicePathSimpleTestSuite, "Test SetDevicePathNodeLength", "TestSetDevicePathNodeLength", TestSetDevicePathNodeLength, NULL, NULL, &SimpleTestContext);
   AddTestCase (DevicePathSimpleTestSuite, "Test GetDevicePathSize", "TestGetDevicePathSize", TestGetDevicePathSize, NULL, NULL, &SimpleTestContext);
+  AddTestCase (DevicePathSimpleTestSuite, "Test GetDevicePathHash", "TestGetDevicePathHash", TestGetDevicePathHash, NULL, NULL, &SimpleTestContext);
+  AddTestCase (DevicePathSimpleTestSuite, "Test CompareDevicePath", "TestCompareDevicePath", TestCompareDevicePath, NULL, NULL, &SimpleTestContext);
   AddTestCase (DevicePathSimpleTestSuite, "Test CreateDeviceNode", "TestCreateDeviceNode", TestCreateDeviceNode, NULL, NULL, &SimpleTestContext);
   AddTestCase (DevicePathSimpleTestSuite, "Test SetDevicePathEndNode", "TestSetDevicePathEndNode", TestSetDevicePathEndNode, NULL, NULL, &SimpleTestContext);
   AddTestCase (DevicePathAppendTestSuite, "Test DuplicateDevicePath", "TestDuplicateDevicePath", TestDuplicateDevicePath, NULL, NULL, &SimpleTestContext);
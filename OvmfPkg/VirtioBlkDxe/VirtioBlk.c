@@ -6,9 +6,10 @@
 
   - No attach/detach (ie. removable media).
 
-  - Although the non-blocking interfaces of EFI_BLOCK_IO2_PROTOCOL could be a
-    good match for multiple in-flight virtio-blk requests, we stick to
-    synchronous requests and EFI_BLOCK_IO_PROTOCOL for now.
+  - EFI_BLOCK_IO_PROTOCOL and EFI_BLOCK_IO2_PROTOCOL share the same request
+    queue (see VirtioBlkQueue.c). Multiple requests are kept in flight, also
+    for large synchronous transfers, and completion is detected by polling the
+    used ring.
 
   Copyright (C) 2012, Red Hat, Inc.
   Copyright (c) 2012 - 2018, Intel Corporation. All rights reserved.<BR>
@@ -177,331 +178,227 @@ VerifyReadWriteRequest (
 
 /**
 
-  Format a read / write / flush request as three consecutive virtio
-  descriptors, push them to the host, and poll for the response.
-
-  This is the main workhorse function. Two use cases are supported, read/write
-  and flush. The function may only be called after the request parameters have
-  been verified by
-  - specific checks in ReadBlocks() / WriteBlocks() / FlushBlocks(), and
-  - VerifyReadWriteRequest() (for read/write only).
-
-  Parameters handled commonly:
-
-    @param[in] Dev             The virtio-blk device the request is targeted
-                               at.
-
-  Flush request:
-
-    @param[in] Lba             Must be zero.
+  ReadBlocks() operation for virtio-blk.
 
-    @param[in] BufferSize      Must be zero.
+  See
+  - UEFI Spec 2.3.1 + Errata C, 12.8 EFI Block I/O Protocol, 12.8 EFI Block I/O
+    Protocol, EFI_BLOCK_IO_PROTOCOL.ReadBlocks().
+  - Driver Writer's Guide for UEFI 2.3.1 v1.01, 24.2.2. ReadBlocks() and
+    ReadBlocksEx() Implementation.
 
-    @param[in out] Buffer      Ignored by the function.
+  Parameter checks and conformant return values are implemented in
+  VerifyReadWriteRequest() and VirtioBlkQueueTask().
 
-    @param[in] RequestIsWrite  Must be TRUE.
+  A zero BufferSize doesn't seem to be prohibited, so do nothing in that case,
+  successfully.
 
-  Read/Write request:
+**/
+EFI_STATUS
+EFIAPI
+VirtioBlkReadBlocks (
+  IN  EFI_BLOCK_IO_PROTOCOL  *This,
+  IN  UINT32                 MediaId,
+  IN  EFI_LBA                Lba,
+  IN  UINTN                  BufferSize,
+  OUT VOID                   *Buffer
+  )
+{
+  VBLK_DEV    *Dev;
+  EFI_STATUS  Status;
 
-    @param[in] Lba             Logical Block Address: number of logical blocks
-                               to skip from the beginning of the device.
+  if (BufferSize == 0) {
+    return EFI_SUCCESS;
+  }
 
-    @param[in] BufferSize      Size of buffer to transfer, in bytes. The caller
-                               is responsible to ensure this parameter is
-                               positive.
+  Dev    = VIRTIO_BLK_FROM_BLOCK_IO (This);
+  Status = VerifyReadWriteRequest (
+             &Dev->BlockIoMedia,
+             Lba,
+             BufferSize,
+             FALSE               // RequestIsWrite
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
 
-    @param[in out] Buffer      The guest side area to read data from the device
-                               into, or write data to the device from.
+  return VirtioBlkQueueTask (
+           Dev,
+           VIRTIO_BLK_T_IN,
+           Lba,
+           BufferSize,
+           Buffer,
+           NULL        // Token
+           );
+}
 
-    @param[in] RequestIsWrite  TRUE iff data transfer goes from guest to
-                               device.
+/**
 
-  Return values are common to both use cases, and are appropriate to be
-  forwarded by the EFI_BLOCK_IO_PROTOCOL functions (ReadBlocks(),
-  WriteBlocks(), FlushBlocks()).
+  WriteBlocks() operation for virtio-blk.
 
+  See
+  - UEFI Spec 2.3.1 + Errata C, 12.8 EFI Block I/O Protocol, 12.8 EFI Block I/O
+    Protocol, EFI_BLOCK_IO_PROTOCOL.WriteBlocks().
+  - Driver Writer's Guide for UEFI 2.3.1 v1.01, 24.2.3 WriteBlocks() and
+    WriteBlockEx() Implementation.
 
-  @retval EFI_SUCCESS          Transfer complete.
+  Parameter checks and conformant return values are implemented in
+  VerifyReadWriteRequest() and VirtioBlkQueueTask().
 
-  @retval EFI_DEVICE_ERROR     Failed to notify host side via VirtIo write, or
-                               unable to parse host response, or host response
-                               is not VIRTIO_BLK_S_OK or failed to map Buffer
-                               for a bus master operation.
+  A zero BufferSize doesn't seem to be prohibited, so do nothing in that case,
+  successfully.
 
 **/
-STATIC
 EFI_STATUS
 EFIAPI
-SynchronousRequest (
-  IN              VBLK_DEV  *Dev,
-  IN              EFI_LBA   Lba,
-  IN              UINTN     BufferSize,
-  IN OUT volatile VOID      *Buffer,
-  IN              BOOLEAN   RequestIsWrite
+VirtioBlkWriteBlocks (
+  IN EFI_BLOCK_IO_PROTOCOL  *This,
+  IN UINT32                 MediaId,
+  IN EFI_LBA                Lba,
+  IN UINTN                  BufferSize,
+  IN VOID                   *Buffer
   )
 {
-  UINT32                   BlockSize;
-  volatile VIRTIO_BLK_REQ  *Request;
-  volatile UINT8           *HostStatus;
-  VOID                     *HostStatusBuffer;
-  DESC_INDICES             Indices;
-  VOID                     *RequestMapping;
-  VOID                     *StatusMapping;
-  VOID                     *BufferMapping;
-  EFI_PHYSICAL_ADDRESS     BufferDeviceAddress;
-  EFI_PHYSICAL_ADDRESS     HostStatusDeviceAddress;
-  EFI_PHYSICAL_ADDRESS     RequestDeviceAddress;
-  EFI_STATUS               Status;
-  EFI_STATUS               UnmapStatus;
-
-  BlockSize = Dev->BlockIoMedia.BlockSize;
-
-  //
-  // Set BufferMapping and BufferDeviceAddress to suppress incorrect
-  // compiler/analyzer warnings.
-  //
-  BufferMapping       = NULL;
-  BufferDeviceAddress = 0;
-
-  //
-  // ensured by VirtioBlkInit()
-  //
-  ASSERT (BlockSize > 0);
-  ASSERT (BlockSize % 512 == 0);
-
-  //
-  // ensured by contract above, plus VerifyReadWriteRequest()
-  //
-  ASSERT (BufferSize % BlockSize == 0);
-
-  Request = AllocateZeroPool (sizeof (*Request));
-  if (Request == NULL) {
-    return EFI_DEVICE_ERROR;
-  }
-
-  //
-  // Prepare virtio-blk request header, setting zero size for flush.
-  // IO Priority is homogeneously 0.
-  //
-  Request->Type = RequestIsWrite ?
-                  (BufferSize == 0 ? VIRTIO_BLK_T_FLUSH : VIRTIO_BLK_T_OUT) :
-                  VIRTIO_BLK_T_IN;
-  Request->IoPrio = 0;
-  Request->Sector = MultU64x32 (Lba, BlockSize / 512);
+  VBLK_DEV    *Dev;
+  EFI_STATUS  Status;
 
-  //
-  // Host status is bi-directional (we preset with a value and expect the
-  // device to update it). Allocate a host status buffer which can be mapped
-  // to access equally by both processor and the device.
-  //
-  Status = Dev->VirtIo->AllocateSharedPages (
-                          Dev->VirtIo,
-                          EFI_SIZE_TO_PAGES (sizeof *HostStatus),
-                          &HostStatusBuffer
-                          );
-  if (EFI_ERROR (Status)) {
-    Status = EFI_DEVICE_ERROR;
-    goto FreeBlkRequest;
+  if (BufferSize == 0) {
+    return EFI_SUCCESS;
   }
 
-  HostStatus = HostStatusBuffer;
-
-  //
-  // Map virtio-blk request header (must be done after request header is
-  // populated)
-  //
-  Status = VirtioMapAllBytesInSharedBuffer (
-             Dev->VirtIo,
-             VirtioOperationBusMasterRead,
-             (VOID *)Request,
-             sizeof (*Request),
-             &RequestDeviceAddress,
-             &RequestMapping
+  Dev    = VIRTIO_BLK_FROM_BLOCK_IO (This);
+  Status = VerifyReadWriteRequest (
+             &Dev->BlockIoMedia,
+             Lba,
+             BufferSize,
+             TRUE                // RequestIsWrite
              );
   if (EFI_ERROR (Status)) {
-    Status = EFI_DEVICE_ERROR;
-    goto FreeHostStatusBuffer;
-  }
-
-  //
-  // Map data buffer
-  //
-  if (BufferSize > 0) {
-    Status = VirtioMapAllBytesInSharedBuffer (
-               Dev->VirtIo,
-               (RequestIsWrite ?
-                VirtioOperationBusMasterRead :
-                VirtioOperationBusMasterWrite),
-               (VOID *)Buffer,
-               BufferSize,
-               &BufferDeviceAddress,
-               &BufferMapping
-               );
-    if (EFI_ERROR (Status)) {
-      Status = EFI_DEVICE_ERROR;
-      goto UnmapRequestBuffer;
-    }
+    return Status;
   }
 
-  //
-  // preset a host status for ourselves that we do not accept as success
-  //
-  *HostStatus = VIRTIO_BLK_S_IOERR;
+  return VirtioBlkQueueTask (
+           Dev,
+           VIRTIO_BLK_T_OUT,
+           Lba,
+           BufferSize,
+           Buffer,
+           NULL        // Token
+           );
+}
 
-  //
-  // Map the Status Buffer with VirtioOperationBusMasterCommonBuffer so that
-  // both processor and device can access it.
-  //
-  Status = VirtioMapAllBytesInSharedBuffer (
-             Dev->VirtIo,
-             VirtioOperationBusMasterCommonBuffer,
-             HostStatusBuffer,
-             sizeof *HostStatus,
-             &HostStatusDeviceAddress,
-             &StatusMapping
-             );
-  if (EFI_ERROR (Status)) {
-    Status = EFI_DEVICE_ERROR;
-    goto UnmapDataBuffer;
-  }
+/**
 
-  VirtioPrepare (&Dev->Ring, &Indices);
+  FlushBlocks() operation for virtio-blk.
 
-  //
-  // ensured by VirtioBlkInit() -- this predicate, in combination with the
-  // lock-step progress, ensures we don't have to track free descriptors.
-  //
-  ASSERT (Dev->Ring.QueueSize >= 3);
+  See
+  - UEFI Spec 2.3.1 + Errata C, 12.8 EFI Block I/O Protocol, 12.8 EFI Block I/O
+    Protocol, EFI_BLOCK_IO_PROTOCOL.FlushBlocks().
+  - Driver Writer's Guide for UEFI 2.3.1 v1.01, 24.2.4 FlushBlocks() and
+    FlushBlocksEx() Implementation.
 
-  //
-  // virtio-blk header in first desc
-  //
-  VirtioAppendDesc (
-    &Dev->Ring,
-    RequestDeviceAddress,
-    sizeof (*Request),
-    VRING_DESC_F_NEXT,
-    &Indices
-    );
+  If the underlying virtio-blk device doesn't support flushing (ie.
+  write-caching), then this function should not be called by higher layers,
+  according to EFI_BLOCK_IO_MEDIA characteristics set in VirtioBlkInit().
+  Should they do nonetheless, we do nothing, successfully.
 
-  //
-  // data buffer for read/write in second desc
-  //
-  if (BufferSize > 0) {
-    //
-    // From virtio-0.9.5, 2.3.2 Descriptor Table:
-    // "no descriptor chain may be more than 2^32 bytes long in total".
-    //
-    // The predicate is ensured by the call contract above (for flush), or
-    // VerifyReadWriteRequest() (for read/write). It also implies that
-    // converting BufferSize to UINT32 will not truncate it.
-    //
-    ASSERT (BufferSize <= SIZE_1GB);
-
-    //
-    // VRING_DESC_F_WRITE is interpreted from the host's point of view.
-    //
-    VirtioAppendDesc (
-      &Dev->Ring,
-      BufferDeviceAddress,
-      (UINT32)BufferSize,
-      VRING_DESC_F_NEXT | (RequestIsWrite ? 0 : VRING_DESC_F_WRITE),
-      &Indices
-      );
-  }
+**/
+EFI_STATUS
+EFIAPI
+VirtioBlkFlushBlocks (
+  IN EFI_BLOCK_IO_PROTOCOL  *This
+  )
+{
+  VBLK_DEV  *Dev;
 
-  //
-  // host status in last (second or third) desc
-  //
-  VirtioAppendDesc (
-    &Dev->Ring,
-    HostStatusDeviceAddress,
-    sizeof *HostStatus,
-    VRING_DESC_F_WRITE,
-    &Indices
-    );
+  Dev = VIRTIO_BLK_FROM_BLOCK_IO (This);
+  return Dev->BlockIoMedia.WriteCaching ?
+         VirtioBlkQueueTask (
+           Dev,
+           VIRTIO_BLK_T_FLUSH,
+           0,      // Lba
+           0,      // BufferSize
+           NULL,   // Buffer
+           NULL    // Token
+           ) :
+         EFI_SUCCESS;
+}
 
+//
+// UEFI Spec 2.3.1 + Errata C, 12.9 EFI Block I/O 2 Protocol
+// Driver Writer's Guide for UEFI 2.3.1 v1.01,
+//   24.2 Block I/O Protocol Implementations
+//
+EFI_STATUS
+EFIAPI
+VirtioBlkResetEx (
+  IN EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN BOOLEAN                 ExtendedVerification
+  )
+{
   //
-  // virtio-blk's only virtqueue is #0, called "requestq" (see Appendix D).
+  // Abort the tasks that have not been submitted yet, and wait for the
+  // submitted requests to complete.
   //
-  if ((VirtioFlush (
-         Dev->VirtIo,
-         0,
-         &Dev->Ring,
-         &Indices,
-         NULL
-         ) == EFI_SUCCESS) &&
-      (*HostStatus == VIRTIO_BLK_S_OK))
-  {
-    Status = EFI_SUCCESS;
-  } else {
-    Status = EFI_DEVICE_ERROR;
-  }
+  VirtioBlkAbortTasks (VIRTIO_BLK_FROM_BLOCK_IO2 (This));
+  return EFI_SUCCESS;
+}
 
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, StatusMapping);
+/**
 
-UnmapDataBuffer:
-  if (BufferSize > 0) {
-    UnmapStatus = Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, BufferMapping);
-    if (EFI_ERROR (UnmapStatus) && !RequestIsWrite && !EFI_ERROR (Status)) {
-      //
-      // Data from the bus master may not reach the caller; fail the request.
-      //
-      Status = EFI_DEVICE_ERROR;
-    }
-  }
+  Complete a Block I/O 2 request that needs no device access.
 
-UnmapRequestBuffer:
-  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, RequestMapping);
+  @param[in out] Token  The token of the request, or NULL for a blocking
+                        request.
 
-FreeHostStatusBuffer:
-  Dev->VirtIo->FreeSharedPages (
-                 Dev->VirtIo,
-                 EFI_SIZE_TO_PAGES (sizeof *HostStatus),
-                 HostStatusBuffer
-                 );
+  @retval EFI_SUCCESS  The request is complete.
 
-FreeBlkRequest:
-  FreePool ((VOID *)Request);
+**/
+STATIC
+EFI_STATUS
+CompleteTrivialRequest (
+  IN OUT EFI_BLOCK_IO2_TOKEN  *Token OPTIONAL
+  )
+{
+  if ((Token != NULL) && (Token->Event != NULL)) {
+    Token->TransactionStatus = EFI_SUCCESS;
+    gBS->SignalEvent (Token->Event);
+  }
 
-  return Status;
+  return EFI_SUCCESS;
 }
 
 /**
 
-  ReadBlocks() operation for virtio-blk.
+  ReadBlocksEx() operation for virtio-blk.
 
   See
-  - UEFI Spec 2.3.1 + Errata C, 12.8 EFI Block I/O Protocol, 12.8 EFI Block I/O
-    Protocol, EFI_BLOCK_IO_PROTOCOL.ReadBlocks().
+  - UEFI Spec 2.3.1 + Errata C, 12.9 EFI Block I/O 2 Protocol,
+    EFI_BLOCK_IO2_PROTOCOL.ReadBlocksEx().
   - Driver Writer's Guide for UEFI 2.3.1 v1.01, 24.2.2. ReadBlocks() and
     ReadBlocksEx() Implementation.
 
-  Parameter checks and conformant return values are implemented in
-  VerifyReadWriteRequest() and SynchronousRequest().
-
-  A zero BufferSize doesn't seem to be prohibited, so do nothing in that case,
-  successfully.
+  The request is blocking if Token is NULL or Token->Event is NULL.
 
 **/
 EFI_STATUS
 EFIAPI
-VirtioBlkReadBlocks (
-  IN  EFI_BLOCK_IO_PROTOCOL  *This,
-  IN  UINT32                 MediaId,
-  IN  EFI_LBA                Lba,
-  IN  UINTN                  BufferSize,
-  OUT VOID                   *Buffer
+VirtioBlkReadBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  OUT    VOID                    *Buffer
   )
 {
   VBLK_DEV    *Dev;
   EFI_STATUS  Status;
 
   if (BufferSize == 0) {
-    return EFI_SUCCESS;
+    return CompleteTrivialRequest (Token);
   }
 
-  Dev    = VIRTIO_BLK_FROM_BLOCK_IO (This);
+  Dev    = VIRTIO_BLK_FROM_BLOCK_IO2 (This);
   Status = VerifyReadWriteRequest (
              &Dev->BlockIoMedia,
              Lba,
@@ -512,50 +409,48 @@ VirtioBlkReadBlocks (
     return Status;
   }
 
-  return SynchronousRequest (
+  return VirtioBlkQueueTask (
            Dev,
+           VIRTIO_BLK_T_IN,
            Lba,
            BufferSize,
            Buffer,
-           FALSE       // RequestIsWrite
+           ((Token != NULL) && (Token->Event != NULL)) ? Token : NULL
            );
 }
 
 /**
 
-  WriteBlocks() operation for virtio-blk.
+  WriteBlocksEx() operation for virtio-blk.
 
   See
-  - UEFI Spec 2.3.1 + Errata C, 12.8 EFI Block I/O Protocol, 12.8 EFI Block I/O
-    Protocol, EFI_BLOCK_IO_PROTOCOL.WriteBlocks().
+  - UEFI Spec 2.3.1 + Errata C, 12.9 EFI Block I/O 2 Protocol,
+    EFI_BLOCK_IO2_PROTOCOL.WriteBlocksEx().
   - Driver Writer's Guide for UEFI 2.3.1 v1.01, 24.2.3 WriteBlocks() and
     WriteBlockEx() Implementation.
 
-  Parameter checks and conformant return values are implemented in
-  VerifyReadWriteRequest() and SynchronousRequest().
-
-  A zero BufferSize doesn't seem to be prohibited, so do nothing in that case,
-  successfully.
+  The request is blocking if Token is NULL or Token->Event is NULL.
 
 **/
 EFI_STATUS
 EFIAPI
-VirtioBlkWriteBlocks (
-  IN EFI_BLOCK_IO_PROTOCOL  *This,
-  IN UINT32                 MediaId,
-  IN EFI_LBA                Lba,
-  IN UINTN                  BufferSize,
-  IN VOID                   *Buffer
+VirtioBlkWriteBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  IN     VOID                    *Buffer
   )
 {
   VBLK_DEV    *Dev;
   EFI_STATUS  Status;
 
   if (BufferSize == 0) {
-    return EFI_SUCCESS;
+    return CompleteTrivialRequest (Token);
   }
 
-  Dev    = VIRTIO_BLK_FROM_BLOCK_IO (This);
+  Dev    = VIRTIO_BLK_FROM_BLOCK_IO2 (This);
   Status = VerifyReadWriteRequest (
              &Dev->BlockIoMedia,
              Lba,
@@ -566,49 +461,52 @@ VirtioBlkWriteBlocks (
     return Status;
   }
 
-  return SynchronousRequest (
+  return VirtioBlkQueueTask (
            Dev,
+           VIRTIO_BLK_T_OUT,
            Lba,
            BufferSize,
            Buffer,
-           TRUE        // RequestIsWrite
+           ((Token != NULL) && (Token->Event != NULL)) ? Token : NULL
            );
 }
 
 /**
 
-  FlushBlocks() operation for virtio-blk.
+  FlushBlocksEx() operation for virtio-blk.
 
   See
-  - UEFI Spec 2.3.1 + Errata C, 12.8 EFI Block I/O Protocol, 12.8 EFI Block I/O
-    Protocol, EFI_BLOCK_IO_PROTOCOL.FlushBlocks().
+  - UEFI Spec 2.3.1 + Errata C, 12.9 EFI Block I/O 2 Protocol,
+    EFI_BLOCK_IO2_PROTOCOL.FlushBlocksEx().
   - Driver Writer's Guide for UEFI 2.3.1 v1.01, 24.2.4 FlushBlocks() and
     FlushBlocksEx() Implementation.
 
-  If the underlying virtio-blk device doesn't support flushing (ie.
-  write-caching), then this function should not be called by higher layers,
-  according to EFI_BLOCK_IO_MEDIA characteristics set in VirtioBlkInit().
-  Should they do nonetheless, we do nothing, successfully.
+  The flush is only submitted after all earlier requests have completed, and
+  later requests are only submitted after the flush has completed.
 
 **/
 EFI_STATUS
 EFIAPI
-VirtioBlkFlushBlocks (
-  IN EFI_BLOCK_IO_PROTOCOL  *This
+VirtioBlkFlushBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token
   )
 {
   VBLK_DEV  *Dev;
 
-  Dev = VIRTIO_BLK_FROM_BLOCK_IO (This);
-  return Dev->BlockIoMedia.WriteCaching ?
-         SynchronousRequest (
+  Dev = VIRTIO_BLK_FROM_BLOCK_IO2 (This);
+  if (!Dev->BlockIoMedia.WriteCaching) {
+    return CompleteTrivialRequest (Token);
+  }
+
+  return VirtioBlkQueueTask (
            Dev,
+           VIRTIO_BLK_T_FLUSH,
            0,      // Lba
            0,      // BufferSize
            NULL,   // Buffer
-           TRUE    // RequestIsWrite
-           ) :
-         EFI_SUCCESS;
+           ((Token != NULL) && (Token->Event != NULL)) ? Token : NULL
+           );
 }
 
 /**
@@ -731,10 +629,12 @@ VirtioBlkInit (
   UINT32  OptIoSize;
   UINT16  QueueSize;
   UINT64  RingBaseShift;
+  UINT32  SizeMax;
 
   PhysicalBlockExp = 0;
   AlignmentOffset  = 0;
   OptIoSize        = 0;
+  SizeMax          = 0;
 
   //
   // Execute virtio-0.9.5, 2.2.1 Device Initialization Sequence.
@@ -829,10 +729,34 @@ VirtioBlkInit (
     }
   }
 
+  if (Features & VIRTIO_BLK_F_SIZE_MAX) {
+    Status = VIRTIO_CFG_READ (Dev, SizeMax, &SizeMax);
+    if (EFI_ERROR (Status)) {
+      goto Failed;
+    }
+  }
+
   Features &= VIRTIO_BLK_F_BLK_SIZE | VIRTIO_BLK_F_TOPOLOGY | VIRTIO_BLK_F_RO |
-              VIRTIO_BLK_F_FLUSH | VIRTIO_F_VERSION_1 |
+              VIRTIO_BLK_F_FLUSH | VIRTIO_BLK_F_SIZE_MAX |
+              VIRTIO_F_RING_INDIRECT_DESC | VIRTIO_F_VERSION_1 |
               VIRTIO_F_IOMMU_PLATFORM;
 
+  //
+  // Split transfers into requests of at most VBLK_MAX_REQUEST_SIZE bytes, or
+  // the maximum segment size of the device if that is smaller. Every request
+  // transfers a whole number of logical blocks.
+  //
+  Dev->MaxRequestSize = VBLK_MAX_REQUEST_SIZE;
+  if ((Features & VIRTIO_BLK_F_SIZE_MAX) && (SizeMax < Dev->MaxRequestSize)) {
+    Dev->MaxRequestSize = SizeMax - SizeMax % BlockSize;
+  }
+
+  if (Dev->MaxRequestSize < BlockSize) {
+    Dev->MaxRequestSize = BlockSize;
+  }
+
+  Dev->IndirectDesc = (BOOLEAN)((Features & VIRTIO_F_RING_INDIRECT_DESC) != 0);
+
   //
   // In virtio-1.0, feature negotiation is expected to complete before queue
   // discovery, and the device can also reject the selected set of features.
@@ -857,8 +781,8 @@ VirtioBlkInit (
     goto Failed;
   }
 
-  if (QueueSize < 3) {
-    // SynchronousRequest() uses at most three descriptors
+  if (QueueSize < VBLK_DESC_PER_REQUEST) {
+    // a request uses at most three descriptors without indirect descriptors
     Status = EFI_UNSUPPORTED;
     goto Failed;
   }
@@ -918,13 +842,22 @@ VirtioBlkInit (
     }
   }
 
+  //
+  // Set up the request slots of the virtqueue. If anything fails from here
+  // on, we must release them.
+  //
+  Status = VirtioBlkQueueInit (Dev);
+  if (EFI_ERROR (Status)) {
+    goto UnmapQueue;
+  }
+
   //
   // step 6 -- initialization complete
   //
   NextDevStat |= VSTAT_DRIVER_OK;
   Status       = Dev->VirtIo->SetDeviceStatus (Dev->VirtIo, NextDevStat);
   if (EFI_ERROR (Status)) {
-    goto UnmapQueue;
+    goto UninitQueue;
   }
 
   //
@@ -950,6 +883,12 @@ VirtioBlkInit (
                                          BlockSize / 512
                                          ) - 1;
 
+  Dev->BlockIo2.Media         = &Dev->BlockIoMedia;
+  Dev->BlockIo2.Reset         = &VirtioBlkResetEx;
+  Dev->BlockIo2.ReadBlocksEx  = &VirtioBlkReadBlocksEx;
+  Dev->BlockIo2.WriteBlocksEx = &VirtioBlkWriteBlocksEx;
+  Dev->BlockIo2.FlushBlocksEx = &VirtioBlkFlushBlocksEx;
+
   DEBUG ((
     DEBUG_INFO,
     "%a: LbaSize=0x%x[B] NumBlocks=0x%Lx[Lba]\n",
@@ -980,8 +919,20 @@ VirtioBlkInit (
       ));
   }
 
+  DEBUG ((
+    DEBUG_INFO,
+    "%a: Requests=%u MaxRequestSize=0x%Lx[B] IndirectDesc=%d\n",
+    __func__,
+    Dev->RequestCount,
+    (UINT64)Dev->MaxRequestSize,
+    Dev->IndirectDesc
+    ));
+
   return EFI_SUCCESS;
 
+UninitQueue:
+  VirtioBlkQueueUninit (Dev);
+
 UnmapQueue:
   Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RingMap);
 
@@ -1021,10 +972,12 @@ VirtioBlkUninit (
   //
   Dev->VirtIo->SetDeviceStatus (Dev->VirtIo, 0);
 
+  VirtioBlkQueueUninit (Dev);
   Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->RingMap);
   VirtioRingUninit (Dev->VirtIo, &Dev->Ring);
 
   SetMem (&Dev->BlockIo, sizeof Dev->BlockIo, 0x00);
+  SetMem (&Dev->BlockIo2, sizeof Dev->BlockIo2, 0x00);
   SetMem (&Dev->BlockIoMedia, sizeof Dev->BlockIoMedia, 0x00);
 }
 
@@ -1135,14 +1088,17 @@ VirtioBlkDriverBindingStart (
   }
 
   //
-  // Setup complete, attempt to export the driver instance's BlockIo interface.
+  // Setup complete, attempt to export the driver instance's BlockIo and
+  // BlockIo2 interfaces.
   //
   Dev->Signature = VBLK_SIG;
-  Status         = gBS->InstallProtocolInterface (
+  Status         = gBS->InstallMultipleProtocolInterfaces (
                           &DeviceHandle,
                           &gEfiBlockIoProtocolGuid,
-                          EFI_NATIVE_INTERFACE,
-                          &Dev->BlockIo
+                          &Dev->BlockIo,
+                          &gEfiBlockIo2ProtocolGuid,
+                          &Dev->BlockIo2,
+                          NULL
                           );
   if (EFI_ERROR (Status)) {
     goto CloseExitBoot;
@@ -1172,7 +1128,8 @@ FreeVirtioBlk:
 
 /**
 
-  Stop driving a virtio-blk device and remove its BlockIo interface.
+  Stop driving a virtio-blk device and remove its BlockIo and BlockIo2
+  interfaces.
 
   This function replays the success path of DriverBindingStart() in reverse.
   The host side virtio-blk device is reset, so that the OS boot loader or the
@@ -1222,15 +1179,23 @@ VirtioBlkDriverBindingStop (
   //
   // Handle Stop() requests for in-use driver instances gracefully.
   //
-  Status = gBS->UninstallProtocolInterface (
+  Status = gBS->UninstallMultipleProtocolInterfaces (
                   DeviceHandle,
                   &gEfiBlockIoProtocolGuid,
-                  &Dev->BlockIo
+                  &Dev->BlockIo,
+                  &gEfiBlockIo2ProtocolGuid,
+                  &Dev->BlockIo2,
+                  NULL
                   );
   if (EFI_ERROR (Status)) {
     return Status;
   }
 
+  //
+  // Wait for the requests that are still in flight.
+  //
+  VirtioBlkAbortTasks (Dev);
+
   gBS->CloseEvent (Dev->ExitBoot);
 
   VirtioBlkUninit (Dev);
@@ -1,7 +1,7 @@
 /** @file
 
-  Internal definitions for the virtio-blk driver, which produces Block I/O
-  Protocol instances for virtio-blk devices.
+  Internal definitions for the virtio-blk driver, which produces Block I/O and
+  Block I/O 2 Protocol instances for virtio-blk devices.
 
   Copyright (C) 2012, Red Hat, Inc.
 
@@ -12,13 +12,79 @@
 #pragma once
 
 #include <Protocol/BlockIo.h>
+#include <Protocol/BlockIo2.h>
 #include <Protocol/ComponentName.h>
 #include <Protocol/DriverBinding.h>
 
 #include <IndustryStandard/Virtio.h>
+#include <IndustryStandard/VirtioBlk.h>
 
 #define VBLK_SIG  SIGNATURE_32 ('V', 'B', 'L', 'K')
 
+//
+// Read and write requests are split into virtio-blk requests of at most this
+// size, so that the host can process the parts of a large transfer in parallel.
+//
+#define VBLK_MAX_REQUEST_SIZE  SIZE_1MB
+
+//
+// Period of the timer that polls the used ring while asynchronous requests are
+// pending, in 100ns units.
+//
+#define VBLK_POLL_PERIOD  10000
+
+//
+// The number of descriptors of a request: header, data buffer, host status.
+//
+#define VBLK_DESC_PER_REQUEST  3
+
+//
+// The parts of a request that the device accesses, other than the data buffer.
+// One element per request slot is allocated in a buffer shared with the device.
+//
+#pragma pack(1)
+typedef struct {
+  VRING_DESC        Indirect[VBLK_DESC_PER_REQUEST];
+  VIRTIO_BLK_REQ    Header;
+  UINT8             HostStatus;
+  UINT8             Reserved[15];
+} VBLK_SHARED_REQUEST;
+#pragma pack()
+
+#define VBLK_TASK_SIG  SIGNATURE_32 ('V', 'B', 'T', 'K')
+
+//
+// A read, write or flush operation of the Block I/O (2) Protocol. A task is
+// queued in VBLK_DEV.TaskQueue until all of its requests have been submitted,
+// and it is completed when the last one has been used by the device.
+//
+typedef struct {
+  UINT32                 Signature;
+  LIST_ENTRY             Link;
+  EFI_BLOCK_IO2_TOKEN    *Token;          // NULL for synchronous tasks
+  UINT32                 Type;            // VIRTIO_BLK_T_IN, _OUT or _FLUSH
+  EFI_LBA                Lba;             // LBA of the next request
+  UINT8                  *Buffer;         // data buffer of the next request
+  UINTN                  Remaining;       // bytes not submitted yet
+  UINTN                  PendingRequests; // requests not submitted yet
+  UINTN                  InFlight;        // requests not used by the device yet
+  EFI_STATUS             Status;
+  BOOLEAN                Done;
+} VBLK_TASK;
+
+#define VBLK_TASK_FROM_LINK(Link) \
+        CR (Link, VBLK_TASK, Link, VBLK_TASK_SIG)
+
+//
+// The driver side of a request slot. Task is NULL when the slot is free.
+//
+typedef struct {
+  VBLK_TASK    *Task;
+  UINTN        BufferSize;
+  VOID         *BufferMapping;
+  BOOLEAN      RequestIsWrite;
+} VBLK_REQUEST;
+
 typedef struct {
   //
   // Parts of this structure are initialized / torn down in various functions
@@ -34,11 +100,27 @@ typedef struct {
   EFI_BLOCK_IO_PROTOCOL     BlockIo;           // VirtioBlkInit       1
   EFI_BLOCK_IO_MEDIA        BlockIoMedia;      // VirtioBlkInit       1
   VOID                      *RingMap;          // VirtioRingMap       2
+  EFI_BLOCK_IO2_PROTOCOL    BlockIo2;          // VirtioBlkInit       1
+  BOOLEAN                   IndirectDesc;      // VirtioBlkInit       1
+  UINTN                     MaxRequestSize;    // VirtioBlkInit       1
+  UINT16                    RequestCount;      // VirtioBlkQueueInit  2
+  UINT16                    CurPending;        // VirtioBlkQueueInit  2
+  UINT16                    *FreeStack;        // VirtioBlkQueueInit  2
+  VBLK_REQUEST              *Requests;         // VirtioBlkQueueInit  2
+  VBLK_SHARED_REQUEST       *Shared;           // VirtioBlkQueueInit  2
+  VOID                      *SharedMap;        // VirtioBlkQueueInit  2
+  EFI_PHYSICAL_ADDRESS      SharedDeviceBase;  // VirtioBlkQueueInit  2
+  UINT16                    LastUsed;          // VirtioBlkQueueInit  2
+  LIST_ENTRY                TaskQueue;         // VirtioBlkQueueInit  2
+  EFI_EVENT                 PollTimer;         // VirtioBlkQueueInit  2
 } VBLK_DEV;
 
 #define VIRTIO_BLK_FROM_BLOCK_IO(BlockIoPointer) \
         CR (BlockIoPointer, VBLK_DEV, BlockIo, VBLK_SIG)
 
+#define VIRTIO_BLK_FROM_BLOCK_IO2(BlockIo2Pointer) \
+        CR (BlockIo2Pointer, VBLK_DEV, BlockIo2, VBLK_SIG)
+
 /**
 
   Device probe function for this driver.
@@ -243,6 +325,140 @@ VirtioBlkFlushBlocks (
   IN EFI_BLOCK_IO_PROTOCOL  *This
   );
 
+//
+// UEFI Spec 2.10, 13.10 Block I/O 2 Protocol
+//
+// The Ex() functions share the request verification of their Block I/O
+// counterparts. A NULL Token, or a Token with a NULL Event, makes them
+// blocking.
+//
+EFI_STATUS
+EFIAPI
+VirtioBlkResetEx (
+  IN EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN BOOLEAN                 ExtendedVerification
+  );
+
+EFI_STATUS
+EFIAPI
+VirtioBlkReadBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  OUT    VOID                    *Buffer
+  );
+
+EFI_STATUS
+EFIAPI
+VirtioBlkWriteBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN     UINT32                  MediaId,
+  IN     EFI_LBA                 Lba,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token,
+  IN     UINTN                   BufferSize,
+  IN     VOID                    *Buffer
+  );
+
+EFI_STATUS
+EFIAPI
+VirtioBlkFlushBlocksEx (
+  IN     EFI_BLOCK_IO2_PROTOCOL  *This,
+  IN OUT EFI_BLOCK_IO2_TOKEN     *Token
+  );
+
+//
+// Request queue management, in VirtioBlkQueue.c.
+//
+
+/**
+
+  Allocate the request slots of the virtqueue and the buffer shared with the
+  device for their headers, host status bytes and indirect descriptor tables.
+
+  @param[in out] Dev  The virtio-blk device. Dev->Ring must be initialized, and
+                      Dev->IndirectDesc must reflect the negotiated features.
+
+  @retval EFI_SUCCESS           The request slots are ready.
+
+  @retval EFI_OUT_OF_RESOURCES  Memory allocation failed.
+
+  @return                       Error codes from the VirtIo protocol or the
+                                CreateEvent() boot service.
+
+**/
+EFI_STATUS
+VirtioBlkQueueInit (
+  IN OUT VBLK_DEV  *Dev
+  );
+
+/**
+
+  Release the resources allocated by VirtioBlkQueueInit(). The device must not
+  access the virtqueue any longer.
+
+  @param[in out] Dev  The virtio-blk device.
+
+**/
+VOID
+VirtioBlkQueueUninit (
+  IN OUT VBLK_DEV  *Dev
+  );
+
+/**
+
+  Queue a read, write or flush task, and wait for it unless it is asynchronous.
+
+  The function may only be called after the request parameters have been
+  verified by ReadBlocks() / WriteBlocks() / FlushBlocks() or their Ex()
+  counterparts.
+
+  @param[in] Dev             The virtio-blk device.
+
+  @param[in] Type            VIRTIO_BLK_T_IN, VIRTIO_BLK_T_OUT or
+                             VIRTIO_BLK_T_FLUSH.
+
+  @param[in] Lba             The first LBA to transfer, zero for flush.
+
+  @param[in] BufferSize      The size of Buffer in bytes, zero for flush.
+
+  @param[in out] Buffer      The data buffer, ignored for flush.
+
+  @param[in out] Token       The Block I/O 2 token of an asynchronous task, or
+                             NULL for a synchronous task.
+
+  @retval EFI_SUCCESS           The synchronous task has completed, or the
+                                asynchronous task has been queued.
+
+  @retval EFI_OUT_OF_RESOURCES  The asynchronous task could not be allocated.
+
+  @retval EFI_DEVICE_ERROR      The synchronous task failed.
+
+**/
+EFI_STATUS
+VirtioBlkQueueTask (
+  IN     VBLK_DEV             *Dev,
+  IN     UINT32               Type,
+  IN     EFI_LBA              Lba,
+  IN     UINTN                BufferSize,
+  IN OUT VOID                 *Buffer,
+  IN OUT EFI_BLOCK_IO2_TOKEN  *Token OPTIONAL
+  );
+
+/**
+
+  Abort the queued tasks whose requests have not been submitted yet, and wait
+  until the device has used all submitted requests.
+
+  @param[in] Dev  The virtio-blk device.
+
+**/
+VOID
+VirtioBlkAbortTasks (
+  IN VBLK_DEV  *Dev
+  );
+
 //
 // The purpose of the following scaffolding (EFI_COMPONENT_NAME_PROTOCOL and
 // EFI_COMPONENT_NAME2_PROTOCOL implementation) is to format the driver's name
@@ -0,0 +1,747 @@
+/** @file
+
+  Multiple in-flight request support for the virtio-blk driver.
+
+  The virtqueue is divided into request slots. Without indirect descriptors,
+  slot N owns descriptors 3*N .. 3*N+2 of the descriptor table. With
+  VIRTIO_F_RING_INDIRECT_DESC, slot N owns descriptor N, which points to the
+  indirect descriptor table of the slot in the shared buffer, so every
+  descriptor of the virtqueue can carry a request.
+
+  Read and write tasks are split into requests of at most Dev->MaxRequestSize
+  bytes. Tasks are submitted in FIFO order, as long as free slots exist. A
+  flush task is only submitted after all earlier requests have been used by
+  the device, and no later request is submitted before it is used.
+
+  The used ring is polled by synchronous callers, and by a periodic timer
+  while asynchronous tasks are pending. All accesses to the virtqueue and the
+  task queue are made at TPL_NOTIFY.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/VirtioLib.h>
+
+#include "VirtioBlk.h"
+
+/**
+
+  Complete a task whose requests have all been used by the device.
+
+  A flush task stays at the head of the task queue while it is in flight, and
+  is removed from the queue here. An asynchronous task is freed after its
+  event is signaled. A synchronous task is freed by its waiter.
+
+  @param[in out] Task  The task to complete.
+
+**/
+STATIC
+VOID
+VirtioBlkCompleteTask (
+  IN OUT VBLK_TASK  *Task
+  )
+{
+  ASSERT (Task->PendingRequests == 0);
+  ASSERT (Task->InFlight == 0);
+
+  if ((Task->Type == VIRTIO_BLK_T_FLUSH) && (Task->Link.ForwardLink != NULL)) {
+    RemoveEntryList (&Task->Link);
+    Task->Link.ForwardLink = NULL;
+  }
+
+  Task->Done = TRUE;
+  if (Task->Token != NULL) {
+    Task->Token->TransactionStatus = Task->Status;
+    gBS->SignalEvent (Task->Token->Event);
+    FreePool (Task);
+  }
+}
+
+/**
+
+  Build the next request of a task in a free slot.
+
+  @param[in] Dev           The virtio-blk device.
+
+  @param[in out] Task      The task, with at least one pending request.
+
+  @param[in out] AvailIdx  The next index of the available ring. It is
+                           incremented on success.
+
+  @retval EFI_SUCCESS       The request has been placed in the available ring.
+                            The index field of the available ring is not
+                            updated yet.
+
+  @retval EFI_DEVICE_ERROR  Failed to map the data buffer.
+
+**/
+STATIC
+EFI_STATUS
+VirtioBlkSubmitRequest (
+  IN     VBLK_DEV   *Dev,
+  IN OUT VBLK_TASK  *Task,
+  IN OUT UINT16     *AvailIdx
+  )
+{
+  UINT16                Slot;
+  VBLK_REQUEST          *Request;
+  VBLK_SHARED_REQUEST   *Shared;
+  EFI_PHYSICAL_ADDRESS  SharedDeviceAddress;
+  EFI_PHYSICAL_ADDRESS  BufferDeviceAddress;
+  BOOLEAN               RequestIsWrite;
+  UINTN                 BufferSize;
+  UINT16                BufferFlags;
+  UINT16                HeadDescIdx;
+  DESC_INDICES          Indices;
+  EFI_STATUS            Status;
+
+  ASSERT (Task->PendingRequests > 0);
+  ASSERT (Dev->CurPending < Dev->RequestCount);
+
+  Slot                = Dev->FreeStack[Dev->CurPending];
+  Request             = &Dev->Requests[Slot];
+  Shared              = &Dev->Shared[Slot];
+  SharedDeviceAddress = Dev->SharedDeviceBase + Slot * sizeof (VBLK_SHARED_REQUEST);
+  RequestIsWrite      = (BOOLEAN)(Task->Type != VIRTIO_BLK_T_IN);
+  BufferSize          = MIN (Task->Remaining, Dev->MaxRequestSize);
+  BufferDeviceAddress = 0;
+
+  //
+  // Map the data buffer of this request
+  //
+  if (BufferSize > 0) {
+    Status = VirtioMapAllBytesInSharedBuffer (
+               Dev->VirtIo,
+               (RequestIsWrite ?
+                VirtioOperationBusMasterRead :
+                VirtioOperationBusMasterWrite),
+               Task->Buffer,
+               BufferSize,
+               &BufferDeviceAddress,
+               &Request->BufferMapping
+               );
+    if (EFI_ERROR (Status)) {
+      return EFI_DEVICE_ERROR;
+    }
+  }
+
+  Dev->CurPending++;
+  Request->Task           = Task;
+  Request->BufferSize     = BufferSize;
+  Request->RequestIsWrite = RequestIsWrite;
+
+  //
+  // Prepare virtio-blk request header. IO Priority is homogeneously 0.
+  // Preset a host status for ourselves that we do not accept as success.
+  //
+  Shared->Header.Type   = Task->Type;
+  Shared->Header.IoPrio = 0;
+  Shared->Header.Sector = MultU64x32 (Task->Lba, Dev->BlockIoMedia.BlockSize / 512);
+  Shared->HostStatus    = VIRTIO_BLK_S_IOERR;
+
+  //
+  // VRING_DESC_F_WRITE is interpreted from the host's point of view.
+  //
+  BufferFlags = RequestIsWrite ? 0 : VRING_DESC_F_WRITE;
+
+  if (Dev->IndirectDesc) {
+    Indices.NextDescIdx = 0;
+    Shared->Indirect[Indices.NextDescIdx].Addr  = SharedDeviceAddress + OFFSET_OF (VBLK_SHARED_REQUEST, Header);
+    Shared->Indirect[Indices.NextDescIdx].Len   = sizeof (Shared->Header);
+    Shared->Indirect[Indices.NextDescIdx].Flags = VRING_DESC_F_NEXT;
+    Shared->Indirect[Indices.NextDescIdx].Next  = Indices.NextDescIdx + 1;
+    Indices.NextDescIdx++;
+
+    if (BufferSize > 0) {
+      Shared->Indirect[Indices.NextDescIdx].Addr  = BufferDeviceAddress;
+      Shared->Indirect[Indices.NextDescIdx].Len   = (UINT32)BufferSize;
+      Shared->Indirect[Indices.NextDescIdx].Flags = VRING_DESC_F_NEXT | BufferFlags;
+      Shared->Indirect[Indices.NextDescIdx].Next  = Indices.NextDescIdx + 1;
+      Indices.NextDescIdx++;
+    }
+
+    Shared->Indirect[Indices.NextDescIdx].Addr  = SharedDeviceAddress + OFFSET_OF (VBLK_SHARED_REQUEST, HostStatus);
+    Shared->Indirect[Indices.NextDescIdx].Len   = sizeof (Shared->HostStatus);
+    Shared->Indirect[Indices.NextDescIdx].Flags = VRING_DESC_F_WRITE;
+    Shared->Indirect[Indices.NextDescIdx].Next  = 0;
+    Indices.NextDescIdx++;
+
+    HeadDescIdx                       = Slot;
+    Dev->Ring.Desc[HeadDescIdx].Addr  = SharedDeviceAddress + OFFSET_OF (VBLK_SHARED_REQUEST, Indirect);
+    Dev->Ring.Desc[HeadDescIdx].Len   = Indices.NextDescIdx * sizeof (VRING_DESC);
+    Dev->Ring.Desc[HeadDescIdx].Flags = VRING_DESC_F_INDIRECT;
+    Dev->Ring.Desc[HeadDescIdx].Next  = 0;
+  } else {
+    HeadDescIdx         = (UINT16)(Slot * VBLK_DESC_PER_REQUEST);
+    Indices.HeadDescIdx = HeadDescIdx;
+    Indices.NextDescIdx = HeadDescIdx;
+
+    VirtioAppendDesc (
+      &Dev->Ring,
+      SharedDeviceAddress + OFFSET_OF (VBLK_SHARED_REQUEST, Header),
+      sizeof (Shared->Header),
+      VRING_DESC_F_NEXT,
+      &Indices
+      );
+
+    if (BufferSize > 0) {
+      VirtioAppendDesc (
+        &Dev->Ring,
+        BufferDeviceAddress,
+        (UINT32)BufferSize,
+        VRING_DESC_F_NEXT | BufferFlags,
+        &Indices
+        );
+    }
+
+    VirtioAppendDesc (
+      &Dev->Ring,
+      SharedDeviceAddress + OFFSET_OF (VBLK_SHARED_REQUEST, HostStatus),
+      sizeof (Shared->HostStatus),
+      VRING_DESC_F_WRITE,
+      &Indices
+      );
+  }
+
+  //
+  // virtio-0.9.5, 2.4.1.2 Updating the Available Ring
+  //
+  Dev->Ring.Avail.Ring[(*AvailIdx)++ % Dev->Ring.QueueSize] = HeadDescIdx;
+
+  Task->Lba       += BufferSize / Dev->BlockIoMedia.BlockSize;
+  Task->Buffer    += BufferSize;
+  Task->Remaining -= BufferSize;
+  Task->PendingRequests--;
+  Task->InFlight++;
+
+  return EFI_SUCCESS;
+}
+
+/**
+
+  Submit the pending requests of the queued tasks in FIFO order, as long as
+  free request slots exist, and notify the device once.
+
+  Must be called at TPL_NOTIFY.
+
+  @param[in] Dev  The virtio-blk device.
+
+**/
+STATIC
+VOID
+VirtioBlkSubmitTasks (
+  IN VBLK_DEV  *Dev
+  )
+{
+  LIST_ENTRY  *Link;
+  VBLK_TASK   *Task;
+  UINT16      AvailIdx;
+  UINT16      FirstAvailIdx;
+  EFI_STATUS  Status;
+
+  AvailIdx      = *Dev->Ring.Avail.Idx;
+  FirstAvailIdx = AvailIdx;
+
+  while (!IsListEmpty (&Dev->TaskQueue)) {
+    Link = GetFirstNode (&Dev->TaskQueue);
+    Task = VBLK_TASK_FROM_LINK (Link);
+
+    //
+    // A flush is a barrier for the requests submitted before and after it. It
+    // waits at the head of the queue until the earlier requests have been
+    // used, and stays there until it has been used itself.
+    //
+    if (Task->Type == VIRTIO_BLK_T_FLUSH) {
+      if (Dev->CurPending == 0) {
+        Status = VirtioBlkSubmitRequest (Dev, Task, &AvailIdx);
+        if (EFI_ERROR (Status)) {
+          Task->Status          = Status;
+          Task->PendingRequests = 0;
+          VirtioBlkCompleteTask (Task);
+          continue;
+        }
+      }
+
+      break;
+    }
+
+    while ((Task->PendingRequests > 0) && (Dev->CurPending < Dev->RequestCount)) {
+      Status = VirtioBlkSubmitRequest (Dev, Task, &AvailIdx);
+      if (EFI_ERROR (Status)) {
+        //
+        // Fail the rest of the task. It completes when its submitted requests
+        // have been used.
+        //
+        Task->Status          = Status;
+        Task->Remaining       = 0;
+        Task->PendingRequests = 0;
+        break;
+      }
+    }
+
+    if (Task->PendingRequests > 0) {
+      break;
+    }
+
+    RemoveEntryList (&Task->Link);
+    Task->Link.ForwardLink = NULL;
+    if (Task->InFlight == 0) {
+      VirtioBlkCompleteTask (Task);
+    }
+  }
+
+  if (AvailIdx == FirstAvailIdx) {
+    return;
+  }
+
+  //
+  // virtio-0.9.5, 2.4.1.3 Updating the Index Field
+  //
+  MemoryFence ();
+  *Dev->Ring.Avail.Idx = AvailIdx;
+
+  //
+  // virtio-0.9.5, 2.4.1.4 Notifying the Device -- gratuitous notifications are
+  // OK. If the notification fails, the requests are still in the available
+  // ring and will be processed after a later notification.
+  //
+  MemoryFence ();
+  Status = Dev->VirtIo->SetQueueNotify (Dev->VirtIo, 0);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: SetQueueNotify(): %r\n", __func__, Status));
+  }
+}
+
+/**
+
+  Process the requests that the device has used since the last call, and
+  complete the tasks whose requests have all been used.
+
+  Must be called at TPL_NOTIFY.
+
+  @param[in] Dev  The virtio-blk device.
+
+**/
+STATIC
+VOID
+VirtioBlkProcessUsed (
+  IN VBLK_DEV  *Dev
+  )
+{
+  UINT16        CurUsed;
+  UINT32        DescIdx;
+  UINT16        Slot;
+  VBLK_REQUEST  *Request;
+  VBLK_TASK     *Task;
+  EFI_STATUS    UnmapStatus;
+
+  //
+  // virtio-0.9.5, 2.4.2 Receiving Used Buffers From the Device
+  //
+  MemoryFence ();
+  CurUsed = *Dev->Ring.Used.Idx;
+  MemoryFence ();
+
+  while (Dev->LastUsed != CurUsed) {
+    DescIdx = Dev->Ring.Used.UsedElem[Dev->LastUsed++ % Dev->Ring.QueueSize].Id;
+    Slot    = (UINT16)(Dev->IndirectDesc ? DescIdx : DescIdx / VBLK_DESC_PER_REQUEST);
+    ASSERT (Slot < Dev->RequestCount);
+    Request = &Dev->Requests[Slot];
+    Task    = Request->Task;
+    ASSERT (Task != NULL);
+
+    if (Dev->Shared[Slot].HostStatus != VIRTIO_BLK_S_OK) {
+      Task->Status = EFI_DEVICE_ERROR;
+    }
+
+    if (Request->BufferSize > 0) {
+      UnmapStatus = Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Request->BufferMapping);
+      if (EFI_ERROR (UnmapStatus) && !Request->RequestIsWrite) {
+        //
+        // Data from the bus master may not reach the caller; fail the request.
+        //
+        Task->Status = EFI_DEVICE_ERROR;
+      }
+    }
+
+    Request->Task = NULL;
+    ASSERT (Dev->CurPending > 0);
+    Dev->FreeStack[--Dev->CurPending] = Slot;
+
+    ASSERT (Task->InFlight > 0);
+    Task->InFlight--;
+    if ((Task->InFlight == 0) && (Task->PendingRequests == 0)) {
+      VirtioBlkCompleteTask (Task);
+    }
+  }
+}
+
+/**
+
+  Timer notification function polling the used ring while requests are
+  pending. It cancels itself when the task queue is empty and no request is in
+  flight.
+
+  @param[in] Event    The timer event.
+
+  @param[in] Context  Pointer to the VBLK_DEV structure.
+
+**/
+STATIC
+VOID
+EFIAPI
+VirtioBlkPollTimer (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  VBLK_DEV  *Dev;
+
+  Dev = Context;
+  VirtioBlkProcessUsed (Dev);
+  VirtioBlkSubmitTasks (Dev);
+
+  if ((Dev->CurPending == 0) && IsListEmpty (&Dev->TaskQueue)) {
+    gBS->SetTimer (Event, TimerCancel, 0);
+  }
+}
+
+/**
+
+  Poll the used ring until a synchronous task is done.
+
+  @param[in] Dev   The virtio-blk device.
+
+  @param[in] Task  The synchronous task to wait for.
+
+**/
+STATIC
+VOID
+VirtioBlkWaitTask (
+  IN VBLK_DEV   *Dev,
+  IN VBLK_TASK  *Task
+  )
+{
+  EFI_TPL  OldTpl;
+  UINTN    PollPeriodUsecs;
+  BOOLEAN  Done;
+
+  //
+  // Keep slowing down until we reach a poll period of slightly above 1 ms.
+  //
+  PollPeriodUsecs = 1;
+  for ( ; ;) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    VirtioBlkProcessUsed (Dev);
+    VirtioBlkSubmitTasks (Dev);
+    Done = Task->Done;
+    gBS->RestoreTPL (OldTpl);
+
+    if (Done) {
+      break;
+    }
+
+    gBS->Stall (PollPeriodUsecs);
+    if (PollPeriodUsecs < 1024) {
+      PollPeriodUsecs *= 2;
+    }
+  }
+}
+
+/**
+
+  Allocate the request slots of the virtqueue and the buffer shared with the
+  device for their headers, host status bytes and indirect descriptor tables.
+
+  @param[in out] Dev  The virtio-blk device. Dev->Ring must be initialized, and
+                      Dev->IndirectDesc must reflect the negotiated features.
+
+  @retval EFI_SUCCESS           The request slots are ready.
+
+  @retval EFI_OUT_OF_RESOURCES  Memory allocation failed.
+
+  @return                       Error codes from the VirtIo protocol or the
+                                CreateEvent() boot service.
+
+**/
+EFI_STATUS
+VirtioBlkQueueInit (
+  IN OUT VBLK_DEV  *Dev
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       SharedPages;
+  VOID        *SharedBuffer;
+  UINT16      Slot;
+
+  Dev->RequestCount = Dev->IndirectDesc ?
+                      Dev->Ring.QueueSize :
+                      Dev->Ring.QueueSize / VBLK_DESC_PER_REQUEST;
+  ASSERT (Dev->RequestCount > 0);
+
+  Dev->FreeStack = AllocatePool (Dev->RequestCount * sizeof *Dev->FreeStack);
+  if (Dev->FreeStack == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Dev->Requests = AllocateZeroPool (Dev->RequestCount * sizeof *Dev->Requests);
+  if (Dev->Requests == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto FreeFreeStack;
+  }
+
+  //
+  // The request headers, host status bytes and indirect descriptor tables are
+  // accessed by both the processor and the device.
+  //
+  SharedPages = EFI_SIZE_TO_PAGES (Dev->RequestCount * sizeof *Dev->Shared);
+  Status      = Dev->VirtIo->AllocateSharedPages (
+                               Dev->VirtIo,
+                               SharedPages,
+                               &SharedBuffer
+                               );
+  if (EFI_ERROR (Status)) {
+    goto FreeRequests;
+  }
+
+  ZeroMem (SharedBuffer, EFI_PAGES_TO_SIZE (SharedPages));
+  Dev->Shared = SharedBuffer;
+
+  Status = VirtioMapAllBytesInSharedBuffer (
+             Dev->VirtIo,
+             VirtioOperationBusMasterCommonBuffer,
+             SharedBuffer,
+             EFI_PAGES_TO_SIZE (SharedPages),
+             &Dev->SharedDeviceBase,
+             &Dev->SharedMap
+             );
+  if (EFI_ERROR (Status)) {
+    goto FreeSharedBuffer;
+  }
+
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  VirtioBlkPollTimer,
+                  Dev,
+                  &Dev->PollTimer
+                  );
+  if (EFI_ERROR (Status)) {
+    goto UnmapSharedBuffer;
+  }
+
+  for (Slot = 0; Slot < Dev->RequestCount; Slot++) {
+    Dev->FreeStack[Slot] = Slot;
+  }
+
+  Dev->CurPending = 0;
+  InitializeListHead (&Dev->TaskQueue);
+
+  //
+  // We poll the used ring, the host should not send an interrupt.
+  //
+  *Dev->Ring.Avail.Flags = (UINT16)VRING_AVAIL_F_NO_INTERRUPT;
+
+  MemoryFence ();
+  Dev->LastUsed = *Dev->Ring.Used.Idx;
+
+  return EFI_SUCCESS;
+
+UnmapSharedBuffer:
+  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->SharedMap);
+
+FreeSharedBuffer:
+  Dev->VirtIo->FreeSharedPages (Dev->VirtIo, SharedPages, SharedBuffer);
+
+FreeRequests:
+  FreePool (Dev->Requests);
+
+FreeFreeStack:
+  FreePool (Dev->FreeStack);
+
+  return Status;
+}
+
+/**
+
+  Release the resources allocated by VirtioBlkQueueInit(). The device must not
+  access the virtqueue any longer.
+
+  @param[in out] Dev  The virtio-blk device.
+
+**/
+VOID
+VirtioBlkQueueUninit (
+  IN OUT VBLK_DEV  *Dev
+  )
+{
+  ASSERT (Dev->CurPending == 0);
+  ASSERT (IsListEmpty (&Dev->TaskQueue));
+
+  gBS->CloseEvent (Dev->PollTimer);
+  Dev->VirtIo->UnmapSharedBuffer (Dev->VirtIo, Dev->SharedMap);
+  Dev->VirtIo->FreeSharedPages (
+                 Dev->VirtIo,
+                 EFI_SIZE_TO_PAGES (Dev->RequestCount * sizeof *Dev->Shared),
+                 Dev->Shared
+                 );
+  FreePool (Dev->Requests);
+  FreePool (Dev->FreeStack);
+}
+
+/**
+
+  Queue a read, write or flush task, and wait for it unless it is asynchronous.
+
+  The function may only be called after the request parameters have been
+  verified by ReadBlocks() / WriteBlocks() / FlushBlocks() or their Ex()
+  counterparts.
+
+  @param[in] Dev             The virtio-blk device.
+
+  @param[in] Type            VIRTIO_BLK_T_IN, VIRTIO_BLK_T_OUT or
+                             VIRTIO_BLK_T_FLUSH.
+
+  @param[in] Lba             The first LBA to transfer, zero for flush.
+
+  @param[in] BufferSize      The size of Buffer in bytes, zero for flush.
+
+  @param[in out] Buffer      The data buffer, ignored for flush.
+
+  @param[in out] Token       The Block I/O 2 token of an asynchronous task, or
+                             NULL for a synchronous task.
+
+  @retval EFI_SUCCESS           The synchronous task has completed, or the
+                                asynchronous task has been queued.
+
+  @retval EFI_OUT_OF_RESOURCES  The asynchronous task could not be allocated.
+
+  @retval EFI_DEVICE_ERROR      The synchronous task failed.
+
+**/
+EFI_STATUS
+VirtioBlkQueueTask (
+  IN     VBLK_DEV             *Dev,
+  IN     UINT32               Type,
+  IN     EFI_LBA              Lba,
+  IN     UINTN                BufferSize,
+  IN OUT VOID                 *Buffer,
+  IN OUT EFI_BLOCK_IO2_TOKEN  *Token OPTIONAL
+  )
+{
+  VBLK_TASK   *Task;
+  EFI_TPL     OldTpl;
+  EFI_STATUS  Status;
+
+  //
+  // ensured by contract above, plus VerifyReadWriteRequest()
+  //
+  ASSERT (BufferSize % Dev->BlockIoMedia.BlockSize == 0);
+  ASSERT (BufferSize <= SIZE_1GB);
+  ASSERT ((Type == VIRTIO_BLK_T_FLUSH) == (BufferSize == 0));
+
+  Task = AllocateZeroPool (sizeof *Task);
+  if (Task == NULL) {
+    return (Token != NULL) ? EFI_OUT_OF_RESOURCES : EFI_DEVICE_ERROR;
+  }
+
+  Task->Signature = VBLK_TASK_SIG;
+  Task->Token     = Token;
+  Task->Type      = Type;
+  Task->Lba       = Lba;
+  Task->Buffer    = Buffer;
+  Task->Remaining = BufferSize;
+  Task->Status    = EFI_SUCCESS;
+  if (BufferSize == 0) {
+    Task->PendingRequests = 1;
+  } else {
+    Task->PendingRequests = (BufferSize + Dev->MaxRequestSize - 1) / Dev->MaxRequestSize;
+  }
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  InsertTailList (&Dev->TaskQueue, &Task->Link);
+  VirtioBlkSubmitTasks (Dev);
+  if (Token != NULL) {
+    gBS->SetTimer (Dev->PollTimer, TimerPeriodic, VBLK_POLL_PERIOD);
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  if (Token != NULL) {
+    return EFI_SUCCESS;
+  }
+
+  VirtioBlkWaitTask (Dev, Task);
+  Status = Task->Status;
+  FreePool (Task);
+
+  return Status;
+}
+
+/**
+
+  Abort the queued tasks whose requests have not been submitted yet, and wait
+  until the device has used all submitted requests.
+
+  @param[in] Dev  The virtio-blk device.
+
+**/
+VOID
+VirtioBlkAbortTasks (
+  IN VBLK_DEV  *Dev
+  )
+{
+  EFI_TPL     OldTpl;
+  LIST_ENTRY  *Link;
+  LIST_ENTRY  *NextLink;
+  VBLK_TASK   *Task;
+  UINT16      CurPending;
+
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+  for (Link = GetFirstNode (&Dev->TaskQueue);
+       !IsNull (&Dev->TaskQueue, Link);
+       Link = NextLink)
+  {
+    NextLink = GetNextNode (&Dev->TaskQueue, Link);
+    Task     = VBLK_TASK_FROM_LINK (Link);
+
+    //
+    // A flush in flight removes itself from the queue when it completes.
+    //
+    if ((Task->Type == VIRTIO_BLK_T_FLUSH) && (Task->InFlight > 0)) {
+      continue;
+    }
+
+    RemoveEntryList (Link);
+    Task->Link.ForwardLink = NULL;
+    Task->Status           = EFI_ABORTED;
+    Task->Remaining        = 0;
+    Task->PendingRequests  = 0;
+    if (Task->InFlight == 0) {
+      VirtioBlkCompleteTask (Task);
+    }
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  for ( ; ;) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    VirtioBlkProcessUsed (Dev);
+    CurPending = Dev->CurPending;
+    gBS->RestoreTPL (OldTpl);
+
+    if (CurPending == 0) {
+      break;
+    }
+
+    gBS->Stall (1024);
+  }
+}
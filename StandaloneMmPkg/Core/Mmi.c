@@ -19,13 +19,16 @@
 
 #define MMI_ENTRY_SIGNATURE  SIGNATURE_32('m','m','i','e')
 
-typedef struct {
+typedef struct _MMI_ENTRY MMI_ENTRY;
+
+struct _MMI_ENTRY {
   UINTN         Signature;
   LIST_ENTRY    AllEntries; // All entries
 
   EFI_GUID      HandlerType; // Type of interrupt
   LIST_ENTRY    MmiHandlers; // All handlers
-} MMI_ENTRY;
+  MMI_ENTRY     *HashNext;   // Next entry in the same hash bucket
+};
 
 #define MMI_HANDLER_SIGNATURE  SIGNATURE_32('m','m','i','h')
 
@@ -42,9 +45,49 @@ typedef struct {
 //
 UINTN  mMmiManageCallingDepth = 0;
 
+//
+// mMmiHandlerToRemoveCount counts the MMI handlers unregistered by MMI handlers,
+// so MmiManage only looks for the handlers to remove when there are any.
+//
+UINTN  mMmiHandlerToRemoveCount = 0;
+
 LIST_ENTRY  mRootMmiHandlerList = INITIALIZE_LIST_HEAD_VARIABLE (mRootMmiHandlerList);
 LIST_ENTRY  mMmiEntryList       = INITIALIZE_LIST_HEAD_VARIABLE (mMmiEntryList);
 
+//
+// The MMI entries are also chained in a hash table indexed by their GUID, so
+// MmiManage finds the entry of an MMI without walking mMmiEntryList.
+// The number of buckets must be a power of 2.
+//
+#define MMI_ENTRY_HASH_BUCKET_COUNT  64
+
+MMI_ENTRY  *mMmiEntryHashTable[MMI_ENTRY_HASH_BUCKET_COUNT];
+
+/**
+  Returns the hash table bucket of an MMI handler type.
+
+  @param  HandlerType            The type of the interrupt
+
+  @return The index of the bucket in mMmiEntryHashTable.
+
+**/
+UINTN
+MmiEntryHash (
+  IN CONST EFI_GUID  *HandlerType
+  )
+{
+  UINT32  Hash;
+
+  Hash  = ReadUnaligned32 ((CONST UINT32 *)HandlerType) ^
+          ReadUnaligned32 ((CONST UINT32 *)HandlerType + 1) ^
+          ReadUnaligned32 ((CONST UINT32 *)HandlerType + 2) ^
+          ReadUnaligned32 ((CONST UINT32 *)HandlerType + 3);
+  Hash ^= Hash >> 16;
+  Hash ^= Hash >> 8;
+
+  return Hash & (MMI_ENTRY_HASH_BUCKET_COUNT - 1);
+}
+
 /**
   Remove MmiHandler and free the memory it used.
   If MmiEntry is empty, remove MmiEntry and free the memory it used.
@@ -61,6 +104,8 @@ RemoveMmiHandler (
   IN MMI_ENTRY    *MmiEntry
   )
 {
+  MMI_ENTRY  **Link;
+
   ASSERT (MmiHandler->ToRemove);
   RemoveEntryList (&MmiHandler->Link);
   FreePool (MmiHandler);
@@ -71,6 +116,13 @@ RemoveMmiHandler (
   if (MmiEntry != NULL) {
     if (IsListEmpty (&MmiEntry->MmiHandlers)) {
       RemoveEntryList (&MmiEntry->AllEntries);
+      for (Link = &mMmiEntryHashTable[MmiEntryHash (&MmiEntry->HandlerType)]; *Link != NULL; Link = &(*Link)->HashNext) {
+        if (*Link == MmiEntry) {
+          *Link = MmiEntry->HashNext;
+          break;
+        }
+      }
+
       FreePool (MmiEntry);
       return TRUE;
     }
@@ -95,19 +147,17 @@ MmCoreFindMmiEntry (
   IN BOOLEAN   Create
   )
 {
-  LIST_ENTRY  *Link;
-  MMI_ENTRY   *Item;
-  MMI_ENTRY   *MmiEntry;
+  MMI_ENTRY  *Item;
+  MMI_ENTRY  *MmiEntry;
+  UINTN      Bucket;
 
   //
-  // Search the MMI entry list for the matching GUID
+  // Search the hash bucket of the GUID for the matching GUID
   //
   MmiEntry = NULL;
-  for (Link = mMmiEntryList.ForwardLink;
-       Link != &mMmiEntryList;
-       Link = Link->ForwardLink)
-  {
-    Item = CR (Link, MMI_ENTRY, AllEntries, MMI_ENTRY_SIGNATURE);
+  Bucket   = MmiEntryHash (HandlerType);
+  for (Item = mMmiEntryHashTable[Bucket]; Item != NULL; Item = Item->HashNext) {
+    ASSERT (Item->Signature == MMI_ENTRY_SIGNATURE);
     if (CompareGuid (&Item->HandlerType, HandlerType)) {
       //
       // This is the MMI entry
@@ -132,9 +182,11 @@ MmCoreFindMmiEntry (
       InitializeListHead (&MmiEntry->MmiHandlers);
 
       //
-      // Add it to MMI entry list
+      // Add it to MMI entry list and hash table
       //
       InsertTailList (&mMmiEntryList, &MmiEntry->AllEntries);
+      MmiEntry->HashNext         = mMmiEntryHashTable[Bucket];
+      mMmiEntryHashTable[Bucket] = MmiEntry;
     }
   }
 
@@ -283,7 +335,9 @@ MmiManage (
   // marked as ToRemove.
   // Note that MmiManage can be called recursively.
   //
-  if (mMmiManageCallingDepth == 0) {
+  if ((mMmiManageCallingDepth == 0) && (mMmiHandlerToRemoveCount != 0)) {
+    mMmiHandlerToRemoveCount = 0;
+
     //
     // Go through all MmiHandler in root Mmi handlers
     //
@@ -436,6 +490,7 @@ MmiHandlerUnRegister (
     // This function is called from MmiManage()
     // Do not delete or remove MmiHandler or MmiEntry now.
     //
+    mMmiHandlerToRemoveCount++;
     return EFI_SUCCESS;
   }
 
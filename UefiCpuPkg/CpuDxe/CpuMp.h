@@ -8,6 +8,8 @@
 
 #pragma once
 
+extern EDKII_MP_TASK_PROTOCOL  mMpTaskTemplate;
+
 /**
   Initialize Multi-processor support.
 
@@ -538,6 +538,8 @@ InitializeMpSupport (
                   &mMpServiceHandle,
                   &gEfiMpServiceProtocolGuid,
                   &mMpServicesTemplate,
+                  &gEdkiiMpTaskProtocolGuid,
+                  &mMpTaskTemplate,
                   NULL
                   );
   ASSERT_EFI_ERROR (Status);
@@ -12,6 +12,7 @@
 #include <PiPei.h>
 
 #include <Ppi/MpServices.h>
+#include <Ppi/MpTask.h>
 #include <Ppi/SecPlatformInformation.h>
 #include <Ppi/SecPlatformInformation2.h>
 #include <Ppi/EndOfPeiPhase.h>
@@ -34,6 +35,7 @@
 #include <Register/Cpuid.h>
 
 extern EFI_PEI_MP_SERVICES_PPI  mMpServicesPpi;
+extern EDKII_PEI_MP_TASK_PPI    mMpTaskPpi;
 
 /**
   This service retrieves the number of logical processor in the platform
@@ -0,0 +1,119 @@
+/** @file
+  EDKII_PEI_MP_TASK_PPI Implementation code.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "CpuMpPei.h"
+
+/**
+  Create an empty task pool. This service may only be called from the BSP.
+
+  @param[in]  This      A pointer to the EDKII_PEI_MP_TASK_PPI instance.
+  @param[out] TaskPool  Returns the handle of the new task pool.
+
+  @retval EFI_SUCCESS             The task pool was created.
+  @retval EFI_INVALID_PARAMETER   TaskPool is NULL.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory for the task pool.
+  @retval EFI_DEVICE_ERROR        The calling processor is an AP.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+PeiCreateTaskPool (
+  IN  EDKII_PEI_MP_TASK_PPI   *This,
+  OUT EDKII_MP_TASK_POOL      *TaskPool
+  )
+{
+  return MpInitLibCreateTaskPool (TaskPool);
+}
+
+/**
+  Queue a batch of tasks into a task pool. This service may only be called
+  from the BSP.
+
+  @param[in] This       A pointer to the EDKII_PEI_MP_TASK_PPI instance.
+  @param[in] TaskPool   The task pool.
+  @param[in] Procedure  The function run for every task of the batch.
+  @param[in] Context    The value passed to Procedure.
+  @param[in] TaskCount  The number of tasks in the batch.
+
+  @retval EFI_SUCCESS             The tasks were queued.
+  @retval EFI_INVALID_PARAMETER   TaskPool or Procedure is NULL, or TaskCount is 0.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory to queue the tasks.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+PeiSubmitTasks (
+  IN EDKII_PEI_MP_TASK_PPI    *This,
+  IN EDKII_MP_TASK_POOL       TaskPool,
+  IN EDKII_MP_TASK_PROCEDURE  Procedure,
+  IN VOID                     *Context   OPTIONAL,
+  IN UINTN                    TaskCount
+  )
+{
+  return MpInitLibSubmitTasks (TaskPool, Procedure, Context, TaskCount);
+}
+
+/**
+  Run all queued tasks of a task pool on all enabled processors and wait for
+  them to finish. This service may only be called from the BSP.
+
+  @param[in]  This                   A pointer to the EDKII_PEI_MP_TASK_PPI instance.
+  @param[in]  TaskPool               The task pool.
+  @param[in]  TimeoutInMicroseconds  The time limit for starting tasks. Zero
+                                     means infinity.
+  @param[out] CompletedTasks         Returns the number of tasks that ran.
+
+  @retval EFI_SUCCESS             All queued tasks ran.
+  @retval EFI_TIMEOUT             The timeout expired before all tasks ran.
+  @retval EFI_INVALID_PARAMETER   TaskPool is NULL.
+  @retval EFI_DEVICE_ERROR        The calling processor is an AP.
+  @retval EFI_NOT_READY           Any enabled AP is busy.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+PeiJoinTasks (
+  IN  EDKII_PEI_MP_TASK_PPI   *This,
+  IN  EDKII_MP_TASK_POOL      TaskPool,
+  IN  UINTN                   TimeoutInMicroseconds,
+  OUT UINTN                   *CompletedTasks OPTIONAL
+  )
+{
+  return MpInitLibJoinTasks (TaskPool, TimeoutInMicroseconds, CompletedTasks);
+}
+
+/**
+  Free a task pool and drop the tasks still queued in it.
+
+  @param[in] This      A pointer to the EDKII_PEI_MP_TASK_PPI instance.
+  @param[in] TaskPool  The task pool.
+
+  @retval EFI_SUCCESS             The task pool was freed.
+  @retval EFI_INVALID_PARAMETER   TaskPool is NULL.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+PeiDestroyTaskPool (
+  IN EDKII_PEI_MP_TASK_PPI   *This,
+  IN EDKII_MP_TASK_POOL      TaskPool
+  )
+{
+  return MpInitLibDestroyTaskPool (TaskPool);
+}
+
+EDKII_PEI_MP_TASK_PPI  mMpTaskPpi = {
+  PeiCreateTaskPool,
+  PeiSubmitTasks,
+  PeiJoinTasks,
+  PeiDestroyTaskPool
+};
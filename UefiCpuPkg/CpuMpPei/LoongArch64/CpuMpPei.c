@@ -15,6 +15,11 @@ EFI_PEI_PPI_DESCRIPTOR  mPeiCpuMpPpiList[] = {
     &gEfiPeiMpServices2PpiGuid,
     &mMpServices2Ppi
   },
+  {
+    EFI_PEI_PPI_DESCRIPTOR_PPI,
+    &gEdkiiPeiMpTaskPpiGuid,
+    &mMpTaskPpi
+  },
   {
     (EFI_PEI_PPI_DESCRIPTOR_PPI | EFI_PEI_PPI_DESCRIPTOR_TERMINATE_LIST),
     &gEfiPeiMpServicesPpiGuid,
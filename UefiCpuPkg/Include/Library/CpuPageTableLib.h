@@ -141,3 +141,89 @@ PageTableParse (
   OUT    IA32_MAP_ENTRY  *Map,
   IN OUT UINTN           *MapCount
   );
+
+typedef struct {
+  UINT64                LinearAddress;
+  UINT64                Length;
+  IA32_MAP_ATTRIBUTE    Attribute;
+  IA32_MAP_ATTRIBUTE    Mask;
+} IA32_MAP_REQUEST;
+
+/**
+  Create or update page table to map multiple linear address ranges with specified attributes.
+
+  All ranges are checked and the buffer required by all of them is calculated before the page table is
+  modified, so the page table is either updated for all ranges or not updated at all.
+  The ranges must be sorted by LinearAddress and must not overlap.
+
+  @param[in, out] PageTable      The pointer to the page table to update, or pointer to NULL if a new page table is to be created.
+                                 If not pointer to NULL, the value it points to won't be changed in this function.
+  @param[in]      PagingMode     The paging mode.
+  @param[in]      Buffer         The free buffer to be used for page table creation/updating.
+  @param[in, out] BufferSize     The buffer size.
+                                 On return, the remaining buffer size.
+                                 The free buffer is used from the end so caller can supply the same Buffer pointer with an updated
+                                 BufferSize in the second call to this API.
+  @param[in]      Requests       Pointer to an array that describes the linear address ranges to map.
+                                 The Attribute and Mask of each range are used in the same way as PageTableMap().
+                                 The ranges with 0 Length are ignored.
+  @param[in]      RequestCount   The number of entries in Requests.
+  @param[out]     IsModified     TRUE means page table is modified by software or hardware. FALSE means page table is not modified by software.
+                                 If the output IsModified is FALSE, there is possibility that the page table is changed by hardware. It is ok
+                                 because page table can be changed by hardware anytime, and caller don't need to Flush TLB.
+
+  @retval RETURN_UNSUPPORTED        PagingMode is not supported.
+  @retval RETURN_INVALID_PARAMETER  PageTable or BufferSize is NULL, or RequestCount is not 0 but Requests is NULL.
+  @retval RETURN_INVALID_PARAMETER  The ranges are not sorted by LinearAddress or they overlap.
+  @retval RETURN_INVALID_PARAMETER  Any range is invalid for PageTableMap().
+  @retval RETURN_BUFFER_TOO_SMALL   The buffer is too small for page table creation/updating.
+                                    BufferSize is updated to indicate the expected buffer size.
+                                    The expected buffer size is the sum of the buffer size required by every range,
+                                    so it may be larger than the buffer used by the page table update.
+  @retval RETURN_SUCCESS            PageTable is created/updated successfully or RequestCount is 0.
+**/
+RETURN_STATUS
+EFIAPI
+PageTableMapBatch (
+  IN OUT UINTN             *PageTable  OPTIONAL,
+  IN     PAGING_MODE       PagingMode,
+  IN     VOID              *Buffer,
+  IN OUT UINTN             *BufferSize,
+  IN     IA32_MAP_REQUEST  *Requests,
+  IN     UINTN             RequestCount,
+  OUT    BOOLEAN           *IsModified   OPTIONAL
+  );
+
+/**
+  Compact page table by replacing the page directories that can be described by one entry.
+
+  A page directory is replaced by a 2M/1G leaf entry when all its entries are leaf entries that map contiguous
+  physical memory, aligned on the size of the new leaf entry, with the same attribute. The Accessed and Dirty
+  attributes are merged in the new leaf entry. A page directory whose entries are all non-present is replaced
+  by a non-present entry.
+  The caller is responsible for flushing the TLB when the page table is modified.
+
+  @param[in]      PageTable       The page table to compact.
+  @param[in]      PagingMode      The paging mode.
+  @param[out]     FreeTables      Return an array of the addresses of the page directories that are no longer referenced
+                                  by the page table. NULL means the caller doesn't free the page directories.
+  @param[in, out] FreeTableCount  On input, the maximum number of entries that FreeTables can hold.
+                                  On output, the number of page directories that are no longer referenced by the page table.
+  @param[out]     IsModified      TRUE means page table is modified. FALSE means page table is not modified.
+
+  @retval RETURN_UNSUPPORTED        PagingMode is not supported.
+  @retval RETURN_INVALID_PARAMETER  FreeTables is not NULL but FreeTableCount is NULL.
+  @retval RETURN_INVALID_PARAMETER  *FreeTableCount is not 0 but FreeTables is NULL.
+  @retval RETURN_BUFFER_TOO_SMALL   FreeTables is full. The page table is partially compacted.
+                                    Caller can free the returned page directories and call this API again.
+  @retval RETURN_SUCCESS            PageTable is compacted successfully.
+**/
+RETURN_STATUS
+EFIAPI
+PageTableCompact (
+  IN     UINTN        PageTable,
+  IN     PAGING_MODE  PagingMode,
+  OUT    UINTN        *FreeTables      OPTIONAL,
+  IN OUT UINTN        *FreeTableCount  OPTIONAL,
+  OUT    BOOLEAN      *IsModified      OPTIONAL
+  );
@@ -10,6 +10,7 @@
 
 #include <Ppi/SecPlatformInformation.h>
 #include <Protocol/MpService.h>
+#include <Protocol/MpTask.h>
 
 /**
   MP Initialize Library initialization.
@@ -378,3 +379,93 @@ MpInitLibStartupAllCPUs (
   IN  UINTN             TimeoutInMicroseconds,
   IN  VOID              *ProcedureArgument      OPTIONAL
   );
+
+/**
+  Create an empty task pool for MpInitLibSubmitTasks() and MpInitLibJoinTasks().
+  This service may only be called from the BSP.
+
+  @param[out] TaskPool  Returns the handle of the new task pool.
+
+  @retval EFI_SUCCESS             The task pool was created.
+  @retval EFI_INVALID_PARAMETER   TaskPool is NULL.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory for the task pool.
+  @retval EFI_DEVICE_ERROR        The calling processor is an AP.
+  @retval EFI_NOT_READY           MP Initialize Library is not initialized.
+
+**/
+EFI_STATUS
+EFIAPI
+MpInitLibCreateTaskPool (
+  OUT EDKII_MP_TASK_POOL  *TaskPool
+  );
+
+/**
+  Queue a batch of tasks into a task pool. The tasks do not start before the
+  pool is joined by MpInitLibJoinTasks(). This service may only be called from
+  the BSP.
+
+  @param[in] TaskPool   The task pool.
+  @param[in] Procedure  The function run for every task of the batch.
+  @param[in] Context    The value passed to Procedure.
+  @param[in] TaskCount  The number of tasks in the batch.
+
+  @retval EFI_SUCCESS             The tasks were queued.
+  @retval EFI_INVALID_PARAMETER   TaskPool or Procedure is NULL, or TaskCount is 0.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory to queue the tasks.
+
+**/
+EFI_STATUS
+EFIAPI
+MpInitLibSubmitTasks (
+  IN EDKII_MP_TASK_POOL       TaskPool,
+  IN EDKII_MP_TASK_PROCEDURE  Procedure,
+  IN VOID                     *Context   OPTIONAL,
+  IN UINTN                    TaskCount
+  );
+
+/**
+  Run all queued tasks of a task pool on all enabled CPUs and wait for them to
+  finish. This service may only be called from the BSP, which runs tasks as
+  well.
+
+  When the timeout expires no further task is started and the tasks that were
+  not started are dropped. The APs that are still running a task when the
+  timeout expires are stopped as MpInitLibStartupAllCPUs() does, and their
+  tasks are not counted as completed. The pool is empty when this service
+  returns.
+
+  @param[in]  TaskPool               The task pool.
+  @param[in]  TimeoutInMicroseconds  The time limit for starting tasks. Zero
+                                     means infinity.
+  @param[out] CompletedTasks         Returns the number of tasks that ran.
+
+  @retval EFI_SUCCESS             All queued tasks ran.
+  @retval EFI_TIMEOUT             The timeout expired before all tasks ran.
+  @retval EFI_INVALID_PARAMETER   TaskPool is NULL.
+  @retval EFI_DEVICE_ERROR        The calling processor is an AP.
+  @retval EFI_NOT_READY           Any enabled AP is busy. No task was started.
+
+**/
+EFI_STATUS
+EFIAPI
+MpInitLibJoinTasks (
+  IN  EDKII_MP_TASK_POOL  TaskPool,
+  IN  UINTN               TimeoutInMicroseconds,
+  OUT UINTN               *CompletedTasks OPTIONAL
+  );
+
+/**
+  Free a task pool created by MpInitLibCreateTaskPool() and drop the tasks
+  still queued in it.
+
+  @param[in] TaskPool  The task pool.
+
+  @retval EFI_SUCCESS             The task pool was freed.
+  @retval EFI_INVALID_PARAMETER   TaskPool is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+MpInitLibDestroyTaskPool (
+  IN EDKII_MP_TASK_POOL  TaskPool
+  );
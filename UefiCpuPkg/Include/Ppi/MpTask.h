@@ -0,0 +1,24 @@
+/** @file
+  EDK II PEI MP Task PPI definition.
+
+  The PPI provides the same services as the EDK II MP Task protocol to PEIMs.
+  Task pools are allocated from the PEI memory, so the PPI may only be used
+  after permanent memory is installed.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#pragma once
+
+#include <Protocol/MpTask.h>
+
+#define EDKII_PEI_MP_TASK_PPI_GUID \
+  { \
+    0x8900a932, 0x4fe5, 0x4ecd, { 0xb8, 0x64, 0x42, 0x7a, 0xa9, 0x55, 0x03, 0x50 } \
+  }
+
+typedef EDKII_MP_TASK_PROTOCOL EDKII_PEI_MP_TASK_PPI;
+
+extern EFI_GUID  gEdkiiPeiMpTaskPpiGuid;
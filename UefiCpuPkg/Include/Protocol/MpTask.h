@@ -0,0 +1,153 @@
+/** @file
+  EDK II MP Task protocol definition.
+
+  The MP Task protocol runs a large number of small, independent tasks on all
+  enabled processors. Tasks are queued into a task pool and executed when the
+  pool is joined. The BSP and the APs each take tasks from their own queue and
+  steal half of the remaining tasks of another processor when their queue
+  runs empty, so uneven task durations do not leave processors idle.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#pragma once
+
+#define EDKII_MP_TASK_PROTOCOL_GUID \
+  { \
+    0x4b1555a2, 0xeaa7, 0x4a7a, { 0xa3, 0x47, 0xa9, 0xc4, 0xba, 0xa0, 0x77, 0xb2 } \
+  }
+
+typedef struct _EDKII_MP_TASK_PROTOCOL EDKII_MP_TASK_PROTOCOL;
+
+///
+/// Opaque handle of a task pool.
+///
+typedef VOID *EDKII_MP_TASK_POOL;
+
+/**
+  Function run for every task of a batch.
+
+  The function may run on the BSP or on any enabled AP, concurrently with other
+  tasks of the same pool. The same restrictions as for EFI_AP_PROCEDURE apply:
+  it must not call boot services, PEI services, PPIs or protocols unless they
+  are documented as MP safe.
+
+  @param[in] Context    The Context passed to SubmitTasks() for the batch.
+  @param[in] TaskIndex  Index of the task within the batch, from 0 to the
+                        TaskCount passed to SubmitTasks() minus 1.
+
+**/
+typedef
+VOID
+(EFIAPI *EDKII_MP_TASK_PROCEDURE)(
+  IN VOID   *Context,
+  IN UINTN  TaskIndex
+  );
+
+/**
+  Create an empty task pool. This service may only be called from the BSP.
+
+  @param[in]  This      A pointer to the EDKII_MP_TASK_PROTOCOL instance.
+  @param[out] TaskPool  Returns the handle of the new task pool.
+
+  @retval EFI_SUCCESS             The task pool was created.
+  @retval EFI_INVALID_PARAMETER   TaskPool is NULL.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory for the task pool.
+  @retval EFI_DEVICE_ERROR        The calling processor is an AP.
+  @retval EFI_NOT_READY           MP services are not initialized.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_MP_TASK_CREATE_POOL)(
+  IN  EDKII_MP_TASK_PROTOCOL  *This,
+  OUT EDKII_MP_TASK_POOL      *TaskPool
+  );
+
+/**
+  Queue a batch of tasks into a task pool. The tasks do not start before the
+  pool is joined. This service may only be called from the BSP.
+
+  @param[in] This       A pointer to the EDKII_MP_TASK_PROTOCOL instance.
+  @param[in] TaskPool   The task pool.
+  @param[in] Procedure  The function run for every task of the batch.
+  @param[in] Context    The value passed to Procedure.
+  @param[in] TaskCount  The number of tasks in the batch.
+
+  @retval EFI_SUCCESS             The tasks were queued.
+  @retval EFI_INVALID_PARAMETER   TaskPool or Procedure is NULL, or TaskCount is 0.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory to queue the tasks.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_MP_TASK_SUBMIT)(
+  IN EDKII_MP_TASK_PROTOCOL   *This,
+  IN EDKII_MP_TASK_POOL       TaskPool,
+  IN EDKII_MP_TASK_PROCEDURE  Procedure,
+  IN VOID                     *Context   OPTIONAL,
+  IN UINTN                    TaskCount
+  );
+
+/**
+  Run all queued tasks of a task pool on all enabled processors and wait for
+  them to finish. This service may only be called from the BSP, which runs
+  tasks as well.
+
+  When the timeout expires no further task is started and the tasks that were
+  not started are dropped. The APs that are still running a task when the
+  timeout expires are stopped and their tasks are not counted as completed.
+  In both cases the pool is empty and may be reused when this service returns.
+
+  @param[in]  This                   A pointer to the EDKII_MP_TASK_PROTOCOL instance.
+  @param[in]  TaskPool               The task pool.
+  @param[in]  TimeoutInMicroseconds  The time limit for starting tasks. Zero
+                                     means infinity.
+  @param[out] CompletedTasks         Returns the number of tasks that ran.
+
+  @retval EFI_SUCCESS             All queued tasks ran.
+  @retval EFI_TIMEOUT             The timeout expired before all tasks ran.
+  @retval EFI_INVALID_PARAMETER   TaskPool is NULL.
+  @retval EFI_DEVICE_ERROR        The calling processor is an AP.
+  @retval EFI_NOT_READY           Any enabled AP is busy. No task was started.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_MP_TASK_JOIN)(
+  IN  EDKII_MP_TASK_PROTOCOL  *This,
+  IN  EDKII_MP_TASK_POOL      TaskPool,
+  IN  UINTN                   TimeoutInMicroseconds,
+  OUT UINTN                   *CompletedTasks OPTIONAL
+  );
+
+/**
+  Free a task pool and drop the tasks still queued in it.
+
+  @param[in] This      A pointer to the EDKII_MP_TASK_PROTOCOL instance.
+  @param[in] TaskPool  The task pool.
+
+  @retval EFI_SUCCESS             The task pool was freed.
+  @retval EFI_INVALID_PARAMETER   TaskPool is NULL.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EDKII_MP_TASK_DESTROY_POOL)(
+  IN EDKII_MP_TASK_PROTOCOL  *This,
+  IN EDKII_MP_TASK_POOL      TaskPool
+  );
+
+///
+/// Run batches of independent tasks on all enabled processors.
+///
+struct _EDKII_MP_TASK_PROTOCOL {
+  EDKII_MP_TASK_CREATE_POOL     CreatePool;
+  EDKII_MP_TASK_SUBMIT          SubmitTasks;
+  EDKII_MP_TASK_JOIN            JoinTasks;
+  EDKII_MP_TASK_DESTROY_POOL    DestroyPool;
+};
+
+extern EFI_GUID  gEdkiiMpTaskProtocolGuid;
@@ -0,0 +1,315 @@
+/** @file
+  This library implements CpuPageTableLib that are generic for IA32 family CPU.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "CpuPageTable.h"
+
+/**
+  Return the entry that can replace the non-leaf entry referencing a page directory.
+
+  @param[in]  PageTableBaseAddress The base address of the 512 page table entries in the specified level.
+  @param[in]  Level                Page level of the page table entries. Could be 4, 3, 2 or 1.
+  @param[in]  MaxLeafLevel         Maximum level that can be a leaf entry. Could be 1, 2 or 3 (if Page 1G is supported).
+  @param[in]  ParentMapAttribute   The mapping attribute of the parent entries.
+  @param[out] NewEntry             Return the entry that maps the same memory with the same attribute as the page directory.
+
+  @retval TRUE   The page directory can be replaced by NewEntry.
+  @retval FALSE  The page directory cannot be replaced by one entry.
+**/
+BOOLEAN
+PageTableLibGetCompactEntry (
+  IN     UINT64              PageTableBaseAddress,
+  IN     UINTN               Level,
+  IN     UINTN               MaxLeafLevel,
+  IN     IA32_MAP_ATTRIBUTE  *ParentMapAttribute,
+  OUT    IA32_PAGING_ENTRY   *NewEntry
+  )
+{
+  IA32_PAGING_ENTRY   *PagingEntry;
+  UINTN               Index;
+  UINT64              RegionLength;
+  IA32_MAP_ATTRIBUTE  MapAttribute;
+  IA32_MAP_ATTRIBUTE  LeafAttribute;
+  IA32_MAP_ATTRIBUTE  AccessedDirtyMask;
+  IA32_MAP_ATTRIBUTE  AllOneMask;
+
+  PagingEntry = (IA32_PAGING_ENTRY *)(UINTN)PageTableBaseAddress;
+
+  if (PagingEntry[0].Pce.Present == 0) {
+    //
+    // A page directory which maps nothing can be replaced by a non-present entry.
+    //
+    for (Index = 1; Index < 512; Index++) {
+      if (PagingEntry[Index].Pce.Present != 0) {
+        return FALSE;
+      }
+    }
+
+    NewEntry->Uint64 = 0;
+    return TRUE;
+  }
+
+  if (Level + 1 > MaxLeafLevel) {
+    return FALSE;
+  }
+
+  RegionLength                    = REGION_LENGTH (Level);
+  AccessedDirtyMask.Uint64        = 0;
+  AccessedDirtyMask.Bits.Accessed = 1;
+  AccessedDirtyMask.Bits.Dirty    = 1;
+  LeafAttribute.Uint64            = 0;
+
+  for (Index = 0; Index < 512; Index++) {
+    if ((PagingEntry[Index].Pce.Present == 0) || !IsPle (&PagingEntry[Index], Level)) {
+      return FALSE;
+    }
+
+    if (Level == 1) {
+      MapAttribute.Uint64 = PageTableLibGetPte4KMapAttribute (&PagingEntry[Index].Pte4K, ParentMapAttribute);
+    } else {
+      MapAttribute.Uint64 = PageTableLibGetPleBMapAttribute (&PagingEntry[Index].PleB, ParentMapAttribute);
+    }
+
+    if (Index == 0) {
+      //
+      // The physical address of the new leaf entry should be aligned on the region it maps.
+      //
+      if ((IA32_MAP_ATTRIBUTE_PAGE_TABLE_BASE_ADDRESS (&MapAttribute) & (REGION_LENGTH (Level + 1) - 1)) != 0) {
+        return FALSE;
+      }
+
+      LeafAttribute.Uint64 = MapAttribute.Uint64;
+      continue;
+    }
+
+    if (IA32_MAP_ATTRIBUTE_PAGE_TABLE_BASE_ADDRESS (&MapAttribute) !=
+        IA32_MAP_ATTRIBUTE_PAGE_TABLE_BASE_ADDRESS (&LeafAttribute) + MultU64x32 (RegionLength, (UINT32)Index))
+    {
+      return FALSE;
+    }
+
+    //
+    // Accessed and Dirty are set by CPU. They are not taken into account and are merged in the new leaf entry.
+    //
+    if (((IA32_MAP_ATTRIBUTE_ATTRIBUTES (&MapAttribute) ^ IA32_MAP_ATTRIBUTE_ATTRIBUTES (&LeafAttribute)) & ~AccessedDirtyMask.Uint64) != 0) {
+      return FALSE;
+    }
+
+    LeafAttribute.Uint64 |= MapAttribute.Uint64 & AccessedDirtyMask.Uint64;
+  }
+
+  AllOneMask.Uint64 = ~0ull;
+  NewEntry->Uint64  = 0;
+  PageTableLibSetPleB (&NewEntry->PleB, 0, &LeafAttribute, &AllOneMask);
+  return TRUE;
+}
+
+/**
+  Recursively compact the non-leaf page table entries.
+
+  @param[in]      PageTableBaseAddress The base address of the 512 non-leaf page table entries in the specified level.
+  @param[in]      Level                Page level. Could be 5, 4, 3, 2.
+  @param[in]      MaxLevel             Maximum level of the page table.
+  @param[in]      MaxLeafLevel         Maximum level that can be a leaf entry. Could be 1, 2 or 3 (if Page 1G is supported).
+  @param[in]      ParentMapAttribute   The mapping attribute of the parent entries.
+  @param[out]     FreeTables           Pointer to an array that receives the page directories no longer referenced.
+  @param[in]      FreeTableCapacity    The maximum number of entries the FreeTables can hold.
+  @param[in, out] FreeTableCount       Pointer to a UINTN that hold the number of page directories no longer referenced.
+  @param[in, out] IsModified           Change IsModified to TRUE if page table is modified.
+
+  @retval RETURN_BUFFER_TOO_SMALL  FreeTables is full.
+  @retval RETURN_SUCCESS           The page table entries are compacted successfully.
+**/
+RETURN_STATUS
+PageTableLibCompactPnle (
+  IN     UINT64              PageTableBaseAddress,
+  IN     UINTN               Level,
+  IN     UINTN               MaxLevel,
+  IN     UINTN               MaxLeafLevel,
+  IN     IA32_MAP_ATTRIBUTE  *ParentMapAttribute,
+  OUT    UINTN               *FreeTables,
+  IN     UINTN               FreeTableCapacity,
+  IN OUT UINTN               *FreeTableCount,
+  IN OUT BOOLEAN             *IsModified
+  )
+{
+  RETURN_STATUS       Status;
+  IA32_PAGING_ENTRY   *PagingEntry;
+  UINTN               Index;
+  IA32_MAP_ATTRIBUTE  MapAttribute;
+  UINTN               PagingEntryNumber;
+  UINT64              ChildPageTableBaseAddress;
+  IA32_PAGING_ENTRY   NewEntry;
+
+  PagingEntry       = (IA32_PAGING_ENTRY *)(UINTN)PageTableBaseAddress;
+  PagingEntryNumber = ((MaxLevel == 3) && (Level == 3)) ? MAX_PAE_PDPTE_NUM : 512;
+
+  for (Index = 0; Index < PagingEntryNumber; Index++) {
+    if ((PagingEntry[Index].Pce.Present == 0) || IsPle (&PagingEntry[Index], Level)) {
+      continue;
+    }
+
+    ChildPageTableBaseAddress = IA32_PNLE_PAGE_TABLE_BASE_ADDRESS (&PagingEntry[Index].Pnle);
+    MapAttribute.Uint64       = PageTableLibGetPnleMapAttribute (&PagingEntry[Index].Pnle, ParentMapAttribute);
+
+    //
+    // Compact the child page directories first, so that a page directory whose entries
+    // are all replaced by 2M leaf entries can be replaced by a 1G leaf entry.
+    //
+    if (Level > 2) {
+      Status = PageTableLibCompactPnle (
+                 ChildPageTableBaseAddress,
+                 Level - 1,
+                 MaxLevel,
+                 MaxLeafLevel,
+                 &MapAttribute,
+                 FreeTables,
+                 FreeTableCapacity,
+                 FreeTableCount,
+                 IsModified
+                 );
+      if (RETURN_ERROR (Status)) {
+        return Status;
+      }
+    }
+
+    if (!PageTableLibGetCompactEntry (ChildPageTableBaseAddress, Level - 1, MaxLeafLevel, &MapAttribute, &NewEntry)) {
+      continue;
+    }
+
+    if (FreeTables != NULL) {
+      if (*FreeTableCount >= FreeTableCapacity) {
+        return RETURN_BUFFER_TOO_SMALL;
+      }
+
+      FreeTables[*FreeTableCount] = (UINTN)ChildPageTableBaseAddress;
+    }
+
+    (*FreeTableCount)++;
+    *(volatile UINT64 *)&PagingEntry[Index].Uint64 = NewEntry.Uint64;
+    *IsModified                                    = TRUE;
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Compact page table by replacing the page directories that can be described by one entry.
+
+  A page directory is replaced by a 2M/1G leaf entry when all its entries are leaf entries that map contiguous
+  physical memory, aligned on the size of the new leaf entry, with the same attribute. The Accessed and Dirty
+  attributes are merged in the new leaf entry. A page directory whose entries are all non-present is replaced
+  by a non-present entry.
+  The caller is responsible for flushing the TLB when the page table is modified.
+
+  @param[in]      PageTable       The page table to compact.
+  @param[in]      PagingMode      The paging mode.
+  @param[out]     FreeTables      Return an array of the addresses of the page directories that are no longer referenced
+                                  by the page table. NULL means the caller doesn't free the page directories.
+  @param[in, out] FreeTableCount  On input, the maximum number of entries that FreeTables can hold.
+                                  On output, the number of page directories that are no longer referenced by the page table.
+  @param[out]     IsModified      TRUE means page table is modified. FALSE means page table is not modified.
+
+  @retval RETURN_UNSUPPORTED        PagingMode is not supported.
+  @retval RETURN_INVALID_PARAMETER  FreeTables is not NULL but FreeTableCount is NULL.
+  @retval RETURN_INVALID_PARAMETER  *FreeTableCount is not 0 but FreeTables is NULL.
+  @retval RETURN_BUFFER_TOO_SMALL   FreeTables is full. The page table is partially compacted.
+                                    Caller can free the returned page directories and call this API again.
+  @retval RETURN_SUCCESS            PageTable is compacted successfully.
+**/
+RETURN_STATUS
+EFIAPI
+PageTableCompact (
+  IN     UINTN        PageTable,
+  IN     PAGING_MODE  PagingMode,
+  OUT    UINTN        *FreeTables      OPTIONAL,
+  IN OUT UINTN        *FreeTableCount  OPTIONAL,
+  OUT    BOOLEAN      *IsModified      OPTIONAL
+  )
+{
+  RETURN_STATUS       Status;
+  UINTN               FreeTableCapacity;
+  UINTN               LocalFreeTableCount;
+  BOOLEAN             LocalIsModified;
+  IA32_MAP_ATTRIBUTE  NopAttribute;
+  UINTN               MaxLevel;
+  UINTN               MaxLeafLevel;
+  UINTN               Index;
+  IA32_PAGING_ENTRY   BufferInStack[MAX_PAE_PDPTE_NUM];
+
+  if ((PagingMode == Paging32bit) || (PagingMode >= PagingModeMax)) {
+    //
+    // 32bit paging is never supported.
+    //
+    return RETURN_UNSUPPORTED;
+  }
+
+  if ((FreeTables != NULL) && (FreeTableCount == NULL)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if ((FreeTableCount != NULL) && (*FreeTableCount != 0) && (FreeTables == NULL)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (FreeTableCount == NULL) {
+    FreeTableCount = &LocalFreeTableCount;
+  }
+
+  if (IsModified == NULL) {
+    IsModified = &LocalIsModified;
+  }
+
+  FreeTableCapacity = (FreeTables == NULL) ? 0 : *FreeTableCount;
+  *FreeTableCount   = 0;
+  *IsModified       = FALSE;
+
+  if (PageTable == 0) {
+    return RETURN_SUCCESS;
+  }
+
+  if (PagingMode == PagingPae) {
+    CopyMem (BufferInStack, (VOID *)PageTable, sizeof (BufferInStack));
+    for (Index = 0; Index < MAX_PAE_PDPTE_NUM; Index++) {
+      BufferInStack[Index].Pnle.Bits.ReadWrite      = 1;
+      BufferInStack[Index].Pnle.Bits.UserSupervisor = 1;
+      BufferInStack[Index].Pnle.Bits.Nx             = 0;
+    }
+  }
+
+  NopAttribute.Uint64              = 0;
+  NopAttribute.Bits.Present        = 1;
+  NopAttribute.Bits.ReadWrite      = 1;
+  NopAttribute.Bits.UserSupervisor = 1;
+
+  MaxLeafLevel = (UINT8)PagingMode;
+  MaxLevel     = (UINT8)(PagingMode >> 8);
+  Status       = PageTableLibCompactPnle (
+                   (PagingMode == PagingPae) ? (UINT64)(UINTN)BufferInStack : (UINT64)PageTable,
+                   MaxLevel,
+                   MaxLevel,
+                   MaxLeafLevel,
+                   &NopAttribute,
+                   FreeTables,
+                   FreeTableCapacity,
+                   FreeTableCount,
+                   IsModified
+                   );
+
+  if (PagingMode == PagingPae) {
+    //
+    // PDPTE cannot be a leaf entry in PAE paging. It can only be replaced by a non-present entry.
+    //
+    for (Index = 0; Index < MAX_PAE_PDPTE_NUM; Index++) {
+      if (BufferInStack[Index].Uint64 == 0) {
+        ((IA32_PAGING_ENTRY *)PageTable)[Index].Uint64 = 0;
+      }
+    }
+  }
+
+  return Status;
+}
@@ -648,7 +648,7 @@ PageTableLibMapInLevel (
 }
 
 /**
-  Create or update page table to map [LinearAddress, LinearAddress + Length) with specified attribute.
+  Create or update page table to map multiple linear address ranges with specified attributes.
 
   @param[in, out] PageTable      The pointer to the page table to update, or pointer to NULL if a new page table is to be created.
                                  If not pointer to NULL, the value it points to won't be changed in this function.
@@ -656,43 +656,30 @@ PageTableLibMapInLevel (
   @param[in]      Buffer         The free buffer to be used for page table creation/updating.
   @param[in, out] BufferSize     The buffer size.
                                  On return, the remaining buffer size.
-                                 The free buffer is used from the end so caller can supply the same Buffer pointer with an updated
-                                 BufferSize in the second call to this API.
-  @param[in]      LinearAddress  The start of the linear address range.
-  @param[in]      Length         The length of the linear address range.
-  @param[in]      Attribute      The attribute of the linear address range.
-                                 All non-reserved fields in IA32_MAP_ATTRIBUTE are supported to set in the page table.
-                                 Page table entries that map the linear address range are reset to 0 before set to the new attribute
-                                 when a new physical base address is set.
-  @param[in]      Mask           The mask used for attribute. The corresponding field in Attribute is ignored if that in Mask is 0.
+  @param[in]      Requests       Pointer to an array that describes the linear address ranges to map.
+                                 The ranges must be sorted by LinearAddress and must not overlap.
+                                 The ranges with 0 Length are ignored.
+  @param[in]      RequestCount   The number of entries in Requests.
   @param[out]     IsModified     TRUE means page table is modified by software or hardware. FALSE means page table is not modified by software.
-                                 If the output IsModified is FALSE, there is possibility that the page table is changed by hardware. It is ok
-                                 because page table can be changed by hardware anytime, and caller don't need to Flush TLB.
 
   @retval RETURN_UNSUPPORTED        PagingMode is not supported.
-  @retval RETURN_INVALID_PARAMETER  PageTable, BufferSize, Attribute or Mask is NULL.
-  @retval RETURN_INVALID_PARAMETER  For non-present range, Mask->Bits.Present is 0 but some other attributes are provided.
-  @retval RETURN_INVALID_PARAMETER  For non-present range, Mask->Bits.Present is 1, Attribute->Bits.Present is 1 but some other attributes are not provided.
-  @retval RETURN_INVALID_PARAMETER  For non-present range, Mask->Bits.Present is 1, Attribute->Bits.Present is 0 but some other attributes are provided.
-  @retval RETURN_INVALID_PARAMETER  For present range, Mask->Bits.Present is 1, Attribute->Bits.Present is 0 but some other attributes are provided.
+  @retval RETURN_INVALID_PARAMETER  PageTable or BufferSize is NULL.
+  @retval RETURN_INVALID_PARAMETER  The ranges are not sorted by LinearAddress or they overlap.
+  @retval RETURN_INVALID_PARAMETER  Any range is invalid.
   @retval RETURN_INVALID_PARAMETER  *BufferSize is not multiple of 4KB.
   @retval RETURN_BUFFER_TOO_SMALL   The buffer is too small for page table creation/updating.
                                     BufferSize is updated to indicate the expected buffer size.
-                                    Caller may still get RETURN_BUFFER_TOO_SMALL with the new BufferSize.
-  @retval RETURN_SUCCESS            PageTable is created/updated successfully or the input Length is 0.
+  @retval RETURN_SUCCESS            PageTable is created/updated successfully.
 **/
 RETURN_STATUS
-EFIAPI
-PageTableMap (
-  IN OUT UINTN               *PageTable  OPTIONAL,
-  IN     PAGING_MODE         PagingMode,
-  IN     VOID                *Buffer,
-  IN OUT UINTN               *BufferSize,
-  IN     UINT64              LinearAddress,
-  IN     UINT64              Length,
-  IN     IA32_MAP_ATTRIBUTE  *Attribute,
-  IN     IA32_MAP_ATTRIBUTE  *Mask,
-  OUT    BOOLEAN             *IsModified   OPTIONAL
+PageTableLibMap (
+  IN OUT UINTN             *PageTable  OPTIONAL,
+  IN     PAGING_MODE       PagingMode,
+  IN     VOID              *Buffer,
+  IN OUT UINTN             *BufferSize,
+  IN     IA32_MAP_REQUEST  *Requests,
+  IN     UINTN             RequestCount,
+  OUT    BOOLEAN           *IsModified
   )
 {
   RETURN_STATUS       Status;
@@ -702,15 +689,13 @@ PageTableMap (
   IA32_PAGE_LEVEL     MaxLevel;
   IA32_PAGE_LEVEL     MaxLeafLevel;
   IA32_MAP_ATTRIBUTE  ParentAttribute;
-  BOOLEAN             LocalIsModified;
   UINTN               Index;
+  UINTN               RequestIndex;
+  IA32_MAP_REQUEST    *Request;
+  UINT64              PreviousLimit;
   IA32_PAGING_ENTRY   *PagingEntry;
   UINT8               BufferInStack[SIZE_4KB - 1 + MAX_PAE_PDPTE_NUM * sizeof (IA32_PAGING_ENTRY)];
 
-  if (Length == 0) {
-    return RETURN_SUCCESS;
-  }
-
   if ((PagingMode == Paging32bit) || (PagingMode >= PagingModeMax)) {
     //
     // 32bit paging is never supported.
@@ -718,7 +703,7 @@ PageTableMap (
     return RETURN_UNSUPPORTED;
   }
 
-  if ((PageTable == NULL) || (BufferSize == NULL) || (Attribute == NULL) || (Mask == NULL)) {
+  if ((PageTable == NULL) || (BufferSize == NULL)) {
     return RETURN_INVALID_PARAMETER;
   }
 
@@ -729,34 +714,52 @@ PageTableMap (
     return RETURN_INVALID_PARAMETER;
   }
 
-  if (!IS_ALIGNED ((UINTN)LinearAddress, SIZE_4KB) || !IS_ALIGNED ((UINTN)Length, SIZE_4KB)) {
-    //
-    // LinearAddress and Length should be multiple of 4K.
-    //
-    return RETURN_INVALID_PARAMETER;
-  }
-
   if ((*BufferSize != 0) && (Buffer == NULL)) {
     return RETURN_INVALID_PARAMETER;
   }
 
-  //
-  // If to map [LinearAddress, LinearAddress + Length] as non-present,
-  // all attributes except Present should not be provided.
-  //
-  if ((Attribute->Bits.Present == 0) && (Mask->Bits.Present == 1) && (Mask->Uint64 > 1)) {
-    return RETURN_INVALID_PARAMETER;
-  }
-
   MaxLeafLevel     = (IA32_PAGE_LEVEL)(UINT8)PagingMode;
   MaxLevel         = (IA32_PAGE_LEVEL)(UINT8)(PagingMode >> 8);
   MaxLinearAddress = (PagingMode == PagingPae) ? LShiftU64 (1, 32) : LShiftU64 (1, 12 + MaxLevel * 9);
 
-  if ((LinearAddress > MaxLinearAddress) || (Length > MaxLinearAddress - LinearAddress)) {
+  PreviousLimit = 0;
+  for (RequestIndex = 0; RequestIndex < RequestCount; RequestIndex++) {
+    Request = &Requests[RequestIndex];
+    if (Request->Length == 0) {
+      continue;
+    }
+
+    if (!IS_ALIGNED ((UINTN)Request->LinearAddress, SIZE_4KB) || !IS_ALIGNED ((UINTN)Request->Length, SIZE_4KB)) {
+      //
+      // LinearAddress and Length should be multiple of 4K.
+      //
+      return RETURN_INVALID_PARAMETER;
+    }
+
     //
-    // Maximum linear address is (1 << 32), (1 << 48) or (1 << 57)
+    // If to map [LinearAddress, LinearAddress + Length] as non-present,
+    // all attributes except Present should not be provided.
     //
-    return RETURN_INVALID_PARAMETER;
+    if ((Request->Attribute.Bits.Present == 0) && (Request->Mask.Bits.Present == 1) && (Request->Mask.Uint64 > 1)) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    if ((Request->LinearAddress > MaxLinearAddress) || (Request->Length > MaxLinearAddress - Request->LinearAddress)) {
+      //
+      // Maximum linear address is (1 << 32), (1 << 48) or (1 << 57)
+      //
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    //
+    // The ranges are checked against the page table before any of them is mapped.
+    // It's correct only when the ranges don't overlap.
+    //
+    if (Request->LinearAddress < PreviousLimit) {
+      return RETURN_INVALID_PARAMETER;
+    }
+
+    PreviousLimit = Request->LinearAddress + Request->Length;
   }
 
   TopPagingEntry.Uintn = *PageTable;
@@ -782,10 +785,6 @@ PageTableMap (
     TopPagingEntry.Pce.Nx             = 0;
   }
 
-  if (IsModified == NULL) {
-    IsModified = &LocalIsModified;
-  }
-
   *IsModified = FALSE;
 
   ParentAttribute.Uint64                       = 0;
@@ -797,26 +796,34 @@ PageTableMap (
 
   //
   // Query the required buffer size without modifying the page table.
+  // The size required by every range is accumulated in RequiredSize.
   //
   RequiredSize = 0;
-  Status       = PageTableLibMapInLevel (
-                   &TopPagingEntry,
-                   &ParentAttribute,
-                   FALSE,
-                   NULL,
-                   &RequiredSize,
-                   MaxLevel,
-                   MaxLeafLevel,
-                   LinearAddress,
-                   Length,
-                   0,
-                   Attribute,
-                   Mask,
-                   IsModified
-                   );
-  ASSERT (*IsModified == FALSE);
-  if (RETURN_ERROR (Status)) {
-    return Status;
+  for (RequestIndex = 0; RequestIndex < RequestCount; RequestIndex++) {
+    Request = &Requests[RequestIndex];
+    if (Request->Length == 0) {
+      continue;
+    }
+
+    Status = PageTableLibMapInLevel (
+               &TopPagingEntry,
+               &ParentAttribute,
+               FALSE,
+               NULL,
+               &RequiredSize,
+               MaxLevel,
+               MaxLeafLevel,
+               Request->LinearAddress,
+               Request->Length,
+               0,
+               &Request->Attribute,
+               &Request->Mask,
+               IsModified
+               );
+    ASSERT (*IsModified == FALSE);
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
   }
 
   RequiredSize = -RequiredSize;
@@ -833,23 +840,34 @@ PageTableMap (
   //
   // Update the page table when the supplied buffer is sufficient.
   //
-  Status = PageTableLibMapInLevel (
-             &TopPagingEntry,
-             &ParentAttribute,
-             TRUE,
-             Buffer,
-             (INTN *)BufferSize,
-             MaxLevel,
-             MaxLeafLevel,
-             LinearAddress,
-             Length,
-             0,
-             Attribute,
-             Mask,
-             IsModified
-             );
-
-  if (!RETURN_ERROR (Status)) {
+  Status = RETURN_SUCCESS;
+  for (RequestIndex = 0; RequestIndex < RequestCount; RequestIndex++) {
+    Request = &Requests[RequestIndex];
+    if (Request->Length == 0) {
+      continue;
+    }
+
+    Status = PageTableLibMapInLevel (
+               &TopPagingEntry,
+               &ParentAttribute,
+               TRUE,
+               Buffer,
+               (INTN *)BufferSize,
+               MaxLevel,
+               MaxLeafLevel,
+               Request->LinearAddress,
+               Request->Length,
+               0,
+               &Request->Attribute,
+               &Request->Mask,
+               IsModified
+               );
+    if (RETURN_ERROR (Status)) {
+      break;
+    }
+  }
+
+  if (!RETURN_ERROR (Status) && (TopPagingEntry.Uintn != 0)) {
     PagingEntry = (IA32_PAGING_ENTRY *)(UINTN)(TopPagingEntry.Uintn & IA32_PE_BASE_ADDRESS_MASK_40);
 
     if (PagingMode == PagingPae) {
@@ -881,3 +899,143 @@ PageTableMap (
 
   return Status;
 }
+
+/**
+  Create or update page table to map [LinearAddress, LinearAddress + Length) with specified attribute.
+
+  @param[in, out] PageTable      The pointer to the page table to update, or pointer to NULL if a new page table is to be created.
+                                 If not pointer to NULL, the value it points to won't be changed in this function.
+  @param[in]      PagingMode     The paging mode.
+  @param[in]      Buffer         The free buffer to be used for page table creation/updating.
+  @param[in, out] BufferSize     The buffer size.
+                                 On return, the remaining buffer size.
+                                 The free buffer is used from the end so caller can supply the same Buffer pointer with an updated
+                                 BufferSize in the second call to this API.
+  @param[in]      LinearAddress  The start of the linear address range.
+  @param[in]      Length         The length of the linear address range.
+  @param[in]      Attribute      The attribute of the linear address range.
+                                 All non-reserved fields in IA32_MAP_ATTRIBUTE are supported to set in the page table.
+                                 Page table entries that map the linear address range are reset to 0 before set to the new attribute
+                                 when a new physical base address is set.
+  @param[in]      Mask           The mask used for attribute. The corresponding field in Attribute is ignored if that in Mask is 0.
+  @param[out]     IsModified     TRUE means page table is modified by software or hardware. FALSE means page table is not modified by software.
+                                 If the output IsModified is FALSE, there is possibility that the page table is changed by hardware. It is ok
+                                 because page table can be changed by hardware anytime, and caller don't need to Flush TLB.
+
+  @retval RETURN_UNSUPPORTED        PagingMode is not supported.
+  @retval RETURN_INVALID_PARAMETER  PageTable, BufferSize, Attribute or Mask is NULL.
+  @retval RETURN_INVALID_PARAMETER  For non-present range, Mask->Bits.Present is 0 but some other attributes are provided.
+  @retval RETURN_INVALID_PARAMETER  For non-present range, Mask->Bits.Present is 1, Attribute->Bits.Present is 1 but some other attributes are not provided.
+  @retval RETURN_INVALID_PARAMETER  For non-present range, Mask->Bits.Present is 1, Attribute->Bits.Present is 0 but some other attributes are provided.
+  @retval RETURN_INVALID_PARAMETER  For present range, Mask->Bits.Present is 1, Attribute->Bits.Present is 0 but some other attributes are provided.
+  @retval RETURN_INVALID_PARAMETER  *BufferSize is not multiple of 4KB.
+  @retval RETURN_BUFFER_TOO_SMALL   The buffer is too small for page table creation/updating.
+                                    BufferSize is updated to indicate the expected buffer size.
+                                    Caller may still get RETURN_BUFFER_TOO_SMALL with the new BufferSize.
+  @retval RETURN_SUCCESS            PageTable is created/updated successfully or the input Length is 0.
+**/
+RETURN_STATUS
+EFIAPI
+PageTableMap (
+  IN OUT UINTN               *PageTable  OPTIONAL,
+  IN     PAGING_MODE         PagingMode,
+  IN     VOID                *Buffer,
+  IN OUT UINTN               *BufferSize,
+  IN     UINT64              LinearAddress,
+  IN     UINT64              Length,
+  IN     IA32_MAP_ATTRIBUTE  *Attribute,
+  IN     IA32_MAP_ATTRIBUTE  *Mask,
+  OUT    BOOLEAN             *IsModified   OPTIONAL
+  )
+{
+  IA32_MAP_REQUEST  Request;
+  BOOLEAN           LocalIsModified;
+
+  if (Length == 0) {
+    return RETURN_SUCCESS;
+  }
+
+  if ((PagingMode == Paging32bit) || (PagingMode >= PagingModeMax)) {
+    //
+    // 32bit paging is never supported.
+    //
+    return RETURN_UNSUPPORTED;
+  }
+
+  if ((Attribute == NULL) || (Mask == NULL)) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (IsModified == NULL) {
+    IsModified = &LocalIsModified;
+  }
+
+  Request.LinearAddress    = LinearAddress;
+  Request.Length           = Length;
+  Request.Attribute.Uint64 = Attribute->Uint64;
+  Request.Mask.Uint64      = Mask->Uint64;
+
+  return PageTableLibMap (PageTable, PagingMode, Buffer, BufferSize, &Request, 1, IsModified);
+}
+
+/**
+  Create or update page table to map multiple linear address ranges with specified attributes.
+
+  All ranges are checked and the buffer required by all of them is calculated before the page table is
+  modified, so the page table is either updated for all ranges or not updated at all.
+  The ranges must be sorted by LinearAddress and must not overlap.
+
+  @param[in, out] PageTable      The pointer to the page table to update, or pointer to NULL if a new page table is to be created.
+                                 If not pointer to NULL, the value it points to won't be changed in this function.
+  @param[in]      PagingMode     The paging mode.
+  @param[in]      Buffer         The free buffer to be used for page table creation/updating.
+  @param[in, out] BufferSize     The buffer size.
+                                 On return, the remaining buffer size.
+                                 The free buffer is used from the end so caller can supply the same Buffer pointer with an updated
+                                 BufferSize in the second call to this API.
+  @param[in]      Requests       Pointer to an array that describes the linear address ranges to map.
+                                 The Attribute and Mask of each range are used in the same way as PageTableMap().
+                                 The ranges with 0 Length are ignored.
+  @param[in]      RequestCount   The number of entries in Requests.
+  @param[out]     IsModified     TRUE means page table is modified by software or hardware. FALSE means page table is not modified by software.
+                                 If the output IsModified is FALSE, there is possibility that the page table is changed by hardware. It is ok
+                                 because page table can be changed by hardware anytime, and caller don't need to Flush TLB.
+
+  @retval RETURN_UNSUPPORTED        PagingMode is not supported.
+  @retval RETURN_INVALID_PARAMETER  PageTable or BufferSize is NULL, or RequestCount is not 0 but Requests is NULL.
+  @retval RETURN_INVALID_PARAMETER  The ranges are not sorted by LinearAddress or they overlap.
+  @retval RETURN_INVALID_PARAMETER  Any range is invalid for PageTableMap().
+  @retval RETURN_BUFFER_TOO_SMALL   The buffer is too small for page table creation/updating.
+                                    BufferSize is updated to indicate the expected buffer size.
+                                    The expected buffer size is the sum of the buffer size required by every range,
+                                    so it may be larger than the buffer used by the page table update.
+  @retval RETURN_SUCCESS            PageTable is created/updated successfully or RequestCount is 0.
+**/
+RETURN_STATUS
+EFIAPI
+PageTableMapBatch (
+  IN OUT UINTN             *PageTable  OPTIONAL,
+  IN     PAGING_MODE       PagingMode,
+  IN     VOID              *Buffer,
+  IN OUT UINTN             *BufferSize,
+  IN     IA32_MAP_REQUEST  *Requests,
+  IN     UINTN             RequestCount,
+  OUT    BOOLEAN           *IsModified   OPTIONAL
+  )
+{
+  BOOLEAN  LocalIsModified;
+
+  if (RequestCount == 0) {
+    return RETURN_SUCCESS;
+  }
+
+  if (Requests == NULL) {
+    return RETURN_INVALID_PARAMETER;
+  }
+
+  if (IsModified == NULL) {
+    IsModified = &LocalIsModified;
+  }
+
+  return PageTableLibMap (PageTable, PagingMode, Buffer, BufferSize, Requests, RequestCount, IsModified);
+}
@@ -821,6 +821,252 @@ TestCaseToCheckMapMaskAndAttr (
   return UNIT_TEST_PASSED;
 }
 
+/**
+  Check PageTableMapBatch maps multiple ranges in one call.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestCaseManualMapBatch (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN               PageTable;
+  PAGING_MODE         PagingMode;
+  VOID                *Buffer;
+  UINTN               PageTableBufferSize;
+  IA32_MAP_REQUEST    Requests[3];
+  IA32_MAP_REQUEST    Request;
+  IA32_MAP_ATTRIBUTE  ExpectedMapAttribute;
+  RETURN_STATUS       Status;
+  IA32_MAP_ENTRY      *Map;
+  UINTN               MapCount;
+  BOOLEAN             IsModified;
+
+  PagingMode          = Paging4Level;
+  PageTableBufferSize = 0;
+  PageTable           = 0;
+  Buffer              = NULL;
+  ZeroMem (Requests, sizeof (Requests));
+
+  //
+  // Map [0, 2M] with ReadWrite = 1, [2M+4K, 2M+8K] with ReadWrite = 0 and [1G, 2G] with ReadWrite = 1
+  //
+  Requests[0].LinearAddress            = 0;
+  Requests[0].Length                   = SIZE_2MB;
+  Requests[0].Attribute.Bits.Present   = 1;
+  Requests[0].Attribute.Bits.ReadWrite = 1;
+  Requests[0].Mask.Uint64              = MAX_UINT64;
+
+  Requests[1].LinearAddress          = SIZE_2MB + SIZE_4KB;
+  Requests[1].Length                 = SIZE_4KB;
+  Requests[1].Attribute.Uint64       = SIZE_2MB + SIZE_4KB;
+  Requests[1].Attribute.Bits.Present = 1;
+  Requests[1].Mask.Uint64            = MAX_UINT64;
+
+  Requests[2].LinearAddress            = SIZE_1GB;
+  Requests[2].Length                   = SIZE_1GB;
+  Requests[2].Attribute.Uint64         = SIZE_1GB;
+  Requests[2].Attribute.Bits.Present   = 1;
+  Requests[2].Attribute.Bits.ReadWrite = 1;
+  Requests[2].Mask.Uint64              = MAX_UINT64;
+
+  Status = PageTableMapBatch (&PageTable, PagingMode, Buffer, &PageTableBufferSize, Requests, ARRAY_SIZE (Requests), &IsModified);
+  UT_ASSERT_EQUAL (Status, RETURN_BUFFER_TOO_SMALL);
+  UT_ASSERT_EQUAL (PageTable, 0);
+  Buffer = AllocatePages (EFI_SIZE_TO_PAGES (PageTableBufferSize));
+  Status = PageTableMapBatch (&PageTable, PagingMode, Buffer, &PageTableBufferSize, Requests, ARRAY_SIZE (Requests), &IsModified);
+  UT_ASSERT_EQUAL (Status, RETURN_SUCCESS);
+  UT_ASSERT_EQUAL (IsModified, TRUE);
+  IsPageTableValid (PageTable, PagingMode);
+
+  MapCount = 0;
+  Status   = PageTableParse (PageTable, PagingMode, NULL, &MapCount);
+  UT_ASSERT_EQUAL (Status, RETURN_BUFFER_TOO_SMALL);
+  Map    = AllocatePages (EFI_SIZE_TO_PAGES (MapCount * sizeof (IA32_MAP_ENTRY)));
+  Status = PageTableParse (PageTable, PagingMode, Map, &MapCount);
+  UT_ASSERT_EQUAL (Status, RETURN_SUCCESS);
+  UT_ASSERT_EQUAL (MapCount, 3);
+  UT_ASSERT_EQUAL (Map[0].LinearAddress, 0);
+  UT_ASSERT_EQUAL (Map[0].Length, SIZE_2MB);
+  UT_ASSERT_EQUAL (Map[0].Attribute.Uint64, Requests[0].Attribute.Uint64);
+  UT_ASSERT_EQUAL (Map[1].LinearAddress, SIZE_2MB + SIZE_4KB);
+  UT_ASSERT_EQUAL (Map[1].Length, SIZE_4KB);
+  UT_ASSERT_EQUAL (Map[1].Attribute.Uint64, Requests[1].Attribute.Uint64);
+  UT_ASSERT_EQUAL (Map[2].LinearAddress, SIZE_1GB);
+  UT_ASSERT_EQUAL (Map[2].Length, SIZE_1GB);
+  UT_ASSERT_EQUAL (Map[2].Attribute.Uint64, Requests[2].Attribute.Uint64);
+
+  //
+  // Ranges which are not sorted or overlap are not supported.
+  //
+  Request     = Requests[0];
+  Requests[0] = Requests[1];
+  Requests[1] = Request;
+  Status      = PageTableMapBatch (&PageTable, PagingMode, Buffer, &PageTableBufferSize, Requests, 2, &IsModified);
+  UT_ASSERT_EQUAL (Status, RETURN_INVALID_PARAMETER);
+
+  Requests[0]               = Request;
+  Requests[1].LinearAddress = SIZE_1MB;
+  Status                    = PageTableMapBatch (&PageTable, PagingMode, Buffer, &PageTableBufferSize, Requests, 2, &IsModified);
+  UT_ASSERT_EQUAL (Status, RETURN_INVALID_PARAMETER);
+
+  //
+  // When one range is invalid, no range is mapped.
+  // Set [0, 4K] to ReadWrite = 0 and set [4G, 4G+4K] which is not-present to ReadWrite = 0.
+  //
+  Requests[0].LinearAddress            = 0;
+  Requests[0].Length                   = SIZE_4KB;
+  Requests[0].Attribute.Uint64         = 0;
+  Requests[0].Attribute.Bits.ReadWrite = 0;
+  Requests[0].Mask.Uint64              = 0;
+  Requests[0].Mask.Bits.ReadWrite      = 1;
+  Requests[1]                          = Requests[0];
+  Requests[1].LinearAddress            = SIZE_4GB;
+  Status                               = PageTableMapBatch (&PageTable, PagingMode, Buffer, &PageTableBufferSize, Requests, 2, &IsModified);
+  UT_ASSERT_EQUAL (Status, RETURN_INVALID_PARAMETER);
+  UT_ASSERT_EQUAL (IsModified, FALSE);
+
+  Status = PageTableParse (PageTable, PagingMode, Map, &MapCount);
+  UT_ASSERT_EQUAL (Status, RETURN_SUCCESS);
+  UT_ASSERT_EQUAL (MapCount, 3);
+  ExpectedMapAttribute.Uint64         = 0;
+  ExpectedMapAttribute.Bits.Present   = 1;
+  ExpectedMapAttribute.Bits.ReadWrite = 1;
+  UT_ASSERT_EQUAL (Map[0].Attribute.Uint64, ExpectedMapAttribute.Uint64);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check PageTableCompact merges the split pages back to large pages.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestCaseManualCompact (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN               PageTable;
+  PAGING_MODE         PagingMode;
+  VOID                *Buffer;
+  UINTN               PageTableBufferSize;
+  IA32_MAP_ATTRIBUTE  MapAttribute;
+  IA32_MAP_ATTRIBUTE  MapMask;
+  RETURN_STATUS       Status;
+  IA32_MAP_ENTRY      Map[2];
+  UINTN               MapCount;
+  IA32_PAGING_ENTRY   *PagingEntry;
+  UINTN               FreeTables[2];
+  UINTN               FreeTableCount;
+  BOOLEAN             IsModified;
+
+  PagingMode                  = Paging4Level1GB;
+  PageTableBufferSize         = 0;
+  PageTable                   = 0;
+  Buffer                      = NULL;
+  MapAttribute.Uint64         = 0;
+  MapMask.Uint64              = MAX_UINT64;
+  MapAttribute.Bits.Present   = 1;
+  MapAttribute.Bits.ReadWrite = 1;
+
+  //
+  // Create Page table to cover [0,1G], with ReadWrite = 1. It's mapped by one 1G page.
+  //
+  Status = PageTableMap (&PageTable, PagingMode, Buffer, &PageTableBufferSize, 0, SIZE_1GB, &MapAttribute, &MapMask, NULL);
+  UT_ASSERT_EQUAL (Status, RETURN_BUFFER_TOO_SMALL);
+  Buffer = AllocatePages (EFI_SIZE_TO_PAGES (PageTableBufferSize));
+  Status = PageTableMap (&PageTable, PagingMode, Buffer, &PageTableBufferSize, 0, SIZE_1GB, &MapAttribute, &MapMask, NULL);
+  UT_ASSERT_EQUAL (Status, RETURN_SUCCESS);
+
+  //
+  // Set [4K, 8K] to ReadWrite = 0 and then back to ReadWrite = 1.
+  // The 1G page is split to 2M pages and 4K pages.
+  //
+  MapMask.Uint64              = 0;
+  MapMask.Bits.ReadWrite      = 1;
+  MapAttribute.Bits.ReadWrite = 0;
+  PageTableBufferSize         = 0;
+  Status                      = PageTableMap (&PageTable, PagingMode, NULL, &PageTableBufferSize, SIZE_4KB, SIZE_4KB, &MapAttribute, &MapMask, NULL);
+  UT_ASSERT_EQUAL (Status, RETURN_BUFFER_TOO_SMALL);
+  UT_ASSERT_EQUAL (PageTableBufferSize, 2 * SIZE_4KB);
+  Buffer = AllocatePages (EFI_SIZE_TO_PAGES (PageTableBufferSize));
+  Status = PageTableMap (&PageTable, PagingMode, Buffer, &PageTableBufferSize, SIZE_4KB, SIZE_4KB, &MapAttribute, &MapMask, NULL);
+  UT_ASSERT_EQUAL (Status, RETURN_SUCCESS);
+  MapAttribute.Bits.ReadWrite = 1;
+  Status                      = PageTableMap (&PageTable, PagingMode, NULL, &PageTableBufferSize, SIZE_4KB, SIZE_4KB, &MapAttribute, &MapMask, NULL);
+  UT_ASSERT_EQUAL (Status, RETURN_SUCCESS);
+
+  PagingEntry = (IA32_PAGING_ENTRY *)(UINTN)PageTable;                                       // Get 4 level entry
+  PagingEntry = (IA32_PAGING_ENTRY *)(UINTN)IA32_PNLE_PAGE_TABLE_BASE_ADDRESS (PagingEntry); // Get 3 level entry
+  UT_ASSERT_EQUAL (IsPle (PagingEntry, 3), FALSE);
+
+  //
+  // Compact with room for one page directory only. The 4K page table is freed.
+  //
+  FreeTableCount = 1;
+  Status         = PageTableCompact (PageTable, PagingMode, FreeTables, &FreeTableCount, &IsModified);
+  UT_ASSERT_EQUAL (Status, RETURN_BUFFER_TOO_SMALL);
+  UT_ASSERT_EQUAL (FreeTableCount, 1);
+  UT_ASSERT_EQUAL (IsModified, TRUE);
+  UT_ASSERT_EQUAL (FreeTables[0], (UINTN)Buffer);
+  IsPageTableValid (PageTable, PagingMode);
+
+  //
+  // Compact again. The 2M page directory is freed and [0,1G] is mapped by one 1G page.
+  //
+  FreeTableCount = ARRAY_SIZE (FreeTables);
+  Status         = PageTableCompact (PageTable, PagingMode, FreeTables, &FreeTableCount, &IsModified);
+  UT_ASSERT_EQUAL (Status, RETURN_SUCCESS);
+  UT_ASSERT_EQUAL (FreeTableCount, 1);
+  UT_ASSERT_EQUAL (IsModified, TRUE);
+  UT_ASSERT_EQUAL (FreeTables[0], (UINTN)Buffer + SIZE_4KB);
+  UT_ASSERT_EQUAL (IsPle (PagingEntry, 3), TRUE);
+  IsPageTableValid (PageTable, PagingMode);
+
+  MapCount = ARRAY_SIZE (Map);
+  Status   = PageTableParse (PageTable, PagingMode, Map, &MapCount);
+  UT_ASSERT_EQUAL (Status, RETURN_SUCCESS);
+  UT_ASSERT_EQUAL (MapCount, 1);
+  UT_ASSERT_EQUAL (Map[0].LinearAddress, 0);
+  UT_ASSERT_EQUAL (Map[0].Length, SIZE_1GB);
+  UT_ASSERT_EQUAL (Map[0].Attribute.Uint64, MapAttribute.Uint64);
+
+  //
+  // Nothing is left to compact.
+  //
+  FreeTableCount = ARRAY_SIZE (FreeTables);
+  Status         = PageTableCompact (PageTable, PagingMode, FreeTables, &FreeTableCount, &IsModified);
+  UT_ASSERT_EQUAL (Status, RETURN_SUCCESS);
+  UT_ASSERT_EQUAL (FreeTableCount, 0);
+  UT_ASSERT_EQUAL (IsModified, FALSE);
+
+  return UNIT_TEST_PASSED;
+}
+
 /**
   Initialize the unit test framework, suite, and unit tests for the
   sample unit tests and run the unit tests.
@@ -872,6 +1118,8 @@ UefiTestMain (
   AddTestCase (ManualTestCase, "Check if the parent entry has different Nx attribute", "Manual Test Case6", TestCaseManualChangeNx, NULL, NULL, NULL);
   AddTestCase (ManualTestCase, "Check if the needed size is expected", "Manual Test Case7", TestCaseManualSizeNotMatch, NULL, NULL, NULL);
   AddTestCase (ManualTestCase, "Check MapMask when creating new page table or mapping not-present range", "Manual Test Case8", TestCaseToCheckMapMaskAndAttr, NULL, NULL, NULL);
+  AddTestCase (ManualTestCase, "Check PageTableMapBatch maps multiple ranges in one call", "Manual Test Case9", TestCaseManualMapBatch, NULL, NULL, NULL);
+  AddTestCase (ManualTestCase, "Check PageTableCompact merges the split pages back to large pages", "Manual Test Case10", TestCaseManualCompact, NULL, NULL, NULL);
   //
   // Populate the Random Test Cases.
   //
@@ -634,6 +634,53 @@ GetKeyPointList (
   *Count = TemCount;
 }
 
+/**
+  Map one MAP_ENTRY by PageTableMap() or by PageTableMapBatch() with one range.
+
+  @param[in, out] PageTable     The pointer to the page table to update, or pointer to NULL if a new page table is to be created.
+  @param[in]      PagingMode    The paging mode.
+  @param[in]      Buffer        The free buffer to be used for page table creation/updating.
+  @param[in, out] BufferSize    The buffer size.
+  @param[in]      MapEntry      The linear address range to map.
+  @param[in]      UseBatch      TRUE to use PageTableMapBatch().
+  @param[out]     IsModified    TRUE means page table is modified.
+
+  @return The status returned by PageTableMap() or PageTableMapBatch().
+**/
+RETURN_STATUS
+MapSingleEntry (
+  IN OUT UINTN        *PageTable,
+  IN     PAGING_MODE  PagingMode,
+  IN     VOID         *Buffer,
+  IN OUT UINTN        *BufferSize,
+  IN     MAP_ENTRY    *MapEntry,
+  IN     BOOLEAN      UseBatch,
+  OUT    BOOLEAN      *IsModified
+  )
+{
+  IA32_MAP_REQUEST  Request;
+
+  if (!UseBatch) {
+    return PageTableMap (
+             PageTable,
+             PagingMode,
+             Buffer,
+             BufferSize,
+             MapEntry->LinearAddress,
+             MapEntry->Length,
+             &MapEntry->Attribute,
+             &MapEntry->Mask,
+             IsModified
+             );
+  }
+
+  Request.LinearAddress    = MapEntry->LinearAddress;
+  Request.Length           = MapEntry->Length;
+  Request.Attribute.Uint64 = MapEntry->Attribute.Uint64;
+  Request.Mask.Uint64      = MapEntry->Mask.Uint64;
+  return PageTableMapBatch (PageTable, PagingMode, Buffer, BufferSize, &Request, 1, IsModified);
+}
+
 /**
   Generate random one range with randome attribute, and add it into pagetable
   Compare the key point has same attribute
@@ -680,6 +727,7 @@ SingleMapEntryTest (
   UINT64              LastNotPresentRegionStart;
   BOOLEAN             IsNotPresent;
   BOOLEAN             IsModified;
+  BOOLEAN             UseBatch;
 
   MapsIndex                 = MapEntrys->Count;
   MapCount                  = 0;
@@ -724,18 +772,12 @@ SingleMapEntryTest (
     }
   }
 
+  //
+  // PageTableMapBatch() with one range should behave the same as PageTableMap().
+  //
+  UseBatch            = RandomBoolean (50);
   PageTableBufferSize = 0;
-  Status              = PageTableMap (
-                          PageTable,
-                          PagingMode,
-                          NULL,
-                          &PageTableBufferSize,
-                          LastMapEntry->LinearAddress,
-                          LastMapEntry->Length,
-                          &LastMapEntry->Attribute,
-                          &LastMapEntry->Mask,
-                          &IsModified
-                          );
+  Status              = MapSingleEntry (PageTable, PagingMode, NULL, &PageTableBufferSize, LastMapEntry, UseBatch, &IsModified);
 
   Attribute = &LastMapEntry->Attribute;
   Mask      = &LastMapEntry->Mask;
@@ -786,17 +828,7 @@ SingleMapEntryTest (
     //
     Buffer = PagesRecord->AllocatePagesForPageTable (PagesRecord, EFI_SIZE_TO_PAGES (PageTableBufferSize));
     UT_ASSERT_NOT_NULL (Buffer);
-    Status = PageTableMap (
-               PageTable,
-               PagingMode,
-               Buffer,
-               &PageTableBufferSize,
-               LastMapEntry->LinearAddress,
-               LastMapEntry->Length,
-               &LastMapEntry->Attribute,
-               &LastMapEntry->Mask,
-               &IsModified
-               );
+    Status = MapSingleEntry (PageTable, PagingMode, Buffer, &PageTableBufferSize, LastMapEntry, UseBatch, &IsModified);
   }
 
   if (Status != RETURN_SUCCESS ) {
@@ -904,6 +936,387 @@ RecordAllocatePages (
   return Buffer;
 }
 
+/**
+  Parse the page table to a map.
+
+  @param[in]  PageTable   The page table to parse.
+  @param[in]  PagingMode  The paging mode.
+  @param[out] Map         Return the map allocated from pages. It's NULL when MapCount is 0.
+  @param[out] MapCount    Return the number of entries in the map.
+
+  @retval  UNIT_TEST_PASSED        The page table is parsed successfully.
+**/
+UNIT_TEST_STATUS
+ParsePageTableToMap (
+  IN     UINTN           PageTable,
+  IN     PAGING_MODE     PagingMode,
+  OUT    IA32_MAP_ENTRY  **Map,
+  OUT    UINTN           *MapCount
+  )
+{
+  RETURN_STATUS  Status;
+
+  *Map      = NULL;
+  *MapCount = 0;
+  Status    = PageTableParse (PageTable, PagingMode, NULL, MapCount);
+  if (*MapCount != 0) {
+    UT_ASSERT_EQUAL (Status, RETURN_BUFFER_TOO_SMALL);
+    *Map = AllocatePages (EFI_SIZE_TO_PAGES (*MapCount * sizeof (IA32_MAP_ENTRY)));
+    UT_ASSERT_NOT_NULL (*Map);
+    Status = PageTableParse (PageTable, PagingMode, *Map, MapCount);
+  }
+
+  UT_ASSERT_EQUAL (Status, RETURN_SUCCESS);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check if two maps describe the same mapping.
+  Adjacent entries in one map may be merged in the other map.
+
+  @param[in] Map1          Pointer to the first map.
+  @param[in] MapCount1     The number of entries in the first map.
+  @param[in] Map2          Pointer to the second map.
+  @param[in] MapCount2     The number of entries in the second map.
+  @param[in] IgnoredMask   The attributes not to compare.
+
+  @retval TRUE   The two maps describe the same mapping.
+  @retval FALSE  The two maps describe different mappings.
+**/
+BOOLEAN
+IsSameMapping (
+  IN IA32_MAP_ENTRY  *Map1,
+  IN UINTN           MapCount1,
+  IN IA32_MAP_ENTRY  *Map2,
+  IN UINTN           MapCount2,
+  IN UINT64          IgnoredMask
+  )
+{
+  UINTN   Index1;
+  UINTN   Index2;
+  UINT64  Offset1;
+  UINT64  Offset2;
+  UINT64  Length;
+
+  Index1  = 0;
+  Index2  = 0;
+  Offset1 = 0;
+  Offset2 = 0;
+  while ((Index1 < MapCount1) && (Index2 < MapCount2)) {
+    if (Map1[Index1].LinearAddress + Offset1 != Map2[Index2].LinearAddress + Offset2) {
+      return FALSE;
+    }
+
+    if (IA32_MAP_ATTRIBUTE_PAGE_TABLE_BASE_ADDRESS (&Map1[Index1].Attribute) + Offset1 !=
+        IA32_MAP_ATTRIBUTE_PAGE_TABLE_BASE_ADDRESS (&Map2[Index2].Attribute) + Offset2)
+    {
+      return FALSE;
+    }
+
+    if ((IA32_MAP_ATTRIBUTE_ATTRIBUTES (&Map1[Index1].Attribute) & ~IgnoredMask) != (IA32_MAP_ATTRIBUTE_ATTRIBUTES (&Map2[Index2].Attribute) & ~IgnoredMask)) {
+      return FALSE;
+    }
+
+    Length   = MIN (Map1[Index1].Length - Offset1, Map2[Index2].Length - Offset2);
+    Offset1 += Length;
+    Offset2 += Length;
+    if (Offset1 == Map1[Index1].Length) {
+      Index1++;
+      Offset1 = 0;
+    }
+
+    if (Offset2 == Map2[Index2].Length) {
+      Index2++;
+      Offset2 = 0;
+    }
+  }
+
+  return (BOOLEAN)((Index1 == MapCount1) && (Index2 == MapCount2));
+}
+
+/**
+  Compact the page table and check the mapping is not changed.
+
+  @param[in]  PageTable     The page table to compact.
+  @param[in]  PagingMode    The paging mode.
+  @param[in]  PagesRecord   Used to record memory usage for page table.
+
+  @retval  UNIT_TEST_PASSED        The test is successful.
+**/
+UNIT_TEST_STATUS
+PageTableCompactTest (
+  IN     UINTN                  PageTable,
+  IN     PAGING_MODE            PagingMode,
+  IN     ALLOCATE_PAGE_RECORDS  *PagesRecord
+  )
+{
+  RETURN_STATUS       Status;
+  UNIT_TEST_STATUS    TestStatus;
+  IA32_MAP_ENTRY      *Map;
+  UINTN               MapCount;
+  IA32_MAP_ENTRY      *Map2;
+  UINTN               MapCount2;
+  UINTN               *FreeTables;
+  UINTN               FreeTableCapacity;
+  UINTN               FreeTableCount;
+  UINTN               Index;
+  BOOLEAN             IsModified;
+  IA32_MAP_ATTRIBUTE  AccessedDirtyMask;
+
+  TestStatus = ParsePageTableToMap (PageTable, PagingMode, &Map, &MapCount);
+  if (TestStatus != UNIT_TEST_PASSED) {
+    return TestStatus;
+  }
+
+  //
+  // All page directories are allocated from PagesRecord,
+  // so the number of the allocated pages is enough to hold the page directories to free.
+  //
+  FreeTableCapacity = 1;
+  for (Index = 0; Index < PagesRecord->Count; Index++) {
+    FreeTableCapacity += PagesRecord->Records[Index].Pages;
+  }
+
+  FreeTables = AllocatePages (EFI_SIZE_TO_PAGES (FreeTableCapacity * sizeof (UINTN)));
+  UT_ASSERT_NOT_NULL (FreeTables);
+
+  FreeTableCount = FreeTableCapacity;
+  Status         = PageTableCompact (PageTable, PagingMode, FreeTables, &FreeTableCount, &IsModified);
+  UT_ASSERT_EQUAL (Status, RETURN_SUCCESS);
+  UT_ASSERT_EQUAL (IsModified, (BOOLEAN)(FreeTableCount != 0));
+
+  TestStatus = IsPageTableValid (PageTable, PagingMode);
+  if (TestStatus != UNIT_TEST_PASSED) {
+    return TestStatus;
+  }
+
+  //
+  // The freed page directories should not be referenced by the page table.
+  // Fill them with garbage so that parsing the page table doesn't get the same mapping if they are referenced.
+  //
+  for (Index = 0; Index < FreeTableCount; Index++) {
+    SetMem ((VOID *)FreeTables[Index], SIZE_4KB, 0xFF);
+  }
+
+  TestStatus = ParsePageTableToMap (PageTable, PagingMode, &Map2, &MapCount2);
+  if (TestStatus != UNIT_TEST_PASSED) {
+    return TestStatus;
+  }
+
+  //
+  // Accessed and Dirty attributes are merged in the new leaf entries.
+  //
+  AccessedDirtyMask.Uint64        = 0;
+  AccessedDirtyMask.Bits.Accessed = 1;
+  AccessedDirtyMask.Bits.Dirty    = 1;
+  UT_ASSERT_TRUE (IsSameMapping (Map, MapCount, Map2, MapCount2, AccessedDirtyMask.Uint64));
+
+  //
+  // There is nothing to compact in the second call.
+  //
+  FreeTableCount = FreeTableCapacity;
+  Status         = PageTableCompact (PageTable, PagingMode, FreeTables, &FreeTableCount, &IsModified);
+  UT_ASSERT_EQUAL (Status, RETURN_SUCCESS);
+  UT_ASSERT_EQUAL (FreeTableCount, 0);
+  UT_ASSERT_EQUAL (IsModified, FALSE);
+
+  FreePages (FreeTables, EFI_SIZE_TO_PAGES (FreeTableCapacity * sizeof (UINTN)));
+  if (MapCount != 0) {
+    FreePages (Map, EFI_SIZE_TO_PAGES (MapCount * sizeof (IA32_MAP_ENTRY)));
+  }
+
+  if (MapCount2 != 0) {
+    FreePages (Map2, EFI_SIZE_TO_PAGES (MapCount2 * sizeof (IA32_MAP_ENTRY)));
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Generate random ranges, map them one by one by PageTableMap() in one page table
+  and map them by PageTableMapBatch() in another page table.
+  Compare the two page tables have the same mapping.
+
+  @param[in]  PagingMode    The paging mode.
+  @param[in]  MaxAddress    Max Address.
+  @param[in]  PagesRecord   Used to record memory usage for page table.
+
+  @retval  UNIT_TEST_PASSED        The test is successful.
+**/
+UNIT_TEST_STATUS
+BatchMapEntryTest (
+  IN     PAGING_MODE            PagingMode,
+  IN     UINT64                 MaxAddress,
+  IN     ALLOCATE_PAGE_RECORDS  *PagesRecord
+  )
+{
+  RETURN_STATUS     Status;
+  UNIT_TEST_STATUS  TestStatus;
+  MAP_ENTRYS        *MapEntrys;
+  MAP_ENTRY         *MapEntry;
+  IA32_MAP_REQUEST  Requests[BATCH_MAP_ENTRY_COUNT];
+  IA32_MAP_REQUEST  Request;
+  UINTN             RequestCount;
+  UINTN             Index;
+  UINTN             Index2;
+  UINTN             PageTable;
+  UINTN             PageTable2;
+  UINTN             PageTableBufferSize;
+  VOID              *Buffer;
+  BOOLEAN           IsModified;
+  IA32_MAP_ENTRY    *Map;
+  UINTN             MapCount;
+  IA32_MAP_ENTRY    *Map2;
+  UINTN             MapCount2;
+
+  MapEntrys = AllocatePages (EFI_SIZE_TO_PAGES (BATCH_MAP_ENTRY_COUNT * sizeof (MAP_ENTRY) + sizeof (MAP_ENTRYS)));
+  UT_ASSERT_NOT_NULL (MapEntrys);
+  MapEntrys->Count     = 0;
+  MapEntrys->InitCount = 0;
+  MapEntrys->MaxCount  = BATCH_MAP_ENTRY_COUNT;
+  for (Index = 0; Index < BATCH_MAP_ENTRY_COUNT; Index++) {
+    GenerateSingleRandomMapEntry (MaxAddress, MapEntrys);
+  }
+
+  //
+  // Sort the ranges by LinearAddress. Drop the empty ranges and the ranges overlapping with others.
+  //
+  RequestCount = 0;
+  for (Index = 0; Index < MapEntrys->Count; Index++) {
+    MapEntry = &MapEntrys->Maps[Index];
+    if (MapEntry->Length == 0) {
+      continue;
+    }
+
+    for (Index2 = RequestCount; Index2 > 0; Index2--) {
+      if (Requests[Index2 - 1].LinearAddress < MapEntry->LinearAddress) {
+        break;
+      }
+    }
+
+    if ((Index2 > 0) && (Requests[Index2 - 1].LinearAddress + Requests[Index2 - 1].Length > MapEntry->LinearAddress)) {
+      continue;
+    }
+
+    if ((Index2 < RequestCount) && (MapEntry->LinearAddress + MapEntry->Length > Requests[Index2].LinearAddress)) {
+      continue;
+    }
+
+    CopyMem (&Requests[Index2 + 1], &Requests[Index2], (RequestCount - Index2) * sizeof (IA32_MAP_REQUEST));
+    Requests[Index2].LinearAddress    = MapEntry->LinearAddress;
+    Requests[Index2].Length           = MapEntry->Length;
+    Requests[Index2].Attribute.Uint64 = MapEntry->Attribute.Uint64;
+    Requests[Index2].Mask.Uint64      = MapEntry->Mask.Uint64;
+    RequestCount++;
+  }
+
+  //
+  // Map the ranges one by one. The ranges don't overlap, so a range is valid for
+  // PageTableMapBatch() only when it's valid for PageTableMap(). Drop the invalid ranges.
+  //
+  PageTable = 0;
+  Index2    = 0;
+  for (Index = 0; Index < RequestCount; Index++) {
+    PageTableBufferSize = 0;
+    Status              = PageTableMap (
+                            &PageTable,
+                            PagingMode,
+                            NULL,
+                            &PageTableBufferSize,
+                            Requests[Index].LinearAddress,
+                            Requests[Index].Length,
+                            &Requests[Index].Attribute,
+                            &Requests[Index].Mask,
+                            NULL
+                            );
+    if (Status == RETURN_INVALID_PARAMETER) {
+      continue;
+    }
+
+    if (PageTableBufferSize != 0) {
+      UT_ASSERT_EQUAL (Status, RETURN_BUFFER_TOO_SMALL);
+      Buffer = PagesRecord->AllocatePagesForPageTable (PagesRecord, EFI_SIZE_TO_PAGES (PageTableBufferSize));
+      UT_ASSERT_NOT_NULL (Buffer);
+      Status = PageTableMap (
+                 &PageTable,
+                 PagingMode,
+                 Buffer,
+                 &PageTableBufferSize,
+                 Requests[Index].LinearAddress,
+                 Requests[Index].Length,
+                 &Requests[Index].Attribute,
+                 &Requests[Index].Mask,
+                 NULL
+                 );
+    }
+
+    UT_ASSERT_EQUAL (Status, RETURN_SUCCESS);
+    Requests[Index2++] = Requests[Index];
+  }
+
+  RequestCount = Index2;
+
+  //
+  // Map all the valid ranges in one call.
+  //
+  PageTable2          = 0;
+  PageTableBufferSize = 0;
+  IsModified          = FALSE;
+  Status              = PageTableMapBatch (&PageTable2, PagingMode, NULL, &PageTableBufferSize, Requests, RequestCount, &IsModified);
+  if (PageTableBufferSize != 0) {
+    UT_ASSERT_EQUAL (Status, RETURN_BUFFER_TOO_SMALL);
+    UT_ASSERT_EQUAL (IsModified, FALSE);
+    Buffer = PagesRecord->AllocatePagesForPageTable (PagesRecord, EFI_SIZE_TO_PAGES (PageTableBufferSize));
+    UT_ASSERT_NOT_NULL (Buffer);
+    Status = PageTableMapBatch (&PageTable2, PagingMode, Buffer, &PageTableBufferSize, Requests, RequestCount, &IsModified);
+  }
+
+  UT_ASSERT_EQUAL (Status, RETURN_SUCCESS);
+  UT_ASSERT_EQUAL (IsModified, (BOOLEAN)(RequestCount != 0));
+  TestStatus = IsPageTableValid (PageTable2, PagingMode);
+  if (TestStatus != UNIT_TEST_PASSED) {
+    return TestStatus;
+  }
+
+  TestStatus = ParsePageTableToMap (PageTable, PagingMode, &Map, &MapCount);
+  if (TestStatus != UNIT_TEST_PASSED) {
+    return TestStatus;
+  }
+
+  TestStatus = ParsePageTableToMap (PageTable2, PagingMode, &Map2, &MapCount2);
+  if (TestStatus != UNIT_TEST_PASSED) {
+    return TestStatus;
+  }
+
+  UT_ASSERT_EQUAL (MapCount, MapCount2);
+  UT_ASSERT_MEM_EQUAL (Map, Map2, MapCount * sizeof (IA32_MAP_ENTRY));
+
+  //
+  // The ranges which are not sorted are rejected.
+  //
+  if (RequestCount > 1) {
+    Request     = Requests[0];
+    Requests[0] = Requests[1];
+    Requests[1] = Request;
+
+    PageTableBufferSize = 0;
+    Status              = PageTableMapBatch (&PageTable2, PagingMode, NULL, &PageTableBufferSize, Requests, RequestCount, &IsModified);
+    UT_ASSERT_EQUAL (Status, RETURN_INVALID_PARAMETER);
+  }
+
+  if (MapCount != 0) {
+    FreePages (Map, EFI_SIZE_TO_PAGES (MapCount * sizeof (IA32_MAP_ENTRY)));
+  }
+
+  if (MapCount2 != 0) {
+    FreePages (Map2, EFI_SIZE_TO_PAGES (MapCount2 * sizeof (IA32_MAP_ENTRY)));
+  }
+
+  FreePages (MapEntrys, EFI_SIZE_TO_PAGES (BATCH_MAP_ENTRY_COUNT * sizeof (MAP_ENTRY) + sizeof (MAP_ENTRYS)));
+
+  return UNIT_TEST_PASSED;
+}
+
 /**
   The function is a whole Random test, it will call SingleMapEntryTest for ExpctedEntryNumber times
 
@@ -1003,6 +1416,16 @@ MultipleMapEntryTest (
     }
   }
 
+  TestStatus = PageTableCompactTest (PageTable, PagingMode, PagesRecord);
+  if (TestStatus != UNIT_TEST_PASSED) {
+    return TestStatus;
+  }
+
+  TestStatus = BatchMapEntryTest (PagingMode, MaxAddress, PagesRecord);
+  if (TestStatus != UNIT_TEST_PASSED) {
+    return TestStatus;
+  }
+
   FreePages (
     MapEntrys,
     EFI_SIZE_TO_PAGES (1000*sizeof (MAP_ENTRY) + sizeof (MAP_ENTRYS))
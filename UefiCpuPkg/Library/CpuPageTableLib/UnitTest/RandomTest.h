@@ -45,6 +45,11 @@ typedef struct {
   MAP_ENTRY    Maps[10];
 } MAP_ENTRYS;
 
+//
+// The number of random ranges generated for one PageTableMapBatch() test
+//
+#define BATCH_MAP_ENTRY_COUNT  10
+
 UINT64
 GetEntryFromPageTable (
   IN     UINTN        PageTable,
@@ -742,6 +742,116 @@ PlaceAPInMwaitLoopOrRunLoop (
   }
 }
 
+/**
+  Build the AP tree for all APs that are responsible for the current
+  broadcast StartupAllAPs().
+
+  The APs are placed into the nodes in ascending order of processor number.
+  Node 0 is the BSP, which waits for all APs to arrive at it.
+
+  @param[in] CpuMpData          Pointer to CPU MP Data
+**/
+VOID
+BuildApTree (
+  IN CPU_MP_DATA  *CpuMpData
+  )
+{
+  AP_TREE_NODE  *ApTree;
+  UINTN         ProcessorNumber;
+  UINT32        TreeSize;
+
+  ApTree = CpuMpData->ApTree;
+  ZeroMem (&ApTree[0], sizeof (AP_TREE_NODE));
+  ApTree[0].Node.ProcessorNumber = CpuMpData->BspNumber;
+
+  TreeSize = 1;
+  for (ProcessorNumber = 0; ProcessorNumber < CpuMpData->CpuCount; ProcessorNumber++) {
+    if (!CpuMpData->CpuData[ProcessorNumber].Waiting) {
+      continue;
+    }
+
+    ApTree[TreeSize].Node.Arrived         = 0;
+    ApTree[TreeSize].Node.Expected        = 1;
+    ApTree[TreeSize].Node.ProcessorNumber = (UINT32)ProcessorNumber;
+    ApTree[(TreeSize - 1) / AP_TREE_FAN_OUT].Node.Expected++;
+    CpuMpData->CpuData[ProcessorNumber].ApTreeIndex = TreeSize;
+    TreeSize++;
+  }
+
+  CpuMpData->ApTreeRelay = FALSE;
+  CpuMpData->ApTreeSize  = TreeSize;
+}
+
+/**
+  Stop using the AP tree.
+
+  @param[in] CpuMpData          Pointer to CPU MP Data
+**/
+VOID
+ResetApTree (
+  IN CPU_MP_DATA  *CpuMpData
+  )
+{
+  UINT32  TreeIndex;
+
+  CpuMpData->ApTreeRelay = FALSE;
+  for (TreeIndex = 1; TreeIndex < CpuMpData->ApTreeSize; TreeIndex++) {
+    CpuMpData->CpuData[CpuMpData->ApTree[TreeIndex].Node.ProcessorNumber].ApTreeIndex = 0;
+  }
+
+  CpuMpData->ApTreeSize = 0;
+}
+
+/**
+  Write the start-up signal of the children of an AP tree node.
+
+  @param[in] CpuMpData          Pointer to CPU MP Data
+  @param[in] TreeIndex          The index of the node in the AP tree.
+**/
+VOID
+WakeUpApTreeChildren (
+  IN CPU_MP_DATA  *CpuMpData,
+  IN UINT32       TreeIndex
+  )
+{
+  UINT32  Child;
+  UINT32  LastChild;
+
+  Child     = TreeIndex * AP_TREE_FAN_OUT + 1;
+  LastChild = MIN (Child + AP_TREE_FAN_OUT, CpuMpData->ApTreeSize);
+  for ( ; Child < LastChild; Child++) {
+    *(UINT32 *)CpuMpData->CpuData[CpuMpData->ApTree[Child].Node.ProcessorNumber].StartupApSignal = WAKEUP_AP_SIGNAL;
+  }
+}
+
+/**
+  Arrive at an AP tree node.
+
+  The processor that completes a node arrives at the parent node, so every
+  node is updated by at most AP_TREE_FAN_OUT + 1 processors and the BSP only
+  polls the root node.
+
+  @param[in] CpuMpData          Pointer to CPU MP Data
+  @param[in] TreeIndex          The index of the node in the AP tree.
+**/
+VOID
+ArriveAtApTree (
+  IN CPU_MP_DATA  *CpuMpData,
+  IN UINT32       TreeIndex
+  )
+{
+  AP_TREE_NODE  *ApTree;
+
+  ApTree = CpuMpData->ApTree;
+  while (InterlockedIncrement (&ApTree[TreeIndex].Node.Arrived) == ApTree[TreeIndex].Node.Expected) {
+    if (TreeIndex == 0) {
+      break;
+    }
+
+    TreeIndex = (TreeIndex - 1) / AP_TREE_FAN_OUT;
+  }
+}
+
 /**
   This function will be called from AP reset code if BSP uses WakeUpAP.
 
@@ -765,6 +875,7 @@ ApWakeupFunction (
   UINTN             CurrentApicMode;
   AP_STACK_DATA     *ApStackData;
   UINT32            OriginalValue;
+  UINT32            ApTreeIndex;
 
   //
   // AP's local APIC settings will be lost after received INIT IPI
@@ -829,6 +940,15 @@ ApWakeupFunction (
       RestoreVolatileRegisters (&CpuMpData->CpuData[ProcessorNumber].VolatileRegisters);
 
       if (GetApState (&CpuMpData->CpuData[ProcessorNumber]) == CpuStateReady) {
+        //
+        // Pass the start-up signal on to the children in the AP tree
+        // before running the AP function.
+        //
+        ApTreeIndex = CpuMpData->CpuData[ProcessorNumber].ApTreeIndex;
+        if ((ApTreeIndex != 0) && CpuMpData->ApTreeRelay) {
+          WakeUpApTreeChildren (CpuMpData, ApTreeIndex);
+        }
+
         Procedure = (EFI_AP_PROCEDURE)CpuMpData->CpuData[ProcessorNumber].ApFunction;
         Parameter = (VOID *)CpuMpData->CpuData[ProcessorNumber].ApFunctionArgument;
         if (Procedure != NULL) {
@@ -874,6 +994,11 @@ ApWakeupFunction (
         }
 
         SetApState (&CpuMpData->CpuData[ProcessorNumber], CpuStateFinished);
+
+        if (ApTreeIndex != 0) {
+          CpuMpData->CpuData[ProcessorNumber].ApTreeIndex = 0;
+          ArriveAtApTree (CpuMpData, ApTreeIndex);
+        }
       }
     }
 
@@ -1255,6 +1380,7 @@ WakeUpAP (
   UINTN                          Index;
   CPU_AP_DATA                    *CpuData;
   BOOLEAN                        ResetVectorRequired;
+  BOOLEAN                        ApTreeWakeUp;
   CPU_INFO_IN_HOB                *CpuInfoInHob;
 
   CpuMpData->FinishedCount = 0;
@@ -1280,6 +1406,15 @@ WakeUpAP (
   ExchangeInfo = CpuMpData->MpCpuExchangeInfo;
 
   if (Broadcast) {
+    //
+    // When the APs wait for the start-up signal and an AP tree is built, the
+    // BSP only wakes up the children of the root node and each AP wakes up
+    // its own children, so the start-up signals are written in parallel.
+    //
+    ApTreeWakeUp = (BOOLEAN)((CpuMpData->ApTreeSize > 1) &&
+                             !ResetVectorRequired &&
+                             (CpuMpData->InitFlag == ApInitDone));
+
     for (Index = 0; Index < CpuMpData->CpuCount; Index++) {
       if (Index != CpuMpData->BspNumber) {
         CpuData = &CpuMpData->CpuData[Index];
@@ -1292,15 +1427,24 @@ WakeUpAP (
           continue;
         }
 
+        if (ApTreeWakeUp && (CpuData->ApTreeIndex == 0)) {
+          continue;
+        }
+
         CpuData->ApFunction         = (UINTN)Procedure;
         CpuData->ApFunctionArgument = (UINTN)ProcedureArgument;
         SetApState (CpuData, CpuStateReady);
-        if (CpuMpData->InitFlag == ApInitDone) {
+        if ((CpuMpData->InitFlag == ApInitDone) && !ApTreeWakeUp) {
           *(UINT32 *)CpuData->StartupApSignal = WAKEUP_AP_SIGNAL;
         }
       }
     }
 
+    if (ApTreeWakeUp) {
+      CpuMpData->ApTreeRelay = TRUE;
+      WakeUpApTreeChildren (CpuMpData, 0);
+    }
+
     if (ResetVectorRequired) {
       //
       // For SEV-ES and SEV-SNP, the initial AP boot address will be defined by
@@ -1394,9 +1538,11 @@ WakeUpAP (
           CpuPause ();
         }
       }
-    } else {
+    } else if (!ApTreeWakeUp) {
       //
-      // Wait all APs waken up if this is not the 1st broadcast of SIPI
+      // Wait all APs waken up if this is not the 1st broadcast of SIPI.
+      // With the AP tree, the BSP waits for the APs to arrive at the root
+      // node in CheckAllAPs() instead.
       //
       for (Index = 0; Index < CpuMpData->CpuCount; Index++) {
         CpuData = &CpuMpData->CpuData[Index];
@@ -1842,6 +1988,21 @@ CheckAllAPs (
     return EFI_LOAD_ERROR;
   }
 
+  if (CpuMpData->ApTreeSize != 0) {
+    //
+    // While the AP tree is in use, only its root node is polled. All APs
+    // reach CpuStateFinished before they arrive at the tree, so the APs are
+    // checked once all of them arrived or the timeout expired.
+    //
+    if ((CpuMpData->ApTree[0].Node.Arrived < CpuMpData->ApTree[0].Node.Expected) &&
+        !CheckTimeout (&CpuMpData->CurrentTime, &CpuMpData->TotalTime, CpuMpData->ExpectedTime))
+    {
+      return EFI_NOT_READY;
+    }
+
+    ResetApTree (CpuMpData);
+  }
+
   NextProcessorNumber = 0;
 
   //
@@ -2105,6 +2266,7 @@ MpInitLibInitialize (
   CPU_MP_DATA              *CpuMpData;
   UINT8                    ApLoopMode;
   UINT8                    *MonitorBuffer;
+  AP_TREE_NODE             *ApTree;
   UINT32                   Index, HobIndex;
   UINTN                    ApResetVectorSizeBelow1Mb;
   UINTN                    ApResetVectorSizeAbove1Mb;
@@ -2155,6 +2317,8 @@ MpInitLibInitialize (
   //
   BufferSize += ApStackSize;
   BufferSize += MonitorFilterSize * MaxLogicalProcessorNumber;
+  BufferSize  = ALIGN_VALUE (BufferSize, AP_TREE_NODE_SIZE);
+  BufferSize += sizeof (AP_TREE_NODE) * MaxLogicalProcessorNumber;
   BufferSize += ApResetVectorSizeBelow1Mb;
   BufferSize  = ALIGN_VALUE (BufferSize, 8);
   BufferSize += VolatileRegisters.Idtr.Limit + 1;
@@ -2176,6 +2340,10 @@ MpInitLibInitialize (
   //        AP Stacks (N)                 (StackTop = (RSP + ApStackSize) & ~ApStackSize))
   //    +--------------------+ <-- MonitorBuffer
   //    AP Monitor Filters (N)
+  //    +--------------------+
+  //           Padding
+  //    +--------------------+ <-- ApTree (64-byte boundary)
+  //       AP_TREE_NODE (N)
   //    +--------------------+ <-- BackupBufferAddr (CpuMpData->BackupBuffer)
   //         Backup Buffer
   //    +--------------------+
@@ -2191,13 +2359,15 @@ MpInitLibInitialize (
   //    +--------------------+
   //
   MonitorBuffer               = (UINT8 *)(Buffer + ApStackSize * MaxLogicalProcessorNumber);
-  BackupBufferAddr            = (UINTN)MonitorBuffer + MonitorFilterSize * MaxLogicalProcessorNumber;
+  ApTree                      = (AP_TREE_NODE *)ALIGN_VALUE ((UINTN)MonitorBuffer + MonitorFilterSize * MaxLogicalProcessorNumber, AP_TREE_NODE_SIZE);
+  BackupBufferAddr            = (UINTN)(ApTree + MaxLogicalProcessorNumber);
   ApIdtBase                   = ALIGN_VALUE (BackupBufferAddr + ApResetVectorSizeBelow1Mb, 8);
   CpuMpData                   = (CPU_MP_DATA *)(ApIdtBase + VolatileRegisters.Idtr.Limit + 1);
   CpuMpData->Buffer           = Buffer;
   CpuMpData->CpuApStackSize   = ApStackSize;
   CpuMpData->BackupBuffer     = BackupBufferAddr;
   CpuMpData->BackupBufferSize = ApResetVectorSizeBelow1Mb;
+  CpuMpData->ApTree           = ApTree;
   CpuMpData->WakeupBuffer     = (UINTN)-1;
   CpuMpData->CpuCount         = 1;
   if (FirstMpHandOff == NULL) {
@@ -3111,6 +3281,10 @@ StartupAllCPUsWorker (
   CpuMpData->WaitEvent = WaitEvent;
 
   if (!SingleThread) {
+    if (CpuMpData->RunningCount != 0) {
+      BuildApTree (CpuMpData);
+    }
+
     WakeUpAP (CpuMpData, TRUE, 0, Procedure, ProcedureArgument, FALSE);
   } else {
     for (ProcessorNumber = 0; ProcessorNumber < ProcessorCount; ProcessorNumber++) {
@@ -71,6 +71,19 @@
 
 #define PAGING_4K_ADDRESS_MASK_64  0x000FFFFFFFFFF000ull
 
+//
+// Fan-out of the AP wake-up and completion tree used by broadcast
+// StartupAllAPs(). Node 0 is the BSP, the children of node N are nodes
+// N * AP_TREE_FAN_OUT + 1 .. N * AP_TREE_FAN_OUT + AP_TREE_FAN_OUT.
+//
+#define AP_TREE_FAN_OUT  4
+
+//
+// Node size of the AP tree. Each node occupies its own cache line so that
+// arrivals at different nodes do not contend.
+//
+#define AP_TREE_NODE_SIZE  64
+
 //
 // Data structure for microcode patch information
 //
@@ -161,8 +174,29 @@ typedef struct {
   UINT64                    MicrocodeEntryAddr;
   UINT32                    MicrocodeRevision;
   SEV_ES_SAVE_AREA          *SevEsSaveArea;
+  //
+  // Index of the AP in CPU_MP_DATA.ApTree. 0 when the AP is not part of
+  // the current tree.
+  //
+  volatile UINT32           ApTreeIndex;
 } CPU_AP_DATA;
 
+//
+// AP tree node.
+// Arrived counts the completed subtree members. The node itself (except the
+// root, which is the BSP) and each child subtree arrive once. When Arrived
+// reaches Expected, the whole subtree has finished and the last arriving
+// processor arrives at the parent node.
+//
+typedef union {
+  struct {
+    volatile UINT32    Arrived;
+    UINT32             Expected;
+    UINT32             ProcessorNumber;
+  } Node;
+  UINT8    Padding[AP_TREE_NODE_SIZE];
+} AP_TREE_NODE;
+
 //
 // Basic CPU information saved in Guided HOB.
 // Because the contents will be shard between PEI and DXE,
@@ -331,6 +365,16 @@ struct _CPU_MP_DATA {
   CPU_MP_DATA    *NewCpuMpData;
 
   UINT64         GhcbBase;
+
+  //
+  // Wake-up and completion tree of the APs dispatched by a broadcast
+  // StartupAllAPs(). ApTreeSize is the number of used nodes including the
+  // root and is 0 when no tree is in use. When ApTreeRelay is TRUE, each
+  // woken AP wakes up its children.
+  //
+  AP_TREE_NODE        *ApTree;
+  volatile UINT32     ApTreeSize;
+  volatile BOOLEAN    ApTreeRelay;
 };
 
 //
@@ -0,0 +1,569 @@
+/** @file
+  Work-stealing task pool on top of MpInitLibStartupAllCPUs().
+
+  Every task of a pool has a pool-wide number. MpInitLibJoinTasks() splits the
+  task numbers into one contiguous range per processor and runs MpTaskWorker()
+  on all enabled CPUs. A worker takes tasks from the front of its own range.
+  When the range is empty it steals the back half of the range of another
+  processor, so processors that finish early keep busy and disabled APs do not
+  leave their share behind.
+
+  Only the BSP reads the performance counter. It checks the timeout between
+  the tasks it runs and tells the APs to stop starting new tasks. The remaining
+  timeout is passed to MpInitLibStartupAllCPUs() as well, so an AP stuck in a
+  task does not hang the BSP.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <PiPei.h>
+
+#include <Library/MpInitLib.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Library/TimerLib.h>
+
+#define MP_TASK_POOL_SIGNATURE   SIGNATURE_32 ('M', 'P', 'T', 'P')
+#define MP_TASK_CACHE_LINE_SIZE  64
+#define MP_TASK_INITIAL_BATCHES  8
+
+typedef struct {
+  EDKII_MP_TASK_PROCEDURE    Procedure;
+  VOID                       *Context;
+  //
+  // Pool-wide number of task 0 of the batch.
+  //
+  UINTN                      FirstTask;
+  UINTN                      TaskCount;
+} MP_TASK_BATCH;
+
+//
+// The tasks queued on one processor are the pool-wide task numbers
+// [Head, Tail). The owner takes tasks at Head, thieves take them at Tail.
+// Every queue fills a cache line of its own, so that a processor running its
+// tasks does not disturb the others.
+//
+typedef struct {
+  TICKET_SPIN_LOCK    Lock;
+  volatile UINTN      Head;
+  volatile UINTN      Tail;
+  //
+  // Only written by the owner.
+  //
+  UINTN               CompletedTasks;
+  UINT8               Reserved[MP_TASK_CACHE_LINE_SIZE - sizeof (TICKET_SPIN_LOCK) - 3 * sizeof (UINTN)];
+} MP_TASK_QUEUE;
+
+STATIC_ASSERT (sizeof (MP_TASK_QUEUE) == MP_TASK_CACHE_LINE_SIZE, "MP_TASK_QUEUE must fill one cache line");
+
+typedef struct {
+  UINT32              Signature;
+  UINTN               ProcessorCount;
+  MP_TASK_QUEUE       *Queues;
+  MP_TASK_BATCH       *Batches;
+  UINTN               BatchCount;
+  UINTN               MaxBatches;
+  UINTN               TaskCount;
+  //
+  // State of the running MpInitLibJoinTasks().
+  //
+  UINTN               BspNumber;
+  UINT64              TimeoutInNanoseconds;
+  UINT64              PreviousTime;
+  UINT64              ElapsedTicks;
+  volatile BOOLEAN    Stop;
+} MP_TASK_POOL;
+
+/**
+  Check whether the timeout of the running MpInitLibJoinTasks() expired.
+
+  @param[in, out] Pool  The task pool.
+
+  @retval TRUE   The timeout expired.
+  @retval FALSE  The timeout did not expire, or there is no timeout.
+
+**/
+STATIC
+BOOLEAN
+MpTaskTimedOut (
+  IN OUT MP_TASK_POOL  *Pool
+  )
+{
+  UINT64  Start;
+  UINT64  End;
+  UINT64  CurrentTime;
+  INT64   Delta;
+  INT64   Cycle;
+
+  if (Pool->TimeoutInNanoseconds == 0) {
+    return FALSE;
+  }
+
+  GetPerformanceCounterProperties (&Start, &End);
+  Cycle = End - Start;
+  if (Cycle < 0) {
+    Cycle = -Cycle;
+  }
+
+  Cycle++;
+  CurrentTime = GetPerformanceCounter ();
+  Delta       = (INT64)(CurrentTime - Pool->PreviousTime);
+  if (Start > End) {
+    Delta = -Delta;
+  }
+
+  if (Delta < 0) {
+    Delta += Cycle;
+  }
+
+  Pool->ElapsedTicks += Delta;
+  Pool->PreviousTime  = CurrentTime;
+
+  return (BOOLEAN)(GetTimeInNanoSecond (Pool->ElapsedTicks) >= Pool->TimeoutInNanoseconds);
+}
+
+/**
+  Take the next task from the front of a queue.
+
+  @param[in, out] Queue       The queue.
+  @param[out]     TaskNumber  Returns the pool-wide number of the task.
+
+  @retval TRUE   A task was taken.
+  @retval FALSE  The queue is empty.
+
+**/
+STATIC
+BOOLEAN
+MpTaskPop (
+  IN OUT MP_TASK_QUEUE  *Queue,
+  OUT    UINTN          *TaskNumber
+  )
+{
+  BOOLEAN  Found;
+
+  Found = FALSE;
+  AcquireTicketSpinLock (&Queue->Lock);
+  if (Queue->Head < Queue->Tail) {
+    *TaskNumber = Queue->Head++;
+    Found       = TRUE;
+  }
+
+  ReleaseTicketSpinLock (&Queue->Lock);
+  return Found;
+}
+
+/**
+  Steal the back half of the queue of another processor, keep the first stolen
+  task and queue the others on the calling processor.
+
+  @param[in, out] Pool             The task pool.
+  @param[in]      ProcessorNumber  The calling processor.
+  @param[out]     TaskNumber       Returns the pool-wide number of the task.
+
+  @retval TRUE   A task was stolen.
+  @retval FALSE  The queues of all processors are empty.
+
+**/
+STATIC
+BOOLEAN
+MpTaskSteal (
+  IN OUT MP_TASK_POOL  *Pool,
+  IN     UINTN         ProcessorNumber,
+  OUT    UINTN         *TaskNumber
+  )
+{
+  UINTN          Index;
+  MP_TASK_QUEUE  *Victim;
+  MP_TASK_QUEUE  *Queue;
+  UINTN          Count;
+  UINTN          First;
+  UINTN          Last;
+
+  for (Index = 1; Index < Pool->ProcessorCount; Index++) {
+    Victim = &Pool->Queues[(ProcessorNumber + Index) % Pool->ProcessorCount];
+
+    //
+    // Skip empty queues without taking their lock.
+    //
+    if (Victim->Head >= Victim->Tail) {
+      continue;
+    }
+
+    Count = 0;
+    AcquireTicketSpinLock (&Victim->Lock);
+    if (Victim->Head < Victim->Tail) {
+      Count         = (Victim->Tail - Victim->Head + 1) / 2;
+      Last          = Victim->Tail;
+      Victim->Tail -= Count;
+      First         = Victim->Tail;
+    }
+
+    ReleaseTicketSpinLock (&Victim->Lock);
+
+    if (Count != 0) {
+      Queue = &Pool->Queues[ProcessorNumber];
+      AcquireTicketSpinLock (&Queue->Lock);
+      Queue->Head = First + 1;
+      Queue->Tail = Last;
+      ReleaseTicketSpinLock (&Queue->Lock);
+
+      *TaskNumber = First;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Run one task.
+
+  @param[in] Pool        The task pool.
+  @param[in] TaskNumber  The pool-wide number of the task.
+
+**/
+STATIC
+VOID
+MpTaskRun (
+  IN MP_TASK_POOL  *Pool,
+  IN UINTN         TaskNumber
+  )
+{
+  UINTN          Low;
+  UINTN          High;
+  UINTN          Middle;
+  MP_TASK_BATCH  *Batch;
+
+  //
+  // Batches are sorted by FirstTask. Find the last batch starting at or
+  // before TaskNumber.
+  //
+  Low  = 0;
+  High = Pool->BatchCount - 1;
+  while (Low < High) {
+    Middle = (Low + High + 1) / 2;
+    if (Pool->Batches[Middle].FirstTask <= TaskNumber) {
+      Low = Middle;
+    } else {
+      High = Middle - 1;
+    }
+  }
+
+  Batch = &Pool->Batches[Low];
+  ASSERT (TaskNumber - Batch->FirstTask < Batch->TaskCount);
+  Batch->Procedure (Batch->Context, TaskNumber - Batch->FirstTask);
+}
+
+/**
+  Run tasks of a pool until no task is left or the timeout expired. Runs on
+  the BSP and on all enabled APs.
+
+  @param[in, out] Buffer  The task pool.
+
+**/
+STATIC
+VOID
+EFIAPI
+MpTaskWorker (
+  IN OUT VOID  *Buffer
+  )
+{
+  MP_TASK_POOL   *Pool;
+  MP_TASK_QUEUE  *Queue;
+  UINTN          ProcessorNumber;
+  UINTN          TaskNumber;
+
+  Pool = (MP_TASK_POOL *)Buffer;
+  if (EFI_ERROR (MpInitLibWhoAmI (&ProcessorNumber)) || (ProcessorNumber >= Pool->ProcessorCount)) {
+    return;
+  }
+
+  Queue = &Pool->Queues[ProcessorNumber];
+  while (!Pool->Stop) {
+    if (!MpTaskPop (Queue, &TaskNumber) && !MpTaskSteal (Pool, ProcessorNumber, &TaskNumber)) {
+      break;
+    }
+
+    MpTaskRun (Pool, TaskNumber);
+    Queue->CompletedTasks++;
+
+    if ((ProcessorNumber == Pool->BspNumber) && MpTaskTimedOut (Pool)) {
+      Pool->Stop = TRUE;
+    }
+  }
+}
+
+/**
+  Create an empty task pool for MpInitLibSubmitTasks() and MpInitLibJoinTasks().
+  This service may only be called from the BSP.
+
+  @param[out] TaskPool  Returns the handle of the new task pool.
+
+  @retval EFI_SUCCESS             The task pool was created.
+  @retval EFI_INVALID_PARAMETER   TaskPool is NULL.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory for the task pool.
+  @retval EFI_DEVICE_ERROR        The calling processor is an AP.
+  @retval EFI_NOT_READY           MP Initialize Library is not initialized.
+
+**/
+EFI_STATUS
+EFIAPI
+MpInitLibCreateTaskPool (
+  OUT EDKII_MP_TASK_POOL  *TaskPool
+  )
+{
+  EFI_STATUS    Status;
+  MP_TASK_POOL  *Pool;
+  UINTN         ProcessorCount;
+  UINTN         Index;
+
+  if (TaskPool == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = MpInitLibGetNumberOfProcessors (&ProcessorCount, NULL);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Pool = AllocateZeroPool (sizeof (MP_TASK_POOL));
+  if (Pool == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Pages keep every queue aligned on a cache line.
+  //
+  Pool->Queues  = AllocatePages (EFI_SIZE_TO_PAGES (ProcessorCount * sizeof (MP_TASK_QUEUE)));
+  Pool->Batches = AllocatePool (MP_TASK_INITIAL_BATCHES * sizeof (MP_TASK_BATCH));
+  if ((Pool->Queues == NULL) || (Pool->Batches == NULL)) {
+    if (Pool->Queues != NULL) {
+      FreePages (Pool->Queues, EFI_SIZE_TO_PAGES (ProcessorCount * sizeof (MP_TASK_QUEUE)));
+    }
+
+    if (Pool->Batches != NULL) {
+      FreePool (Pool->Batches);
+    }
+
+    FreePool (Pool);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Index = 0; Index < ProcessorCount; Index++) {
+    InitializeTicketSpinLock (&Pool->Queues[Index].Lock);
+    Pool->Queues[Index].Head           = 0;
+    Pool->Queues[Index].Tail           = 0;
+    Pool->Queues[Index].CompletedTasks = 0;
+  }
+
+  Pool->Signature      = MP_TASK_POOL_SIGNATURE;
+  Pool->ProcessorCount = ProcessorCount;
+  Pool->MaxBatches     = MP_TASK_INITIAL_BATCHES;
+
+  *TaskPool = Pool;
+  return EFI_SUCCESS;
+}
+
+/**
+  Queue a batch of tasks into a task pool. The tasks do not start before the
+  pool is joined by MpInitLibJoinTasks(). This service may only be called from
+  the BSP.
+
+  @param[in] TaskPool   The task pool.
+  @param[in] Procedure  The function run for every task of the batch.
+  @param[in] Context    The value passed to Procedure.
+  @param[in] TaskCount  The number of tasks in the batch.
+
+  @retval EFI_SUCCESS             The tasks were queued.
+  @retval EFI_INVALID_PARAMETER   TaskPool or Procedure is NULL, or TaskCount is 0.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory to queue the tasks.
+
+**/
+EFI_STATUS
+EFIAPI
+MpInitLibSubmitTasks (
+  IN EDKII_MP_TASK_POOL       TaskPool,
+  IN EDKII_MP_TASK_PROCEDURE  Procedure,
+  IN VOID                     *Context   OPTIONAL,
+  IN UINTN                    TaskCount
+  )
+{
+  MP_TASK_POOL   *Pool;
+  MP_TASK_BATCH  *Batches;
+
+  Pool = (MP_TASK_POOL *)TaskPool;
+  if ((Pool == NULL) || (Pool->Signature != MP_TASK_POOL_SIGNATURE) ||
+      (Procedure == NULL) || (TaskCount == 0))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (TaskCount > MAX_UINTN - Pool->TaskCount) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  if (Pool->BatchCount == Pool->MaxBatches) {
+    Batches = ReallocatePool (
+                Pool->MaxBatches * sizeof (MP_TASK_BATCH),
+                2 * Pool->MaxBatches * sizeof (MP_TASK_BATCH),
+                Pool->Batches
+                );
+    if (Batches == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    Pool->Batches     = Batches;
+    Pool->MaxBatches *= 2;
+  }
+
+  Pool->Batches[Pool->BatchCount].Procedure = Procedure;
+  Pool->Batches[Pool->BatchCount].Context   = Context;
+  Pool->Batches[Pool->BatchCount].FirstTask = Pool->TaskCount;
+  Pool->Batches[Pool->BatchCount].TaskCount = TaskCount;
+  Pool->BatchCount++;
+  Pool->TaskCount += TaskCount;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Run all queued tasks of a task pool on all enabled CPUs and wait for them to
+  finish. This service may only be called from the BSP, which runs tasks as
+  well.
+
+  When the timeout expires no further task is started and the tasks that were
+  not started are dropped. The APs that are still running a task when the
+  timeout expires are stopped as MpInitLibStartupAllCPUs() does, and their
+  tasks are not counted as completed. The pool is empty when this service
+  returns.
+
+  @param[in]  TaskPool               The task pool.
+  @param[in]  TimeoutInMicroseconds  The time limit for starting tasks. Zero
+                                     means infinity.
+  @param[out] CompletedTasks         Returns the number of tasks that ran.
+
+  @retval EFI_SUCCESS             All queued tasks ran.
+  @retval EFI_TIMEOUT             The timeout expired before all tasks ran.
+  @retval EFI_INVALID_PARAMETER   TaskPool is NULL.
+  @retval EFI_DEVICE_ERROR        The calling processor is an AP.
+  @retval EFI_NOT_READY           Any enabled AP is busy. No task was started.
+
+**/
+EFI_STATUS
+EFIAPI
+MpInitLibJoinTasks (
+  IN  EDKII_MP_TASK_POOL  TaskPool,
+  IN  UINTN               TimeoutInMicroseconds,
+  OUT UINTN               *CompletedTasks OPTIONAL
+  )
+{
+  EFI_STATUS    Status;
+  MP_TASK_POOL  *Pool;
+  UINTN         Index;
+  UINTN         Share;
+  UINTN         Extra;
+  UINTN         NextTask;
+  UINTN         Completed;
+  UINT64        RemainingTimeout;
+
+  Pool = (MP_TASK_POOL *)TaskPool;
+  if ((Pool == NULL) || (Pool->Signature != MP_TASK_POOL_SIGNATURE)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (CompletedTasks != NULL) {
+    *CompletedTasks = 0;
+  }
+
+  Status = MpInitLibWhoAmI (&Pool->BspNumber);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (Pool->TaskCount == 0) {
+    return EFI_SUCCESS;
+  }
+
+  Pool->TimeoutInNanoseconds = MultU64x32 (TimeoutInMicroseconds, 1000);
+  Pool->PreviousTime         = GetPerformanceCounter ();
+  Pool->ElapsedTicks         = 0;
+  Pool->Stop                 = FALSE;
+
+  Share    = Pool->TaskCount / Pool->ProcessorCount;
+  Extra    = Pool->TaskCount % Pool->ProcessorCount;
+  NextTask = 0;
+  for (Index = 0; Index < Pool->ProcessorCount; Index++) {
+    Pool->Queues[Index].Head           = NextTask;
+    NextTask                          += Share + ((Index < Extra) ? 1 : 0);
+    Pool->Queues[Index].Tail           = NextTask;
+    Pool->Queues[Index].CompletedTasks = 0;
+  }
+
+  //
+  // The BSP stops starting tasks when the timeout expires. The APs get the
+  // rest of the timeout to finish the tasks they run.
+  //
+  RemainingTimeout = 0;
+  if (TimeoutInMicroseconds != 0) {
+    if (MpTaskTimedOut (Pool)) {
+      Pool->BatchCount = 0;
+      Pool->TaskCount  = 0;
+      return EFI_TIMEOUT;
+    }
+
+    RemainingTimeout = TimeoutInMicroseconds - DivU64x32 (GetTimeInNanoSecond (Pool->ElapsedTicks), 1000);
+  }
+
+  Status = MpInitLibStartupAllCPUs (MpTaskWorker, (UINTN)RemainingTimeout, Pool);
+  if (EFI_ERROR (Status) && (Status != EFI_TIMEOUT)) {
+    return Status;
+  }
+
+  Completed = 0;
+  for (Index = 0; Index < Pool->ProcessorCount; Index++) {
+    Completed += Pool->Queues[Index].CompletedTasks;
+  }
+
+  if (CompletedTasks != NULL) {
+    *CompletedTasks = Completed;
+  }
+
+  Status           = ((Status == EFI_TIMEOUT) || (Completed != Pool->TaskCount)) ? EFI_TIMEOUT : EFI_SUCCESS;
+  Pool->BatchCount = 0;
+  Pool->TaskCount  = 0;
+  return Status;
+}
+
+/**
+  Free a task pool created by MpInitLibCreateTaskPool() and drop the tasks
+  still queued in it.
+
+  @param[in] TaskPool  The task pool.
+
+  @retval EFI_SUCCESS             The task pool was freed.
+  @retval EFI_INVALID_PARAMETER   TaskPool is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+MpInitLibDestroyTaskPool (
+  IN EDKII_MP_TASK_POOL  TaskPool
+  )
+{
+  MP_TASK_POOL  *Pool;
+
+  Pool = (MP_TASK_POOL *)TaskPool;
+  if ((Pool == NULL) || (Pool->Signature != MP_TASK_POOL_SIGNATURE)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Pool->Signature = 0;
+  FreePages (Pool->Queues, EFI_SIZE_TO_PAGES (Pool->ProcessorCount * sizeof (MP_TASK_QUEUE)));
+  FreePool (Pool->Batches);
+  FreePool (Pool);
+  return EFI_SUCCESS;
+}
@@ -13,6 +13,31 @@
 #include <Library/LocalApicLib.h>
 #include <Library/HobLib.h>
 #include <Library/BaseMemoryLib.h>
+#include <Library/BaseLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/MpInitLib.h>
+
+#define MP_UP_TASK_POOL_SIGNATURE   SIGNATURE_32 ('M', 'P', 'U', 'P')
+#define MP_UP_TASK_INITIAL_BATCHES  8
+
+typedef struct {
+  EDKII_MP_TASK_PROCEDURE    Procedure;
+  VOID                       *Context;
+  UINTN                      TaskCount;
+} MP_UP_TASK_BATCH;
+
+//
+// There is no AP to share the tasks with, so the pool is a list of batches
+// that the BSP runs in order.
+//
+typedef struct {
+  UINT32              Signature;
+  MP_UP_TASK_BATCH    *Batches;
+  UINTN               BatchCount;
+  UINTN               MaxBatches;
+  UINTN               TaskCount;
+} MP_UP_TASK_POOL;
 
 /**
   MP Initialize Library initialization.
@@ -458,3 +483,223 @@ MpInitLibStartupAllCPUs (
 
   return EFI_SUCCESS;
 }
+
+/**
+  Create an empty task pool for MpInitLibSubmitTasks() and MpInitLibJoinTasks().
+  This service may only be called from the BSP.
+
+  @param[out] TaskPool  Returns the handle of the new task pool.
+
+  @retval EFI_SUCCESS             The task pool was created.
+  @retval EFI_INVALID_PARAMETER   TaskPool is NULL.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory for the task pool.
+
+**/
+EFI_STATUS
+EFIAPI
+MpInitLibCreateTaskPool (
+  OUT EDKII_MP_TASK_POOL  *TaskPool
+  )
+{
+  MP_UP_TASK_POOL  *Pool;
+
+  if (TaskPool == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Pool = AllocateZeroPool (sizeof (MP_UP_TASK_POOL));
+  if (Pool == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Pool->Batches = AllocatePool (MP_UP_TASK_INITIAL_BATCHES * sizeof (MP_UP_TASK_BATCH));
+  if (Pool->Batches == NULL) {
+    FreePool (Pool);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Pool->Signature  = MP_UP_TASK_POOL_SIGNATURE;
+  Pool->MaxBatches = MP_UP_TASK_INITIAL_BATCHES;
+
+  *TaskPool = Pool;
+  return EFI_SUCCESS;
+}
+
+/**
+  Queue a batch of tasks into a task pool. The tasks do not start before the
+  pool is joined by MpInitLibJoinTasks(). This service may only be called from
+  the BSP.
+
+  @param[in] TaskPool   The task pool.
+  @param[in] Procedure  The function run for every task of the batch.
+  @param[in] Context    The value passed to Procedure.
+  @param[in] TaskCount  The number of tasks in the batch.
+
+  @retval EFI_SUCCESS             The tasks were queued.
+  @retval EFI_INVALID_PARAMETER   TaskPool or Procedure is NULL, or TaskCount is 0.
+  @retval EFI_OUT_OF_RESOURCES    There is not enough memory to queue the tasks.
+
+**/
+EFI_STATUS
+EFIAPI
+MpInitLibSubmitTasks (
+  IN EDKII_MP_TASK_POOL       TaskPool,
+  IN EDKII_MP_TASK_PROCEDURE  Procedure,
+  IN VOID                     *Context   OPTIONAL,
+  IN UINTN                    TaskCount
+  )
+{
+  MP_UP_TASK_POOL   *Pool;
+  MP_UP_TASK_BATCH  *Batches;
+
+  Pool = (MP_UP_TASK_POOL *)TaskPool;
+  if ((Pool == NULL) || (Pool->Signature != MP_UP_TASK_POOL_SIGNATURE) ||
+      (Procedure == NULL) || (TaskCount == 0))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (TaskCount > MAX_UINTN - Pool->TaskCount) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  if (Pool->BatchCount == Pool->MaxBatches) {
+    Batches = ReallocatePool (
+                Pool->MaxBatches * sizeof (MP_UP_TASK_BATCH),
+                2 * Pool->MaxBatches * sizeof (MP_UP_TASK_BATCH),
+                Pool->Batches
+                );
+    if (Batches == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    Pool->Batches     = Batches;
+    Pool->MaxBatches *= 2;
+  }
+
+  Pool->Batches[Pool->BatchCount].Procedure = Procedure;
+  Pool->Batches[Pool->BatchCount].Context   = Context;
+  Pool->Batches[Pool->BatchCount].TaskCount = TaskCount;
+  Pool->BatchCount++;
+  Pool->TaskCount += TaskCount;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Run all queued tasks of a task pool on the BSP.
+
+  When the timeout expires no further task is started and the tasks that were
+  not started are dropped. The pool is empty when this service returns.
+
+  @param[in]  TaskPool               The task pool.
+  @param[in]  TimeoutInMicroseconds  The time limit for starting tasks. Zero
+                                     means infinity.
+  @param[out] CompletedTasks         Returns the number of tasks that ran.
+
+  @retval EFI_SUCCESS             All queued tasks ran.
+  @retval EFI_TIMEOUT             The timeout expired before all tasks ran.
+  @retval EFI_INVALID_PARAMETER   TaskPool is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+MpInitLibJoinTasks (
+  IN  EDKII_MP_TASK_POOL  TaskPool,
+  IN  UINTN               TimeoutInMicroseconds,
+  OUT UINTN               *CompletedTasks OPTIONAL
+  )
+{
+  MP_UP_TASK_POOL  *Pool;
+  UINTN            Batch;
+  UINTN            Task;
+  UINTN            Completed;
+  UINT64           TimeoutInNanoseconds;
+  UINT64           Start;
+  UINT64           End;
+  UINT64           PreviousTime;
+  UINT64           CurrentTime;
+  UINT64           ElapsedTicks;
+  INT64            Delta;
+  INT64            Cycle;
+
+  Pool = (MP_UP_TASK_POOL *)TaskPool;
+  if ((Pool == NULL) || (Pool->Signature != MP_UP_TASK_POOL_SIGNATURE)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  GetPerformanceCounterProperties (&Start, &End);
+  Cycle = End - Start;
+  if (Cycle < 0) {
+    Cycle = -Cycle;
+  }
+
+  Cycle++;
+
+  TimeoutInNanoseconds = MultU64x32 (TimeoutInMicroseconds, 1000);
+  PreviousTime         = GetPerformanceCounter ();
+  ElapsedTicks         = 0;
+  Completed            = 0;
+  for (Batch = 0; Batch < Pool->BatchCount; Batch++) {
+    for (Task = 0; Task < Pool->Batches[Batch].TaskCount; Task++) {
+      if (TimeoutInNanoseconds != 0) {
+        CurrentTime = GetPerformanceCounter ();
+        Delta       = (INT64)(CurrentTime - PreviousTime);
+        if (Start > End) {
+          Delta = -Delta;
+        }
+
+        if (Delta < 0) {
+          Delta += Cycle;
+        }
+
+        ElapsedTicks += Delta;
+        PreviousTime  = CurrentTime;
+        if (GetTimeInNanoSecond (ElapsedTicks) >= TimeoutInNanoseconds) {
+          break;
+        }
+      }
+
+      Pool->Batches[Batch].Procedure (Pool->Batches[Batch].Context, Task);
+      Completed++;
+    }
+  }
+
+  if (CompletedTasks != NULL) {
+    *CompletedTasks = Completed;
+  }
+
+  Task             = Pool->TaskCount;
+  Pool->BatchCount = 0;
+  Pool->TaskCount  = 0;
+  return (Completed == Task) ? EFI_SUCCESS : EFI_TIMEOUT;
+}
+
+/**
+  Free a task pool created by MpInitLibCreateTaskPool() and drop the tasks
+  still queued in it.
+
+  @param[in] TaskPool  The task pool.
+
+  @retval EFI_SUCCESS             The task pool was freed.
+  @retval EFI_INVALID_PARAMETER   TaskPool is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+MpInitLibDestroyTaskPool (
+  IN EDKII_MP_TASK_POOL  TaskPool
+  )
+{
+  MP_UP_TASK_POOL  *Pool;
+
+  Pool = (MP_UP_TASK_POOL *)TaskPool;
+  if ((Pool == NULL) || (Pool->Signature != MP_UP_TASK_POOL_SIGNATURE)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Pool->Signature = 0;
+  FreePool (Pool->Batches);
+  FreePool (Pool);
+  return EFI_SUCCESS;
+}
@@ -2085,6 +2085,231 @@ MtrrLibMergeVariableMtrr (
   }
 }
 
+/**
+  Add the variable MTRR settings for a memory range whose type is changed,
+  without changing the existing variable MTRR settings.
+
+  The memory range is split to blocks that can be covered by one variable MTRR.
+  The new type of a block which overlaps with any existing variable MTRR should
+  precede or equal to the type of that MTRR, so that the new MTRR decides the
+  effective type of the whole block.
+
+  @param A0                   Alignment to use when base address is 0.
+  @param BaseAddress          Base address of the memory range.
+  @param Length               Length of the memory range.
+  @param Type                 The new type of the memory range.
+  @param VariableMtrr         The existing variable MTRR settings.
+  @param VariableMtrrCount    Count of the existing variable MTRR settings.
+  @param NewMtrrs             Array holding the new variable MTRR settings.
+  @param NewMtrrCapacity      Capacity of the new variable MTRR array.
+  @param NewMtrrCount         The count of new variable MTRR settings in array.
+
+  @retval RETURN_SUCCESS          The new variable MTRR settings are appended.
+  @retval RETURN_UNSUPPORTED      The existing variable MTRR settings need to change.
+  @retval RETURN_OUT_OF_RESOURCES Count of new variable MTRRs exceeds capacity.
+**/
+RETURN_STATUS
+MtrrLibAppendVariableMtrrForRange (
+  IN     UINT64                   A0,
+  IN     UINT64                   BaseAddress,
+  IN     UINT64                   Length,
+  IN     MTRR_MEMORY_CACHE_TYPE   Type,
+  IN     CONST MTRR_MEMORY_RANGE  *VariableMtrr,
+  IN     UINT32                   VariableMtrrCount,
+  IN OUT MTRR_MEMORY_RANGE        *NewMtrrs,
+  IN     UINT32                   NewMtrrCapacity,
+  IN OUT UINT32                   *NewMtrrCount
+  )
+{
+  RETURN_STATUS  Status;
+  UINT32         Index;
+  UINT64         Alignment;
+  UINT64         Limit;
+
+  Limit = BaseAddress + Length;
+  while (BaseAddress < Limit) {
+    Alignment = MtrrLibBiggestAlignment (BaseAddress, A0);
+    while (Alignment > Limit - BaseAddress) {
+      Alignment = RShiftU64 (Alignment, 1);
+    }
+
+    for (Index = 0; Index < VariableMtrrCount; Index++) {
+      if ((VariableMtrr[Index].Length != 0) &&
+          (BaseAddress < VariableMtrr[Index].BaseAddress + VariableMtrr[Index].Length) &&
+          (VariableMtrr[Index].BaseAddress < BaseAddress + Alignment) &&
+          (Type != VariableMtrr[Index].Type) &&
+          !MtrrLibTypeLeftPrecedeRight (Type, VariableMtrr[Index].Type))
+      {
+        return RETURN_UNSUPPORTED;
+      }
+    }
+
+    Status = MtrrLibAppendVariableMtrr (NewMtrrs, NewMtrrCapacity, NewMtrrCount, BaseAddress, Alignment, Type);
+    if (RETURN_ERROR (Status)) {
+      return Status;
+    }
+
+    BaseAddress += Alignment;
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Update the variable MTRR settings incrementally for the memory type changes.
+
+  Only new variable MTRRs are added for the memory ranges whose type is changed.
+  It's much faster than calculating all the variable MTRR settings again, but
+  more variable MTRRs may be used than the calculated settings. When a change
+  cannot be applied by adding new variable MTRRs, or there are not enough free
+  variable MTRRs, nothing is changed and the caller should calculate all the
+  variable MTRR settings instead.
+
+  @param A0                        Alignment to use when base address is 0.
+  @param FixedMtrrMemoryLimit      The limit of memory covered by fixed MTRRs.
+  @param OldRanges                 Memory ranges before the change.
+  @param OldRangeCount             Count of memory ranges before the change.
+  @param NewRanges                 Memory ranges after the change.
+  @param NewRangeCount             Count of memory ranges after the change.
+  @param VariableMtrr              The variable MTRR settings to update.
+  @param VariableMtrrCount         Count of the variable MTRR settings.
+  @param FirmwareVariableMtrrCount Count of the variable MTRRs that can be used by firmware.
+  @param Modified                  Flag array to indicate which variable MTRR setting is modified.
+
+  @retval TRUE   The variable MTRR settings are updated.
+  @retval FALSE  The variable MTRR settings need to be calculated again.
+**/
+BOOLEAN
+MtrrLibIncrementalUpdateVariableMtrr (
+  IN     UINT64                   A0,
+  IN     UINT64                   FixedMtrrMemoryLimit,
+  IN     CONST MTRR_MEMORY_RANGE  *OldRanges,
+  IN     UINTN                    OldRangeCount,
+  IN     CONST MTRR_MEMORY_RANGE  *NewRanges,
+  IN     UINTN                    NewRangeCount,
+  IN OUT MTRR_MEMORY_RANGE        *VariableMtrr,
+  IN     UINT32                   VariableMtrrCount,
+  IN     UINT32                   FirmwareVariableMtrrCount,
+  IN OUT BOOLEAN                  *Modified
+  )
+{
+  RETURN_STATUS           Status;
+  UINTN                   OldIndex;
+  UINTN                   NewIndex;
+  UINT32                  Index;
+  UINT32                  UsedMtrrCount;
+  UINT64                  Base;
+  UINT64                  Limit;
+  UINT64                  ChangeBase;
+  UINT64                  ChangeLength;
+  MTRR_MEMORY_CACHE_TYPE  ChangeType;
+  MTRR_MEMORY_RANGE       NewMtrrs[MTRR_NUMBER_OF_VARIABLE_MTRR];
+  UINT32                  NewMtrrCount;
+
+  UsedMtrrCount = 0;
+  for (Index = 0; Index < VariableMtrrCount; Index++) {
+    if (VariableMtrr[Index].Length != 0) {
+      UsedMtrrCount++;
+    }
+  }
+
+  if (UsedMtrrCount >= FirmwareVariableMtrrCount) {
+    return FALSE;
+  }
+
+  //
+  // Both OldRanges and NewRanges cover the whole address space in ascending order.
+  // Walk them together to find the memory ranges whose type is changed, and merge
+  // the adjacent changed ranges of the same new type.
+  // The changed range starting from FixedMtrrMemoryLimit is extended to 0 because
+  // the variable MTRRs don't impact the memory covered by fixed MTRRs.
+  //
+  NewMtrrCount = 0;
+  ChangeLength = 0;
+  ChangeBase   = 0;
+  ChangeType   = CacheInvalid;
+  Base         = 0;
+  OldIndex     = 0;
+  NewIndex     = 0;
+  while ((OldIndex < OldRangeCount) && (NewIndex < NewRangeCount)) {
+    Limit = MIN (
+              OldRanges[OldIndex].BaseAddress + OldRanges[OldIndex].Length,
+              NewRanges[NewIndex].BaseAddress + NewRanges[NewIndex].Length
+              );
+    if (OldRanges[OldIndex].Type != NewRanges[NewIndex].Type) {
+      if ((ChangeLength != 0) && ((ChangeBase + ChangeLength != Base) || (ChangeType != NewRanges[NewIndex].Type))) {
+        Status = MtrrLibAppendVariableMtrrForRange (
+                   A0,
+                   ChangeBase,
+                   ChangeLength,
+                   ChangeType,
+                   VariableMtrr,
+                   VariableMtrrCount,
+                   NewMtrrs,
+                   FirmwareVariableMtrrCount - UsedMtrrCount,
+                   &NewMtrrCount
+                   );
+        if (RETURN_ERROR (Status)) {
+          return FALSE;
+        }
+
+        ChangeLength = 0;
+      }
+
+      if (ChangeLength == 0) {
+        ChangeBase = (Base == FixedMtrrMemoryLimit) ? 0 : Base;
+        ChangeType = NewRanges[NewIndex].Type;
+      }
+
+      ChangeLength = Limit - ChangeBase;
+    }
+
+    if (Limit == OldRanges[OldIndex].BaseAddress + OldRanges[OldIndex].Length) {
+      OldIndex++;
+    }
+
+    if (Limit == NewRanges[NewIndex].BaseAddress + NewRanges[NewIndex].Length) {
+      NewIndex++;
+    }
+
+    Base = Limit;
+  }
+
+  if (ChangeLength != 0) {
+    Status = MtrrLibAppendVariableMtrrForRange (
+               A0,
+               ChangeBase,
+               ChangeLength,
+               ChangeType,
+               VariableMtrr,
+               VariableMtrrCount,
+               NewMtrrs,
+               FirmwareVariableMtrrCount - UsedMtrrCount,
+               &NewMtrrCount
+               );
+    if (RETURN_ERROR (Status)) {
+      return FALSE;
+    }
+  }
+
+  //
+  // Put the new MTRRs in the empty slots.
+  //
+  Index = 0;
+  while (NewMtrrCount != 0) {
+    while (VariableMtrr[Index].Length != 0) {
+      Index++;
+    }
+
+    ASSERT (Index < VariableMtrrCount);
+    NewMtrrCount--;
+    CopyMem (&VariableMtrr[Index], &NewMtrrs[NewMtrrCount], sizeof (NewMtrrs[0]));
+    Modified[Index] = TRUE;
+  }
+
+  return TRUE;
+}
+
 /**
   Calculate the variable MTRR settings for all memory ranges.
 
@@ -2353,6 +2578,8 @@ MtrrSetMemoryAttributesInMtrrSettings (
   MTRR_VARIABLE_SETTINGS  VariableSettings;
   MTRR_MEMORY_RANGE       WorkingRanges[2 * ARRAY_SIZE (MtrrSetting->Variables.Mtrr) + 2];
   UINTN                   WorkingRangeCount;
+  MTRR_MEMORY_RANGE       OriginalWorkingRanges[ARRAY_SIZE (WorkingRanges)];
+  UINTN                   OriginalWorkingRangeCount;
   BOOLEAN                 Modified;
   MTRR_VARIABLE_SETTING   VariableSetting;
   UINT32                  OriginalVariableMtrrCount;
@@ -2503,7 +2730,14 @@ MtrrSetMemoryAttributesInMtrrSettings (
 
     //
     // 2.3. Apply the new memory attribute settings to Ranges.
+    //      Keep the original Ranges for the incremental update.
     //
+    OriginalWorkingRangeCount = 0;
+    if (PcdGetBool (PcdCpuMtrrIncrementalUpdate)) {
+      CopyMem (OriginalWorkingRanges, WorkingRanges, WorkingRangeCount * sizeof (WorkingRanges[0]));
+      OriginalWorkingRangeCount = WorkingRangeCount;
+    }
+
     Modified = FALSE;
     for (Index = 0; Index < RangeCount; Index++) {
       BaseAddress = Ranges[Index].BaseAddress;
@@ -2535,9 +2769,32 @@ MtrrSetMemoryAttributesInMtrrSettings (
       }
     }
 
+    //
+    // 2.4. Only add the Variable MTRRs for the changed ranges when possible.
+    //      The existing Variable MTRRs are kept and the scratch buffer is not used.
+    //
+    if (Modified && (OriginalWorkingRangeCount != 0)) {
+      if (MtrrLibIncrementalUpdateVariableMtrr (
+            LShiftU64 (1, (UINTN)HighBitSet64 (MtrrValidBitsMask)),
+            FixedMtrrMemoryLimit,
+            OriginalWorkingRanges,
+            OriginalWorkingRangeCount,
+            WorkingRanges,
+            WorkingRangeCount,
+            OriginalVariableMtrr,
+            OriginalVariableMtrrCount,
+            FirmwareVariableMtrrCount,
+            VariableSettingModified
+            ))
+      {
+        DEBUG ((DEBUG_CACHE, "  Variable MTRRs are updated incrementally.\n"));
+        Modified = FALSE;
+      }
+    }
+
     if (Modified) {
       //
-      // 2.4. Calculate the Variable MTRR settings based on the Ranges.
+      // 2.5. Calculate the Variable MTRR settings based on the Ranges.
       //      Buffer Too Small may be returned if the scratch buffer size is insufficient.
       //
       Status = MtrrLibSetMemoryRanges (
@@ -2556,7 +2813,7 @@ MtrrSetMemoryAttributesInMtrrSettings (
       }
 
       //
-      // 2.5. Remove the [0, 1MB) MTRR if it still exists (not merged with other range)
+      // 2.6. Remove the [0, 1MB) MTRR if it still exists (not merged with other range)
       //
       for (Index = 0; Index < WorkingVariableMtrrCount; Index++) {
         if ((WorkingVariableMtrr[Index].BaseAddress == 0) && (WorkingVariableMtrr[Index].Length == FixedMtrrMemoryLimit)) {
@@ -2577,7 +2834,7 @@ MtrrSetMemoryAttributesInMtrrSettings (
       }
 
       //
-      // 2.6. Merge the WorkingVariableMtrr to OriginalVariableMtrr
+      // 2.7. Merge the WorkingVariableMtrr to OriginalVariableMtrr
       //      Make sure least modification is made to OriginalVariableMtrr.
       //
       MtrrLibMergeVariableMtrr (
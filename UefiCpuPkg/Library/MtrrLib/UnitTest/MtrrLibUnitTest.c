@@ -72,7 +72,68 @@ typedef struct {
   CONST MTRR_LIB_SYSTEM_PARAMETER    *SystemParameter;
 } MTRR_LIB_GET_FIRMWARE_VARIABLE_MTRR_COUNT_CONTEXT;
 
+//
+// Context structure to be used for the memory layout test cases.
+//
+typedef struct {
+  CONST MTRR_LIB_SYSTEM_PARAMETER    *SystemParameter;
+  CHAR8                              *Name;
+  CONST MTRR_MEMORY_RANGE            *Ranges;
+  UINTN                              RangeCount;
+} MTRR_LIB_MEMORY_LAYOUT_CONTEXT;
+
+//
+// Memory layout of a typical platform that sets the memory attributes range by range.
+//
+STATIC CONST MTRR_MEMORY_RANGE  mPlatformMemoryLayout[] = {
+  { 0x000000000, 0x080000000, CacheWriteBack      },  // Low memory
+  { 0x100000000, 0x180000000, CacheWriteBack      },  // High memory
+  { 0x07F000000, SIZE_8MB,    CacheUncacheable    },  // SMRAM
+  { 0x0C0000000, SIZE_256MB,  CacheWriteCombining },  // Frame buffer
+  { 0x0D0000000, SIZE_16MB,   CacheWriteCombining },  // PCI MMIO
+  { 0x0E0000000, SIZE_64MB,   CacheWriteCombining },  // PCI MMIO
+  { 0x200000000, SIZE_256MB,  CacheUncacheable    },  // PCI MMIO above 4GB
+};
+
+//
+// Memory layout whose range boundaries are not aligned to big power of two,
+// which needs the most calculation to find the least variable MTRRs.
+//
+STATIC CONST MTRR_MEMORY_RANGE  mUnalignedMemoryLayout[] = {
+  { 0x000000000, 0x07F7FF000, CacheWriteBack      },
+  { 0x100000000, 0x13FFFF000, CacheWriteBack      },
+  { 0x0BFFFF000, 0x010001000, CacheWriteCombining },
+  { 0x07F000000, 0x0007FF000, CacheUncacheable    },
+};
+
+//
+// Memory layout with many small ranges of different types.
+//
+STATIC CONST MTRR_MEMORY_RANGE  mFragmentedMemoryLayout[] = {
+  { 0x100000000, SIZE_2MB, CacheWriteBack      },
+  { 0x100400000, SIZE_2MB, CacheWriteThrough   },
+  { 0x100800000, SIZE_2MB, CacheWriteCombining },
+  { 0x100C00000, SIZE_2MB, CacheWriteProtected },
+  { 0x101000000, SIZE_2MB, CacheWriteBack      },
+  { 0x101400000, SIZE_2MB, CacheWriteThrough   },
+  { 0x101800000, SIZE_2MB, CacheWriteCombining },
+  { 0x101C00000, SIZE_2MB, CacheWriteProtected },
+  { 0x102000000, SIZE_2MB, CacheWriteBack      },
+  { 0x102400000, SIZE_2MB, CacheWriteThrough   },
+  { 0x102800000, SIZE_2MB, CacheWriteCombining },
+  { 0x102C00000, SIZE_2MB, CacheWriteProtected },
+};
+
+STATIC MTRR_LIB_MEMORY_LAYOUT_CONTEXT  mMemoryLayoutContexts[] = {
+  { &mDefaultSystemParameter, "Platform",   mPlatformMemoryLayout,   ARRAY_SIZE (mPlatformMemoryLayout)   },
+  { &mDefaultSystemParameter, "Unaligned",  mUnalignedMemoryLayout,  ARRAY_SIZE (mUnalignedMemoryLayout)  },
+  { &mDefaultSystemParameter, "Fragmented", mFragmentedMemoryLayout, ARRAY_SIZE (mFragmentedMemoryLayout) },
+};
+
+#define MTRR_LIB_PERFORMANCE_ITERATIONS  1000
+
 STATIC CHAR8  *mCacheDescription[] = { "UC", "WC", "N/A", "N/A", "WT", "WP", "WB" };
+STATIC CHAR8  *mSetMethods[]       = { "Range by range", "Range by range (incremental)", "All in one call" };
 
 /**
   Compare the actual memory ranges against expected memory ranges and return PASS when they match.
@@ -1148,7 +1209,12 @@ UnitTestMtrrSetMemoryAttributeAndGetMemoryAttributesInMtrrSettings (
     UT_LOG_INFO ("--- Actual Memory Ranges [%d] ---\n", ActualMemoryRangesCount);
     DumpMemoryRanges (ActualMemoryRanges, ActualMemoryRangesCount);
     VerifyMemoryRanges (ExpectedMemoryRanges, ExpectedMemoryRangesCount, ActualMemoryRanges, ActualMemoryRangesCount);
-    UT_ASSERT_TRUE (ExpectedVariableMtrrUsage >= ActualVariableMtrrUsage);
+    //
+    // More variable MTRRs may be used when they are updated incrementally.
+    //
+    if (!PatchPcdGetBool (PcdCpuMtrrIncrementalUpdate)) {
+      UT_ASSERT_TRUE (ExpectedVariableMtrrUsage >= ActualVariableMtrrUsage);
+    }
 
     ReturnedMemoryRangesCount = ARRAY_SIZE (ReturnedMemoryRanges);
     Status                    = MtrrGetMemoryAttributesInMtrrSettings (
@@ -1167,6 +1233,256 @@ UnitTestMtrrSetMemoryAttributeAndGetMemoryAttributesInMtrrSettings (
   return UNIT_TEST_PASSED;
 }
 
+/**
+  Unit test of MtrrLib service MtrrSetMemoryAttributeInMtrrSettings() when the
+  variable MTRRs are updated incrementally.
+
+  Every memory range of the layout can be set by only adding new variable MTRRs,
+  so the existing variable MTRRs should not be changed.
+
+  @param[in]  Context    Pointer to MTRR_LIB_MEMORY_LAYOUT_CONTEXT.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+UnitTestMtrrIncrementalUpdate (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MTRR_LIB_MEMORY_LAYOUT_CONTEXT  *LocalContext;
+  MTRR_LIB_SYSTEM_PARAMETER       SystemParameter;
+  RETURN_STATUS                   Status;
+  UINTN                           Index;
+  UINTN                           MtrrIndex;
+  MTRR_SETTINGS                   LocalMtrrs;
+  MTRR_VARIABLE_SETTINGS          PreviousVariableMtrrs;
+  MTRR_MEMORY_RANGE               ExpectedMemoryRanges[MTRR_NUMBER_OF_FIXED_MTRR * sizeof (UINT64) + 2 * MTRR_NUMBER_OF_VARIABLE_MTRR + 1];
+  UINTN                           ExpectedMemoryRangesCount;
+  MTRR_MEMORY_RANGE               ActualMemoryRanges[MTRR_NUMBER_OF_FIXED_MTRR * sizeof (UINT64) + 2 * MTRR_NUMBER_OF_VARIABLE_MTRR + 1];
+  UINTN                           ActualMemoryRangesCount;
+  UINT8                           *Scratch;
+  UINTN                           ScratchSize;
+
+  LocalContext = (MTRR_LIB_MEMORY_LAYOUT_CONTEXT *)Context;
+  CopyMem (&SystemParameter, LocalContext->SystemParameter, sizeof (SystemParameter));
+  InitializeMtrrRegs (&SystemParameter);
+
+  //
+  // Set all the memory ranges in one call to get the expected memory ranges.
+  //
+  ZeroMem (&LocalMtrrs, sizeof (LocalMtrrs));
+  LocalMtrrs.MtrrDefType = MtrrGetDefaultMemoryType ();
+  ScratchSize            = SCRATCH_BUFFER_SIZE;
+  Scratch                = calloc (ScratchSize, sizeof (UINT8));
+  Status                 = MtrrSetMemoryAttributesInMtrrSettings (&LocalMtrrs, Scratch, &ScratchSize, LocalContext->Ranges, LocalContext->RangeCount);
+  free (Scratch);
+  UT_ASSERT_STATUS_EQUAL (Status, RETURN_SUCCESS);
+  ExpectedMemoryRangesCount = ARRAY_SIZE (ExpectedMemoryRanges);
+  Status                    = MtrrGetMemoryAttributesInMtrrSettings (&LocalMtrrs, ExpectedMemoryRanges, &ExpectedMemoryRangesCount);
+  UT_ASSERT_STATUS_EQUAL (Status, RETURN_SUCCESS);
+
+  //
+  // Set the memory ranges one by one. The existing variable MTRRs should not be changed.
+  //
+  PatchPcdSetBool (PcdCpuMtrrIncrementalUpdate, TRUE);
+  ZeroMem (&LocalMtrrs, sizeof (LocalMtrrs));
+  LocalMtrrs.MtrrDefType = MtrrGetDefaultMemoryType ();
+  for (Index = 0; Index < LocalContext->RangeCount; Index++) {
+    CopyMem (&PreviousVariableMtrrs, &LocalMtrrs.Variables, sizeof (PreviousVariableMtrrs));
+    Status = MtrrSetMemoryAttributeInMtrrSettings (
+               &LocalMtrrs,
+               LocalContext->Ranges[Index].BaseAddress,
+               LocalContext->Ranges[Index].Length,
+               LocalContext->Ranges[Index].Type
+               );
+    UT_ASSERT_STATUS_EQUAL (Status, RETURN_SUCCESS);
+
+    for (MtrrIndex = 0; MtrrIndex < SystemParameter.VariableMtrrCount; MtrrIndex++) {
+      if (((MSR_IA32_MTRR_PHYSMASK_REGISTER *)&PreviousVariableMtrrs.Mtrr[MtrrIndex].Mask)->Bits.V != 0) {
+        UT_ASSERT_EQUAL (LocalMtrrs.Variables.Mtrr[MtrrIndex].Base, PreviousVariableMtrrs.Mtrr[MtrrIndex].Base);
+        UT_ASSERT_EQUAL (LocalMtrrs.Variables.Mtrr[MtrrIndex].Mask, PreviousVariableMtrrs.Mtrr[MtrrIndex].Mask);
+      }
+    }
+  }
+
+  ActualMemoryRangesCount = ARRAY_SIZE (ActualMemoryRanges);
+  Status                  = MtrrGetMemoryAttributesInMtrrSettings (&LocalMtrrs, ActualMemoryRanges, &ActualMemoryRangesCount);
+  UT_ASSERT_STATUS_EQUAL (Status, RETURN_SUCCESS);
+  UT_LOG_INFO ("--- Actual Memory Ranges [%d] ---\n", ActualMemoryRangesCount);
+  DumpMemoryRanges (ActualMemoryRanges, ActualMemoryRangesCount);
+  VerifyMemoryRanges (ExpectedMemoryRanges, ExpectedMemoryRangesCount, ActualMemoryRanges, ActualMemoryRangesCount);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Set the memory layout to the MTRR settings repeatedly and measure the average time.
+
+  @param[in]  Context       Pointer to MTRR_LIB_MEMORY_LAYOUT_CONTEXT.
+  @param[in]  Batch         TRUE to set all the memory ranges in one call.
+                            FALSE to set the memory ranges one by one.
+  @param[in]  Incremental   TRUE to update the variable MTRRs incrementally.
+  @param[out] MtrrSetting   Return the MTRR settings of the memory layout.
+  @param[out] Microseconds  Return the average time in microseconds to set the memory layout.
+
+  @retval  UNIT_TEST_PASSED             The memory layout is set successfully.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+MeasureMemoryLayoutSetting (
+  IN  MTRR_LIB_MEMORY_LAYOUT_CONTEXT  *Context,
+  IN  BOOLEAN                         Batch,
+  IN  BOOLEAN                         Incremental,
+  OUT MTRR_SETTINGS                   *MtrrSetting,
+  OUT UINT64                          *Microseconds
+  )
+{
+  RETURN_STATUS  Status;
+  UINTN          Iteration;
+  UINTN          Index;
+  UINT8          *Scratch;
+  UINTN          ScratchSize;
+  clock_t        Start;
+
+  PatchPcdSetBool (PcdCpuMtrrIncrementalUpdate, Incremental);
+
+  //
+  // Get the scratch buffer size needed by the memory layout.
+  //
+  ScratchSize = SCRATCH_BUFFER_SIZE;
+  Scratch     = calloc (ScratchSize, sizeof (UINT8));
+  ZeroMem (MtrrSetting, sizeof (*MtrrSetting));
+  MtrrSetting->MtrrDefType = MtrrGetDefaultMemoryType ();
+  Status                   = MtrrSetMemoryAttributesInMtrrSettings (MtrrSetting, Scratch, &ScratchSize, Context->Ranges, Context->RangeCount);
+  if (Status == RETURN_BUFFER_TOO_SMALL) {
+    Scratch = realloc (Scratch, ScratchSize);
+  }
+
+  Start = clock ();
+  for (Iteration = 0; Iteration < MTRR_LIB_PERFORMANCE_ITERATIONS; Iteration++) {
+    ZeroMem (MtrrSetting, sizeof (*MtrrSetting));
+    MtrrSetting->MtrrDefType = MtrrGetDefaultMemoryType ();
+    if (Batch) {
+      Status = MtrrSetMemoryAttributesInMtrrSettings (MtrrSetting, Scratch, &ScratchSize, Context->Ranges, Context->RangeCount);
+      UT_ASSERT_STATUS_EQUAL (Status, RETURN_SUCCESS);
+    } else {
+      for (Index = 0; Index < Context->RangeCount; Index++) {
+        Status = MtrrSetMemoryAttributeInMtrrSettings (
+                   MtrrSetting,
+                   Context->Ranges[Index].BaseAddress,
+                   Context->Ranges[Index].Length,
+                   Context->Ranges[Index].Type
+                   );
+        UT_ASSERT_STATUS_EQUAL (Status, RETURN_SUCCESS);
+      }
+    }
+  }
+
+  *Microseconds = (UINT64)(clock () - Start) * 1000000 / CLOCKS_PER_SEC / MTRR_LIB_PERFORMANCE_ITERATIONS;
+  free (Scratch);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Performance test of MtrrLib service MtrrSetMemoryAttributeInMtrrSettings() and
+  MtrrSetMemoryAttributesInMtrrSettings().
+
+  The memory layout is set range by range, range by range with the incremental
+  update, and in one call. All of them should result in the same memory ranges.
+
+  @param[in]  Context    Pointer to MTRR_LIB_MEMORY_LAYOUT_CONTEXT.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+UnitTestMtrrSetMemoryAttributesPerformance (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MTRR_LIB_MEMORY_LAYOUT_CONTEXT  *LocalContext;
+  MTRR_LIB_SYSTEM_PARAMETER       SystemParameter;
+  UNIT_TEST_STATUS                Status;
+  UINTN                           Index;
+  MTRR_SETTINGS                   LocalMtrrs;
+  UINT64                          Microseconds;
+  MTRR_MEMORY_RANGE               ActualMemoryRanges[ARRAY_SIZE (mSetMethods)][MTRR_NUMBER_OF_FIXED_MTRR * sizeof (UINT64) + 2 * MTRR_NUMBER_OF_VARIABLE_MTRR + 1];
+  UINTN                           ActualMemoryRangesCount[ARRAY_SIZE (mSetMethods)];
+  UINT32                          ActualVariableMtrrUsage;
+
+  LocalContext = (MTRR_LIB_MEMORY_LAYOUT_CONTEXT *)Context;
+  CopyMem (&SystemParameter, LocalContext->SystemParameter, sizeof (SystemParameter));
+  InitializeMtrrRegs (&SystemParameter);
+
+  for (Index = 0; Index < ARRAY_SIZE (mSetMethods); Index++) {
+    Status = MeasureMemoryLayoutSetting (LocalContext, (BOOLEAN)(Index == 2), (BOOLEAN)(Index == 1), &LocalMtrrs, &Microseconds);
+    if (Status != UNIT_TEST_PASSED) {
+      return Status;
+    }
+
+    ActualMemoryRangesCount[Index] = ARRAY_SIZE (ActualMemoryRanges[Index]);
+    CollectTestResult (
+      SystemParameter.DefaultCacheType,
+      SystemParameter.PhysicalAddressBits - SystemParameter.MkTmeKeyidBits,
+      SystemParameter.VariableMtrrCount,
+      &LocalMtrrs,
+      ActualMemoryRanges[Index],
+      &ActualMemoryRangesCount[Index],
+      &ActualVariableMtrrUsage
+      );
+    UT_LOG_INFO (
+      "%a layout: %a takes %ld us, %d variable MTRRs are used\n",
+      LocalContext->Name,
+      mSetMethods[Index],
+      Microseconds,
+      ActualVariableMtrrUsage
+      );
+  }
+
+  for (Index = 1; Index < ARRAY_SIZE (mSetMethods); Index++) {
+    VerifyMemoryRanges (ActualMemoryRanges[0], ActualMemoryRangesCount[0], ActualMemoryRanges[Index], ActualMemoryRangesCount[Index]);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Prep routine for the test cases that update the variable MTRRs incrementally.
+
+  @param Context  Pointer to MTRR_LIB_SYSTEM_PARAMETER.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+EnableIncrementalUpdate (
+  UNIT_TEST_CONTEXT  Context
+  )
+{
+  PatchPcdSetBool (PcdCpuMtrrIncrementalUpdate, TRUE);
+  return InitializeSystem (Context);
+}
+
+/**
+  Clean up routine for the test cases that update the variable MTRRs incrementally.
+
+  @param Context  Ignored.
+**/
+VOID
+EFIAPI
+DisableIncrementalUpdate (
+  UNIT_TEST_CONTEXT  Context
+  )
+{
+  PatchPcdSetBool (PcdCpuMtrrIncrementalUpdate, FALSE);
+}
+
 /**
   Prep routine for UnitTestGetFirmwareVariableMtrrCount().
 
@@ -1271,9 +1587,16 @@ UnitTestingEntry (
       AddTestCase (MtrrApiTests, "Test InvalidMemoryLayouts", "InvalidMemoryLayouts", UnitTestInvalidMemoryLayouts, InitializeSystem, NULL, &mSystemParameters[SystemIndex]);
       AddTestCase (MtrrApiTests, "Test MtrrSetMemoryAttributeInMtrrSettings and MtrrGetMemoryAttributesInMtrrSettings", "MtrrSetMemoryAttributeInMtrrSettings and MtrrGetMemoryAttributesInMtrrSettings", UnitTestMtrrSetMemoryAttributeAndGetMemoryAttributesInMtrrSettings, InitializeSystem, NULL, &mSystemParameters[SystemIndex]);
       AddTestCase (MtrrApiTests, "Test MtrrSetMemoryAttributesInMtrrSettings and MtrrGetMemoryAttributesInMtrrSettings", "MtrrSetMemoryAttributesInMtrrSettings and MtrrGetMemoryAttributesInMtrrSetting", UnitTestMtrrSetAndGetMemoryAttributesInMtrrSettings, InitializeSystem, NULL, &mSystemParameters[SystemIndex]);
+      AddTestCase (MtrrApiTests, "Test MtrrSetMemoryAttributeInMtrrSettings with incremental update", "MtrrSetMemoryAttributeInMtrrSettings with incremental update", UnitTestMtrrSetMemoryAttributeAndGetMemoryAttributesInMtrrSettings, EnableIncrementalUpdate, DisableIncrementalUpdate, &mSystemParameters[SystemIndex]);
     }
   }
 
+  for (Index = 0; Index < ARRAY_SIZE (mMemoryLayoutContexts); Index++) {
+    AddTestCase (MtrrApiTests, "Test MtrrSetMemoryAttributesInMtrrSettings performance", "MtrrSetMemoryAttributesPerformance", UnitTestMtrrSetMemoryAttributesPerformance, NULL, DisableIncrementalUpdate, &mMemoryLayoutContexts[Index]);
+  }
+
+  AddTestCase (MtrrApiTests, "Test MtrrSetMemoryAttributeInMtrrSettings incremental update", "MtrrIncrementalUpdate", UnitTestMtrrIncrementalUpdate, NULL, DisableIncrementalUpdate, &mMemoryLayoutContexts[0]);
+
   //
   // Execute the tests.
   //
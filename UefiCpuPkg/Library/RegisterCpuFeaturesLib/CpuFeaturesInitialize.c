@@ -193,7 +193,6 @@ CpuInitDataInitialize (
       goto ExitOnError;
     }
 
-    InitializeListHead (&InitOrder->OrderList);
     Status = GetProcessorInformation (ProcessorNumber, &ProcessorInfoBuffer);
     ASSERT_EFI_ERROR (Status);
     CopyMem (
@@ -296,6 +295,26 @@ CpuInitDataInitialize (
     goto ExitOnError;
   }
 
+  if (PcdGetBool (PcdCpuFeaturesParallelProgramming)) {
+    //
+    // One barrier counter per core and per package, each one in its own cache line.
+    //
+    CpuFeaturesData->CpuFlags.BarrierStride    = MAX (GetSpinLockProperties (), sizeof (UINT32)) / sizeof (UINT32);
+    CpuFeaturesData->CpuFlags.CoreBarrierCount = AllocateZeroPool (
+                                                   sizeof (UINT32) * CpuFeaturesData->CpuFlags.BarrierStride *
+                                                   CpuStatus->PackageCount * CpuStatus->MaxCoreCount
+                                                   );
+    CpuFeaturesData->CpuFlags.PackageBarrierCount = AllocateZeroPool (
+                                                      sizeof (UINT32) * CpuFeaturesData->CpuFlags.BarrierStride *
+                                                      CpuStatus->PackageCount
+                                                      );
+    if ((CpuFeaturesData->CpuFlags.CoreBarrierCount == NULL) || (CpuFeaturesData->CpuFlags.PackageBarrierCount == NULL)) {
+      ASSERT (CpuFeaturesData->CpuFlags.CoreBarrierCount != NULL);
+      ASSERT (CpuFeaturesData->CpuFlags.PackageBarrierCount != NULL);
+      goto ExitOnError;
+    }
+  }
+
   //
   // Initialize CpuFeaturesData->InitOrder[].CpuInfo.First
   // Use AllocatePages () instead of AllocatePool () because pool cannot be freed in PEI phase but page can.
@@ -374,6 +393,16 @@ ExitOnError:
     FreePages (FirstCore, Pages);
   }
 
+  if ((CpuFeaturesData != NULL) && (CpuFeaturesData->CpuFlags.PackageBarrierCount != NULL)) {
+    FreePool ((VOID *)CpuFeaturesData->CpuFlags.PackageBarrierCount);
+    CpuFeaturesData->CpuFlags.PackageBarrierCount = NULL;
+  }
+
+  if ((CpuFeaturesData != NULL) && (CpuFeaturesData->CpuFlags.CoreBarrierCount != NULL)) {
+    FreePool ((VOID *)CpuFeaturesData->CpuFlags.CoreBarrierCount);
+    CpuFeaturesData->CpuFlags.CoreBarrierCount = NULL;
+  }
+
   if ((CpuFeaturesData != NULL) && (CpuFeaturesData->CpuFlags.PackageSemaphoreCount != NULL)) {
     FreePool ((VOID *)CpuFeaturesData->CpuFlags.PackageSemaphoreCount);
     CpuFeaturesData->CpuFlags.PackageSemaphoreCount = NULL;
@@ -730,6 +759,7 @@ AnalysisProcessorFeatures (
   CPU_FEATURE_DEPENDENCE_TYPE       AfterDep;
   CPU_FEATURE_DEPENDENCE_TYPE       NoneNeibBeforeDep;
   CPU_FEATURE_DEPENDENCE_TYPE       NoneNeibAfterDep;
+  LIST_ENTRY                        OrderList;
 
   CpuFeaturesData                = GetCpuFeaturesData ();
   CpuFeaturesData->CapabilityPcd = AllocatePool (CpuFeaturesData->BitMaskSize);
@@ -786,29 +816,70 @@ AnalysisProcessorFeatures (
   SetCapabilityPcd (CpuFeaturesData->CapabilityPcd, CpuFeaturesData->BitMaskSize);
   SetSettingPcd (CpuFeaturesData->SettingPcd, CpuFeaturesData->BitMaskSize);
 
-  for (ProcessorNumber = 0; ProcessorNumber < NumberOfCpus; ProcessorNumber++) {
-    CpuInitOrder = &CpuFeaturesData->InitOrder[ProcessorNumber];
-    Entry        = GetFirstNode (&CpuFeaturesData->FeatureList);
-    while (!IsNull (&CpuFeaturesData->FeatureList, Entry)) {
+  //
+  // The features in the capability PCD are supported by all processors, so every
+  // processor initializes the same ordered feature list. Build the list and the
+  // dependence between the neighbor features once for all processors.
+  //
+  InitializeListHead (&OrderList);
+  Entry = GetFirstNode (&CpuFeaturesData->FeatureList);
+  while (!IsNull (&CpuFeaturesData->FeatureList, Entry)) {
+    CpuFeature = CPU_FEATURE_ENTRY_FROM_LINK (Entry);
+    if (IsBitMaskMatch (CpuFeature->FeatureMask, CpuFeaturesData->CapabilityPcd, CpuFeaturesData->BitMaskSize)) {
+      CpuFeatureInOrder = AllocateCopyPool (sizeof (CPU_FEATURES_ENTRY), CpuFeature);
+      ASSERT (CpuFeatureInOrder != NULL);
+      InsertTailList (&OrderList, &CpuFeatureInOrder->Link);
+    }
+
+    Entry = Entry->ForwardLink;
+  }
+
+  Entry = GetFirstNode (&OrderList);
+  while (!IsNull (&OrderList, Entry)) {
+    CpuFeatureInOrder = CPU_FEATURE_ENTRY_FROM_LINK (Entry);
+    NextEntry         = Entry->ForwardLink;
+    if (!IsNull (&OrderList, NextEntry)) {
+      NextCpuFeatureInOrder = CPU_FEATURE_ENTRY_FROM_LINK (NextEntry);
+
       //
-      // Insert each feature into processor's order list
+      // If feature has dependence with the next feature (ONLY care core/package dependency).
+      // and feature initialize succeed, add sync semaphere here.
       //
-      CpuFeature = CPU_FEATURE_ENTRY_FROM_LINK (Entry);
-      if (IsBitMaskMatch (CpuFeature->FeatureMask, CpuFeaturesData->CapabilityPcd, CpuFeaturesData->BitMaskSize)) {
-        CpuFeatureInOrder = AllocateCopyPool (sizeof (CPU_FEATURES_ENTRY), CpuFeature);
-        ASSERT (CpuFeatureInOrder != NULL);
-        InsertTailList (&CpuInitOrder->OrderList, &CpuFeatureInOrder->Link);
-      }
-
-      Entry = Entry->ForwardLink;
+      BeforeDep = DetectFeatureScope (CpuFeatureInOrder, TRUE, NextCpuFeatureInOrder->FeatureMask);
+      AfterDep  = DetectFeatureScope (NextCpuFeatureInOrder, FALSE, CpuFeatureInOrder->FeatureMask);
+      //
+      // Check whether next feature has After type dependence with not neighborhood CPU
+      // Features in former CPU features.
+      //
+      NoneNeibAfterDep = DetectNoneNeighborhoodFeatureScope (NextCpuFeatureInOrder, FALSE, &OrderList);
+    } else {
+      BeforeDep        = NoneDepType;
+      AfterDep         = NoneDepType;
+      NoneNeibAfterDep = NoneDepType;
     }
 
+    //
+    // Check whether current feature has Before type dependence with none neighborhood
+    // CPU features in after Cpu features.
+    //
+    NoneNeibBeforeDep = DetectNoneNeighborhoodFeatureScope (CpuFeatureInOrder, TRUE, &OrderList);
+
+    //
+    // Get the biggest dependence and add semaphore for it.
+    // PackageDepType > CoreDepType > ThreadDepType > NoneDepType.
+    //
+    CpuFeatureInOrder->SemaphoreDep = BiggestDep (BeforeDep, AfterDep, NoneNeibBeforeDep, NoneNeibAfterDep);
+
+    Entry = NextEntry;
+  }
+
+  for (ProcessorNumber = 0; ProcessorNumber < NumberOfCpus; ProcessorNumber++) {
     //
     // Go through ordered feature list to initialize CPU features
     //
     CpuInfo = &CpuFeaturesData->InitOrder[ProcessorNumber].CpuInfo;
-    Entry   = GetFirstNode (&CpuInitOrder->OrderList);
-    while (!IsNull (&CpuInitOrder->OrderList, Entry)) {
+    Entry   = GetFirstNode (&OrderList);
+    while (!IsNull (&OrderList, Entry)) {
       CpuFeatureInOrder = CPU_FEATURE_ENTRY_FROM_LINK (Entry);
 
       Success = FALSE;
@@ -842,42 +913,8 @@ AnalysisProcessorFeatures (
         }
       }
 
-      if (Success) {
-        NextEntry = Entry->ForwardLink;
-        if (!IsNull (&CpuInitOrder->OrderList, NextEntry)) {
-          NextCpuFeatureInOrder = CPU_FEATURE_ENTRY_FROM_LINK (NextEntry);
-
-          //
-          // If feature has dependence with the next feature (ONLY care core/package dependency).
-          // and feature initialize succeed, add sync semaphere here.
-          //
-          BeforeDep = DetectFeatureScope (CpuFeatureInOrder, TRUE, NextCpuFeatureInOrder->FeatureMask);
-          AfterDep  = DetectFeatureScope (NextCpuFeatureInOrder, FALSE, CpuFeatureInOrder->FeatureMask);
-          //
-          // Check whether next feature has After type dependence with not neighborhood CPU
-          // Features in former CPU features.
-          //
-          NoneNeibAfterDep = DetectNoneNeighborhoodFeatureScope (NextCpuFeatureInOrder, FALSE, &CpuInitOrder->OrderList);
-        } else {
-          BeforeDep        = NoneDepType;
-          AfterDep         = NoneDepType;
-          NoneNeibAfterDep = NoneDepType;
-        }
-
-        //
-        // Check whether current feature has Before type dependence with none neighborhood
-        // CPU features in after Cpu features.
-        //
-        NoneNeibBeforeDep = DetectNoneNeighborhoodFeatureScope (CpuFeatureInOrder, TRUE, &CpuInitOrder->OrderList);
-
-        //
-        // Get the biggest dependence and add semaphore for it.
-        // PackageDepType > CoreDepType > ThreadDepType > NoneDepType.
-        //
-        BeforeDep = BiggestDep (BeforeDep, AfterDep, NoneNeibBeforeDep, NoneNeibAfterDep);
-        if (BeforeDep > ThreadDepType) {
-          CPU_REGISTER_TABLE_WRITE32 (ProcessorNumber, Semaphore, 0, BeforeDep);
-        }
+      if (Success && (CpuFeatureInOrder->SemaphoreDep > ThreadDepType)) {
+        CPU_REGISTER_TABLE_WRITE32 (ProcessorNumber, Semaphore, 0, CpuFeatureInOrder->SemaphoreDep);
       }
 
       Entry = Entry->ForwardLink;
@@ -895,6 +932,12 @@ AnalysisProcessorFeatures (
     //
     DumpRegisterTableOnProcessor (ProcessorNumber);
   }
+
+  while (!IsListEmpty (&OrderList)) {
+    Entry = GetFirstNode (&OrderList);
+    RemoveEntryList (Entry);
+    FreePool (CPU_FEATURE_ENTRY_FROM_LINK (Entry));
+  }
 }
 
 /**
@@ -1025,6 +1068,11 @@ ProgramProcessorRegister (
   UINT8                     *ThreadCountPerCore;
   EFI_STATUS                Status;
   UINT64                    CurrentValue;
+  UINT32                    CoreBarrier;
+  UINT32                    PackageBarrier;
+
+  CoreBarrier    = 0;
+  PackageBarrier = 0;
 
   //
   // Traverse Register Table of this logical processor
@@ -1153,12 +1201,28 @@ ProgramProcessorRegister (
         //  V(0...n)       V(0...n)      ...           V(0...n)
         //  n * P(0)       n * P(1)      ...           n * P(n)
         //
+        // When the barrier counters are allocated, each thread increments the
+        // counter of its core or package once and waits until all valid threads
+        // have reached the same barrier. It takes one atomic operation per
+        // thread instead of one per thread pair.
+        //
         switch (RegisterTableEntry->Value) {
           case CoreDepType:
             SemaphorePtr       = CpuFlags->CoreSemaphoreCount;
             ThreadCountPerCore = (UINT8 *)(UINTN)CpuStatus->ThreadCountPerCore;
 
             CurrentCore = ApLocation->Package * CpuStatus->MaxCoreCount + ApLocation->Core;
+            if (CpuFlags->CoreBarrierCount != NULL) {
+              CoreBarrier++;
+              SemaphorePtr = &CpuFlags->CoreBarrierCount[CurrentCore * CpuFlags->BarrierStride];
+              InterlockedIncrement (SemaphorePtr);
+              while (*SemaphorePtr < ThreadCountPerCore[CurrentCore] * CoreBarrier) {
+                CpuPause ();
+              }
+
+              break;
+            }
+
             //
             // Get Offset info for the first thread in the core which current thread belongs to.
             //
@@ -1196,6 +1260,17 @@ ProgramProcessorRegister (
           case PackageDepType:
             SemaphorePtr          = CpuFlags->PackageSemaphoreCount;
             ThreadCountPerPackage = (UINT32 *)(UINTN)CpuStatus->ThreadCountPerPackage;
+            if (CpuFlags->PackageBarrierCount != NULL) {
+              PackageBarrier++;
+              SemaphorePtr = &CpuFlags->PackageBarrierCount[ApLocation->Package * CpuFlags->BarrierStride];
+              InterlockedIncrement (SemaphorePtr);
+              while (*SemaphorePtr < ThreadCountPerPackage[ApLocation->Package] * PackageBarrier) {
+                CpuPause ();
+              }
+
+              break;
+            }
+
             //
             // Get Offset info for the first thread in the package which current thread belongs to.
             //
@@ -1245,6 +1320,136 @@ ProgramProcessorRegister (
   }
 }
 
+/**
+  Let the processors with identical register tables share one register table buffer.
+
+  The buffers of the duplicated register tables are freed. Every register table
+  that shares a buffer is marked in Shared, so that adding a new entry to it
+  copies the entries to a new buffer instead of changing the shared one. The
+  AllocatedSize of a register table is the size of the buffer it points to,
+  shared or not.
+
+  @param[in, out] RegisterTables  The register tables of all processors.
+  @param[in, out] Shared          The shared marks of the register tables.
+  @param[in]      NumberOfCpus    The number of the register tables.
+
+  @return The number of the pages that are freed.
+**/
+UINTN
+DeduplicateRegisterTables (
+  IN OUT CPU_REGISTER_TABLE  *RegisterTables,
+  IN OUT BOOLEAN             *Shared,
+  IN     UINTN               NumberOfCpus
+  )
+{
+  UINTN               Index;
+  UINTN               UniqueIndex;
+  CPU_REGISTER_TABLE  *RegisterTable;
+  CPU_REGISTER_TABLE  *UniqueTable;
+  UINTN               FreedPages;
+
+  FreedPages = 0;
+  for (Index = 1; Index < NumberOfCpus; Index++) {
+    RegisterTable = &RegisterTables[Index];
+    if ((RegisterTable->TableLength == 0) || Shared[Index]) {
+      continue;
+    }
+
+    for (UniqueIndex = 0; UniqueIndex < Index; UniqueIndex++) {
+      UniqueTable = &RegisterTables[UniqueIndex];
+      if ((UniqueTable->TableLength == RegisterTable->TableLength) &&
+          (UniqueTable->RegisterTableEntry != RegisterTable->RegisterTableEntry) &&
+          (CompareMem (
+             (VOID *)(UINTN)UniqueTable->RegisterTableEntry,
+             (VOID *)(UINTN)RegisterTable->RegisterTableEntry,
+             RegisterTable->TableLength * sizeof (CPU_REGISTER_TABLE_ENTRY)
+             ) == 0))
+      {
+        FreePages ((VOID *)(UINTN)RegisterTable->RegisterTableEntry, EFI_SIZE_TO_PAGES (RegisterTable->AllocatedSize));
+        FreedPages                       += EFI_SIZE_TO_PAGES (RegisterTable->AllocatedSize);
+        RegisterTable->RegisterTableEntry = UniqueTable->RegisterTableEntry;
+        RegisterTable->AllocatedSize      = UniqueTable->AllocatedSize;
+        Shared[Index]                     = TRUE;
+        Shared[UniqueIndex]               = TRUE;
+        break;
+      }
+    }
+  }
+
+  return FreedPages;
+}
+
+/**
+  Prepares the register tables and the synchronization data before the
+  registers of all processors are programmed.
+
+  @param[in] CpuFeaturesData  The pointer to CPU feature data structure.
+**/
+VOID
+PrepareProcessorRegister (
+  IN CPU_FEATURES_DATA  *CpuFeaturesData
+  )
+{
+  ACPI_CPU_DATA           *AcpiCpuData;
+  CPU_STATUS_INFORMATION  *CpuStatus;
+  UINTN                   RegisterTablePages;
+  UINTN                   PreSmmRegisterTablePages;
+
+  AcpiCpuData = CpuFeaturesData->AcpiCpuData;
+  CpuStatus   = &AcpiCpuData->CpuFeatureInitData.CpuStatus;
+
+  if (CpuFeaturesData->CpuFlags.CoreBarrierCount != NULL) {
+    ZeroMem (
+      (VOID *)CpuFeaturesData->CpuFlags.CoreBarrierCount,
+      sizeof (UINT32) * CpuFeaturesData->CpuFlags.BarrierStride * CpuStatus->PackageCount * CpuStatus->MaxCoreCount
+      );
+    ZeroMem (
+      (VOID *)CpuFeaturesData->CpuFlags.PackageBarrierCount,
+      sizeof (UINT32) * CpuFeaturesData->CpuFlags.BarrierStride * CpuStatus->PackageCount
+      );
+  }
+
+  if (PcdGetBool (PcdCpuFeaturesParallelProgramming)) {
+    if (CpuFeaturesData->RegisterTableShared == NULL) {
+      CpuFeaturesData->RegisterTableShared       = AllocateZeroPool (sizeof (BOOLEAN) * AcpiCpuData->NumberOfCpus);
+      CpuFeaturesData->PreSmmRegisterTableShared = AllocateZeroPool (sizeof (BOOLEAN) * AcpiCpuData->NumberOfCpus);
+      if ((CpuFeaturesData->RegisterTableShared == NULL) || (CpuFeaturesData->PreSmmRegisterTableShared == NULL)) {
+        //
+        // Without the shared marks the register tables are kept as they are.
+        //
+        if (CpuFeaturesData->RegisterTableShared != NULL) {
+          FreePool (CpuFeaturesData->RegisterTableShared);
+          CpuFeaturesData->RegisterTableShared = NULL;
+        }
+
+        if (CpuFeaturesData->PreSmmRegisterTableShared != NULL) {
+          FreePool (CpuFeaturesData->PreSmmRegisterTableShared);
+          CpuFeaturesData->PreSmmRegisterTableShared = NULL;
+        }
+
+        return;
+      }
+    }
+
+    RegisterTablePages = DeduplicateRegisterTables (
+                           (CPU_REGISTER_TABLE *)(UINTN)AcpiCpuData->CpuFeatureInitData.RegisterTable,
+                           CpuFeaturesData->RegisterTableShared,
+                           AcpiCpuData->NumberOfCpus
+                           );
+    PreSmmRegisterTablePages = DeduplicateRegisterTables (
+                                 (CPU_REGISTER_TABLE *)(UINTN)AcpiCpuData->CpuFeatureInitData.PreSmmInitRegisterTable,
+                                 CpuFeaturesData->PreSmmRegisterTableShared,
+                                 AcpiCpuData->NumberOfCpus
+                                 );
+    DEBUG ((
+      DEBUG_INFO,
+      "PrepareProcessorRegister: Freed %Lu pages of duplicated register tables and %Lu pages of duplicated pre-SMM register tables\n",
+      (UINT64)RegisterTablePages,
+      (UINT64)PreSmmRegisterTablePages
+      ));
+  }
+}
+
 /**
   Programs registers for the calling processor.
 
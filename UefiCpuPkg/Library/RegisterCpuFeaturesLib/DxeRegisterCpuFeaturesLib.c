@@ -235,6 +235,8 @@ CpuFeaturesInitialize (
   //
   MpEvent = NULL;
 
+  PrepareProcessorRegister (CpuFeaturesData);
+
   if (CpuFeaturesData->NumberOfCpus > 1) {
     Status = gBS->CreateEvent (
                     EVT_NOTIFY_WAIT,
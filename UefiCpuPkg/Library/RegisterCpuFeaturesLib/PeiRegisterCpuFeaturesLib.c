@@ -294,6 +294,8 @@ CpuFeaturesInitialize (
   OldBspNumber               = GetProcessorIndex (CpuFeaturesData);
   CpuFeaturesData->BspNumber = OldBspNumber;
 
+  PrepareProcessorRegister (CpuFeaturesData);
+
   //
   // Start to program register for all CPUs.
   //
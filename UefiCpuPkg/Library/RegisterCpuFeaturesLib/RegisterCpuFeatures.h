@@ -32,7 +32,6 @@
 typedef struct {
   REGISTER_CPU_FEATURE_INFORMATION    CpuInfo;
   UINT8                               *FeaturesSupportedMask;
-  LIST_ENTRY                          OrderList;
 } CPU_FEATURES_INIT_ORDER;
 
 typedef struct {
@@ -52,6 +51,7 @@ typedef struct {
   VOID                           *ConfigData;
   BOOLEAN                        BeforeAll;
   BOOLEAN                        AfterAll;
+  CPU_FEATURE_DEPENDENCE_TYPE    SemaphoreDep;
 } CPU_FEATURES_ENTRY;
 
 //
@@ -61,6 +61,9 @@ typedef struct {
   volatile UINTN     MemoryMappedLock;              // Spinlock used to program mmio
   volatile UINT32    *CoreSemaphoreCount;           // Semaphore containers used to program Core semaphore.
   volatile UINT32    *PackageSemaphoreCount;        // Semaphore containers used to program Package semaphore.
+  volatile UINT32    *CoreBarrierCount;             // Barrier counters used to program Core semaphore, NULL if not used.
+  volatile UINT32    *PackageBarrierCount;          // Barrier counters used to program Package semaphore, NULL if not used.
+  UINTN              BarrierStride;                 // Number of UINT32 between two barrier counters.
 } PROGRAM_CPU_REGISTER_FLAGS;
 
 typedef union {
@@ -82,6 +85,12 @@ typedef struct {
 
   CPU_REGISTER_TABLE            *RegisterTable;
   CPU_REGISTER_TABLE            *PreSmmRegisterTable;
+  //
+  // TRUE for a register table whose buffer is shared with other processors,
+  // NULL if no register table is shared.
+  //
+  BOOLEAN                       *RegisterTableShared;
+  BOOLEAN                       *PreSmmRegisterTableShared;
   UINTN                         BspNumber;
 
   PROGRAM_CPU_REGISTER_FLAGS    CpuFlags;
@@ -245,6 +254,18 @@ SetProcessorRegister (
   IN OUT VOID  *Buffer
   );
 
+/**
+  Prepares the register tables and the semaphores before programming the processors.
+
+  @param[in] CpuFeaturesData    Cpu Feature Data structure.
+
+  @note This service could be called by BSP only.
+**/
+VOID
+PrepareProcessorRegister (
+  IN CPU_FEATURES_DATA  *CpuFeaturesData
+  );
+
 /**
   Return ACPI_CPU_DATA data.
 
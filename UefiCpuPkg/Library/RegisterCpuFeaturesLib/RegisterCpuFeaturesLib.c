@@ -1049,39 +1049,50 @@ GetAcpiCpuData (
 /**
   Enlarges CPU register table for each processor.
 
+  The entries of a register table whose buffer is shared with other processors
+  are copied to a new buffer owned by the register table, and the shared buffer
+  is left unchanged.
+
   @param[in, out]  RegisterTable   Pointer processor's CPU register table
+  @param[in]       Shared          TRUE if the buffer of the register table is
+                                   shared with other processors.
 **/
 STATIC
 VOID
 EnlargeRegisterTable (
-  IN OUT CPU_REGISTER_TABLE  *RegisterTable
+  IN OUT CPU_REGISTER_TABLE  *RegisterTable,
+  IN     BOOLEAN             Shared
   )
 {
   EFI_PHYSICAL_ADDRESS  Address;
   UINTN                 UsedPages;
+  UINTN                 Pages;
 
   UsedPages = RegisterTable->AllocatedSize / EFI_PAGE_SIZE;
-  Address   = (UINTN)AllocatePages (UsedPages + 1);
+  Pages     = MAX (UsedPages + 1, EFI_SIZE_TO_PAGES ((RegisterTable->TableLength + 1) * sizeof (CPU_REGISTER_TABLE_ENTRY)));
+  Address   = (UINTN)AllocatePages (Pages);
   ASSERT (Address != 0);
 
   //
   // If there are records existing in the register table, then copy its contents
   // to new region and free the old one.
   //
-  if (RegisterTable->AllocatedSize > 0) {
+  if (RegisterTable->TableLength > 0) {
     CopyMem (
       (VOID *)(UINTN)Address,
       (VOID *)(UINTN)RegisterTable->RegisterTableEntry,
-      RegisterTable->AllocatedSize
+      RegisterTable->TableLength * sizeof (CPU_REGISTER_TABLE_ENTRY)
       );
+  }
 
+  if ((RegisterTable->AllocatedSize > 0) && !Shared) {
     FreePages ((VOID *)(UINTN)RegisterTable->RegisterTableEntry, UsedPages);
   }
 
   //
   // Adjust the allocated size and register table base address.
   //
-  RegisterTable->AllocatedSize     += EFI_PAGE_SIZE;
+  RegisterTable->AllocatedSize      = (UINT32)EFI_PAGES_TO_SIZE (Pages);
   RegisterTable->RegisterTableEntry = Address;
 }
 
@@ -1118,6 +1129,7 @@ CpuRegisterTableWriteWorker (
   ACPI_CPU_DATA             *AcpiCpuData;
   CPU_REGISTER_TABLE        *RegisterTable;
   CPU_REGISTER_TABLE_ENTRY  *RegisterTableEntry;
+  BOOLEAN                   *Shared;
 
   CpuFeaturesData = GetCpuFeaturesData ();
   if (CpuFeaturesData->RegisterTable == NULL) {
@@ -1134,12 +1146,20 @@ CpuRegisterTableWriteWorker (
 
   if (PreSmmFlag) {
     RegisterTable = &CpuFeaturesData->PreSmmRegisterTable[ProcessorNumber];
+    Shared        = CpuFeaturesData->PreSmmRegisterTableShared;
   } else {
     RegisterTable = &CpuFeaturesData->RegisterTable[ProcessorNumber];
+    Shared        = CpuFeaturesData->RegisterTableShared;
   }
 
-  if (RegisterTable->TableLength == RegisterTable->AllocatedSize / sizeof (CPU_REGISTER_TABLE_ENTRY)) {
-    EnlargeRegisterTable (RegisterTable);
+  //
+  // A shared buffer is copied before it is changed.
+  //
+  if ((Shared != NULL) && Shared[ProcessorNumber]) {
+    EnlargeRegisterTable (RegisterTable, TRUE);
+    Shared[ProcessorNumber] = FALSE;
+  } else if (RegisterTable->TableLength >= RegisterTable->AllocatedSize / sizeof (CPU_REGISTER_TABLE_ENTRY)) {
+    EnlargeRegisterTable (RegisterTable, FALSE);
   }
 
   //
@@ -1153,6 +1173,7 @@ CpuRegisterTableWriteWorker (
   RegisterTableEntry[RegisterTable->TableLength].ValidBitLength = ValidBitLength;
   RegisterTableEntry[RegisterTable->TableLength].Value          = Value;
   RegisterTableEntry[RegisterTable->TableLength].TestThenWrite  = TestThenWrite;
+  RegisterTableEntry[RegisterTable->TableLength].Reserved1      = 0;
 
   RegisterTable->TableLength++;
 }
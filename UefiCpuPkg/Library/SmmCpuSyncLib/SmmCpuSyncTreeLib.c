@@ -0,0 +1,757 @@
+/** @file
+  SMM CPU Sync lib implementation with topology-aware CPU groups.
+
+  The lib provides the same APIs as SmmCpuSyncLib.c. Instead of one counter shared by
+  all CPUs for check-in, and one BSP semaphore released by all APs, the CPUs are
+  split into groups:
+  1. Each group holds the CPUs of at most SMM_CPU_SYNC_GROUP_SIZE threads of one
+     package. The threads of one core are never split between two groups.
+  2. Each group has its own check-in counter and its own counter of APs that released
+     the BSP, each placed on an exclusive cache line.
+  3. The BSP adds up the counters of all groups. Locking the door locks the check-in
+     counter of every group.
+
+  A CPU only contends with the other CPUs of its group, so the cost of one SMI
+  rendezvous no longer grows with the number of CPUs bouncing one cache line. The
+  per-AP semaphores used by ReleaseOneAp()/WaitForBsp() are the same as in
+  SmmCpuSyncLib.c.
+
+  The package and core of each CPU are taken from the gMpInformation2HobGuid HOBs.
+  CPUs not described by the HOBs are grouped by CPU index.
+
+  Copyright (c) 2023 - 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <PiMm.h>
+#include <Guid/MpInformation2.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/HobLib.h>
+#include "InternalSmmCpuSyncLib.h"
+
+///
+/// The maximum number of CPUs in one group.
+///
+#define SMM_CPU_SYNC_GROUP_SIZE  16
+
+typedef struct {
+  ///
+  /// Before the door is locked, CheckedIn stores the arrived CPU count of the group.
+  /// After the door is locked, CheckedIn is set to -1 and CheckedInUponLock stores
+  /// the arrived CPU count of the group then.
+  ///
+  SMM_CPU_SYNC_SEMAPHORE    *CheckedIn;
+  ///
+  /// Number of APs in the group that released the BSP since the context was reset.
+  ///
+  SMM_CPU_SYNC_SEMAPHORE    *Released;
+  UINT32                    CheckedInUponLock;
+} SMM_CPU_SYNC_GROUP;
+
+typedef struct {
+  ///
+  /// Used for control each CPU continue run or wait for signal
+  ///
+  SMM_CPU_SYNC_SEMAPHORE    *Run;
+  ///
+  /// The group of the CPU.
+  ///
+  SMM_CPU_SYNC_GROUP        *Group;
+} SMM_CPU_SYNC_SEMAPHORE_FOR_EACH_CPU;
+
+struct SMM_CPU_SYNC_CONTEXT  {
+  ///
+  /// Indicate all CPUs in the system.
+  ///
+  UINTN                                  NumberOfCpus;
+  ///
+  /// Number of CPU groups.
+  ///
+  UINTN                                  NumberOfGroups;
+  ///
+  /// Array of CPU groups.
+  ///
+  SMM_CPU_SYNC_GROUP                     *Group;
+  ///
+  /// Address of semaphores.
+  ///
+  VOID                                   *SemBuffer;
+  ///
+  /// Size of semaphores.
+  ///
+  UINTN                                  SemBufferPages;
+  ///
+  /// TRUE after the door is locked. ArrivedCpuCountUponLock stores the arrived CPU count then.
+  ///
+  volatile BOOLEAN                       DoorLocked;
+  UINTN                                  ArrivedCpuCountUponLock;
+  ///
+  /// Number of AP releases the BSP has waited for since the context was reset.
+  ///
+  UINT32                                 BspWaitedCount;
+  ///
+  /// Define an array of structure for each CPU semaphore due to the size alignment
+  /// requirement. With the array of structure for each CPU semaphore, it's easy to
+  /// reach the specific CPU with CPU Index for its own semaphore access: CpuSem[CpuIndex].
+  ///
+  SMM_CPU_SYNC_SEMAPHORE_FOR_EACH_CPU    CpuSem[];
+};
+
+/**
+  Assign each CPU to a group.
+
+  A new group is started for a new package, or when the current group is full and a
+  new core starts.
+
+  @param[in]  NumberOfCpus    The number of Logical Processors in the system.
+  @param[out] GroupIndex      Array of NumberOfCpus entries receiving the group index
+                              of each CPU.
+
+  @return The number of groups.
+
+**/
+STATIC
+UINTN
+InternalAssignCpuGroups (
+  IN  UINTN   NumberOfCpus,
+  OUT UINT32  *GroupIndex
+  )
+{
+  EFI_HOB_GUID_TYPE          *GuidHob;
+  MP_INFORMATION2_HOB_DATA   *MpInformation2HobData;
+  MP_INFORMATION2_ENTRY      *MpInformation2Entry;
+  EFI_CPU_PHYSICAL_LOCATION  *Location;
+  UINTN                      CpuIndex;
+  UINTN                      Index;
+  UINTN                      NumberOfGroups;
+  UINTN                      GroupSize;
+  UINT32                     Package;
+  UINT32                     Core;
+  UINT32                     PrevPackage;
+  UINT32                     PrevCore;
+
+  //
+  // Get the package and core of each CPU.
+  //
+  Location = AllocateZeroPool (NumberOfCpus * sizeof (EFI_CPU_PHYSICAL_LOCATION));
+  if (Location != NULL) {
+    for (CpuIndex = 0; CpuIndex < NumberOfCpus; CpuIndex++) {
+      //
+      // CPUs not described by the HOBs are grouped by CPU index.
+      //
+      Location[CpuIndex].Package = MAX_UINT32;
+      Location[CpuIndex].Core    = (UINT32)CpuIndex;
+    }
+
+    GuidHob = GetFirstGuidHob (&gMpInformation2HobGuid);
+    while (GuidHob != NULL) {
+      MpInformation2HobData = GET_GUID_HOB_DATA (GuidHob);
+      if (MpInformation2HobData->NumberOfProcessors == 0) {
+        break;
+      }
+
+      for (Index = 0; Index < MpInformation2HobData->NumberOfProcessors; Index++) {
+        CpuIndex = (UINTN)MpInformation2HobData->ProcessorIndex + Index;
+        if (CpuIndex < NumberOfCpus) {
+          MpInformation2Entry = GET_MP_INFORMATION_ENTRY (MpInformation2HobData, Index);
+          CopyMem (&Location[CpuIndex], &MpInformation2Entry->ProcessorInfo.Location, sizeof (EFI_CPU_PHYSICAL_LOCATION));
+        }
+      }
+
+      GuidHob = GetNextGuidHob (&gMpInformation2HobGuid, GET_NEXT_HOB (GuidHob));
+    }
+  }
+
+  NumberOfGroups = 0;
+  GroupSize      = 0;
+  PrevPackage    = MAX_UINT32;
+  PrevCore       = MAX_UINT32;
+  for (CpuIndex = 0; CpuIndex < NumberOfCpus; CpuIndex++) {
+    if (Location != NULL) {
+      Package = Location[CpuIndex].Package;
+      Core    = Location[CpuIndex].Core;
+    } else {
+      Package = MAX_UINT32;
+      Core    = (UINT32)CpuIndex;
+    }
+
+    if ((NumberOfGroups == 0) ||
+        (Package != PrevPackage) ||
+        ((GroupSize >= SMM_CPU_SYNC_GROUP_SIZE) && (Core != PrevCore)))
+    {
+      NumberOfGroups++;
+      GroupSize = 0;
+    }
+
+    GroupIndex[CpuIndex] = (UINT32)(NumberOfGroups - 1);
+    GroupSize++;
+    PrevPackage = Package;
+    PrevCore    = Core;
+  }
+
+  if (Location != NULL) {
+    FreePool (Location);
+  }
+
+  return NumberOfGroups;
+}
+
+/**
+  Create and initialize the SMM CPU Sync context. It is to allocate and initialize the
+  SMM CPU Sync context.
+
+  If Context is NULL, then ASSERT().
+
+  @param[in]  NumberOfCpus          The number of Logical Processors in the system.
+  @param[out] Context               Pointer to the new created and initialized SMM CPU Sync context object.
+                                    NULL will be returned if any error happen during init.
+
+  @retval RETURN_SUCCESS            The SMM CPU Sync context was successful created and initialized.
+  @retval RETURN_OUT_OF_RESOURCES   There are not enough resources available to create and initialize SMM CPU Sync context.
+  @retval RETURN_BUFFER_TOO_SMALL   Overflow happen
+
+**/
+RETURN_STATUS
+EFIAPI
+SmmCpuSyncContextInit (
+  IN   UINTN                 NumberOfCpus,
+  OUT  SMM_CPU_SYNC_CONTEXT  **Context
+  )
+{
+  RETURN_STATUS                        Status;
+  UINTN                                ContextSize;
+  UINTN                                GroupSize;
+  UINTN                                OneSemSize;
+  UINTN                                NumSem;
+  UINTN                                TotalSemSize;
+  UINTN                                SemAddr;
+  UINTN                                CpuIndex;
+  UINTN                                GroupIndex;
+  UINT32                               *CpuGroupIndex;
+  SMM_CPU_SYNC_GROUP                   *Group;
+  SMM_CPU_SYNC_SEMAPHORE_FOR_EACH_CPU  *CpuSem;
+
+  ASSERT (Context != NULL);
+
+  //
+  // Calculate ContextSize
+  //
+  Status = SafeUintnMult (NumberOfCpus, sizeof (SMM_CPU_SYNC_SEMAPHORE_FOR_EACH_CPU), &ContextSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = SafeUintnAdd (ContextSize, sizeof (SMM_CPU_SYNC_CONTEXT), &ContextSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  //
+  // Assign the CPUs to groups
+  //
+  Status = SafeUintnMult (NumberOfCpus, sizeof (UINT32), &GroupSize);
+  if (RETURN_ERROR (Status)) {
+    return Status;
+  }
+
+  CpuGroupIndex = AllocatePool (GroupSize);
+  if (CpuGroupIndex == NULL) {
+    return RETURN_OUT_OF_RESOURCES;
+  }
+
+  //
+  // Allocate Buffer for Context
+  //
+  *Context = AllocatePool (ContextSize);
+  if (*Context == NULL) {
+    FreePool (CpuGroupIndex);
+    return RETURN_OUT_OF_RESOURCES;
+  }
+
+  (*Context)->NumberOfCpus            = NumberOfCpus;
+  (*Context)->NumberOfGroups          = InternalAssignCpuGroups (NumberOfCpus, CpuGroupIndex);
+  (*Context)->DoorLocked              = FALSE;
+  (*Context)->ArrivedCpuCountUponLock = 0;
+  (*Context)->BspWaitedCount          = 0;
+  (*Context)->SemBuffer               = NULL;
+
+  (*Context)->Group = AllocateZeroPool ((*Context)->NumberOfGroups * sizeof (SMM_CPU_SYNC_GROUP));
+  if ((*Context)->Group == NULL) {
+    Status = RETURN_OUT_OF_RESOURCES;
+    goto ON_ERROR;
+  }
+
+  //
+  // Calculate total semaphore size: 2 semaphores for each group and 1 for each CPU.
+  //
+  OneSemSize = GetSpinLockProperties ();
+  ASSERT (sizeof (SMM_CPU_SYNC_SEMAPHORE) <= OneSemSize);
+
+  Status = SafeUintnMult (2, (*Context)->NumberOfGroups, &NumSem);
+  if (RETURN_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = SafeUintnAdd (NumSem, NumberOfCpus, &NumSem);
+  if (RETURN_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  Status = SafeUintnMult (NumSem, OneSemSize, &TotalSemSize);
+  if (RETURN_ERROR (Status)) {
+    goto ON_ERROR;
+  }
+
+  //
+  // Allocate for Semaphores in the *Context
+  //
+  (*Context)->SemBufferPages = EFI_SIZE_TO_PAGES (TotalSemSize);
+  (*Context)->SemBuffer      = AllocatePages ((*Context)->SemBufferPages);
+  if ((*Context)->SemBuffer == NULL) {
+    Status = RETURN_OUT_OF_RESOURCES;
+    goto ON_ERROR;
+  }
+
+  //
+  // Assign Group Semaphore pointer
+  //
+  SemAddr = (UINTN)(*Context)->SemBuffer;
+  for (GroupIndex = 0; GroupIndex < (*Context)->NumberOfGroups; GroupIndex++) {
+    Group             = &(*Context)->Group[GroupIndex];
+    Group->CheckedIn  = (SMM_CPU_SYNC_SEMAPHORE *)SemAddr;
+    *Group->CheckedIn = 0;
+    SemAddr          += OneSemSize;
+    Group->Released   = (SMM_CPU_SYNC_SEMAPHORE *)SemAddr;
+    *Group->Released  = 0;
+    SemAddr          += OneSemSize;
+  }
+
+  //
+  // Assign CPU Semaphore pointer
+  //
+  CpuSem = (*Context)->CpuSem;
+  for (CpuIndex = 0; CpuIndex < NumberOfCpus; CpuIndex++) {
+    CpuSem->Run   = (SMM_CPU_SYNC_SEMAPHORE *)SemAddr;
+    *CpuSem->Run  = 0;
+    CpuSem->Group = &(*Context)->Group[CpuGroupIndex[CpuIndex]];
+
+    CpuSem++;
+    SemAddr += OneSemSize;
+  }
+
+  DEBUG ((DEBUG_INFO, "SmmCpuSyncContextInit: %d CPUs in %d groups\n", (UINT32)NumberOfCpus, (UINT32)(*Context)->NumberOfGroups));
+
+  FreePool (CpuGroupIndex);
+  return RETURN_SUCCESS;
+
+ON_ERROR:
+  if ((*Context)->Group != NULL) {
+    FreePool ((*Context)->Group);
+  }
+
+  FreePool (*Context);
+  FreePool (CpuGroupIndex);
+  return Status;
+}
+
+/**
+  Deinit an allocated SMM CPU Sync context. The resources allocated in SmmCpuSyncContextInit() will
+  be freed.
+
+  If Context is NULL, then ASSERT().
+
+  @param[in,out]  Context     Pointer to the SMM CPU Sync context object to be deinitialized.
+
+**/
+VOID
+EFIAPI
+SmmCpuSyncContextDeinit (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context
+  )
+{
+  ASSERT (Context != NULL);
+
+  FreePages (Context->SemBuffer, Context->SemBufferPages);
+
+  FreePool (Context->Group);
+
+  FreePool (Context);
+}
+
+/**
+  Reset SMM CPU Sync context. SMM CPU Sync context will be reset to the initialized state.
+
+  This function is called by one of CPUs after all CPUs are ready to exit SMI, which allows CPU to
+  check into the next SMI from this point.
+
+  If Context is NULL, then ASSERT().
+
+  @param[in,out]  Context     Pointer to the SMM CPU Sync context object to be reset.
+
+**/
+VOID
+EFIAPI
+SmmCpuSyncContextReset (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context
+  )
+{
+  UINTN               GroupIndex;
+  SMM_CPU_SYNC_GROUP  *Group;
+
+  ASSERT (Context != NULL);
+
+  Context->BspWaitedCount          = 0;
+  Context->ArrivedCpuCountUponLock = 0;
+  Context->DoorLocked              = FALSE;
+
+  for (GroupIndex = 0; GroupIndex < Context->NumberOfGroups; GroupIndex++) {
+    Group                    = &Context->Group[GroupIndex];
+    Group->CheckedInUponLock = 0;
+    *Group->Released         = 0;
+    *Group->CheckedIn        = 0;
+  }
+}
+
+/**
+  Get current number of arrived CPU in SMI.
+
+  BSP might need to know the current number of arrived CPU in SMI to make sure all APs
+  in SMI. This API can be for that purpose.
+
+  If Context is NULL, then ASSERT().
+
+  @param[in]      Context     Pointer to the SMM CPU Sync context object.
+
+  @retval    Current number of arrived CPU in SMI.
+
+**/
+UINTN
+EFIAPI
+SmmCpuSyncGetArrivedCpuCount (
+  IN  SMM_CPU_SYNC_CONTEXT  *Context
+  )
+{
+  UINTN               GroupIndex;
+  UINTN               Arrived;
+  UINT32              Value;
+  SMM_CPU_SYNC_GROUP  *Group;
+
+  ASSERT (Context != NULL);
+
+  if (Context->DoorLocked) {
+    return Context->ArrivedCpuCountUponLock;
+  }
+
+  Arrived = 0;
+  for (GroupIndex = 0; GroupIndex < Context->NumberOfGroups; GroupIndex++) {
+    Group = &Context->Group[GroupIndex];
+    Value = *Group->CheckedIn;
+    if (Value == MAX_UINT32) {
+      Value = Group->CheckedInUponLock;
+    }
+
+    Arrived += Value;
+  }
+
+  return Arrived;
+}
+
+/**
+  Performs an atomic operation to check in CPU.
+
+  When SMI happens, all processors including BSP enter to SMM mode by calling SmmCpuSyncCheckInCpu().
+
+  If Context is NULL, then ASSERT().
+  If CpuIndex exceeds the range of all CPUs in the system, then ASSERT().
+
+  @param[in,out]  Context           Pointer to the SMM CPU Sync context object.
+  @param[in]      CpuIndex          Check in CPU index.
+
+  @retval RETURN_SUCCESS            Check in CPU (CpuIndex) successfully.
+  @retval RETURN_ABORTED            Check in CPU failed due to SmmCpuSyncLockDoor() has been called by one elected CPU.
+
+**/
+RETURN_STATUS
+EFIAPI
+SmmCpuSyncCheckInCpu (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context,
+  IN     UINTN                 CpuIndex
+  )
+{
+  ASSERT (Context != NULL);
+
+  ASSERT (CpuIndex < Context->NumberOfCpus);
+
+  //
+  // Check to return if the CheckedIn of the group has already been locked.
+  //
+  if (InternalReleaseSemaphore (Context->CpuSem[CpuIndex].Group->CheckedIn) == MAX_UINT32) {
+    return RETURN_ABORTED;
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Performs an atomic operation to check out CPU.
+
+  This function can be called in error handling flow for the CPU who calls CheckInCpu() earlier.
+  The caller shall make sure the CPU specified by CpuIndex has already checked-in.
+
+  If Context is NULL, then ASSERT().
+  If CpuIndex exceeds the range of all CPUs in the system, then ASSERT().
+
+  @param[in,out]  Context           Pointer to the SMM CPU Sync context object.
+  @param[in]      CpuIndex          Check out CPU index.
+
+  @retval RETURN_SUCCESS            Check out CPU (CpuIndex) successfully.
+  @retval RETURN_ABORTED            Check out CPU failed due to SmmCpuSyncLockDoor() has been called by one elected CPU.
+
+**/
+RETURN_STATUS
+EFIAPI
+SmmCpuSyncCheckOutCpu (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context,
+  IN     UINTN                 CpuIndex
+  )
+{
+  ASSERT (Context != NULL);
+
+  ASSERT (CpuIndex < Context->NumberOfCpus);
+
+  if (InternalWaitForSemaphore (Context->CpuSem[CpuIndex].Group->CheckedIn) == MAX_UINT32) {
+    return RETURN_ABORTED;
+  }
+
+  return RETURN_SUCCESS;
+}
+
+/**
+  Performs an atomic operation lock door for CPU checkin and checkout. After this function:
+  CPU can not check in via SmmCpuSyncCheckInCpu().
+  CPU can not check out via SmmCpuSyncCheckOutCpu().
+
+  The CPU specified by CpuIndex is elected to lock door. The caller shall make sure the CpuIndex
+  is the actual CPU calling this function to avoid the undefined behavior.
+
+  If Context is NULL, then ASSERT().
+  If CpuCount is NULL, then ASSERT().
+  If CpuIndex exceeds the range of all CPUs in the system, then ASSERT().
+
+  @param[in,out]  Context           Pointer to the SMM CPU Sync context object.
+  @param[in]      CpuIndex          Indicate which CPU to lock door.
+  @param[out]     CpuCount          Number of arrived CPU in SMI after look door.
+
+**/
+VOID
+EFIAPI
+SmmCpuSyncLockDoor (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context,
+  IN     UINTN                 CpuIndex,
+  OUT UINTN                    *CpuCount
+  )
+{
+  UINTN               GroupIndex;
+  UINTN               Arrived;
+  SMM_CPU_SYNC_GROUP  *Group;
+
+  ASSERT (Context != NULL);
+
+  ASSERT (CpuCount != NULL);
+
+  ASSERT (CpuIndex < Context->NumberOfCpus);
+
+  //
+  // Lock the door of each group. The CPUs of one group that check in before its door
+  // is locked are counted, no matter whether the doors of other groups are locked.
+  //
+  Arrived = 0;
+  for (GroupIndex = 0; GroupIndex < Context->NumberOfGroups; GroupIndex++) {
+    Group = &Context->Group[GroupIndex];
+
+    //
+    // Temporarily record the CheckedIn into the CheckedInUponLock before lock door.
+    // Recording before lock door is to avoid the CheckedIn is locked but possible
+    // CheckedInUponLock is not updated.
+    //
+    Group->CheckedInUponLock = *Group->CheckedIn;
+    Group->CheckedInUponLock = InternalLockdownSemaphore (Group->CheckedIn);
+    Arrived                 += Group->CheckedInUponLock;
+  }
+
+  Context->ArrivedCpuCountUponLock = Arrived;
+  Context->DoorLocked              = TRUE;
+
+  *CpuCount = Arrived;
+}
+
+/**
+  Used by the BSP to wait for APs.
+
+  The number of APs need to be waited is specified by NumberOfAPs. The BSP is specified by BspIndex.
+  The caller shall make sure the BspIndex is the actual CPU calling this function to avoid the undefined behavior.
+  The caller shall make sure the NumberOfAPs have already checked-in to avoid the undefined behavior.
+
+  If Context is NULL, then ASSERT().
+  If NumberOfAPs >= All CPUs in system, then ASSERT().
+  If BspIndex exceeds the range of all CPUs in the system, then ASSERT().
+
+  Note:
+  This function is blocking mode, and it will return only after the number of APs released by
+  calling SmmCpuSyncReleaseBsp():
+  BSP: WaitForAPs    <--  AP: ReleaseBsp
+
+  @param[in,out]  Context           Pointer to the SMM CPU Sync context object.
+  @param[in]      NumberOfAPs       Number of APs need to be waited by BSP.
+  @param[in]      BspIndex          The BSP Index to wait for APs.
+
+**/
+VOID
+EFIAPI
+SmmCpuSyncWaitForAPs (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context,
+  IN     UINTN                 NumberOfAPs,
+  IN     UINTN                 BspIndex
+  )
+{
+  UINTN   GroupIndex;
+  UINT32  Target;
+  UINT32  Released;
+
+  ASSERT (Context != NULL);
+
+  ASSERT (NumberOfAPs < Context->NumberOfCpus);
+
+  ASSERT (BspIndex < Context->NumberOfCpus);
+
+  //
+  // The Released counters only grow until the context is reset. Wait until the APs
+  // released the BSP NumberOfAPs more times than the BSP has waited for so far.
+  //
+  Target = Context->BspWaitedCount + (UINT32)NumberOfAPs;
+  for ( ; ;) {
+    Released = 0;
+    for (GroupIndex = 0; GroupIndex < Context->NumberOfGroups; GroupIndex++) {
+      Released += *Context->Group[GroupIndex].Released;
+    }
+
+    if (Released >= Target) {
+      break;
+    }
+
+    CpuPause ();
+  }
+
+  Context->BspWaitedCount = Target;
+}
+
+/**
+  Used by the BSP to release one AP.
+
+  The AP is specified by CpuIndex. The BSP is specified by BspIndex.
+  The caller shall make sure the BspIndex is the actual CPU calling this function to avoid the undefined behavior.
+  The caller shall make sure the CpuIndex has already checked-in to avoid the undefined behavior.
+
+  If Context is NULL, then ASSERT().
+  If CpuIndex == BspIndex, then ASSERT().
+  If BspIndex or CpuIndex exceed the range of all CPUs in the system, then ASSERT().
+
+  @param[in,out]  Context           Pointer to the SMM CPU Sync context object.
+  @param[in]      CpuIndex          Indicate which AP need to be released.
+  @param[in]      BspIndex          The BSP Index to release AP.
+
+**/
+VOID
+EFIAPI
+SmmCpuSyncReleaseOneAp   (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context,
+  IN     UINTN                 CpuIndex,
+  IN     UINTN                 BspIndex
+  )
+{
+  ASSERT (Context != NULL);
+
+  ASSERT (BspIndex != CpuIndex);
+
+  ASSERT (CpuIndex < Context->NumberOfCpus);
+
+  ASSERT (BspIndex < Context->NumberOfCpus);
+
+  InternalReleaseSemaphore (Context->CpuSem[CpuIndex].Run);
+}
+
+/**
+  Used by the AP to wait BSP.
+
+  The AP is specified by CpuIndex.
+  The caller shall make sure the CpuIndex is the actual CPU calling this function to avoid the undefined behavior.
+  The BSP is specified by BspIndex.
+
+  If Context is NULL, then ASSERT().
+  If CpuIndex == BspIndex, then ASSERT().
+  If BspIndex or CpuIndex exceed the range of all CPUs in the system, then ASSERT().
+
+  Note:
+  This function is blocking mode, and it will return only after the AP released by
+  calling SmmCpuSyncReleaseOneAp():
+  BSP: ReleaseOneAp  -->  AP: WaitForBsp
+
+  @param[in,out]  Context          Pointer to the SMM CPU Sync context object.
+  @param[in]      CpuIndex         Indicate which AP wait BSP.
+  @param[in]      BspIndex         The BSP Index to be waited.
+
+**/
+VOID
+EFIAPI
+SmmCpuSyncWaitForBsp (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context,
+  IN     UINTN                 CpuIndex,
+  IN     UINTN                 BspIndex
+  )
+{
+  ASSERT (Context != NULL);
+
+  ASSERT (BspIndex != CpuIndex);
+
+  ASSERT (CpuIndex < Context->NumberOfCpus);
+
+  ASSERT (BspIndex < Context->NumberOfCpus);
+
+  InternalWaitForSemaphore (Context->CpuSem[CpuIndex].Run);
+}
+
+/**
+  Used by the AP to release BSP.
+
+  The AP is specified by CpuIndex.
+  The caller shall make sure the CpuIndex is the actual CPU calling this function to avoid the undefined behavior.
+  The BSP is specified by BspIndex.
+
+  If Context is NULL, then ASSERT().
+  If CpuIndex == BspIndex, then ASSERT().
+  If BspIndex or CpuIndex exceed the range of all CPUs in the system, then ASSERT().
+
+  @param[in,out]  Context           Pointer to the SMM CPU Sync context object.
+  @param[in]      CpuIndex          Indicate which AP release BSP.
+  @param[in]      BspIndex          The BSP Index to be released.
+
+**/
+VOID
+EFIAPI
+SmmCpuSyncReleaseBsp (
+  IN OUT SMM_CPU_SYNC_CONTEXT  *Context,
+  IN     UINTN                 CpuIndex,
+  IN     UINTN                 BspIndex
+  )
+{
+  ASSERT (Context != NULL);
+
+  ASSERT (BspIndex != CpuIndex);
+
+  ASSERT (CpuIndex < Context->NumberOfCpus);
+
+  ASSERT (BspIndex < Context->NumberOfCpus);
+
+  InterlockedIncrement (Context->CpuSem[CpuIndex].Group->Released);
+}
@@ -597,7 +597,9 @@ BSPHandler (
   //
   // Invoke SMM Foundation EntryPoint with the processor information context.
   //
+  SmiLatencyDispatchBegin ();
   gSmmCpuPrivate->SmmCoreEntry (&gSmmCpuPrivate->SmmCoreEntryContext);
+  SmiLatencyDispatchEnd ();
 
   //
   // Make sure all APs have completed their pending none-block tasks
@@ -701,6 +703,12 @@ BSPHandler (
   //
   SmmCpuSyncWaitForAPs (mSmmMpSyncData->SyncContext, ApCount, CpuIndex); /// #13: Wait APs
 
+  SmiLatencyExit (CpuIndex);
+
+  PERF_CODE (
+    MpPerfEnd (CpuIndex, SMM_MP_PERF_PROCEDURE_ID (SmiEntryToExit));
+    );
+
   //
   // At this point, all APs should have exited from APHandler().
   // Migrate the SMM MP performance logging to standard SMM performance logging.
@@ -954,6 +962,10 @@ APHandler (
   //
   *(mSmmMpSyncData->CpuData[CpuIndex].Present) = FALSE;
 
+  PERF_CODE (
+    MpPerfEnd (CpuIndex, SMM_MP_PERF_PROCEDURE_ID (SmiEntryToExit));
+    );
+
   //
   // Notify BSP the readiness of this AP to exit SMM
   //
@@ -1587,6 +1599,16 @@ SmiRendezvous (
     return;
   }
 
+  //
+  // SmiEntryToExit ends before the CPU signals the BSP the last time in
+  // BSPHandler()/APHandler(), so that it is migrated in the same SMI.
+  //
+  PERF_CODE (
+    MpPerfBegin (CpuIndex, SMM_MP_PERF_PROCEDURE_ID (SmiEntryToExit));
+    );
+
+  SmiLatencyEntry (CpuIndex);
+
   //
   // Call the user register Startup function first.
   //
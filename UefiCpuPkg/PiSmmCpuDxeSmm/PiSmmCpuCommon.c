@@ -810,6 +810,8 @@ PiSmmCpuEntryCommon (
     InitializeMpPerf (gSmmCpuPrivate->SmmCoreEntryContext.NumberOfCpus);
     );
 
+  InitializeSmiLatency (gSmmCpuPrivate->SmmCoreEntryContext.NumberOfCpus);
+
   //
   // The CPU save state and code for the SMI entry point are tiled within an SMRAM
   // allocated buffer.  The minimum size of this buffer for a uniprocessor system
@@ -66,6 +66,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "CpuService.h"
 #include "SmmProfile.h"
 #include "SmmMpPerf.h"
+#include "SmiLatency.h"
 
 //
 // CET definition
@@ -0,0 +1,211 @@
+/** @file
+SMI latency histogram of the SMI phases.
+
+The BSP of every SMI adds the time of the rendezvous, of the SMM core dispatch
+and of the exit synchronization to a histogram of the phase. The histograms
+are kept in SMRAM and returned by the gSmiLatencyHistogramGuid SMI handler.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "PiSmmCpuCommon.h"
+
+//
+// Each element holds the performance counter value of one processor at SMI entry.
+//
+UINT64                 *mSmiLatencyEntryCounter = NULL;
+UINT64                 mSmiLatencyDispatchBeginCounter;
+UINT64                 mSmiLatencyDispatchEndCounter;
+UINT64                 mSmiLatencyCounterStart;
+UINT64                 mSmiLatencyCounterEnd;
+SMI_LATENCY_HISTOGRAM  mSmiLatencyHistogram[SmiLatencyPhaseMax];
+
+/**
+  Add the time between two performance counter values to an SMI latency histogram.
+
+  @param Histogram       The SMI latency histogram.
+  @param StartCounter    The performance counter value at the start of the sample.
+  @param EndCounter      The performance counter value at the end of the sample.
+**/
+VOID
+SmiLatencyHistogramAdd (
+  IN OUT SMI_LATENCY_HISTOGRAM  *Histogram,
+  IN     UINT64                 StartCounter,
+  IN     UINT64                 EndCounter
+  )
+{
+  UINT64  Ticks;
+  UINT64  Ns;
+  INTN    Bucket;
+
+  //
+  // Take the counter wrap around into account.
+  //
+  if (mSmiLatencyCounterStart < mSmiLatencyCounterEnd) {
+    if (EndCounter >= StartCounter) {
+      Ticks = EndCounter - StartCounter;
+    } else {
+      Ticks = (mSmiLatencyCounterEnd - StartCounter) + (EndCounter - mSmiLatencyCounterStart);
+    }
+  } else {
+    if (StartCounter >= EndCounter) {
+      Ticks = StartCounter - EndCounter;
+    } else {
+      Ticks = (StartCounter - mSmiLatencyCounterEnd) + (mSmiLatencyCounterStart - EndCounter);
+    }
+  }
+
+  Ns     = GetTimeInNanoSecond (Ticks);
+  Bucket = HighBitSet64 (Ns);
+  if (Bucket < 0) {
+    Bucket = 0;
+  } else if (Bucket >= SMI_LATENCY_HISTOGRAM_BUCKET_COUNT) {
+    Bucket = SMI_LATENCY_HISTOGRAM_BUCKET_COUNT - 1;
+  }
+
+  Histogram->Count++;
+  Histogram->TotalNs += Ns;
+  Histogram->Bucket[Bucket]++;
+  if (Ns > Histogram->MaxNs) {
+    Histogram->MaxNs = Ns;
+  }
+}
+
+/**
+  SMI handler that returns the SMI latency histograms of the SMI phases.
+
+  The SMM core registers a handler for the same GUID to return the histograms
+  of the SMI handlers, so other commands are left to that handler. The SMM core
+  has checked that the communication buffer is outside SMRAM.
+
+  @param DispatchHandle  The unique handle assigned to this handler by MmiHandlerRegister().
+  @param Context         Points to an optional handler context which was specified when the handler was registered.
+  @param CommBuffer      A pointer to a collection of data in memory that will
+                         be conveyed from a non-MM environment into an MM environment.
+  @param CommBufferSize  The size of the CommBuffer.
+
+  @return Status Code
+**/
+EFI_STATUS
+EFIAPI
+SmiLatencyHistogramHandler (
+  IN     EFI_HANDLE  DispatchHandle,
+  IN     CONST VOID  *Context         OPTIONAL,
+  IN OUT VOID        *CommBuffer      OPTIONAL,
+  IN OUT UINTN       *CommBufferSize  OPTIONAL
+  )
+{
+  SMI_LATENCY_HISTOGRAM_PARAMETER_GET_PHASES  *GetPhases;
+
+  if ((CommBuffer == NULL) || (CommBufferSize == NULL)) {
+    return EFI_SUCCESS;
+  }
+
+  if (*CommBufferSize < sizeof (SMI_LATENCY_HISTOGRAM_PARAMETER_HEADER)) {
+    return EFI_SUCCESS;
+  }
+
+  if (((SMI_LATENCY_HISTOGRAM_PARAMETER_HEADER *)CommBuffer)->Command != SMI_LATENCY_HISTOGRAM_COMMAND_GET_PHASES) {
+    return EFI_WARN_INTERRUPT_SOURCE_PENDING;
+  }
+
+  if (*CommBufferSize != sizeof (SMI_LATENCY_HISTOGRAM_PARAMETER_GET_PHASES)) {
+    DEBUG ((DEBUG_ERROR, "SmiLatencyHistogramHandler: MM communication buffer size invalid!\n"));
+    return EFI_SUCCESS;
+  }
+
+  //
+  // Only output fields are written, so the parameter needs no copy in SMRAM.
+  //
+  GetPhases = (SMI_LATENCY_HISTOGRAM_PARAMETER_GET_PHASES *)CommBuffer;
+  CopyMem (GetPhases->Phase, mSmiLatencyHistogram, sizeof (GetPhases->Phase));
+  GetPhases->Header.ReturnStatus = 0;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Initialize the SMI latency histograms and register the SMI handler that
+  returns them.
+
+  @param NumberofCpus    Number of processors in the platform.
+**/
+VOID
+InitializeSmiLatency (
+  IN UINTN  NumberofCpus
+  )
+{
+  EFI_STATUS  Status;
+  EFI_HANDLE  DispatchHandle;
+
+  mSmiLatencyEntryCounter = AllocateZeroPool (NumberofCpus * sizeof (*mSmiLatencyEntryCounter));
+  ASSERT (mSmiLatencyEntryCounter != NULL);
+
+  GetPerformanceCounterProperties (&mSmiLatencyCounterStart, &mSmiLatencyCounterEnd);
+
+  Status = gMmst->MmiHandlerRegister (
+                    SmiLatencyHistogramHandler,
+                    &gSmiLatencyHistogramGuid,
+                    &DispatchHandle
+                    );
+  ASSERT_EFI_ERROR (Status);
+}
+
+/**
+  Save the performance counter value when the processor enters the SMI.
+
+  @param CpuIndex        The index of the CPU.
+**/
+VOID
+SmiLatencyEntry (
+  IN UINTN  CpuIndex
+  )
+{
+  mSmiLatencyEntryCounter[CpuIndex] = GetPerformanceCounter ();
+}
+
+/**
+  Save the performance counter value before the BSP invokes the SMM core.
+**/
+VOID
+SmiLatencyDispatchBegin (
+  VOID
+  )
+{
+  mSmiLatencyDispatchBeginCounter = GetPerformanceCounter ();
+}
+
+/**
+  Save the performance counter value after the BSP returns from the SMM core.
+**/
+VOID
+SmiLatencyDispatchEnd (
+  VOID
+  )
+{
+  mSmiLatencyDispatchEndCounter = GetPerformanceCounter ();
+}
+
+/**
+  Add the phases of the SMI to the SMI latency histograms. This is called by
+  the BSP after all APs have exited the SMI.
+
+  @param CpuIndex        The index of the BSP.
+**/
+VOID
+SmiLatencyExit (
+  IN UINTN  CpuIndex
+  )
+{
+  UINT64  ExitCounter;
+
+  ExitCounter = GetPerformanceCounter ();
+
+  SmiLatencyHistogramAdd (&mSmiLatencyHistogram[SmiLatencyPhaseRendezvous], mSmiLatencyEntryCounter[CpuIndex], mSmiLatencyDispatchBeginCounter);
+  SmiLatencyHistogramAdd (&mSmiLatencyHistogram[SmiLatencyPhaseDispatch], mSmiLatencyDispatchBeginCounter, mSmiLatencyDispatchEndCounter);
+  SmiLatencyHistogramAdd (&mSmiLatencyHistogram[SmiLatencyPhaseExitSync], mSmiLatencyDispatchEndCounter, ExitCounter);
+  SmiLatencyHistogramAdd (&mSmiLatencyHistogram[SmiLatencyPhaseTotal], mSmiLatencyEntryCounter[CpuIndex], ExitCounter);
+}
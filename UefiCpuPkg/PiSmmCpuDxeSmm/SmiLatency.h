@@ -0,0 +1,60 @@
+/** @file
+SMI latency histogram of the SMI phases.
+
+Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#pragma once
+
+#include <Guid/SmiLatencyHistogram.h>
+
+/**
+  Initialize the SMI latency histograms and register the SMI handler that
+  returns them.
+
+  @param NumberofCpus    Number of processors in the platform.
+**/
+VOID
+InitializeSmiLatency (
+  IN UINTN  NumberofCpus
+  );
+
+/**
+  Save the performance counter value when the processor enters the SMI.
+
+  @param CpuIndex        The index of the CPU.
+**/
+VOID
+SmiLatencyEntry (
+  IN UINTN  CpuIndex
+  );
+
+/**
+  Save the performance counter value before the BSP invokes the SMM core.
+**/
+VOID
+SmiLatencyDispatchBegin (
+  VOID
+  );
+
+/**
+  Save the performance counter value after the BSP returns from the SMM core.
+**/
+VOID
+SmiLatencyDispatchEnd (
+  VOID
+  );
+
+/**
+  Add the phases of the SMI to the SMI latency histograms. This is called by
+  the BSP after all APs have exited the SMI.
+
+  @param CpuIndex        The index of the BSP.
+**/
+VOID
+SmiLatencyExit (
+  IN UINTN  CpuIndex
+  );
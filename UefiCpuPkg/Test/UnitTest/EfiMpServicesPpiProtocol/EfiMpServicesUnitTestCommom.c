@@ -1390,6 +1390,128 @@ TestStartupAllAPs5 (
   return UNIT_TEST_PASSED;
 }
 
+/**
+  Get the time elapsed since the performance counter had the value Start.
+
+  @param[in]  Start   The earlier performance counter value.
+
+  @return  The elapsed time in nanoseconds.
+**/
+UINT64
+GetElapsedNanoSecond (
+  IN UINT64  Start
+  )
+{
+  UINT64  StartValue;
+  UINT64  EndValue;
+  INT64   Delta;
+  INT64   Cycle;
+
+  GetPerformanceCounterProperties (&StartValue, &EndValue);
+  Cycle = EndValue - StartValue;
+  if (Cycle < 0) {
+    Cycle = -Cycle;
+  }
+
+  Cycle++;
+  Delta = (INT64)(GetPerformanceCounter () - Start);
+  if (StartValue > EndValue) {
+    Delta = -Delta;
+  }
+
+  if (Delta < 0) {
+    Delta += Cycle;
+  }
+
+  return GetTimeInNanoSecond (Delta);
+}
+
+/**
+  Unit test of MP service StartupAllAPs.
+  Measure the average round trip time of dispatching the empty Procedure to all enabled APs,
+  with 1, 3, 7 .. and finally all APs enabled. Every dispatch should return EFI_SUCCESS.
+
+  @param[in]  Context   Context pointer for this test.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestStartupAllAPs6 (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS             Status;
+  UINTN                  ProcessorNumber;
+  UINTN                  EnabledProcessors;
+  UINTN                  EnabledAps;
+  UINTN                  Round;
+  UINT64                 Start;
+  UINT64                 Elapsed;
+  MP_SERVICE_UT_CONTEXT  *LocalContext;
+
+  LocalContext = (MP_SERVICE_UT_CONTEXT *)Context;
+
+  if (LocalContext->NumberOfProcessors < 2) {
+    return UNIT_TEST_SKIPPED;
+  }
+
+  EnabledProcessors = 2;
+  while (TRUE) {
+    if (EnabledProcessors > LocalContext->NumberOfProcessors) {
+      EnabledProcessors = LocalContext->NumberOfProcessors;
+    }
+
+    //
+    // Enable the BSP and the first (EnabledProcessors - 1) APs only.
+    //
+    EnabledAps = 0;
+    for (ProcessorNumber = 0; ProcessorNumber < LocalContext->NumberOfProcessors; ProcessorNumber++) {
+      if (ProcessorNumber == LocalContext->BspNumber) {
+        continue;
+      }
+
+      Status = MpServicesUnitTestEnableDisableAP (
+                 LocalContext->MpServices,
+                 ProcessorNumber,
+                 (BOOLEAN)(EnabledAps < EnabledProcessors - 1),
+                 NULL
+                 );
+      UT_ASSERT_NOT_EFI_ERROR (Status);
+      EnabledAps++;
+    }
+
+    Start = GetPerformanceCounter ();
+    for (Round = 0; Round < STARTUP_ALL_APS_LATENCY_ROUNDS; Round++) {
+      Status = MpServicesUnitTestStartupAllAPs (
+                 LocalContext->MpServices,
+                 (EFI_AP_PROCEDURE)EmptyProcedure,
+                 FALSE,
+                 0,
+                 NULL
+                 );
+      UT_ASSERT_NOT_EFI_ERROR (Status);
+    }
+
+    Elapsed = GetElapsedNanoSecond (Start);
+    UT_LOG_INFO (
+      "StartupAllAPs with %ld enabled APs: %ld ns per round trip\n",
+      (UINT64)(EnabledProcessors - 1),
+      DivU64x32 (Elapsed, STARTUP_ALL_APS_LATENCY_ROUNDS)
+      );
+
+    if (EnabledProcessors == LocalContext->NumberOfProcessors) {
+      break;
+    }
+
+    EnabledProcessors *= 2;
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
 /**
   Unit test of MP service SwitchBSP.
   When switch current BSP to be BSP, the return status should be EFI_INVALID_PARAMETER.
@@ -1767,6 +1889,7 @@ AddCommonTestCase (
   AddTestCase (MpServiceStartupAllAPsTestSuite, "Test StartupAllAPs 3", "TestStartupAllAPs3", TestStartupAllAPs3, InitUTContext, CheckUTContext, Context);
   AddTestCase (MpServiceStartupAllAPsTestSuite, "Test StartupAllAPs 4", "TestStartupAllAPs4", TestStartupAllAPs4, InitUTContext, CheckUTContext, Context);
   AddTestCase (MpServiceStartupAllAPsTestSuite, "Test StartupAllAPs 5", "TestStartupAllAPs5", TestStartupAllAPs5, InitUTContext, CheckUTContext, Context);
+  AddTestCase (MpServiceStartupAllAPsTestSuite, "Test StartupAllAPs 6", "TestStartupAllAPs6", TestStartupAllAPs6, InitUTContext, CheckUTContext, Context);
 
   //
   // Test SwitchBSP function
@@ -17,10 +17,13 @@
 #include <Library/ReportStatusCodeLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/TimerLib.h>
 #include <Library/UnitTestLib.h>
 
 #define RUN_PROCEDURE_TIMEOUT_VALUE  100000  // microseconds
 
+#define STARTUP_ALL_APS_LATENCY_ROUNDS  1000
+
 typedef union {
   EFI_PEI_MP_SERVICES2_PPI    *Ppi;
   EFI_MP_SERVICES_PROTOCOL    *Protocol;
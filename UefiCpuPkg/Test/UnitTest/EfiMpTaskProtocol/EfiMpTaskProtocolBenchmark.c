@@ -0,0 +1,365 @@
+/** @file
+  Correctness tests and scaling benchmark of the EDK II MP Task Protocol.
+
+  The benchmark runs the same compute-bound tasks once on the BSP alone and
+  once through the protocol on all enabled processors, and reports the
+  speedup. It runs a workload with equal task durations and a workload with
+  durations varying by a factor of 16, which only scales well when idle
+  processors steal tasks from busy ones.
+
+  To reproduce, boot a platform with many processors, for example OVMF on
+  QEMU with "-smp 64", and run the application from the UEFI Shell.
+
+  Copyright (c) 2026, Intel Corporation. All rights reserved.<BR>
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Protocol/MpTask.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Library/TimerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_NAME     "EDK II MP Task Protocol Benchmark"
+#define UNIT_TEST_VERSION  "1.0"
+
+#define CORRECTNESS_TASKS   1000
+#define CORRECTNESS_EXTRA   37
+#define BENCHMARK_TASKS     4096
+#define ROUNDS_PER_TASK     20000
+#define TIMEOUT_TASKS       100000
+#define TIMEOUT_IN_US       1000
+
+typedef struct {
+  BOOLEAN    Uneven;
+  UINT64     *Results;
+} BENCHMARK_CONTEXT;
+
+EDKII_MP_TASK_PROTOCOL  *mMpTask;
+
+/**
+  Return the time elapsed since a performance counter value was read. The
+  counter may count down and may wrap around once.
+
+  @param[in] Start  The earlier performance counter value.
+
+  @return The elapsed time in nanoseconds.
+
+**/
+UINT64
+ElapsedNanoseconds (
+  IN UINT64  Start
+  )
+{
+  UINT64  StartValue;
+  UINT64  EndValue;
+  UINT64  Current;
+  INT64   Delta;
+  INT64   Cycle;
+
+  GetPerformanceCounterProperties (&StartValue, &EndValue);
+  Current = GetPerformanceCounter ();
+  Cycle   = EndValue - StartValue;
+  if (Cycle < 0) {
+    Cycle = -Cycle;
+  }
+
+  Cycle++;
+  Delta = (INT64)(Current - Start);
+  if (StartValue > EndValue) {
+    Delta = -Delta;
+  }
+
+  if (Delta < 0) {
+    Delta += Cycle;
+  }
+
+  return GetTimeInNanoSecond (Delta);
+}
+
+/**
+  Count how often every task of a batch ran.
+
+  @param[in] Context    Array of UINT32 counters, one per task.
+  @param[in] TaskIndex  Index of the task in its batch.
+
+**/
+VOID
+EFIAPI
+CountTask (
+  IN VOID   *Context,
+  IN UINTN  TaskIndex
+  )
+{
+  InterlockedIncrement (&((UINT32 *)Context)[TaskIndex]);
+}
+
+/**
+  Compute-bound task. Mixes a xorshift state for a number of rounds so that
+  the run time does not depend on memory bandwidth.
+
+  @param[in] Context    The BENCHMARK_CONTEXT.
+  @param[in] TaskIndex  Index of the task in its batch.
+
+**/
+VOID
+EFIAPI
+ComputeTask (
+  IN VOID   *Context,
+  IN UINTN  TaskIndex
+  )
+{
+  BENCHMARK_CONTEXT  *Benchmark;
+  UINT64             State;
+  UINTN              Rounds;
+  UINTN              Index;
+
+  Benchmark = (BENCHMARK_CONTEXT *)Context;
+  Rounds    = ROUNDS_PER_TASK;
+  if (Benchmark->Uneven) {
+    Rounds = ROUNDS_PER_TASK / 8 * (1 + (TaskIndex % 16));
+  }
+
+  State = TaskIndex + 1;
+  for (Index = 0; Index < Rounds; Index++) {
+    State ^= LShiftU64 (State, 13);
+    State ^= RShiftU64 (State, 7);
+    State ^= LShiftU64 (State, 17);
+  }
+
+  Benchmark->Results[TaskIndex] = State;
+}
+
+/**
+  Check that every task of every submitted batch runs exactly once.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RunEveryTaskOnce (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS          Status;
+  EDKII_MP_TASK_POOL  Pool;
+  UINT32              *Counters;
+  UINTN               Completed;
+  UINTN               Index;
+
+  Counters = AllocateZeroPool ((CORRECTNESS_TASKS + CORRECTNESS_EXTRA) * sizeof (UINT32));
+  UT_ASSERT_NOT_NULL (Counters);
+
+  Status = mMpTask->CreatePool (mMpTask, &Pool);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  Status = mMpTask->SubmitTasks (mMpTask, Pool, CountTask, Counters, CORRECTNESS_TASKS);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  Status = mMpTask->SubmitTasks (mMpTask, Pool, CountTask, &Counters[CORRECTNESS_TASKS], CORRECTNESS_EXTRA);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  Status = mMpTask->JoinTasks (mMpTask, Pool, 0, &Completed);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (Completed, CORRECTNESS_TASKS + CORRECTNESS_EXTRA);
+  for (Index = 0; Index < CORRECTNESS_TASKS + CORRECTNESS_EXTRA; Index++) {
+    UT_ASSERT_EQUAL (Counters[Index], 1);
+  }
+
+  //
+  // The pool is empty after the join.
+  //
+  Status = mMpTask->JoinTasks (mMpTask, Pool, 0, &Completed);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (Completed, 0);
+
+  UT_ASSERT_STATUS_EQUAL (mMpTask->SubmitTasks (mMpTask, Pool, CountTask, Counters, 0), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (mMpTask->SubmitTasks (mMpTask, Pool, NULL, Counters, 1), EFI_INVALID_PARAMETER);
+
+  Status = mMpTask->DestroyPool (mMpTask, Pool);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  FreePool (Counters);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Check that a join stops starting tasks when its timeout expires, and that
+  the pool can be used again afterwards.
+
+  @param[in]  Context  Unused.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+JoinTimeout (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS          Status;
+  EDKII_MP_TASK_POOL  Pool;
+  BENCHMARK_CONTEXT   Benchmark;
+  UINTN               Completed;
+
+  Benchmark.Uneven  = FALSE;
+  Benchmark.Results = AllocatePool (TIMEOUT_TASKS * sizeof (UINT64));
+  UT_ASSERT_NOT_NULL (Benchmark.Results);
+
+  Status = mMpTask->CreatePool (mMpTask, &Pool);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  Status = mMpTask->SubmitTasks (mMpTask, Pool, ComputeTask, &Benchmark, TIMEOUT_TASKS);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  Status = mMpTask->JoinTasks (mMpTask, Pool, TIMEOUT_IN_US, &Completed);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_TIMEOUT);
+  UT_ASSERT_TRUE (Completed < TIMEOUT_TASKS);
+  UT_LOG_INFO ("%ld of %d tasks ran before the timeout\n", (UINT64)Completed, TIMEOUT_TASKS);
+
+  Status = mMpTask->SubmitTasks (mMpTask, Pool, ComputeTask, &Benchmark, BENCHMARK_TASKS);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  Status = mMpTask->JoinTasks (mMpTask, Pool, 0, &Completed);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (Completed, BENCHMARK_TASKS);
+
+  Status = mMpTask->DestroyPool (mMpTask, Pool);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  FreePool (Benchmark.Results);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Run the compute-bound tasks on the BSP alone and on all processors, check
+  that both give the same results and report the speedup.
+
+  @param[in]  Context  Non-zero for the workload with uneven task durations.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+
+**/
+UNIT_TEST_STATUS
+EFIAPI
+Speedup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS          Status;
+  EDKII_MP_TASK_POOL  Pool;
+  BENCHMARK_CONTEXT   Benchmark;
+  UINT64              *Expected;
+  UINTN               Index;
+  UINT64              Start;
+  UINT64              SerialTime;
+  UINT64              ParallelTime;
+
+  Benchmark.Uneven  = (BOOLEAN)(Context != NULL);
+  Benchmark.Results = AllocateZeroPool (BENCHMARK_TASKS * sizeof (UINT64));
+  Expected          = AllocateZeroPool (BENCHMARK_TASKS * sizeof (UINT64));
+  UT_ASSERT_NOT_NULL (Benchmark.Results);
+  UT_ASSERT_NOT_NULL (Expected);
+
+  Start = GetPerformanceCounter ();
+  for (Index = 0; Index < BENCHMARK_TASKS; Index++) {
+    ComputeTask (&Benchmark, Index);
+  }
+
+  SerialTime = ElapsedNanoseconds (Start);
+  CopyMem (Expected, Benchmark.Results, BENCHMARK_TASKS * sizeof (UINT64));
+  ZeroMem (Benchmark.Results, BENCHMARK_TASKS * sizeof (UINT64));
+
+  Status = mMpTask->CreatePool (mMpTask, &Pool);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  Status = mMpTask->SubmitTasks (mMpTask, Pool, ComputeTask, &Benchmark, BENCHMARK_TASKS);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  Start  = GetPerformanceCounter ();
+  Status = mMpTask->JoinTasks (mMpTask, Pool, 0, NULL);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  ParallelTime = ElapsedNanoseconds (Start);
+
+  UT_ASSERT_MEM_EQUAL (Benchmark.Results, Expected, BENCHMARK_TASKS * sizeof (UINT64));
+  UT_LOG_INFO (
+    "%a tasks: %ld us on the BSP, %ld us on all processors, speedup %ld.%02ld\n",
+    Benchmark.Uneven ? "Uneven" : "Equal",
+    DivU64x32 (SerialTime, 1000),
+    DivU64x32 (ParallelTime, 1000),
+    DivU64x64Remainder (SerialTime, MAX (ParallelTime, 1), NULL),
+    (UINT64)ModU64x32 (DivU64x64Remainder (MultU64x32 (SerialTime, 100), MAX (ParallelTime, 1), NULL), 100)
+    );
+
+  Status = mMpTask->DestroyPool (mMpTask, Pool);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  FreePool (Expected);
+  FreePool (Benchmark.Results);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Standard UEFI application entry point. Initialize the unit test framework,
+  add the tests and benchmarks of the EDK II MP Task Protocol and run them.
+
+  @param[in]  ImageHandle    The firmware allocated handle for the EFI image.
+  @param[in]  SystemTable    A pointer to the EFI System Table.
+
+**/
+EFI_STATUS
+EFIAPI
+DxeEntryPoint (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      MpTaskTests;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  Status = gBS->LocateProtocol (&gEdkiiMpTaskProtocolGuid, NULL, (VOID **)&mMpTask);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed to locate the MP Task Protocol. Status = %r\n", Status));
+    return Status;
+  }
+
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&MpTaskTests, Framework, "MP Task Protocol Tests", "UefiCpuPkg.MpTask", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for the MP Task Protocol Tests\n"));
+    goto EXIT;
+  }
+
+  AddTestCase (MpTaskTests, "Every task runs once", "RunEveryTaskOnce", RunEveryTaskOnce, NULL, NULL, NULL);
+  AddTestCase (MpTaskTests, "Join stops at the timeout", "JoinTimeout", JoinTimeout, NULL, NULL, NULL);
+  AddTestCase (MpTaskTests, "Speedup with equal tasks", "SpeedupEqual", Speedup, NULL, NULL, NULL);
+  AddTestCase (MpTaskTests, "Speedup with uneven tasks", "SpeedupUneven", Speedup, NULL, NULL, (UNIT_TEST_CONTEXT)(UINTN)1);
+
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework != NULL) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}